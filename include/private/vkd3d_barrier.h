@@ -0,0 +1,202 @@
+/*
+ * Copyright 2026 agent
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __VKD3D_BARRIER_H
+#define __VKD3D_BARRIER_H
+
+#include <stdbool.h>
+#include "vkd3d.h"
+
+/* Translation of enhanced barriers to synchronization2.
+ * Only stage and access bits which have a legacy equivalent with the same value are
+ * emitted, so the masks can be passed to vkCmdPipelineBarrier as-is when
+ * VK_KHR_synchronization2 is not available. Callers are expected to mask out
+ * stages which are not supported by the queue. */
+
+#define VKD3D_PIPELINE_STAGE_2_ALL_SHADERS ( \
+        VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | \
+        VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT_KHR | \
+        VK_PIPELINE_STAGE_2_TESSELLATION_EVALUATION_SHADER_BIT_KHR | \
+        VK_PIPELINE_STAGE_2_GEOMETRY_SHADER_BIT_KHR | \
+        VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | \
+        VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT | \
+        VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | \
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | \
+        VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR)
+
+static inline VkPipelineStageFlags2KHR vk_stage_flags_from_d3d12_barrier_sync(D3D12_BARRIER_SYNC sync)
+{
+    VkPipelineStageFlags2KHR stages = 0;
+
+    if (sync & D3D12_BARRIER_SYNC_ALL)
+        return VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+
+    if (sync & D3D12_BARRIER_SYNC_DRAW)
+        stages |= VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT_KHR;
+    if (sync & D3D12_BARRIER_SYNC_INDEX_INPUT)
+        stages |= VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR;
+    /* Vertex buffers are synchronized with vertex shading, which also covers amplification and mesh shaders. */
+    if (sync & D3D12_BARRIER_SYNC_VERTEX_SHADING)
+    {
+        stages |= VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR |
+                VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_TESSELLATION_EVALUATION_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_GEOMETRY_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT |
+                VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+    }
+    if (sync & D3D12_BARRIER_SYNC_PIXEL_SHADING)
+        stages |= VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+    if (sync & D3D12_BARRIER_SYNC_DEPTH_STENCIL)
+        stages |= VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR;
+    if (sync & D3D12_BARRIER_SYNC_RENDER_TARGET)
+        stages |= VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+    if (sync & D3D12_BARRIER_SYNC_COMPUTE_SHADING)
+        stages |= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+    if (sync & D3D12_BARRIER_SYNC_RAYTRACING)
+        stages |= VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR;
+    if (sync & (D3D12_BARRIER_SYNC_COPY | D3D12_BARRIER_SYNC_RESOLVE))
+        stages |= VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+    /* Indirect arguments and predicates may be read by compute shaders or copied
+     * before they are consumed, depending on the implementation. */
+    if (sync & D3D12_BARRIER_SYNC_EXECUTE_INDIRECT)
+    {
+        stages |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR |
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+    }
+    if (sync & D3D12_BARRIER_SYNC_ALL_SHADING)
+        stages |= VKD3D_PIPELINE_STAGE_2_ALL_SHADERS;
+    if (sync & D3D12_BARRIER_SYNC_NON_PIXEL_SHADING)
+        stages |= VKD3D_PIPELINE_STAGE_2_ALL_SHADERS & ~VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+    if (sync & D3D12_BARRIER_SYNC_EMIT_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO)
+        stages |= VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+    /* UAV clears are implemented with compute shaders or fills. */
+    if (sync & D3D12_BARRIER_SYNC_CLEAR_UNORDERED_ACCESS_VIEW)
+        stages |= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+    if (sync & (D3D12_BARRIER_SYNC_BUILD_RAYTRACING_ACCELERATION_STRUCTURE |
+            D3D12_BARRIER_SYNC_COPY_RAYTRACING_ACCELERATION_STRUCTURE))
+        stages |= VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+
+    return stages;
+}
+
+static inline VkAccessFlags2KHR vk_access_flags_from_d3d12_barrier_access(D3D12_BARRIER_ACCESS access,
+        VkPipelineStageFlags2KHR stages)
+{
+    VkAccessFlags2KHR vk_access = 0;
+
+    if (access & D3D12_BARRIER_ACCESS_NO_ACCESS)
+        return 0;
+
+    /* Any access which is compatible with the layout. */
+    if (access == D3D12_BARRIER_ACCESS_COMMON)
+        return VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+
+    if (access & D3D12_BARRIER_ACCESS_VERTEX_BUFFER)
+        vk_access |= VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR;
+    /* CBVs may be implemented as SSBOs or raw pointers. */
+    if (access & D3D12_BARRIER_ACCESS_CONSTANT_BUFFER)
+        vk_access |= VK_ACCESS_2_UNIFORM_READ_BIT_KHR | VK_ACCESS_2_SHADER_READ_BIT_KHR;
+    if (access & D3D12_BARRIER_ACCESS_INDEX_BUFFER)
+        vk_access |= VK_ACCESS_2_INDEX_READ_BIT_KHR;
+    if (access & D3D12_BARRIER_ACCESS_RENDER_TARGET)
+        vk_access |= VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR;
+    if (access & D3D12_BARRIER_ACCESS_UNORDERED_ACCESS)
+    {
+        vk_access |= VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR;
+        /* Scratch buffers for acceleration structure builds are UAVs. */
+        if (stages & VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR)
+        {
+            vk_access |= VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR |
+                    VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+        }
+    }
+    if (access & D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE)
+    {
+        vk_access |= VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR |
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR;
+    }
+    if (access & D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ)
+        vk_access |= VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR;
+    if (access & D3D12_BARRIER_ACCESS_SHADER_RESOURCE)
+        vk_access |= VK_ACCESS_2_SHADER_READ_BIT_KHR;
+    if (access & D3D12_BARRIER_ACCESS_STREAM_OUTPUT)
+    {
+        vk_access |= VK_ACCESS_2_TRANSFORM_FEEDBACK_WRITE_BIT_EXT |
+                VK_ACCESS_2_TRANSFORM_FEEDBACK_COUNTER_READ_BIT_EXT |
+                VK_ACCESS_2_TRANSFORM_FEEDBACK_COUNTER_WRITE_BIT_EXT;
+    }
+    if (access & D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT)
+    {
+        vk_access |= VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR |
+                VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_READ_BIT_KHR;
+    }
+    if (access & (D3D12_BARRIER_ACCESS_COPY_DEST | D3D12_BARRIER_ACCESS_RESOLVE_DEST))
+        vk_access |= VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+    if (access & (D3D12_BARRIER_ACCESS_COPY_SOURCE | D3D12_BARRIER_ACCESS_RESOLVE_SOURCE))
+        vk_access |= VK_ACCESS_2_TRANSFER_READ_BIT_KHR;
+    if (access & D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_READ)
+        vk_access |= VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+    if (access & D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_WRITE)
+        vk_access |= VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+    if (access & D3D12_BARRIER_ACCESS_SHADING_RATE_SOURCE)
+        vk_access |= VK_ACCESS_2_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR;
+
+    return vk_access;
+}
+
+/* Mirrors the layouts used for legacy resource states. Read-only and transfer layouts
+ * use the resource's common layout, since everything outside of render passes
+ * and UAV access expects images to be in that layout. */
+static inline VkImageLayout vk_image_layout_from_d3d12_barrier_layout(D3D12_BARRIER_LAYOUT layout,
+        VkImageLayout common_layout, VkImageLayout depth_stencil_layout)
+{
+    switch (layout)
+    {
+        case D3D12_BARRIER_LAYOUT_UNDEFINED:
+            return VK_IMAGE_LAYOUT_UNDEFINED;
+
+        case D3D12_BARRIER_LAYOUT_RENDER_TARGET:
+            return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        case D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS:
+        case D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_UNORDERED_ACCESS:
+        case D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_UNORDERED_ACCESS:
+            return VK_IMAGE_LAYOUT_GENERAL;
+
+        case D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE:
+        case D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ:
+            return depth_stencil_layout;
+
+        case D3D12_BARRIER_LAYOUT_SHADING_RATE_SOURCE:
+            return VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+
+        default:
+            return common_layout;
+    }
+}
+
+static inline bool d3d12_barrier_layout_is_depth_stencil(D3D12_BARRIER_LAYOUT layout)
+{
+    return layout == D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE ||
+            layout == D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ;
+}
+
+#endif /* __VKD3D_BARRIER_H */
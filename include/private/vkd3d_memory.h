@@ -21,37 +21,94 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "vkd3d_debug.h"
 
-static inline void *vkd3d_malloc(size_t size)
+/* Subsystem an allocation is accounted to. Translation units select
+ * their default by defining VKD3D_MEMORY_TAG before including this header. */
+enum vkd3d_memory_tag
+{
+    VKD3D_MEMORY_TAG_MISC = 0,
+    VKD3D_MEMORY_TAG_RESOURCE,
+    VKD3D_MEMORY_TAG_DESCRIPTOR,
+    VKD3D_MEMORY_TAG_COMMAND,
+    VKD3D_MEMORY_TAG_BUNDLE,
+    VKD3D_MEMORY_TAG_PIPELINE,
+    VKD3D_MEMORY_TAG_SHADER,
+    VKD3D_MEMORY_TAG_VULKAN,
+    VKD3D_MEMORY_TAG_COUNT
+};
+
+#ifndef VKD3D_MEMORY_TAG
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_MISC
+#endif
+
+/* Backend for all host allocations. Blocks handed to the backend only
+ * need to satisfy malloc-like alignment, stricter alignment and the
+ * accounting header are handled on top of it. */
+struct vkd3d_host_allocator
+{
+    void *(*pfn_allocate)(void *userdata, size_t size, bool zero);
+    void *(*pfn_reallocate)(void *userdata, void *ptr, size_t size);
+    void (*pfn_free)(void *userdata, void *ptr);
+    void *userdata;
+};
+
+struct vkd3d_memory_stats
+{
+    uint64_t live_bytes;
+    uint64_t live_allocations;
+    uint64_t total_allocations;
+};
+
+/* Passing NULL restores the default libc backend. Fails if any
+ * allocation made through the current backend is still alive. */
+bool vkd3d_set_host_allocator_backend(const struct vkd3d_host_allocator *allocator);
+void vkd3d_get_memory_stats(enum vkd3d_memory_tag tag, struct vkd3d_memory_stats *stats);
+
+void *vkd3d_allocate(size_t size, size_t alignment, bool zero, enum vkd3d_memory_tag tag);
+void *vkd3d_reallocate(void *ptr, size_t size, size_t alignment, enum vkd3d_memory_tag tag);
+void vkd3d_deallocate(void *ptr);
+
+static inline void *vkd3d_malloc_tagged(size_t size, enum vkd3d_memory_tag tag)
 {
     void *ptr;
-    if (!(ptr = malloc(size)))
+    if (!(ptr = vkd3d_allocate(size, 0, false, tag)))
         ERR("Out of memory.\n");
     return ptr;
 }
 
-static inline void *vkd3d_realloc(void *ptr, size_t size)
+static inline void *vkd3d_calloc_tagged(size_t count, size_t size, enum vkd3d_memory_tag tag)
 {
-    if (!(ptr = realloc(ptr, size)))
+    void *ptr;
+    assert(!size || count <= ~(size_t)0 / size);
+    if (!(ptr = vkd3d_allocate(count * size, 0, true, tag)))
         ERR("Out of memory.\n");
     return ptr;
 }
 
-static inline void *vkd3d_calloc(size_t count, size_t size)
+static inline void *vkd3d_malloc(size_t size)
 {
-    void *ptr;
-    assert(count <= ~(size_t)0 / size);
-    if (!(ptr = calloc(count, size)))
+    return vkd3d_malloc_tagged(size, VKD3D_MEMORY_TAG);
+}
+
+static inline void *vkd3d_realloc(void *ptr, size_t size)
+{
+    if (!(ptr = vkd3d_reallocate(ptr, size, 0, VKD3D_MEMORY_TAG)))
         ERR("Out of memory.\n");
     return ptr;
 }
 
+static inline void *vkd3d_calloc(size_t count, size_t size)
+{
+    return vkd3d_calloc_tagged(count, size, VKD3D_MEMORY_TAG);
+}
+
 static inline void vkd3d_free(void *ptr)
 {
-    free(ptr);
+    vkd3d_deallocate(ptr);
 }
 
 bool vkd3d_array_reserve(void **elements, size_t *capacity,
@@ -59,20 +116,12 @@ bool vkd3d_array_reserve(void **elements, size_t *capacity,
 
 static inline void *vkd3d_malloc_aligned(size_t size, size_t align)
 {
-#ifdef _WIN32
-    return _aligned_malloc(size, align);
-#else
-    return aligned_alloc(align, size);
-#endif
+    return vkd3d_allocate(size, align, false, VKD3D_MEMORY_TAG);
 }
 
 static inline void vkd3d_free_aligned(void *ptr)
 {
-#ifdef _WIN32
-    _aligned_free(ptr);
-#else
-    free(ptr);
-#endif
+    vkd3d_deallocate(ptr);
 }
 
 #endif  /* __VKD3D_MEMORY_H */
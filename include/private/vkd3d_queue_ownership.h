@@ -0,0 +1,104 @@
+/*
+ * Copyright 2026 agent
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __VKD3D_QUEUE_OWNERSHIP_H
+#define __VKD3D_QUEUE_OWNERSHIP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "vkd3d_spinlock.h"
+
+/* Matches VK_QUEUE_FAMILY_IGNORED. */
+#define VKD3D_QUEUE_OWNERSHIP_NONE (~0u)
+
+/* Tracks which queue family owns a resource created with exclusive sharing.
+ * Queues are opaque tokens, the last queue to use the resource within the owning
+ * family is the one which must release ownership when another family uses it.
+ * Updates happen in submission order on the queue worker threads. */
+struct vkd3d_queue_ownership
+{
+    spinlock_t lock;
+    uint32_t family;
+    const void *queue;
+};
+
+struct vkd3d_queue_ownership_transfer
+{
+    const void *release_queue;
+    uint32_t src_family;
+    uint32_t dst_family;
+};
+
+static inline void vkd3d_queue_ownership_init(struct vkd3d_queue_ownership *ownership)
+{
+    spinlock_init(&ownership->lock);
+    ownership->family = VKD3D_QUEUE_OWNERSHIP_NONE;
+    ownership->queue = NULL;
+}
+
+/* Makes queue the owner without a transfer. Used when the previous contents
+ * are discarded anyway, e.g. for the initial layout transition. */
+static inline void vkd3d_queue_ownership_reset(struct vkd3d_queue_ownership *ownership,
+        const void *queue, uint32_t family)
+{
+    spinlock_acquire(&ownership->lock);
+    ownership->family = family;
+    ownership->queue = queue;
+    spinlock_release(&ownership->lock);
+}
+
+/* Records a use by queue. Returns true if ownership must be released by the previous
+ * owner and acquired by queue before the use, in which case transfer is filled in. */
+static inline bool vkd3d_queue_ownership_acquire(struct vkd3d_queue_ownership *ownership,
+        const void *queue, uint32_t family, struct vkd3d_queue_ownership_transfer *transfer)
+{
+    bool needs_transfer;
+
+    spinlock_acquire(&ownership->lock);
+
+    needs_transfer = ownership->family != VKD3D_QUEUE_OWNERSHIP_NONE && ownership->family != family;
+
+    if (needs_transfer)
+    {
+        transfer->release_queue = ownership->queue;
+        transfer->src_family = ownership->family;
+        transfer->dst_family = family;
+    }
+
+    ownership->family = family;
+    ownership->queue = queue;
+
+    spinlock_release(&ownership->lock);
+    return needs_transfer;
+}
+
+/* Returns the queue which would have to release ownership if family used the resource now,
+ * or NULL. The result is only a hint since other queues may use the resource concurrently. */
+static inline const void *vkd3d_queue_ownership_peek_release_queue(struct vkd3d_queue_ownership *ownership,
+        uint32_t family)
+{
+    const void *queue = NULL;
+
+    spinlock_acquire(&ownership->lock);
+    if (ownership->family != VKD3D_QUEUE_OWNERSHIP_NONE && ownership->family != family)
+        queue = ownership->queue;
+    spinlock_release(&ownership->lock);
+    return queue;
+}
+
+#endif /* __VKD3D_QUEUE_OWNERSHIP_H */
@@ -28,9 +28,11 @@
 static inline void rw_spinlock_acquire_read(spinlock_t *spinlock)
 {
     uint32_t count = vkd3d_atomic_uint32_add(spinlock, VKD3D_RW_SPINLOCK_READ, vkd3d_memory_order_acquire);
+    unsigned int spin_count = 0;
+
     while (count & VKD3D_RW_SPINLOCK_WRITE)
     {
-        vkd3d_pause();
+        vkd3d_spin_wait(&spin_count);
         count = vkd3d_atomic_uint32_load_explicit(spinlock, vkd3d_memory_order_acquire);
     }
 }
@@ -42,15 +44,24 @@ static inline void rw_spinlock_release_read(spinlock_t *spinlock)
 
 static inline void rw_spinlock_acquire_write(spinlock_t *spinlock)
 {
+    unsigned int spin_count = 0;
+
     while (vkd3d_atomic_uint32_load_explicit(spinlock, vkd3d_memory_order_relaxed) != VKD3D_RW_SPINLOCK_IDLE ||
             vkd3d_atomic_uint32_compare_exchange(spinlock,
                     VKD3D_RW_SPINLOCK_IDLE, VKD3D_RW_SPINLOCK_WRITE,
                     vkd3d_memory_order_acquire, vkd3d_memory_order_relaxed) != VKD3D_RW_SPINLOCK_IDLE)
     {
-        vkd3d_pause();
+        vkd3d_spin_wait(&spin_count);
     }
 }
 
+static inline bool rw_spinlock_try_acquire_write(spinlock_t *spinlock)
+{
+    return vkd3d_atomic_uint32_compare_exchange(spinlock,
+            VKD3D_RW_SPINLOCK_IDLE, VKD3D_RW_SPINLOCK_WRITE,
+            vkd3d_memory_order_acquire, vkd3d_memory_order_relaxed) == VKD3D_RW_SPINLOCK_IDLE;
+}
+
 static inline void rw_spinlock_release_write(spinlock_t *spinlock)
 {
     vkd3d_atomic_uint32_and(spinlock, ~VKD3D_RW_SPINLOCK_WRITE, vkd3d_memory_order_release);
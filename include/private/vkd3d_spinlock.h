@@ -35,33 +35,58 @@ static inline void vkd3d_pause(void)
 #endif
 }
 
-#define vkd3d_spinlock_try_lock(lock) \
-    (!vkd3d_atomic_uint32_load_explicit(lock, vkd3d_memory_order_relaxed) && \
-     !vkd3d_atomic_uint32_exchange_explicit(lock, 1u, vkd3d_memory_order_acquire))
-
-#define vkd3d_spinlock_unlock(lock) vkd3d_atomic_uint32_store_explicit(lock, 0u, vkd3d_memory_order_release)
+/* Locks are plain words so they can be zero-initialized statically.
+ * Contended acquires spin with exponential backoff for a bounded
+ * time, then park the thread until the holder releases the lock. */
+#define VKD3D_SPINLOCK_FREE 0u
+#define VKD3D_SPINLOCK_LOCKED 1u
+#define VKD3D_SPINLOCK_CONTENDED 2u
 
 typedef uint32_t spinlock_t;
 
+/* In profiling builds, contention counters are kept per lock and exported as
+ * profiling blocks. The site is the function which took the lock. */
+void vkd3d_spinlock_acquire_slow(spinlock_t *lock, const char *site);
+void vkd3d_spinlock_wake(spinlock_t *lock);
+void vkd3d_spinlock_count_acquisition(spinlock_t *lock, const char *site);
+void vkd3d_spin_wait(unsigned int *spin_count);
+
 static inline void spinlock_init(spinlock_t *lock)
 {
-    *lock = 0;
+    *lock = VKD3D_SPINLOCK_FREE;
 }
 
 static inline bool spinlock_try_acquire(spinlock_t *lock)
 {
-    return vkd3d_spinlock_try_lock(lock);
+    return vkd3d_atomic_uint32_load_explicit(lock, vkd3d_memory_order_relaxed) == VKD3D_SPINLOCK_FREE &&
+            vkd3d_atomic_uint32_compare_exchange(lock, VKD3D_SPINLOCK_FREE, VKD3D_SPINLOCK_LOCKED,
+                    vkd3d_memory_order_acquire, vkd3d_memory_order_relaxed) == VKD3D_SPINLOCK_FREE;
+}
+
+static inline void spinlock_acquire_site(spinlock_t *lock, const char *site)
+{
+    if (!spinlock_try_acquire(lock))
+        vkd3d_spinlock_acquire_slow(lock, site);
+    else if (site)
+        vkd3d_spinlock_count_acquisition(lock, site);
 }
 
+#if defined(VKD3D_ENABLE_PROFILING) && !defined(VKD3D_SPINLOCK_NO_STATS)
+/* Users inside the profiling and logging code define VKD3D_SPINLOCK_NO_STATS,
+ * since publishing counters goes through them. */
+#define spinlock_acquire(lock) spinlock_acquire_site(lock, __func__)
+#else
 static inline void spinlock_acquire(spinlock_t *lock)
 {
-    while (!spinlock_try_acquire(lock))
-        vkd3d_pause();
+    spinlock_acquire_site(lock, NULL);
 }
+#endif
 
 static inline void spinlock_release(spinlock_t *lock)
 {
-    vkd3d_spinlock_unlock(lock);
+    if (vkd3d_atomic_uint32_exchange_explicit(lock, VKD3D_SPINLOCK_FREE,
+            vkd3d_memory_order_release) == VKD3D_SPINLOCK_CONTENDED)
+        vkd3d_spinlock_wake(lock);
 }
 
 #endif
@@ -25,6 +25,7 @@
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <errno.h>
 
 /* pthread_t is passed by value in some functions,
  * which implies we need pthread_t to be a pointer type here. */
@@ -103,6 +104,11 @@ static inline int pthread_mutex_lock(pthread_mutex_t *lock)
     return 0;
 }
 
+static inline int pthread_mutex_trylock(pthread_mutex_t *lock)
+{
+    return TryAcquireSRWLockExclusive(&lock->lock) ? 0 : EBUSY;
+}
+
 static inline int pthread_mutex_unlock(pthread_mutex_t *lock)
 {
     ReleaseSRWLockExclusive(&lock->lock);
@@ -175,6 +181,10 @@ static inline void vkd3d_set_thread_name(const char *name)
 #define PTHREAD_ONCE_CALLBACK
 #endif
 
+#ifndef _WIN32
+#include <time.h>
+#endif
+
 #ifdef __linux__
 #include <sys/types.h>
 #include <unistd.h>
@@ -192,4 +202,32 @@ static inline unsigned int vkd3d_get_current_thread_id(void)
 #endif
 }
 
+static inline unsigned int vkd3d_get_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#elif defined(__linux__)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
+#else
+    return 1;
+#endif
+}
+
+static inline uint64_t vkd3d_get_current_time_ns(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER li, lf;
+    QueryPerformanceCounter(&li);
+    QueryPerformanceFrequency(&lf);
+    return (li.QuadPart / lf.QuadPart) * 1000000000ull + ((li.QuadPart % lf.QuadPart) * 1000000000ull) / lf.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
 #endif /* __VKD3D_THREADS_H */
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 agent
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __VKD3D_TILE_MAP_H
+#define __VKD3D_TILE_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Tiles [tile_index, tile_index + tile_count) are mapped to memory, starting at offset
+ * and advancing by one tile size per tile. Memory is an opaque non-zero handle. */
+struct vkd3d_tile_run
+{
+    uint32_t tile_index;
+    uint32_t tile_count;
+    uint64_t memory;
+    uint64_t offset;
+};
+
+/* Run-length encoded tile mappings, sorted by tile index. Only mapped runs are
+ * stored, so the size depends on how fragmented the mapping is rather than on
+ * the size of the resource. Adjacent runs with contiguous memory are merged. */
+struct vkd3d_tile_map
+{
+    struct vkd3d_tile_run *runs;
+    size_t run_count;
+    size_t runs_size;
+    uint64_t tile_size;
+};
+
+void vkd3d_tile_map_init(struct vkd3d_tile_map *map, uint64_t tile_size);
+void vkd3d_tile_map_cleanup(struct vkd3d_tile_map *map);
+
+/* Overrides the mapping of a range of tiles. A memory handle of 0 is stored
+ * as an explicit run, use vkd3d_tile_map_unmap() to remove mappings instead.
+ * Returns false on allocation failure, in which case the map is unchanged. */
+bool vkd3d_tile_map_set(struct vkd3d_tile_map *map, uint32_t tile_index, uint32_t tile_count,
+        uint64_t memory, uint64_t offset);
+bool vkd3d_tile_map_unmap(struct vkd3d_tile_map *map, uint32_t tile_index, uint32_t tile_count);
+
+/* Returns the number of tiles starting at tile_index, at most tile_count, which share
+ * one contiguous mapping. Unmapped tiles are returned with memory and offset set to 0. */
+uint32_t vkd3d_tile_map_query(const struct vkd3d_tile_map *map, uint32_t tile_index, uint32_t tile_count,
+        uint64_t *memory, uint64_t *offset);
+
+size_t vkd3d_tile_map_get_allocated_size(const struct vkd3d_tile_map *map);
+
+#endif /* __VKD3D_TILE_MAP_H */
@@ -74,6 +74,8 @@ enum vkd3d_config_flags
     VKD3D_CONFIG_FLAG_LOG_MEMORY_BUDGET = 0x00000800,
     VKD3D_CONFIG_FLAG_IGNORE_RTV_HOST_VISIBLE = 0x00001000,
     VKD3D_CONFIG_FLAG_FORCE_HOST_CACHED = 0x00002000,
+    VKD3D_CONFIG_FLAG_QUEUE_OWNERSHIP_TRANSFER = 0x00004000,
+    VKD3D_CONFIG_FLAG_NO_DEFERRED_COMPILE = 0x00008000,
 };
 
 typedef HRESULT (*PFN_vkd3d_signal_event)(HANDLE event);
@@ -169,6 +171,10 @@ VKD3D_EXPORT HRESULT vkd3d_serialize_versioned_root_signature(const D3D12_VERSIO
 VKD3D_EXPORT HRESULT vkd3d_create_versioned_root_signature_deserializer(const void *data, SIZE_T data_size,
         REFIID iid, void **deserializer);
 
+/* Must be called before any other vkd3d function. The callbacks
+ * are used for host allocations made by vkd3d and by the driver. */
+VKD3D_EXPORT HRESULT vkd3d_set_host_allocator(const VkAllocationCallbacks *allocator);
+
 #endif  /* VKD3D_NO_PROTOTYPES */
 
 /*
@@ -212,6 +218,8 @@ typedef HRESULT (*PFN_vkd3d_serialize_versioned_root_signature)(const D3D12_VERS
 typedef HRESULT (*PFN_vkd3d_create_versioned_root_signature_deserializer)(const void *data, SIZE_T data_size,
         REFIID iid, void **deserializer);
 
+typedef HRESULT (*PFN_vkd3d_set_host_allocator)(const VkAllocationCallbacks *allocator);
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
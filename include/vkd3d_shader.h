@@ -46,6 +46,8 @@ enum vkd3d_shader_visibility
     VKD3D_SHADER_VISIBILITY_DOMAIN = 3,
     VKD3D_SHADER_VISIBILITY_GEOMETRY = 4,
     VKD3D_SHADER_VISIBILITY_PIXEL = 5,
+    VKD3D_SHADER_VISIBILITY_AMPLIFICATION = 6,
+    VKD3D_SHADER_VISIBILITY_MESH = 7,
 
     VKD3D_SHADER_VISIBILITY_COMPUTE = 1000000000,
 
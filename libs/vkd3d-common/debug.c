@@ -17,6 +17,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_COUNT
+#define VKD3D_SPINLOCK_NO_STATS
 #include "vkd3d_debug.h"
 #include "vkd3d_threads.h"
 
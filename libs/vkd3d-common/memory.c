@@ -20,6 +20,10 @@
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
 
 #include "vkd3d_memory.h"
+#include "vkd3d_atomic.h"
+#include "vkd3d_threads.h"
+
+#include <string.h>
 
 bool vkd3d_array_reserve(void **elements, size_t *capacity, size_t element_count, size_t element_size)
 {
@@ -48,3 +52,472 @@ bool vkd3d_array_reserve(void **elements, size_t *capacity, size_t element_count
 
     return true;
 }
+
+/* Allocations carry a small header in front of the returned pointer, so
+ * that frees can be accounted to the right subsystem and blocks with
+ * stricter alignment can be returned to the backend. */
+struct vkd3d_allocation_header
+{
+    uint64_t size;
+    uint32_t tag;
+    uint32_t offset;
+};
+
+#define VKD3D_ALLOCATION_HEADER_SIZE 16
+STATIC_ASSERT(sizeof(struct vkd3d_allocation_header) == VKD3D_ALLOCATION_HEADER_SIZE);
+
+/* Returned pointers are always 16 byte aligned, but backends are only assumed to
+ * align like malloc(), which only guarantees 8 bytes on 32-bit. Blocks are padded
+ * so that the header can be pushed forward to the next aligned address. */
+#define VKD3D_ALLOCATION_MIN_ALIGNMENT 16
+#define VKD3D_BACKEND_ALIGNMENT (2 * sizeof(void *))
+#define VKD3D_ALLOCATION_PADDING (VKD3D_ALLOCATION_HEADER_SIZE + VKD3D_ALLOCATION_MIN_ALIGNMENT - VKD3D_BACKEND_ALIGNMENT)
+
+struct vkd3d_memory_counters
+{
+    uint64_t live_bytes;
+    uint64_t live_allocations;
+    uint64_t total_allocations;
+    /* Keep subsystems on separate cache lines. */
+    uint64_t padding[5];
+};
+
+static struct vkd3d_memory_counters vkd3d_memory_counters[VKD3D_MEMORY_TAG_COUNT];
+
+static void *vkd3d_libc_allocate(void *userdata, size_t size, bool zero)
+{
+    return zero ? calloc(1, size) : malloc(size);
+}
+
+static void *vkd3d_libc_reallocate(void *userdata, void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+static void vkd3d_libc_free(void *userdata, void *ptr)
+{
+    free(ptr);
+}
+
+static const struct vkd3d_host_allocator vkd3d_libc_allocator =
+{
+    vkd3d_libc_allocate,
+    vkd3d_libc_reallocate,
+    vkd3d_libc_free,
+    NULL,
+};
+
+static struct vkd3d_host_allocator vkd3d_host_allocator =
+{
+    vkd3d_libc_allocate,
+    vkd3d_libc_reallocate,
+    vkd3d_libc_free,
+    NULL,
+};
+
+#ifdef VKD3D_ENABLE_PROFILING
+static const char * const vkd3d_memory_tag_names[VKD3D_MEMORY_TAG_COUNT] =
+{
+    "Host memory: misc",
+    "Host memory: resource",
+    "Host memory: descriptor",
+    "Host memory: command",
+    "Host memory: bundle",
+    "Host memory: pipeline",
+    "Host memory: shader",
+    "Host memory: vulkan",
+};
+
+static spinlock_t vkd3d_memory_region_locks[VKD3D_MEMORY_TAG_COUNT];
+static uint32_t vkd3d_memory_region_latches[VKD3D_MEMORY_TAG_COUNT];
+
+static void vkd3d_memory_publish_counters(enum vkd3d_memory_tag tag, uint64_t live_bytes)
+{
+    unsigned int index;
+
+    if (!vkd3d_uses_profiling())
+        return;
+
+    if (!(index = vkd3d_atomic_uint32_load_explicit(&vkd3d_memory_region_latches[tag], vkd3d_memory_order_acquire)))
+    {
+        index = vkd3d_profiling_register_region(vkd3d_memory_tag_names[tag],
+                &vkd3d_memory_region_locks[tag], &vkd3d_memory_region_latches[tag]);
+    }
+
+    vkd3d_profiling_set_counter(index, live_bytes, vkd3d_atomic_uint64_load_explicit(
+            &vkd3d_memory_counters[tag].total_allocations, vkd3d_memory_order_relaxed));
+}
+#endif
+
+/* Small blocks are recycled through a per-thread cache and accounting is
+ * batched per thread, so the common alloc/free pair does not touch any
+ * shared cache line. */
+#define VKD3D_SMALL_BLOCK_GRANULARITY 16
+#define VKD3D_SMALL_BLOCK_CLASS_COUNT 16
+#define VKD3D_SMALL_BLOCK_MAX_SIZE (VKD3D_SMALL_BLOCK_GRANULARITY * VKD3D_SMALL_BLOCK_CLASS_COUNT)
+#define VKD3D_SMALL_BLOCK_CACHE_DEPTH 32
+#define VKD3D_MEMORY_COUNTER_FLUSH_INTERVAL 64
+
+struct vkd3d_memory_thread_cache
+{
+    void *free_lists[VKD3D_SMALL_BLOCK_CLASS_COUNT];
+    uint32_t free_counts[VKD3D_SMALL_BLOCK_CLASS_COUNT];
+    uint32_t generation;
+    uint32_t pending_ops;
+    bool registered;
+    int64_t pending_bytes[VKD3D_MEMORY_TAG_COUNT];
+    int64_t pending_allocations[VKD3D_MEMORY_TAG_COUNT];
+    uint64_t pending_totals[VKD3D_MEMORY_TAG_COUNT];
+};
+
+static VKD3D_THREAD_LOCAL struct vkd3d_memory_thread_cache vkd3d_memory_thread_cache;
+
+/* Bumped whenever the backend changes, so that caches holding blocks
+ * from a previous backend are abandoned rather than recycled. */
+static uint32_t vkd3d_host_allocator_generation;
+
+static void vkd3d_memory_flush_counters(struct vkd3d_memory_thread_cache *cache)
+{
+    struct vkd3d_memory_counters *counters;
+    uint64_t live_bytes;
+    unsigned int i;
+
+    for (i = 0; i < VKD3D_MEMORY_TAG_COUNT; i++)
+    {
+        if (!cache->pending_totals[i] && !cache->pending_allocations[i] && !cache->pending_bytes[i])
+            continue;
+
+        counters = &vkd3d_memory_counters[i];
+        live_bytes = vkd3d_atomic_uint64_add(&counters->live_bytes,
+                (uint64_t)cache->pending_bytes[i], vkd3d_memory_order_relaxed);
+        vkd3d_atomic_uint64_add(&counters->live_allocations,
+                (uint64_t)cache->pending_allocations[i], vkd3d_memory_order_relaxed);
+        vkd3d_atomic_uint64_add(&counters->total_allocations,
+                cache->pending_totals[i], vkd3d_memory_order_relaxed);
+
+#ifdef VKD3D_ENABLE_PROFILING
+        vkd3d_memory_publish_counters(i, live_bytes);
+#else
+        (void)live_bytes;
+#endif
+
+        cache->pending_bytes[i] = 0;
+        cache->pending_allocations[i] = 0;
+        cache->pending_totals[i] = 0;
+    }
+
+    cache->pending_ops = 0;
+}
+
+static void vkd3d_memory_drain_thread_cache(struct vkd3d_memory_thread_cache *cache)
+{
+    unsigned int i;
+    void *block;
+
+    if (cache->generation == vkd3d_atomic_uint32_load_explicit(&vkd3d_host_allocator_generation,
+            vkd3d_memory_order_acquire))
+    {
+        for (i = 0; i < VKD3D_SMALL_BLOCK_CLASS_COUNT; i++)
+        {
+            while ((block = cache->free_lists[i]))
+            {
+                cache->free_lists[i] = *(void **)block;
+                vkd3d_host_allocator.pfn_free(vkd3d_host_allocator.userdata, block);
+            }
+        }
+    }
+
+    memset(cache->free_lists, 0, sizeof(cache->free_lists));
+    memset(cache->free_counts, 0, sizeof(cache->free_counts));
+}
+
+static void vkd3d_memory_thread_exit(void *data)
+{
+    struct vkd3d_memory_thread_cache *cache = data;
+
+    vkd3d_memory_drain_thread_cache(cache);
+    vkd3d_memory_flush_counters(cache);
+    cache->registered = false;
+}
+
+#ifdef _WIN32
+static DWORD vkd3d_memory_thread_exit_index = FLS_OUT_OF_INDEXES;
+
+static void WINAPI vkd3d_memory_fls_callback(void *data)
+{
+    if (data)
+        vkd3d_memory_thread_exit(data);
+}
+
+static void vkd3d_memory_cleanup_thread_exit(void)
+{
+    if (vkd3d_memory_thread_exit_index == FLS_OUT_OF_INDEXES)
+        return;
+
+    FlsFree(vkd3d_memory_thread_exit_index);
+    vkd3d_memory_thread_exit_index = FLS_OUT_OF_INDEXES;
+}
+
+static void vkd3d_memory_init_thread_exit(void)
+{
+    vkd3d_memory_thread_exit_index = FlsAlloc(vkd3d_memory_fls_callback);
+}
+
+static bool vkd3d_memory_register_thread_exit(struct vkd3d_memory_thread_cache *cache)
+{
+    return vkd3d_memory_thread_exit_index != FLS_OUT_OF_INDEXES &&
+            FlsSetValue(vkd3d_memory_thread_exit_index, cache);
+}
+#else
+static pthread_key_t vkd3d_memory_thread_exit_key;
+static bool vkd3d_memory_thread_exit_key_valid;
+
+static void vkd3d_memory_cleanup_thread_exit(void)
+{
+    if (!vkd3d_memory_thread_exit_key_valid)
+        return;
+
+    pthread_key_delete(vkd3d_memory_thread_exit_key);
+    vkd3d_memory_thread_exit_key_valid = false;
+}
+
+static void vkd3d_memory_init_thread_exit(void)
+{
+    vkd3d_memory_thread_exit_key_valid = !pthread_key_create(&vkd3d_memory_thread_exit_key,
+            vkd3d_memory_thread_exit);
+}
+
+static bool vkd3d_memory_register_thread_exit(struct vkd3d_memory_thread_cache *cache)
+{
+    return vkd3d_memory_thread_exit_key_valid &&
+            !pthread_setspecific(vkd3d_memory_thread_exit_key, cache);
+}
+#endif
+
+static pthread_once_t vkd3d_memory_thread_exit_once = PTHREAD_ONCE_INIT;
+
+static void vkd3d_memory_init_thread_exit_once(void)
+{
+    vkd3d_memory_init_thread_exit();
+
+    /* The exit callback lives in this module, so it must be unregistered before the
+     * module goes away. atexit() handlers of a shared library or DLL run when it is
+     * unloaded, which makes this the library destructor. */
+    atexit(vkd3d_memory_cleanup_thread_exit);
+}
+
+/* Blocks are only cached on threads which will hand them back on exit. */
+static bool vkd3d_memory_thread_cache_usable(struct vkd3d_memory_thread_cache *cache)
+{
+    uint32_t generation = vkd3d_atomic_uint32_load_explicit(&vkd3d_host_allocator_generation,
+            vkd3d_memory_order_relaxed);
+
+    if (cache->generation != generation)
+    {
+        memset(cache->free_lists, 0, sizeof(cache->free_lists));
+        memset(cache->free_counts, 0, sizeof(cache->free_counts));
+        cache->generation = generation;
+    }
+
+    if (!cache->registered)
+    {
+        pthread_once(&vkd3d_memory_thread_exit_once, vkd3d_memory_init_thread_exit_once);
+        cache->registered = vkd3d_memory_register_thread_exit(cache);
+    }
+
+    return cache->registered;
+}
+
+static inline void vkd3d_memory_account(struct vkd3d_memory_thread_cache *cache,
+        enum vkd3d_memory_tag tag, int64_t bytes, int64_t allocations, uint64_t totals)
+{
+    cache->pending_bytes[tag] += bytes;
+    cache->pending_allocations[tag] += allocations;
+    cache->pending_totals[tag] += totals;
+
+    if (++cache->pending_ops >= VKD3D_MEMORY_COUNTER_FLUSH_INTERVAL)
+        vkd3d_memory_flush_counters(cache);
+}
+
+static inline unsigned int vkd3d_small_block_class(size_t size)
+{
+    return size ? (size - 1) / VKD3D_SMALL_BLOCK_GRANULARITY : 0;
+}
+
+/* Small blocks are rounded up to their class size, so that any block in
+ * a class can be recycled for any request of that class. */
+static inline size_t vkd3d_allocation_capacity(size_t size)
+{
+    if (size > VKD3D_SMALL_BLOCK_MAX_SIZE)
+        return size;
+    return (vkd3d_small_block_class(size) + 1) * VKD3D_SMALL_BLOCK_GRANULARITY;
+}
+
+static inline struct vkd3d_allocation_header *vkd3d_allocation_get_header(void *ptr)
+{
+    return (struct vkd3d_allocation_header *)((char *)ptr - VKD3D_ALLOCATION_HEADER_SIZE);
+}
+
+bool vkd3d_set_host_allocator_backend(const struct vkd3d_host_allocator *allocator)
+{
+    struct vkd3d_memory_thread_cache *cache = &vkd3d_memory_thread_cache;
+    struct vkd3d_memory_stats stats;
+    unsigned int i;
+
+    /* Counters of other threads are only published periodically,
+     * so this check is best-effort. */
+    vkd3d_memory_flush_counters(cache);
+
+    for (i = 0; i < VKD3D_MEMORY_TAG_COUNT; i++)
+    {
+        vkd3d_get_memory_stats(i, &stats);
+        if (stats.live_allocations)
+        {
+            ERR("Cannot replace host allocator with live allocations.\n");
+            return false;
+        }
+    }
+
+    vkd3d_memory_drain_thread_cache(cache);
+    vkd3d_host_allocator = allocator ? *allocator : vkd3d_libc_allocator;
+    vkd3d_atomic_uint32_increment(&vkd3d_host_allocator_generation, vkd3d_memory_order_release);
+    return true;
+}
+
+void vkd3d_get_memory_stats(enum vkd3d_memory_tag tag, struct vkd3d_memory_stats *stats)
+{
+    struct vkd3d_memory_counters *counters = &vkd3d_memory_counters[tag];
+
+    stats->live_bytes = vkd3d_atomic_uint64_load_explicit(&counters->live_bytes, vkd3d_memory_order_relaxed);
+    stats->live_allocations = vkd3d_atomic_uint64_load_explicit(&counters->live_allocations, vkd3d_memory_order_relaxed);
+    stats->total_allocations = vkd3d_atomic_uint64_load_explicit(&counters->total_allocations, vkd3d_memory_order_relaxed);
+}
+
+void *vkd3d_allocate(size_t size, size_t alignment, bool zero, enum vkd3d_memory_tag tag)
+{
+    struct vkd3d_memory_thread_cache *cache = &vkd3d_memory_thread_cache;
+    struct vkd3d_allocation_header *header;
+    unsigned int class_index;
+    size_t padding;
+    char *block;
+    char *ptr;
+
+    if (alignment <= VKD3D_ALLOCATION_MIN_ALIGNMENT && size <= VKD3D_SMALL_BLOCK_MAX_SIZE)
+    {
+        class_index = vkd3d_small_block_class(size);
+
+        if (cache->free_lists[class_index] && vkd3d_memory_thread_cache_usable(cache) &&
+                (block = cache->free_lists[class_index]))
+        {
+            cache->free_lists[class_index] = *(void **)block;
+            cache->free_counts[class_index]--;
+            ptr = (char *)align((uintptr_t)block + VKD3D_ALLOCATION_HEADER_SIZE, VKD3D_ALLOCATION_MIN_ALIGNMENT);
+            if (zero)
+                memset(ptr, 0, size);
+        }
+        else
+        {
+            if (!(block = vkd3d_host_allocator.pfn_allocate(vkd3d_host_allocator.userdata,
+                    vkd3d_allocation_capacity(size) + VKD3D_ALLOCATION_PADDING, zero)))
+                return NULL;
+            ptr = (char *)align((uintptr_t)block + VKD3D_ALLOCATION_HEADER_SIZE, VKD3D_ALLOCATION_MIN_ALIGNMENT);
+        }
+    }
+    else
+    {
+        alignment = max(alignment, VKD3D_ALLOCATION_MIN_ALIGNMENT);
+        padding = VKD3D_ALLOCATION_HEADER_SIZE + alignment - VKD3D_BACKEND_ALIGNMENT;
+
+        if (size > ~(size_t)0 - padding)
+            return NULL;
+
+        if (!(block = vkd3d_host_allocator.pfn_allocate(vkd3d_host_allocator.userdata, size + padding, zero)))
+            return NULL;
+
+        ptr = (char *)align((uintptr_t)block + VKD3D_ALLOCATION_HEADER_SIZE, alignment);
+    }
+
+    header = vkd3d_allocation_get_header(ptr);
+    header->size = size;
+    header->tag = tag;
+    header->offset = ptr - block;
+
+    vkd3d_memory_account(cache, tag, size, 1, 1);
+    return ptr;
+}
+
+void *vkd3d_reallocate(void *ptr, size_t size, size_t alignment, enum vkd3d_memory_tag tag)
+{
+    struct vkd3d_allocation_header *header;
+    uint64_t old_size;
+    size_t capacity;
+    char *block;
+    void *new_ptr;
+
+    if (!ptr)
+        return vkd3d_allocate(size, alignment, false, tag);
+
+    header = vkd3d_allocation_get_header(ptr);
+    old_size = header->size;
+    tag = header->tag;
+
+    if (VKD3D_BACKEND_ALIGNMENT < VKD3D_ALLOCATION_MIN_ALIGNMENT ||
+            header->offset != VKD3D_ALLOCATION_HEADER_SIZE || alignment > VKD3D_ALLOCATION_MIN_ALIGNMENT)
+    {
+        /* The backend cannot preserve our alignment padding, move the data ourselves. */
+        if (!(new_ptr = vkd3d_allocate(size, alignment, false, tag)))
+            return NULL;
+        memcpy(new_ptr, ptr, min(old_size, size));
+        vkd3d_deallocate(ptr);
+        return new_ptr;
+    }
+
+    if (size > ~(size_t)0 - VKD3D_ALLOCATION_HEADER_SIZE)
+        return NULL;
+
+    capacity = vkd3d_allocation_capacity(size);
+    if (capacity != vkd3d_allocation_capacity(old_size))
+    {
+        if (!(block = vkd3d_host_allocator.pfn_reallocate(vkd3d_host_allocator.userdata,
+                header, capacity + VKD3D_ALLOCATION_HEADER_SIZE)))
+            return NULL;
+        header = (struct vkd3d_allocation_header *)block;
+    }
+
+    header->size = size;
+
+    vkd3d_memory_account(&vkd3d_memory_thread_cache, tag, (int64_t)size - (int64_t)old_size, 0, 0);
+    return (char *)header + VKD3D_ALLOCATION_HEADER_SIZE;
+}
+
+void vkd3d_deallocate(void *ptr)
+{
+    struct vkd3d_memory_thread_cache *cache = &vkd3d_memory_thread_cache;
+    struct vkd3d_allocation_header *header;
+    unsigned int class_index;
+    char *block;
+
+    if (!ptr)
+        return;
+
+    header = vkd3d_allocation_get_header(ptr);
+    block = (char *)ptr - header->offset;
+    vkd3d_memory_account(cache, header->tag, -(int64_t)header->size, -1, 0);
+
+    /* Over-aligned small blocks are large enough to be recycled as well,
+     * since the allocation path recomputes the aligned pointer. */
+    if (header->offset <= VKD3D_ALLOCATION_PADDING && header->size <= VKD3D_SMALL_BLOCK_MAX_SIZE)
+    {
+        class_index = vkd3d_small_block_class(header->size);
+        if (cache->free_counts[class_index] < VKD3D_SMALL_BLOCK_CACHE_DEPTH &&
+                vkd3d_memory_thread_cache_usable(cache))
+        {
+            *(void **)block = cache->free_lists[class_index];
+            cache->free_lists[class_index] = block;
+            cache->free_counts[class_index]++;
+            return;
+        }
+    }
+
+    vkd3d_host_allocator.pfn_free(vkd3d_host_allocator.userdata, block);
+}
@@ -19,6 +19,7 @@
 #ifdef VKD3D_ENABLE_PROFILING
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_SPINLOCK_NO_STATS
 
 #include "vkd3d_profiling.h"
 #include "vkd3d_threads.h"
@@ -50,7 +51,7 @@ struct vkd3d_profiling_block
 
 static struct vkd3d_profiling_block *mapped_blocks;
 
-#define VKD3D_MAX_PROFILING_REGIONS 256
+#define VKD3D_MAX_PROFILING_REGIONS 1024
 static spinlock_t region_locks[VKD3D_MAX_PROFILING_REGIONS];
 
 #ifdef _WIN32
@@ -192,4 +193,23 @@ void vkd3d_profiling_notify_work(unsigned int index,
     spinlock_release(lock);
 }
 
+void vkd3d_profiling_set_counter(unsigned int index, uint64_t value, uint64_t count)
+{
+    struct vkd3d_profiling_block *block;
+    spinlock_t *lock;
+
+    if (index == 0 || index > VKD3D_MAX_PROFILING_REGIONS || !mapped_blocks)
+        return;
+    index--;
+
+    lock = &region_locks[index];
+    block = &mapped_blocks[index];
+
+    /* Counters are not timings, the value is stored in place of the tick count. */
+    spinlock_acquire(lock);
+    block->ticks_total = value;
+    block->iteration_total = count;
+    spinlock_release(lock);
+}
+
 #endif /* VKD3D_ENABLE_PROFILING */
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2026 agent
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_SPINLOCK_NO_STATS
+
+#include "vkd3d_debug.h"
+#include "vkd3d_profiling.h"
+#include "vkd3d_spinlock.h"
+
+#include <stdio.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* Backoff doubles the number of pauses per round up to the cap. With the
+ * default values, a waiter spins for a few microseconds before parking,
+ * which covers typical critical sections without burning a whole
+ * timeslice when the holder has been preempted. */
+#define VKD3D_SPINLOCK_MAX_PAUSES_PER_ROUND 64u
+#define VKD3D_SPINLOCK_SPIN_ROUNDS 12u
+
+/* Publish acquisition counts periodically even without contention. */
+#define VKD3D_SPINLOCK_PUBLISH_INTERVAL 4096u
+
+static inline void vkd3d_spinlock_yield(void)
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static void vkd3d_spinlock_park(spinlock_t *lock)
+{
+#ifdef _WIN32
+    uint32_t contended = VKD3D_SPINLOCK_CONTENDED;
+    WaitOnAddress(lock, &contended, sizeof(*lock), INFINITE);
+#else
+    syscall(SYS_futex, lock, FUTEX_WAIT_PRIVATE, VKD3D_SPINLOCK_CONTENDED, NULL, NULL, 0);
+#endif
+}
+
+void vkd3d_spinlock_wake(spinlock_t *lock)
+{
+#ifdef _WIN32
+    WakeByAddressSingle(lock);
+#else
+    syscall(SYS_futex, lock, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#endif
+}
+
+void vkd3d_spin_wait(unsigned int *spin_count)
+{
+    unsigned int round = *spin_count, pauses, i;
+
+    if (round < VKD3D_SPINLOCK_SPIN_ROUNDS)
+    {
+        pauses = min(1u << round, VKD3D_SPINLOCK_MAX_PAUSES_PER_ROUND);
+        for (i = 0; i < pauses; i++)
+            vkd3d_pause();
+        *spin_count = round + 1;
+    }
+    else
+    {
+        vkd3d_spinlock_yield();
+    }
+}
+
+#ifdef VKD3D_ENABLE_PROFILING
+struct vkd3d_spinlock_stats
+{
+    uint64_t acquisitions;
+    uint64_t spins;
+    uint64_t parks;
+    uint64_t contended;
+    uint32_t latches[2];
+    spinlock_t region_locks[2];
+};
+
+/* Locks are plain words without room for a stats pointer, so stats live in a
+ * side table keyed by lock address. Entries are never removed, a lock which is
+ * freed and reallocated at the same address keeps counting into its old entry. */
+#define VKD3D_SPINLOCK_STATS_TABLE_SIZE 4096u
+#define VKD3D_SPINLOCK_STATS_MAX_PROBES 16u
+
+struct vkd3d_spinlock_stats_entry
+{
+    spinlock_t *lock;
+    struct vkd3d_spinlock_stats stats;
+};
+
+static struct vkd3d_spinlock_stats_entry vkd3d_spinlock_stats_table[VKD3D_SPINLOCK_STATS_TABLE_SIZE];
+/* Locks which do not find a free entry share one set of counters. */
+static struct vkd3d_spinlock_stats vkd3d_spinlock_overflow_stats;
+
+static struct vkd3d_spinlock_stats *vkd3d_spinlock_get_stats(spinlock_t *lock)
+{
+    struct vkd3d_spinlock_stats_entry *entry;
+    spinlock_t *key;
+    uint32_t hash, i;
+
+    hash = (uint32_t)(((uint64_t)(uintptr_t)lock * 0x9e3779b97f4a7c15ull) >> 32);
+
+    for (i = 0; i < VKD3D_SPINLOCK_STATS_MAX_PROBES; i++)
+    {
+        entry = &vkd3d_spinlock_stats_table[(hash + i) & (VKD3D_SPINLOCK_STATS_TABLE_SIZE - 1)];
+
+        if (!(key = vkd3d_atomic_ptr_load_explicit(&entry->lock, vkd3d_memory_order_acquire)))
+        {
+            key = vkd3d_atomic_ptr_compare_exchange(&entry->lock, NULL, lock,
+                    vkd3d_memory_order_acq_rel, vkd3d_memory_order_acquire);
+        }
+
+        if (!key || key == lock)
+            return &entry->stats;
+    }
+
+    return &vkd3d_spinlock_overflow_stats;
+}
+
+static void vkd3d_spinlock_publish_stats(struct vkd3d_spinlock_stats *stats, spinlock_t *lock, const char *site)
+{
+    static const char * const prefixes[] = { "Lock spins", "Lock parks" };
+    unsigned int index, i;
+    char name[64];
+
+    for (i = 0; i < ARRAY_SIZE(stats->latches); i++)
+    {
+        if (!(index = vkd3d_atomic_uint32_load_explicit(&stats->latches[i], vkd3d_memory_order_acquire)))
+        {
+            /* The region is named after the first site which publishes it. */
+            if (stats == &vkd3d_spinlock_overflow_stats)
+                snprintf(name, sizeof(name), "%s: other locks", prefixes[i]);
+            else
+                snprintf(name, sizeof(name), "%s: %s %p", prefixes[i], site, (void *)lock);
+            if (!(index = vkd3d_profiling_register_region(name, &stats->region_locks[i], &stats->latches[i])))
+                return;
+        }
+
+        if (i == 0)
+        {
+            vkd3d_profiling_set_counter(index,
+                    vkd3d_atomic_uint64_load_explicit(&stats->spins, vkd3d_memory_order_relaxed),
+                    vkd3d_atomic_uint64_load_explicit(&stats->acquisitions, vkd3d_memory_order_relaxed));
+        }
+        else
+        {
+            vkd3d_profiling_set_counter(index,
+                    vkd3d_atomic_uint64_load_explicit(&stats->parks, vkd3d_memory_order_relaxed),
+                    vkd3d_atomic_uint64_load_explicit(&stats->contended, vkd3d_memory_order_relaxed));
+        }
+    }
+}
+#endif
+
+void vkd3d_spinlock_count_acquisition(spinlock_t *lock, const char *site)
+{
+#ifdef VKD3D_ENABLE_PROFILING
+    struct vkd3d_spinlock_stats *stats;
+    uint64_t count;
+
+    if (!vkd3d_uses_profiling())
+        return;
+
+    stats = vkd3d_spinlock_get_stats(lock);
+    count = vkd3d_atomic_uint64_increment(&stats->acquisitions, vkd3d_memory_order_relaxed);
+    if (!(count % VKD3D_SPINLOCK_PUBLISH_INTERVAL))
+        vkd3d_spinlock_publish_stats(stats, lock, site);
+#else
+    (void)lock;
+    (void)site;
+#endif
+}
+
+void vkd3d_spinlock_acquire_slow(spinlock_t *lock, const char *site)
+{
+#ifdef VKD3D_ENABLE_PROFILING
+    struct vkd3d_spinlock_stats *stats;
+#endif
+    unsigned int spin_count = 0;
+    uint64_t spins = 0;
+    uint64_t parks = 0;
+
+    while (spin_count < VKD3D_SPINLOCK_SPIN_ROUNDS)
+    {
+        spins += min(1u << spin_count, VKD3D_SPINLOCK_MAX_PAUSES_PER_ROUND);
+        vkd3d_spin_wait(&spin_count);
+
+        if (spinlock_try_acquire(lock))
+            goto acquired;
+    }
+
+    /* Taking the lock in the contended state is conservative, the
+     * next release may issue a spurious wake. */
+    while (vkd3d_atomic_uint32_exchange_explicit(lock, VKD3D_SPINLOCK_CONTENDED,
+            vkd3d_memory_order_acquire) != VKD3D_SPINLOCK_FREE)
+    {
+        vkd3d_spinlock_park(lock);
+        parks++;
+    }
+
+acquired:
+#ifdef VKD3D_ENABLE_PROFILING
+    if (site && vkd3d_uses_profiling())
+    {
+        stats = vkd3d_spinlock_get_stats(lock);
+        vkd3d_atomic_uint64_increment(&stats->acquisitions, vkd3d_memory_order_relaxed);
+        vkd3d_atomic_uint64_increment(&stats->contended, vkd3d_memory_order_relaxed);
+        vkd3d_atomic_uint64_add(&stats->spins, spins, vkd3d_memory_order_relaxed);
+        vkd3d_atomic_uint64_add(&stats->parks, parks, vkd3d_memory_order_relaxed);
+        vkd3d_spinlock_publish_stats(stats, lock, site);
+    }
+#else
+    (void)site;
+    (void)spins;
+    (void)parks;
+#endif
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2026 agent
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_RESOURCE
+
+#include "vkd3d_tile_map.h"
+#include "vkd3d_common.h"
+#include "vkd3d_memory.h"
+
+#include <string.h>
+
+/* Don't keep much more memory around than needed after large unmaps. */
+#define VKD3D_TILE_MAP_MIN_CAPACITY 16u
+
+static inline uint64_t vkd3d_tile_run_end(const struct vkd3d_tile_run *run)
+{
+    return (uint64_t)run->tile_index + run->tile_count;
+}
+
+static bool vkd3d_tile_map_can_merge(const struct vkd3d_tile_map *map,
+        const struct vkd3d_tile_run *a, const struct vkd3d_tile_run *b)
+{
+    if (vkd3d_tile_run_end(a) != b->tile_index || a->memory != b->memory)
+        return false;
+
+    return !a->memory || b->offset == a->offset + a->tile_count * map->tile_size;
+}
+
+/* Returns the first run which ends after tile_index. */
+static size_t vkd3d_tile_map_lower_bound(const struct vkd3d_tile_map *map, uint32_t tile_index)
+{
+    size_t lo = 0, hi = map->run_count, mid;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+
+        if (vkd3d_tile_run_end(&map->runs[mid]) <= tile_index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+void vkd3d_tile_map_init(struct vkd3d_tile_map *map, uint64_t tile_size)
+{
+    memset(map, 0, sizeof(*map));
+    map->tile_size = tile_size;
+}
+
+void vkd3d_tile_map_cleanup(struct vkd3d_tile_map *map)
+{
+    vkd3d_free(map->runs);
+    memset(map, 0, sizeof(*map));
+}
+
+static void vkd3d_tile_map_shrink(struct vkd3d_tile_map *map)
+{
+    struct vkd3d_tile_run *runs;
+    size_t new_size;
+
+    if (map->runs_size <= VKD3D_TILE_MAP_MIN_CAPACITY || map->run_count >= map->runs_size / 4)
+        return;
+
+    new_size = max(map->run_count * 2, VKD3D_TILE_MAP_MIN_CAPACITY);
+
+    /* Failing to shrink is harmless. */
+    if ((runs = vkd3d_realloc(map->runs, new_size * sizeof(*runs))))
+    {
+        map->runs = runs;
+        map->runs_size = new_size;
+    }
+}
+
+static bool vkd3d_tile_map_replace(struct vkd3d_tile_map *map, uint32_t tile_index, uint32_t tile_count,
+        const struct vkd3d_tile_run *run)
+{
+    uint64_t end = (uint64_t)tile_index + tile_count;
+    struct vkd3d_tile_run replacement[3];
+    size_t lo, hi, i, count, new_count;
+    uint32_t delta;
+
+    if (!tile_count)
+        return true;
+
+    lo = vkd3d_tile_map_lower_bound(map, tile_index);
+    for (hi = lo; hi < map->run_count && map->runs[hi].tile_index < end; hi++)
+        continue;
+
+    if (lo == hi && !run)
+        return true;
+
+    count = 0;
+
+    /* Keep the parts of overlapping runs which lie outside the range. */
+    if (lo < hi && map->runs[lo].tile_index < tile_index)
+    {
+        replacement[count] = map->runs[lo];
+        replacement[count].tile_count = tile_index - map->runs[lo].tile_index;
+        count++;
+    }
+
+    if (run)
+        replacement[count++] = *run;
+
+    if (lo < hi && vkd3d_tile_run_end(&map->runs[hi - 1]) > end)
+    {
+        replacement[count] = map->runs[hi - 1];
+        delta = end - replacement[count].tile_index;
+        replacement[count].tile_index += delta;
+        replacement[count].tile_count -= delta;
+        if (replacement[count].memory)
+            replacement[count].offset += delta * map->tile_size;
+        count++;
+    }
+
+    new_count = map->run_count - (hi - lo) + count;
+
+    if (!vkd3d_array_reserve((void **)&map->runs, &map->runs_size, new_count, sizeof(*map->runs)))
+        return false;
+
+    memmove(&map->runs[lo + count], &map->runs[hi], (map->run_count - hi) * sizeof(*map->runs));
+    memcpy(&map->runs[lo], replacement, count * sizeof(*map->runs));
+    map->run_count = new_count;
+
+    /* Merge with neighbours, going backwards so indices stay valid. */
+    for (i = min(lo + count, map->run_count - 1); i >= max(lo, (size_t)1) && i < map->run_count; i--)
+    {
+        if (vkd3d_tile_map_can_merge(map, &map->runs[i - 1], &map->runs[i]))
+        {
+            map->runs[i - 1].tile_count += map->runs[i].tile_count;
+            memmove(&map->runs[i], &map->runs[i + 1], (map->run_count - i - 1) * sizeof(*map->runs));
+            map->run_count--;
+        }
+    }
+
+    vkd3d_tile_map_shrink(map);
+    return true;
+}
+
+bool vkd3d_tile_map_set(struct vkd3d_tile_map *map, uint32_t tile_index, uint32_t tile_count,
+        uint64_t memory, uint64_t offset)
+{
+    struct vkd3d_tile_run run;
+
+    run.tile_index = tile_index;
+    run.tile_count = tile_count;
+    run.memory = memory;
+    run.offset = memory ? offset : 0;
+
+    return vkd3d_tile_map_replace(map, tile_index, tile_count, &run);
+}
+
+bool vkd3d_tile_map_unmap(struct vkd3d_tile_map *map, uint32_t tile_index, uint32_t tile_count)
+{
+    return vkd3d_tile_map_replace(map, tile_index, tile_count, NULL);
+}
+
+uint32_t vkd3d_tile_map_query(const struct vkd3d_tile_map *map, uint32_t tile_index, uint32_t tile_count,
+        uint64_t *memory, uint64_t *offset)
+{
+    const struct vkd3d_tile_run *run;
+    uint32_t delta;
+    size_t lo;
+
+    lo = vkd3d_tile_map_lower_bound(map, tile_index);
+
+    if (lo < map->run_count && map->runs[lo].tile_index <= tile_index)
+    {
+        run = &map->runs[lo];
+        delta = tile_index - run->tile_index;
+        *memory = run->memory;
+        *offset = run->memory ? run->offset + delta * map->tile_size : 0;
+        return min(tile_count, run->tile_count - delta);
+    }
+
+    *memory = 0;
+    *offset = 0;
+
+    if (lo < map->run_count)
+        return min(tile_count, map->runs[lo].tile_index - tile_index);
+
+    return tile_count;
+}
+
+size_t vkd3d_tile_map_get_allocated_size(const struct vkd3d_tile_map *map)
+{
+    return map->runs_size * sizeof(*map->runs);
+}
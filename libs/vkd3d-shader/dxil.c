@@ -17,6 +17,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_SHADER
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_SHADER
 
 #include "vkd3d_shader_private.h"
 #include "vkd3d_utf8.h"
@@ -45,6 +46,10 @@ static bool dxil_match_shader_visibility(enum vkd3d_shader_visibility visibility
             return visibility == VKD3D_SHADER_VISIBILITY_PIXEL;
         case DXIL_SPV_STAGE_COMPUTE:
             return visibility == VKD3D_SHADER_VISIBILITY_COMPUTE;
+        case DXIL_SPV_STAGE_AMPLIFICATION:
+            return visibility == VKD3D_SHADER_VISIBILITY_AMPLIFICATION;
+        case DXIL_SPV_STAGE_MESH:
+            return visibility == VKD3D_SHADER_VISIBILITY_MESH;
         default:
             return false;
     }
@@ -461,6 +466,8 @@ static bool dxil_match_shader_stage(dxil_spv_shader_stage blob_stage, VkShaderSt
         case DXIL_SPV_STAGE_GEOMETRY: stage = VK_SHADER_STAGE_GEOMETRY_BIT; break;
         case DXIL_SPV_STAGE_PIXEL: stage = VK_SHADER_STAGE_FRAGMENT_BIT; break;
         case DXIL_SPV_STAGE_COMPUTE: stage = VK_SHADER_STAGE_COMPUTE_BIT; break;
+        case DXIL_SPV_STAGE_AMPLIFICATION: stage = VK_SHADER_STAGE_TASK_BIT_EXT; break;
+        case DXIL_SPV_STAGE_MESH: stage = VK_SHADER_STAGE_MESH_BIT_EXT; break;
         default: return false;
     }
 
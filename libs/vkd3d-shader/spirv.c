@@ -17,6 +17,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_SHADER
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_SHADER
 
 #include "vkd3d_shader_private.h"
 #include "vkd3d_d3d12.h"
@@ -2466,6 +2467,10 @@ static bool vkd3d_dxbc_compiler_check_shader_visibility(const struct vkd3d_dxbc_
             return compiler->shader_type == VKD3D_SHADER_TYPE_PIXEL;
         case VKD3D_SHADER_VISIBILITY_COMPUTE:
             return compiler->shader_type == VKD3D_SHADER_TYPE_COMPUTE;
+        case VKD3D_SHADER_VISIBILITY_AMPLIFICATION:
+        case VKD3D_SHADER_VISIBILITY_MESH:
+            /* Amplification and mesh shaders only exist in DXIL. */
+            return false;
         default:
             ERR("Invalid shader visibility %#x.\n", visibility);
             return false;
@@ -23,6 +23,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_SHADER
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_SHADER
 
 #include "vkd3d_shader_private.h"
 
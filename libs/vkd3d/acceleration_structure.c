@@ -192,6 +192,274 @@ bool vkd3d_acceleration_structure_convert_inputs(const struct d3d12_device *devi
     return true;
 }
 
+/* Prebuild sizes only depend on the shape of the build inputs, never on the
+ * addresses, so queries are memoized per device. Inputs with more geometries
+ * than fit in the key bypass the cache. */
+struct vkd3d_acceleration_structure_prebuild_geometry
+{
+    D3D12_RAYTRACING_GEOMETRY_TYPE type;
+    D3D12_RAYTRACING_GEOMETRY_FLAGS flags;
+    DXGI_FORMAT vertex_format;
+    DXGI_FORMAT index_format;
+    uint32_t vertex_count;
+    uint32_t element_count;
+    uint64_t stride;
+    bool has_transform;
+};
+
+struct vkd3d_acceleration_structure_prebuild_key
+{
+    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE type;
+    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS flags;
+    D3D12_ELEMENTS_LAYOUT layout;
+    uint32_t num_descs;
+    struct vkd3d_acceleration_structure_prebuild_geometry geometries[VKD3D_BUILD_INFO_STACK_COUNT];
+};
+
+struct vkd3d_acceleration_structure_prebuild_entry
+{
+    struct hash_map_entry entry;
+    struct vkd3d_acceleration_structure_prebuild_key key;
+    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO info;
+};
+
+/* Arbitrary, dynamic geometry tends to cycle through a small set of shapes.
+ * The cache is simply reset once it fills up. */
+#define VKD3D_PREBUILD_CACHE_MAX_ENTRIES 512
+
+static bool vkd3d_acceleration_structure_prebuild_key_init(struct vkd3d_acceleration_structure_prebuild_key *key,
+        const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS *desc)
+{
+    struct vkd3d_acceleration_structure_prebuild_geometry *geometry;
+    const D3D12_RAYTRACING_GEOMETRY_DESC *geom_desc;
+    unsigned int i;
+
+    key->type = desc->Type;
+    /* The build mode is ignored when querying sizes. */
+    key->flags = desc->Flags & ~D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
+    key->num_descs = desc->NumDescs;
+
+    if (desc->Type == D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL)
+    {
+        key->layout = desc->DescsLayout;
+        return true;
+    }
+
+    /* The layout only affects how we read the geometry descs. */
+    key->layout = D3D12_ELEMENTS_LAYOUT_ARRAY;
+
+    if (desc->NumDescs > ARRAY_SIZE(key->geometries))
+        return false;
+
+    for (i = 0; i < desc->NumDescs; i++)
+    {
+        if (desc->DescsLayout == D3D12_ELEMENTS_LAYOUT_ARRAY_OF_POINTERS)
+            geom_desc = desc->ppGeometryDescs[i];
+        else
+            geom_desc = &desc->pGeometryDescs[i];
+
+        geometry = &key->geometries[i];
+        memset(geometry, 0, sizeof(*geometry));
+        geometry->type = geom_desc->Type;
+        geometry->flags = geom_desc->Flags;
+
+        switch (geom_desc->Type)
+        {
+            case D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES:
+                geometry->vertex_format = geom_desc->Triangles.VertexFormat;
+                geometry->vertex_count = geom_desc->Triangles.VertexCount;
+                geometry->stride = geom_desc->Triangles.VertexBuffer.StrideInBytes;
+                /* Whether a transform is present can affect sizes in Vulkan. */
+                geometry->has_transform = !!geom_desc->Triangles.Transform3x4;
+                if (geom_desc->Triangles.IndexBuffer)
+                {
+                    geometry->index_format = geom_desc->Triangles.IndexFormat;
+                    geometry->element_count = geom_desc->Triangles.IndexCount;
+                }
+                break;
+
+            case D3D12_RAYTRACING_GEOMETRY_TYPE_PROCEDURAL_PRIMITIVE_AABBS:
+                geometry->element_count = geom_desc->AABBs.AABBCount;
+                geometry->stride = geom_desc->AABBs.AABBs.StrideInBytes;
+                break;
+
+            default:
+                /* Let the conversion report the error. */
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static uint32_t vkd3d_acceleration_structure_prebuild_entry_hash(const void *key)
+{
+    const struct vkd3d_acceleration_structure_prebuild_key *k = key;
+    const struct vkd3d_acceleration_structure_prebuild_geometry *g;
+    uint32_t hash;
+    unsigned int i;
+
+    hash = (uint32_t)k->type;
+    hash = hash_combine(hash, (uint32_t)k->flags);
+    hash = hash_combine(hash, (uint32_t)k->layout);
+    hash = hash_combine(hash, k->num_descs);
+
+    if (k->type == D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL)
+        return hash;
+
+    for (i = 0; i < k->num_descs; i++)
+    {
+        g = &k->geometries[i];
+        hash = hash_combine(hash, (uint32_t)g->type);
+        hash = hash_combine(hash, (uint32_t)g->flags);
+        hash = hash_combine(hash, (uint32_t)g->vertex_format);
+        hash = hash_combine(hash, (uint32_t)g->index_format);
+        hash = hash_combine(hash, g->vertex_count);
+        hash = hash_combine(hash, g->element_count);
+        hash = hash_combine(hash, hash_uint64(g->stride));
+        hash = hash_combine(hash, (uint32_t)g->has_transform);
+    }
+
+    return hash;
+}
+
+static bool vkd3d_acceleration_structure_prebuild_entry_compare(const void *key, const struct hash_map_entry *entry)
+{
+    const struct vkd3d_acceleration_structure_prebuild_entry *e = (const struct vkd3d_acceleration_structure_prebuild_entry *)entry;
+    const struct vkd3d_acceleration_structure_prebuild_key *k = key;
+    const struct vkd3d_acceleration_structure_prebuild_geometry *a, *b;
+    unsigned int i;
+
+    if (k->type != e->key.type || k->flags != e->key.flags ||
+            k->layout != e->key.layout || k->num_descs != e->key.num_descs)
+        return false;
+
+    if (k->type == D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL)
+        return true;
+
+    for (i = 0; i < k->num_descs; i++)
+    {
+        a = &k->geometries[i];
+        b = &e->key.geometries[i];
+
+        if (a->type != b->type || a->flags != b->flags ||
+                a->vertex_format != b->vertex_format || a->index_format != b->index_format ||
+                a->vertex_count != b->vertex_count || a->element_count != b->element_count ||
+                a->stride != b->stride || a->has_transform != b->has_transform)
+            return false;
+    }
+
+    return true;
+}
+
+void vkd3d_acceleration_structure_prebuild_cache_init(struct vkd3d_acceleration_structure_prebuild_cache *cache)
+{
+    spinlock_init(&cache->spinlock);
+    hash_map_init(&cache->map, &vkd3d_acceleration_structure_prebuild_entry_hash,
+            &vkd3d_acceleration_structure_prebuild_entry_compare,
+            sizeof(struct vkd3d_acceleration_structure_prebuild_entry));
+    cache->hit_count = 0;
+    cache->miss_count = 0;
+}
+
+void vkd3d_acceleration_structure_prebuild_cache_cleanup(struct vkd3d_acceleration_structure_prebuild_cache *cache)
+{
+    TRACE("Prebuild info cache: %"PRIu64" hits, %"PRIu64" misses.\n",
+            cache->hit_count, cache->miss_count);
+    hash_map_clear(&cache->map);
+}
+
+#ifdef VKD3D_ENABLE_PROFILING
+static spinlock_t vkd3d_prebuild_cache_region_lock;
+static uint32_t vkd3d_prebuild_cache_region_latch;
+
+static void vkd3d_acceleration_structure_prebuild_cache_publish(struct vkd3d_acceleration_structure_prebuild_cache *cache)
+{
+    uint64_t hits, misses;
+    unsigned int index;
+
+    if (!vkd3d_uses_profiling())
+        return;
+
+    if (!(index = vkd3d_atomic_uint32_load_explicit(&vkd3d_prebuild_cache_region_latch, vkd3d_memory_order_acquire)))
+    {
+        if (!(index = vkd3d_profiling_register_region("RTAS prebuild cache hits",
+                &vkd3d_prebuild_cache_region_lock, &vkd3d_prebuild_cache_region_latch)))
+            return;
+    }
+
+    hits = vkd3d_atomic_uint64_load_explicit(&cache->hit_count, vkd3d_memory_order_relaxed);
+    misses = vkd3d_atomic_uint64_load_explicit(&cache->miss_count, vkd3d_memory_order_relaxed);
+    vkd3d_profiling_set_counter(index, hits, hits + misses);
+}
+#endif
+
+bool vkd3d_acceleration_structure_get_prebuild_info(struct d3d12_device *device,
+        const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS *desc,
+        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO *info)
+{
+    struct vkd3d_acceleration_structure_prebuild_cache *cache = &device->prebuild_cache;
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    struct vkd3d_acceleration_structure_prebuild_entry entry;
+    struct vkd3d_acceleration_structure_build_info build_info;
+    const struct vkd3d_acceleration_structure_prebuild_entry *e;
+    VkAccelerationStructureBuildSizesInfoKHR size_info;
+    bool cacheable;
+
+    if ((cacheable = vkd3d_acceleration_structure_prebuild_key_init(&entry.key, desc)))
+    {
+        spinlock_acquire(&cache->spinlock);
+        if ((e = (const struct vkd3d_acceleration_structure_prebuild_entry *)hash_map_find(&cache->map, &entry.key)))
+            *info = e->info;
+        spinlock_release(&cache->spinlock);
+
+        if (e)
+        {
+            vkd3d_atomic_uint64_increment(&cache->hit_count, vkd3d_memory_order_relaxed);
+#ifdef VKD3D_ENABLE_PROFILING
+            vkd3d_acceleration_structure_prebuild_cache_publish(cache);
+#endif
+            return true;
+        }
+    }
+
+    if (!vkd3d_acceleration_structure_convert_inputs(device, &build_info, desc))
+        return false;
+
+    memset(&size_info, 0, sizeof(size_info));
+    size_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+
+    VK_CALL(vkGetAccelerationStructureBuildSizesKHR(device->vk_device,
+            VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &build_info.build_info,
+            build_info.primitive_counts, &size_info));
+
+    vkd3d_acceleration_structure_build_info_cleanup(&build_info);
+
+    info->ResultDataMaxSizeInBytes = size_info.accelerationStructureSize;
+    info->ScratchDataSizeInBytes = size_info.buildScratchSize;
+    info->UpdateScratchDataSizeInBytes = size_info.updateScratchSize;
+
+    if (cacheable)
+    {
+        entry.info = *info;
+
+        spinlock_acquire(&cache->spinlock);
+        if (cache->map.used_count >= VKD3D_PREBUILD_CACHE_MAX_ENTRIES)
+            hash_map_clear(&cache->map);
+        /* Another thread may have inserted the same key meanwhile, which is fine. */
+        if (!hash_map_insert(&cache->map, &entry.key, &entry.entry))
+            WARN("Failed to insert prebuild info into cache.\n");
+        spinlock_release(&cache->spinlock);
+
+        vkd3d_atomic_uint64_increment(&cache->miss_count, vkd3d_memory_order_relaxed);
+#ifdef VKD3D_ENABLE_PROFILING
+        vkd3d_acceleration_structure_prebuild_cache_publish(cache);
+#endif
+    }
+
+    return true;
+}
+
 static void vkd3d_acceleration_structure_end_barrier(struct d3d12_command_list *list)
 {
     /* We resolve the query in TRANSFER, but DXR expects UNORDERED_ACCESS. */
@@ -312,8 +580,7 @@ void vkd3d_acceleration_structure_emit_postbuild_info(
 
     for (i = 0; i < count; i++)
     {
-        vk_acceleration_structure = vkd3d_va_map_place_acceleration_structure(
-                &list->device->memory_allocator.va_map, list->device, addresses[i]);
+        vk_acceleration_structure = d3d12_command_list_place_acceleration_structure(list, addresses[i], 0);
         if (vk_acceleration_structure)
             vkd3d_acceleration_structure_write_postbuild_info(list, desc, i * stride, vk_acceleration_structure);
         else
@@ -383,14 +650,14 @@ void vkd3d_acceleration_structure_copy(
     VkAccelerationStructureKHR dst_as, src_as;
     VkCopyAccelerationStructureInfoKHR info;
 
-    dst_as = vkd3d_va_map_place_acceleration_structure(&list->device->memory_allocator.va_map, list->device, dst);
+    dst_as = d3d12_command_list_place_acceleration_structure(list, dst, 0);
     if (dst_as == VK_NULL_HANDLE)
     {
         ERR("Invalid dst address #%"PRIx64" for RTAS copy.\n", dst);
         return;
     }
 
-    src_as = vkd3d_va_map_place_acceleration_structure(&list->device->memory_allocator.va_map, list->device, src);
+    src_as = d3d12_command_list_place_acceleration_structure(list, src, 0);
     if (src_as == VK_NULL_HANDLE)
     {
         ERR("Invalid src address #%"PRIx64" for RTAS copy.\n", src);
@@ -17,6 +17,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_BUNDLE
 
 #include "vkd3d_private.h"
 
@@ -261,12 +262,14 @@ static HRESULT STDMETHODCALLTYPE d3d12_bundle_QueryInterface(d3d12_command_list_
             || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList3)
             || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList4)
             || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList5)
+            || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList6)
+            || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList7)
             || IsEqualGUID(iid, &IID_ID3D12CommandList)
             || IsEqualGUID(iid, &IID_ID3D12DeviceChild)
             || IsEqualGUID(iid, &IID_ID3D12Object)
             || IsEqualGUID(iid, &IID_IUnknown))
     {
-        ID3D12GraphicsCommandList5_AddRef(iface);
+        ID3D12GraphicsCommandList7_AddRef(iface);
         *object = iface;
         return S_OK;
     }
@@ -429,7 +432,7 @@ static void d3d12_bundle_exec_draw_instanced(d3d12_command_list_iface *list, con
 {
     const struct d3d12_draw_instanced_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_DrawInstanced(list, args->vertex_count,
+    ID3D12GraphicsCommandList7_DrawInstanced(list, args->vertex_count,
             args->instance_count, args->first_vertex, args->first_instance);
 }
 
@@ -466,7 +469,7 @@ static void d3d12_bundle_exec_draw_indexed_instanced(d3d12_command_list_iface *l
 {
     const struct d3d12_draw_indexed_instanced_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_DrawIndexedInstanced(list, args->index_count,
+    ID3D12GraphicsCommandList7_DrawIndexedInstanced(list, args->index_count,
             args->instance_count, args->first_index, args->vertex_offset,
             args->first_instance);
 }
@@ -501,7 +504,7 @@ static void d3d12_bundle_exec_dispatch(d3d12_command_list_iface *list, const voi
 {
     const struct d3d12_dispatch_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_Dispatch(list, args->x, args->y, args->z);
+    ID3D12GraphicsCommandList7_Dispatch(list, args->x, args->y, args->z);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_Dispatch(d3d12_command_list_iface *iface,
@@ -569,7 +572,7 @@ static void d3d12_bundle_exec_ia_set_primitive_topology(d3d12_command_list_iface
 {
     const struct d3d12_ia_set_primitive_topology_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_IASetPrimitiveTopology(list, args->topology);
+    ID3D12GraphicsCommandList7_IASetPrimitiveTopology(list, args->topology);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_IASetPrimitiveTopology(d3d12_command_list_iface *iface,
@@ -606,7 +609,7 @@ static void d3d12_bundle_exec_om_set_blend_factor(d3d12_command_list_iface *list
 {
     const struct d3d12_om_set_blend_factor_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_OMSetBlendFactor(list, args->blend_factor);
+    ID3D12GraphicsCommandList7_OMSetBlendFactor(list, args->blend_factor);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_OMSetBlendFactor(d3d12_command_list_iface *iface,
@@ -634,7 +637,7 @@ static void d3d12_bundle_exec_om_set_stencil_ref(d3d12_command_list_iface *list,
 {
     const struct d3d12_om_set_stencil_ref_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_OMSetStencilRef(list, args->stencil_ref);
+    ID3D12GraphicsCommandList7_OMSetStencilRef(list, args->stencil_ref);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_OMSetStencilRef(d3d12_command_list_iface *iface,
@@ -659,7 +662,7 @@ static void d3d12_bundle_exec_set_pipeline_state(d3d12_command_list_iface *list,
 {
     const struct d3d12_set_pipeline_state_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetPipelineState(list, args->pipeline_state);
+    ID3D12GraphicsCommandList7_SetPipelineState(list, args->pipeline_state);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetPipelineState(d3d12_command_list_iface *iface,
@@ -703,7 +706,7 @@ static void d3d12_bundle_exec_set_compute_root_signature(d3d12_command_list_ifac
 {
     const struct d3d12_set_root_signature_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetComputeRootSignature(list, args->root_signature);
+    ID3D12GraphicsCommandList7_SetComputeRootSignature(list, args->root_signature);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetComputeRootSignature(d3d12_command_list_iface *iface,
@@ -722,7 +725,7 @@ static void d3d12_bundle_exec_set_graphics_root_signature(d3d12_command_list_ifa
 {
     const struct d3d12_set_root_signature_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetGraphicsRootSignature(list, args->root_signature);
+    ID3D12GraphicsCommandList7_SetGraphicsRootSignature(list, args->root_signature);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetGraphicsRootSignature(d3d12_command_list_iface *iface,
@@ -748,7 +751,7 @@ static void d3d12_bundle_exec_set_compute_root_descriptor_table(d3d12_command_li
 {
     const struct d3d12_set_root_descriptor_table_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetComputeRootDescriptorTable(list, args->parameter_index, args->base_descriptor);
+    ID3D12GraphicsCommandList7_SetComputeRootDescriptorTable(list, args->parameter_index, args->base_descriptor);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetComputeRootDescriptorTable(d3d12_command_list_iface *iface,
@@ -769,7 +772,7 @@ static void d3d12_bundle_exec_set_graphics_root_descriptor_table(d3d12_command_l
 {
     const struct d3d12_set_root_descriptor_table_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetGraphicsRootDescriptorTable(list, args->parameter_index, args->base_descriptor);
+    ID3D12GraphicsCommandList7_SetGraphicsRootDescriptorTable(list, args->parameter_index, args->base_descriptor);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetGraphicsRootDescriptorTable(d3d12_command_list_iface *iface,
@@ -798,7 +801,7 @@ static void d3d12_bundle_exec_set_compute_root_32bit_constant(d3d12_command_list
 {
     const struct d3d12_set_root_32bit_constant_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetComputeRoot32BitConstant(list, args->parameter_index, args->data, args->offset);
+    ID3D12GraphicsCommandList7_SetComputeRoot32BitConstant(list, args->parameter_index, args->data, args->offset);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetComputeRoot32BitConstant(d3d12_command_list_iface *iface,
@@ -820,7 +823,7 @@ static void d3d12_bundle_exec_set_graphics_root_32bit_constant(d3d12_command_lis
 {
     const struct d3d12_set_root_32bit_constant_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetGraphicsRoot32BitConstant(list, args->parameter_index, args->data, args->offset);
+    ID3D12GraphicsCommandList7_SetGraphicsRoot32BitConstant(list, args->parameter_index, args->data, args->offset);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetGraphicsRoot32BitConstant(d3d12_command_list_iface *iface,
@@ -851,7 +854,7 @@ static void d3d12_bundle_exec_set_compute_root_32bit_constants(d3d12_command_lis
 {
     const struct d3d12_set_root_32bit_constants_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetComputeRoot32BitConstants(list, args->parameter_index,
+    ID3D12GraphicsCommandList7_SetComputeRoot32BitConstants(list, args->parameter_index,
             args->constant_count, args->data, args->offset);
 }
 
@@ -879,7 +882,7 @@ static void d3d12_bundle_exec_set_graphics_root_32bit_constants(d3d12_command_li
 {
     const struct d3d12_set_root_32bit_constants_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetGraphicsRoot32BitConstants(list, args->parameter_index,
+    ID3D12GraphicsCommandList7_SetGraphicsRoot32BitConstants(list, args->parameter_index,
             args->constant_count, args->data, args->offset);
 }
 
@@ -914,7 +917,7 @@ static void d3d12_bundle_exec_set_compute_root_cbv(d3d12_command_list_iface *lis
 {
     const struct d3d12_set_root_descriptor_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetComputeRootConstantBufferView(list, args->parameter_index, args->address);
+    ID3D12GraphicsCommandList7_SetComputeRootConstantBufferView(list, args->parameter_index, args->address);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetComputeRootConstantBufferView(
@@ -935,7 +938,7 @@ static void d3d12_bundle_exec_set_graphics_root_cbv(d3d12_command_list_iface *li
 {
     const struct d3d12_set_root_descriptor_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetGraphicsRootConstantBufferView(list, args->parameter_index, args->address);
+    ID3D12GraphicsCommandList7_SetGraphicsRootConstantBufferView(list, args->parameter_index, args->address);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetGraphicsRootConstantBufferView(
@@ -956,7 +959,7 @@ static void d3d12_bundle_exec_set_compute_root_srv(d3d12_command_list_iface *lis
 {
     const struct d3d12_set_root_descriptor_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetComputeRootShaderResourceView(list, args->parameter_index, args->address);
+    ID3D12GraphicsCommandList7_SetComputeRootShaderResourceView(list, args->parameter_index, args->address);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetComputeRootShaderResourceView(
@@ -977,7 +980,7 @@ static void d3d12_bundle_exec_set_graphics_root_srv(d3d12_command_list_iface *li
 {
     const struct d3d12_set_root_descriptor_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetGraphicsRootShaderResourceView(list, args->parameter_index, args->address);
+    ID3D12GraphicsCommandList7_SetGraphicsRootShaderResourceView(list, args->parameter_index, args->address);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetGraphicsRootShaderResourceView(
@@ -998,7 +1001,7 @@ static void d3d12_bundle_exec_set_compute_root_uav(d3d12_command_list_iface *lis
 {
     const struct d3d12_set_root_descriptor_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetComputeRootUnorderedAccessView(list, args->parameter_index, args->address);
+    ID3D12GraphicsCommandList7_SetComputeRootUnorderedAccessView(list, args->parameter_index, args->address);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetComputeRootUnorderedAccessView(
@@ -1019,7 +1022,7 @@ static void d3d12_bundle_exec_set_graphics_root_uav(d3d12_command_list_iface *li
 {
     const struct d3d12_set_root_descriptor_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetGraphicsRootUnorderedAccessView(list, args->parameter_index, args->address);
+    ID3D12GraphicsCommandList7_SetGraphicsRootUnorderedAccessView(list, args->parameter_index, args->address);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetGraphicsRootUnorderedAccessView(
@@ -1044,14 +1047,14 @@ struct d3d12_ia_set_index_buffer_command
 
 static void d3d12_bundle_exec_ia_set_index_buffer_null(d3d12_command_list_iface *list, const void *args_v)
 {
-    ID3D12GraphicsCommandList5_IASetIndexBuffer(list, NULL);
+    ID3D12GraphicsCommandList7_IASetIndexBuffer(list, NULL);
 }
 
 static void d3d12_bundle_exec_ia_set_index_buffer(d3d12_command_list_iface *list, const void *args_v)
 {
     const struct d3d12_ia_set_index_buffer_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_IASetIndexBuffer(list, &args->view);
+    ID3D12GraphicsCommandList7_IASetIndexBuffer(list, &args->view);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_IASetIndexBuffer(d3d12_command_list_iface *iface,
@@ -1086,7 +1089,7 @@ static void d3d12_bundle_exec_ia_set_vertex_buffers(d3d12_command_list_iface *li
 {
     const struct d3d12_ia_set_vertex_buffers_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_IASetVertexBuffers(list, args->start_slot, args->view_count, args->views);
+    ID3D12GraphicsCommandList7_IASetVertexBuffers(list, args->start_slot, args->view_count, args->views);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_IASetVertexBuffers(d3d12_command_list_iface *iface,
@@ -1201,7 +1204,7 @@ static void d3d12_bundle_exec_set_marker(d3d12_command_list_iface *list, const v
 {
     const struct d3d12_debug_marker_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetMarker(list, args->metadata, args->data, args->data_size);
+    ID3D12GraphicsCommandList7_SetMarker(list, args->metadata, args->data, args->data_size);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetMarker(d3d12_command_list_iface *iface,
@@ -1222,7 +1225,7 @@ static void d3d12_bundle_exec_begin_event(d3d12_command_list_iface *list, const
 {
     const struct d3d12_debug_marker_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_BeginEvent(list, args->metadata, args->data, args->data_size);
+    ID3D12GraphicsCommandList7_BeginEvent(list, args->metadata, args->data, args->data_size);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_BeginEvent(d3d12_command_list_iface *iface,
@@ -1241,7 +1244,7 @@ static void STDMETHODCALLTYPE d3d12_bundle_BeginEvent(d3d12_command_list_iface *
 
 static void d3d12_bundle_exec_end_event(d3d12_command_list_iface *list, const void *args_v)
 {
-    ID3D12GraphicsCommandList5_EndEvent(list);
+    ID3D12GraphicsCommandList7_EndEvent(list);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_EndEvent(d3d12_command_list_iface *iface)
@@ -1268,7 +1271,7 @@ static void d3d12_bundle_exec_execute_indirect(d3d12_command_list_iface *list, c
 {
     const struct d3d12_execute_indirect_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_ExecuteIndirect(list, args->signature, args->max_count,
+    ID3D12GraphicsCommandList7_ExecuteIndirect(list, args->signature, args->max_count,
             args->arg_buffer, args->arg_offset, args->count_buffer, args->count_offset);
 }
 
@@ -1330,7 +1333,7 @@ static void d3d12_bundle_exec_om_set_depth_bounds(d3d12_command_list_iface *list
 {
     const struct d3d12_om_set_depth_bounds_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_OMSetDepthBounds(list, args->min, args->max);
+    ID3D12GraphicsCommandList7_OMSetDepthBounds(list, args->min, args->max);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_OMSetDepthBounds(d3d12_command_list_iface *iface,
@@ -1359,7 +1362,7 @@ static void d3d12_bundle_exec_set_sample_positions(d3d12_command_list_iface *lis
     const struct d3d12_set_sample_positions_command *args = args_v;
 
     /* The sample position array is non-const but does not get written to */
-    ID3D12GraphicsCommandList5_SetSamplePositions(list, args->sample_count,
+    ID3D12GraphicsCommandList7_SetSamplePositions(list, args->sample_count,
             args->pixel_count, (D3D12_SAMPLE_POSITION*)args->positions);
 }
 
@@ -1402,7 +1405,7 @@ static void d3d12_bundle_exec_set_view_instance_mask(d3d12_command_list_iface *l
 {
     const struct d3d12_set_view_instance_mask_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetViewInstanceMask(list, args->mask);
+    ID3D12GraphicsCommandList7_SetViewInstanceMask(list, args->mask);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetViewInstanceMask(d3d12_command_list_iface *iface, UINT mask)
@@ -1428,7 +1431,7 @@ static void d3d12_bundle_exec_write_buffer_immediate(d3d12_command_list_iface *l
 {
     const struct d3d12_write_buffer_immediate_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_WriteBufferImmediate(list, args->count, args->parameters, args->modes);
+    ID3D12GraphicsCommandList7_WriteBufferImmediate(list, args->count, args->parameters, args->modes);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_WriteBufferImmediate(d3d12_command_list_iface *iface,
@@ -1524,7 +1527,7 @@ static void d3d12_bundle_exec_set_pipeline_state1(d3d12_command_list_iface *list
 {
     const struct d3d12_set_pipeline_state1_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_SetPipelineState1(list, args->state_object);
+    ID3D12GraphicsCommandList7_SetPipelineState1(list, args->state_object);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_SetPipelineState1(d3d12_command_list_iface *iface,
@@ -1549,7 +1552,7 @@ static void d3d12_bundle_exec_dispatch_rays(d3d12_command_list_iface *list, cons
 {
     const struct d3d12_dispatch_rays_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_DispatchRays(list, &args->desc);
+    ID3D12GraphicsCommandList7_DispatchRays(list, &args->desc);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_DispatchRays(d3d12_command_list_iface *iface,
@@ -1575,14 +1578,14 @@ static void d3d12_bundle_exec_rs_set_shading_rate(d3d12_command_list_iface *list
 {
     const struct d3d12_rs_set_shading_rate_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_RSSetShadingRate(list, args->base, args->combiners);
+    ID3D12GraphicsCommandList7_RSSetShadingRate(list, args->base, args->combiners);
 }
 
 static void d3d12_bundle_exec_rs_set_shading_rate_base(d3d12_command_list_iface *list, const void *args_v)
 {
     const struct d3d12_rs_set_shading_rate_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_RSSetShadingRate(list, args->base, NULL);
+    ID3D12GraphicsCommandList7_RSSetShadingRate(list, args->base, NULL);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_RSSetShadingRate(d3d12_command_list_iface *iface,
@@ -1612,7 +1615,7 @@ static void d3d12_bundle_exec_rs_set_shading_rate_image(d3d12_command_list_iface
 {
     const struct d3d12_rs_set_shading_rate_image_command *args = args_v;
 
-    ID3D12GraphicsCommandList5_RSSetShadingRateImage(list, args->image);
+    ID3D12GraphicsCommandList7_RSSetShadingRateImage(list, args->image);
 }
 
 static void STDMETHODCALLTYPE d3d12_bundle_RSSetShadingRateImage(d3d12_command_list_iface *iface,
@@ -1627,7 +1630,34 @@ static void STDMETHODCALLTYPE d3d12_bundle_RSSetShadingRateImage(d3d12_command_l
     args->image = image;
 }
 
-static CONST_VTBL struct ID3D12GraphicsCommandList5Vtbl d3d12_bundle_vtbl =
+static void d3d12_bundle_exec_dispatch_mesh(d3d12_command_list_iface *list, const void *args_v)
+{
+    const struct d3d12_dispatch_command *args = args_v;
+
+    ID3D12GraphicsCommandList7_DispatchMesh(list, args->x, args->y, args->z);
+}
+
+static void STDMETHODCALLTYPE d3d12_bundle_DispatchMesh(d3d12_command_list_iface *iface,
+        UINT x, UINT y, UINT z)
+{
+    struct d3d12_bundle *bundle = impl_from_ID3D12GraphicsCommandList(iface);
+    struct d3d12_dispatch_command *args;
+
+    TRACE("iface %p, x %u, y %u, z %u.\n", iface, x, y, z);
+
+    args = d3d12_bundle_add_command(bundle, &d3d12_bundle_exec_dispatch_mesh, sizeof(*args));
+    args->x = x;
+    args->y = y;
+    args->z = z;
+}
+
+static void STDMETHODCALLTYPE d3d12_bundle_Barrier(d3d12_command_list_iface *iface,
+        UINT32 num_barrier_groups, const D3D12_BARRIER_GROUP *barrier_groups)
+{
+    WARN("iface %p, num_barrier_groups %u, barrier_groups %p ignored!\n", iface, num_barrier_groups, barrier_groups);
+}
+
+static CONST_VTBL struct ID3D12GraphicsCommandList7Vtbl d3d12_bundle_vtbl =
 {
     /* IUnknown methods */
     d3d12_bundle_QueryInterface,
@@ -1718,6 +1748,10 @@ static CONST_VTBL struct ID3D12GraphicsCommandList5Vtbl d3d12_bundle_vtbl =
     /* ID3D12GraphicsCommandList5 methods */
     d3d12_bundle_RSSetShadingRate,
     d3d12_bundle_RSSetShadingRateImage,
+    /* ID3D12GraphicsCommandList6 methods */
+    d3d12_bundle_DispatchMesh,
+    /* ID3D12GraphicsCommandList7 methods */
+    d3d12_bundle_Barrier,
 };
 
 HRESULT d3d12_bundle_create(struct d3d12_device *device,
@@ -17,8 +17,10 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_PIPELINE
 
 #include "vkd3d_private.h"
+#include "vkd3d_rw_spinlock.h"
 
 VkResult vkd3d_create_pipeline_cache(struct d3d12_device *device,
         size_t size, const void *data, VkPipelineCache *cache)
@@ -32,10 +34,34 @@ VkResult vkd3d_create_pipeline_cache(struct d3d12_device *device,
     info.initialDataSize = size;
     info.pInitialData = data;
 
-    return VK_CALL(vkCreatePipelineCache(device->vk_device, &info, NULL, cache));
+    return VK_CALL(vkCreatePipelineCache(device->vk_device, &info, &vkd3d_vk_allocator, cache));
 }
 
-#define VKD3D_CACHE_BLOB_VERSION MAKE_MAGIC('V','K','B',1)
+#define VKD3D_CACHE_BLOB_VERSION MAKE_MAGIC('V','K','B',2)
+
+enum vkd3d_pipeline_blob_chunk_type
+{
+    /* Opaque VkPipelineCache data. */
+    VKD3D_PIPELINE_BLOB_CHUNK_TYPE_PIPELINE_CACHE = 0,
+    /* Translated SPIR-V of one shader stage, see struct vkd3d_pipeline_blob_chunk_spirv. */
+    VKD3D_PIPELINE_BLOB_CHUNK_TYPE_SPIRV = 1,
+};
+
+struct vkd3d_pipeline_blob_chunk
+{
+    uint32_t type;
+    uint32_t size;
+    uint8_t data[];
+};
+
+struct vkd3d_pipeline_blob_chunk_spirv
+{
+    uint32_t stage;
+    uint32_t spirv_size;
+    vkd3d_shader_hash_t fingerprint;
+    struct vkd3d_shader_meta meta;
+    uint8_t spirv[];
+};
 
 struct vkd3d_pipeline_blob
 {
@@ -44,22 +70,57 @@ struct vkd3d_pipeline_blob
     uint32_t device_id;
     uint64_t vkd3d_build;
     uint8_t cache_uuid[VK_UUID_SIZE];
-    uint8_t vk_blob[];
+    uint8_t data[]; /* struct vkd3d_pipeline_blob_chunk[] */
 };
 
-HRESULT vkd3d_create_pipeline_cache_from_d3d12_desc(struct d3d12_device *device,
-        const D3D12_CACHED_PIPELINE_STATE *state, VkPipelineCache *cache)
+#define VKD3D_PIPELINE_BLOB_CHUNK_ALIGNMENT 8
+
+static size_t vkd3d_pipeline_blob_chunk_size(size_t payload_size)
+{
+    return align(sizeof(struct vkd3d_pipeline_blob_chunk) + payload_size, VKD3D_PIPELINE_BLOB_CHUNK_ALIGNMENT);
+}
+
+static const struct vkd3d_pipeline_blob_chunk *vkd3d_pipeline_blob_next_chunk(
+        const D3D12_CACHED_PIPELINE_STATE *state, const struct vkd3d_pipeline_blob_chunk *chunk)
 {
-    const VkPhysicalDeviceProperties *device_properties = &device->device_info.properties2.properties;
     const struct vkd3d_pipeline_blob *blob = state->pCachedBlob;
-    VkResult vr;
+    size_t offset, end = state->CachedBlobSizeInBytes;
 
-    if (!state->CachedBlobSizeInBytes)
+    if (chunk)
+        offset = (const uint8_t *)chunk - (const uint8_t *)blob + vkd3d_pipeline_blob_chunk_size(chunk->size);
+    else
+        offset = offsetof(struct vkd3d_pipeline_blob, data);
+
+    if (offset + sizeof(*chunk) > end)
+        return NULL;
+
+    chunk = (const struct vkd3d_pipeline_blob_chunk *)((const uint8_t *)blob + offset);
+    if (chunk->size > end - offset - sizeof(*chunk))
+        return NULL;
+
+    return chunk;
+}
+
+static const struct vkd3d_pipeline_blob_chunk *vkd3d_pipeline_blob_find_chunk(
+        const D3D12_CACHED_PIPELINE_STATE *state, const struct vkd3d_pipeline_blob_chunk *chunk, uint32_t type)
+{
+    while ((chunk = vkd3d_pipeline_blob_next_chunk(state, chunk)))
     {
-        vr = vkd3d_create_pipeline_cache(device, 0, NULL, cache);
-        return hresult_from_vk_result(vr);
+        if (chunk->type == type)
+            return chunk;
     }
 
+    return NULL;
+}
+
+static HRESULT vkd3d_validate_pipeline_blob(struct d3d12_device *device,
+        const D3D12_CACHED_PIPELINE_STATE *state)
+{
+    const VkPhysicalDeviceProperties *device_properties = &device->device_info.properties2.properties;
+    const struct vkd3d_pipeline_blob *blob = state->pCachedBlob;
+    const struct vkd3d_pipeline_blob_chunk *chunk = NULL;
+    size_t size = sizeof(*blob);
+
     /* Avoid E_INVALIDARG with an invalid header size, since that may confuse some games */
     if (state->CachedBlobSizeInBytes < sizeof(*blob) || blob->version != VKD3D_CACHE_BLOB_VERSION)
         return D3D12_ERROR_DRIVER_VERSION_MISMATCH;
@@ -74,29 +135,129 @@ HRESULT vkd3d_create_pipeline_cache_from_d3d12_desc(struct d3d12_device *device,
             memcmp(blob->cache_uuid, device_properties->pipelineCacheUUID, VK_UUID_SIZE))
         return D3D12_ERROR_DRIVER_VERSION_MISMATCH;
 
-    vr = vkd3d_create_pipeline_cache(device, state->CachedBlobSizeInBytes - sizeof(*blob), blob->vk_blob, cache);
+    /* Chunks must tile the blob exactly. */
+    while ((chunk = vkd3d_pipeline_blob_next_chunk(state, chunk)))
+        size += vkd3d_pipeline_blob_chunk_size(chunk->size);
+
+    if (size != state->CachedBlobSizeInBytes)
+        return E_INVALIDARG;
+
+    return S_OK;
+}
+
+/* Returns VK_NULL_HANDLE in cache if there is no cached data,
+ * in which case the device's cache pool should be used instead. */
+HRESULT vkd3d_create_pipeline_cache_from_d3d12_desc(struct d3d12_device *device,
+        const D3D12_CACHED_PIPELINE_STATE *state, VkPipelineCache *cache)
+{
+    const struct vkd3d_pipeline_blob_chunk *chunk;
+    VkResult vr;
+    HRESULT hr;
+
+    *cache = VK_NULL_HANDLE;
+
+    if (!state->CachedBlobSizeInBytes)
+        return S_OK;
+
+    if (FAILED(hr = vkd3d_validate_pipeline_blob(device, state)))
+        return hr;
+
+    if (!(chunk = vkd3d_pipeline_blob_find_chunk(state, NULL, VKD3D_PIPELINE_BLOB_CHUNK_TYPE_PIPELINE_CACHE)))
+        return S_OK;
+
+    vr = vkd3d_create_pipeline_cache(device, chunk->size, chunk->data, cache);
     return hresult_from_vk_result(vr);
 }
 
-VkResult vkd3d_serialize_pipeline_state(const struct d3d12_pipeline_state *state, size_t *size, void *data)
+/* Only valid for blobs which were accepted by vkd3d_create_pipeline_cache_from_d3d12_desc(). */
+const void *vkd3d_get_pipeline_cache_data_from_d3d12_desc(const D3D12_CACHED_PIPELINE_STATE *state, size_t *size)
+{
+    const struct vkd3d_pipeline_blob_chunk *chunk;
+
+    if (!(chunk = vkd3d_pipeline_blob_find_chunk(state, NULL, VKD3D_PIPELINE_BLOB_CHUNK_TYPE_PIPELINE_CACHE)))
+    {
+        *size = 0;
+        return NULL;
+    }
+
+    *size = chunk->size;
+    return chunk->data;
+}
+
+/* Looks up SPIR-V which was translated with the same inputs. The returned code points into
+ * the application's blob and must be copied if it needs to outlive PSO creation. */
+bool vkd3d_get_cached_spirv_from_d3d12_desc(struct d3d12_device *device,
+        const D3D12_CACHED_PIPELINE_STATE *state, VkShaderStageFlagBits stage,
+        vkd3d_shader_hash_t fingerprint, struct vkd3d_shader_code *spirv)
+{
+    const struct vkd3d_pipeline_blob_chunk_spirv *spirv_chunk;
+    const struct vkd3d_pipeline_blob_chunk *chunk = NULL;
+
+    if (!state->CachedBlobSizeInBytes || FAILED(vkd3d_validate_pipeline_blob(device, state)))
+        return false;
+
+    while ((chunk = vkd3d_pipeline_blob_find_chunk(state, chunk, VKD3D_PIPELINE_BLOB_CHUNK_TYPE_SPIRV)))
+    {
+        if (chunk->size < sizeof(*spirv_chunk))
+            continue;
+
+        spirv_chunk = (const struct vkd3d_pipeline_blob_chunk_spirv *)chunk->data;
+        if (spirv_chunk->stage != stage || spirv_chunk->fingerprint != fingerprint ||
+                spirv_chunk->spirv_size > chunk->size - sizeof(*spirv_chunk))
+            continue;
+
+        spirv->code = spirv_chunk->spirv;
+        spirv->size = spirv_chunk->spirv_size;
+        spirv->meta = spirv_chunk->meta;
+        return true;
+    }
+
+    return false;
+}
+
+static uint8_t *vkd3d_pipeline_blob_write_chunk(uint8_t *ptr, uint32_t type, const void *data, size_t size)
+{
+    struct vkd3d_pipeline_blob_chunk *chunk = (struct vkd3d_pipeline_blob_chunk *)ptr;
+    size_t chunk_size = vkd3d_pipeline_blob_chunk_size(size);
+
+    chunk->type = type;
+    chunk->size = size;
+    memcpy(chunk->data, data, size);
+    memset(chunk->data + size, 0, chunk_size - sizeof(*chunk) - size);
+    return ptr + chunk_size;
+}
+
+VkResult vkd3d_serialize_pipeline_state(struct d3d12_pipeline_state *state, size_t *size, void *data)
 {
     const VkPhysicalDeviceProperties *device_properties = &state->device->device_info.properties2.properties;
-    const struct vkd3d_vk_device_procs *vk_procs = &state->device->vk_procs;
+    const struct vkd3d_pipeline_stage_code *stage_code;
+    struct vkd3d_pipeline_blob_chunk_spirv *spirv_chunk;
+    struct vkd3d_pipeline_blob_chunk *chunk;
     struct vkd3d_pipeline_blob *blob = data;
     size_t total_size = sizeof(*blob);
+    const void *vk_blob = NULL;
     size_t vk_blob_size = 0;
-    VkResult vr;
+    size_t chunk_size;
+    unsigned int i;
+    uint8_t *ptr;
+    HRESULT hr;
 
-    if (state->vk_pso_cache)
+    d3d12_device_mark_pipeline_blob_usage(state->device);
+
+    if (FAILED(hr = d3d12_pipeline_state_get_cache_data(state, &vk_blob, &vk_blob_size)))
     {
-        if ((vr = VK_CALL(vkGetPipelineCacheData(state->device->vk_device, state->vk_pso_cache, &vk_blob_size, NULL))))
-        {
-            ERR("Failed to retrieve pipeline cache size, vr %d.\n", vr);
-            return vr;
-        }
+        ERR("Failed to retrieve pipeline cache data, hr %#x.\n", hr);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    total_size += vk_blob_size;
+    if (vk_blob_size)
+        total_size += vkd3d_pipeline_blob_chunk_size(vk_blob_size);
+
+    for (i = 0; i < state->stage_code_count; i++)
+    {
+        if (state->stage_code[i].spirv.code)
+            total_size += vkd3d_pipeline_blob_chunk_size(sizeof(*spirv_chunk) + state->stage_code[i].spirv.size);
+    }
 
     if (blob && *size < total_size)
         return VK_INCOMPLETE;
@@ -109,10 +270,31 @@ VkResult vkd3d_serialize_pipeline_state(const struct d3d12_pipeline_state *state
         blob->vkd3d_build = vkd3d_build;
         memcpy(blob->cache_uuid, device_properties->pipelineCacheUUID, VK_UUID_SIZE);
 
-        if (state->vk_pso_cache)
+        ptr = blob->data;
+        if (vk_blob_size)
+            ptr = vkd3d_pipeline_blob_write_chunk(ptr, VKD3D_PIPELINE_BLOB_CHUNK_TYPE_PIPELINE_CACHE, vk_blob, vk_blob_size);
+
+        for (i = 0; i < state->stage_code_count; i++)
         {
-            if ((vr = VK_CALL(vkGetPipelineCacheData(state->device->vk_device, state->vk_pso_cache, &vk_blob_size, blob->vk_blob))))
-                return vr;
+            stage_code = &state->stage_code[i];
+            if (!stage_code->spirv.code)
+                continue;
+
+            chunk = (struct vkd3d_pipeline_blob_chunk *)ptr;
+            chunk->type = VKD3D_PIPELINE_BLOB_CHUNK_TYPE_SPIRV;
+            chunk->size = sizeof(*spirv_chunk) + stage_code->spirv.size;
+
+            spirv_chunk = (struct vkd3d_pipeline_blob_chunk_spirv *)chunk->data;
+            memset(spirv_chunk, 0, sizeof(*spirv_chunk));
+            spirv_chunk->stage = stage_code->stage;
+            spirv_chunk->spirv_size = stage_code->spirv.size;
+            spirv_chunk->fingerprint = stage_code->fingerprint;
+            spirv_chunk->meta = stage_code->spirv.meta;
+            memcpy(spirv_chunk->spirv, stage_code->spirv.code, stage_code->spirv.size);
+
+            chunk_size = vkd3d_pipeline_blob_chunk_size(chunk->size);
+            memset(chunk->data + chunk->size, 0, chunk_size - sizeof(*chunk) - chunk->size);
+            ptr += chunk_size;
         }
     }
 
@@ -120,6 +302,218 @@ VkResult vkd3d_serialize_pipeline_state(const struct d3d12_pipeline_state *state
     return VK_SUCCESS;
 }
 
+/* Folding moves a shard's additions into the base, so it is cheap,
+ * but it waits for the base to be idle, so only try every so often. */
+#define VKD3D_PIPELINE_CACHE_FOLD_INTERVAL 64
+
+static bool vkd3d_pipeline_cache_pool_uses_base(struct d3d12_device *device)
+{
+    return device->device_info.pipeline_creation_cache_control_features.pipelineCreationCacheControl;
+}
+
+HRESULT vkd3d_pipeline_cache_pool_init(struct vkd3d_pipeline_cache_pool *pool, struct d3d12_device *device)
+{
+    unsigned int i;
+    VkResult vr;
+
+    memset(pool, 0, sizeof(*pool));
+    spinlock_init(&pool->base_lock);
+
+    if ((vr = vkd3d_create_pipeline_cache(device, 0, NULL, &pool->vk_base_cache)))
+    {
+        ERR("Failed to create pipeline cache, vr %d.\n", vr);
+        return hresult_from_vk_result(vr);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(pool->shards); i++)
+    {
+        spinlock_init(&pool->shards[i].lock);
+
+        if ((vr = vkd3d_create_pipeline_cache(device, 0, NULL, &pool->shards[i].vk_cache)))
+        {
+            ERR("Failed to create pipeline cache, vr %d.\n", vr);
+            vkd3d_pipeline_cache_pool_cleanup(pool, device);
+            return hresult_from_vk_result(vr);
+        }
+    }
+
+    return S_OK;
+}
+
+void vkd3d_pipeline_cache_pool_cleanup(struct vkd3d_pipeline_cache_pool *pool, struct d3d12_device *device)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(pool->shards); i++)
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, pool->shards[i].vk_cache, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipelineCache(device->vk_device, pool->vk_base_cache, &vkd3d_vk_allocator));
+}
+
+unsigned int vkd3d_pipeline_cache_pool_get_shard(struct vkd3d_pipeline_cache_pool *pool)
+{
+    return vkd3d_atomic_uint32_increment(&pool->next_shard, vkd3d_memory_order_relaxed) % ARRAY_SIZE(pool->shards);
+}
+
+VkPipelineCache vkd3d_pipeline_cache_pool_acquire(struct vkd3d_pipeline_cache_pool *pool, unsigned int shard_index)
+{
+    struct vkd3d_pipeline_cache_shard *shard = &pool->shards[shard_index];
+
+    rw_spinlock_acquire_read(&shard->lock);
+    return shard->vk_cache;
+}
+
+/* Must be called with the shard locked exclusively. */
+static void vkd3d_pipeline_cache_pool_fold_shard(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, struct vkd3d_pipeline_cache_shard *shard)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkPipelineCache vk_cache;
+    VkResult vr;
+
+    /* Compiles only read the base, never wait for them, the next compile retries. */
+    if (!rw_spinlock_try_acquire_write(&pool->base_lock))
+        return;
+
+    if ((vr = vkd3d_create_pipeline_cache(device, 0, NULL, &vk_cache)))
+    {
+        ERR("Failed to create pipeline cache, vr %d.\n", vr);
+        rw_spinlock_release_write(&pool->base_lock);
+        return;
+    }
+
+    if ((vr = VK_CALL(vkMergePipelineCaches(device->vk_device, pool->vk_base_cache, 1, &shard->vk_cache))))
+    {
+        WARN("Failed to merge pipeline cache, vr %d.\n", vr);
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, vk_cache, &vkd3d_vk_allocator));
+        rw_spinlock_release_write(&pool->base_lock);
+        return;
+    }
+
+    rw_spinlock_release_write(&pool->base_lock);
+
+    VK_CALL(vkDestroyPipelineCache(device->vk_device, shard->vk_cache, &vkd3d_vk_allocator));
+    shard->vk_cache = vk_cache;
+    vkd3d_atomic_uint32_store_explicit(&shard->compile_count, 0, vkd3d_memory_order_relaxed);
+}
+
+static void vkd3d_pipeline_cache_pool_count_compile(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, struct vkd3d_pipeline_cache_shard *shard)
+{
+    if (!vkd3d_pipeline_cache_pool_uses_base(device))
+        return;
+
+    if (vkd3d_atomic_uint32_increment(&shard->compile_count, vkd3d_memory_order_relaxed) <
+            VKD3D_PIPELINE_CACHE_FOLD_INTERVAL)
+        return;
+
+    if (!rw_spinlock_try_acquire_write(&shard->lock))
+        return;
+
+    /* Another thread may have folded the shard in the meantime. */
+    if (vkd3d_atomic_uint32_load_explicit(&shard->compile_count, vkd3d_memory_order_relaxed) >=
+            VKD3D_PIPELINE_CACHE_FOLD_INTERVAL)
+        vkd3d_pipeline_cache_pool_fold_shard(pool, device, shard);
+
+    rw_spinlock_release_write(&shard->lock);
+}
+
+void vkd3d_pipeline_cache_pool_release(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, unsigned int shard_index)
+{
+    struct vkd3d_pipeline_cache_shard *shard = &pool->shards[shard_index];
+
+    rw_spinlock_release_read(&shard->lock);
+    vkd3d_pipeline_cache_pool_count_compile(pool, device, shard);
+}
+
+/* Makes data from a PSO's private cache available to later compiles on the same shard.
+ * This is best-effort, the data is dropped if the shard is busy. */
+void vkd3d_pipeline_cache_pool_import(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, unsigned int shard_index, VkPipelineCache vk_cache)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    struct vkd3d_pipeline_cache_shard *shard = &pool->shards[shard_index];
+    VkResult vr;
+
+    if (!rw_spinlock_try_acquire_write(&shard->lock))
+        return;
+
+    if ((vr = VK_CALL(vkMergePipelineCaches(device->vk_device, shard->vk_cache, 1, &vk_cache))))
+        WARN("Failed to merge pipeline cache, vr %d.\n", vr);
+
+    rw_spinlock_release_write(&shard->lock);
+    vkd3d_pipeline_cache_pool_count_compile(pool, device, shard);
+}
+
+/* Only compiles into a shard consult the base, private caches must see every compile. */
+static bool vkd3d_pipeline_cache_pool_probes_base(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, VkPipelineCache vk_cache)
+{
+    unsigned int i;
+
+    if (!vk_cache || !vkd3d_pipeline_cache_pool_uses_base(device))
+        return false;
+
+    for (i = 0; i < ARRAY_SIZE(pool->shards); i++)
+    {
+        if (pool->shards[i].vk_cache == vk_cache)
+            return true;
+    }
+
+    return false;
+}
+
+VkResult vkd3d_pipeline_cache_pool_create_graphics_pipeline(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, VkPipelineCache vk_cache, VkGraphicsPipelineCreateInfo *create_info,
+        VkPipeline *vk_pipeline)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkPipelineCreateFlags flags = create_info->flags;
+    VkResult vr;
+
+    if (vkd3d_pipeline_cache_pool_probes_base(pool, device, vk_cache))
+    {
+        create_info->flags |= VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_EXT;
+        rw_spinlock_acquire_read(&pool->base_lock);
+        vr = VK_CALL(vkCreateGraphicsPipelines(device->vk_device, pool->vk_base_cache,
+                1, create_info, &vkd3d_vk_allocator, vk_pipeline));
+        rw_spinlock_release_read(&pool->base_lock);
+        create_info->flags = flags;
+
+        if (vr == VK_SUCCESS)
+            return vr;
+    }
+
+    return VK_CALL(vkCreateGraphicsPipelines(device->vk_device, vk_cache,
+            1, create_info, &vkd3d_vk_allocator, vk_pipeline));
+}
+
+VkResult vkd3d_pipeline_cache_pool_create_compute_pipeline(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, VkPipelineCache vk_cache, VkComputePipelineCreateInfo *create_info,
+        VkPipeline *vk_pipeline)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkPipelineCreateFlags flags = create_info->flags;
+    VkResult vr;
+
+    if (vkd3d_pipeline_cache_pool_probes_base(pool, device, vk_cache))
+    {
+        create_info->flags |= VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_EXT;
+        rw_spinlock_acquire_read(&pool->base_lock);
+        vr = VK_CALL(vkCreateComputePipelines(device->vk_device, pool->vk_base_cache,
+                1, create_info, &vkd3d_vk_allocator, vk_pipeline));
+        rw_spinlock_release_read(&pool->base_lock);
+        create_info->flags = flags;
+
+        if (vr == VK_SUCCESS)
+            return vr;
+    }
+
+    return VK_CALL(vkCreateComputePipelines(device->vk_device, vk_cache,
+            1, create_info, &vkd3d_vk_allocator, vk_pipeline));
+}
+
 struct vkd3d_cached_pipeline_key
 {
     size_t name_length;
@@ -173,8 +567,11 @@ struct vkd3d_serialized_pipeline
     uint8_t data[];
 };
 
-#define VKD3D_PIPELINE_LIBRARY_VERSION MAKE_MAGIC('V','K','L',1)
+#define VKD3D_PIPELINE_LIBRARY_VERSION MAKE_MAGIC('V','K','L',2)
 
+/* Serialized pipelines are followed by the contents of the
+ * device's ray tracing pipeline cache, since state objects
+ * cannot be stored in pipeline libraries directly. */
 struct vkd3d_serialized_pipeline_library
 {
     uint32_t version;
@@ -182,10 +579,146 @@ struct vkd3d_serialized_pipeline_library
     uint32_t device_id;
     uint32_t pipeline_count;
     uint64_t vkd3d_build;
+    uint64_t rt_cache_size;
     uint8_t cache_uuid[VK_UUID_SIZE];
     uint8_t data[];
 };
 
+/* Ray tracing pipelines compile directly against the device's cache, which Vulkan
+ * synchronizes internally. Merging needs exclusive access to the destination though,
+ * and compiles can take seconds, so data from loaded pipeline libraries is queued
+ * and merged once no compile is using the cache. */
+static void vkd3d_flush_rt_pipeline_cache_merges(struct d3d12_device *device)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkPipelineCache *vk_caches;
+    size_t count, i;
+    VkResult vr;
+
+    if (!vkd3d_atomic_uint32_load_explicit(&device->rt_pipeline_cache_pending_count, vkd3d_memory_order_relaxed))
+        return;
+
+    if (!rw_spinlock_try_acquire_write(&device->rt_pipeline_cache_lock))
+        return;
+
+    spinlock_acquire(&device->rt_pipeline_cache_pending_lock);
+    vk_caches = device->rt_pipeline_cache_pending;
+    count = device->rt_pipeline_cache_pending_count;
+    device->rt_pipeline_cache_pending = NULL;
+    device->rt_pipeline_cache_pending_size = 0;
+    vkd3d_atomic_uint32_store_explicit(&device->rt_pipeline_cache_pending_count, 0, vkd3d_memory_order_relaxed);
+    spinlock_release(&device->rt_pipeline_cache_pending_lock);
+
+    if (count && (vr = VK_CALL(vkMergePipelineCaches(device->vk_device, device->rt_pipeline_cache, count, vk_caches))))
+        WARN("Failed to merge ray tracing pipeline cache data, vr %d.\n", vr);
+    rw_spinlock_release_write(&device->rt_pipeline_cache_lock);
+
+    for (i = 0; i < count; i++)
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, vk_caches[i], &vkd3d_vk_allocator));
+    vkd3d_free(vk_caches);
+}
+
+VkPipelineCache vkd3d_acquire_rt_pipeline_cache(struct d3d12_device *device)
+{
+    if (!device->rt_pipeline_cache)
+        return VK_NULL_HANDLE;
+
+    vkd3d_flush_rt_pipeline_cache_merges(device);
+    rw_spinlock_acquire_read(&device->rt_pipeline_cache_lock);
+    return device->rt_pipeline_cache;
+}
+
+void vkd3d_release_rt_pipeline_cache(struct d3d12_device *device)
+{
+    if (!device->rt_pipeline_cache)
+        return;
+
+    rw_spinlock_release_read(&device->rt_pipeline_cache_lock);
+    vkd3d_flush_rt_pipeline_cache_merges(device);
+}
+
+void vkd3d_cleanup_rt_pipeline_cache_merges(struct d3d12_device *device)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    size_t i;
+
+    for (i = 0; i < device->rt_pipeline_cache_pending_count; i++)
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, device->rt_pipeline_cache_pending[i], &vkd3d_vk_allocator));
+    vkd3d_free(device->rt_pipeline_cache_pending);
+}
+
+static HRESULT vkd3d_get_rt_pipeline_cache_data(struct d3d12_device *device, size_t *size, void **data)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkResult vr;
+
+    *size = 0;
+    *data = NULL;
+
+    if (!vkd3d_acquire_rt_pipeline_cache(device))
+        return S_OK;
+
+    /* Concurrent compiles may grow the cache between the two calls. */
+    do
+    {
+        vkd3d_free(*data);
+        *data = NULL;
+
+        if ((vr = VK_CALL(vkGetPipelineCacheData(device->vk_device, device->rt_pipeline_cache, size, NULL))) || !*size)
+            break;
+
+        if (!(*data = vkd3d_malloc(*size)))
+            vr = VK_ERROR_OUT_OF_HOST_MEMORY;
+        else
+            vr = VK_CALL(vkGetPipelineCacheData(device->vk_device, device->rt_pipeline_cache, size, *data));
+    } while (vr == VK_INCOMPLETE);
+    vkd3d_release_rt_pipeline_cache(device);
+
+    if (vr)
+    {
+        vkd3d_free(*data);
+        *data = NULL;
+        ERR("Failed to retrieve ray tracing pipeline cache data, vr %d.\n", vr);
+        *size = 0;
+        return hresult_from_vk_result(vr);
+    }
+
+    return S_OK;
+}
+
+static HRESULT vkd3d_merge_rt_pipeline_cache_data(struct d3d12_device *device, size_t size, const void *data)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkPipelineCache vk_cache;
+    VkResult vr;
+    bool queued;
+
+    if (!size || !device->rt_pipeline_cache)
+        return S_OK;
+
+    if ((vr = vkd3d_create_pipeline_cache(device, size, data, &vk_cache)))
+        return hresult_from_vk_result(vr);
+
+    spinlock_acquire(&device->rt_pipeline_cache_pending_lock);
+    if ((queued = vkd3d_array_reserve((void **)&device->rt_pipeline_cache_pending, &device->rt_pipeline_cache_pending_size,
+            device->rt_pipeline_cache_pending_count + 1, sizeof(*device->rt_pipeline_cache_pending))))
+    {
+        device->rt_pipeline_cache_pending[device->rt_pipeline_cache_pending_count] = vk_cache;
+        vkd3d_atomic_uint32_store_explicit(&device->rt_pipeline_cache_pending_count,
+                device->rt_pipeline_cache_pending_count + 1, vkd3d_memory_order_relaxed);
+    }
+    spinlock_release(&device->rt_pipeline_cache_pending_lock);
+
+    if (!queued)
+    {
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, vk_cache, &vkd3d_vk_allocator));
+        return E_OUTOFMEMORY;
+    }
+
+    vkd3d_flush_rt_pipeline_cache_merges(device);
+    return S_OK;
+}
+
 /* ID3D12PipelineLibrary */
 static inline struct d3d12_pipeline_library *impl_from_ID3D12PipelineLibrary(d3d12_pipeline_library_iface *iface)
 {
@@ -235,6 +768,10 @@ static void d3d12_pipeline_library_cleanup(struct d3d12_pipeline_library *pipeli
 
     hash_map_clear(&pipeline_library->map);
 
+    vkd3d_atomic_ptr_compare_exchange(&device->rt_pipeline_cache_library, pipeline_library, NULL,
+            vkd3d_memory_order_relaxed, vkd3d_memory_order_relaxed);
+    vkd3d_free(pipeline_library->rt_cache_data);
+
     vkd3d_private_store_destroy(&pipeline_library->private_store);
     pthread_mutex_destroy(&pipeline_library->mutex);
 }
@@ -359,7 +896,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_StorePipeline(d3d12_pipe
     }
 
     /* We need to allocate persistent storage for the name */
-    if (!(new_name = malloc(entry.key.name_length)))
+    if (!(new_name = vkd3d_malloc(entry.key.name_length)))
     {
         pthread_mutex_unlock(&pipeline_library->mutex);
         return E_OUTOFMEMORY;
@@ -375,7 +912,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_StorePipeline(d3d12_pipe
         return hresult_from_vk_result(vr);
     }
 
-    if (!(new_blob = malloc(entry.data.blob_length)))
+    if (!(new_blob = vkd3d_malloc(entry.data.blob_length)))
     {
         vkd3d_free(new_name);
         pthread_mutex_unlock(&pipeline_library->mutex);
@@ -479,6 +1016,33 @@ static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_LoadComputePipeline(d3d1
             &IID_ID3D12PipelineState, iid, pipeline_state);
 }
 
+/* The device's ray tracing pipeline cache is only stored in one library at a time, since every
+ * library would otherwise carry the same data. The snapshot is taken once per GetSerializedSize()
+ * call, so that Serialize() writes exactly the size which was reported. */
+static HRESULT d3d12_pipeline_library_snapshot_rt_cache(struct d3d12_pipeline_library *pipeline_library)
+{
+    struct d3d12_device *device = pipeline_library->device;
+    struct d3d12_pipeline_library *owner;
+
+    vkd3d_free(pipeline_library->rt_cache_data);
+    pipeline_library->rt_cache_data = NULL;
+    pipeline_library->rt_cache_size = 0;
+    pipeline_library->has_rt_cache_snapshot = false;
+
+    owner = vkd3d_atomic_ptr_compare_exchange(&device->rt_pipeline_cache_library, NULL, pipeline_library,
+            vkd3d_memory_order_relaxed, vkd3d_memory_order_relaxed);
+
+    if (!owner || owner == pipeline_library)
+    {
+        if (FAILED(vkd3d_get_rt_pipeline_cache_data(device,
+                &pipeline_library->rt_cache_size, &pipeline_library->rt_cache_data)))
+            return E_FAIL;
+    }
+
+    pipeline_library->has_rt_cache_snapshot = true;
+    return S_OK;
+}
+
 static SIZE_T STDMETHODCALLTYPE d3d12_pipeline_library_GetSerializedSize(d3d12_pipeline_library_iface *iface)
 {
     struct d3d12_pipeline_library *pipeline_library = impl_from_ID3D12PipelineLibrary(iface);
@@ -503,13 +1067,24 @@ static SIZE_T STDMETHODCALLTYPE d3d12_pipeline_library_GetSerializedSize(d3d12_p
             size_t pipeline_size = 0;
 
             if (!d3d12_pipeline_library_serialize_entry(pipeline_library, e, &pipeline_size, NULL))
+            {
+                pthread_mutex_unlock(&pipeline_library->mutex);
                 return 0;
+            }
 
             total_size += pipeline_size;
         }
     }
 
+    if (FAILED(d3d12_pipeline_library_snapshot_rt_cache(pipeline_library)))
+    {
+        pthread_mutex_unlock(&pipeline_library->mutex);
+        return 0;
+    }
+
+    total_size += pipeline_library->rt_cache_size;
     pthread_mutex_unlock(&pipeline_library->mutex);
+
     return total_size;
 }
 
@@ -540,6 +1115,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_Serialize(d3d12_pipeline
     header->device_id = device_properties->deviceID;
     header->pipeline_count = pipeline_library->map.used_count;
     header->vkd3d_build = vkd3d_build;
+    header->rt_cache_size = 0;
     memcpy(header->cache_uuid, device_properties->pipelineCacheUUID, VK_UUID_SIZE);
 
     for (i = 0; i < pipeline_library->map.entry_count; i++)
@@ -562,6 +1138,25 @@ static HRESULT STDMETHODCALLTYPE d3d12_pipeline_library_Serialize(d3d12_pipeline
         }
     }
 
+    /* Applications may skip GetSerializedSize() if they know the size from an earlier call. */
+    if (!pipeline_library->has_rt_cache_snapshot &&
+            FAILED(d3d12_pipeline_library_snapshot_rt_cache(pipeline_library)))
+    {
+        pthread_mutex_unlock(&pipeline_library->mutex);
+        return E_FAIL;
+    }
+
+    /* Fails if the provided buffer is too small to fit the cache */
+    if (pipeline_library->rt_cache_size > serialized_size)
+    {
+        pthread_mutex_unlock(&pipeline_library->mutex);
+        return E_INVALIDARG;
+    }
+
+    if (pipeline_library->rt_cache_size)
+        memcpy(serialized_data, pipeline_library->rt_cache_data, pipeline_library->rt_cache_size);
+    header->rt_cache_size = pipeline_library->rt_cache_size;
+
     pthread_mutex_unlock(&pipeline_library->mutex);
     return S_OK;
 }
@@ -660,7 +1255,10 @@ static HRESULT d3d12_pipeline_library_read_blob(struct d3d12_pipeline_library *p
             return E_OUTOFMEMORY;
     }
 
-    return S_OK;
+    if (header->rt_cache_size > (size_t)(end - cur))
+        return E_INVALIDARG;
+
+    return vkd3d_merge_rt_pipeline_cache_data(device, header->rt_cache_size, cur);
 }
 
 static HRESULT d3d12_pipeline_library_init(struct d3d12_pipeline_library *pipeline_library,
@@ -710,6 +1308,8 @@ HRESULT d3d12_pipeline_library_create(struct d3d12_device *device, const void *b
     if (!(object = vkd3d_malloc(sizeof(*object))))
         return E_OUTOFMEMORY;
 
+    d3d12_device_mark_pipeline_blob_usage(device);
+
     if (FAILED(hr = d3d12_pipeline_library_init(object, device, blob, blob_length)))
     {
         vkd3d_free(object);
@@ -18,6 +18,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_COMMAND
 
 #include "vkd3d_private.h"
 #include "vkd3d_swapchain_factory.h"
@@ -31,6 +32,10 @@ static void d3d12_command_queue_add_submission(struct d3d12_command_queue *queue
         const struct d3d12_command_queue_submission *sub);
 static void d3d12_fence_inc_ref(struct d3d12_fence *fence);
 static void d3d12_fence_dec_ref(struct d3d12_fence *fence);
+static void vkd3d_queue_worker_pool_schedule(struct vkd3d_queue_worker_pool *pool,
+        struct d3d12_command_queue *queue);
+static void d3d12_command_queue_transition_pool_deinit(struct d3d12_command_queue_transition_pool *pool,
+        struct d3d12_device *device);
 
 #define MAX_BATCHED_IMAGE_BARRIERS 16
 struct d3d12_command_list_barrier_batch
@@ -51,6 +56,8 @@ static void d3d12_command_list_barrier_batch_add_layout_transition(
 
 static uint32_t d3d12_command_list_promote_dsv_resource(struct d3d12_command_list *list,
         struct d3d12_resource *resource, uint32_t plane_optimal_mask);
+static void d3d12_command_list_track_dsv_boundary_layout(struct d3d12_command_list *list,
+        struct d3d12_resource *resource, uint32_t depth_state_plane_mask);
 static void d3d12_command_list_notify_decay_dsv_resource(struct d3d12_command_list *list,
         struct d3d12_resource *resource);
 static uint32_t d3d12_command_list_notify_dsv_writes(struct d3d12_command_list *list,
@@ -75,7 +82,7 @@ static HRESULT vkd3d_create_binary_semaphore(struct d3d12_device *device, VkSema
     info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
     info.pNext = NULL;
     info.flags = 0;
-    vr = VK_CALL(vkCreateSemaphore(device->vk_device, &info, NULL, vk_semaphore));
+    vr = VK_CALL(vkCreateSemaphore(device->vk_device, &info, &vkd3d_vk_allocator, vk_semaphore));
     return hresult_from_vk_result(vr);
 }
 
@@ -118,7 +125,7 @@ HRESULT vkd3d_queue_create(struct d3d12_device *device, uint32_t family_index, u
     pool_create_info.pNext = NULL;
     pool_create_info.flags = 0;
     pool_create_info.queueFamilyIndex = family_index;
-    if ((vr = VK_CALL(vkCreateCommandPool(device->vk_device, &pool_create_info, NULL, &object->barrier_pool))))
+    if ((vr = VK_CALL(vkCreateCommandPool(device->vk_device, &pool_create_info, &vkd3d_vk_allocator, &object->barrier_pool))))
     {
         hr = hresult_from_vk_result(vr);
         goto fail_destroy_mutex;
@@ -160,7 +167,7 @@ HRESULT vkd3d_queue_create(struct d3d12_device *device, uint32_t family_index, u
     return hr;
 
 fail_free_command_pool:
-    VK_CALL(vkDestroyCommandPool(device->vk_device, object->barrier_pool, NULL));
+    VK_CALL(vkDestroyCommandPool(device->vk_device, object->barrier_pool, &vkd3d_vk_allocator));
 fail_destroy_mutex:
     pthread_mutex_destroy(&object->mutex);
     return hr;
@@ -175,13 +182,14 @@ void vkd3d_queue_destroy(struct vkd3d_queue *queue, struct d3d12_device *device)
         ERR("Failed to lock mutex, error %d.\n", rc);
 
     if (!rc)
-        pthread_mutex_unlock(&queue->mutex);
+        vkd3d_queue_release(queue);
 
     VK_CALL(vkQueueWaitIdle(queue->vk_queue));
-    VK_CALL(vkDestroyCommandPool(device->vk_device, queue->barrier_pool, NULL));
-    VK_CALL(vkDestroySemaphore(device->vk_device, queue->serializing_binary_semaphore, NULL));
+    VK_CALL(vkDestroyCommandPool(device->vk_device, queue->barrier_pool, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroySemaphore(device->vk_device, queue->serializing_binary_semaphore, &vkd3d_vk_allocator));
 
     pthread_mutex_destroy(&queue->mutex);
+    vkd3d_free(queue->parked_queues);
     vkd3d_free(queue->wait_semaphores);
     vkd3d_free(queue->wait_values);
     vkd3d_free(queue->wait_stages);
@@ -206,16 +214,60 @@ VkQueue vkd3d_queue_acquire(struct vkd3d_queue *queue)
 
 void vkd3d_queue_release(struct vkd3d_queue *queue)
 {
+    struct d3d12_command_queue *command_queue;
+
     TRACE("queue %p.\n", queue);
 
     pthread_mutex_unlock(&queue->mutex);
+
+    /* Parking happens under parked_lock after a failed try-lock,
+     * so anything parked before the unlock is seen here. */
+    spinlock_acquire(&queue->parked_lock);
+    while (queue->parked_queue_count)
+    {
+        command_queue = queue->parked_queues[--queue->parked_queue_count];
+        vkd3d_queue_worker_pool_schedule(&command_queue->device->queue_worker_pool, command_queue);
+    }
+    spinlock_release(&queue->parked_lock);
 }
 
-void vkd3d_queue_add_wait(struct vkd3d_queue *queue, VkSemaphore semaphore, uint64_t value)
+/* Returns false if the queue is locked, in which case command_queue is rescheduled
+ * once it is released. Used by pool workers, which must never block on a queue. */
+static bool vkd3d_queue_try_acquire_or_park(struct vkd3d_queue *queue,
+        struct d3d12_command_queue *command_queue)
 {
-    uint32_t i;
+    bool acquired;
+
+    if (!pthread_mutex_trylock(&queue->mutex))
+        return true;
+
+    spinlock_acquire(&queue->parked_lock);
+
+    /* The holder may have released the queue before we took the lock. */
+    if (!(acquired = !pthread_mutex_trylock(&queue->mutex)))
+    {
+        if (vkd3d_array_reserve((void **)&queue->parked_queues, &queue->parked_queues_size,
+                queue->parked_queue_count + 1, sizeof(*queue->parked_queues)))
+        {
+            TRACE("Parking command queue %p on queue %p.\n", command_queue, queue);
+            queue->parked_queues[queue->parked_queue_count++] = command_queue;
+        }
+        else
+        {
+            ERR("Failed to park command queue %p, blocking.\n", command_queue);
+            pthread_mutex_lock(&queue->mutex);
+            acquired = true;
+        }
+    }
+
+    spinlock_release(&queue->parked_lock);
+    return acquired;
+}
 
-    pthread_mutex_lock(&queue->mutex);
+static void vkd3d_queue_add_wait_locked(struct vkd3d_queue *queue, VkSemaphore semaphore,
+        uint64_t value, VkPipelineStageFlags stages)
+{
+    uint32_t i;
 
     for (i = 0; i < queue->wait_count; i++)
     {
@@ -223,7 +275,7 @@ void vkd3d_queue_add_wait(struct vkd3d_queue *queue, VkSemaphore semaphore, uint
         {
             if (queue->wait_values[i] < value)
                 queue->wait_values[i] = value;
-            pthread_mutex_unlock(&queue->mutex);
+            queue->wait_stages[i] |= stages;
             return;
         }
     }
@@ -236,15 +288,22 @@ void vkd3d_queue_add_wait(struct vkd3d_queue *queue, VkSemaphore semaphore, uint
             queue->wait_count + 1, sizeof(*queue->wait_stages)))
     {
         ERR("Failed to add semaphore wait to queue.\n");
-        pthread_mutex_unlock(&queue->mutex);
         return;
     }
 
     queue->wait_semaphores[queue->wait_count] = semaphore;
     queue->wait_values[queue->wait_count] = value;
-    queue->wait_stages[queue->wait_count] = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    queue->wait_stages[queue->wait_count] = stages;
     queue->wait_count += 1;
-    pthread_mutex_unlock(&queue->mutex);
+}
+
+void vkd3d_queue_add_wait(struct vkd3d_queue *queue, VkSemaphore semaphore, uint64_t value)
+{
+    /* Pool workers may park on the queue meanwhile, so release through the normal path. */
+    if (!vkd3d_queue_acquire(queue))
+        return;
+    vkd3d_queue_add_wait_locked(queue, semaphore, value, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    vkd3d_queue_release(queue);
 }
 
 static VkResult vkd3d_queue_wait_idle(struct vkd3d_queue *queue,
@@ -286,12 +345,32 @@ static HRESULT vkd3d_create_timeline_semaphore(struct d3d12_device *device, uint
     info.pNext = &type_info;
     info.flags = 0;
 
-    if ((vr = VK_CALL(vkCreateSemaphore(device->vk_device, &info, NULL, vk_semaphore))) < 0)
+    if ((vr = VK_CALL(vkCreateSemaphore(device->vk_device, &info, &vkd3d_vk_allocator, vk_semaphore))) < 0)
         ERR("Failed to create timeline semaphore, vr %d.\n", vr);
 
     return hresult_from_vk_result(vr);
 }
 
+static void vkd3d_fence_worker_wake_locked(struct vkd3d_fence_worker *worker)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &worker->device->vk_procs;
+    VkSemaphoreSignalInfoKHR signal_info;
+    VkResult vr;
+
+    if (!worker->is_waiting || worker->wake_pending)
+        return;
+
+    signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+    signal_info.pNext = NULL;
+    signal_info.semaphore = worker->wake_semaphore;
+    signal_info.value = ++worker->wake_value;
+
+    if ((vr = VK_CALL(vkSignalSemaphoreKHR(worker->device->vk_device, &signal_info))))
+        ERR("Failed to signal wake semaphore, vr %d.\n", vr);
+    else
+        worker->wake_pending = true;
+}
+
 static HRESULT vkd3d_enqueue_timeline_semaphore(struct vkd3d_fence_worker *worker,
         struct d3d12_fence *fence, uint64_t value, struct vkd3d_queue *queue)
 {
@@ -321,31 +400,16 @@ static HRESULT vkd3d_enqueue_timeline_semaphore(struct vkd3d_fence_worker *worke
     waiting_fence->value = value;
     ++worker->enqueued_fence_count;
 
+    vkd3d_fence_worker_wake_locked(worker);
     pthread_cond_signal(&worker->cond);
     pthread_mutex_unlock(&worker->mutex);
     return S_OK;
 }
 
-static void vkd3d_wait_for_gpu_timeline_semaphore(struct vkd3d_fence_worker *worker, const struct vkd3d_waiting_fence *fence)
+static void vkd3d_fence_worker_signal_fence(struct vkd3d_fence_worker *worker, const struct vkd3d_waiting_fence *fence)
 {
     struct d3d12_device *device = worker->device;
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
-    VkSemaphoreWaitInfoKHR wait_info;
     HRESULT hr;
-    int vr;
-
-    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
-    wait_info.pNext = NULL;
-    wait_info.flags = 0;
-    wait_info.semaphoreCount = 1;
-    wait_info.pSemaphores = &fence->fence->timeline_semaphore;
-    wait_info.pValues = &fence->value;
-
-    if ((vr = VK_CALL(vkWaitSemaphoresKHR(device->vk_device, &wait_info, ~(uint64_t)0))))
-    {
-        ERR("Failed to wait for Vulkan timeline semaphore, vr %d.\n", vr);
-        return;
-    }
 
     /* This is a good time to kick the debug threads into action. */
     if (device->debug_ring.active)
@@ -359,13 +423,77 @@ static void vkd3d_wait_for_gpu_timeline_semaphore(struct vkd3d_fence_worker *wor
     d3d12_fence_dec_ref(fence->fence);
 }
 
+/* Waits until any of the fences completes or the worker is woken up, then signals
+ * all completed fences in submission order. Returns the number of fences still pending. */
+static uint32_t vkd3d_fence_worker_wait_any(struct vkd3d_fence_worker *worker,
+        struct vkd3d_waiting_fence *fences, uint32_t fence_count,
+        VkSemaphore **vk_semaphores, size_t *vk_semaphores_size,
+        uint64_t **vk_values, size_t *vk_values_size, uint64_t wake_value)
+{
+    struct d3d12_device *device = worker->device;
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkSemaphoreWaitInfoKHR wait_info;
+    uint32_t i, pending_count;
+    uint64_t current_value;
+    VkResult vr;
+
+    if (!vkd3d_array_reserve((void **)vk_semaphores, vk_semaphores_size, fence_count + 1, sizeof(**vk_semaphores)) ||
+            !vkd3d_array_reserve((void **)vk_values, vk_values_size, fence_count + 1, sizeof(**vk_values)))
+    {
+        ERR("Failed to allocate wait arrays.\n");
+        return fence_count;
+    }
+
+    for (i = 0; i < fence_count; i++)
+    {
+        (*vk_semaphores)[i] = fences[i].fence->timeline_semaphore;
+        (*vk_values)[i] = fences[i].value;
+    }
+
+    (*vk_semaphores)[fence_count] = worker->wake_semaphore;
+    (*vk_values)[fence_count] = wake_value;
+
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    wait_info.pNext = NULL;
+    wait_info.flags = VK_SEMAPHORE_WAIT_ANY_BIT_KHR;
+    wait_info.semaphoreCount = fence_count + 1;
+    wait_info.pSemaphores = *vk_semaphores;
+    wait_info.pValues = *vk_values;
+
+    if ((vr = VK_CALL(vkWaitSemaphoresKHR(device->vk_device, &wait_info, ~(uint64_t)0))))
+    {
+        ERR("Failed to wait for Vulkan timeline semaphores, vr %d.\n", vr);
+        return fence_count;
+    }
+
+    for (i = 0, pending_count = 0; i < fence_count; i++)
+    {
+        if ((vr = VK_CALL(vkGetSemaphoreCounterValueKHR(device->vk_device,
+                fences[i].fence->timeline_semaphore, &current_value))))
+        {
+            ERR("Failed to query Vulkan timeline semaphore, vr %d.\n", vr);
+            current_value = 0;
+        }
+
+        if (current_value >= fences[i].value)
+            vkd3d_fence_worker_signal_fence(worker, &fences[i]);
+        else
+            fences[pending_count++] = fences[i];
+    }
+
+    return pending_count;
+}
+
 static void *vkd3d_fence_worker_main(void *arg)
 {
-    struct vkd3d_waiting_fence *cur_fences, *old_fences;
     struct vkd3d_fence_worker *worker = arg;
-    size_t cur_fences_size, old_fences_size;
+    size_t cur_fences_size, vk_semaphores_size;
+    struct vkd3d_waiting_fence *cur_fences;
+    size_t vk_values_size;
+    VkSemaphore *vk_semaphores;
     uint32_t cur_fence_count;
-    uint32_t i;
+    uint64_t *vk_values;
+    uint64_t wake_value;
     bool do_exit;
     int rc;
 
@@ -374,6 +502,10 @@ static void *vkd3d_fence_worker_main(void *arg)
     cur_fence_count = 0;
     cur_fences_size = 0;
     cur_fences = NULL;
+    vk_semaphores = NULL;
+    vk_semaphores_size = 0;
+    vk_values = NULL;
+    vk_values_size = 0;
 
     for (;;)
     {
@@ -383,37 +515,51 @@ static void *vkd3d_fence_worker_main(void *arg)
             break;
         }
 
-        if (!worker->enqueued_fence_count && !worker->should_exit)
+        worker->is_waiting = false;
+        worker->wake_pending = false;
+
+        while (!cur_fence_count && !worker->enqueued_fence_count && !worker->should_exit)
         {
             if ((rc = pthread_cond_wait(&worker->cond, &worker->mutex)))
             {
                 ERR("Failed to wait on condition variable, error %d.\n", rc);
-                pthread_mutex_unlock(&worker->mutex);
                 break;
             }
         }
 
-        old_fences_size = cur_fences_size;
-        old_fences = cur_fences;
+        if (worker->enqueued_fence_count)
+        {
+            if (vkd3d_array_reserve((void **)&cur_fences, &cur_fences_size,
+                    cur_fence_count + worker->enqueued_fence_count, sizeof(*cur_fences)))
+            {
+                memcpy(cur_fences + cur_fence_count, worker->enqueued_fences,
+                        worker->enqueued_fence_count * sizeof(*cur_fences));
+                cur_fence_count += worker->enqueued_fence_count;
+                worker->enqueued_fence_count = 0;
+            }
+            else
+                ERR("Failed to move enqueued fences.\n");
+        }
 
-        cur_fence_count = worker->enqueued_fence_count;
-        cur_fences_size = worker->enqueued_fences_size;
-        cur_fences = worker->enqueued_fences;
         do_exit = worker->should_exit;
 
-        worker->enqueued_fence_count = 0;
-        worker->enqueued_fences_size = old_fences_size;
-        worker->enqueued_fences = old_fences;
+        /* Any enqueue from here on must interrupt the wait. */
+        worker->is_waiting = !!cur_fence_count;
+        wake_value = worker->wake_value + 1;
 
         pthread_mutex_unlock(&worker->mutex);
 
-        for (i = 0; i < cur_fence_count; i++)
-            vkd3d_wait_for_gpu_timeline_semaphore(worker, &cur_fences[i]);
-
-        if (do_exit)
+        if (cur_fence_count)
+        {
+            cur_fence_count = vkd3d_fence_worker_wait_any(worker, cur_fences, cur_fence_count,
+                    &vk_semaphores, &vk_semaphores_size, &vk_values, &vk_values_size, wake_value);
+        }
+        else if (do_exit)
             break;
     }
 
+    vkd3d_free(vk_semaphores);
+    vkd3d_free(vk_values);
     vkd3d_free(cur_fences);
     return NULL;
 }
@@ -421,6 +567,7 @@ static void *vkd3d_fence_worker_main(void *arg)
 HRESULT vkd3d_fence_worker_start(struct vkd3d_fence_worker *worker,
         struct d3d12_device *device)
 {
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     HRESULT hr;
     int rc;
 
@@ -433,32 +580,46 @@ HRESULT vkd3d_fence_worker_start(struct vkd3d_fence_worker *worker,
     worker->enqueued_fences = NULL;
     worker->enqueued_fences_size = 0;
 
+    worker->wake_value = 0;
+    worker->is_waiting = false;
+    worker->wake_pending = false;
+
+    if (FAILED(hr = vkd3d_create_timeline_semaphore(device, 0, &worker->wake_semaphore)))
+        return hr;
+
     if ((rc = pthread_mutex_init(&worker->mutex, NULL)))
     {
         ERR("Failed to initialize mutex, error %d.\n", rc);
-        return hresult_from_errno(rc);
+        hr = hresult_from_errno(rc);
+        goto fail_mutex;
     }
 
     if ((rc = pthread_cond_init(&worker->cond, NULL)))
     {
         ERR("Failed to initialize condition variable, error %d.\n", rc);
-        pthread_mutex_destroy(&worker->mutex);
-        return hresult_from_errno(rc);
+        hr = hresult_from_errno(rc);
+        goto fail_cond;
     }
 
     if (FAILED(hr = vkd3d_create_thread(device->vkd3d_instance,
             vkd3d_fence_worker_main, worker, &worker->thread)))
-    {
-        pthread_mutex_destroy(&worker->mutex);
-        pthread_cond_destroy(&worker->cond);
-    }
+        goto fail_thread;
 
+    return S_OK;
+
+fail_thread:
+    pthread_cond_destroy(&worker->cond);
+fail_cond:
+    pthread_mutex_destroy(&worker->mutex);
+fail_mutex:
+    VK_CALL(vkDestroySemaphore(device->vk_device, worker->wake_semaphore, &vkd3d_vk_allocator));
     return hr;
 }
 
 HRESULT vkd3d_fence_worker_stop(struct vkd3d_fence_worker *worker,
         struct d3d12_device *device)
 {
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     HRESULT hr;
     int rc;
 
@@ -471,6 +632,7 @@ HRESULT vkd3d_fence_worker_stop(struct vkd3d_fence_worker *worker,
     }
 
     worker->should_exit = true;
+    vkd3d_fence_worker_wake_locked(worker);
     pthread_cond_signal(&worker->cond);
 
     pthread_mutex_unlock(&worker->mutex);
@@ -480,6 +642,7 @@ HRESULT vkd3d_fence_worker_stop(struct vkd3d_fence_worker *worker,
 
     pthread_mutex_destroy(&worker->mutex);
     pthread_cond_destroy(&worker->cond);
+    VK_CALL(vkDestroySemaphore(device->vk_device, worker->wake_semaphore, &vkd3d_vk_allocator));
 
     vkd3d_free(worker->enqueued_fences);
     return S_OK;
@@ -532,7 +695,7 @@ static void d3d12_fence_destroy_vk_objects(struct d3d12_fence *fence)
     }
 
     vk_procs = &device->vk_procs;
-    VK_CALL(vkDestroySemaphore(device->vk_device, fence->timeline_semaphore, NULL));
+    VK_CALL(vkDestroySemaphore(device->vk_device, fence->timeline_semaphore, &vkd3d_vk_allocator));
     pthread_mutex_unlock(&fence->mutex);
 }
 
@@ -552,8 +715,8 @@ static void d3d12_fence_dec_ref(struct d3d12_fence *fence)
 
         vkd3d_free(fence->events);
         vkd3d_free(fence->pending_updates);
+        vkd3d_free(fence->parked_queues);
         pthread_mutex_destroy(&fence->mutex);
-        pthread_cond_destroy(&fence->cond);
         pthread_cond_destroy(&fence->null_event_cond);
         vkd3d_free(fence);
     }
@@ -616,13 +779,24 @@ static void d3d12_fence_signal_external_events_locked(struct d3d12_fence *fence)
         pthread_cond_broadcast(&fence->null_event_cond);
 }
 
-static void d3d12_fence_block_until_pending_value_reaches_locked(struct d3d12_fence *fence, UINT64 pending_value)
+static bool d3d12_fence_park_queue_locked(struct d3d12_fence *fence,
+        struct d3d12_command_queue *queue, uint64_t value)
 {
-    while (pending_value > fence->max_pending_virtual_timeline_value)
+    struct vkd3d_parked_queue *parked;
+
+    if (!vkd3d_array_reserve((void **)&fence->parked_queues, &fence->parked_queues_size,
+            fence->parked_queue_count + 1, sizeof(*fence->parked_queues)))
     {
-        TRACE("Blocking wait on fence %p until it reaches 0x%"PRIx64".\n", fence, pending_value);
-        pthread_cond_wait(&fence->cond, &fence->mutex);
+        ERR("Failed to park queue %p on fence %p.\n", queue, fence);
+        return false;
     }
+
+    TRACE("Parking queue %p on fence %p until it reaches 0x%"PRIx64".\n", queue, fence, value);
+
+    parked = &fence->parked_queues[fence->parked_queue_count++];
+    parked->queue = queue;
+    parked->value = value;
+    return true;
 }
 
 static void d3d12_fence_update_pending_value_locked(struct d3d12_fence *fence)
@@ -634,9 +808,19 @@ static void d3d12_fence_update_pending_value_locked(struct d3d12_fence *fence)
         new_max_pending_virtual_timeline_value = max(fence->pending_updates[i].virtual_value, new_max_pending_virtual_timeline_value);
     new_max_pending_virtual_timeline_value = max(fence->virtual_value, new_max_pending_virtual_timeline_value);
 
-    /* If we're signalling the fence, wake up any submission threads which can now safely kick work. */
+    /* If we're signalling the fence, reschedule any queues which can now safely kick work. */
     fence->max_pending_virtual_timeline_value = new_max_pending_virtual_timeline_value;
-    pthread_cond_broadcast(&fence->cond);
+
+    for (i = 0; i < fence->parked_queue_count; )
+    {
+        if (fence->parked_queues[i].value <= new_max_pending_virtual_timeline_value)
+        {
+            vkd3d_queue_worker_pool_schedule(&fence->device->queue_worker_pool, fence->parked_queues[i].queue);
+            fence->parked_queues[i] = fence->parked_queues[--fence->parked_queue_count];
+        }
+        else
+            i++;
+    }
 }
 
 static void d3d12_fence_lock(struct d3d12_fence *fence)
@@ -1034,18 +1218,10 @@ static HRESULT d3d12_fence_init(struct d3d12_fence *fence, struct d3d12_device *
         return hresult_from_errno(rc);
     }
 
-    if ((rc = pthread_cond_init(&fence->cond, NULL)))
-    {
-        ERR("Failed to initialize cond variable, error %d.\n", rc);
-        pthread_mutex_destroy(&fence->mutex);
-        return hresult_from_errno(rc);
-    }
-
     if ((rc = pthread_cond_init(&fence->null_event_cond, NULL)))
     {
         ERR("Failed to initialize cond variable, error %d.\n", rc);
         pthread_mutex_destroy(&fence->mutex);
-        pthread_cond_destroy(&fence->cond);
         return hresult_from_errno(rc);
     }
 
@@ -1060,10 +1236,13 @@ static HRESULT d3d12_fence_init(struct d3d12_fence *fence, struct d3d12_device *
     fence->pending_updates_count = 0;
     fence->pending_updates_size = 0;
 
+    fence->parked_queues = NULL;
+    fence->parked_queues_size = 0;
+    fence->parked_queue_count = 0;
+
     if (FAILED(hr = vkd3d_private_store_init(&fence->private_store)))
     {
         pthread_mutex_destroy(&fence->mutex);
-        pthread_cond_destroy(&fence->cond);
         pthread_cond_destroy(&fence->null_event_cond);
         return hr;
     }
@@ -1249,17 +1428,6 @@ static void d3d12_command_allocator_free_command_buffer(struct d3d12_command_all
     d3d12_command_allocator_free_vk_command_buffer(allocator, list->vk_init_commands);
 }
 
-static bool d3d12_command_allocator_add_render_pass(struct d3d12_command_allocator *allocator, VkRenderPass pass)
-{
-    if (!vkd3d_array_reserve((void **)&allocator->passes, &allocator->passes_size,
-            allocator->pass_count + 1, sizeof(*allocator->passes)))
-        return false;
-
-    allocator->passes[allocator->pass_count++] = pass;
-
-    return true;
-}
-
 static bool d3d12_command_allocator_add_framebuffer(struct d3d12_command_allocator *allocator,
         VkFramebuffer framebuffer)
 {
@@ -1360,7 +1528,7 @@ static VkDescriptorPool d3d12_command_allocator_allocate_descriptor_pool(
             pool_desc.poolSizeCount -= 1;
         }
 
-        if ((vr = VK_CALL(vkCreateDescriptorPool(vk_device, &pool_desc, NULL, &vk_pool))) < 0)
+        if ((vr = VK_CALL(vkCreateDescriptorPool(vk_device, &pool_desc, &vkd3d_vk_allocator, &vk_pool))) < 0)
         {
             ERR("Failed to create descriptor pool, vr %d.\n", vr);
             return VK_NULL_HANDLE;
@@ -1370,7 +1538,7 @@ static VkDescriptorPool d3d12_command_allocator_allocate_descriptor_pool(
     if (!(d3d12_command_allocator_add_descriptor_pool(allocator, vk_pool, pool_type)))
     {
         ERR("Failed to add descriptor pool.\n");
-        VK_CALL(vkDestroyDescriptorPool(vk_device, vk_pool, NULL));
+        VK_CALL(vkDestroyDescriptorPool(vk_device, vk_pool, &vkd3d_vk_allocator));
         return VK_NULL_HANDLE;
     }
 
@@ -1458,14 +1626,14 @@ static void d3d12_command_allocator_free_descriptor_pool_cache(struct d3d12_comm
     {
         for (i = 0; i < cache->free_descriptor_pool_count; ++i)
         {
-            VK_CALL(vkDestroyDescriptorPool(device->vk_device, cache->free_descriptor_pools[i], NULL));
+            VK_CALL(vkDestroyDescriptorPool(device->vk_device, cache->free_descriptor_pools[i], &vkd3d_vk_allocator));
         }
         cache->free_descriptor_pool_count = 0;
     }
 
     for (i = 0; i < cache->descriptor_pool_count; ++i)
     {
-        VK_CALL(vkDestroyDescriptorPool(device->vk_device, cache->descriptor_pools[i], NULL));
+        VK_CALL(vkDestroyDescriptorPool(device->vk_device, cache->descriptor_pools[i], &vkd3d_vk_allocator));
     }
     cache->descriptor_pool_count = 0;
 }
@@ -1486,7 +1654,7 @@ static void d3d12_command_allocator_free_resources(struct d3d12_command_allocato
 
     for (i = 0; i < allocator->buffer_view_count; ++i)
     {
-        VK_CALL(vkDestroyBufferView(device->vk_device, allocator->buffer_views[i], NULL));
+        VK_CALL(vkDestroyBufferView(device->vk_device, allocator->buffer_views[i], &vkd3d_vk_allocator));
     }
     allocator->buffer_view_count = 0;
 
@@ -1498,15 +1666,9 @@ static void d3d12_command_allocator_free_resources(struct d3d12_command_allocato
 
     for (i = 0; i < allocator->framebuffer_count; ++i)
     {
-        VK_CALL(vkDestroyFramebuffer(device->vk_device, allocator->framebuffers[i], NULL));
+        VK_CALL(vkDestroyFramebuffer(device->vk_device, allocator->framebuffers[i], &vkd3d_vk_allocator));
     }
     allocator->framebuffer_count = 0;
-
-    for (i = 0; i < allocator->pass_count; ++i)
-    {
-        VK_CALL(vkDestroyRenderPass(device->vk_device, allocator->passes[i], NULL));
-    }
-    allocator->pass_count = 0;
 }
 
 static void d3d12_command_allocator_set_name(struct d3d12_command_allocator *allocator, const char *name)
@@ -1557,7 +1719,7 @@ static ULONG STDMETHODCALLTYPE d3d12_command_allocator_Release(ID3D12CommandAllo
 {
     struct d3d12_command_allocator *allocator = impl_from_ID3D12CommandAllocator(iface);
     ULONG refcount = InterlockedDecrement(&allocator->refcount);
-    unsigned int i;
+    unsigned int i, j;
 
     TRACE("%p decreasing refcount to %u.\n", allocator, refcount);
 
@@ -1580,19 +1742,23 @@ static ULONG STDMETHODCALLTYPE d3d12_command_allocator_Release(ID3D12CommandAllo
             vkd3d_free(allocator->descriptor_pool_caches[i].free_descriptor_pools);
         }
         vkd3d_free(allocator->framebuffers);
-        vkd3d_free(allocator->passes);
 
         /* All command buffers are implicitly freed when a pool is destroyed. */
         vkd3d_free(allocator->command_buffers);
-        VK_CALL(vkDestroyCommandPool(device->vk_device, allocator->vk_command_pool, NULL));
+        VK_CALL(vkDestroyCommandPool(device->vk_device, allocator->vk_command_pool, &vkd3d_vk_allocator));
+
+        for (i = 0; i < VKD3D_SCRATCH_POOL_KIND_COUNT; i++)
+        {
+            struct d3d12_command_allocator_scratch_pool *pool = &allocator->scratch_pools[i];
 
-        for (i = 0; i < allocator->scratch_buffer_count; i++)
-            d3d12_device_return_scratch_buffer(device, &allocator->scratch_buffers[i]);
+            for (j = 0; j < pool->scratch_buffer_count; j++)
+                d3d12_device_return_scratch_buffer(device, i, &pool->scratch_buffers[j]);
+            vkd3d_free(pool->scratch_buffers);
+        }
 
         for (i = 0; i < allocator->query_pool_count; i++)
             d3d12_device_return_query_pool(device, &allocator->query_pools[i]);
 
-        vkd3d_free(allocator->scratch_buffers);
         vkd3d_free(allocator->query_pools);
         vkd3d_free(allocator);
 
@@ -1651,7 +1817,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_command_allocator_Reset(ID3D12CommandAllo
     struct d3d12_device *device;
     LONG pending;
     VkResult vr;
-    size_t i;
+    size_t i, j;
 
     TRACE("iface %p.\n", iface);
 
@@ -1702,10 +1868,14 @@ static HRESULT STDMETHODCALLTYPE d3d12_command_allocator_Reset(ID3D12CommandAllo
     }
 
     /* Return scratch buffers to the device */
-    for (i = 0; i < allocator->scratch_buffer_count; i++)
-        d3d12_device_return_scratch_buffer(device, &allocator->scratch_buffers[i]);
+    for (i = 0; i < VKD3D_SCRATCH_POOL_KIND_COUNT; i++)
+    {
+        struct d3d12_command_allocator_scratch_pool *pool = &allocator->scratch_pools[i];
 
-    allocator->scratch_buffer_count = 0;
+        for (j = 0; j < pool->scratch_buffer_count; j++)
+            d3d12_device_return_scratch_buffer(device, i, &pool->scratch_buffers[j]);
+        pool->scratch_buffer_count = 0;
+    }
 
     /* Return query pools to the device */
     for (i = 0; i < allocator->query_pool_count; i++)
@@ -1810,7 +1980,7 @@ static HRESULT d3d12_command_allocator_init(struct d3d12_command_allocator *allo
     command_pool_info.flags = 0;
     command_pool_info.queueFamilyIndex = queue_family->vk_family_index;
 
-    if ((vr = VK_CALL(vkCreateCommandPool(device->vk_device, &command_pool_info, NULL,
+    if ((vr = VK_CALL(vkCreateCommandPool(device->vk_device, &command_pool_info, &vkd3d_vk_allocator,
             &allocator->vk_command_pool))) < 0)
     {
         WARN("Failed to create Vulkan command pool, vr %d.\n", vr);
@@ -1820,10 +1990,6 @@ static HRESULT d3d12_command_allocator_init(struct d3d12_command_allocator *allo
 
     memset(allocator->descriptor_pool_caches, 0, sizeof(allocator->descriptor_pool_caches));
 
-    allocator->passes = NULL;
-    allocator->passes_size = 0;
-    allocator->pass_count = 0;
-
     allocator->framebuffers = NULL;
     allocator->framebuffers_size = 0;
     allocator->framebuffer_count = 0;
@@ -1841,9 +2007,7 @@ static HRESULT d3d12_command_allocator_init(struct d3d12_command_allocator *allo
     allocator->command_buffers_size = 0;
     allocator->command_buffer_count = 0;
 
-    allocator->scratch_buffers = NULL;
-    allocator->scratch_buffers_size = 0;
-    allocator->scratch_buffer_count = 0;
+    memset(allocator->scratch_pools, 0, sizeof(allocator->scratch_pools));
 
     allocator->query_pools = NULL;
     allocator->query_pools_size = 0;
@@ -1890,11 +2054,25 @@ struct vkd3d_scratch_allocation
     VkBuffer buffer;
     VkDeviceSize offset;
     VkDeviceAddress va;
+    /* Only set for VKD3D_SCRATCH_POOL_KIND_UPLOAD allocations. */
+    void *host_ptr;
 };
 
+static void vkd3d_scratch_allocation_init(struct vkd3d_scratch_allocation *allocation,
+        const struct vkd3d_scratch_buffer *scratch, VkDeviceSize offset)
+{
+    allocation->buffer = scratch->allocation.resource.vk_buffer;
+    allocation->offset = scratch->allocation.offset + offset;
+    allocation->va = scratch->allocation.resource.va + offset;
+    allocation->host_ptr = scratch->allocation.cpu_address ?
+            void_ptr_offset(scratch->allocation.cpu_address, offset) : NULL;
+}
+
 static bool d3d12_command_allocator_allocate_scratch_memory(struct d3d12_command_allocator *allocator,
-        VkDeviceSize size, VkDeviceSize alignment, struct vkd3d_scratch_allocation *allocation)
+        enum vkd3d_scratch_pool_kind kind, VkDeviceSize size, VkDeviceSize alignment,
+        struct vkd3d_scratch_allocation *allocation)
 {
+    struct d3d12_command_allocator_scratch_pool *pool = &allocator->scratch_pools[kind];
     VkDeviceSize aligned_offset, aligned_size;
     struct vkd3d_scratch_buffer *scratch;
     unsigned int i;
@@ -1902,42 +2080,36 @@ static bool d3d12_command_allocator_allocate_scratch_memory(struct d3d12_command
     aligned_size = align(size, alignment);
 
     /* Probe last block first since the others are likely full */
-    for (i = allocator->scratch_buffer_count; i; i--)
+    for (i = pool->scratch_buffer_count; i; i--)
     {
-        scratch = &allocator->scratch_buffers[i - 1];
+        scratch = &pool->scratch_buffers[i - 1];
         aligned_offset = align(scratch->offset, alignment);
 
         if (aligned_offset + aligned_size <= scratch->allocation.resource.size)
         {
             scratch->offset = aligned_offset + aligned_size;
-
-            allocation->buffer = scratch->allocation.resource.vk_buffer;
-            allocation->offset = scratch->allocation.offset + aligned_offset;
-            allocation->va = scratch->allocation.resource.va + aligned_offset;
+            vkd3d_scratch_allocation_init(allocation, scratch, aligned_offset);
             return true;
         }
     }
 
-    if (!vkd3d_array_reserve((void**)&allocator->scratch_buffers, &allocator->scratch_buffers_size,
-            allocator->scratch_buffer_count + 1, sizeof(*allocator->scratch_buffers)))
+    if (!vkd3d_array_reserve((void**)&pool->scratch_buffers, &pool->scratch_buffers_size,
+            pool->scratch_buffer_count + 1, sizeof(*pool->scratch_buffers)))
     {
         ERR("Failed to allocate scratch buffer.\n");
         return false;
     }
 
-    scratch = &allocator->scratch_buffers[allocator->scratch_buffer_count];
-    if (FAILED(d3d12_device_get_scratch_buffer(allocator->device, aligned_size, scratch)))
+    scratch = &pool->scratch_buffers[pool->scratch_buffer_count];
+    if (FAILED(d3d12_device_get_scratch_buffer(allocator->device, kind, aligned_size, scratch)))
     {
         ERR("Failed to create scratch buffer.\n");
         return false;
     }
 
-    allocator->scratch_buffer_count += 1;
+    pool->scratch_buffer_count += 1;
     scratch->offset = aligned_size;
-
-    allocation->buffer = scratch->allocation.resource.vk_buffer;
-    allocation->offset = scratch->allocation.offset;
-    allocation->va = scratch->allocation.resource.va;
+    vkd3d_scratch_allocation_init(allocation, scratch, 0);
     return true;
 }
 
@@ -2246,6 +2418,8 @@ static void d3d12_command_list_notify_decay_dsv_resource(struct d3d12_command_li
     if (resource->desc.Flags & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE)
         return;
 
+    d3d12_command_list_track_dsv_boundary_layout(list, resource, 0);
+
     for (i = 0, n = list->dsv_resource_tracking_count; i < n; i++)
     {
         if (list->dsv_resource_tracking[i].resource == resource)
@@ -2274,6 +2448,8 @@ static uint32_t d3d12_command_list_promote_dsv_resource(struct d3d12_command_lis
     if (!(resource->format->vk_aspect_mask & VK_IMAGE_ASPECT_DEPTH_BIT))
         plane_optimal_mask |= (plane_optimal_mask & VKD3D_STENCIL_PLANE_OPTIMAL) ? VKD3D_DEPTH_PLANE_OPTIMAL : 0;
 
+    d3d12_command_list_track_dsv_boundary_layout(list, resource, 0);
+
     for (i = 0, n = list->dsv_resource_tracking_count; i < n; i++)
     {
         if (list->dsv_resource_tracking[i].resource == resource)
@@ -2381,184 +2557,342 @@ static void d3d12_command_list_notify_dsv_state(struct d3d12_command_list *list,
     }
 }
 
-static void d3d12_command_list_decay_optimal_dsv_resources(struct d3d12_command_list *list)
+static bool d3d12_resource_supports_dsv_boundary_layout(const struct d3d12_resource *resource)
 {
-    struct d3d12_command_list_barrier_batch batch;
-    size_t i, n;
+    /* Images which may alias other resources or are shared externally must be in their
+     * common layout outside of command lists. Queue family ownership transfers keep
+     * whatever layout the previous owner left the image in. */
+    return (resource->desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) &&
+            resource->common_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL &&
+            (resource->flags & VKD3D_RESOURCE_COMMITTED) &&
+            !(resource->flags & VKD3D_RESOURCE_EXTERNAL);
+}
 
-    d3d12_command_list_barrier_batch_init(&batch);
-    for (i = 0, n = list->dsv_resource_tracking_count; i < n; i++)
+static struct d3d12_dsv_boundary_layout *d3d12_command_list_find_dsv_boundary_layout(
+        struct d3d12_command_list *list, const struct d3d12_resource *resource)
+{
+    size_t i;
+
+    for (i = 0; i < list->dsv_boundary_layout_count; i++)
     {
-        const struct d3d12_resource_tracking *track = &list->dsv_resource_tracking[i];
-        d3d12_command_list_decay_optimal_dsv_resource(list, track->resource, track->plane_optimal_mask, &batch);
+        if (list->dsv_boundary_layouts[i].resource == resource)
+            return &list->dsv_boundary_layouts[i];
     }
-    d3d12_command_list_barrier_batch_end(list, &batch);
-    list->dsv_resource_tracking_count = 0;
+
+    return NULL;
 }
 
-static VkImageLayout d3d12_command_list_get_depth_stencil_resource_layout(const struct d3d12_command_list *list,
-        const struct d3d12_resource *resource, uint32_t *plane_optimal_mask)
+static void d3d12_command_list_track_dsv_boundary_layout(struct d3d12_command_list *list,
+        struct d3d12_resource *resource, uint32_t depth_state_plane_mask)
 {
-    size_t i, n;
+    struct d3d12_dsv_boundary_layout *boundary;
+    uint32_t plane_optimal_mask;
 
-    if (resource->desc.Flags & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE)
+    /* Called on the first use of a DSV resource in a command list. depth_state_plane_mask
+     * contains the planes which are known to be in DEPTH_READ or DEPTH_WRITE state at this point,
+     * for those planes we can assume the layout the resource was last left in by the queue.
+     * If that guess turns out to be wrong, the queue will fix up the layout before submission. */
+    if (!d3d12_resource_supports_dsv_boundary_layout(resource))
+        return;
+
+    if (d3d12_command_list_find_dsv_boundary_layout(list, resource))
+        return;
+
+    if (!vkd3d_array_reserve((void **)&list->dsv_boundary_layouts, &list->dsv_boundary_layouts_size,
+            list->dsv_boundary_layout_count + 1, sizeof(*list->dsv_boundary_layouts)))
     {
-        if (plane_optimal_mask)
-            *plane_optimal_mask = VKD3D_DEPTH_PLANE_OPTIMAL | VKD3D_STENCIL_PLANE_OPTIMAL;
-        return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        d3d12_command_list_mark_as_invalid(list, "Failed to allocate DSV boundary layout.");
+        return;
     }
 
-    for (i = 0, n = list->dsv_resource_tracking_count; i < n; i++)
+    if (!(resource->format->vk_aspect_mask & VK_IMAGE_ASPECT_STENCIL_BIT))
+        depth_state_plane_mask |= (depth_state_plane_mask & VKD3D_DEPTH_PLANE_OPTIMAL) ? VKD3D_STENCIL_PLANE_OPTIMAL : 0;
+    if (!(resource->format->vk_aspect_mask & VK_IMAGE_ASPECT_DEPTH_BIT))
+        depth_state_plane_mask |= (depth_state_plane_mask & VKD3D_STENCIL_PLANE_OPTIMAL) ? VKD3D_DEPTH_PLANE_OPTIMAL : 0;
+
+    plane_optimal_mask = depth_state_plane_mask & vkd3d_atomic_uint32_load_explicit(
+            &resource->persistent_dsv_plane_optimal_mask, vkd3d_memory_order_relaxed);
+
+    boundary = &list->dsv_boundary_layouts[list->dsv_boundary_layout_count++];
+    memset(boundary, 0, sizeof(*boundary));
+    boundary->resource = resource;
+    boundary->entry_plane_optimal_mask = plane_optimal_mask;
+
+    if (!plane_optimal_mask)
+        return;
+
+    if (!vkd3d_array_reserve((void **)&list->dsv_resource_tracking, &list->dsv_resource_tracking_size,
+            list->dsv_resource_tracking_count + 1, sizeof(*list->dsv_resource_tracking)))
     {
-        if (resource == list->dsv_resource_tracking[i].resource)
-        {
-            if (plane_optimal_mask)
-                *plane_optimal_mask = list->dsv_resource_tracking[i].plane_optimal_mask;
-            return dsv_plane_optimal_mask_to_layout(list->dsv_resource_tracking[i].plane_optimal_mask,
-                    resource->format->vk_aspect_mask);
-        }
+        d3d12_command_list_mark_as_invalid(list, "Failed to allocate DSV resource tracking.");
+        return;
     }
 
-    if (plane_optimal_mask)
-        *plane_optimal_mask = 0;
-    return resource->common_layout;
-}
-
-static VkImageLayout vk_separate_depth_layout(VkImageLayout combined_layout)
-{
-    return (combined_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL ||
-            combined_layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_STENCIL_READ_ONLY_OPTIMAL) ?
-            VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL;
+    list->dsv_resource_tracking[list->dsv_resource_tracking_count].resource = resource;
+    list->dsv_resource_tracking[list->dsv_resource_tracking_count].plane_optimal_mask = plane_optimal_mask;
+    list->dsv_resource_tracking_count++;
 }
 
-static VkImageLayout vk_separate_stencil_layout(VkImageLayout combined_layout)
+static void d3d12_command_list_track_dsv_boundary_layout_for_view(struct d3d12_command_list *list,
+        struct d3d12_resource *resource, const struct vkd3d_view *view)
 {
-    return (combined_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL ||
-            combined_layout == VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_STENCIL_ATTACHMENT_OPTIMAL) ?
-            VK_IMAGE_LAYOUT_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_STENCIL_READ_ONLY_OPTIMAL;
+    /* Views used as DSV must be in a depth state. This proves the state of all planes
+     * if the view covers the entire resource. */
+    d3d12_command_list_track_dsv_boundary_layout(list, resource,
+            view->info.texture.layer_count == resource->desc.DepthOrArraySize &&
+            resource->desc.MipLevels == 1 ? VKD3D_DEPTH_PLANE_OPTIMAL | VKD3D_STENCIL_PLANE_OPTIMAL : 0);
 }
 
-static void d3d12_command_list_clear_attachment_pass(struct d3d12_command_list *list, struct d3d12_resource *resource,
-        struct vkd3d_view *view, VkImageAspectFlags clear_aspects, const VkClearValue *clear_value, UINT rect_count,
-        const D3D12_RECT *rects, bool is_bound)
+static HRESULT d3d12_command_list_record_dsv_boundary_transition(struct d3d12_command_list *list,
+        const struct d3d12_resource *resource, VkImageLayout old_layout, VkImageLayout new_layout,
+        VkCommandBuffer *vk_command_buffer)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
-    VkAttachmentDescriptionStencilLayout stencil_attachment_desc;
-    VkAttachmentReferenceStencilLayout stencil_attachment_ref;
-    VkAttachmentDescription2KHR attachment_desc;
-    VkAttachmentReference2KHR attachment_ref;
-    VkSubpassBeginInfoKHR subpass_begin_info;
-    VkSubpassDependency2KHR dependencies[2];
-    VkSubpassDescription2KHR subpass_desc;
-    VkSubpassEndInfoKHR subpass_end_info;
-    VkRenderPassCreateInfo2KHR pass_info;
-    VkRenderPassBeginInfo begin_info;
-    VkFramebuffer vk_framebuffer;
-    VkRenderPass vk_render_pass;
-    VkPipelineStageFlags stages;
-    uint32_t plane_write_mask;
-    bool separate_ds_layouts;
-    VkAccessFlags access;
-    VkExtent3D extent;
-    bool clear_op;
+    struct d3d12_command_allocator *allocator = list->allocator;
+    VkCommandBufferAllocateInfo command_buffer_info;
+    VkCommandBufferBeginInfo begin_info;
+    VkImageMemoryBarrier barrier;
     VkResult vr;
 
-    attachment_desc.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2_KHR;
-    attachment_desc.pNext = NULL;
-    attachment_desc.flags = 0;
-    attachment_desc.format = view->format->vk_format;
-    attachment_desc.samples = vk_samples_from_dxgi_sample_desc(&resource->desc.SampleDesc);
-    attachment_desc.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-    attachment_desc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    attachment_desc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-    attachment_desc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
-
-    /* If we need to discard a single aspect, use separate layouts, since we have to use UNDEFINED barrier when we can. */
-    separate_ds_layouts = view->format->vk_aspect_mask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) &&
-            clear_aspects != view->format->vk_aspect_mask;
+    command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    command_buffer_info.pNext = NULL;
+    command_buffer_info.commandPool = allocator->vk_command_pool;
+    command_buffer_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    command_buffer_info.commandBufferCount = 1;
 
-    if (clear_aspects & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+    if ((vr = VK_CALL(vkAllocateCommandBuffers(list->device->vk_device, &command_buffer_info,
+            vk_command_buffer))) < 0)
     {
-        if (is_bound)
-            attachment_desc.initialLayout = list->dsv_layout;
-        else
-            attachment_desc.initialLayout = d3d12_command_list_get_depth_stencil_resource_layout(list, resource, NULL);
+        WARN("Failed to allocate Vulkan command buffer, vr %d.\n", vr);
+        return hresult_from_vk_result(vr);
+    }
 
-        if (separate_ds_layouts)
-        {
-            stencil_attachment_desc.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_STENCIL_LAYOUT;
-            stencil_attachment_desc.pNext = NULL;
-            stencil_attachment_desc.stencilInitialLayout = vk_separate_stencil_layout(attachment_desc.initialLayout);
-            attachment_desc.initialLayout = vk_separate_depth_layout(attachment_desc.initialLayout);
-            attachment_desc.pNext = &stencil_attachment_desc;
-        }
+    /* Freed along with the other command buffers when the allocator is reset. */
+    d3d12_command_allocator_free_vk_command_buffer(allocator, *vk_command_buffer);
 
-        /* We have proven a write, try to promote the image layout to something OPTIMAL. */
-        plane_write_mask = 0;
-        if (clear_aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
-            plane_write_mask |= VKD3D_DEPTH_PLANE_OPTIMAL;
-        if (clear_aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
-            plane_write_mask |= VKD3D_STENCIL_PLANE_OPTIMAL;
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.pNext = NULL;
+    begin_info.flags = 0;
+    begin_info.pInheritanceInfo = NULL;
 
-        attachment_ref.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-        attachment_desc.finalLayout = dsv_plane_optimal_mask_to_layout(
+    if ((vr = VK_CALL(vkBeginCommandBuffer(*vk_command_buffer, &begin_info))) < 0)
+    {
+        WARN("Failed to begin command buffer, vr %d.\n", vr);
+        return hresult_from_vk_result(vr);
+    }
+
+    /* These only execute when command lists disagree about the layout,
+     * so don't bother with precise stages. */
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.pNext = NULL;
+    barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = resource->res.vk_image;
+    barrier.subresourceRange.aspectMask = resource->format->vk_aspect_mask;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+    VK_CALL(vkCmdPipelineBarrier(*vk_command_buffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            0, 0, NULL, 0, NULL, 1, &barrier));
+
+    if ((vr = VK_CALL(vkEndCommandBuffer(*vk_command_buffer))) < 0)
+    {
+        WARN("Failed to end command buffer, vr %d.\n", vr);
+        return hresult_from_vk_result(vr);
+    }
+
+    return S_OK;
+}
+
+static HRESULT d3d12_command_list_build_dsv_boundary_commands(struct d3d12_command_list *list)
+{
+    struct d3d12_dsv_boundary_layout *boundary;
+    VkImageLayout layout;
+    uint32_t exit_mask;
+    HRESULT hr;
+    size_t i;
+
+    for (i = 0; i < list->dsv_boundary_layout_count; i++)
+    {
+        boundary = &list->dsv_boundary_layouts[i];
+        d3d12_command_list_get_depth_stencil_resource_layout(list, boundary->resource, &exit_mask);
+        boundary->exit_plane_optimal_mask = exit_mask;
+
+        if (boundary->entry_plane_optimal_mask)
+        {
+            layout = dsv_plane_optimal_mask_to_layout(boundary->entry_plane_optimal_mask,
+                    boundary->resource->format->vk_aspect_mask);
+            if (FAILED(hr = d3d12_command_list_record_dsv_boundary_transition(list, boundary->resource,
+                    boundary->resource->common_layout, layout, &boundary->vk_promote_commands)))
+                return hr;
+        }
+
+        if (boundary->exit_plane_optimal_mask)
+        {
+            layout = dsv_plane_optimal_mask_to_layout(boundary->exit_plane_optimal_mask,
+                    boundary->resource->format->vk_aspect_mask);
+            if (FAILED(hr = d3d12_command_list_record_dsv_boundary_transition(list, boundary->resource,
+                    layout, boundary->resource->common_layout, &boundary->vk_decay_commands)))
+                return hr;
+        }
+    }
+
+    return S_OK;
+}
+
+static void d3d12_command_list_decay_optimal_dsv_resources(struct d3d12_command_list *list)
+{
+    struct d3d12_command_list_barrier_batch batch;
+    size_t i, n;
+
+    d3d12_command_list_barrier_batch_init(&batch);
+    for (i = 0, n = list->dsv_resource_tracking_count; i < n; i++)
+    {
+        const struct d3d12_resource_tracking *track = &list->dsv_resource_tracking[i];
+
+        /* The queue decides if these need to decay. */
+        if (d3d12_command_list_find_dsv_boundary_layout(list, track->resource))
+            continue;
+
+        d3d12_command_list_decay_optimal_dsv_resource(list, track->resource, track->plane_optimal_mask, &batch);
+    }
+    d3d12_command_list_barrier_batch_end(list, &batch);
+    list->dsv_resource_tracking_count = 0;
+}
+
+static VkImageLayout d3d12_command_list_get_depth_stencil_resource_layout(const struct d3d12_command_list *list,
+        const struct d3d12_resource *resource, uint32_t *plane_optimal_mask)
+{
+    size_t i, n;
+
+    if (resource->desc.Flags & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE)
+    {
+        if (plane_optimal_mask)
+            *plane_optimal_mask = VKD3D_DEPTH_PLANE_OPTIMAL | VKD3D_STENCIL_PLANE_OPTIMAL;
+        return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    }
+
+    for (i = 0, n = list->dsv_resource_tracking_count; i < n; i++)
+    {
+        if (resource == list->dsv_resource_tracking[i].resource)
+        {
+            if (plane_optimal_mask)
+                *plane_optimal_mask = list->dsv_resource_tracking[i].plane_optimal_mask;
+            return dsv_plane_optimal_mask_to_layout(list->dsv_resource_tracking[i].plane_optimal_mask,
+                    resource->format->vk_aspect_mask);
+        }
+    }
+
+    if (plane_optimal_mask)
+        *plane_optimal_mask = 0;
+    return resource->common_layout;
+}
+
+static VkImageLayout vk_separate_depth_layout(VkImageLayout combined_layout)
+{
+    return (combined_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL ||
+            combined_layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_STENCIL_READ_ONLY_OPTIMAL) ?
+            VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL;
+}
+
+static VkImageLayout vk_separate_stencil_layout(VkImageLayout combined_layout)
+{
+    return (combined_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL ||
+            combined_layout == VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_STENCIL_ATTACHMENT_OPTIMAL) ?
+            VK_IMAGE_LAYOUT_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_STENCIL_READ_ONLY_OPTIMAL;
+}
+
+static void d3d12_command_list_clear_attachment_pass(struct d3d12_command_list *list, struct d3d12_resource *resource,
+        struct vkd3d_view *view, VkImageAspectFlags clear_aspects, const VkClearValue *clear_value, UINT rect_count,
+        const D3D12_RECT *rects, bool is_bound)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
+    struct vkd3d_clear_render_pass_key key;
+    VkSubpassBeginInfoKHR subpass_begin_info;
+    VkSubpassEndInfoKHR subpass_end_info;
+    VkRenderPassBeginInfo begin_info;
+    VkFramebuffer vk_framebuffer;
+    VkRenderPass vk_render_pass;
+    uint32_t plane_write_mask;
+    bool separate_ds_layouts;
+    VkExtent3D extent;
+    bool clear_op;
+
+    /* The key is memcmp'd by the render pass cache. */
+    memset(&key, 0, sizeof(key));
+    key.vk_format = view->format->vk_format;
+    key.sample_count = vk_samples_from_dxgi_sample_desc(&resource->desc.SampleDesc);
+    key.clear_aspects = clear_aspects;
+    key.format_aspects = view->format->vk_aspect_mask;
+
+    /* If we need to discard a single aspect, use separate layouts, since we have to use UNDEFINED barrier when we can. */
+    separate_ds_layouts = view->format->vk_aspect_mask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) &&
+            clear_aspects != view->format->vk_aspect_mask;
+
+    if (separate_ds_layouts)
+        key.flags |= VKD3D_CLEAR_RENDER_PASS_KEY_SEPARATE_DS_LAYOUTS;
+
+    if (clear_aspects & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+    {
+        if (is_bound)
+            key.initial_layout = list->dsv_layout;
+        else
+            key.initial_layout = d3d12_command_list_get_depth_stencil_resource_layout(list, resource, NULL);
+
+        if (separate_ds_layouts)
+        {
+            key.stencil_initial_layout = vk_separate_stencil_layout(key.initial_layout);
+            key.initial_layout = vk_separate_depth_layout(key.initial_layout);
+        }
+
+        /* We have proven a write, try to promote the image layout to something OPTIMAL. */
+        plane_write_mask = 0;
+        if (clear_aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+            plane_write_mask |= VKD3D_DEPTH_PLANE_OPTIMAL;
+        if (clear_aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+            plane_write_mask |= VKD3D_STENCIL_PLANE_OPTIMAL;
+
+        key.attachment_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        key.final_layout = dsv_plane_optimal_mask_to_layout(
                 d3d12_command_list_notify_dsv_writes(list, resource, view, plane_write_mask),
                 resource->format->vk_aspect_mask);
 
         if (separate_ds_layouts)
         {
-            stencil_attachment_desc.stencilFinalLayout = vk_separate_stencil_layout(attachment_desc.finalLayout);
-            attachment_desc.finalLayout = vk_separate_depth_layout(attachment_desc.finalLayout);
+            key.stencil_final_layout = vk_separate_stencil_layout(key.final_layout);
+            key.final_layout = vk_separate_depth_layout(key.final_layout);
         }
     }
     else
     {
-        attachment_desc.initialLayout = d3d12_resource_pick_layout(resource, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-        attachment_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        attachment_desc.finalLayout = attachment_desc.initialLayout;
+        key.initial_layout = d3d12_resource_pick_layout(resource, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        key.attachment_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        key.final_layout = key.initial_layout;
     }
 
-    attachment_ref.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2_KHR;
-    attachment_ref.pNext = NULL;
-    attachment_ref.attachment = 0;
-    attachment_ref.aspectMask = 0; /* input attachment aspect mask */
-
     if (separate_ds_layouts)
     {
-        stencil_attachment_ref.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_STENCIL_LAYOUT;
-        stencil_attachment_ref.pNext = NULL;
-        stencil_attachment_ref.stencilLayout = vk_separate_stencil_layout(attachment_ref.layout);
-        attachment_ref.layout = vk_separate_depth_layout(attachment_ref.layout);
-        attachment_ref.pNext = &stencil_attachment_ref;
+        key.stencil_attachment_layout = vk_separate_stencil_layout(key.attachment_layout);
+        key.attachment_layout = vk_separate_depth_layout(key.attachment_layout);
 
         /* Don't trigger any layout change for aspects we don't intend to touch. */
         if (!(clear_aspects & VK_IMAGE_ASPECT_DEPTH_BIT))
-            attachment_ref.layout = attachment_desc.initialLayout;
+            key.attachment_layout = key.initial_layout;
         if (!(clear_aspects & VK_IMAGE_ASPECT_STENCIL_BIT))
-            stencil_attachment_ref.stencilLayout = stencil_attachment_desc.stencilInitialLayout;
-    }
-
-    subpass_desc.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2_KHR;
-    subpass_desc.pNext = NULL;
-    subpass_desc.flags = 0;
-    subpass_desc.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass_desc.viewMask = 0;
-    subpass_desc.inputAttachmentCount = 0;
-    subpass_desc.pInputAttachments = NULL;
-    subpass_desc.colorAttachmentCount = 0;
-    subpass_desc.pColorAttachments = NULL;
-    subpass_desc.pResolveAttachments = NULL;
-    subpass_desc.pDepthStencilAttachment = NULL;
-    subpass_desc.preserveAttachmentCount = 0;
-    subpass_desc.pPreserveAttachments = NULL;
+            key.stencil_attachment_layout = key.stencil_initial_layout;
+    }
 
     if ((clear_op = !rect_count))
     {
-        if (clear_aspects & (VK_IMAGE_ASPECT_COLOR_BIT | VK_IMAGE_ASPECT_DEPTH_BIT))
-            attachment_desc.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-
-        if (clear_aspects & (VK_IMAGE_ASPECT_STENCIL_BIT))
-            attachment_desc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        key.flags |= VKD3D_CLEAR_RENDER_PASS_KEY_CLEAR_OP;
 
         /* Ignore 3D images as re-initializing those may cause us to
          * discard the entire image, not just the layers to clear. */
@@ -2567,81 +2901,19 @@ static void d3d12_command_list_clear_attachment_pass(struct d3d12_command_list *
             if (separate_ds_layouts)
             {
                 if (clear_aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
-                    attachment_desc.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                    key.initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
                 if (clear_aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
-                    stencil_attachment_desc.stencilInitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                    key.stencil_initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
             }
             else
-                attachment_desc.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                key.initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
         }
     }
 
-    if (clear_aspects & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
-    {
-        stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-        access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-        if (!clear_op || clear_aspects != view->format->vk_aspect_mask)
-            access |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
-
-        subpass_desc.pDepthStencilAttachment = &attachment_ref;
-    }
-    else
-    {
-        stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-        if (!clear_op)
-            access |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-
-        subpass_desc.colorAttachmentCount = 1;
-        subpass_desc.pColorAttachments = &attachment_ref;
-    }
-
-    dependencies[0].sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2_KHR;
-    dependencies[0].pNext = NULL;
-    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependencies[0].dstSubpass = 0;
-    dependencies[0].srcStageMask = stages;
-    dependencies[0].dstStageMask = stages;
-    dependencies[0].srcAccessMask = clear_op ? access : 0;
-    dependencies[0].dstAccessMask = access;
-    dependencies[0].dependencyFlags = 0;
-    dependencies[0].viewOffset = 0;
-
-    dependencies[1].sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2_KHR;
-    dependencies[1].pNext = NULL;
-    dependencies[1].srcSubpass = 0;
-    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
-    dependencies[1].srcStageMask = stages;
-    dependencies[1].dstStageMask = stages;
-    dependencies[1].srcAccessMask = access;
-    dependencies[1].dstAccessMask = 0;
-    dependencies[1].dependencyFlags = 0;
-    dependencies[1].viewOffset = 0;
-
-    pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2_KHR;
-    pass_info.pNext = NULL;
-    pass_info.flags = 0;
-    pass_info.attachmentCount = 1;
-    pass_info.pAttachments = &attachment_desc;
-    pass_info.subpassCount = 1;
-    pass_info.pSubpasses = &subpass_desc;
-    pass_info.dependencyCount = ARRAY_SIZE(dependencies);
-    pass_info.pDependencies = dependencies;
-    pass_info.correlatedViewMaskCount = 0;
-    pass_info.pCorrelatedViewMasks = NULL;
-
-    if ((vr = VK_CALL(vkCreateRenderPass2KHR(list->device->vk_device, &pass_info, NULL, &vk_render_pass))) < 0)
-    {
-        WARN("Failed to create Vulkan render pass, vr %d.\n", vr);
-        return;
-    }
-
-    if (!d3d12_command_allocator_add_render_pass(list->allocator, vk_render_pass))
+    if (FAILED(vkd3d_render_pass_cache_find_clear_pass(&list->device->render_pass_cache,
+            list->device, &key, &vk_render_pass)))
     {
-        WARN("Failed to add render pass.\n");
-        VK_CALL(vkDestroyRenderPass(list->device->vk_device, vk_render_pass, NULL));
+        WARN("Failed to get clear render pass.\n");
         return;
     }
 
@@ -2685,7 +2957,79 @@ static void d3d12_command_list_clear_attachment_pass(struct d3d12_command_list *
     VK_CALL(vkCmdEndRenderPass2KHR(list->vk_command_buffer, &subpass_end_info));
 }
 
-static VkPipelineStageFlags vk_queue_shader_stages(VkQueueFlags vk_queue_flags)
+static void d3d12_command_list_flush_deferred_clears(struct d3d12_command_list *list, uint32_t attachment_mask)
+{
+    struct vkd3d_clear_state *clear_state = &list->clear_state;
+    struct vkd3d_clear_attachment *attachment;
+    unsigned int i;
+
+    attachment_mask &= clear_state->attachment_mask;
+    clear_state->attachment_mask &= ~attachment_mask;
+
+    while (attachment_mask)
+    {
+        i = vkd3d_bitmask_iter32(&attachment_mask);
+        attachment = &clear_state->attachments[i];
+
+        d3d12_command_list_clear_attachment_pass(list, attachment->resource, attachment->view,
+                attachment->aspect_mask, &attachment->value, 0, NULL, false);
+    }
+}
+
+static void d3d12_command_list_clear_attachment_deferred(struct d3d12_command_list *list,
+        struct d3d12_resource *resource, struct vkd3d_view *view, unsigned int attachment_idx,
+        VkImageAspectFlags clear_aspects, const VkClearValue *clear_value)
+{
+    struct vkd3d_clear_state *clear_state = &list->clear_state;
+    struct vkd3d_clear_attachment *attachment;
+
+    attachment = &clear_state->attachments[attachment_idx];
+
+    if (!(clear_state->attachment_mask & (1u << attachment_idx)))
+    {
+        clear_state->attachment_mask |= 1u << attachment_idx;
+        attachment->aspect_mask = 0;
+    }
+
+    attachment->resource = resource;
+    attachment->view = view;
+
+    /* A later clear of only one aspect must not throw away a pending
+     * clear of the other aspect of the same depth-stencil view. */
+    if (clear_aspects & VK_IMAGE_ASPECT_COLOR_BIT)
+        attachment->value.color = clear_value->color;
+    if (clear_aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+        attachment->value.depthStencil.depth = clear_value->depthStencil.depth;
+    if (clear_aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+        attachment->value.depthStencil.stencil = clear_value->depthStencil.stencil;
+
+    attachment->aspect_mask |= clear_aspects;
+}
+
+static void d3d12_command_list_discard_attachment_deferred(struct d3d12_command_list *list,
+        unsigned int attachment_idx, VkImageAspectFlags discard_aspects)
+{
+    struct vkd3d_clear_state *clear_state = &list->clear_state;
+    struct vkd3d_clear_attachment *attachment;
+    const struct d3d12_rtv_desc *rtv;
+
+    rtv = attachment_idx == D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT ? &list->dsv : &list->rtvs[attachment_idx];
+    attachment = &clear_state->attachments[attachment_idx];
+
+    /* Views are only ever deferred for the current render targets,
+     * so a pending clear of the same attachment uses the same view. */
+    if (!(clear_state->discard_mask & (1u << attachment_idx)))
+    {
+        clear_state->discard_mask |= 1u << attachment_idx;
+        attachment->discard_aspect_mask = 0;
+    }
+
+    attachment->resource = rtv->resource;
+    attachment->view = rtv->view;
+    attachment->discard_aspect_mask |= discard_aspects;
+}
+
+static VkPipelineStageFlags vk_queue_shader_stages(struct d3d12_device *device, VkQueueFlags vk_queue_flags)
 {
     VkPipelineStageFlags queue_shader_stages = 0;
 
@@ -2696,6 +3040,11 @@ static VkPipelineStageFlags vk_queue_shader_stages(VkQueueFlags vk_queue_flags)
                 VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT |
                 VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT |
                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+        if (device->device_info.mesh_shader_features.meshShader)
+            queue_shader_stages |= VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT;
+        if (device->device_info.mesh_shader_features.taskShader)
+            queue_shader_stages |= VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT;
     }
 
     if (vk_queue_flags & VK_QUEUE_COMPUTE_BIT)
@@ -2730,7 +3079,7 @@ static void d3d12_command_list_discard_attachment_barrier(struct d3d12_command_l
     }
     else if (resource->desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS)
     {
-        stages = vk_queue_shader_stages(list->vk_queue_flags);
+        stages = vk_queue_shader_stages(list->device, list->vk_queue_flags);
         access = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
         layout = VK_IMAGE_LAYOUT_GENERAL;
     }
@@ -3229,7 +3578,8 @@ static bool d3d12_command_list_gather_pending_queries(struct d3d12_command_list
 
     /* Allocate scratch buffer and resolve virtual Vulkan queries into it */
     if (!d3d12_command_allocator_allocate_scratch_memory(list->allocator,
-            resolve_buffer_size, max(ssbo_alignment, sizeof(uint64_t)), &resolve_buffer))
+            VKD3D_SCRATCH_POOL_KIND_DEVICE_STORAGE, resolve_buffer_size,
+            max(ssbo_alignment, sizeof(uint64_t)), &resolve_buffer))
         goto cleanup;
 
     for (i = 0; i < resolve_count; i++)
@@ -3246,7 +3596,7 @@ static bool d3d12_command_list_gather_pending_queries(struct d3d12_command_list
     entry_buffer_size = sizeof(struct query_entry) * list->pending_queries_count;
 
     if (!d3d12_command_allocator_allocate_scratch_memory(list->allocator,
-            entry_buffer_size, ssbo_alignment, &entry_buffer))
+            VKD3D_SCRATCH_POOL_KIND_DEVICE_STORAGE, entry_buffer_size, ssbo_alignment, &entry_buffer))
         goto cleanup;
 
     if (!(query_map = vkd3d_malloc(sizeof(*query_map) * query_map_size)) ||
@@ -3454,6 +3804,12 @@ static void d3d12_command_list_end_current_render_pass(struct d3d12_command_list
 
         list->xfb_enabled = false;
     }
+
+    /* Any pending clear must land before whatever comes next. */
+    if (!suspend && list->clear_state.attachment_mask)
+        d3d12_command_list_flush_deferred_clears(list, list->clear_state.attachment_mask);
+    if (!suspend)
+        list->clear_state.discard_mask = 0;
 }
 
 static void d3d12_command_list_invalidate_current_render_pass(struct d3d12_command_list *list)
@@ -3574,7 +3930,7 @@ static void vk_access_and_stage_flags_from_d3d12_resource_state(const struct d3d
     VkPipelineStageFlags queue_shader_stages;
     uint32_t unhandled_state = 0;
 
-    queue_shader_stages = vk_queue_shader_stages(vk_queue_flags);
+    queue_shader_stages = vk_queue_shader_stages(device, vk_queue_flags);
 
     if (state_mask == D3D12_RESOURCE_STATE_COMMON)
     {
@@ -3797,8 +4153,10 @@ static void d3d12_command_list_track_resource_usage(struct d3d12_command_list *l
 
     /* When a command queue has confirmed that it has received a command list for submission, this flag will eventually
      * be cleared. The command queue will only perform the transition once.
-     * Until that point, we must keep submitting initial transitions like this. */
-    if (vkd3d_atomic_uint32_load_explicit(&resource->initial_layout_transition, vkd3d_memory_order_relaxed))
+     * Until that point, we must keep submitting initial transitions like this.
+     * Resources with exclusive sharing must always be tracked so the queue can transfer ownership. */
+    if (vkd3d_atomic_uint32_load_explicit(&resource->initial_layout_transition, vkd3d_memory_order_relaxed) ||
+            (resource->flags & VKD3D_RESOURCE_EXCLUSIVE_OWNERSHIP))
     {
         transition.type = VKD3D_INITIAL_TRANSITION_TYPE_RESOURCE;
         transition.resource.resource = resource;
@@ -3833,6 +4191,8 @@ HRESULT STDMETHODCALLTYPE d3d12_command_list_QueryInterface(d3d12_command_list_i
             || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList3)
             || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList4)
             || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList5)
+            || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList6)
+            || IsEqualGUID(iid, &IID_ID3D12GraphicsCommandList7)
             || IsEqualGUID(iid, &IID_ID3D12CommandList)
             || IsEqualGUID(iid, &IID_ID3D12DeviceChild)
             || IsEqualGUID(iid, &IID_ID3D12Object)
@@ -3889,6 +4249,8 @@ ULONG STDMETHODCALLTYPE d3d12_command_list_Release(d3d12_command_list_iface *ifa
         vkd3d_free(list->active_queries);
         vkd3d_free(list->pending_queries);
         vkd3d_free(list->dsv_resource_tracking);
+        vkd3d_free(list->dsv_boundary_layouts);
+        vkd3d_free(list->render_pass_state.resolve_parameters);
         vkd3d_free(list);
 
         d3d12_device_release(device);
@@ -4014,8 +4376,10 @@ static HRESULT STDMETHODCALLTYPE d3d12_command_list_Close(d3d12_command_list_ifa
     if (!d3d12_command_list_gather_pending_queries(list))
         d3d12_command_list_mark_as_invalid(list, "Failed to gather virtual queries.\n");
 
-    /* If we have kept some DSV resources in optimal layout throughout the command buffer,
-     * now is the time to decay them. */
+    /* Resources which the queue can keep in optimal layout across command lists
+     * get their decay recorded separately, the others are decayed here. */
+    if (FAILED(hr = d3d12_command_list_build_dsv_boundary_commands(list)))
+        return hr;
     d3d12_command_list_decay_optimal_dsv_resources(list);
 
     vkd3d_shader_debug_ring_end_command_buffer(list);
@@ -4201,6 +4565,27 @@ bool d3d12_command_list_reset_query(struct d3d12_command_list *list,
     return true;
 }
 
+VkAccelerationStructureKHR d3d12_command_list_place_acceleration_structure(struct d3d12_command_list *list,
+        D3D12_GPU_VIRTUAL_ADDRESS va, VkDeviceSize size)
+{
+    VkAccelerationStructureKHR vk_acceleration_structure;
+    struct vkd3d_view *view;
+
+    if (!(view = vkd3d_va_map_place_acceleration_structure(&list->device->memory_allocator.va_map,
+            list->device, va, size)))
+        return VK_NULL_HANDLE;
+
+    /* The allocator keeps the view alive after the VA map reclaims it,
+     * until the command list can no longer be in flight. */
+    if (d3d12_command_allocator_add_view(list->allocator, view))
+        vk_acceleration_structure = view->vk_acceleration_structure;
+    else
+        vk_acceleration_structure = VK_NULL_HANDLE;
+
+    vkd3d_view_decref(view, list->device);
+    return vk_acceleration_structure;
+}
+
 static void d3d12_command_list_reset_api_state(struct d3d12_command_list *list,
         ID3D12PipelineState *initial_pipeline_state)
 {
@@ -4221,6 +4606,8 @@ static void d3d12_command_list_reset_api_state(struct d3d12_command_list *list,
 
     list->predicate_enabled = false;
     list->predicate_va = 0;
+    list->predicate_vk_buffer = VK_NULL_HANDLE;
+    list->predicate_offset = 0;
 
     list->has_valid_index_buffer = false;
 
@@ -4229,6 +4616,9 @@ static void d3d12_command_list_reset_api_state(struct d3d12_command_list *list,
     list->command_buffer_pipeline = VK_NULL_HANDLE;
     list->pso_render_pass = VK_NULL_HANDLE;
     list->current_render_pass = VK_NULL_HANDLE;
+    list->clear_state.attachment_mask = 0;
+    list->clear_state.discard_mask = 0;
+    list->render_pass_state.active = false;
 
     memset(&list->dynamic_state, 0, sizeof(list->dynamic_state));
     list->dynamic_state.blend_constants[0] = D3D12_DEFAULT_BLEND_FACTOR_RED;
@@ -4256,7 +4646,7 @@ static void d3d12_command_list_reset_api_state(struct d3d12_command_list *list,
     memset(list->so_counter_buffers, 0, sizeof(list->so_counter_buffers));
     memset(list->so_counter_buffer_offsets, 0, sizeof(list->so_counter_buffer_offsets));
 
-    list->cbv_srv_uav_descriptors = NULL;
+    list->cbv_srv_uav_heap = NULL;
     list->vrs_image = NULL;
 
     ID3D12GraphicsCommandList_SetPipelineState(iface, initial_pipeline_state);
@@ -4276,6 +4666,7 @@ static void d3d12_command_list_reset_internal_state(struct d3d12_command_list *l
     list->active_queries_count = 0;
     list->pending_queries_count = 0;
     list->dsv_resource_tracking_count = 0;
+    list->dsv_boundary_layout_count = 0;
 
     list->render_pass_suspended = false;
 }
@@ -4377,7 +4768,7 @@ static bool d3d12_command_list_create_framebuffer(struct d3d12_command_list *lis
     fb_desc.height = extent.height;
     fb_desc.layers = extent.depth;
 
-    if ((vr = VK_CALL(vkCreateFramebuffer(device->vk_device, &fb_desc, NULL, vk_framebuffer))) < 0)
+    if ((vr = VK_CALL(vkCreateFramebuffer(device->vk_device, &fb_desc, &vkd3d_vk_allocator, vk_framebuffer))) < 0)
     {
         ERR("Failed to create Vulkan framebuffer, vr %d.\n", vr);
         return false;
@@ -4386,7 +4777,7 @@ static bool d3d12_command_list_create_framebuffer(struct d3d12_command_list *lis
     if (!d3d12_command_allocator_add_framebuffer(list->allocator, *vk_framebuffer))
     {
         WARN("Failed to add framebuffer.\n");
-        VK_CALL(vkDestroyFramebuffer(device->vk_device, *vk_framebuffer, NULL));
+        VK_CALL(vkDestroyFramebuffer(device->vk_device, *vk_framebuffer, &vkd3d_vk_allocator));
         return false;
     }
 
@@ -4940,8 +5331,10 @@ static void d3d12_command_list_update_hoisted_descriptors(struct d3d12_command_l
     const struct d3d12_root_signature *rs = bindings->root_signature;
     const struct vkd3d_descriptor_hoist_desc *hoist_desc;
     struct vkd3d_root_descriptor_info *root_parameter;
+    const struct vkd3d_descriptor_data *metadata;
+    const union d3d12_desc_info *desc_info;
     union vkd3d_descriptor_info *info;
-    const struct d3d12_desc *desc;
+    uint32_t desc_index;
     unsigned int i;
 
     /* We don't track dirty table index, just update every hoisted descriptor.
@@ -4950,9 +5343,14 @@ static void d3d12_command_list_update_hoisted_descriptors(struct d3d12_command_l
     {
         hoist_desc = &rs->hoist_info.desc[i];
 
-        desc = list->cbv_srv_uav_descriptors;
-        if (desc)
-            desc += bindings->descriptor_tables[hoist_desc->table_index] + hoist_desc->table_offset;
+        metadata = NULL;
+        desc_info = NULL;
+        if (list->cbv_srv_uav_heap)
+        {
+            desc_index = bindings->descriptor_tables[hoist_desc->table_index] + hoist_desc->table_offset;
+            metadata = &list->cbv_srv_uav_heap->descriptor_metadata[desc_index];
+            desc_info = &list->cbv_srv_uav_heap->descriptor_info[desc_index];
+        }
 
         root_parameter = &bindings->root_descriptors[hoist_desc->parameter_index];
 
@@ -4961,10 +5359,10 @@ static void d3d12_command_list_update_hoisted_descriptors(struct d3d12_command_l
         root_parameter->vk_descriptor_type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         info = &root_parameter->info;
 
-        if (desc && (desc->metadata.flags & VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE))
+        if (metadata && (metadata->flags & VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE))
         {
             /* Buffer descriptors must be valid on recording time. */
-            info->buffer = desc->info.buffer;
+            info->buffer = desc_info->buffer;
         }
         else
         {
@@ -5279,58 +5677,236 @@ static void d3d12_command_list_promote_dsv_layout(struct d3d12_command_list *lis
     }
 }
 
-static bool d3d12_command_list_begin_render_pass(struct d3d12_command_list *list)
+static bool d3d12_command_list_rtv_covers_framebuffer(struct d3d12_command_list *list,
+        const struct d3d12_rtv_desc *rtv)
+{
+    /* LOAD_OP_CLEAR only applies to the render area and the framebuffer layers. */
+    return rtv->width == list->fb_width && rtv->height == list->fb_height &&
+            rtv->layer_count == list->fb_layer_count;
+}
+
+static VkRenderPass d3d12_command_list_fold_deferred_clears(struct d3d12_command_list *list,
+        VkClearValue *clear_values, uint32_t *clear_value_count)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
+    uint32_t rtv_mask, rtv_clear_mask, rtv_discard_mask, ds_load_flags;
+    struct vkd3d_clear_state *clear_state = &list->clear_state;
     struct d3d12_graphics_pipeline_state *graphics;
-    VkSubpassBeginInfoKHR subpass_begin_info;
-    VkRenderPassBeginInfo begin_desc;
+    const struct vkd3d_clear_attachment *attachment;
+    VkImageAspectFlags aspects, writable_aspects;
+    VkPipelineStageFlags stages;
     VkRenderPass vk_render_pass;
+    VkMemoryBarrier vk_barrier;
+    VkAccessFlags access;
+    unsigned int i, idx;
 
-    d3d12_command_list_promote_dsv_layout(list);
-    if (!d3d12_command_list_update_graphics_pipeline(list))
-        return false;
-    if (!d3d12_command_list_update_current_framebuffer(list))
-        return false;
+    graphics = &list->state->graphics;
+    rtv_mask = graphics->rtv_active_mask & list->rtv_nonnull_mask;
+    rtv_clear_mask = 0;
+    rtv_discard_mask = 0;
+    ds_load_flags = 0;
 
-    if (list->dynamic_state.dirty_flags)
-        d3d12_command_list_update_dynamic_state(list);
+    for (i = 0; i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT; i++)
+    {
+        attachment = &clear_state->attachments[i];
 
-    d3d12_command_list_update_descriptors(list, VK_PIPELINE_BIND_POINT_GRAPHICS);
+        if (!((clear_state->attachment_mask | clear_state->discard_mask) & (1u << i)) ||
+                !(rtv_mask & (1u << i)) || list->rtvs[i].view != attachment->view ||
+                !d3d12_command_list_rtv_covers_framebuffer(list, &list->rtvs[i]))
+            continue;
 
-    if (list->current_render_pass != VK_NULL_HANDLE)
-    {
-        d3d12_command_list_handle_active_queries(list, false);
-        return true;
+        if (clear_state->attachment_mask & (1u << i))
+            rtv_clear_mask |= 1u << i;
+        else
+            rtv_discard_mask |= 1u << i;
     }
 
-    vk_render_pass = list->pso_render_pass;
-    assert(vk_render_pass);
+    attachment = &clear_state->attachments[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT];
 
-    if (!list->render_pass_suspended)
-        d3d12_command_list_emit_render_pass_transition(list, VKD3D_RENDER_PASS_TRANSITION_MODE_BEGIN);
+    if (((clear_state->attachment_mask | clear_state->discard_mask) & (1u << D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT)) &&
+            d3d12_command_list_has_depth_stencil_view(list) &&
+            list->dsv.view == attachment->view &&
+            d3d12_command_list_rtv_covers_framebuffer(list, &list->dsv))
+    {
+        /* Aspects which are read-only in this render pass must be cleared separately. */
+        writable_aspects = vk_writable_aspects_from_image_layout(list->dsv_layout);
 
-    begin_desc.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    begin_desc.pNext = NULL;
-    begin_desc.renderPass = vk_render_pass;
-    begin_desc.framebuffer = list->current_framebuffer;
-    begin_desc.renderArea.offset.x = 0;
-    begin_desc.renderArea.offset.y = 0;
-    d3d12_command_list_get_fb_extent(list,
-            &begin_desc.renderArea.extent.width, &begin_desc.renderArea.extent.height, NULL);
-    begin_desc.clearValueCount = 0;
-    begin_desc.pClearValues = NULL;
+        if (clear_state->attachment_mask & (1u << D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT))
+        {
+            aspects = writable_aspects & attachment->aspect_mask;
 
-    subpass_begin_info.sType = VK_STRUCTURE_TYPE_SUBPASS_BEGIN_INFO_KHR;
-    subpass_begin_info.pNext = NULL;
-    subpass_begin_info.contents = VK_SUBPASS_CONTENTS_INLINE;
+            if (aspects == attachment->aspect_mask)
+            {
+                if (aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+                    ds_load_flags |= VKD3D_RENDER_PASS_KEY_DEPTH_CLEAR;
+                if (aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+                    ds_load_flags |= VKD3D_RENDER_PASS_KEY_STENCIL_CLEAR;
+            }
+        }
 
-    VK_CALL(vkCmdBeginRenderPass2KHR(list->vk_command_buffer, &begin_desc, &subpass_begin_info));
+        if (clear_state->discard_mask & (1u << D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT))
+        {
+            aspects = writable_aspects & attachment->discard_aspect_mask;
 
-    list->current_render_pass = vk_render_pass;
+            if (aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+                ds_load_flags |= VKD3D_RENDER_PASS_KEY_DEPTH_DISCARD;
+            if (aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+                ds_load_flags |= VKD3D_RENDER_PASS_KEY_STENCIL_DISCARD;
+        }
+    }
 
-    graphics = &list->state->graphics;
-    if (graphics->xfb_enabled)
+    /* Discards only ever apply to the first render pass after BeginRenderPass(). */
+    clear_state->discard_mask = 0;
+
+    if (FAILED(vkd3d_render_pass_cache_find_clear_variant(&list->device->render_pass_cache, list->device,
+            list->pso_render_pass, &rtv_clear_mask, &rtv_discard_mask, &ds_load_flags, &vk_render_pass)))
+    {
+        WARN("Failed to look up render pass with clears, falling back to separate clears.\n");
+        vk_render_pass = list->pso_render_pass;
+        rtv_clear_mask = 0;
+        rtv_discard_mask = 0;
+        ds_load_flags = 0;
+    }
+
+    /* Whatever cannot be folded into the render pass is cleared right away. */
+    d3d12_command_list_flush_deferred_clears(list, ~(rtv_clear_mask |
+            ((ds_load_flags & VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_CLEAR) ?
+            (1u << D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT) : 0)));
+
+    if (!rtv_clear_mask && !rtv_discard_mask && !ds_load_flags)
+        return vk_render_pass;
+
+    /* Attachments are packed in the framebuffer, see d3d12_command_list_update_current_framebuffer. */
+    stages = 0;
+    access = 0;
+    idx = 0;
+
+    while (rtv_mask)
+    {
+        i = vkd3d_bitmask_iter32(&rtv_mask);
+
+        if (rtv_clear_mask & (1u << i))
+        {
+            clear_values[idx] = clear_state->attachments[i].value;
+            *clear_value_count = idx + 1;
+        }
+
+        if ((rtv_clear_mask | rtv_discard_mask) & (1u << i))
+        {
+            stages |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            access |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        }
+
+        idx++;
+    }
+
+    if (ds_load_flags & VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_CLEAR)
+    {
+        clear_values[idx] = clear_state->attachments[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT].value;
+        *clear_value_count = idx + 1;
+    }
+
+    if (ds_load_flags)
+    {
+        stages |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        access |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    }
+
+    clear_state->attachment_mask = 0;
+
+    /* The regular render pass dependencies must stay identical in order to keep the pass
+     * compatible with the pipeline, so order the clear against prior attachment writes here. */
+    vk_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    vk_barrier.pNext = NULL;
+    vk_barrier.srcAccessMask = access;
+    vk_barrier.dstAccessMask = access;
+
+    VK_CALL(vkCmdPipelineBarrier(list->vk_command_buffer,
+            stages, stages, 0, 1, &vk_barrier, 0, NULL, 0, NULL));
+
+    return vk_render_pass;
+}
+
+static void d3d12_command_list_check_deferred_dsv_clear(struct d3d12_command_list *list)
+{
+    const struct vkd3d_clear_attachment *attachment;
+    VkImageLayout layout;
+
+    /* Clearing a DSV proves a write and promotes its layout, which in turn decides
+     * the render pass we pick. If the image is not yet in a layout where the cleared
+     * aspects are writable, perform the clear now so that the render pass observes
+     * the promoted layout. Otherwise the clear can be folded into the render pass. */
+    attachment = &list->clear_state.attachments[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT];
+    layout = d3d12_command_list_get_depth_stencil_resource_layout(list, attachment->resource, NULL);
+
+    if ((vk_writable_aspects_from_image_layout(layout) & attachment->aspect_mask) != attachment->aspect_mask)
+        d3d12_command_list_flush_deferred_clears(list, 1u << D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT);
+}
+
+static bool d3d12_command_list_begin_render_pass(struct d3d12_command_list *list)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
+    VkClearValue clear_values[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT + 2];
+    struct d3d12_graphics_pipeline_state *graphics;
+    VkSubpassBeginInfoKHR subpass_begin_info;
+    VkRenderPassBeginInfo begin_desc;
+    uint32_t clear_value_count;
+    VkRenderPass vk_render_pass;
+
+    if (list->dsv.view && list->dsv.resource)
+        d3d12_command_list_track_dsv_boundary_layout_for_view(list, list->dsv.resource, list->dsv.view);
+
+    if (list->clear_state.attachment_mask & (1u << D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT))
+        d3d12_command_list_check_deferred_dsv_clear(list);
+
+    d3d12_command_list_promote_dsv_layout(list);
+    if (!d3d12_command_list_update_graphics_pipeline(list))
+        return false;
+    if (!d3d12_command_list_update_current_framebuffer(list))
+        return false;
+
+    if (list->dynamic_state.dirty_flags)
+        d3d12_command_list_update_dynamic_state(list);
+
+    d3d12_command_list_update_descriptors(list, VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+    if (list->current_render_pass != VK_NULL_HANDLE)
+    {
+        d3d12_command_list_handle_active_queries(list, false);
+        return true;
+    }
+
+    vk_render_pass = list->pso_render_pass;
+    assert(vk_render_pass);
+
+    clear_value_count = 0;
+    if (list->clear_state.attachment_mask || list->clear_state.discard_mask)
+        vk_render_pass = d3d12_command_list_fold_deferred_clears(list, clear_values, &clear_value_count);
+
+    if (!list->render_pass_suspended)
+        d3d12_command_list_emit_render_pass_transition(list, VKD3D_RENDER_PASS_TRANSITION_MODE_BEGIN);
+
+    begin_desc.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    begin_desc.pNext = NULL;
+    begin_desc.renderPass = vk_render_pass;
+    begin_desc.framebuffer = list->current_framebuffer;
+    begin_desc.renderArea.offset.x = 0;
+    begin_desc.renderArea.offset.y = 0;
+    d3d12_command_list_get_fb_extent(list,
+            &begin_desc.renderArea.extent.width, &begin_desc.renderArea.extent.height, NULL);
+    begin_desc.clearValueCount = clear_value_count;
+    begin_desc.pClearValues = clear_value_count ? clear_values : NULL;
+
+    subpass_begin_info.sType = VK_STRUCTURE_TYPE_SUBPASS_BEGIN_INFO_KHR;
+    subpass_begin_info.pNext = NULL;
+    subpass_begin_info.contents = VK_SUBPASS_CONTENTS_INLINE;
+
+    VK_CALL(vkCmdBeginRenderPass2KHR(list->vk_command_buffer, &begin_desc, &subpass_begin_info));
+
+    list->current_render_pass = vk_render_pass;
+
+    graphics = &list->state->graphics;
+    if (graphics->xfb_enabled)
     {
         VK_CALL(vkCmdBeginTransformFeedbackEXT(list->vk_command_buffer, 0, ARRAY_SIZE(list->so_counter_buffers),
                 list->so_counter_buffers, list->so_counter_buffer_offsets));
@@ -5384,7 +5960,7 @@ static bool d3d12_command_list_emit_predicated_command(struct d3d12_command_list
     vkd3d_meta_get_predicate_pipeline(&list->device->meta_ops, command_type, &pipeline_info);
 
     if (!d3d12_command_allocator_allocate_scratch_memory(list->allocator,
-            pipeline_info.data_size, sizeof(uint32_t), scratch))
+            VKD3D_SCRATCH_POOL_KIND_DEVICE_STORAGE, pipeline_info.data_size, sizeof(uint32_t), scratch))
         return false;
 
     d3d12_command_list_end_current_render_pass(list, true);
@@ -5416,6 +5992,47 @@ static bool d3d12_command_list_emit_predicated_command(struct d3d12_command_list
     return true;
 }
 
+static bool d3d12_command_list_emit_predicated_draw(struct d3d12_command_list *list,
+        enum vkd3d_predicate_command_type command_type,
+        const union vkd3d_predicate_command_direct_args *direct_args,
+        struct vkd3d_scratch_allocation *scratch, bool *use_draw_count)
+{
+    size_t args_size;
+
+    /* The resolved predicate is either 0 or 1, so it can be consumed directly as the
+     * draw count of an indirect count draw. The draw arguments are known on the host,
+     * so we do not need a compute dispatch, a barrier or a render pass split here. */
+    if (list->device->vk_info.KHR_draw_indirect_count)
+    {
+        switch (command_type)
+        {
+            case VKD3D_PREDICATE_COMMAND_DRAW:
+                args_size = sizeof(direct_args->draw);
+                break;
+            case VKD3D_PREDICATE_COMMAND_DRAW_INDEXED:
+                args_size = sizeof(direct_args->draw_indexed);
+                break;
+            case VKD3D_PREDICATE_COMMAND_DRAW_MESH_TASKS:
+                args_size = sizeof(direct_args->draw_mesh_tasks);
+                break;
+            default:
+                ERR("Unhandled predicated draw type %u.\n", command_type);
+                return false;
+        }
+
+        if (!d3d12_command_allocator_allocate_scratch_memory(list->allocator,
+                VKD3D_SCRATCH_POOL_KIND_UPLOAD, args_size, sizeof(uint32_t), scratch))
+            return false;
+
+        memcpy(scratch->host_ptr, direct_args, args_size);
+        *use_draw_count = true;
+        return true;
+    }
+
+    *use_draw_count = false;
+    return d3d12_command_list_emit_predicated_command(list, command_type, 0, direct_args, scratch);
+}
+
 static void STDMETHODCALLTYPE d3d12_command_list_DrawInstanced(d3d12_command_list_iface *iface,
         UINT vertex_count_per_instance, UINT instance_count, UINT start_vertex_location,
         UINT start_instance_location)
@@ -5423,6 +6040,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_DrawInstanced(d3d12_command_lis
     struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
     const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
     struct vkd3d_scratch_allocation scratch;
+    bool use_draw_count = false;
 
     TRACE("iface %p, vertex_count_per_instance %u, instance_count %u, "
             "start_vertex_location %u, start_instance_location %u.\n",
@@ -5437,7 +6055,8 @@ static void STDMETHODCALLTYPE d3d12_command_list_DrawInstanced(d3d12_command_lis
         args.draw.firstVertex = start_vertex_location;
         args.draw.firstInstance = start_instance_location;
 
-        if (!d3d12_command_list_emit_predicated_command(list, VKD3D_PREDICATE_COMMAND_DRAW, 0, &args, &scratch))
+        if (!d3d12_command_list_emit_predicated_draw(list, VKD3D_PREDICATE_COMMAND_DRAW,
+                &args, &scratch, &use_draw_count))
             return;
     }
 
@@ -5450,6 +6069,9 @@ static void STDMETHODCALLTYPE d3d12_command_list_DrawInstanced(d3d12_command_lis
     if (!list->predicate_va)
         VK_CALL(vkCmdDraw(list->vk_command_buffer, vertex_count_per_instance,
                 instance_count, start_vertex_location, start_instance_location));
+    else if (use_draw_count)
+        VK_CALL(vkCmdDrawIndirectCountKHR(list->vk_command_buffer, scratch.buffer, scratch.offset,
+                list->predicate_vk_buffer, list->predicate_offset, 1, sizeof(VkDrawIndirectCommand)));
     else
         VK_CALL(vkCmdDrawIndirect(list->vk_command_buffer, scratch.buffer, scratch.offset, 1, 0));
 }
@@ -5461,6 +6083,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_DrawIndexedInstanced(d3d12_comm
     struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
     const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
     struct vkd3d_scratch_allocation scratch;
+    bool use_draw_count = false;
 
     TRACE("iface %p, index_count_per_instance %u, instance_count %u, start_vertex_location %u, "
             "base_vertex_location %d, start_instance_location %u.\n",
@@ -5489,7 +6112,8 @@ static void STDMETHODCALLTYPE d3d12_command_list_DrawIndexedInstanced(d3d12_comm
         args.draw_indexed.vertexOffset = base_vertex_location;
         args.draw_indexed.firstInstance = start_instance_location;
 
-        if (!d3d12_command_list_emit_predicated_command(list, VKD3D_PREDICATE_COMMAND_DRAW_INDEXED, 0, &args, &scratch))
+        if (!d3d12_command_list_emit_predicated_draw(list, VKD3D_PREDICATE_COMMAND_DRAW_INDEXED,
+                &args, &scratch, &use_draw_count))
             return;
     }
 
@@ -5504,6 +6128,9 @@ static void STDMETHODCALLTYPE d3d12_command_list_DrawIndexedInstanced(d3d12_comm
     if (!list->predicate_va)
         VK_CALL(vkCmdDrawIndexed(list->vk_command_buffer, index_count_per_instance,
                 instance_count, start_vertex_location, base_vertex_location, start_instance_location));
+    else if (use_draw_count)
+        VK_CALL(vkCmdDrawIndexedIndirectCountKHR(list->vk_command_buffer, scratch.buffer, scratch.offset,
+                list->predicate_vk_buffer, list->predicate_offset, 1, sizeof(VkDrawIndexedIndirectCommand)));
     else
         VK_CALL(vkCmdDrawIndexedIndirect(list->vk_command_buffer, scratch.buffer, scratch.offset, 1, 0));
 }
@@ -6298,7 +6925,11 @@ static void STDMETHODCALLTYPE d3d12_command_list_CopyTiles(d3d12_command_list_if
         for (i = 0; i < region_size->NumTiles; i++)
         {
             unsigned int tile_index = vkd3d_get_tile_index_from_region(&tiled_res->sparse, region_coord, region_size, i);
-            const struct d3d12_sparse_image_region *region = &tiled_res->sparse.tiles[tile_index].image;
+            const struct d3d12_sparse_image_region *region;
+            struct d3d12_sparse_tile tile;
+
+            d3d12_resource_get_sparse_tile(tiled_res, tile_index, &tile);
+            region = &tile.image;
 
             buffer_image_copy.bufferOffset = buffer_offset + VKD3D_TILE_SIZE * i;
             buffer_image_copy.imageSubresource = vk_subresource_layers_from_subresource(&region->subresource);
@@ -6836,19 +7467,21 @@ static bool vk_subresource_range_overlaps(uint32_t base_a, uint32_t count_a, uin
         return end_b > base_a;
 }
 
-static bool vk_image_barrier_overlaps_subresource(const VkImageMemoryBarrier *a, const VkImageMemoryBarrier *b)
+static bool vk_image_subresource_range_overlaps(VkImage image_a, const VkImageSubresourceRange *a,
+        VkImage image_b, const VkImageSubresourceRange *b)
 {
-    if (a->image != b->image)
+    if (image_a != image_b)
         return false;
-    if (!(a->subresourceRange.aspectMask & b->subresourceRange.aspectMask))
+    if (!(a->aspectMask & b->aspectMask))
         return false;
 
-    return vk_subresource_range_overlaps(
-            a->subresourceRange.baseMipLevel, a->subresourceRange.levelCount,
-            b->subresourceRange.baseMipLevel, b->subresourceRange.levelCount) &&
-            vk_subresource_range_overlaps(
-                    a->subresourceRange.baseArrayLayer, a->subresourceRange.layerCount,
-                    b->subresourceRange.baseArrayLayer, b->subresourceRange.layerCount);
+    return vk_subresource_range_overlaps(a->baseMipLevel, a->levelCount, b->baseMipLevel, b->levelCount) &&
+            vk_subresource_range_overlaps(a->baseArrayLayer, a->layerCount, b->baseArrayLayer, b->layerCount);
+}
+
+static bool vk_image_barrier_overlaps_subresource(const VkImageMemoryBarrier *a, const VkImageMemoryBarrier *b)
+{
+    return vk_image_subresource_range_overlaps(a->image, &a->subresourceRange, b->image, &b->subresourceRange);
 }
 
 static void d3d12_command_list_barrier_batch_add_layout_transition(
@@ -6933,6 +7566,15 @@ static void STDMETHODCALLTYPE d3d12_command_list_ResourceBarrier(d3d12_command_l
                     continue;
                 }
 
+                if (preserve_resource->desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
+                {
+                    d3d12_command_list_track_dsv_boundary_layout(list, preserve_resource,
+                            transition->Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES &&
+                            (transition->StateBefore == D3D12_RESOURCE_STATE_DEPTH_READ ||
+                            transition->StateBefore == D3D12_RESOURCE_STATE_DEPTH_WRITE) ?
+                            VKD3D_DEPTH_PLANE_OPTIMAL | VKD3D_STENCIL_PLANE_OPTIMAL : 0);
+                }
+
                 vk_access_and_stage_flags_from_d3d12_resource_state(list, preserve_resource,
                         transition->StateBefore, list->vk_queue_flags, &transition_src_stage_mask,
                         &transition_src_access);
@@ -7152,7 +7794,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_SetDescriptorHeaps(d3d12_comman
 
         /* In case we need to hoist buffer descriptors. */
         if (heap->desc.Type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)
-            list->cbv_srv_uav_descriptors = (const struct d3d12_desc *) heap->descriptors;
+            list->cbv_srv_uav_heap = heap;
     }
 
     for (i = 0; i < ARRAY_SIZE(list->pipeline_bindings); i++)
@@ -7379,7 +8021,7 @@ static void d3d12_command_list_set_push_descriptor_info(struct d3d12_command_lis
             if (!(d3d12_command_allocator_add_buffer_view(list->allocator, vk_buffer_view)))
             {
                 ERR("Failed to add buffer view.\n");
-                VK_CALL(vkDestroyBufferView(list->device->vk_device, vk_buffer_view, NULL));
+                VK_CALL(vkDestroyBufferView(list->device->vk_device, vk_buffer_view, &vkd3d_vk_allocator));
                 return;
             }
 
@@ -7781,7 +8423,16 @@ static void d3d12_command_list_clear_attachment(struct d3d12_command_list *list,
     if (attachment_idx == D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT && list->current_render_pass)
         writable = (vk_writable_aspects_from_image_layout(list->dsv_layout) & clear_aspects) == clear_aspects;
 
-    if (attachment_idx < 0 || !list->current_render_pass || !writable)
+    if (full_clear && attachment_idx >= 0 && !list->current_render_pass)
+    {
+        /* View bound but no render pass active. Defer the clear so that it
+         * can become the load op of the next render pass using the view. */
+        if (list->render_pass_suspended)
+            d3d12_command_list_end_current_render_pass(list, false);
+        d3d12_command_list_clear_attachment_deferred(list, resource, view,
+                attachment_idx, clear_aspects, clear_value);
+    }
+    else if (attachment_idx < 0 || !list->current_render_pass || !writable)
     {
         /* View currently not bound as a render target, or bound but
          * the render pass isn't active and we're only going to clear
@@ -7813,6 +8464,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_ClearDepthStencilView(d3d12_com
             iface, dsv.ptr, flags, depth, stencil, rect_count, rects);
 
     d3d12_command_list_track_resource_usage(list, dsv_desc->resource, true);
+    d3d12_command_list_track_dsv_boundary_layout_for_view(list, dsv_desc->resource, dsv_desc->view);
 
     if (flags & D3D12_CLEAR_FLAG_DEPTH)
         clear_aspects |= VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -8064,17 +8716,17 @@ static const struct vkd3d_format *vkd3d_fixup_clear_uav_uint_color(struct d3d12_
 
 static bool vkd3d_clear_uav_info_from_desc(struct vkd3d_clear_uav_info *args, const struct d3d12_desc *desc)
 {
-    if (desc->metadata.flags & VKD3D_DESCRIPTOR_FLAG_VIEW)
+    if (desc->metadata->flags & VKD3D_DESCRIPTOR_FLAG_VIEW)
     {
         args->has_view = true;
-        args->u.view = desc->info.view;
+        args->u.view = desc->info->view;
         return true;
     }
-    else if (desc->metadata.flags & VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE)
+    else if (desc->metadata->flags & VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE)
     {
         args->has_view = false;
-        args->u.buffer.offset = desc->info.buffer.offset;
-        args->u.buffer.range = desc->info.buffer.range;
+        args->u.buffer.offset = desc->info->buffer.offset;
+        args->u.buffer.range = desc->info->buffer.range;
         return true;
     }
     else
@@ -8121,7 +8773,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_ClearUnorderedAccessViewUint(d3
         const UINT values[4], UINT rect_count, const D3D12_RECT *rects)
 {
     struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
-    const struct d3d12_desc *desc = d3d12_desc_from_cpu_handle(cpu_handle);
+    struct d3d12_desc desc = d3d12_desc_from_cpu_handle(cpu_handle);
     const struct vkd3d_format *uint_format;
     struct vkd3d_view *inline_view = NULL;
     struct d3d12_resource *resource_impl;
@@ -8135,12 +8787,12 @@ static void STDMETHODCALLTYPE d3d12_command_list_ClearUnorderedAccessViewUint(d3
 
     resource_impl = impl_from_ID3D12Resource(resource);
 
-    if (!vkd3d_clear_uav_info_from_desc(&args, desc))
+    if (!vkd3d_clear_uav_info_from_desc(&args, &desc))
         return;
 
-    if (args.has_view && desc->info.view->format->type != VKD3D_FORMAT_TYPE_UINT)
+    if (args.has_view && desc.info->view->format->type != VKD3D_FORMAT_TYPE_UINT)
     {
-        const struct vkd3d_view *base_view = desc->info.view;
+        const struct vkd3d_view *base_view = desc.info->view;
         uint_format = vkd3d_find_uint_format(list->device, base_view->format->dxgi_format);
 
         if (!uint_format && !(uint_format = vkd3d_fixup_clear_uav_uint_color(
@@ -8194,10 +8846,10 @@ static void STDMETHODCALLTYPE d3d12_command_list_ClearUnorderedAccessViewUint(d3
     }
     else if (args.has_view)
     {
-        vkd3d_mask_uint_clear_color(color.uint32, desc->info.view->format->vk_format);
+        vkd3d_mask_uint_clear_color(color.uint32, desc.info->view->format->vk_format);
     }
 
-    d3d12_command_list_clear_uav(list, desc, resource_impl, &args, &color, rect_count, rects);
+    d3d12_command_list_clear_uav(list, &desc, resource_impl, &args, &color, rect_count, rects);
 
     if (inline_view)
     {
@@ -8211,7 +8863,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_ClearUnorderedAccessViewFloat(d
         const float values[4], UINT rect_count, const D3D12_RECT *rects)
 {
     struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
-    const struct d3d12_desc *desc = d3d12_desc_from_cpu_handle(cpu_handle);
+    struct d3d12_desc desc = d3d12_desc_from_cpu_handle(cpu_handle);
     struct d3d12_resource *resource_impl;
     struct vkd3d_clear_uav_info args;
     VkClearColorValue color;
@@ -8223,9 +8875,9 @@ static void STDMETHODCALLTYPE d3d12_command_list_ClearUnorderedAccessViewFloat(d
 
     resource_impl = impl_from_ID3D12Resource(resource);
 
-    if (!vkd3d_clear_uav_info_from_desc(&args, desc))
+    if (!vkd3d_clear_uav_info_from_desc(&args, &desc))
         return;
-    d3d12_command_list_clear_uav(list, desc, resource_impl, &args, &color, rect_count, rects);
+    d3d12_command_list_clear_uav(list, &desc, resource_impl, &args, &color, rect_count, rects);
 }
 
 static void STDMETHODCALLTYPE d3d12_command_list_DiscardResource(d3d12_command_list_iface *iface,
@@ -8637,7 +9289,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_SetPredication(d3d12_command_li
     if (resource)
     {
         if (!d3d12_command_allocator_allocate_scratch_memory(list->allocator,
-                sizeof(uint32_t), sizeof(uint32_t), &scratch))
+                VKD3D_SCRATCH_POOL_KIND_DEVICE_STORAGE, sizeof(uint32_t), sizeof(uint32_t), &scratch))
             return;
 
         begin_info.sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
@@ -8693,9 +9345,12 @@ static void STDMETHODCALLTYPE d3d12_command_list_SetPredication(d3d12_command_li
         }
         else
         {
-            dst_stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            dst_access = VK_ACCESS_SHADER_READ_BIT;
+            /* Direct draws consume the resolved predicate as an indirect draw count. */
+            dst_stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+            dst_access = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
             list->predicate_va = scratch.va;
+            list->predicate_vk_buffer = scratch.buffer;
+            list->predicate_offset = scratch.offset;
         }
 
         vk_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
@@ -8713,6 +9368,8 @@ static void STDMETHODCALLTYPE d3d12_command_list_SetPredication(d3d12_command_li
     {
         list->predicate_enabled = false;
         list->predicate_va = 0;
+        list->predicate_vk_buffer = VK_NULL_HANDLE;
+        list->predicate_offset = 0;
     }
 }
 
@@ -8829,6 +9486,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_EndEvent(d3d12_command_list_ifa
 STATIC_ASSERT(sizeof(VkDispatchIndirectCommand) == sizeof(D3D12_DISPATCH_ARGUMENTS));
 STATIC_ASSERT(sizeof(VkDrawIndexedIndirectCommand) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS));
 STATIC_ASSERT(sizeof(VkDrawIndirectCommand) == sizeof(D3D12_DRAW_ARGUMENTS));
+STATIC_ASSERT(sizeof(VkDrawMeshTasksIndirectCommandEXT) == sizeof(D3D12_DISPATCH_MESH_ARGUMENTS));
 
 static void STDMETHODCALLTYPE d3d12_command_list_ExecuteIndirect(d3d12_command_list_iface *iface,
         ID3D12CommandSignature *command_signature, UINT max_command_count, ID3D12Resource *arg_buffer,
@@ -8868,6 +9526,7 @@ static void STDMETHODCALLTYPE d3d12_command_list_ExecuteIndirect(d3d12_command_l
             {
                 case D3D12_INDIRECT_ARGUMENT_TYPE_DRAW:
                 case D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED:
+                case D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH:
                     if (count_buffer)
                     {
                         type = VKD3D_PREDICATE_COMMAND_DRAW_INDIRECT_COUNT;
@@ -8971,6 +9630,32 @@ static void STDMETHODCALLTYPE d3d12_command_list_ExecuteIndirect(d3d12_command_l
                 VK_CALL(vkCmdDispatchIndirect(list->vk_command_buffer, scratch.buffer, scratch.offset));
                 break;
 
+            case D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH:
+                if (!d3d12_pipeline_state_is_graphics(list->state) || !list->state->graphics.is_mesh_pipeline)
+                {
+                    WARN("Pipeline state %p is not a mesh shader pipeline, ignoring mesh dispatch.\n", list->state);
+                    break;
+                }
+
+                if (!d3d12_command_list_begin_render_pass(list))
+                {
+                    WARN("Failed to begin render pass, ignoring mesh dispatch.\n");
+                    break;
+                }
+
+                if (count_buffer || list->predicate_va)
+                {
+                    VK_CALL(vkCmdDrawMeshTasksIndirectCountEXT(list->vk_command_buffer, arg_impl->res.vk_buffer,
+                            arg_buffer_offset + arg_impl->mem.offset, scratch.buffer, scratch.offset,
+                            max_command_count, signature_desc->ByteStride));
+                }
+                else
+                {
+                    VK_CALL(vkCmdDrawMeshTasksIndirectEXT(list->vk_command_buffer, arg_impl->res.vk_buffer,
+                            arg_buffer_offset + arg_impl->mem.offset, max_command_count, signature_desc->ByteStride));
+                }
+                break;
+
             default:
                 FIXME("Ignoring unhandled argument type %#x.\n", arg_desc->Type);
                 break;
@@ -9212,129 +9897,401 @@ static void STDMETHODCALLTYPE d3d12_command_list_SetProtectedResourceSession(d3d
     FIXME("iface %p, protected_session %p stub!\n", iface, protected_session);
 }
 
-static void STDMETHODCALLTYPE d3d12_command_list_BeginRenderPass(d3d12_command_list_iface *iface,
-        UINT rt_count, const D3D12_RENDER_PASS_RENDER_TARGET_DESC *render_targets,
-        const D3D12_RENDER_PASS_DEPTH_STENCIL_DESC *depth_stencil, D3D12_RENDER_PASS_FLAGS flags)
+static HRESULT d3d12_render_pass_state_copy_ending_access(struct d3d12_render_pass_state *state,
+        D3D12_RENDER_PASS_ENDING_ACCESS *dst, const D3D12_RENDER_PASS_ENDING_ACCESS *src, size_t *resolve_count)
 {
-    FIXME("iface %p, rt_count %u, render_targets %p, depth_stencil %p, flags %#x stub!\n",
-            iface, rt_count, render_targets, depth_stencil, flags);
-}
+    D3D12_RENDER_PASS_ENDING_ACCESS_RESOLVE_SUBRESOURCE_PARAMETERS *parameters;
 
-static void STDMETHODCALLTYPE d3d12_command_list_EndRenderPass(d3d12_command_list_iface *iface)
-{
-    FIXME("iface %p stub!\n", iface);
-}
+    *dst = *src;
 
-static void STDMETHODCALLTYPE d3d12_command_list_InitializeMetaCommand(d3d12_command_list_iface *iface,
-        ID3D12MetaCommand *meta_command, const void *parameter_data, SIZE_T parameter_size)
-{
-    FIXME("iface %p, meta_command %p, parameter_data %p, parameter_size %lu stub!\n",
-            iface, meta_command, parameter_data, parameter_size);
+    if (src->Type != D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_RESOLVE || !src->Resolve.SubresourceCount)
+        return S_OK;
+
+    /* The application does not need to keep the parameters alive until EndRenderPass(). */
+    if (!vkd3d_array_reserve((void **)&state->resolve_parameters, &state->resolve_parameters_size,
+            *resolve_count + src->Resolve.SubresourceCount, sizeof(*state->resolve_parameters)))
+        return E_OUTOFMEMORY;
+
+    parameters = &state->resolve_parameters[*resolve_count];
+    memcpy(parameters, src->Resolve.pSubresourceParameters,
+            src->Resolve.SubresourceCount * sizeof(*parameters));
+    /* Store the offset for now, the array may still be reallocated. */
+    dst->Resolve.pSubresourceParameters = (void *)(uintptr_t)*resolve_count;
+    *resolve_count += src->Resolve.SubresourceCount;
+    return S_OK;
 }
 
-static void STDMETHODCALLTYPE d3d12_command_list_ExecuteMetaCommand(d3d12_command_list_iface *iface,
-        ID3D12MetaCommand *meta_command, const void *parameter_data, SIZE_T parameter_size)
+static void d3d12_render_pass_state_fixup_ending_access(struct d3d12_render_pass_state *state,
+        D3D12_RENDER_PASS_ENDING_ACCESS *access)
 {
-    FIXME("iface %p, meta_command %p, parameter_data %p, parameter_size %lu stub!\n",
-            iface, meta_command, parameter_data, parameter_size);
+    if (access->Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_RESOLVE && access->Resolve.SubresourceCount)
+        access->Resolve.pSubresourceParameters = &state->resolve_parameters[(uintptr_t)access->Resolve.pSubresourceParameters];
 }
 
-static void STDMETHODCALLTYPE d3d12_command_list_BuildRaytracingAccelerationStructure(d3d12_command_list_iface *iface,
-        const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC *desc, UINT num_postbuild_info_descs,
-        const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC *postbuild_info_descs)
+static void STDMETHODCALLTYPE d3d12_command_list_BeginRenderPass(d3d12_command_list_iface *iface,
+        UINT rt_count, const D3D12_RENDER_PASS_RENDER_TARGET_DESC *render_targets,
+        const D3D12_RENDER_PASS_DEPTH_STENCIL_DESC *depth_stencil, D3D12_RENDER_PASS_FLAGS flags)
 {
     struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
-    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
-    struct vkd3d_acceleration_structure_build_info build_info;
+    D3D12_CPU_DESCRIPTOR_HANDLE rtv_handles[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT];
+    struct d3d12_render_pass_state *state = &list->render_pass_state;
+    VkImageAspectFlags discard_aspects;
+    D3D12_CLEAR_FLAGS clear_flags;
+    size_t resolve_count;
+    unsigned int i;
+    HRESULT hr;
 
-    TRACE("iface %p, desc %p, num_postbuild_info_descs %u, postbuild_info_descs %p\n",
-            iface, desc, num_postbuild_info_descs, postbuild_info_descs);
+    TRACE("iface %p, rt_count %u, render_targets %p, depth_stencil %p, flags %#x.\n",
+            iface, rt_count, render_targets, depth_stencil, flags);
 
-    if (!d3d12_device_supports_ray_tracing_tier_1_0(list->device))
+    if (state->active)
     {
-        WARN("Acceleration structure is not supported. Calling this is invalid.\n");
+        d3d12_command_list_mark_as_invalid(list, "Render pass is already active.");
         return;
     }
 
-    if (!vkd3d_acceleration_structure_convert_inputs(list->device, &build_info, &desc->Inputs))
+    if (rt_count > D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT)
     {
-        ERR("Failed to convert inputs.\n");
-        return;
+        WARN("Render target count %u > %u, ignoring extra render targets.\n",
+                rt_count, D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT);
+        rt_count = D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT;
     }
 
-    if (desc->DestAccelerationStructureData)
+    for (i = 0; i < rt_count; i++)
+        rtv_handles[i] = render_targets[i].cpuDescriptor;
+
+    d3d12_command_list_OMSetRenderTargets(iface, rt_count, rtv_handles, FALSE,
+            depth_stencil ? &depth_stencil->cpuDescriptor : NULL);
+
+    /* Beginning accesses are folded into the load ops of the first Vulkan render pass.
+     * A resuming pass continues where the suspending pass left off. */
+    if (!(flags & D3D12_RENDER_PASS_FLAG_RESUMING_PASS))
     {
-        build_info.build_info.dstAccelerationStructure =
-                vkd3d_va_map_place_acceleration_structure(&list->device->memory_allocator.va_map,
-                        list->device, desc->DestAccelerationStructureData);
-        if (build_info.build_info.dstAccelerationStructure == VK_NULL_HANDLE)
+        for (i = 0; i < rt_count; i++)
         {
-            ERR("Failed to place destAccelerationStructure. Dropping call.\n");
-            return;
+            if (!(list->rtv_nonnull_mask & (1u << i)))
+                continue;
+
+            if (render_targets[i].BeginningAccess.Type == D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_CLEAR)
+            {
+                d3d12_command_list_ClearRenderTargetView(iface, render_targets[i].cpuDescriptor,
+                        render_targets[i].BeginningAccess.Clear.ClearValue.Color, 0, NULL);
+            }
+            else if (render_targets[i].BeginningAccess.Type == D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_DISCARD)
+            {
+                d3d12_command_list_discard_attachment_deferred(list, i, VK_IMAGE_ASPECT_COLOR_BIT);
+            }
         }
-    }
 
-    if (build_info.build_info.mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR &&
-            desc->SourceAccelerationStructureData)
-    {
-        build_info.build_info.srcAccelerationStructure =
-                vkd3d_va_map_place_acceleration_structure(&list->device->memory_allocator.va_map,
-                        list->device, desc->SourceAccelerationStructureData);
-        if (build_info.build_info.srcAccelerationStructure == VK_NULL_HANDLE)
+        if (depth_stencil && list->dsv.resource)
         {
-            ERR("Failed to place srcAccelerationStructure. Dropping call.\n");
-            return;
-        }
-    }
+            clear_flags = 0;
+            discard_aspects = 0;
 
-    build_info.build_info.scratchData.deviceAddress = desc->ScratchAccelerationStructureData;
+            if (depth_stencil->DepthBeginningAccess.Type == D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_CLEAR)
+                clear_flags |= D3D12_CLEAR_FLAG_DEPTH;
+            else if (depth_stencil->DepthBeginningAccess.Type == D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_DISCARD)
+                discard_aspects |= VK_IMAGE_ASPECT_DEPTH_BIT;
 
-    d3d12_command_list_end_current_render_pass(list, true);
-    VK_CALL(vkCmdBuildAccelerationStructuresKHR(list->vk_command_buffer, 1,
-            &build_info.build_info, build_info.build_range_ptrs));
+            if (depth_stencil->StencilBeginningAccess.Type == D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_CLEAR)
+                clear_flags |= D3D12_CLEAR_FLAG_STENCIL;
+            else if (depth_stencil->StencilBeginningAccess.Type == D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_DISCARD)
+                discard_aspects |= VK_IMAGE_ASPECT_STENCIL_BIT;
 
-    vkd3d_acceleration_structure_build_info_cleanup(&build_info);
+            if (clear_flags)
+            {
+                d3d12_command_list_ClearDepthStencilView(iface, depth_stencil->cpuDescriptor, clear_flags,
+                        depth_stencil->DepthBeginningAccess.Clear.ClearValue.DepthStencil.Depth,
+                        depth_stencil->StencilBeginningAccess.Clear.ClearValue.DepthStencil.Stencil, 0, NULL);
+            }
 
-    if (num_postbuild_info_descs)
-    {
-        vkd3d_acceleration_structure_emit_immediate_postbuild_info(list,
-                num_postbuild_info_descs, postbuild_info_descs,
-                build_info.build_info.dstAccelerationStructure);
+            discard_aspects &= list->dsv.format->vk_aspect_mask;
+            if (discard_aspects)
+            {
+                d3d12_command_list_discard_attachment_deferred(list,
+                        D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT, discard_aspects);
+            }
+        }
     }
-}
 
-static void STDMETHODCALLTYPE d3d12_command_list_EmitRaytracingAccelerationStructurePostbuildInfo(d3d12_command_list_iface *iface,
-        const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC *desc, UINT num_acceleration_structures,
-        const D3D12_GPU_VIRTUAL_ADDRESS *src_data)
-{
-    struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
-    TRACE("iface %p, desc %p, num_acceleration_structures %u, src_data %p\n",
-            iface, desc, num_acceleration_structures, src_data);
+    state->flags = flags;
+    state->rt_count = rt_count;
+    resolve_count = 0;
 
-    if (!d3d12_device_supports_ray_tracing_tier_1_0(list->device))
+    for (i = 0; i < rt_count; i++)
     {
-        WARN("Acceleration structure is not supported. Calling this is invalid.\n");
-        return;
+        if (FAILED(hr = d3d12_render_pass_state_copy_ending_access(state, &state->rt_ending_access[i],
+                &render_targets[i].EndingAccess, &resolve_count)))
+            goto fail;
     }
 
-    d3d12_command_list_end_current_render_pass(list, true);
-    vkd3d_acceleration_structure_emit_postbuild_info(list,
-            desc, num_acceleration_structures, src_data);
+    if (depth_stencil)
+    {
+        if (FAILED(hr = d3d12_render_pass_state_copy_ending_access(state, &state->depth_ending_access,
+                &depth_stencil->DepthEndingAccess, &resolve_count)))
+            goto fail;
+        if (FAILED(hr = d3d12_render_pass_state_copy_ending_access(state, &state->stencil_ending_access,
+                &depth_stencil->StencilEndingAccess, &resolve_count)))
+            goto fail;
+    }
+    else
+    {
+        state->depth_ending_access.Type = D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_NO_ACCESS;
+        state->stencil_ending_access.Type = D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_NO_ACCESS;
+    }
+
+    for (i = 0; i < rt_count; i++)
+        d3d12_render_pass_state_fixup_ending_access(state, &state->rt_ending_access[i]);
+    d3d12_render_pass_state_fixup_ending_access(state, &state->depth_ending_access);
+    d3d12_render_pass_state_fixup_ending_access(state, &state->stencil_ending_access);
+
+    state->active = true;
+    return;
+
+fail:
+    d3d12_command_list_mark_as_invalid(list, "Failed to allocate resolve parameters, hr %#x.", hr);
 }
 
-static void STDMETHODCALLTYPE d3d12_command_list_CopyRaytracingAccelerationStructure(d3d12_command_list_iface *iface,
-        D3D12_GPU_VIRTUAL_ADDRESS dst_data, D3D12_GPU_VIRTUAL_ADDRESS src_data,
-        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE mode)
+static void d3d12_command_list_discard_render_pass_view(d3d12_command_list_iface *iface,
+        const struct d3d12_rtv_desc *rtv, VkImageAspectFlags aspects)
 {
-    struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
-
-    TRACE("iface %p, dst_data %#"PRIx64", src_data %#"PRIx64", mode %u\n",
-          iface, dst_data, src_data, mode);
+    struct d3d12_resource *resource = rtv->resource;
+    unsigned int layer, layer_idx, layer_count;
+    D3D12_DISCARD_REGION region;
+    VkImageAspectFlags aspect;
+    unsigned int plane;
 
-    if (!d3d12_device_supports_ray_tracing_tier_1_0(list->device))
+    if (resource->desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D)
     {
-        WARN("Acceleration structure is not supported. Calling this is invalid.\n");
-        return;
+        layer_idx = 0;
+        layer_count = 1;
+    }
+    else
+    {
+        layer_idx = rtv->view->info.texture.layer_idx;
+        layer_count = rtv->layer_count;
+    }
+
+    region.NumRects = 0;
+    region.pRects = NULL;
+    region.NumSubresources = 1;
+
+    while (aspects)
+    {
+        aspect = aspects & -aspects;
+        aspects &= ~aspect;
+
+        plane = (aspect == VK_IMAGE_ASPECT_STENCIL_BIT &&
+                (resource->format->vk_aspect_mask & VK_IMAGE_ASPECT_DEPTH_BIT)) ? 1 : 0;
+
+        for (layer = layer_idx; layer < layer_idx + layer_count; layer++)
+        {
+            region.FirstSubresource = rtv->view->info.texture.miplevel_idx + resource->desc.MipLevels *
+                    (layer + plane * d3d12_resource_desc_get_layer_count(&resource->desc));
+            d3d12_command_list_DiscardResource(iface, (ID3D12Resource *)&resource->ID3D12Resource_iface, &region);
+        }
+    }
+}
+
+static void d3d12_command_list_resolve_render_pass_attachment(d3d12_command_list_iface *iface,
+        const D3D12_RENDER_PASS_ENDING_ACCESS_RESOLVE_PARAMETERS *resolve)
+{
+    const D3D12_RENDER_PASS_ENDING_ACCESS_RESOLVE_SUBRESOURCE_PARAMETERS *parameters;
+    D3D12_RECT src_rect;
+    unsigned int i;
+
+    for (i = 0; i < resolve->SubresourceCount; i++)
+    {
+        parameters = &resolve->pSubresourceParameters[i];
+        src_rect = parameters->SrcRect;
+        d3d12_command_list_ResolveSubresourceRegion(iface, resolve->pDstResource, parameters->DstSubresource,
+                parameters->DstX, parameters->DstY, resolve->pSrcResource, parameters->SrcSubresource,
+                &src_rect, resolve->Format, resolve->ResolveMode);
+    }
+}
+
+static void STDMETHODCALLTYPE d3d12_command_list_EndRenderPass(d3d12_command_list_iface *iface)
+{
+    struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
+    struct d3d12_render_pass_state *state = &list->render_pass_state;
+    const D3D12_RENDER_PASS_ENDING_ACCESS *access;
+    VkImageAspectFlags discard_aspects;
+    unsigned int i;
+
+    TRACE("iface %p.\n", iface);
+
+    if (!state->active)
+    {
+        d3d12_command_list_mark_as_invalid(list, "No render pass is active.");
+        return;
+    }
+
+    state->active = false;
+    d3d12_command_list_end_current_render_pass(list, false);
+
+    /* The store op of a Vulkan render pass is decided when it begins, but we may have to
+     * split a D3D12 render pass into multiple Vulkan render passes while recording,
+     * so ending accesses are applied after the fact. */
+    if (state->flags & D3D12_RENDER_PASS_FLAG_SUSPENDING_PASS)
+        return;
+
+    for (i = 0; i < state->rt_count; i++)
+    {
+        access = &state->rt_ending_access[i];
+
+        if (!list->rtvs[i].resource)
+            continue;
+
+        if (access->Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_RESOLVE)
+        {
+            d3d12_command_list_resolve_render_pass_attachment(iface, &access->Resolve);
+            if (!access->Resolve.PreserveResolveSource)
+                d3d12_command_list_discard_render_pass_view(iface, &list->rtvs[i], VK_IMAGE_ASPECT_COLOR_BIT);
+        }
+        else if (access->Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_DISCARD)
+        {
+            d3d12_command_list_discard_render_pass_view(iface, &list->rtvs[i], VK_IMAGE_ASPECT_COLOR_BIT);
+        }
+    }
+
+    if (!list->dsv.resource)
+        return;
+
+    discard_aspects = 0;
+
+    if (state->depth_ending_access.Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_RESOLVE)
+        d3d12_command_list_resolve_render_pass_attachment(iface, &state->depth_ending_access.Resolve);
+    if (state->stencil_ending_access.Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_RESOLVE)
+        d3d12_command_list_resolve_render_pass_attachment(iface, &state->stencil_ending_access.Resolve);
+
+    if (state->depth_ending_access.Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_DISCARD ||
+            (state->depth_ending_access.Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_RESOLVE &&
+            !state->depth_ending_access.Resolve.PreserveResolveSource))
+        discard_aspects |= VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (state->stencil_ending_access.Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_DISCARD ||
+            (state->stencil_ending_access.Type == D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_RESOLVE &&
+            !state->stencil_ending_access.Resolve.PreserveResolveSource))
+        discard_aspects |= VK_IMAGE_ASPECT_STENCIL_BIT;
+
+    discard_aspects &= list->dsv.format->vk_aspect_mask;
+    if (discard_aspects)
+        d3d12_command_list_discard_render_pass_view(iface, &list->dsv, discard_aspects);
+}
+
+static void STDMETHODCALLTYPE d3d12_command_list_InitializeMetaCommand(d3d12_command_list_iface *iface,
+        ID3D12MetaCommand *meta_command, const void *parameter_data, SIZE_T parameter_size)
+{
+    FIXME("iface %p, meta_command %p, parameter_data %p, parameter_size %lu stub!\n",
+            iface, meta_command, parameter_data, parameter_size);
+}
+
+static void STDMETHODCALLTYPE d3d12_command_list_ExecuteMetaCommand(d3d12_command_list_iface *iface,
+        ID3D12MetaCommand *meta_command, const void *parameter_data, SIZE_T parameter_size)
+{
+    FIXME("iface %p, meta_command %p, parameter_data %p, parameter_size %lu stub!\n",
+            iface, meta_command, parameter_data, parameter_size);
+}
+
+static void STDMETHODCALLTYPE d3d12_command_list_BuildRaytracingAccelerationStructure(d3d12_command_list_iface *iface,
+        const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC *desc, UINT num_postbuild_info_descs,
+        const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC *postbuild_info_descs)
+{
+    struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
+    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
+    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO prebuild_info;
+    struct vkd3d_acceleration_structure_build_info build_info;
+
+    TRACE("iface %p, desc %p, num_postbuild_info_descs %u, postbuild_info_descs %p\n",
+            iface, desc, num_postbuild_info_descs, postbuild_info_descs);
+
+    if (!d3d12_device_supports_ray_tracing_tier_1_0(list->device))
+    {
+        WARN("Acceleration structure is not supported. Calling this is invalid.\n");
+        return;
+    }
+
+    if (!vkd3d_acceleration_structure_convert_inputs(list->device, &build_info, &desc->Inputs))
+    {
+        ERR("Failed to convert inputs.\n");
+        return;
+    }
+
+    if (desc->DestAccelerationStructureData)
+    {
+        /* The app must reserve the maximum result size for the destination, and anything
+         * else placed in that range is overwritten by the build. */
+        if (!vkd3d_acceleration_structure_get_prebuild_info(list->device, &desc->Inputs, &prebuild_info))
+            prebuild_info.ResultDataMaxSizeInBytes = 0;
+
+        build_info.build_info.dstAccelerationStructure = d3d12_command_list_place_acceleration_structure(list,
+                desc->DestAccelerationStructureData, prebuild_info.ResultDataMaxSizeInBytes);
+        if (build_info.build_info.dstAccelerationStructure == VK_NULL_HANDLE)
+        {
+            ERR("Failed to place destAccelerationStructure. Dropping call.\n");
+            return;
+        }
+    }
+
+    if (build_info.build_info.mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR &&
+            desc->SourceAccelerationStructureData)
+    {
+        build_info.build_info.srcAccelerationStructure =
+                d3d12_command_list_place_acceleration_structure(list, desc->SourceAccelerationStructureData, 0);
+        if (build_info.build_info.srcAccelerationStructure == VK_NULL_HANDLE)
+        {
+            ERR("Failed to place srcAccelerationStructure. Dropping call.\n");
+            return;
+        }
+    }
+
+    build_info.build_info.scratchData.deviceAddress = desc->ScratchAccelerationStructureData;
+
+    d3d12_command_list_end_current_render_pass(list, true);
+    VK_CALL(vkCmdBuildAccelerationStructuresKHR(list->vk_command_buffer, 1,
+            &build_info.build_info, build_info.build_range_ptrs));
+
+    vkd3d_acceleration_structure_build_info_cleanup(&build_info);
+
+    if (num_postbuild_info_descs)
+    {
+        vkd3d_acceleration_structure_emit_immediate_postbuild_info(list,
+                num_postbuild_info_descs, postbuild_info_descs,
+                build_info.build_info.dstAccelerationStructure);
+    }
+}
+
+static void STDMETHODCALLTYPE d3d12_command_list_EmitRaytracingAccelerationStructurePostbuildInfo(d3d12_command_list_iface *iface,
+        const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC *desc, UINT num_acceleration_structures,
+        const D3D12_GPU_VIRTUAL_ADDRESS *src_data)
+{
+    struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
+    TRACE("iface %p, desc %p, num_acceleration_structures %u, src_data %p\n",
+            iface, desc, num_acceleration_structures, src_data);
+
+    if (!d3d12_device_supports_ray_tracing_tier_1_0(list->device))
+    {
+        WARN("Acceleration structure is not supported. Calling this is invalid.\n");
+        return;
+    }
+
+    d3d12_command_list_end_current_render_pass(list, true);
+    vkd3d_acceleration_structure_emit_postbuild_info(list,
+            desc, num_acceleration_structures, src_data);
+}
+
+static void STDMETHODCALLTYPE d3d12_command_list_CopyRaytracingAccelerationStructure(d3d12_command_list_iface *iface,
+        D3D12_GPU_VIRTUAL_ADDRESS dst_data, D3D12_GPU_VIRTUAL_ADDRESS src_data,
+        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE mode)
+{
+    struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
+
+    TRACE("iface %p, dst_data %#"PRIx64", src_data %#"PRIx64", mode %u\n",
+          iface, dst_data, src_data, mode);
+
+    if (!d3d12_device_supports_ray_tracing_tier_1_0(list->device))
+    {
+        WARN("Acceleration structure is not supported. Calling this is invalid.\n");
+        return;
     }
 
     d3d12_command_list_end_current_render_pass(list, true);
@@ -9504,102 +10461,601 @@ static void STDMETHODCALLTYPE d3d12_command_list_RSSetShadingRateImage(d3d12_com
     list->vrs_image = vrs_image;
 }
 
-static CONST_VTBL struct ID3D12GraphicsCommandList5Vtbl d3d12_command_list_vtbl =
+static void STDMETHODCALLTYPE d3d12_command_list_DispatchMesh(d3d12_command_list_iface *iface,
+        UINT x, UINT y, UINT z)
 {
-    /* IUnknown methods */
-    d3d12_command_list_QueryInterface,
-    d3d12_command_list_AddRef,
-    d3d12_command_list_Release,
-    /* ID3D12Object methods */
-    d3d12_command_list_GetPrivateData,
-    d3d12_command_list_SetPrivateData,
-    d3d12_command_list_SetPrivateDataInterface,
-    (void *)d3d12_object_SetName,
-    /* ID3D12DeviceChild methods */
-    d3d12_command_list_GetDevice,
-    /* ID3D12CommandList methods */
-    d3d12_command_list_GetType,
-    /* ID3D12GraphicsCommandList methods */
-    d3d12_command_list_Close,
-    d3d12_command_list_Reset,
-    d3d12_command_list_ClearState,
-    d3d12_command_list_DrawInstanced,
-    d3d12_command_list_DrawIndexedInstanced,
-    d3d12_command_list_Dispatch,
-    d3d12_command_list_CopyBufferRegion,
-    d3d12_command_list_CopyTextureRegion,
-    d3d12_command_list_CopyResource,
-    d3d12_command_list_CopyTiles,
-    d3d12_command_list_ResolveSubresource,
-    d3d12_command_list_IASetPrimitiveTopology,
-    d3d12_command_list_RSSetViewports,
-    d3d12_command_list_RSSetScissorRects,
-    d3d12_command_list_OMSetBlendFactor,
-    d3d12_command_list_OMSetStencilRef,
-    d3d12_command_list_SetPipelineState,
-    d3d12_command_list_ResourceBarrier,
-    d3d12_command_list_ExecuteBundle,
-    d3d12_command_list_SetDescriptorHeaps,
-    d3d12_command_list_SetComputeRootSignature,
-    d3d12_command_list_SetGraphicsRootSignature,
-    d3d12_command_list_SetComputeRootDescriptorTable,
-    d3d12_command_list_SetGraphicsRootDescriptorTable,
-    d3d12_command_list_SetComputeRoot32BitConstant,
-    d3d12_command_list_SetGraphicsRoot32BitConstant,
-    d3d12_command_list_SetComputeRoot32BitConstants,
-    d3d12_command_list_SetGraphicsRoot32BitConstants,
-    d3d12_command_list_SetComputeRootConstantBufferView,
-    d3d12_command_list_SetGraphicsRootConstantBufferView,
-    d3d12_command_list_SetComputeRootShaderResourceView,
-    d3d12_command_list_SetGraphicsRootShaderResourceView,
-    d3d12_command_list_SetComputeRootUnorderedAccessView,
-    d3d12_command_list_SetGraphicsRootUnorderedAccessView,
-    d3d12_command_list_IASetIndexBuffer,
-    d3d12_command_list_IASetVertexBuffers,
-    d3d12_command_list_SOSetTargets,
-    d3d12_command_list_OMSetRenderTargets,
-    d3d12_command_list_ClearDepthStencilView,
-    d3d12_command_list_ClearRenderTargetView,
-    d3d12_command_list_ClearUnorderedAccessViewUint,
-    d3d12_command_list_ClearUnorderedAccessViewFloat,
-    d3d12_command_list_DiscardResource,
-    d3d12_command_list_BeginQuery,
-    d3d12_command_list_EndQuery,
-    d3d12_command_list_ResolveQueryData,
-    d3d12_command_list_SetPredication,
-    d3d12_command_list_SetMarker,
-    d3d12_command_list_BeginEvent,
-    d3d12_command_list_EndEvent,
-    d3d12_command_list_ExecuteIndirect,
-    /* ID3D12GraphicsCommandList1 methods */
-    d3d12_command_list_AtomicCopyBufferUINT,
-    d3d12_command_list_AtomicCopyBufferUINT64,
-    d3d12_command_list_OMSetDepthBounds,
-    d3d12_command_list_SetSamplePositions,
-    d3d12_command_list_ResolveSubresourceRegion,
-    d3d12_command_list_SetViewInstanceMask,
-    /* ID3D12GraphicsCommandList2 methods */
-    d3d12_command_list_WriteBufferImmediate,
-    /* ID3D12GraphicsCommandList3 methods */
-    d3d12_command_list_SetProtectedResourceSession,
-    /* ID3D12GraphicsCommandList4 methods */
-    d3d12_command_list_BeginRenderPass,
-    d3d12_command_list_EndRenderPass,
-    d3d12_command_list_InitializeMetaCommand,
-    d3d12_command_list_ExecuteMetaCommand,
-    d3d12_command_list_BuildRaytracingAccelerationStructure,
-    d3d12_command_list_EmitRaytracingAccelerationStructurePostbuildInfo,
-    d3d12_command_list_CopyRaytracingAccelerationStructure,
-    d3d12_command_list_SetPipelineState1,
-    d3d12_command_list_DispatchRays,
-    /* ID3D12GraphicsCommandList5 methods */
-    d3d12_command_list_RSSetShadingRate,
-    d3d12_command_list_RSSetShadingRateImage,
-};
+    struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
+    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
+    struct vkd3d_scratch_allocation scratch;
+    bool use_draw_count = false;
 
-#ifdef VKD3D_ENABLE_PROFILING
-#include "command_list_profiled.h"
-#endif
+    TRACE("iface %p, x %u, y %u, z %u.\n", iface, x, y, z);
+
+    if (!d3d12_pipeline_state_is_graphics(list->state) || !list->state->graphics.is_mesh_pipeline)
+    {
+        WARN("Pipeline state %p is not a mesh shader pipeline, ignoring DispatchMesh.\n", list->state);
+        return;
+    }
+
+    if (list->predicate_va)
+    {
+        union vkd3d_predicate_command_direct_args args;
+        memset(&args, 0, sizeof(args));
+        args.draw_mesh_tasks.groupCountX = x;
+        args.draw_mesh_tasks.groupCountY = y;
+        args.draw_mesh_tasks.groupCountZ = z;
+
+        if (!d3d12_command_list_emit_predicated_draw(list, VKD3D_PREDICATE_COMMAND_DRAW_MESH_TASKS,
+                &args, &scratch, &use_draw_count))
+            return;
+    }
+
+    if (!d3d12_command_list_begin_render_pass(list))
+    {
+        WARN("Failed to begin render pass, ignoring mesh dispatch.\n");
+        return;
+    }
+
+    if (!list->predicate_va)
+        VK_CALL(vkCmdDrawMeshTasksEXT(list->vk_command_buffer, x, y, z));
+    else if (use_draw_count)
+        VK_CALL(vkCmdDrawMeshTasksIndirectCountEXT(list->vk_command_buffer, scratch.buffer, scratch.offset,
+                list->predicate_vk_buffer, list->predicate_offset, 1, sizeof(VkDrawMeshTasksIndirectCommandEXT)));
+    else
+        VK_CALL(vkCmdDrawMeshTasksIndirectEXT(list->vk_command_buffer, scratch.buffer, scratch.offset,
+                1, sizeof(VkDrawMeshTasksIndirectCommandEXT)));
+}
+
+struct d3d12_command_list_barrier2_batch
+{
+    VkImageMemoryBarrier2KHR vk_image_barriers[MAX_BATCHED_IMAGE_BARRIERS];
+    VkMemoryBarrier2KHR vk_memory_barrier;
+    uint32_t image_barrier_count;
+};
+
+static void d3d12_command_list_barrier2_batch_init(struct d3d12_command_list_barrier2_batch *batch)
+{
+    memset(&batch->vk_memory_barrier, 0, sizeof(batch->vk_memory_barrier));
+    batch->vk_memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+    batch->image_barrier_count = 0;
+}
+
+static void d3d12_command_list_barrier2_batch_end_legacy(struct d3d12_command_list *list,
+        struct d3d12_command_list_barrier2_batch *batch)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
+    VkImageMemoryBarrier vk_image_barriers[MAX_BATCHED_IMAGE_BARRIERS];
+    VkPipelineStageFlags src_stages, dst_stages;
+    VkMemoryBarrier vk_memory_barrier;
+    uint32_t i;
+
+    /* The translation only emits stage and access bits which exist in the legacy enums. */
+    src_stages = (VkPipelineStageFlags)batch->vk_memory_barrier.srcStageMask;
+    dst_stages = (VkPipelineStageFlags)batch->vk_memory_barrier.dstStageMask;
+
+    vk_memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    vk_memory_barrier.pNext = NULL;
+    vk_memory_barrier.srcAccessMask = (VkAccessFlags)batch->vk_memory_barrier.srcAccessMask;
+    vk_memory_barrier.dstAccessMask = (VkAccessFlags)batch->vk_memory_barrier.dstAccessMask;
+
+    for (i = 0; i < batch->image_barrier_count; i++)
+    {
+        const VkImageMemoryBarrier2KHR *src = &batch->vk_image_barriers[i];
+        VkImageMemoryBarrier *dst = &vk_image_barriers[i];
+
+        src_stages |= (VkPipelineStageFlags)src->srcStageMask;
+        dst_stages |= (VkPipelineStageFlags)src->dstStageMask;
+
+        dst->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        dst->pNext = NULL;
+        dst->srcAccessMask = (VkAccessFlags)src->srcAccessMask;
+        dst->dstAccessMask = (VkAccessFlags)src->dstAccessMask;
+        dst->oldLayout = src->oldLayout;
+        dst->newLayout = src->newLayout;
+        dst->srcQueueFamilyIndex = src->srcQueueFamilyIndex;
+        dst->dstQueueFamilyIndex = src->dstQueueFamilyIndex;
+        dst->image = src->image;
+        dst->subresourceRange = src->subresourceRange;
+    }
+
+    if (!src_stages)
+        src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    if (!dst_stages)
+        dst_stages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+    VK_CALL(vkCmdPipelineBarrier(list->vk_command_buffer,
+            src_stages, dst_stages, 0,
+            1, &vk_memory_barrier, 0, NULL,
+            batch->image_barrier_count, vk_image_barriers));
+}
+
+static void d3d12_command_list_barrier2_batch_end(struct d3d12_command_list *list,
+        struct d3d12_command_list_barrier2_batch *batch)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &list->device->vk_procs;
+    bool has_memory_barrier;
+    VkDependencyInfoKHR dep_info;
+
+    has_memory_barrier = batch->vk_memory_barrier.srcStageMask || batch->vk_memory_barrier.dstStageMask;
+
+    if (!has_memory_barrier && !batch->image_barrier_count)
+        return;
+
+    if (list->device->device_info.synchronization2_features.synchronization2)
+    {
+        memset(&dep_info, 0, sizeof(dep_info));
+        dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dep_info.memoryBarrierCount = has_memory_barrier ? 1 : 0;
+        dep_info.pMemoryBarriers = &batch->vk_memory_barrier;
+        dep_info.imageMemoryBarrierCount = batch->image_barrier_count;
+        dep_info.pImageMemoryBarriers = batch->vk_image_barriers;
+        VK_CALL(vkCmdPipelineBarrier2KHR(list->vk_command_buffer, &dep_info));
+    }
+    else
+        d3d12_command_list_barrier2_batch_end_legacy(list, batch);
+
+    d3d12_command_list_barrier2_batch_init(batch);
+}
+
+static void d3d12_command_list_barrier2_batch_add_image_barrier(struct d3d12_command_list *list,
+        struct d3d12_command_list_barrier2_batch *batch, const VkImageMemoryBarrier2KHR *image_barrier)
+{
+    uint32_t i;
+
+    if (batch->image_barrier_count == ARRAY_SIZE(batch->vk_image_barriers))
+        d3d12_command_list_barrier2_batch_end(list, batch);
+
+    /* Barriers within a group are ordered, see ResourceBarrier(). */
+    for (i = 0; i < batch->image_barrier_count; i++)
+    {
+        if (vk_image_subresource_range_overlaps(image_barrier->image, &image_barrier->subresourceRange,
+                batch->vk_image_barriers[i].image, &batch->vk_image_barriers[i].subresourceRange))
+        {
+            d3d12_command_list_barrier2_batch_end(list, batch);
+            break;
+        }
+    }
+
+    batch->vk_image_barriers[batch->image_barrier_count++] = *image_barrier;
+}
+
+static VkPipelineStageFlags2KHR d3d12_command_list_get_barrier_stages(const struct d3d12_command_list *list,
+        D3D12_BARRIER_SYNC sync)
+{
+    VkPipelineStageFlags2KHR stages;
+
+    if (sync == D3D12_BARRIER_SYNC_NONE)
+        return 0;
+
+    /* Vulkan doesn't support split barriers, so the begin half has to wait for everything. */
+    if (sync == D3D12_BARRIER_SYNC_SPLIT)
+    {
+        FIXME_ONCE("Split barriers are not supported, issuing full barrier.\n");
+        return VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+    }
+
+    stages = vk_stage_flags_from_d3d12_barrier_sync(sync);
+
+    if (!(list->vk_queue_flags & VK_QUEUE_GRAPHICS_BIT))
+    {
+        stages &= ~(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT_KHR |
+                VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR |
+                VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_TESSELLATION_EVALUATION_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_GEOMETRY_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT |
+                VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT |
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR |
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR |
+                VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR |
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+    }
+
+    if (!(list->vk_queue_flags & VK_QUEUE_COMPUTE_BIT))
+    {
+        stages &= VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR |
+                VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT_KHR |
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+    }
+
+    if (!d3d12_device_supports_ray_tracing_tier_1_0(list->device))
+    {
+        stages &= ~(VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR |
+                VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR);
+    }
+
+    if (!list->device->device_info.mesh_shader_features.meshShader)
+        stages &= ~VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+    if (!list->device->device_info.mesh_shader_features.taskShader)
+        stages &= ~VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT;
+
+    /* Don't drop synchronization if the queue cannot execute any of the requested stages. */
+    return stages ? stages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+}
+
+static VkAccessFlags2KHR d3d12_command_list_get_barrier_access(const struct d3d12_command_list *list,
+        D3D12_BARRIER_ACCESS access, VkPipelineStageFlags2KHR stages)
+{
+    VkAccessFlags2KHR vk_access = vk_access_flags_from_d3d12_barrier_access(access, stages);
+
+    if (!(list->vk_queue_flags & VK_QUEUE_GRAPHICS_BIT))
+    {
+        vk_access &= ~(VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR |
+                VK_ACCESS_2_INDEX_READ_BIT_KHR |
+                VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR |
+                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR |
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+                VK_ACCESS_2_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR);
+    }
+
+    if (!(list->vk_queue_flags & VK_QUEUE_GRAPHICS_BIT) || !list->device->vk_info.EXT_transform_feedback)
+    {
+        vk_access &= ~(VK_ACCESS_2_TRANSFORM_FEEDBACK_WRITE_BIT_EXT |
+                VK_ACCESS_2_TRANSFORM_FEEDBACK_COUNTER_READ_BIT_EXT |
+                VK_ACCESS_2_TRANSFORM_FEEDBACK_COUNTER_WRITE_BIT_EXT);
+    }
+
+    if (!d3d12_device_supports_ray_tracing_tier_1_0(list->device))
+    {
+        vk_access &= ~(VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR |
+                VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR);
+    }
+
+    return vk_access;
+}
+
+static void d3d12_command_list_add_global_barrier(struct d3d12_command_list *list,
+        struct d3d12_command_list_barrier2_batch *batch,
+        D3D12_BARRIER_SYNC sync_before, D3D12_BARRIER_SYNC sync_after,
+        D3D12_BARRIER_ACCESS access_before, D3D12_BARRIER_ACCESS access_after)
+{
+    VkPipelineStageFlags2KHR src_stages, dst_stages;
+
+    src_stages = d3d12_command_list_get_barrier_stages(list, sync_before);
+    dst_stages = d3d12_command_list_get_barrier_stages(list, sync_after);
+
+    batch->vk_memory_barrier.srcStageMask |= src_stages;
+    batch->vk_memory_barrier.dstStageMask |= dst_stages;
+    batch->vk_memory_barrier.srcAccessMask |= d3d12_command_list_get_barrier_access(list, access_before, src_stages);
+    batch->vk_memory_barrier.dstAccessMask |= d3d12_command_list_get_barrier_access(list, access_after, dst_stages);
+}
+
+/* Returns a subresource index which can be passed to notify_dsv_state(). Ranges which
+ * cannot be expressed as a single subresource return an out of range index, which
+ * only allows decaying. */
+static UINT d3d12_barrier_subresource_range_get_index(const struct d3d12_resource *resource,
+        const D3D12_BARRIER_SUBRESOURCE_RANGE *range)
+{
+    unsigned int layer_count = d3d12_resource_desc_get_layer_count(&resource->desc);
+    unsigned int plane_count = vkd3d_popcount(resource->format->vk_aspect_mask);
+
+    if (!range->NumMipLevels)
+        return range->IndexOrFirstMipLevel;
+
+    if (range->IndexOrFirstMipLevel == 0 && range->NumMipLevels >= resource->desc.MipLevels &&
+            range->FirstArraySlice == 0 && range->NumArraySlices >= layer_count &&
+            range->FirstPlane == 0 && range->NumPlanes >= plane_count)
+        return D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+    if (range->NumMipLevels == 1 && range->NumArraySlices == 1 && range->NumPlanes == 1)
+    {
+        return range->IndexOrFirstMipLevel + (range->FirstArraySlice +
+                range->FirstPlane * layer_count) * resource->desc.MipLevels;
+    }
+
+    return d3d12_resource_get_sub_resource_count(resource);
+}
+
+static void vk_image_subresource_range_from_d3d12_barrier(const struct d3d12_resource *resource,
+        const D3D12_BARRIER_SUBRESOURCE_RANGE *range, VkImageSubresourceRange *vk_range)
+{
+    VkImageSubresource subresource;
+
+    /* Depth and stencil share a layout in the current model, so like ResourceBarrier(),
+     * always transition all aspects. */
+    vk_range->aspectMask = resource->format->vk_aspect_mask;
+
+    if (!range->NumMipLevels)
+    {
+        if (range->IndexOrFirstMipLevel == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+        {
+            vk_range->baseMipLevel = 0;
+            vk_range->baseArrayLayer = 0;
+            vk_range->levelCount = VK_REMAINING_MIP_LEVELS;
+            vk_range->layerCount = VK_REMAINING_ARRAY_LAYERS;
+        }
+        else
+        {
+            subresource = d3d12_resource_get_vk_subresource(resource, range->IndexOrFirstMipLevel, true);
+            vk_range->baseMipLevel = subresource.mipLevel;
+            vk_range->baseArrayLayer = subresource.arrayLayer;
+            vk_range->levelCount = 1;
+            vk_range->layerCount = 1;
+        }
+    }
+    else
+    {
+        vk_range->baseMipLevel = range->IndexOrFirstMipLevel;
+        vk_range->levelCount = range->NumMipLevels;
+
+        if (resource->desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D)
+        {
+            vk_range->baseArrayLayer = 0;
+            vk_range->layerCount = 1;
+        }
+        else
+        {
+            vk_range->baseArrayLayer = range->FirstArraySlice;
+            vk_range->layerCount = range->NumArraySlices;
+        }
+    }
+}
+
+static VkImageLayout d3d12_command_list_get_barrier_layout(struct d3d12_command_list *list,
+        const struct d3d12_resource *resource, D3D12_BARRIER_LAYOUT layout)
+{
+    VkImageLayout depth_stencil_layout = resource->common_layout;
+
+    if (layout == D3D12_BARRIER_LAYOUT_UNDEFINED)
+        return VK_IMAGE_LAYOUT_UNDEFINED;
+
+    /* See vk_image_layout_from_d3d12_resource_state(). */
+    if (resource->flags & (VKD3D_RESOURCE_LINEAR_TILING | VKD3D_RESOURCE_SIMULTANEOUS_ACCESS))
+        return VK_IMAGE_LAYOUT_GENERAL;
+
+    if (d3d12_barrier_layout_is_depth_stencil(layout))
+        depth_stencil_layout = d3d12_command_list_get_depth_stencil_resource_layout(list, resource, NULL);
+
+    return vk_image_layout_from_d3d12_barrier_layout(layout, resource->common_layout, depth_stencil_layout);
+}
+
+static void d3d12_command_list_add_texture_barrier(struct d3d12_command_list *list,
+        struct d3d12_command_list_barrier2_batch *batch, const D3D12_TEXTURE_BARRIER *barrier)
+{
+    VkImageLayout old_layout, new_layout;
+    VkImageMemoryBarrier2KHR vk_barrier;
+    struct d3d12_resource *resource;
+    bool discard;
+
+    if (!(resource = impl_from_ID3D12Resource(barrier->pResource)) || !d3d12_resource_is_texture(resource))
+    {
+        d3d12_command_list_mark_as_invalid(list, "Texture barrier with invalid resource %p.", barrier->pResource);
+        return;
+    }
+
+    /* The transition happens in the END half of split barriers. */
+    if (barrier->SyncAfter == D3D12_BARRIER_SYNC_SPLIT)
+        return;
+
+    /* The contents are undefined after the barrier, which lets us skip the initial transition. */
+    discard = barrier->LayoutBefore == D3D12_BARRIER_LAYOUT_UNDEFINED ||
+            (barrier->Flags & D3D12_TEXTURE_BARRIER_FLAG_DISCARD);
+
+    if (resource->desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
+    {
+        d3d12_command_list_track_dsv_boundary_layout(list, resource,
+                d3d12_barrier_layout_is_depth_stencil(barrier->LayoutBefore) &&
+                d3d12_barrier_subresource_range_get_index(resource, &barrier->Subresources) ==
+                D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES ?
+                VKD3D_DEPTH_PLANE_OPTIMAL | VKD3D_STENCIL_PLANE_OPTIMAL : 0);
+    }
+
+    old_layout = discard ? VK_IMAGE_LAYOUT_UNDEFINED :
+            d3d12_command_list_get_barrier_layout(list, resource, barrier->LayoutBefore);
+
+    if ((resource->desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) &&
+            barrier->LayoutAfter != D3D12_BARRIER_LAYOUT_UNDEFINED)
+    {
+        /* If we enter DEPTH_WRITE or DEPTH_READ we can promote to optimal. */
+        d3d12_command_list_notify_dsv_state(list, resource,
+                d3d12_barrier_layout_is_depth_stencil(barrier->LayoutAfter) ?
+                D3D12_RESOURCE_STATE_DEPTH_WRITE : D3D12_RESOURCE_STATE_COMMON,
+                d3d12_barrier_subresource_range_get_index(resource, &barrier->Subresources));
+    }
+
+    /* Transitioning to UNDEFINED keeps the current layout, the resource is
+     * expected to be discarded before it is used again. */
+    new_layout = barrier->LayoutAfter == D3D12_BARRIER_LAYOUT_UNDEFINED ? old_layout :
+            d3d12_command_list_get_barrier_layout(list, resource, barrier->LayoutAfter);
+
+    d3d12_command_list_track_resource_usage(list, resource, !discard);
+
+    if (old_layout == new_layout)
+    {
+        d3d12_command_list_add_global_barrier(list, batch, barrier->SyncBefore, barrier->SyncAfter,
+                barrier->AccessBefore, barrier->AccessAfter);
+        return;
+    }
+
+    memset(&vk_barrier, 0, sizeof(vk_barrier));
+    vk_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+    vk_barrier.srcStageMask = d3d12_command_list_get_barrier_stages(list, barrier->SyncBefore);
+    vk_barrier.dstStageMask = d3d12_command_list_get_barrier_stages(list, barrier->SyncAfter);
+    vk_barrier.srcAccessMask = d3d12_command_list_get_barrier_access(list,
+            barrier->AccessBefore, vk_barrier.srcStageMask);
+    vk_barrier.dstAccessMask = d3d12_command_list_get_barrier_access(list,
+            barrier->AccessAfter, vk_barrier.dstStageMask);
+    vk_barrier.oldLayout = old_layout;
+    vk_barrier.newLayout = new_layout;
+    vk_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    vk_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    vk_barrier.image = resource->res.vk_image;
+    vk_image_subresource_range_from_d3d12_barrier(resource, &barrier->Subresources, &vk_barrier.subresourceRange);
+
+    d3d12_command_list_barrier2_batch_add_image_barrier(list, batch, &vk_barrier);
+
+    TRACE("Texture barrier (resource %p, layout before %#x, layout after %#x).\n",
+            resource, barrier->LayoutBefore, barrier->LayoutAfter);
+}
+
+static void STDMETHODCALLTYPE d3d12_command_list_Barrier(d3d12_command_list_iface *iface,
+        UINT32 num_barrier_groups, const D3D12_BARRIER_GROUP *barrier_groups)
+{
+    struct d3d12_command_list *list = impl_from_ID3D12GraphicsCommandList(iface);
+    struct d3d12_command_list_barrier2_batch batch;
+    const D3D12_BUFFER_BARRIER *buffer_barrier;
+    const D3D12_GLOBAL_BARRIER *global_barrier;
+    struct d3d12_resource *resource;
+    unsigned int i, j;
+
+    TRACE("iface %p, num_barrier_groups %u, barrier_groups %p.\n", iface, num_barrier_groups, barrier_groups);
+
+    d3d12_command_list_end_current_render_pass(list, false);
+    d3d12_command_list_barrier2_batch_init(&batch);
+
+    for (i = 0; i < num_barrier_groups; i++)
+    {
+        const D3D12_BARRIER_GROUP *group = &barrier_groups[i];
+
+        for (j = 0; j < group->NumBarriers; j++)
+        {
+            switch (group->Type)
+            {
+                case D3D12_BARRIER_TYPE_GLOBAL:
+                    global_barrier = &group->pGlobalBarriers[j];
+                    if (global_barrier->SyncAfter == D3D12_BARRIER_SYNC_SPLIT)
+                        continue;
+
+                    d3d12_command_list_add_global_barrier(list, &batch,
+                            global_barrier->SyncBefore, global_barrier->SyncAfter,
+                            global_barrier->AccessBefore, global_barrier->AccessAfter);
+                    break;
+
+                case D3D12_BARRIER_TYPE_TEXTURE:
+                    d3d12_command_list_add_texture_barrier(list, &batch, &group->pTextureBarriers[j]);
+                    break;
+
+                case D3D12_BARRIER_TYPE_BUFFER:
+                    /* Buffers are only synchronized with global memory barriers. */
+                    buffer_barrier = &group->pBufferBarriers[j];
+                    if (!(resource = impl_from_ID3D12Resource(buffer_barrier->pResource)))
+                    {
+                        d3d12_command_list_mark_as_invalid(list, "A resource pointer is NULL.");
+                        continue;
+                    }
+
+                    d3d12_command_list_track_resource_usage(list, resource, true);
+
+                    if (buffer_barrier->SyncAfter == D3D12_BARRIER_SYNC_SPLIT)
+                        continue;
+
+                    d3d12_command_list_add_global_barrier(list, &batch,
+                            buffer_barrier->SyncBefore, buffer_barrier->SyncAfter,
+                            buffer_barrier->AccessBefore, buffer_barrier->AccessAfter);
+                    break;
+
+                default:
+                    WARN("Invalid barrier type %#x.\n", group->Type);
+                    break;
+            }
+        }
+    }
+
+    d3d12_command_list_barrier2_batch_end(list, &batch);
+}
+
+static CONST_VTBL struct ID3D12GraphicsCommandList7Vtbl d3d12_command_list_vtbl =
+{
+    /* IUnknown methods */
+    d3d12_command_list_QueryInterface,
+    d3d12_command_list_AddRef,
+    d3d12_command_list_Release,
+    /* ID3D12Object methods */
+    d3d12_command_list_GetPrivateData,
+    d3d12_command_list_SetPrivateData,
+    d3d12_command_list_SetPrivateDataInterface,
+    (void *)d3d12_object_SetName,
+    /* ID3D12DeviceChild methods */
+    d3d12_command_list_GetDevice,
+    /* ID3D12CommandList methods */
+    d3d12_command_list_GetType,
+    /* ID3D12GraphicsCommandList methods */
+    d3d12_command_list_Close,
+    d3d12_command_list_Reset,
+    d3d12_command_list_ClearState,
+    d3d12_command_list_DrawInstanced,
+    d3d12_command_list_DrawIndexedInstanced,
+    d3d12_command_list_Dispatch,
+    d3d12_command_list_CopyBufferRegion,
+    d3d12_command_list_CopyTextureRegion,
+    d3d12_command_list_CopyResource,
+    d3d12_command_list_CopyTiles,
+    d3d12_command_list_ResolveSubresource,
+    d3d12_command_list_IASetPrimitiveTopology,
+    d3d12_command_list_RSSetViewports,
+    d3d12_command_list_RSSetScissorRects,
+    d3d12_command_list_OMSetBlendFactor,
+    d3d12_command_list_OMSetStencilRef,
+    d3d12_command_list_SetPipelineState,
+    d3d12_command_list_ResourceBarrier,
+    d3d12_command_list_ExecuteBundle,
+    d3d12_command_list_SetDescriptorHeaps,
+    d3d12_command_list_SetComputeRootSignature,
+    d3d12_command_list_SetGraphicsRootSignature,
+    d3d12_command_list_SetComputeRootDescriptorTable,
+    d3d12_command_list_SetGraphicsRootDescriptorTable,
+    d3d12_command_list_SetComputeRoot32BitConstant,
+    d3d12_command_list_SetGraphicsRoot32BitConstant,
+    d3d12_command_list_SetComputeRoot32BitConstants,
+    d3d12_command_list_SetGraphicsRoot32BitConstants,
+    d3d12_command_list_SetComputeRootConstantBufferView,
+    d3d12_command_list_SetGraphicsRootConstantBufferView,
+    d3d12_command_list_SetComputeRootShaderResourceView,
+    d3d12_command_list_SetGraphicsRootShaderResourceView,
+    d3d12_command_list_SetComputeRootUnorderedAccessView,
+    d3d12_command_list_SetGraphicsRootUnorderedAccessView,
+    d3d12_command_list_IASetIndexBuffer,
+    d3d12_command_list_IASetVertexBuffers,
+    d3d12_command_list_SOSetTargets,
+    d3d12_command_list_OMSetRenderTargets,
+    d3d12_command_list_ClearDepthStencilView,
+    d3d12_command_list_ClearRenderTargetView,
+    d3d12_command_list_ClearUnorderedAccessViewUint,
+    d3d12_command_list_ClearUnorderedAccessViewFloat,
+    d3d12_command_list_DiscardResource,
+    d3d12_command_list_BeginQuery,
+    d3d12_command_list_EndQuery,
+    d3d12_command_list_ResolveQueryData,
+    d3d12_command_list_SetPredication,
+    d3d12_command_list_SetMarker,
+    d3d12_command_list_BeginEvent,
+    d3d12_command_list_EndEvent,
+    d3d12_command_list_ExecuteIndirect,
+    /* ID3D12GraphicsCommandList1 methods */
+    d3d12_command_list_AtomicCopyBufferUINT,
+    d3d12_command_list_AtomicCopyBufferUINT64,
+    d3d12_command_list_OMSetDepthBounds,
+    d3d12_command_list_SetSamplePositions,
+    d3d12_command_list_ResolveSubresourceRegion,
+    d3d12_command_list_SetViewInstanceMask,
+    /* ID3D12GraphicsCommandList2 methods */
+    d3d12_command_list_WriteBufferImmediate,
+    /* ID3D12GraphicsCommandList3 methods */
+    d3d12_command_list_SetProtectedResourceSession,
+    /* ID3D12GraphicsCommandList4 methods */
+    d3d12_command_list_BeginRenderPass,
+    d3d12_command_list_EndRenderPass,
+    d3d12_command_list_InitializeMetaCommand,
+    d3d12_command_list_ExecuteMetaCommand,
+    d3d12_command_list_BuildRaytracingAccelerationStructure,
+    d3d12_command_list_EmitRaytracingAccelerationStructurePostbuildInfo,
+    d3d12_command_list_CopyRaytracingAccelerationStructure,
+    d3d12_command_list_SetPipelineState1,
+    d3d12_command_list_DispatchRays,
+    /* ID3D12GraphicsCommandList5 methods */
+    d3d12_command_list_RSSetShadingRate,
+    d3d12_command_list_RSSetShadingRateImage,
+    /* ID3D12GraphicsCommandList6 methods */
+    d3d12_command_list_DispatchMesh,
+    /* ID3D12GraphicsCommandList7 methods */
+    d3d12_command_list_Barrier,
+};
+
+#ifdef VKD3D_ENABLE_PROFILING
+#include "command_list_profiled.h"
+#endif
 
 static struct d3d12_command_list *unsafe_impl_from_ID3D12CommandList(ID3D12CommandList *iface)
 {
@@ -9748,9 +11204,23 @@ static ULONG STDMETHODCALLTYPE d3d12_command_queue_Release(ID3D12CommandQueue *i
         vkd3d_private_store_destroy(&command_queue->private_store);
 
         d3d12_command_queue_submit_stop(command_queue);
-        vkd3d_fence_worker_stop(&command_queue->fence_worker, device);
+
+        pthread_mutex_lock(&command_queue->queue_lock);
+        while (!command_queue->is_stopped)
+            pthread_cond_wait(&command_queue->queue_cond, &command_queue->queue_lock);
+        pthread_mutex_unlock(&command_queue->queue_lock);
+
+        TRACE("Folded %"PRIu64" queue submissions into ExecuteCommandLists.\n",
+                command_queue->folded_submit_count);
+
+        d3d12_command_queue_transition_pool_deinit(command_queue->transition_pool, device);
+        vkd3d_free(command_queue->transition_pool);
+        vkd3d_free(command_queue->pending_waits.fences);
+        vkd3d_free(command_queue->pending_waits.semaphores);
+        vkd3d_free(command_queue->pending_waits.values);
+        vkd3d_free(command_queue->pending_waits.stages);
+        vkd3d_free(command_queue->held_vk_queues);
         d3d12_device_unmap_vkd3d_queue(device, command_queue->vkd3d_queue);
-        pthread_join(command_queue->submission_thread, NULL);
         pthread_mutex_destroy(&command_queue->queue_lock);
         pthread_cond_destroy(&command_queue->queue_cond);
 
@@ -9846,14 +11316,19 @@ static void STDMETHODCALLTYPE d3d12_command_queue_UpdateTileMappings(ID3D12Comma
     unsigned int region_tile = 0, region_idx = 0, range_tile = 0, range_idx = 0;
     struct d3d12_resource *res = impl_from_ID3D12Resource(resource);
     struct d3d12_heap *memory_heap = impl_from_ID3D12Heap(heap);
-    struct vkd3d_sparse_memory_bind *bind, **bound_tiles;
     struct d3d12_sparse_info *sparse = &res->sparse;
     D3D12_TILED_RESOURCE_COORDINATE region_coord;
     struct d3d12_command_queue_submission sub;
+    struct vkd3d_sparse_memory_bind *bind;
     D3D12_TILE_REGION_SIZE region_size;
     D3D12_TILE_RANGE_FLAGS range_flag;
     UINT range_size, range_offset;
-    size_t bind_infos_size = 0;
+    struct vkd3d_tile_map mappings;
+    const struct vkd3d_tile_run *run;
+    VkDeviceMemory vk_memory;
+    VkDeviceSize vk_offset;
+    unsigned int count;
+    size_t i;
 
     TRACE("iface %p, resource %p, region_count %u, region_coords %p, "
             "region_sizes %p, heap %p, range_count %u, range_flags %p, heap_range_offsets %p, "
@@ -9896,12 +11371,10 @@ static void STDMETHODCALLTYPE d3d12_command_queue_UpdateTileMappings(ID3D12Comma
     range_size = ~0u;
     range_offset = 0;
 
-    if (!(bound_tiles = vkd3d_calloc(sparse->tile_count, sizeof(*bound_tiles))))
-    {
-        ERR("Failed to allocate tile mapping table.\n");
-        return;
-    }
-
+    /* Later mappings override earlier ones for the same tile. Collect the mappings
+     * as runs of tiles, so that the cost only depends on the number of ranges. */
+    vkd3d_tile_map_init(&mappings, VKD3D_TILE_SIZE);
+
     while (region_idx < region_count && range_idx < range_count)
     {
         if (range_tile == 0)
@@ -9925,61 +11398,91 @@ static void STDMETHODCALLTYPE d3d12_command_queue_UpdateTileMappings(ID3D12Comma
                 region_size = region_sizes[region_idx];
         }
 
-        if (range_flag != D3D12_TILE_RANGE_FLAG_SKIP)
+        if (!range_size)
         {
-            unsigned int tile_index = vkd3d_get_tile_index_from_region(sparse, &region_coord, &region_size, region_tile);
+            range_idx += 1;
+            continue;
+        }
 
-            if (!(bind = bound_tiles[tile_index]))
-            {
-                if (!vkd3d_array_reserve((void **)&sub.bind_sparse.bind_infos, &bind_infos_size,
-                        sub.bind_sparse.bind_count + 1, sizeof(*sub.bind_sparse.bind_infos)))
-                {
-                    ERR("Failed to allocate bind info array.\n");
-                    goto fail;
-                }
+        if (!region_size.NumTiles)
+        {
+            region_idx += 1;
+            continue;
+        }
 
-                bind = &sub.bind_sparse.bind_infos[sub.bind_sparse.bind_count++];
-                bound_tiles[tile_index] = bind;
-            }
+        /* Process as many tiles as possible at once. Within a box, only tiles
+         * in the same row are guaranteed to have consecutive tile indices. */
+        count = min(range_size - range_tile, region_size.NumTiles - region_tile);
+
+        if (region_size.UseBox)
+            count = min(count, region_size.Width - region_tile % region_size.Width);
+
+        if (range_flag == D3D12_TILE_RANGE_FLAG_REUSE_SINGLE_TILE)
+            count = 1;
 
-            bind->dst_tile = tile_index;
-            bind->src_tile = 0;
+        if (range_flag != D3D12_TILE_RANGE_FLAG_SKIP)
+        {
+            unsigned int tile_index = vkd3d_get_tile_index_from_region(sparse, &region_coord, &region_size, region_tile);
 
             if (range_flag == D3D12_TILE_RANGE_FLAG_NULL)
             {
-                bind->vk_memory = VK_NULL_HANDLE;
-                bind->vk_offset = 0;
+                vk_memory = VK_NULL_HANDLE;
+                vk_offset = 0;
             }
             else
             {
-                bind->vk_memory = memory_heap->allocation.device_allocation.vk_memory;
-                bind->vk_offset = memory_heap->allocation.offset + VKD3D_TILE_SIZE * range_offset;
+                vk_memory = memory_heap->allocation.device_allocation.vk_memory;
+                vk_offset = memory_heap->allocation.offset + VKD3D_TILE_SIZE * range_offset;
 
                 if (range_flag != D3D12_TILE_RANGE_FLAG_REUSE_SINGLE_TILE)
-                    bind->vk_offset += VKD3D_TILE_SIZE * range_tile;
+                    vk_offset += VKD3D_TILE_SIZE * range_tile;
+            }
+
+            if (!vkd3d_tile_map_set(&mappings, tile_index, count, (uint64_t)vk_memory, vk_offset))
+            {
+                ERR("Failed to allocate tile mappings.\n");
+                goto fail;
             }
         }
 
-        if (++range_tile == range_size)
+        if ((range_tile += count) == range_size)
         {
             range_idx += 1;
             range_tile = 0;
         }
 
-        if (++region_tile == region_size.NumTiles)
+        if ((region_tile += count) == region_size.NumTiles)
         {
             region_idx += 1;
             region_tile = 0;
         }
     }
 
-    vkd3d_free(bound_tiles);
+    if (mappings.run_count && !(sub.bind_sparse.bind_infos =
+            vkd3d_malloc(mappings.run_count * sizeof(*sub.bind_sparse.bind_infos))))
+    {
+        ERR("Failed to allocate bind info array.\n");
+        goto fail;
+    }
+
+    for (i = 0; i < mappings.run_count; i++)
+    {
+        run = &mappings.runs[i];
+        bind = &sub.bind_sparse.bind_infos[i];
+        bind->dst_tile = run->tile_index;
+        bind->src_tile = 0;
+        bind->tile_count = run->tile_count;
+        bind->vk_memory = (VkDeviceMemory)run->memory;
+        bind->vk_offset = run->offset;
+    }
+
+    sub.bind_sparse.bind_count = mappings.run_count;
+    vkd3d_tile_map_cleanup(&mappings);
     d3d12_command_queue_add_submission(command_queue, &sub);
     return;
 
 fail:
-    vkd3d_free(bound_tiles);
-    vkd3d_free(sub.bind_sparse.bind_infos);
+    vkd3d_tile_map_cleanup(&mappings);
 }
 
 static void STDMETHODCALLTYPE d3d12_command_queue_CopyTileMappings(ID3D12CommandQueue *iface,
@@ -9992,7 +11495,8 @@ static void STDMETHODCALLTYPE d3d12_command_queue_CopyTileMappings(ID3D12Command
     struct d3d12_resource *src_res = impl_from_ID3D12Resource(src_resource);
     struct d3d12_command_queue_submission sub;
     struct vkd3d_sparse_memory_bind *bind;
-    unsigned int i;
+    size_t bind_infos_size = 0;
+    unsigned int i, count;
 
     TRACE("iface %p, dst_resource %p, dst_region_start_coordinate %p, "
             "src_resource %p, src_region_start_coordinate %p, region_size %p, flags %#x.\n",
@@ -10001,22 +11505,31 @@ static void STDMETHODCALLTYPE d3d12_command_queue_CopyTileMappings(ID3D12Command
 
     sub.type = VKD3D_SUBMISSION_BIND_SPARSE;
     sub.bind_sparse.mode = VKD3D_SPARSE_MEMORY_BIND_MODE_COPY;
-    sub.bind_sparse.bind_count = region_size->NumTiles;
-    sub.bind_sparse.bind_infos = vkd3d_malloc(region_size->NumTiles * sizeof(*sub.bind_sparse.bind_infos));
+    sub.bind_sparse.bind_count = 0;
+    sub.bind_sparse.bind_infos = NULL;
     sub.bind_sparse.dst_resource = dst_res;
     sub.bind_sparse.src_resource = src_res;
 
-    if (!sub.bind_sparse.bind_infos)
+    for (i = 0; i < region_size->NumTiles; i += count)
     {
-        ERR("Failed to allocate bind info array.\n");
-        return;
-    }
+        /* Tiles within one row of a box have consecutive tile indices */
+        count = region_size->NumTiles - i;
 
-    for (i = 0; i < region_size->NumTiles; i++)
-    {
-        bind = &sub.bind_sparse.bind_infos[i];
+        if (region_size->UseBox)
+            count = min(count, region_size->Width - i % region_size->Width);
+
+        if (!vkd3d_array_reserve((void **)&sub.bind_sparse.bind_infos, &bind_infos_size,
+                sub.bind_sparse.bind_count + 1, sizeof(*sub.bind_sparse.bind_infos)))
+        {
+            ERR("Failed to allocate bind info array.\n");
+            vkd3d_free(sub.bind_sparse.bind_infos);
+            return;
+        }
+
+        bind = &sub.bind_sparse.bind_infos[sub.bind_sparse.bind_count++];
         bind->dst_tile = vkd3d_get_tile_index_from_region(&dst_res->sparse, dst_region_start_coordinate, region_size, i);
         bind->src_tile = vkd3d_get_tile_index_from_region(&src_res->sparse, src_region_start_coordinate, region_size, i);
+        bind->tile_count = count;
         bind->vk_memory = VK_NULL_HANDLE;
         bind->vk_offset = 0;
     }
@@ -10028,18 +11541,22 @@ static void STDMETHODCALLTYPE d3d12_command_queue_ExecuteCommandLists(ID3D12Comm
         UINT command_list_count, ID3D12CommandList * const *command_lists)
 {
     struct d3d12_command_queue *command_queue = impl_from_ID3D12CommandQueue(iface);
+    size_t num_transitions, num_command_buffers, num_dsv_boundaries;
+    struct d3d12_command_queue_dsv_boundary *dsv_boundary;
     struct vkd3d_initial_transition *transitions;
-    size_t num_transitions, num_command_buffers;
     struct d3d12_command_queue_submission sub;
     struct d3d12_command_list *cmd_list;
     VkCommandBuffer *buffers;
     LONG **outstanding;
-    unsigned int i, j;
+    unsigned int i, j, k;
+    UINT cmd_begin;
     HRESULT hr;
 
     TRACE("iface %p, command_list_count %u, command_lists %p.\n",
             iface, command_list_count, command_lists);
 
+    vkd3d_vk_call_profiling_sample("ExecuteCommandLists");
+
     if (!command_list_count)
         return;
 
@@ -10052,6 +11569,7 @@ static void STDMETHODCALLTYPE d3d12_command_queue_ExecuteCommandLists(ID3D12Comm
     }
 
     num_command_buffers = command_list_count + 1;
+    num_dsv_boundaries = 0;
 
     for (i = 0; i < command_list_count; ++i)
     {
@@ -10065,6 +11583,7 @@ static void STDMETHODCALLTYPE d3d12_command_queue_ExecuteCommandLists(ID3D12Comm
 
         if (cmd_list->vk_init_commands)
             num_command_buffers++;
+        num_dsv_boundaries += cmd_list->dsv_boundary_layout_count;
     }
 
     if (!(buffers = vkd3d_calloc(num_command_buffers, sizeof(*buffers))))
@@ -10080,6 +11599,21 @@ static void STDMETHODCALLTYPE d3d12_command_queue_ExecuteCommandLists(ID3D12Comm
         return;
     }
 
+    if (num_dsv_boundaries)
+    {
+        if (!(sub.execute.dsv_boundaries = vkd3d_malloc(num_dsv_boundaries * sizeof(*sub.execute.dsv_boundaries))))
+        {
+            ERR("Failed to allocate DSV boundary array.\n");
+            vkd3d_free(outstanding);
+            vkd3d_free(buffers);
+            return;
+        }
+    }
+    else
+        sub.execute.dsv_boundaries = NULL;
+    sub.execute.dsv_boundary_count = num_dsv_boundaries;
+    dsv_boundary = sub.execute.dsv_boundaries;
+
     sub.execute.debug_capture = false;
 
     num_transitions = 0;
@@ -10092,6 +11626,7 @@ static void STDMETHODCALLTYPE d3d12_command_queue_ExecuteCommandLists(ID3D12Comm
         {
             d3d12_device_mark_as_removed(command_queue->device, DXGI_ERROR_INVALID_CALL,
                     "Command list %p is in recording state.\n", command_lists[i]);
+            vkd3d_free(sub.execute.dsv_boundaries);
             vkd3d_free(outstanding);
             vkd3d_free(buffers);
             return;
@@ -10102,9 +11637,21 @@ static void STDMETHODCALLTYPE d3d12_command_queue_ExecuteCommandLists(ID3D12Comm
         outstanding[i] = cmd_list->outstanding_submissions_count;
         InterlockedIncrement(outstanding[i]);
 
+        cmd_begin = j;
         if (cmd_list->vk_init_commands)
             buffers[j++] = cmd_list->vk_init_commands;
         buffers[j++] = cmd_list->vk_command_buffer;
+
+        /* Remember which command buffers belong to the list so that boundary
+         * layout transitions can be spliced around them at submit time. */
+        for (k = 0; k < cmd_list->dsv_boundary_layout_count; k++)
+        {
+            dsv_boundary->layout = cmd_list->dsv_boundary_layouts[k];
+            dsv_boundary->cmd_begin = cmd_begin;
+            dsv_boundary->cmd_end = j;
+            dsv_boundary++;
+        }
+
         if (cmd_list->debug_capture)
             sub.execute.debug_capture = true;
     }
@@ -10336,19 +11883,157 @@ static CONST_VTBL struct ID3D12CommandQueueVtbl d3d12_command_queue_vtbl =
     d3d12_command_queue_GetDesc,
 };
 
-static void d3d12_command_queue_wait(struct d3d12_command_queue *command_queue,
-        struct d3d12_fence *fence, UINT64 value)
+#ifdef VKD3D_ENABLE_PROFILING
+static uint64_t vkd3d_queue_folded_submit_count;
+static uint64_t vkd3d_queue_fold_count;
+static spinlock_t vkd3d_queue_fold_region_lock;
+static uint32_t vkd3d_queue_fold_region_latch;
+#endif
+
+static void d3d12_command_queue_count_folded_submits(struct d3d12_command_queue *command_queue, uint32_t count)
+{
+#ifdef VKD3D_ENABLE_PROFILING
+    unsigned int index;
+#endif
+
+    if (!count)
+        return;
+
+    command_queue->folded_submit_count += count;
+
+#ifdef VKD3D_ENABLE_PROFILING
+    vkd3d_atomic_uint64_add(&vkd3d_queue_folded_submit_count, count, vkd3d_memory_order_relaxed);
+    vkd3d_atomic_uint64_increment(&vkd3d_queue_fold_count, vkd3d_memory_order_relaxed);
+
+    if (!vkd3d_uses_profiling())
+        return;
+
+    if (!(index = vkd3d_atomic_uint32_load_explicit(&vkd3d_queue_fold_region_latch, vkd3d_memory_order_acquire)))
+    {
+        if (!(index = vkd3d_profiling_register_region("Queue submits folded",
+                &vkd3d_queue_fold_region_lock, &vkd3d_queue_fold_region_latch)))
+            return;
+    }
+
+    vkd3d_profiling_set_counter(index,
+            vkd3d_atomic_uint64_load_explicit(&vkd3d_queue_folded_submit_count, vkd3d_memory_order_relaxed),
+            vkd3d_atomic_uint64_load_explicit(&vkd3d_queue_fold_count, vkd3d_memory_order_relaxed));
+#endif
+}
+
+static void d3d12_command_queue_add_pending_wait(struct d3d12_command_queue *command_queue,
+        struct d3d12_fence *fence, uint64_t physical_value)
+{
+    struct d3d12_command_queue_pending_waits *waits = &command_queue->pending_waits;
+    uint32_t i;
+
+    for (i = 0; i < waits->count; i++)
+    {
+        if (waits->fences[i] == fence)
+        {
+            if (waits->values[i] < physical_value)
+                waits->values[i] = physical_value;
+            waits->submission_count++;
+            return;
+        }
+    }
+
+    if (!vkd3d_array_reserve((void **)&waits->fences, &waits->fences_size,
+            waits->count + 1, sizeof(*waits->fences)) ||
+        !vkd3d_array_reserve((void **)&waits->semaphores, &waits->semaphores_size,
+            waits->count + 1, sizeof(*waits->semaphores)) ||
+        !vkd3d_array_reserve((void **)&waits->values, &waits->values_size,
+            waits->count + 1, sizeof(*waits->values)) ||
+        !vkd3d_array_reserve((void **)&waits->stages, &waits->stages_size,
+            waits->count + 1, sizeof(*waits->stages)))
+    {
+        ERR("Failed to add pending wait to queue %p.\n", command_queue);
+        return;
+    }
+
+    /* Keeps the timeline semaphore alive until the wait has been submitted. */
+    d3d12_fence_inc_ref(fence);
+
+    waits->fences[waits->count] = fence;
+    waits->semaphores[waits->count] = fence->timeline_semaphore;
+    waits->values[waits->count] = physical_value;
+    waits->stages[waits->count] = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    waits->count++;
+    waits->submission_count++;
+}
+
+/* Called once the pending waits are part of a submission. Each Wait() which
+ * did not get a vkQueueSubmit of its own counts as a folded submit. */
+static void d3d12_command_queue_clear_pending_waits(struct d3d12_command_queue *command_queue,
+        uint32_t submit_count)
+{
+    struct d3d12_command_queue_pending_waits *waits = &command_queue->pending_waits;
+    uint32_t i;
+
+    for (i = 0; i < waits->count; i++)
+        d3d12_fence_dec_ref(waits->fences[i]);
+
+    if (waits->submission_count > submit_count)
+        d3d12_command_queue_count_folded_submits(command_queue, waits->submission_count - submit_count);
+
+    waits->count = 0;
+    waits->submission_count = 0;
+}
+
+/* Submits pending waits on their own, for when the next operation on the
+ * queue cannot absorb them. */
+static void d3d12_command_queue_flush_pending_waits(struct d3d12_command_queue *command_queue)
 {
-    const VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    struct d3d12_command_queue_pending_waits *waits = &command_queue->pending_waits;
+    const struct vkd3d_vk_device_procs *vk_procs = &command_queue->device->vk_procs;
     VkTimelineSemaphoreSubmitInfoKHR timeline_submit_info;
-    const struct vkd3d_vk_device_procs *vk_procs;
     struct vkd3d_queue *queue;
     VkSubmitInfo submit_info;
-    uint64_t wait_count;
-    VkQueue vk_queue;
     VkResult vr;
 
-    vk_procs = &command_queue->device->vk_procs;
+    if (!waits->count)
+        return;
+
+    queue = command_queue->vkd3d_queue;
+
+    TRACE("queue %p, wait_count %u.\n", command_queue, waits->count);
+
+    timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timeline_submit_info.pNext = NULL;
+    timeline_submit_info.waitSemaphoreValueCount = waits->count;
+    timeline_submit_info.pWaitSemaphoreValues = waits->values;
+    timeline_submit_info.signalSemaphoreValueCount = 0;
+    timeline_submit_info.pSignalSemaphoreValues = NULL;
+
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.pNext = &timeline_submit_info;
+    submit_info.waitSemaphoreCount = waits->count;
+    submit_info.pWaitSemaphores = waits->semaphores;
+    submit_info.pWaitDstStageMask = waits->stages;
+    submit_info.commandBufferCount = 0;
+    submit_info.pCommandBuffers = NULL;
+    submit_info.signalSemaphoreCount = 0;
+    submit_info.pSignalSemaphores = NULL;
+
+    /* The worker holds the queue, see d3d12_command_queue_acquire_vk_queues(). */
+    vr = VK_CALL(vkQueueSubmit(queue->vk_queue, 1, &submit_info, VK_NULL_HANDLE));
+
+    if (vr < 0)
+    {
+        ERR("Failed to submit wait operation, vr %d.\n", vr);
+    }
+
+    d3d12_command_queue_clear_pending_waits(command_queue, 1);
+}
+
+/* Returns false if the queue was parked on the fence instead. Waits which need a
+ * semaphore are not submitted here, but added to the queue's pending waits. */
+static bool d3d12_command_queue_wait(struct d3d12_command_queue *command_queue,
+        struct d3d12_fence *fence, UINT64 value)
+{
+    struct vkd3d_queue *queue;
+    uint64_t wait_count;
+
     queue = command_queue->vkd3d_queue;
 
     d3d12_fence_lock(fence);
@@ -10357,15 +12042,21 @@ static void d3d12_command_queue_wait(struct d3d12_command_queue *command_queue,
      * Normally we would be able to submit waits and signals out of order,
      * but we don't have virtualized queues in Vulkan, so we need to handle the case
      * where multiple queues alias over the same physical queue, so effectively, we need to manage out-of-order submits
-     * ourselves. */
-    d3d12_fence_block_until_pending_value_reaches_locked(fence, value);
+     * ourselves. Rather than blocking a pool thread, the queue is parked on the fence
+     * and rescheduled once a signal for the value has been submitted. */
+    if (value > fence->max_pending_virtual_timeline_value &&
+            d3d12_fence_park_queue_locked(fence, command_queue, value))
+    {
+        d3d12_fence_unlock(fence);
+        return false;
+    }
 
     /* If a host signal unblocked us, or we know that the fence has reached a specific value, there is no need
      * to queue up a wait. */
     if (d3d12_fence_can_elide_wait_semaphore_locked(fence, value, queue))
     {
         d3d12_fence_unlock(fence);
-        return;
+        return true;
     }
 
     TRACE("queue %p, fence %p, value %#"PRIx64".\n", command_queue, fence, value);
@@ -10373,43 +12064,30 @@ static void d3d12_command_queue_wait(struct d3d12_command_queue *command_queue,
     wait_count = d3d12_fence_get_physical_wait_value_locked(fence, value);
 
     /* We can unlock the fence here. The queue semaphore will not be signalled to signal_value
-     * until we have submitted, so the semaphore cannot be destroyed before the call to vkQueueSubmit. */
+     * until we have submitted, and the pending wait holds a reference to the fence. */
     d3d12_fence_unlock(fence);
 
     assert(fence->timeline_semaphore);
-    timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
-    timeline_submit_info.pNext = NULL;
-    timeline_submit_info.waitSemaphoreValueCount = 1;
-    timeline_submit_info.pWaitSemaphoreValues = &wait_count;
-    timeline_submit_info.signalSemaphoreValueCount = 0;
-    timeline_submit_info.pSignalSemaphoreValues = NULL;
-
-    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.pNext = &timeline_submit_info;
-    submit_info.waitSemaphoreCount = 1;
-    submit_info.pWaitSemaphores = &fence->timeline_semaphore;
-    submit_info.pWaitDstStageMask = &wait_stage_mask;
-    submit_info.commandBufferCount = 0;
-    submit_info.pCommandBuffers = NULL;
-    submit_info.signalSemaphoreCount = 0;
-    submit_info.pSignalSemaphores = NULL;
-
-    if (!(vk_queue = vkd3d_queue_acquire(queue)))
-    {
-        ERR("Failed to acquire queue %p.\n", queue);
-        return;
-    }
+    d3d12_command_queue_add_pending_wait(command_queue, fence, wait_count);
+    return true;
+}
 
-    vr = VK_CALL(vkQueueSubmit(vk_queue, 1, &submit_info, VK_NULL_HANDLE));
+/* Hands a submitted signal over to the fence worker. */
+static void d3d12_command_queue_enqueue_signal(struct d3d12_command_queue *command_queue,
+        struct d3d12_fence *fence, uint64_t physical_value)
+{
+    struct d3d12_device *device = command_queue->device;
+    HRESULT hr;
 
-    vkd3d_queue_release(queue);
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
 
-    if (vr < 0)
+    if (FAILED(hr = vkd3d_enqueue_timeline_semaphore(&device->fence_worker, fence,
+            physical_value, command_queue->vkd3d_queue)))
     {
-        ERR("Failed to submit wait operation, vr %d.\n", vr);
+        /* In case of an unexpected failure, try to safely destroy Vulkan objects.
+         * The worker holds the queue. */
+        VK_CALL(vkQueueWaitIdle(command_queue->vkd3d_queue->vk_queue));
     }
-
-    /* We should probably trigger DEVICE_REMOVED if we hit any errors in the submission thread. */
 }
 
 static void d3d12_command_queue_signal(struct d3d12_command_queue *command_queue,
@@ -10422,9 +12100,7 @@ static void d3d12_command_queue_signal(struct d3d12_command_queue *command_queue
     VkSubmitInfo submit_info;
     uint64_t physical_value;
     uint64_t signal_value;
-    VkQueue vk_queue;
     VkResult vr;
-    HRESULT hr;
 
     device = command_queue->device;
     vk_procs = &device->vk_procs;
@@ -10457,37 +12133,160 @@ static void d3d12_command_queue_signal(struct d3d12_command_queue *command_queue
     submit_info.signalSemaphoreCount = 1;
     submit_info.pSignalSemaphores = &fence->timeline_semaphore;
 
-    if (!(vk_queue = vkd3d_queue_acquire(vkd3d_queue)))
-    {
-        ERR("Failed to acquire queue %p.\n", vkd3d_queue);
-        d3d12_fence_unlock(fence);
-        return;
-    }
-
-    vr = VK_CALL(vkQueueSubmit(vk_queue, 1, &submit_info, VK_NULL_HANDLE));
+    vr = VK_CALL(vkQueueSubmit(vkd3d_queue->vk_queue, 1, &submit_info, VK_NULL_HANDLE));
 
     if (vr == VK_SUCCESS)
         d3d12_fence_update_pending_value_locked(fence);
     d3d12_fence_unlock(fence);
 
-    vkd3d_queue_release(vkd3d_queue);
-
     if (vr < 0)
     {
         ERR("Failed to submit signal operation, vr %d.\n", vr);
         return;
     }
 
-    if (FAILED(hr = vkd3d_enqueue_timeline_semaphore(&command_queue->fence_worker, fence, physical_value, vkd3d_queue)))
+    d3d12_command_queue_enqueue_signal(command_queue, fence, physical_value);
+
+    /* We should probably trigger DEVICE_REMOVED if we hit any errors in the submission thread. */
+}
+
+#define VKD3D_COMMAND_QUEUE_NUM_TRANSITION_BUFFERS 16
+
+/* Command buffers for releasing queue family ownership, recorded by the acquiring
+ * queue and submitted to the queue which used the resource last. */
+struct d3d12_command_queue_release_pool
+{
+    uint32_t vk_family_index;
+    VkCommandPool pool;
+    VkCommandBuffer cmd[VKD3D_COMMAND_QUEUE_NUM_TRANSITION_BUFFERS];
+    uint64_t cmd_timeline_values[VKD3D_COMMAND_QUEUE_NUM_TRANSITION_BUFFERS];
+    unsigned int cmd_count;
+};
+
+struct d3d12_command_queue_ownership_release
+{
+    struct vkd3d_queue *queue;
+    VkImageMemoryBarrier barrier;
+};
+
+/* Layout a DSV resource is in at the current point of a submission. */
+struct d3d12_command_queue_dsv_state
+{
+    struct d3d12_resource *resource;
+    /* Layout the submission found the resource in. */
+    uint32_t entry_plane_optimal_mask;
+    uint32_t plane_optimal_mask;
+    /* Last command list in the submission which used the resource, NULL if
+     * the layout was left by an earlier submission. */
+    struct d3d12_command_queue_dsv_boundary *last_boundary;
+};
+
+static struct vkd3d_queue *d3d12_command_queue_get_sparse_queue(struct d3d12_command_queue *command_queue)
+{
+    /* Ensure that we use a queue that supports sparse binding */
+    if (!(command_queue->vkd3d_queue->vk_queue_flags & VK_QUEUE_SPARSE_BINDING_BIT))
+        return command_queue->device->queue_families[VKD3D_QUEUE_FAMILY_SPARSE_BINDING]->queues[0];
+    else
+        return command_queue->vkd3d_queue;
+}
+
+static bool d3d12_command_queue_holds_vk_queue(const struct d3d12_command_queue *command_queue,
+        const struct vkd3d_queue *queue)
+{
+    size_t i;
+
+    for (i = 0; i < command_queue->held_vk_queue_count; i++)
+    {
+        if (command_queue->held_vk_queues[i] == queue)
+            return true;
+    }
+
+    return false;
+}
+
+static bool d3d12_command_queue_add_held_vk_queue(struct d3d12_command_queue *command_queue,
+        struct vkd3d_queue *queue)
+{
+    if (!queue || d3d12_command_queue_holds_vk_queue(command_queue, queue))
+        return true;
+
+    if (!vkd3d_array_reserve((void **)&command_queue->held_vk_queues, &command_queue->held_vk_queues_size,
+            command_queue->held_vk_queue_count + 1, sizeof(*command_queue->held_vk_queues)))
+        return false;
+
+    command_queue->held_vk_queues[command_queue->held_vk_queue_count++] = queue;
+    return true;
+}
+
+static void d3d12_command_queue_release_vk_queues(struct d3d12_command_queue *command_queue)
+{
+    while (command_queue->held_vk_queue_count)
+        vkd3d_queue_release(command_queue->held_vk_queues[--command_queue->held_vk_queue_count]);
+}
+
+/* Locks every Vulkan queue the submission is going to use. Pool workers must not block
+ * on a queue which is in use by another worker or by an external user, so if any of
+ * the queues is busy, nothing is held and the command queue is rescheduled once that
+ * queue is released. Queues are collected first and locked in a single pass, a worker
+ * never holds one queue while waiting on another. */
+static bool d3d12_command_queue_acquire_vk_queues(struct d3d12_command_queue *command_queue,
+        const struct d3d12_command_queue_submission *submission)
+{
+    const struct vkd3d_initial_transition *transition;
+    struct d3d12_resource *resource;
+    size_t i, held_count;
+
+    assert(!command_queue->held_vk_queue_count);
+
+    /* Space for these is reserved on creation. */
+    d3d12_command_queue_add_held_vk_queue(command_queue, command_queue->vkd3d_queue);
+
+    if (submission->type == VKD3D_SUBMISSION_BIND_SPARSE)
+    {
+        d3d12_command_queue_add_held_vk_queue(command_queue,
+                d3d12_command_queue_get_sparse_queue(command_queue));
+    }
+    else if (submission->type == VKD3D_SUBMISSION_EXECUTE)
+    {
+        /* Queues which have to release ownership of a resource to us. */
+        for (i = 0; i < submission->execute.transition_count; i++)
+        {
+            transition = &submission->execute.transitions[i];
+            if (transition->type != VKD3D_INITIAL_TRANSITION_TYPE_RESOURCE)
+                continue;
+
+            resource = transition->resource.resource;
+            if (!(resource->flags & VKD3D_RESOURCE_EXCLUSIVE_OWNERSHIP))
+                continue;
+
+            /* The release falls back to a blocking acquire for queues which are not held. */
+            if (!d3d12_command_queue_add_held_vk_queue(command_queue,
+                    (struct vkd3d_queue *)vkd3d_queue_ownership_peek_release_queue(&resource->queue_ownership,
+                    command_queue->vkd3d_queue->vk_family_index)))
+            {
+                ERR("Failed to add queue to held queue list.\n");
+                break;
+            }
+        }
+    }
+
+    held_count = command_queue->held_vk_queue_count;
+    command_queue->held_vk_queue_count = 0;
+
+    for (i = 0; i < held_count; i++)
     {
-        /* In case of an unexpected failure, try to safely destroy Vulkan objects. */
-        vkd3d_queue_wait_idle(vkd3d_queue, vk_procs);
+        if (!vkd3d_queue_try_acquire_or_park(command_queue->held_vk_queues[i], command_queue))
+        {
+            d3d12_command_queue_release_vk_queues(command_queue);
+            return false;
+        }
+
+        command_queue->held_vk_queue_count++;
     }
 
-    /* We should probably trigger DEVICE_REMOVED if we hit any errors in the submission thread. */
+    return true;
 }
 
-#define VKD3D_COMMAND_QUEUE_NUM_TRANSITION_BUFFERS 16
 struct d3d12_command_queue_transition_pool
 {
     VkCommandBuffer cmd[VKD3D_COMMAND_QUEUE_NUM_TRANSITION_BUFFERS];
@@ -10495,6 +12294,9 @@ struct d3d12_command_queue_transition_pool
     VkSemaphore timeline;
     uint64_t timeline_value;
 
+    struct d3d12_command_queue *command_queue;
+    struct vkd3d_queue *vkd3d_queue;
+
     VkImageMemoryBarrier *barriers;
     size_t barriers_size;
     size_t barriers_count;
@@ -10502,6 +12304,27 @@ struct d3d12_command_queue_transition_pool
     const struct d3d12_query_heap **query_heaps;
     size_t query_heaps_size;
     size_t query_heaps_count;
+
+    struct d3d12_command_queue_release_pool *release_pools;
+    size_t release_pools_size;
+    size_t release_pools_count;
+    VkSemaphore release_timeline;
+    uint64_t release_timeline_value;
+
+    struct d3d12_command_queue_ownership_release *releases;
+    size_t releases_size;
+    size_t releases_count;
+
+    VkImageMemoryBarrier *release_barriers;
+    size_t release_barriers_size;
+
+    struct d3d12_command_queue_dsv_state *dsv_states;
+    size_t dsv_states_size;
+    size_t dsv_states_count;
+
+    VkImageMemoryBarrier *dsv_barriers;
+    size_t dsv_barriers_size;
+    size_t dsv_barriers_count;
 };
 
 static HRESULT d3d12_command_queue_transition_pool_init(struct d3d12_command_queue_transition_pool *pool,
@@ -10514,13 +12337,15 @@ static HRESULT d3d12_command_queue_transition_pool_init(struct d3d12_command_que
     HRESULT hr;
 
     memset(pool, 0, sizeof(*pool));
+    pool->command_queue = queue;
+    pool->vkd3d_queue = queue->vkd3d_queue;
 
     pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     pool_info.pNext = NULL;
     pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     pool_info.queueFamilyIndex = queue->vkd3d_queue->vk_family_index;
 
-    if ((vr = VK_CALL(vkCreateCommandPool(queue->device->vk_device, &pool_info, NULL, &pool->pool))))
+    if ((vr = VK_CALL(vkCreateCommandPool(queue->device->vk_device, &pool_info, &vkd3d_vk_allocator, &pool->pool))))
         return hresult_from_vk_result(vr);
 
     alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -10529,16 +12354,27 @@ static HRESULT d3d12_command_queue_transition_pool_init(struct d3d12_command_que
     alloc_info.commandBufferCount = VKD3D_COMMAND_QUEUE_NUM_TRANSITION_BUFFERS;
     alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     if ((vr = VK_CALL(vkAllocateCommandBuffers(queue->device->vk_device, &alloc_info, pool->cmd))))
-        return hresult_from_vk_result(vr);
+    {
+        hr = hresult_from_vk_result(vr);
+        goto fail;
+    }
 
     if (FAILED(hr = vkd3d_create_timeline_semaphore(queue->device, 0, &pool->timeline)))
-        return hr;
+        goto fail;
+
+    if (FAILED(hr = vkd3d_create_timeline_semaphore(queue->device, 0, &pool->release_timeline)))
+        goto fail;
 
     return S_OK;
+
+fail:
+    VK_CALL(vkDestroySemaphore(queue->device->vk_device, pool->timeline, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyCommandPool(queue->device->vk_device, pool->pool, &vkd3d_vk_allocator));
+    return hr;
 }
 
-static void d3d12_command_queue_transition_pool_wait(struct d3d12_command_queue_transition_pool *pool,
-        struct d3d12_device *device, uint64_t value)
+static void d3d12_command_queue_transition_pool_wait_semaphore(struct d3d12_device *device,
+        VkSemaphore semaphore, uint64_t value)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     VkSemaphoreWaitInfoKHR wait_info;
@@ -10546,21 +12382,38 @@ static void d3d12_command_queue_transition_pool_wait(struct d3d12_command_queue_
     wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
     wait_info.pNext = NULL;
     wait_info.flags = 0;
-    wait_info.pSemaphores = &pool->timeline;
+    wait_info.pSemaphores = &semaphore;
     wait_info.semaphoreCount = 1;
     wait_info.pValues = &value;
     VK_CALL(vkWaitSemaphoresKHR(device->vk_device, &wait_info, ~(uint64_t)0));
 }
 
+static void d3d12_command_queue_transition_pool_wait(struct d3d12_command_queue_transition_pool *pool,
+        struct d3d12_device *device, uint64_t value)
+{
+    d3d12_command_queue_transition_pool_wait_semaphore(device, pool->timeline, value);
+}
+
 static void d3d12_command_queue_transition_pool_deinit(struct d3d12_command_queue_transition_pool *pool,
         struct d3d12_device *device)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    size_t i;
+
     d3d12_command_queue_transition_pool_wait(pool, device, pool->timeline_value);
-    VK_CALL(vkDestroyCommandPool(device->vk_device, pool->pool, NULL));
-    VK_CALL(vkDestroySemaphore(device->vk_device, pool->timeline, NULL));
+    d3d12_command_queue_transition_pool_wait_semaphore(device, pool->release_timeline, pool->release_timeline_value);
+    VK_CALL(vkDestroyCommandPool(device->vk_device, pool->pool, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroySemaphore(device->vk_device, pool->timeline, &vkd3d_vk_allocator));
+    for (i = 0; i < pool->release_pools_count; i++)
+        VK_CALL(vkDestroyCommandPool(device->vk_device, pool->release_pools[i].pool, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroySemaphore(device->vk_device, pool->release_timeline, &vkd3d_vk_allocator));
     vkd3d_free(pool->barriers);
     vkd3d_free((void*)pool->query_heaps);
+    vkd3d_free(pool->release_pools);
+    vkd3d_free(pool->releases);
+    vkd3d_free(pool->release_barriers);
+    vkd3d_free(pool->dsv_states);
+    vkd3d_free(pool->dsv_barriers);
 }
 
 static void d3d12_command_queue_transition_pool_add_barrier(struct d3d12_command_queue_transition_pool *pool,
@@ -10600,55 +12453,462 @@ static void d3d12_command_queue_transition_pool_add_barrier(struct d3d12_command
           resource, barrier->oldLayout, barrier->newLayout);
 }
 
-static void d3d12_command_queue_transition_pool_add_query_heap(struct d3d12_command_queue_transition_pool *pool,
-            const struct d3d12_query_heap *heap)
-{
-    if (!vkd3d_array_reserve((void**)&pool->query_heaps, &pool->query_heaps_size,
-            pool->query_heaps_count + 1, sizeof(*pool->query_heaps)))
-    {
-        ERR("Failed to allocate query heap list.\n");
-        return;
+static void d3d12_command_queue_transition_pool_add_query_heap(struct d3d12_command_queue_transition_pool *pool,
+            const struct d3d12_query_heap *heap)
+{
+    if (!vkd3d_array_reserve((void**)&pool->query_heaps, &pool->query_heaps_size,
+            pool->query_heaps_count + 1, sizeof(*pool->query_heaps)))
+    {
+        ERR("Failed to allocate query heap list.\n");
+        return;
+    }
+
+    pool->query_heaps[pool->query_heaps_count++] = heap;
+
+    TRACE("Initialization for query heap %p.\n", heap);
+}
+
+static VkImageLayout d3d12_command_queue_transition_pool_get_entry_layout(struct d3d12_command_queue_transition_pool *pool,
+        const struct d3d12_resource *resource)
+{
+    uint32_t plane_optimal_mask;
+    size_t i;
+
+    if (!d3d12_resource_supports_dsv_boundary_layout(resource))
+        return resource->common_layout;
+
+    /* DSV boundary layouts of the submission are resolved first and already
+     * updated the persistent layout, see d3d12_command_queue_transition_pool_build(). */
+    for (i = 0; i < pool->dsv_states_count; i++)
+    {
+        if (pool->dsv_states[i].resource == resource)
+        {
+            return dsv_plane_optimal_mask_to_layout(pool->dsv_states[i].entry_plane_optimal_mask,
+                    resource->format->vk_aspect_mask);
+        }
+    }
+
+    plane_optimal_mask = vkd3d_atomic_uint32_load_explicit(
+            &resource->persistent_dsv_plane_optimal_mask, vkd3d_memory_order_relaxed);
+    return dsv_plane_optimal_mask_to_layout(plane_optimal_mask, resource->format->vk_aspect_mask);
+}
+
+static void d3d12_command_queue_transition_pool_add_ownership_transfer(struct d3d12_command_queue_transition_pool *pool,
+        const struct d3d12_resource *resource, const struct vkd3d_queue_ownership_transfer *transfer)
+{
+    struct d3d12_command_queue_ownership_release *release;
+    VkImageMemoryBarrier *barrier;
+    VkImageLayout layout;
+
+    if (!vkd3d_array_reserve((void**)&pool->barriers, &pool->barriers_size,
+            pool->barriers_count + 1, sizeof(*pool->barriers)) ||
+            !vkd3d_array_reserve((void**)&pool->releases, &pool->releases_size,
+            pool->releases_count + 1, sizeof(*pool->releases)))
+    {
+        ERR("Failed to allocate barriers.\n");
+        return;
+    }
+
+    /* Resources are in their common layout whenever they can be used by another queue type,
+     * see vkd3d_create_image() for the resources which are tracked. The exception are DSV
+     * boundary layouts, which are transferred as is and fixed up after the acquire. */
+    layout = d3d12_command_queue_transition_pool_get_entry_layout(pool, resource);
+    barrier = &pool->barriers[pool->barriers_count++];
+    barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier->pNext = NULL;
+    barrier->srcAccessMask = 0;
+    barrier->dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier->oldLayout = layout;
+    barrier->newLayout = layout;
+    barrier->srcQueueFamilyIndex = transfer->src_family;
+    barrier->dstQueueFamilyIndex = transfer->dst_family;
+    barrier->image = resource->res.vk_image;
+    barrier->subresourceRange.aspectMask = resource->format->vk_aspect_mask;
+    barrier->subresourceRange.baseMipLevel = 0;
+    barrier->subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    barrier->subresourceRange.baseArrayLayer = 0;
+    barrier->subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+    release = &pool->releases[pool->releases_count++];
+    release->queue = (struct vkd3d_queue *)transfer->release_queue;
+    release->barrier = *barrier;
+    release->barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    release->barrier.dstAccessMask = 0;
+
+    TRACE("Transferring ownership of resource %p from queue family %u to %u.\n",
+            resource, transfer->src_family, transfer->dst_family);
+}
+
+static void d3d12_command_queue_transition_pool_track_ownership(struct d3d12_command_queue_transition_pool *pool,
+        struct d3d12_resource *resource, bool discard)
+{
+    struct vkd3d_queue_ownership_transfer transfer;
+    struct vkd3d_queue *queue = pool->vkd3d_queue;
+
+    /* With the initial transition, the previous contents are undefined anyway
+     * and the first queue to use the resource takes ownership implicitly. */
+    if (discard)
+        vkd3d_queue_ownership_reset(&resource->queue_ownership, queue, queue->vk_family_index);
+    else if (vkd3d_queue_ownership_acquire(&resource->queue_ownership, queue, queue->vk_family_index, &transfer))
+        d3d12_command_queue_transition_pool_add_ownership_transfer(pool, resource, &transfer);
+}
+
+static struct d3d12_command_queue_release_pool *d3d12_command_queue_transition_pool_get_release_pool(
+        struct d3d12_command_queue_transition_pool *pool, struct d3d12_device *device, uint32_t vk_family_index)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    struct d3d12_command_queue_release_pool *release_pool;
+    VkCommandBufferAllocateInfo alloc_info;
+    VkCommandPoolCreateInfo pool_info;
+    VkResult vr;
+    size_t i;
+
+    for (i = 0; i < pool->release_pools_count; i++)
+    {
+        if (pool->release_pools[i].vk_family_index == vk_family_index)
+            return &pool->release_pools[i];
+    }
+
+    if (!vkd3d_array_reserve((void**)&pool->release_pools, &pool->release_pools_size,
+            pool->release_pools_count + 1, sizeof(*pool->release_pools)))
+        return NULL;
+
+    release_pool = &pool->release_pools[pool->release_pools_count];
+    memset(release_pool, 0, sizeof(*release_pool));
+    release_pool->vk_family_index = vk_family_index;
+
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.pNext = NULL;
+    pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    pool_info.queueFamilyIndex = vk_family_index;
+
+    if ((vr = VK_CALL(vkCreateCommandPool(device->vk_device, &pool_info, &vkd3d_vk_allocator, &release_pool->pool))))
+    {
+        ERR("Failed to create command pool, vr %d.\n", vr);
+        return NULL;
+    }
+
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.pNext = NULL;
+    alloc_info.commandPool = release_pool->pool;
+    alloc_info.commandBufferCount = VKD3D_COMMAND_QUEUE_NUM_TRANSITION_BUFFERS;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+    if ((vr = VK_CALL(vkAllocateCommandBuffers(device->vk_device, &alloc_info, release_pool->cmd))))
+    {
+        ERR("Failed to allocate command buffers, vr %d.\n", vr);
+        VK_CALL(vkDestroyCommandPool(device->vk_device, release_pool->pool, &vkd3d_vk_allocator));
+        return NULL;
+    }
+
+    pool->release_pools_count++;
+    return release_pool;
+}
+
+static void d3d12_command_queue_transition_pool_submit_release(struct d3d12_command_queue_transition_pool *pool,
+        struct d3d12_device *device, struct vkd3d_queue *queue, uint32_t barrier_count)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    struct d3d12_command_queue_release_pool *release_pool;
+    VkTimelineSemaphoreSubmitInfoKHR timeline_info;
+    VkCommandBufferBeginInfo begin_info;
+    unsigned int command_index;
+    VkSubmitInfo submit_info;
+    VkCommandBuffer cmd;
+    VkQueue vk_queue;
+    VkResult vr;
+
+    if (!(release_pool = d3d12_command_queue_transition_pool_get_release_pool(pool, device, queue->vk_family_index)))
+    {
+        ERR("Failed to get release pool for queue family %u.\n", queue->vk_family_index);
+        return;
+    }
+
+    command_index = release_pool->cmd_count++ % VKD3D_COMMAND_QUEUE_NUM_TRANSITION_BUFFERS;
+    cmd = release_pool->cmd[command_index];
+
+    if (release_pool->cmd_timeline_values[command_index])
+    {
+        d3d12_command_queue_transition_pool_wait_semaphore(device, pool->release_timeline,
+                release_pool->cmd_timeline_values[command_index]);
+    }
+
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.pNext = NULL;
+    begin_info.pInheritanceInfo = NULL;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CALL(vkResetCommandBuffer(cmd, 0));
+    VK_CALL(vkBeginCommandBuffer(cmd, &begin_info));
+    VK_CALL(vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0, 0, NULL, 0, NULL, barrier_count, pool->release_barriers));
+    VK_CALL(vkEndCommandBuffer(cmd));
+
+    release_pool->cmd_timeline_values[command_index] = ++pool->release_timeline_value;
+
+    memset(&timeline_info, 0, sizeof(timeline_info));
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timeline_info.signalSemaphoreValueCount = 1;
+    timeline_info.pSignalSemaphoreValues = &pool->release_timeline_value;
+
+    memset(&submit_info, 0, sizeof(submit_info));
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.pNext = &timeline_info;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &cmd;
+    submit_info.signalSemaphoreCount = 1;
+    submit_info.pSignalSemaphores = &pool->release_timeline;
+
+    /* The release executes after everything the previous owner submitted so far,
+     * which includes the last use of the resources. The worker normally holds the
+     * releasing queue already, see d3d12_command_queue_acquire_vk_queues(). */
+    if (d3d12_command_queue_holds_vk_queue(pool->command_queue, queue))
+        vk_queue = queue->vk_queue;
+    else if (!(vk_queue = vkd3d_queue_acquire(queue)))
+    {
+        ERR("Failed to acquire queue %p.\n", queue);
+        return;
+    }
+    else
+        WARN("Ownership of a resource changed while the submission was scheduled.\n");
+
+    if ((vr = VK_CALL(vkQueueSubmit(vk_queue, 1, &submit_info, VK_NULL_HANDLE))) < 0)
+        ERR("Failed to submit ownership release, vr %d.\n", vr);
+
+    if (!d3d12_command_queue_holds_vk_queue(pool->command_queue, queue))
+        vkd3d_queue_release(queue);
+}
+
+static void d3d12_command_queue_transition_pool_submit_releases(struct d3d12_command_queue_transition_pool *pool,
+        struct d3d12_device *device)
+{
+    struct vkd3d_queue *queue;
+    uint32_t barrier_count;
+    size_t i, j;
+
+    if (!pool->releases_count)
+        return;
+
+    if (!vkd3d_array_reserve((void**)&pool->release_barriers, &pool->release_barriers_size,
+            pool->releases_count, sizeof(*pool->release_barriers)))
+    {
+        ERR("Failed to allocate release barriers.\n");
+        pool->releases_count = 0;
+        return;
+    }
+
+    /* One submission per releasing queue, there are rarely more than a few. */
+    for (i = 0; i < pool->releases_count; i++)
+    {
+        if (!(queue = pool->releases[i].queue))
+            continue;
+
+        for (j = i, barrier_count = 0; j < pool->releases_count; j++)
+        {
+            if (pool->releases[j].queue == queue)
+            {
+                pool->release_barriers[barrier_count++] = pool->releases[j].barrier;
+                pool->releases[j].queue = NULL;
+            }
+        }
+
+        d3d12_command_queue_transition_pool_submit_release(pool, device, queue, barrier_count);
+    }
+
+    /* The acquire barriers are recorded in the transition command buffer. */
+    vkd3d_queue_add_wait_locked(pool->vkd3d_queue, pool->release_timeline,
+            pool->release_timeline_value, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    pool->releases_count = 0;
+}
+
+static void d3d12_command_queue_init_query_heap(struct d3d12_device *device, VkCommandBuffer vk_cmd_buffer,
+        const struct d3d12_query_heap *heap)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    unsigned int i;
+
+    VK_CALL(vkCmdResetQueryPool(vk_cmd_buffer, heap->vk_query_pool, 0, heap->desc.Count));
+
+    for (i = 0; i < heap->desc.Count; i++)
+    {
+        switch (heap->desc.Type)
+        {
+            case D3D12_QUERY_HEAP_TYPE_OCCLUSION:
+            case D3D12_QUERY_HEAP_TYPE_SO_STATISTICS:
+            case D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS:
+                VK_CALL(vkCmdBeginQuery(vk_cmd_buffer, heap->vk_query_pool, i, 0));
+                VK_CALL(vkCmdEndQuery(vk_cmd_buffer, heap->vk_query_pool, i));
+                break;
+
+            case D3D12_QUERY_HEAP_TYPE_TIMESTAMP:
+            case D3D12_QUERY_HEAP_TYPE_COPY_QUEUE_TIMESTAMP:
+                VK_CALL(vkCmdWriteTimestamp(vk_cmd_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        heap->vk_query_pool, i));
+                break;
+
+            default:
+                ERR("Unhandled query pool type %u.\n", heap->desc.Type);
+                return;
+        }
+    }
+}
+
+static struct d3d12_command_queue_dsv_state *d3d12_command_queue_transition_pool_get_dsv_state(
+        struct d3d12_command_queue_transition_pool *pool, struct d3d12_resource *resource)
+{
+    struct d3d12_command_queue_dsv_state *state;
+    size_t i;
+
+    for (i = 0; i < pool->dsv_states_count; i++)
+    {
+        if (pool->dsv_states[i].resource == resource)
+            return &pool->dsv_states[i];
+    }
+
+    if (!vkd3d_array_reserve((void**)&pool->dsv_states, &pool->dsv_states_size,
+            pool->dsv_states_count + 1, sizeof(*pool->dsv_states)))
+    {
+        ERR("Failed to allocate DSV states.\n");
+        return NULL;
+    }
+
+    state = &pool->dsv_states[pool->dsv_states_count++];
+    state->resource = resource;
+    state->entry_plane_optimal_mask = vkd3d_atomic_uint32_load_explicit(
+            &resource->persistent_dsv_plane_optimal_mask, vkd3d_memory_order_relaxed);
+    state->plane_optimal_mask = state->entry_plane_optimal_mask;
+    state->last_boundary = NULL;
+    return state;
+}
+
+static void d3d12_command_queue_transition_pool_add_dsv_barrier(struct d3d12_command_queue_transition_pool *pool,
+        const struct d3d12_resource *resource, uint32_t old_plane_optimal_mask, uint32_t new_plane_optimal_mask)
+{
+    VkImageMemoryBarrier *barrier;
+
+    if (!vkd3d_array_reserve((void**)&pool->dsv_barriers, &pool->dsv_barriers_size,
+            pool->dsv_barriers_count + 1, sizeof(*pool->dsv_barriers)))
+    {
+        ERR("Failed to allocate DSV barriers.\n");
+        return;
+    }
+
+    barrier = &pool->dsv_barriers[pool->dsv_barriers_count++];
+
+    barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier->pNext = NULL;
+    barrier->srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barrier->dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
+    barrier->oldLayout = dsv_plane_optimal_mask_to_layout(old_plane_optimal_mask, resource->format->vk_aspect_mask);
+    barrier->newLayout = dsv_plane_optimal_mask_to_layout(new_plane_optimal_mask, resource->format->vk_aspect_mask);
+    barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->image = resource->res.vk_image;
+    barrier->subresourceRange.aspectMask = resource->format->vk_aspect_mask;
+    barrier->subresourceRange.baseMipLevel = 0;
+    barrier->subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    barrier->subresourceRange.baseArrayLayer = 0;
+    barrier->subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+    TRACE("DSV boundary layout fixup for resource %p (old layout %#x, new layout %#x).\n",
+            resource, barrier->oldLayout, barrier->newLayout);
+}
+
+static void d3d12_command_queue_transition_pool_resolve_dsv_boundaries(struct d3d12_command_queue_transition_pool *pool,
+        struct d3d12_command_queue_submission_execute *execute)
+{
+    struct d3d12_command_queue_dsv_boundary *boundary;
+    struct d3d12_command_queue_dsv_state *state;
+    size_t i, j, begin, end, piece_count;
+    VkCommandBuffer *cmd;
+
+    pool->dsv_states_count = 0;
+    pool->dsv_barriers_count = 0;
+
+    if (!execute->dsv_boundary_count)
+        return;
+
+    /* Command lists leave eligible DSV resources in whatever layout they ended up in.
+     * Walk the submission in order and only emit the decay or promote commands of a command list
+     * when the layout the next command list expects does not match. If the mismatching layout
+     * was left by an earlier submission, fix it up in the transition command buffer instead. */
+    for (i = 0; i < execute->dsv_boundary_count; i++)
+    {
+        boundary = &execute->dsv_boundaries[i];
+
+        if (!(state = d3d12_command_queue_transition_pool_get_dsv_state(pool, boundary->layout.resource)))
+            continue;
+
+        if (state->plane_optimal_mask == boundary->layout.entry_plane_optimal_mask)
+        {
+            if (state->last_boundary)
+                state->last_boundary->layout.vk_decay_commands = VK_NULL_HANDLE;
+            boundary->layout.vk_promote_commands = VK_NULL_HANDLE;
+        }
+        else if (!state->last_boundary)
+        {
+            d3d12_command_queue_transition_pool_add_dsv_barrier(pool, boundary->layout.resource,
+                    state->plane_optimal_mask, boundary->layout.entry_plane_optimal_mask);
+            boundary->layout.vk_promote_commands = VK_NULL_HANDLE;
+        }
+
+        /* Otherwise, keep both the decay of the previous command list and our own promote.
+         * No command list in between touched the resource, so this is equivalent to
+         * decaying in Close(). */
+        state->plane_optimal_mask = boundary->layout.exit_plane_optimal_mask;
+        state->last_boundary = boundary;
     }
 
-    pool->query_heaps[pool->query_heaps_count++] = heap;
+    for (i = 0; i < pool->dsv_states_count; i++)
+    {
+        state = &pool->dsv_states[i];
+        if (state->last_boundary)
+            state->last_boundary->layout.vk_decay_commands = VK_NULL_HANDLE;
+        vkd3d_atomic_uint32_store_explicit(&state->resource->persistent_dsv_plane_optimal_mask,
+                state->plane_optimal_mask, vkd3d_memory_order_relaxed);
+    }
 
-    TRACE("Initialization for query heap %p.\n", heap);
-}
+    for (i = 0, piece_count = 0; i < execute->dsv_boundary_count; i++)
+    {
+        boundary = &execute->dsv_boundaries[i];
+        piece_count += !!boundary->layout.vk_promote_commands + !!boundary->layout.vk_decay_commands;
+    }
 
-static void d3d12_command_queue_init_query_heap(struct d3d12_device *device, VkCommandBuffer vk_cmd_buffer,
-        const struct d3d12_query_heap *heap)
-{
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
-    unsigned int i;
+    if (!piece_count)
+        return;
 
-    VK_CALL(vkCmdResetQueryPool(vk_cmd_buffer, heap->vk_query_pool, 0, heap->desc.Count));
+    if (!(cmd = vkd3d_malloc((execute->cmd_count + piece_count) * sizeof(*cmd))))
+    {
+        ERR("Failed to allocate command buffer array.\n");
+        return;
+    }
 
-    for (i = 0; i < heap->desc.Count; i++)
+    /* Boundaries are sorted by command list, splice the pieces around each list. */
+    for (i = 0, j = 0, begin = 0, end = 0; i < execute->cmd_count; i++)
     {
-        switch (heap->desc.Type)
+        for (; begin < execute->dsv_boundary_count && execute->dsv_boundaries[begin].cmd_begin == i; begin++)
         {
-            case D3D12_QUERY_HEAP_TYPE_OCCLUSION:
-            case D3D12_QUERY_HEAP_TYPE_SO_STATISTICS:
-            case D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS:
-                VK_CALL(vkCmdBeginQuery(vk_cmd_buffer, heap->vk_query_pool, i, 0));
-                VK_CALL(vkCmdEndQuery(vk_cmd_buffer, heap->vk_query_pool, i));
-                break;
+            if (execute->dsv_boundaries[begin].layout.vk_promote_commands)
+                cmd[j++] = execute->dsv_boundaries[begin].layout.vk_promote_commands;
+        }
 
-            case D3D12_QUERY_HEAP_TYPE_TIMESTAMP:
-            case D3D12_QUERY_HEAP_TYPE_COPY_QUEUE_TIMESTAMP:
-                VK_CALL(vkCmdWriteTimestamp(vk_cmd_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                        heap->vk_query_pool, i));
-                break;
+        cmd[j++] = execute->cmd[i];
 
-            default:
-                ERR("Unhandled query pool type %u.\n", heap->desc.Type);
-                return;
+        for (; end < execute->dsv_boundary_count && execute->dsv_boundaries[end].cmd_end == i + 1; end++)
+        {
+            if (execute->dsv_boundaries[end].layout.vk_decay_commands)
+                cmd[j++] = execute->dsv_boundaries[end].layout.vk_decay_commands;
         }
     }
+
+    vkd3d_free(execute->cmd);
+    execute->cmd = cmd;
+    execute->cmd_count = j;
 }
 
 static void d3d12_command_queue_transition_pool_build(struct d3d12_command_queue_transition_pool *pool,
-        struct d3d12_device *device, const struct vkd3d_initial_transition *transitions, size_t count,
+        struct d3d12_device *device, struct d3d12_command_queue_submission_execute *execute,
         VkCommandBuffer *vk_cmd_buffer, uint64_t *timeline_value)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
@@ -10660,16 +12920,19 @@ static void d3d12_command_queue_transition_pool_build(struct d3d12_command_queue
 
     pool->barriers_count = 0;
     pool->query_heaps_count = 0;
+    pool->releases_count = 0;
 
-    if (!count)
+    d3d12_command_queue_transition_pool_resolve_dsv_boundaries(pool, execute);
+
+    if (!execute->transition_count && !pool->dsv_barriers_count)
     {
         *vk_cmd_buffer = VK_NULL_HANDLE;
         return;
     }
 
-    for (i = 0; i < count; i++)
+    for (i = 0; i < execute->transition_count; i++)
     {
-        transition = &transitions[i];
+        transition = &execute->transitions[i];
 
         switch (transition->type)
         {
@@ -10682,6 +12945,9 @@ static void d3d12_command_queue_transition_pool_build(struct d3d12_command_queue
 
                 if (need_transition && transition->resource.perform_initial_transition)
                     d3d12_command_queue_transition_pool_add_barrier(pool, transition->resource.resource);
+
+                if (transition->resource.resource->flags & VKD3D_RESOURCE_EXCLUSIVE_OWNERSHIP)
+                    d3d12_command_queue_transition_pool_track_ownership(pool, transition->resource.resource, need_transition);
                 break;
 
             case VKD3D_INITIAL_TRANSITION_TYPE_QUERY_HEAP:
@@ -10694,7 +12960,9 @@ static void d3d12_command_queue_transition_pool_build(struct d3d12_command_queue
         }
     }
 
-    if (!pool->barriers_count && !pool->query_heaps_count)
+    d3d12_command_queue_transition_pool_submit_releases(pool, device);
+
+    if (!pool->barriers_count && !pool->query_heaps_count && !pool->dsv_barriers_count)
     {
         *vk_cmd_buffer = VK_NULL_HANDLE;
         return;
@@ -10712,9 +12980,20 @@ static void d3d12_command_queue_transition_pool_build(struct d3d12_command_queue
     begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     VK_CALL(vkResetCommandBuffer(pool->cmd[command_index], 0));
     VK_CALL(vkBeginCommandBuffer(pool->cmd[command_index], &begin_info));
-    VK_CALL(vkCmdPipelineBarrier(pool->cmd[command_index],
-            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-            0, 0, NULL, 0, NULL, pool->barriers_count, pool->barriers));
+    if (pool->barriers_count)
+    {
+        /* Ownership acquires have to make the released contents visible to the command lists. */
+        VK_CALL(vkCmdPipelineBarrier(pool->cmd[command_index],
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0, 0, NULL, 0, NULL, pool->barriers_count, pool->barriers));
+    }
+    /* Unlike initial transitions, these have to synchronize with earlier submissions. */
+    if (pool->dsv_barriers_count)
+    {
+        VK_CALL(vkCmdPipelineBarrier(pool->cmd[command_index],
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0, 0, NULL, 0, NULL, pool->dsv_barriers_count, pool->dsv_barriers));
+    }
     for (i = 0; i < pool->query_heaps_count; i++)
         d3d12_command_queue_init_query_heap(device, pool->cmd[command_index], pool->query_heaps[i]);
     VK_CALL(vkEndCommandBuffer(pool->cmd[command_index]));
@@ -10723,18 +13002,21 @@ static void d3d12_command_queue_transition_pool_build(struct d3d12_command_queue
     *timeline_value = pool->timeline_value;
 }
 
+/* Pending waits are attached to the first batch, and an optional signal which
+ * immediately follows the ExecuteCommandLists is folded into the last batch. */
 static void d3d12_command_queue_execute(struct d3d12_command_queue *command_queue,
         VkCommandBuffer *cmd, UINT count,
         VkCommandBuffer transition_cmd, VkSemaphore transition_timeline, uint64_t transition_timeline_value,
-        bool debug_capture)
+        const struct d3d12_command_queue_submission_signal *signal, bool debug_capture)
 {
     static const VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    struct d3d12_command_queue_pending_waits *pending_waits = &command_queue->pending_waits;
     const struct vkd3d_vk_device_procs *vk_procs = &command_queue->device->vk_procs;
     struct vkd3d_queue *vkd3d_queue = command_queue->vkd3d_queue;
     VkTimelineSemaphoreSubmitInfoKHR timeline_submit_info[2];
+    uint64_t signal_value = 0;
     VkSubmitInfo submit_desc[2];
     uint32_t num_submits;
-    VkQueue vk_queue;
     unsigned int i;
     VkResult vr;
 
@@ -10775,10 +13057,29 @@ static void d3d12_command_queue_execute(struct d3d12_command_queue *command_queu
         num_submits = 1;
     }
 
-    if (!(vk_queue = vkd3d_queue_acquire(vkd3d_queue)))
+    if (signal)
     {
-        ERR("Failed to acquire queue %p.\n", vkd3d_queue);
-        return;
+        /* Same locking order as d3d12_command_queue_signal(). The fence lock must be held
+         * until the submit is done so that the semaphore value stays monotonic. */
+        d3d12_fence_lock(signal->fence);
+
+        TRACE("queue %p, fence %p, value %#"PRIx64".\n", command_queue, signal->fence, signal->value);
+
+        signal_value = d3d12_fence_add_pending_signal_locked(signal->fence, signal->value, vkd3d_queue);
+
+        submit_desc[num_submits - 1].signalSemaphoreCount = 1;
+        submit_desc[num_submits - 1].pSignalSemaphores = &signal->fence->timeline_semaphore;
+        timeline_submit_info[num_submits - 1].signalSemaphoreValueCount = 1;
+        timeline_submit_info[num_submits - 1].pSignalSemaphoreValues = &signal_value;
+    }
+
+    /* Must be added while holding the queue, otherwise another command queue
+     * mapped to the same Vulkan queue could consume the waits.
+     * The worker holds the queue, see d3d12_command_queue_acquire_vk_queues(). */
+    for (i = 0; i < pending_waits->count; i++)
+    {
+        vkd3d_queue_add_wait_locked(vkd3d_queue, pending_waits->semaphores[i],
+                pending_waits->values[i], VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
     }
 
     submit_desc[0].waitSemaphoreCount = vkd3d_queue->wait_count;
@@ -10814,7 +13115,7 @@ static void d3d12_command_queue_execute(struct d3d12_command_queue *command_queu
     (void)debug_capture;
 #endif
 
-    if ((vr = VK_CALL(vkQueueSubmit(vk_queue, num_submits, submit_desc, VK_NULL_HANDLE))) < 0)
+    if ((vr = VK_CALL(vkQueueSubmit(vkd3d_queue->vk_queue, num_submits, submit_desc, VK_NULL_HANDLE))) < 0)
         ERR("Failed to submit queue(s), vr %d.\n", vr);
 
 #ifdef VKD3D_ENABLE_RENDERDOC
@@ -10822,51 +13123,89 @@ static void d3d12_command_queue_execute(struct d3d12_command_queue *command_queu
         vkd3d_renderdoc_command_queue_end_capture(command_queue);
 #endif
 
+    if (signal)
+    {
+        if (vr == VK_SUCCESS)
+            d3d12_fence_update_pending_value_locked(signal->fence);
+        d3d12_fence_unlock(signal->fence);
+    }
+
     vkd3d_queue->wait_count = 0;
-    vkd3d_queue_release(vkd3d_queue);
+
+    d3d12_command_queue_clear_pending_waits(command_queue, 0);
+
+    if (signal && vr >= 0)
+    {
+        d3d12_command_queue_count_folded_submits(command_queue, 1);
+        d3d12_command_queue_enqueue_signal(command_queue, signal->fence, signal_value);
+    }
 }
 
-static unsigned int vkd3d_compact_sparse_bind_ranges(const struct d3d12_resource *src_resource,
-        struct vkd3d_sparse_memory_bind_range *bind_ranges, struct vkd3d_sparse_memory_bind *bind_infos,
-        unsigned int count, enum vkd3d_sparse_memory_bind_mode mode, bool can_compact)
+static bool vkd3d_compact_sparse_bind_ranges(const struct d3d12_resource *src_resource,
+        struct vkd3d_sparse_memory_bind_range **bind_ranges, size_t *bind_ranges_size, unsigned int *range_count,
+        const struct vkd3d_sparse_memory_bind *bind_infos, unsigned int count,
+        enum vkd3d_sparse_memory_bind_mode mode, bool can_compact)
 {
     struct vkd3d_sparse_memory_bind_range *range = NULL;
+    uint32_t dst_tile, src_tile, tile_count, n;
     VkDeviceMemory vk_memory;
     VkDeviceSize vk_offset;
-    unsigned int i, j;
+    uint64_t memory;
+    unsigned int i;
 
-    for (i = 0, j = 0; i < count; i++)
+    *range_count = 0;
+
+    for (i = 0; i < count; i++)
     {
-        struct vkd3d_sparse_memory_bind *bind = &bind_infos[i];
+        const struct vkd3d_sparse_memory_bind *bind = &bind_infos[i];
 
-        if (mode == VKD3D_SPARSE_MEMORY_BIND_MODE_UPDATE)
-        {
-            vk_memory = bind->vk_memory;
-            vk_offset = bind->vk_offset;
-        }
-        else /* if (mode == VKD3D_SPARSE_MEMORY_BIND_MODE_COPY) */
-        {
-            struct d3d12_sparse_tile *src_tile = &src_resource->sparse.tiles[bind->src_tile];
-            vk_memory = src_tile->vk_memory;
-            vk_offset = src_tile->vk_offset;
-        }
+        dst_tile = bind->dst_tile;
+        src_tile = bind->src_tile;
+        tile_count = bind->tile_count;
 
-        if (can_compact && range && bind->dst_tile == range->tile_index + range->tile_count && vk_memory == range->vk_memory &&
-                (vk_offset == range->vk_offset + range->tile_count * VKD3D_TILE_SIZE || !vk_memory))
-        {
-            range->tile_count++;
-        }
-        else
+        while (tile_count)
         {
-            range = &bind_ranges[j++];
-            range->tile_index = bind->dst_tile;
-            range->tile_count = 1;
-            range->vk_memory = vk_memory;
-            range->vk_offset = vk_offset;
+            /* Without compaction, every tile gets its own range */
+            n = can_compact ? tile_count : 1;
+
+            if (mode == VKD3D_SPARSE_MEMORY_BIND_MODE_UPDATE)
+            {
+                vk_memory = bind->vk_memory;
+                vk_offset = vk_memory ? bind->vk_offset + (dst_tile - bind->dst_tile) * VKD3D_TILE_SIZE : 0;
+            }
+            else /* if (mode == VKD3D_SPARSE_MEMORY_BIND_MODE_COPY) */
+            {
+                spinlock_acquire(&src_resource->sparse.mappings_lock);
+                n = vkd3d_tile_map_query(&src_resource->sparse.mappings, src_tile, n, &memory, &vk_offset);
+                spinlock_release(&src_resource->sparse.mappings_lock);
+                vk_memory = (VkDeviceMemory)memory;
+            }
+
+            if (can_compact && range && dst_tile == range->tile_index + range->tile_count && vk_memory == range->vk_memory &&
+                    (vk_offset == range->vk_offset + range->tile_count * VKD3D_TILE_SIZE || !vk_memory))
+            {
+                range->tile_count += n;
+            }
+            else
+            {
+                if (!vkd3d_array_reserve((void **)bind_ranges, bind_ranges_size,
+                        *range_count + 1, sizeof(**bind_ranges)))
+                    return false;
+
+                range = &(*bind_ranges)[(*range_count)++];
+                range->tile_index = dst_tile;
+                range->tile_count = n;
+                range->vk_memory = vk_memory;
+                range->vk_offset = vk_offset;
+            }
+
+            dst_tile += n;
+            src_tile += n;
+            tile_count -= n;
         }
     }
 
-    return j;
+    return true;
 }
 
 static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_queue,
@@ -10877,6 +13216,8 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
     const VkPipelineStageFlags wait_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
     struct vkd3d_sparse_memory_bind_range *bind_ranges = NULL;
     unsigned int first_packed_tile, processed_tiles;
+    struct d3d12_sparse_tile tile, last_tile;
+    size_t bind_ranges_size = 0;
     VkSparseImageOpaqueMemoryBindInfo opaque_info;
     const struct vkd3d_vk_device_procs *vk_procs;
     VkSparseImageMemoryBind *image_binds = NULL;
@@ -10888,9 +13229,9 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
     struct vkd3d_queue *queue;
     VkSubmitInfo submit_info;
     VkQueue vk_queue_sparse;
-    unsigned int i, j, k;
+    unsigned int i, k;
     VkQueue vk_queue;
-    bool can_compact;
+    bool can_compact, success;
     VkResult vr;
 
     TRACE("queue %p, dst_resource %p, src_resource %p, count %u, bind_infos %p.\n",
@@ -10907,16 +13248,16 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
     bind_sparse_info.imageBindCount = 0;
     bind_sparse_info.pImageBinds = NULL;
 
-    if (!(bind_ranges = vkd3d_malloc(count * sizeof(*bind_ranges))))
+    /* NV driver is buggy and test_update_tile_mappings fails (bug 3274618). */
+    can_compact = command_queue->device->device_info.properties2.properties.vendorID != VKD3D_VENDOR_ID_NVIDIA;
+
+    if (!vkd3d_compact_sparse_bind_ranges(src_resource, &bind_ranges, &bind_ranges_size,
+            &count, bind_infos, count, mode, can_compact))
     {
         ERR("Failed to allocate bind range info.\n");
         goto cleanup;
     }
 
-    /* NV driver is buggy and test_update_tile_mappings fails (bug 3274618). */
-    can_compact = command_queue->device->device_info.properties2.properties.vendorID != VKD3D_VENDOR_ID_NVIDIA;
-    count = vkd3d_compact_sparse_bind_ranges(src_resource, bind_ranges, bind_infos, count, mode, can_compact);
-
     first_packed_tile = dst_resource->sparse.tile_count;
 
     if (d3d12_resource_is_buffer(dst_resource))
@@ -10947,7 +13288,7 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
             const struct vkd3d_sparse_memory_bind_range *bind = &bind_ranges[i];
 
             if (bind->tile_index < first_packed_tile)
-                image_bind_count += bind->tile_count;
+                image_bind_count += min(bind->tile_count, first_packed_tile - bind->tile_index);
             if (bind->tile_index + bind->tile_count > first_packed_tile)
                 opaque_bind_count++;
         }
@@ -10993,24 +13334,24 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
 
         while (bind->tile_count)
         {
-            struct d3d12_sparse_tile *tile = &dst_resource->sparse.tiles[bind->tile_index];
+            d3d12_resource_get_sparse_tile(dst_resource, bind->tile_index, &tile);
 
             if (d3d12_resource_is_texture(dst_resource) && bind->tile_index < first_packed_tile)
             {
-                const D3D12_SUBRESOURCE_TILING *tiling = &dst_resource->sparse.tilings[tile->image.subresource_index];
+                const D3D12_SUBRESOURCE_TILING *tiling = &dst_resource->sparse.tilings[tile.image.subresource_index];
                 const uint32_t tile_count = tiling->WidthInTiles * tiling->HeightInTiles * tiling->DepthInTiles;
 
                 if (bind->tile_index == tiling->StartTileIndexInOverallResource && bind->tile_count >= tile_count)
                 {
                     /* Bind entire subresource at once to reduce overhead */
-                    const struct d3d12_sparse_tile *last_tile = &tile[tile_count - 1];
-
                     VkSparseImageMemoryBind *vk_bind = &image_binds[image_info.bindCount++];
-                    vk_bind->subresource = tile->image.subresource;
-                    vk_bind->offset = tile->image.offset;
-                    vk_bind->extent.width = last_tile->image.offset.x + last_tile->image.extent.width;
-                    vk_bind->extent.height = last_tile->image.offset.y + last_tile->image.extent.height;
-                    vk_bind->extent.depth = last_tile->image.offset.z + last_tile->image.extent.depth;
+                    d3d12_resource_get_sparse_tile(dst_resource, bind->tile_index + tile_count - 1, &last_tile);
+
+                    vk_bind->subresource = tile.image.subresource;
+                    vk_bind->offset = tile.image.offset;
+                    vk_bind->extent.width = last_tile.image.offset.x + last_tile.image.extent.width;
+                    vk_bind->extent.height = last_tile.image.offset.y + last_tile.image.extent.height;
+                    vk_bind->extent.depth = last_tile.image.offset.z + last_tile.image.extent.depth;
                     vk_bind->memory = bind->vk_memory;
                     vk_bind->memoryOffset = bind->vk_offset;
                     vk_bind->flags = 0;
@@ -11020,9 +13361,9 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
                 else
                 {
                     VkSparseImageMemoryBind *vk_bind = &image_binds[image_info.bindCount++];
-                    vk_bind->subresource = tile->image.subresource;
-                    vk_bind->offset = tile->image.offset;
-                    vk_bind->extent = tile->image.extent;
+                    vk_bind->subresource = tile.image.subresource;
+                    vk_bind->offset = tile.image.offset;
+                    vk_bind->extent = tile.image.extent;
                     vk_bind->memory = bind->vk_memory;
                     vk_bind->memoryOffset = bind->vk_offset;
                     vk_bind->flags = 0;
@@ -11032,12 +13373,12 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
             }
             else
             {
-                const struct d3d12_sparse_tile *last_tile = &tile[bind->tile_count - 1];
-
                 VkSparseMemoryBind *vk_bind = &memory_binds[k++];
-                vk_bind->resourceOffset = tile->buffer.offset;
-                vk_bind->size = last_tile->buffer.offset
-                              + last_tile->buffer.length
+                d3d12_resource_get_sparse_tile(dst_resource, bind->tile_index + bind->tile_count - 1, &last_tile);
+
+                vk_bind->resourceOffset = tile.buffer.offset;
+                vk_bind->size = last_tile.buffer.offset
+                              + last_tile.buffer.length
                               - vk_bind->resourceOffset;
                 vk_bind->memory = bind->vk_memory;
                 vk_bind->memoryOffset = bind->vk_offset;
@@ -11046,11 +13387,16 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
                 processed_tiles = bind->tile_count;
             }
 
-            for (j = 0; j < processed_tiles; j++)
-            {
-                tile[j].vk_memory = bind->vk_memory;
-                tile[j].vk_offset = bind->vk_offset + j * VKD3D_TILE_SIZE;
-            }
+            spinlock_acquire(&dst_resource->sparse.mappings_lock);
+            if (bind->vk_memory)
+                success = vkd3d_tile_map_set(&dst_resource->sparse.mappings, bind->tile_index, processed_tiles,
+                        (uint64_t)bind->vk_memory, bind->vk_offset);
+            else
+                success = vkd3d_tile_map_unmap(&dst_resource->sparse.mappings, bind->tile_index, processed_tiles);
+            spinlock_release(&dst_resource->sparse.mappings_lock);
+
+            if (!success)
+                ERR("Failed to update tile mappings.\n");
 
             bind->tile_index += processed_tiles;
             bind->tile_count -= processed_tiles;
@@ -11058,19 +13404,12 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
         }
     }
 
-    /* Ensure that we use a queue that supports sparse binding */
     queue = command_queue->vkd3d_queue;
+    queue_sparse = d3d12_command_queue_get_sparse_queue(command_queue);
 
-    if (!(queue->vk_queue_flags & VK_QUEUE_SPARSE_BINDING_BIT))
-        queue_sparse = command_queue->device->queue_families[VKD3D_QUEUE_FAMILY_SPARSE_BINDING]->queues[0];
-    else
-        queue_sparse = queue;
-
-    if (!(vk_queue = vkd3d_queue_acquire(queue)))
-    {
-        ERR("Failed to acquire queue %p.\n", queue);
-        goto cleanup;
-    }
+    /* The worker holds both queues, see d3d12_command_queue_acquire_vk_queues(). */
+    vk_queue = queue->vk_queue;
+    vk_queue_sparse = queue_sparse->vk_queue;
 
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submit_info.pNext = NULL;
@@ -11087,18 +13426,6 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
     if ((vr = VK_CALL(vkQueueSubmit(vk_queue, 1, &submit_info, VK_NULL_HANDLE))) < 0)
         ERR("Failed to submit signal, vr %d.\n", vr);
 
-    if (queue != queue_sparse)
-    {
-        if (!(vk_queue_sparse = vkd3d_queue_acquire(queue_sparse)))
-        {
-            ERR("Failed to acquire queue %p.\n", queue_sparse);
-            vkd3d_queue_release(queue);
-            goto cleanup;
-        }
-    }
-    else
-        vk_queue_sparse = vk_queue;
-
     bind_sparse_info.pWaitSemaphores = &queue->serializing_binary_semaphore;
     bind_sparse_info.pSignalSemaphores = &queue->serializing_binary_semaphore;
     bind_sparse_info.waitSemaphoreCount = 1;
@@ -11107,9 +13434,6 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
     if ((vr = VK_CALL(vkQueueBindSparse(vk_queue_sparse, 1, &bind_sparse_info, VK_NULL_HANDLE))) < 0)
         ERR("Failed to perform sparse binding, vr %d.\n", vr);
 
-    if (queue != queue_sparse)
-        vkd3d_queue_release(queue_sparse);
-
     submit_info.pWaitSemaphores = &queue->serializing_binary_semaphore;
     submit_info.waitSemaphoreCount = 1;
     submit_info.pWaitDstStageMask = &wait_stages;
@@ -11119,8 +13443,6 @@ static void d3d12_command_queue_bind_sparse(struct d3d12_command_queue *command_
     if ((vr = VK_CALL(vkQueueSubmit(vk_queue, 1, &submit_info, VK_NULL_HANDLE))) < 0)
         ERR("Failed to submit signal, vr %d.\n", vr);
 
-    vkd3d_queue_release(queue);
-
 cleanup:
     vkd3d_free(memory_binds);
     vkd3d_free(image_binds);
@@ -11140,7 +13462,12 @@ static void d3d12_command_queue_add_submission_locked(struct d3d12_command_queue
     vkd3d_array_reserve((void**)&queue->submissions, &queue->submissions_size,
                         queue->submissions_count + 1, sizeof(*queue->submissions));
     queue->submissions[queue->submissions_count++] = *sub;
-    pthread_cond_signal(&queue->queue_cond);
+
+    if (!queue->is_scheduled)
+    {
+        queue->is_scheduled = true;
+        vkd3d_queue_worker_pool_schedule(&queue->device->queue_worker_pool, queue);
+    }
 }
 
 static void d3d12_command_queue_add_submission(struct d3d12_command_queue *queue,
@@ -11171,53 +13498,108 @@ static void d3d12_command_queue_acquire_serialized(struct d3d12_command_queue *q
 
 static void d3d12_command_queue_release_serialized(struct d3d12_command_queue *queue)
 {
+    /* The worker stops processing after a drain, resume it if work was queued meanwhile. */
+    if (queue->submissions_count && !queue->is_scheduled)
+    {
+        queue->is_scheduled = true;
+        vkd3d_queue_worker_pool_schedule(&queue->device->queue_worker_pool, queue);
+    }
+
     pthread_mutex_unlock(&queue->queue_lock);
 }
 
-static void *d3d12_command_queue_submission_worker_main(void *userdata)
+/* Bounds how long one queue can occupy a worker while others are ready. */
+#define VKD3D_QUEUE_WORKER_BATCH_SIZE 16
+
+static void d3d12_command_queue_run_submissions(struct d3d12_command_queue *queue)
 {
-    struct d3d12_command_queue_submission submission;
-    struct d3d12_command_queue_transition_pool pool;
-    struct d3d12_command_queue *queue = userdata;
-    uint64_t transition_timeline_value = 0;
+    struct d3d12_command_queue_transition_pool *pool = queue->transition_pool;
+    const struct d3d12_command_queue_submission_signal *folded_signal;
+    struct d3d12_command_queue_submission submission, next;
+    unsigned int i, batch, consumed;
     VkCommandBuffer transition_cmd;
-    unsigned int i;
-    HRESULT hr;
+    bool has_next;
 
     VKD3D_REGION_DECL(queue_wait);
     VKD3D_REGION_DECL(queue_signal);
     VKD3D_REGION_DECL(queue_execute);
 
-    vkd3d_set_thread_name("vkd3d_queue");
-
-    if (FAILED(hr = d3d12_command_queue_transition_pool_init(&pool, queue)))
-        ERR("Failed to initialize transition pool.\n");
-
-    for (;;)
+    for (batch = 0; batch < VKD3D_QUEUE_WORKER_BATCH_SIZE; batch++)
     {
         pthread_mutex_lock(&queue->queue_lock);
-        while (queue->submissions_count == 0)
-            pthread_cond_wait(&queue->queue_cond, &queue->queue_lock);
+        if (!queue->submissions_count)
+        {
+            queue->is_scheduled = false;
+            pthread_mutex_unlock(&queue->queue_lock);
+            return;
+        }
 
-        queue->submissions_count--;
         submission = queue->submissions[0];
-        memmove(queue->submissions, queue->submissions + 1, queue->submissions_count * sizeof(submission));
+
+        if ((has_next = queue->submissions_count > 1))
+            next = queue->submissions[1];
+
+        if ((submission.type == VKD3D_SUBMISSION_STOP || submission.type == VKD3D_SUBMISSION_DRAIN) &&
+                queue->pending_waits.count)
+        {
+            /* Waits must be visible to anyone using the Vulkan queue after a drain. */
+            pthread_mutex_unlock(&queue->queue_lock);
+            if (!d3d12_command_queue_acquire_vk_queues(queue, &submission))
+                return;
+            d3d12_command_queue_flush_pending_waits(queue);
+            d3d12_command_queue_release_vk_queues(queue);
+            continue;
+        }
+
+        if (submission.type == VKD3D_SUBMISSION_STOP)
+        {
+            /* The queue may be freed as soon as the lock is released. */
+            queue->is_stopped = true;
+            pthread_cond_broadcast(&queue->queue_cond);
+            pthread_mutex_unlock(&queue->queue_lock);
+            return;
+        }
+
+        if (submission.type == VKD3D_SUBMISSION_DRAIN)
+        {
+            /* Don't process anything else while an external user may own the queue.
+             * Processing resumes in d3d12_command_queue_release_serialized(). */
+            queue->submissions_count--;
+            memmove(queue->submissions, queue->submissions + 1, queue->submissions_count * sizeof(submission));
+            queue->queue_drain_count++;
+            queue->is_scheduled = false;
+            pthread_cond_broadcast(&queue->queue_cond);
+            pthread_mutex_unlock(&queue->queue_lock);
+            return;
+        }
+
         pthread_mutex_unlock(&queue->queue_lock);
 
+        /* Waits don't touch the Vulkan queue. Otherwise, if a queue we need is busy,
+         * we stay scheduled and are put back on the ready list once it is released. */
+        if (submission.type != VKD3D_SUBMISSION_WAIT && !d3d12_command_queue_acquire_vk_queues(queue, &submission))
+            return;
+
+        consumed = 1;
+
         switch (submission.type)
         {
-        case VKD3D_SUBMISSION_STOP:
-            goto cleanup;
-
         case VKD3D_SUBMISSION_WAIT:
             VKD3D_REGION_BEGIN(queue_wait);
-            d3d12_command_queue_wait(queue, submission.wait.fence, submission.wait.value);
+            if (!d3d12_command_queue_wait(queue, submission.wait.fence, submission.wait.value))
+            {
+                /* Parked, the wait stays at the head of the queue until the fence reschedules us. */
+                return;
+            }
             d3d12_fence_dec_ref(submission.wait.fence);
+            /* Resolved waits are deferred into the next ExecuteCommandLists.
+             * Any other submission type flushes them first. */
             VKD3D_REGION_END(queue_wait);
             break;
 
         case VKD3D_SUBMISSION_SIGNAL:
             VKD3D_REGION_BEGIN(queue_signal);
+            d3d12_command_queue_flush_pending_waits(queue);
             d3d12_command_queue_signal(queue, submission.signal.fence, submission.signal.value);
             d3d12_fence_dec_ref(submission.signal.fence);
             VKD3D_REGION_END(queue_signal);
@@ -11225,50 +13607,170 @@ static void *d3d12_command_queue_submission_worker_main(void *userdata)
 
         case VKD3D_SUBMISSION_EXECUTE:
             VKD3D_REGION_BEGIN(queue_execute);
-            d3d12_command_queue_transition_pool_build(&pool, queue->device,
-                    submission.execute.transitions,
-                    submission.execute.transition_count,
-                    &transition_cmd, &transition_timeline_value);
+            /* A signal which is already queued behind the command lists is folded into the same submit. */
+            folded_signal = has_next && next.type == VKD3D_SUBMISSION_SIGNAL ? &next.signal : NULL;
+            d3d12_command_queue_transition_pool_build(pool, queue->device, &submission.execute,
+                    &transition_cmd, &queue->transition_timeline_value);
             d3d12_command_queue_execute(queue, submission.execute.cmd,
                     submission.execute.cmd_count,
-                    transition_cmd, pool.timeline, transition_timeline_value,
-                    submission.execute.debug_capture);
+                    transition_cmd, pool->timeline, queue->transition_timeline_value,
+                    folded_signal, submission.execute.debug_capture);
             vkd3d_free(submission.execute.cmd);
             vkd3d_free(submission.execute.transitions);
+            vkd3d_free(submission.execute.dsv_boundaries);
             /* TODO: The correct place to do this would be in a fence handler, but this is good enough for now. */
             for (i = 0; i < submission.execute.outstanding_submissions_counter_count; i++)
                 InterlockedDecrement(submission.execute.outstanding_submissions_counters[i]);
             vkd3d_free(submission.execute.outstanding_submissions_counters);
+            if (folded_signal)
+            {
+                d3d12_fence_dec_ref(folded_signal->fence);
+                consumed = 2;
+            }
             VKD3D_REGION_END(queue_execute);
             break;
 
         case VKD3D_SUBMISSION_BIND_SPARSE:
+            d3d12_command_queue_flush_pending_waits(queue);
             d3d12_command_queue_bind_sparse(queue, submission.bind_sparse.mode,
                     submission.bind_sparse.dst_resource, submission.bind_sparse.src_resource,
                     submission.bind_sparse.bind_count, submission.bind_sparse.bind_infos);
             vkd3d_free(submission.bind_sparse.bind_infos);
             break;
 
-        case VKD3D_SUBMISSION_DRAIN:
-        {
-            pthread_mutex_lock(&queue->queue_lock);
-            queue->queue_drain_count++;
-            pthread_cond_signal(&queue->queue_cond);
-            pthread_mutex_unlock(&queue->queue_lock);
+        default:
+            ERR("Unrecognized submission type %u.\n", submission.type);
             break;
         }
 
-        default:
-            ERR("Unrecognized submission type %u.\n", submission.type);
+        d3d12_command_queue_release_vk_queues(queue);
+
+        pthread_mutex_lock(&queue->queue_lock);
+        queue->submissions_count -= consumed;
+        memmove(queue->submissions, queue->submissions + consumed, queue->submissions_count * sizeof(submission));
+        pthread_mutex_unlock(&queue->queue_lock);
+    }
+
+    /* Let other ready queues make progress, we stay scheduled. */
+    vkd3d_queue_worker_pool_schedule(&queue->device->queue_worker_pool, queue);
+}
+
+static void vkd3d_queue_worker_pool_schedule(struct vkd3d_queue_worker_pool *pool,
+        struct d3d12_command_queue *queue)
+{
+    pthread_mutex_lock(&pool->mutex);
+
+    if (!vkd3d_array_reserve((void **)&pool->ready_queues, &pool->ready_queues_size,
+            pool->ready_queue_count + 1, sizeof(*pool->ready_queues)))
+    {
+        ERR("Failed to schedule queue %p.\n", queue);
+        pthread_mutex_unlock(&pool->mutex);
+        return;
+    }
+
+    pool->ready_queues[pool->ready_queue_count++] = queue;
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void *vkd3d_queue_worker_main(void *userdata)
+{
+    struct vkd3d_queue_worker_pool *pool = userdata;
+    struct d3d12_command_queue *queue;
+
+    vkd3d_set_thread_name("vkd3d_queue");
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        while (!pool->ready_queue_count && !pool->should_exit)
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+
+        if (!pool->ready_queue_count)
+        {
+            pthread_mutex_unlock(&pool->mutex);
             break;
         }
+
+        queue = pool->ready_queues[0];
+        pool->ready_queue_count--;
+        memmove(pool->ready_queues, pool->ready_queues + 1, pool->ready_queue_count * sizeof(*pool->ready_queues));
+        pthread_mutex_unlock(&pool->mutex);
+
+        d3d12_command_queue_run_submissions(queue);
     }
 
-cleanup:
-    d3d12_command_queue_transition_pool_deinit(&pool, queue->device);
     return NULL;
 }
 
+#define VKD3D_QUEUE_WORKER_DEFAULT_THREAD_COUNT 2
+#define VKD3D_QUEUE_WORKER_MAX_THREAD_COUNT 16
+
+HRESULT vkd3d_queue_worker_pool_init(struct vkd3d_queue_worker_pool *pool,
+        struct d3d12_device *device)
+{
+    unsigned int thread_count, i;
+    HRESULT hr;
+    int rc;
+
+    memset(pool, 0, sizeof(*pool));
+    pool->device = device;
+
+    thread_count = vkd3d_env_var_as_uint("VKD3D_QUEUE_WORKER_THREADS", VKD3D_QUEUE_WORKER_DEFAULT_THREAD_COUNT);
+    thread_count = max(1u, min(thread_count, VKD3D_QUEUE_WORKER_MAX_THREAD_COUNT));
+    TRACE("Using %u queue worker threads.\n", thread_count);
+
+    if (!(pool->threads = vkd3d_calloc(thread_count, sizeof(*pool->threads))))
+        return E_OUTOFMEMORY;
+
+    if ((rc = pthread_mutex_init(&pool->mutex, NULL)))
+    {
+        ERR("Failed to initialize mutex, error %d.\n", rc);
+        vkd3d_free(pool->threads);
+        return hresult_from_errno(rc);
+    }
+
+    if ((rc = pthread_cond_init(&pool->cond, NULL)))
+    {
+        ERR("Failed to initialize condition variable, error %d.\n", rc);
+        pthread_mutex_destroy(&pool->mutex);
+        vkd3d_free(pool->threads);
+        return hresult_from_errno(rc);
+    }
+
+    for (i = 0; i < thread_count; i++)
+    {
+        if (FAILED(hr = vkd3d_create_thread(device->vkd3d_instance,
+                vkd3d_queue_worker_main, pool, &pool->threads[i])))
+        {
+            vkd3d_queue_worker_pool_cleanup(pool, device);
+            return hr;
+        }
+        pool->thread_count++;
+    }
+
+    return S_OK;
+}
+
+void vkd3d_queue_worker_pool_cleanup(struct vkd3d_queue_worker_pool *pool,
+        struct d3d12_device *device)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->should_exit = true;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < pool->thread_count; i++)
+        vkd3d_join_thread(device->vkd3d_instance, &pool->threads[i]);
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->cond);
+    vkd3d_free(pool->ready_queues);
+    vkd3d_free(pool->threads);
+}
+
 static HRESULT d3d12_command_queue_init(struct d3d12_command_queue *queue,
         struct d3d12_device *device, const D3D12_COMMAND_QUEUE_DESC *desc)
 {
@@ -11289,6 +13791,22 @@ static HRESULT d3d12_command_queue_init(struct d3d12_command_queue *queue,
     queue->submissions_size = 0;
     queue->drain_count = 0;
     queue->queue_drain_count = 0;
+    queue->is_scheduled = false;
+    queue->is_stopped = false;
+    queue->transition_timeline_value = 0;
+    memset(&queue->pending_waits, 0, sizeof(queue->pending_waits));
+    queue->folded_submit_count = 0;
+    queue->held_vk_queues = NULL;
+    queue->held_vk_queues_size = 0;
+    queue->held_vk_queue_count = 0;
+
+    /* Room for the queue itself and the sparse binding queue. */
+    if (!vkd3d_array_reserve((void **)&queue->held_vk_queues, &queue->held_vk_queues_size,
+            2, sizeof(*queue->held_vk_queues)))
+    {
+        hr = E_OUTOFMEMORY;
+        goto fail;
+    }
 
     if ((rc = pthread_mutex_init(&queue->queue_lock, NULL)) < 0)
     {
@@ -11319,30 +13837,34 @@ static HRESULT d3d12_command_queue_init(struct d3d12_command_queue *queue,
 
     d3d12_device_add_ref(queue->device = device);
 
-    if (FAILED(hr = vkd3d_fence_worker_start(&queue->fence_worker, device)))
-        goto fail_fence_worker_start;
+    if (!(queue->transition_pool = vkd3d_malloc(sizeof(*queue->transition_pool))))
+    {
+        d3d12_device_release(queue->device);
+        hr = E_OUTOFMEMORY;
+        goto fail_transition_pool;
+    }
 
-    if ((rc = pthread_create(&queue->submission_thread, NULL, d3d12_command_queue_submission_worker_main, queue)) < 0)
+    if (FAILED(hr = d3d12_command_queue_transition_pool_init(queue->transition_pool, queue)))
     {
+        ERR("Failed to initialize transition pool, hr %#x.\n", hr);
+        vkd3d_free(queue->transition_pool);
         d3d12_device_release(queue->device);
-        hr = hresult_from_errno(rc);
-        goto fail_pthread_create;
+        goto fail_transition_pool;
     }
 
     return S_OK;
 
-fail_pthread_create:
-    vkd3d_fence_worker_stop(&queue->fence_worker, device);
-fail_fence_worker_start:;
+fail_transition_pool:
 #ifdef VKD3D_BUILD_STANDALONE_D3D12
 fail_swapchain_factory:
-    vkd3d_private_store_destroy(&queue->private_store);
 #endif
+    vkd3d_private_store_destroy(&queue->private_store);
 fail_private_store:
     pthread_cond_destroy(&queue->queue_cond);
 fail_pthread_cond:
     pthread_mutex_destroy(&queue->queue_lock);
 fail:
+    vkd3d_free(queue->held_vk_queues);
     d3d12_device_unmap_vkd3d_queue(device, queue->vkd3d_queue);
     return hr;
 }
@@ -11539,6 +14061,13 @@ HRESULT d3d12_command_signature_create(struct d3d12_device *device, const D3D12_
         const D3D12_INDIRECT_ARGUMENT_DESC *argument_desc = &desc->pArgumentDescs[i];
         switch (argument_desc->Type)
         {
+            case D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH:
+                if (!device->device_info.mesh_shader_features.meshShader)
+                {
+                    WARN("Mesh shaders are not supported by the device.\n");
+                    return E_INVALIDARG;
+                }
+                /* fallthrough */
             case D3D12_INDIRECT_ARGUMENT_TYPE_DRAW:
             case D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED:
             case D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH:
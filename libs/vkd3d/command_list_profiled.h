@@ -459,7 +459,19 @@ static void STDMETHODCALLTYPE d3d12_command_list_RSSetShadingRateImage_profiled(
     COMMAND_LIST_PROFILED_CALL(RSSetShadingRateImage, iface, image);
 }
 
-static CONST_VTBL struct ID3D12GraphicsCommandList5Vtbl d3d12_command_list_vtbl_profiled =
+static void STDMETHODCALLTYPE d3d12_command_list_DispatchMesh_profiled(d3d12_command_list_iface *iface,
+        UINT x, UINT y, UINT z)
+{
+    COMMAND_LIST_PROFILED_CALL(DispatchMesh, iface, x, y, z);
+}
+
+static void STDMETHODCALLTYPE d3d12_command_list_Barrier_profiled(d3d12_command_list_iface *iface,
+        UINT32 num_barrier_groups, const D3D12_BARRIER_GROUP *barrier_groups)
+{
+    COMMAND_LIST_PROFILED_CALL(Barrier, iface, num_barrier_groups, barrier_groups);
+}
+
+static CONST_VTBL struct ID3D12GraphicsCommandList7Vtbl d3d12_command_list_vtbl_profiled =
 {
     /* IUnknown methods */
     d3d12_command_list_QueryInterface,
@@ -550,6 +562,10 @@ static CONST_VTBL struct ID3D12GraphicsCommandList5Vtbl d3d12_command_list_vtbl_
     /* ID3D12GraphicsCommandList5 methods */
     d3d12_command_list_RSSetShadingRate_profiled,
     d3d12_command_list_RSSetShadingRateImage_profiled,
+    /* ID3D12GraphicsCommandList6 methods */
+    d3d12_command_list_DispatchMesh_profiled,
+    /* ID3D12GraphicsCommandList7 methods */
+    d3d12_command_list_Barrier_profiled,
 };
 
 #endif
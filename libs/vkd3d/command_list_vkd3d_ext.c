@@ -17,6 +17,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_COMMAND
 
 #include "vkd3d_private.h"
 
@@ -257,8 +257,8 @@ err_destroy_mutex:
 err_destroy_cond:
     pthread_cond_destroy(&ring->ring_cond);
 err_free_buffers:
-    VK_CALL(vkDestroyBuffer(device->vk_device, ring->host_buffer, NULL));
-    VK_CALL(vkDestroyBuffer(device->vk_device, ring->device_atomic_buffer, NULL));
+    VK_CALL(vkDestroyBuffer(device->vk_device, ring->host_buffer, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyBuffer(device->vk_device, ring->device_atomic_buffer, &vkd3d_vk_allocator));
     vkd3d_free_device_memory(device, &ring->host_buffer_memory);
     vkd3d_free_device_memory(device, &ring->device_atomic_buffer_memory);
     memset(ring, 0, sizeof(*ring));
@@ -280,8 +280,8 @@ void vkd3d_shader_debug_ring_cleanup(struct vkd3d_shader_debug_ring *ring,
     pthread_mutex_destroy(&ring->ring_lock);
     pthread_cond_destroy(&ring->ring_cond);
 
-    VK_CALL(vkDestroyBuffer(device->vk_device, ring->host_buffer, NULL));
-    VK_CALL(vkDestroyBuffer(device->vk_device, ring->device_atomic_buffer, NULL));
+    VK_CALL(vkDestroyBuffer(device->vk_device, ring->host_buffer, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyBuffer(device->vk_device, ring->device_atomic_buffer, &vkd3d_vk_allocator));
     vkd3d_free_device_memory(device, &ring->host_buffer_memory);
     vkd3d_free_device_memory(device, &ring->device_atomic_buffer_memory);
 }
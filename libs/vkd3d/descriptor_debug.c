@@ -290,7 +290,7 @@ void vkd3d_descriptor_debug_free_global_info(
     }
 
     vkd3d_free_device_memory(device, &global_info->device_allocation);
-    VK_CALL(vkDestroyBuffer(device->vk_device, global_info->vk_buffer, NULL));
+    VK_CALL(vkDestroyBuffer(device->vk_device, global_info->vk_buffer, &vkd3d_vk_allocator));
     vkd3d_free(global_info);
 }
 
@@ -75,6 +75,7 @@ static const struct vkd3d_optional_extension_info optional_device_extensions[] =
     VK_EXTENSION(KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE, KHR_sampler_mirror_clamp_to_edge),
     VK_EXTENSION(KHR_SEPARATE_DEPTH_STENCIL_LAYOUTS, KHR_separate_depth_stencil_layouts),
     VK_EXTENSION(KHR_SHADER_INTEGER_DOT_PRODUCT, KHR_shader_integer_dot_product),
+    VK_EXTENSION(KHR_SYNCHRONIZATION_2, KHR_synchronization2),
     /* EXT extensions */
     VK_EXTENSION(EXT_CALIBRATED_TIMESTAMPS, EXT_calibrated_timestamps),
     VK_EXTENSION(EXT_CONDITIONAL_RENDERING, EXT_conditional_rendering),
@@ -95,6 +96,8 @@ static const struct vkd3d_optional_extension_info optional_device_extensions[] =
     VK_EXTENSION(EXT_EXTENDED_DYNAMIC_STATE, EXT_extended_dynamic_state),
     VK_EXTENSION(EXT_EXTERNAL_MEMORY_HOST, EXT_external_memory_host),
     VK_EXTENSION(EXT_4444_FORMATS, EXT_4444_formats),
+    VK_EXTENSION(EXT_MESH_SHADER, EXT_mesh_shader),
+    VK_EXTENSION(EXT_PIPELINE_CREATION_CACHE_CONTROL, EXT_pipeline_creation_cache_control),
     /* AMD extensions */
     VK_EXTENSION(AMD_BUFFER_MARKER, AMD_buffer_marker),
     VK_EXTENSION(AMD_SHADER_CORE_PROPERTIES, AMD_shader_core_properties),
@@ -399,7 +402,7 @@ static void vkd3d_init_debug_messenger_callback(struct vkd3d_instance *instance)
     callback_info.pfnUserCallback = vkd3d_debug_messenger_callback;
     callback_info.pUserData = NULL;
     callback_info.flags = 0;
-    if ((vr = VK_CALL(vkCreateDebugUtilsMessengerEXT(vk_instance, &callback_info, NULL, &callback)) < 0))
+    if ((vr = VK_CALL(vkCreateDebugUtilsMessengerEXT(vk_instance, &callback_info, &vkd3d_vk_allocator, &callback)) < 0))
     {
         WARN("Failed to create debug report callback, vr %d.\n", vr);
         return;
@@ -497,9 +500,11 @@ static const struct vkd3d_debug_option vkd3d_config_options[] =
     {"force_rtv_exclusive_queue", VKD3D_CONFIG_FLAG_FORCE_RTV_EXCLUSIVE_QUEUE},
     {"force_dsv_exclusive_queue", VKD3D_CONFIG_FLAG_FORCE_DSV_EXCLUSIVE_QUEUE},
     {"force_exclusive_queue", VKD3D_CONFIG_FLAG_FORCE_RTV_EXCLUSIVE_QUEUE | VKD3D_CONFIG_FLAG_FORCE_DSV_EXCLUSIVE_QUEUE},
+    {"queue_ownership_transfer", VKD3D_CONFIG_FLAG_QUEUE_OWNERSHIP_TRANSFER},
     {"no_upload_hvv", VKD3D_CONFIG_FLAG_NO_UPLOAD_HVV},
     {"log_memory_budget", VKD3D_CONFIG_FLAG_LOG_MEMORY_BUDGET},
     {"force_host_cached", VKD3D_CONFIG_FLAG_FORCE_HOST_CACHED},
+    {"no_deferred_compile", VKD3D_CONFIG_FLAG_NO_DEFERRED_COMPILE},
 };
 
 static void vkd3d_config_flags_init_once(void)
@@ -671,7 +676,7 @@ static HRESULT vkd3d_instance_init(struct vkd3d_instance *instance,
         vkd3d_free(layers);
     }
 
-    vr = vk_global_procs->vkCreateInstance(&instance_info, NULL, &vk_instance);
+    vr = vk_global_procs->vkCreateInstance(&instance_info, &vkd3d_vk_allocator, &vk_instance);
     vkd3d_free((void *)extensions);
     if (vr < 0)
     {
@@ -685,7 +690,7 @@ static HRESULT vkd3d_instance_init(struct vkd3d_instance *instance,
     {
         ERR("Failed to load instance procs, hr %#x.\n", hr);
         if (instance->vk_procs.vkDestroyInstance)
-            instance->vk_procs.vkDestroyInstance(vk_instance, NULL);
+            instance->vk_procs.vkDestroyInstance(vk_instance, &vkd3d_vk_allocator);
         if (instance->libvulkan)
             vkd3d_dlclose(instance->libvulkan);
         return hr;
@@ -752,9 +757,9 @@ static void vkd3d_destroy_instance(struct vkd3d_instance *instance)
     VkInstance vk_instance = instance->vk_instance;
 
     if (instance->vk_debug_callback)
-        VK_CALL(vkDestroyDebugUtilsMessengerEXT(vk_instance, instance->vk_debug_callback, NULL));
+        VK_CALL(vkDestroyDebugUtilsMessengerEXT(vk_instance, instance->vk_debug_callback, &vkd3d_vk_allocator));
 
-    VK_CALL(vkDestroyInstance(vk_instance, NULL));
+    VK_CALL(vkDestroyInstance(vk_instance, &vkd3d_vk_allocator));
 
     if (instance->libvulkan)
         vkd3d_dlclose(instance->libvulkan);
@@ -1119,6 +1124,21 @@ static void vkd3d_physical_device_info_init(struct vkd3d_physical_device_info *i
         vk_prepend_struct(&info->features2, &info->ext_4444_formats_features);
     }
 
+    if (vulkan_info->EXT_mesh_shader)
+    {
+        info->mesh_shader_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+        info->mesh_shader_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_PROPERTIES_EXT;
+        vk_prepend_struct(&info->features2, &info->mesh_shader_features);
+        vk_prepend_struct(&info->properties2, &info->mesh_shader_properties);
+    }
+
+    if (vulkan_info->EXT_pipeline_creation_cache_control)
+    {
+        info->pipeline_creation_cache_control_features.sType =
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES_EXT;
+        vk_prepend_struct(&info->features2, &info->pipeline_creation_cache_control_features);
+    }
+
     if (vulkan_info->AMD_shader_core_properties)
     {
         info->shader_core_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_CORE_PROPERTIES_AMD;
@@ -1187,6 +1207,12 @@ static void vkd3d_physical_device_info_init(struct vkd3d_physical_device_info *i
         vk_prepend_struct(&info->properties2, &info->shader_integer_dot_product_properties);
     }
 
+    if (vulkan_info->KHR_synchronization2)
+    {
+        info->synchronization2_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+        vk_prepend_struct(&info->features2, &info->synchronization2_features);
+    }
+
     /* Core in Vulkan 1.1. */
     info->shader_draw_parameters_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES;
     vk_prepend_struct(&info->features2, &info->shader_draw_parameters_features);
@@ -1593,6 +1619,11 @@ static void vkd3d_trace_physical_device_features(const struct vkd3d_physical_dev
     TRACE("  VkPhysicalDeviceCustomBorderColorFeaturesEXT:\n");
     TRACE("    customBorderColors: %#x\n", info->custom_border_color_features.customBorderColors);
     TRACE("    customBorderColorWithoutFormat: %#x\n", info->custom_border_color_features.customBorderColorWithoutFormat);
+
+    TRACE("  VkPhysicalDeviceMeshShaderFeaturesEXT:\n");
+    TRACE("    taskShader: %#x.\n", info->mesh_shader_features.taskShader);
+    TRACE("    meshShader: %#x.\n", info->mesh_shader_features.meshShader);
+    TRACE("    multiviewMeshShader: %#x.\n", info->mesh_shader_features.multiviewMeshShader);
 }
 
 static HRESULT vkd3d_init_device_extensions(struct d3d12_device *device,
@@ -2061,24 +2092,16 @@ static HRESULT vkd3d_select_queues(const struct vkd3d_instance *vkd3d_instance,
     return S_OK;
 }
 
-static HRESULT vkd3d_create_vk_device(struct d3d12_device *device,
-        const struct vkd3d_device_create_info *create_info)
+static HRESULT vkd3d_init_physical_device(struct d3d12_device *device,
+        const struct vkd3d_device_create_info *create_info, struct vkd3d_device_queue_info *device_queue_info,
+        uint32_t *extension_count, bool *user_extension_supported)
 {
     const struct vkd3d_vk_instance_procs *vk_procs = &device->vkd3d_instance->vk_procs;
-    struct vkd3d_device_queue_info device_queue_info;
     VkPhysicalDeviceProperties device_properties;
-    bool *user_extension_supported = NULL;
     VkPhysicalDevice physical_device;
-    VkDeviceCreateInfo device_info;
     unsigned int device_index;
-    uint32_t extension_count;
-    const char **extensions;
-    VkDevice vk_device;
-    VkResult vr;
     HRESULT hr;
 
-    TRACE("device %p, create_info %p.\n", device, create_info);
-
     physical_device = create_info->vk_physical_device;
     device_index = vkd3d_env_var_as_uint("VKD3D_VULKAN_DEVICE", ~0u);
     if ((!physical_device || device_index != ~0u)
@@ -2090,41 +2113,57 @@ static HRESULT vkd3d_create_vk_device(struct d3d12_device *device,
     VK_CALL(vkGetPhysicalDeviceProperties(device->vk_physical_device, &device_properties));
     device->api_version = min(device_properties.apiVersion, VKD3D_MAX_API_VERSION);
 
-    if (FAILED(hr = vkd3d_select_queues(device->vkd3d_instance, physical_device, &device_queue_info)))
+    if (FAILED(hr = vkd3d_select_queues(device->vkd3d_instance, physical_device, device_queue_info)))
         return hr;
 
     TRACE("Using queue family %u for direct command queues.\n",
-            device_queue_info.family_index[VKD3D_QUEUE_FAMILY_GRAPHICS]);
+            device_queue_info->family_index[VKD3D_QUEUE_FAMILY_GRAPHICS]);
     TRACE("Using queue family %u for compute command queues.\n",
-            device_queue_info.family_index[VKD3D_QUEUE_FAMILY_COMPUTE]);
+            device_queue_info->family_index[VKD3D_QUEUE_FAMILY_COMPUTE]);
     TRACE("Using queue family %u for copy command queues.\n",
-            device_queue_info.family_index[VKD3D_QUEUE_FAMILY_TRANSFER]);
+            device_queue_info->family_index[VKD3D_QUEUE_FAMILY_TRANSFER]);
     TRACE("Using queue family %u for sparse binding.\n",
-            device_queue_info.family_index[VKD3D_QUEUE_FAMILY_SPARSE_BINDING]);
+            device_queue_info->family_index[VKD3D_QUEUE_FAMILY_SPARSE_BINDING]);
 
     VK_CALL(vkGetPhysicalDeviceMemoryProperties(physical_device, &device->memory_properties));
 
+    if (FAILED(hr = vkd3d_init_device_extensions(device, create_info,
+            extension_count, user_extension_supported)))
+        return hr;
+
+    vkd3d_physical_device_info_init(&device->device_info, device);
+
+    return vkd3d_init_device_caps(device, create_info, &device->device_info);
+}
+
+static HRESULT vkd3d_create_vk_device(struct d3d12_device *device,
+        const struct vkd3d_device_create_info *create_info)
+{
+    const struct vkd3d_vk_instance_procs *vk_procs = &device->vkd3d_instance->vk_procs;
+    struct vkd3d_device_queue_info device_queue_info;
+    bool *user_extension_supported = NULL;
+    VkDeviceCreateInfo device_info;
+    uint32_t extension_count;
+    const char **extensions;
+    VkDevice vk_device;
+    VkResult vr;
+    HRESULT hr;
+
+    TRACE("device %p, create_info %p.\n", device, create_info);
+
     if (create_info->optional_device_extension_count)
     {
         if (!(user_extension_supported = vkd3d_calloc(create_info->optional_device_extension_count, sizeof(bool))))
             return E_OUTOFMEMORY;
     }
 
-    if (FAILED(hr = vkd3d_init_device_extensions(device, create_info,
+    if (FAILED(hr = vkd3d_init_physical_device(device, create_info, &device_queue_info,
             &extension_count, user_extension_supported)))
     {
         vkd3d_free(user_extension_supported);
         return hr;
     }
 
-    vkd3d_physical_device_info_init(&device->device_info, device);
-
-    if (FAILED(hr = vkd3d_init_device_caps(device, create_info, &device->device_info)))
-    {
-        vkd3d_free(user_extension_supported);
-        return hr;
-    }
-
     if (!(extensions = vkd3d_calloc(extension_count, sizeof(*extensions))))
     {
         vkd3d_free(user_extension_supported);
@@ -2150,7 +2189,7 @@ static HRESULT vkd3d_create_vk_device(struct d3d12_device *device,
     device_info.pEnabledFeatures = &device->device_info.features2.features;
     vkd3d_free(user_extension_supported);
 
-    vr = VK_CALL(vkCreateDevice(physical_device, &device_info, NULL, &vk_device));
+    vr = VK_CALL(vkCreateDevice(device->vk_physical_device, &device_info, &vkd3d_vk_allocator, &vk_device));
     vkd3d_free((void *)extensions);
     if (vr < 0)
     {
@@ -2162,7 +2201,7 @@ static HRESULT vkd3d_create_vk_device(struct d3d12_device *device,
     {
         ERR("Failed to load device procs, hr %#x.\n", hr);
         if (device->vk_procs.vkDestroyDevice)
-            device->vk_procs.vkDestroyDevice(vk_device, NULL);
+            device->vk_procs.vkDestroyDevice(vk_device, &vkd3d_vk_allocator);
         return hr;
     }
 
@@ -2171,7 +2210,7 @@ static HRESULT vkd3d_create_vk_device(struct d3d12_device *device,
     if (FAILED(hr = d3d12_device_create_vkd3d_queues(device, &device_queue_info)))
     {
         ERR("Failed to create queues, hr %#x.\n", hr);
-        device->vk_procs.vkDestroyDevice(vk_device, NULL);
+        device->vk_procs.vkDestroyDevice(vk_device, &vkd3d_vk_allocator);
         return hr;
     }
 
@@ -2185,19 +2224,22 @@ struct d3d12_device_singleton
     struct list entry;
     LUID adapter_luid;
     struct d3d12_device *device;
+    /* Non-zero while the device has no references left and is
+     * kept alive for a short while in case it is created again. */
+    uint64_t release_deadline_ns;
 };
 
 static pthread_mutex_t d3d12_device_map_mutex = PTHREAD_MUTEX_INITIALIZER;
 static struct list d3d12_device_map = LIST_INIT(d3d12_device_map);
 
-static struct d3d12_device *d3d12_find_device_singleton(LUID luid)
+static struct d3d12_device_singleton *d3d12_find_device_singleton(LUID luid)
 {
     struct d3d12_device_singleton* current;
 
     LIST_FOR_EACH_ENTRY(current, &d3d12_device_map, struct d3d12_device_singleton, entry)
     {
         if (!memcmp(&current->adapter_luid, &luid, sizeof(LUID)))
-            return current->device;
+            return current;
     }
 
     return NULL;
@@ -2214,6 +2256,7 @@ static void d3d12_add_device_singleton(struct d3d12_device *device, LUID luid)
     }
     e->adapter_luid = luid;
     e->device = device;
+    e->release_deadline_ns = 0;
 
     list_add_tail(&d3d12_device_map, &e->entry);
 }
@@ -2227,20 +2270,84 @@ static void d3d12_remove_device_singleton(LUID luid)
         if (!memcmp(&current->adapter_luid, &luid, sizeof(LUID)))
         {
             list_remove(&current->entry);
+            vkd3d_free(current);
             return;
         }
     }
 }
 
-static HRESULT d3d12_device_create_scratch_buffer(struct d3d12_device *device, VkDeviceSize size, struct vkd3d_scratch_buffer *scratch)
+static uint64_t d3d12_device_get_release_grace_ns(void)
+{
+    static uint64_t grace_ns;
+    static bool initialized;
+
+    /* Called with the device map mutex held. */
+    if (!initialized)
+    {
+        grace_ns = vkd3d_env_var_as_uint("VKD3D_DEVICE_RELEASE_GRACE_MS", 0) * 1000000ull;
+        initialized = true;
+    }
+
+    return grace_ns;
+}
+
+static void d3d12_device_destroy(struct d3d12_device *device);
+
+static void d3d12_reap_released_device_singletons(void)
+{
+    struct d3d12_device_singleton *current, *next;
+    uint64_t now;
+
+    if (!d3d12_device_get_release_grace_ns())
+        return;
+
+    now = vkd3d_get_current_time_ns();
+
+    LIST_FOR_EACH_ENTRY_SAFE(current, next, &d3d12_device_map, struct d3d12_device_singleton, entry)
+    {
+        if (current->release_deadline_ns && now >= current->release_deadline_ns)
+        {
+            TRACE("Grace period of device %p expired, destroying.\n", current->device);
+            list_remove(&current->entry);
+            d3d12_device_destroy(current->device);
+            vkd3d_free(current->device);
+            vkd3d_free(current);
+        }
+    }
+}
+
+static bool d3d12_defer_device_release(struct d3d12_device *device)
+{
+    struct d3d12_device_singleton *singleton;
+    uint64_t grace_ns;
+
+    /* Applications commonly create a device only to query support,
+     * release it and create it again right away. Keep the singleton
+     * around for a short while so the second creation is cheap.
+     * Disabled by default since users of the vkd3d API expect the
+     * instance and parent references to go away with the device. */
+    if (!(grace_ns = d3d12_device_get_release_grace_ns()) || device->removed_reason != S_OK)
+        return false;
+
+    if (!(singleton = d3d12_find_device_singleton(device->adapter_luid)) || singleton->device != device)
+        return false;
+
+    singleton->release_deadline_ns = vkd3d_get_current_time_ns() + grace_ns;
+    TRACE("Deferring destruction of device %p.\n", device);
+    return true;
+}
+
+static HRESULT d3d12_device_create_scratch_buffer(struct d3d12_device *device, enum vkd3d_scratch_pool_kind kind,
+        VkDeviceSize size, struct vkd3d_scratch_buffer *scratch)
 {
     struct vkd3d_allocate_heap_memory_info alloc_info;
     HRESULT hr;
 
-    TRACE("device %p, size %llu, scratch %p.\n", device, size, scratch);
+    TRACE("device %p, kind %u, size %llu, scratch %p.\n", device, kind, size, scratch);
 
     memset(&alloc_info, 0, sizeof(alloc_info));
-    alloc_info.heap_desc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    alloc_info.heap_desc.Properties.Type = kind == VKD3D_SCRATCH_POOL_KIND_UPLOAD ?
+            D3D12_HEAP_TYPE_UPLOAD : D3D12_HEAP_TYPE_DEFAULT;
     alloc_info.heap_desc.SizeInBytes = size;
     alloc_info.heap_desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
     alloc_info.heap_desc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
@@ -2260,16 +2367,19 @@ static void d3d12_device_destroy_scratch_buffer(struct d3d12_device *device, con
     vkd3d_free_memory(device, &device->memory_allocator, &scratch->allocation);
 }
 
-HRESULT d3d12_device_get_scratch_buffer(struct d3d12_device *device, VkDeviceSize min_size, struct vkd3d_scratch_buffer *scratch)
+HRESULT d3d12_device_get_scratch_buffer(struct d3d12_device *device, enum vkd3d_scratch_pool_kind kind,
+        VkDeviceSize min_size, struct vkd3d_scratch_buffer *scratch)
 {
+    struct d3d12_device_scratch_pool *pool = &device->scratch_pools[kind];
+
     if (min_size > VKD3D_SCRATCH_BUFFER_SIZE)
-        return d3d12_device_create_scratch_buffer(device, min_size, scratch);
+        return d3d12_device_create_scratch_buffer(device, kind, min_size, scratch);
 
     pthread_mutex_lock(&device->mutex);
 
-    if (device->scratch_buffer_count)
+    if (pool->scratch_buffer_count)
     {
-        *scratch = device->scratch_buffers[--device->scratch_buffer_count];
+        *scratch = pool->scratch_buffers[--pool->scratch_buffer_count];
         scratch->offset = 0;
         pthread_mutex_unlock(&device->mutex);
         return S_OK;
@@ -2277,18 +2387,21 @@ HRESULT d3d12_device_get_scratch_buffer(struct d3d12_device *device, VkDeviceSiz
     else
     {
         pthread_mutex_unlock(&device->mutex);
-        return d3d12_device_create_scratch_buffer(device, VKD3D_SCRATCH_BUFFER_SIZE, scratch);
+        return d3d12_device_create_scratch_buffer(device, kind, VKD3D_SCRATCH_BUFFER_SIZE, scratch);
     }
 }
 
-void d3d12_device_return_scratch_buffer(struct d3d12_device *device, const struct vkd3d_scratch_buffer *scratch)
+void d3d12_device_return_scratch_buffer(struct d3d12_device *device, enum vkd3d_scratch_pool_kind kind,
+        const struct vkd3d_scratch_buffer *scratch)
 {
+    struct d3d12_device_scratch_pool *pool = &device->scratch_pools[kind];
+
     pthread_mutex_lock(&device->mutex);
 
     if (scratch->allocation.resource.size == VKD3D_SCRATCH_BUFFER_SIZE &&
-            device->scratch_buffer_count < VKD3D_SCRATCH_BUFFER_COUNT)
+            pool->scratch_buffer_count < VKD3D_SCRATCH_BUFFER_COUNT)
     {
-        device->scratch_buffers[device->scratch_buffer_count++] = *scratch;
+        pool->scratch_buffers[pool->scratch_buffer_count++] = *scratch;
         pthread_mutex_unlock(&device->mutex);
     }
     else
@@ -2384,7 +2497,7 @@ static HRESULT d3d12_device_create_query_pool(struct d3d12_device *device, uint3
             return E_INVALIDARG;
     }
 
-    if ((vr = VK_CALL(vkCreateQueryPool(device->vk_device, &pool_info, NULL, &pool->vk_query_pool))) < 0)
+    if ((vr = VK_CALL(vkCreateQueryPool(device->vk_device, &pool_info, &vkd3d_vk_allocator, &pool->vk_query_pool))) < 0)
     {
         ERR("Failed to create query pool, vr %u.\n", vr);
         return hresult_from_vk_result(vr);
@@ -2402,7 +2515,7 @@ static void d3d12_device_destroy_query_pool(struct d3d12_device *device, const s
 
     TRACE("device %p, pool %p.\n", device, pool);
 
-    VK_CALL(vkDestroyQueryPool(device->vk_device, pool->vk_query_pool, NULL));
+    VK_CALL(vkDestroyQueryPool(device->vk_device, pool->vk_query_pool, &vkd3d_vk_allocator));
 }
 
 HRESULT d3d12_device_get_query_pool(struct d3d12_device *device, uint32_t type_index, struct vkd3d_query_pool *pool)
@@ -2459,6 +2572,7 @@ HRESULT STDMETHODCALLTYPE d3d12_device_QueryInterface(d3d12_device_iface *iface,
             || IsEqualGUID(riid, &IID_ID3D12Device4)
             || IsEqualGUID(riid, &IID_ID3D12Device5)
             || IsEqualGUID(riid, &IID_ID3D12Device6)
+            || IsEqualGUID(riid, &IID_ID3D12Device7)
             || IsEqualGUID(riid, &IID_ID3D12Object)
             || IsEqualGUID(riid, &IID_IUnknown))
     {
@@ -2491,47 +2605,56 @@ static ULONG STDMETHODCALLTYPE d3d12_device_AddRef(d3d12_device_iface *iface)
     return refcount;
 }
 
+static void d3d12_device_global_pipeline_cache_cleanup(struct d3d12_device *device)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    vkd3d_pipeline_cache_pool_cleanup(&device->pipeline_cache_pool, device);
+    vkd3d_cleanup_rt_pipeline_cache_merges(device);
+    VK_CALL(vkDestroyPipelineCache(device->vk_device, device->rt_pipeline_cache, &vkd3d_vk_allocator));
+}
+
 static HRESULT d3d12_device_global_pipeline_cache_init(struct d3d12_device *device)
 {
-    /* On certain drivers, VkPipelineCache has a fixed (large) memory overhead.
-     * This means that using a VkPipelineCache per PSO will explode system memory usage, leading to OOM.
-     * To counteract this, we use one global pipeline cache instead, but this means we lose the ability to
-     * serialize and unserialize PSO state. Instead, we can just serialize garbage and ignore unserialization.
-     * From a correctness PoV, this is perfectly fine, and cached PSOs should be present in disk cache either way.
-     * The bug was introduced in 470 series, but was fixed as of 470.62.02 driver.
-     * 470.63.01 mainline one was released before 62.02, so it is also included in workaround list. */
-    bool use_global = false;
     VkResult vr;
+    HRESULT hr;
+
+    /* Ray tracing pipelines always share a cache so that collections
+     * and pipelines built from them can reuse compiled shaders. */
+    spinlock_init(&device->rt_pipeline_cache_lock);
+    spinlock_init(&device->rt_pipeline_cache_pending_lock);
 
-    if (device->device_info.properties2.properties.vendorID == VKD3D_VENDOR_ID_NVIDIA)
+    if (device->vk_info.KHR_ray_tracing_pipeline)
     {
-        uint32_t driver_version = device->device_info.properties2.properties.driverVersion;
-        use_global = (driver_version >= VKD3D_DRIVER_VERSION_MAKE_NV(470, 0, 0) &&
-                driver_version < VKD3D_DRIVER_VERSION_MAKE_NV(470, 62, 2)) ||
-                driver_version == VKD3D_DRIVER_VERSION_MAKE_NV(470, 63, 1);
+        if ((vr = vkd3d_create_pipeline_cache(device, 0, NULL, &device->rt_pipeline_cache)))
+            return hresult_from_vk_result(vr);
     }
 
-    if (!use_global)
-        return S_OK;
-
-    WARN("Workaround applied. Creating global pipeline cache.\n");
-    vr = vkd3d_create_pipeline_cache(device, 0, NULL, &device->global_pipeline_cache);
-    return hresult_from_vk_result(vr);
-}
+    /* Graphics and compute PSOs share a small pool of caches rather than owning one each.
+     * On some drivers VkPipelineCache has a large fixed memory overhead, which used to
+     * require a workaround, and separate caches cannot reuse compiled state either. */
+    if (FAILED(hr = vkd3d_pipeline_cache_pool_init(&device->pipeline_cache_pool, device)))
+    {
+        d3d12_device_global_pipeline_cache_cleanup(device);
+        return hr;
+    }
 
-static void d3d12_device_global_pipeline_cache_cleanup(struct d3d12_device *device)
-{
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
-    VK_CALL(vkDestroyPipelineCache(device->vk_device, device->global_pipeline_cache, NULL));
+    return S_OK;
 }
 
 static void d3d12_device_destroy(struct d3d12_device *device)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
-    size_t i;
+    size_t i, j;
 
-    for (i = 0; i < device->scratch_buffer_count; i++)
-        d3d12_device_destroy_scratch_buffer(device, &device->scratch_buffers[i]);
+    /* Signalling fences can reschedule queues, so stop the fence worker first. */
+    vkd3d_fence_worker_stop(&device->fence_worker, device);
+    vkd3d_queue_worker_pool_cleanup(&device->queue_worker_pool, device);
+
+    for (i = 0; i < VKD3D_SCRATCH_POOL_KIND_COUNT; i++)
+    {
+        for (j = 0; j < device->scratch_pools[i].scratch_buffer_count; j++)
+            d3d12_device_destroy_scratch_buffer(device, &device->scratch_pools[i].scratch_buffers[j]);
+    }
 
     for (i = 0; i < device->query_pool_count; i++)
         d3d12_device_destroy_query_pool(device, &device->query_pools[i]);
@@ -2544,6 +2667,7 @@ static void d3d12_device_destroy(struct d3d12_device *device)
     vkd3d_memory_info_cleanup(&device->memory_info, device);
     vkd3d_shader_debug_ring_cleanup(&device->debug_ring, device);
     d3d12_device_global_pipeline_cache_cleanup(device);
+    vkd3d_acceleration_structure_prebuild_cache_cleanup(&device->prebuild_cache);
     vkd3d_sampler_state_cleanup(&device->sampler_state, device);
     vkd3d_view_map_destroy(&device->sampler_map, device);
     vkd3d_meta_ops_cleanup(&device->meta_ops, device);
@@ -2559,7 +2683,7 @@ static void d3d12_device_destroy(struct d3d12_device *device)
         vkd3d_renderdoc_end_capture(device->vkd3d_instance->vk_instance);
 #endif
 
-    VK_CALL(vkDestroyDevice(device->vk_device, NULL));
+    VK_CALL(vkDestroyDevice(device->vk_device, &vkd3d_vk_allocator));
     pthread_mutex_destroy(&device->mutex);
     if (device->parent)
         IUnknown_Release(device->parent);
@@ -2600,9 +2724,14 @@ static ULONG STDMETHODCALLTYPE d3d12_device_Release(d3d12_device_iface *iface)
 
     if (cur_refcount == 1)
     {
-        d3d12_remove_device_singleton(device->adapter_luid);
-        d3d12_device_destroy(device);
-        vkd3d_free(device);
+        d3d12_reap_released_device_singletons();
+
+        if (!d3d12_defer_device_release(device))
+        {
+            d3d12_remove_device_singleton(device->adapter_luid);
+            d3d12_device_destroy(device);
+            vkd3d_free(device);
+        }
     }
 
     if (is_locked)
@@ -3427,6 +3556,95 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_CheckFeatureSupport(d3d12_device_i
             return S_OK;
         }
 
+        case D3D12_FEATURE_D3D12_OPTIONS8:
+        {
+            D3D12_FEATURE_DATA_D3D12_OPTIONS8 *data = feature_data;
+
+            if (feature_data_size != sizeof(*data))
+            {
+                WARN("Invalid size %u.\n", feature_data_size);
+                return E_INVALIDARG;
+            }
+
+            *data = device->d3d12_caps.options8;
+
+            TRACE("Unaligned block textures %#x.\n", data->UnalignedBlockTexturesSupported);
+            return S_OK;
+        }
+
+        case D3D12_FEATURE_D3D12_OPTIONS9:
+        {
+            D3D12_FEATURE_DATA_D3D12_OPTIONS9 *data = feature_data;
+
+            if (feature_data_size != sizeof(*data))
+            {
+                WARN("Invalid size %u.\n", feature_data_size);
+                return E_INVALIDARG;
+            }
+
+            *data = device->d3d12_caps.options9;
+
+            TRACE("Mesh shader pipeline stats %#x.\n", data->MeshShaderPipelineStatsSupported);
+            TRACE("Mesh shader full range render target array index %#x.\n", data->MeshShaderSupportsFullRangeRenderTargetArrayIndex);
+            TRACE("Atomic int64 on typed resources %#x.\n", data->AtomicInt64OnTypedResourceSupported);
+            TRACE("Atomic int64 on group shared %#x.\n", data->AtomicInt64OnGroupSharedSupported);
+            TRACE("Derivatives in mesh and amplification shaders %#x.\n", data->DerivativesInMeshAndAmplificationShadersSupported);
+            TRACE("Wave MMA tier %#x.\n", data->WaveMMATier);
+            return S_OK;
+        }
+
+        case D3D12_FEATURE_D3D12_OPTIONS10:
+        {
+            D3D12_FEATURE_DATA_D3D12_OPTIONS10 *data = feature_data;
+
+            if (feature_data_size != sizeof(*data))
+            {
+                WARN("Invalid size %u.\n", feature_data_size);
+                return E_INVALIDARG;
+            }
+
+            *data = device->d3d12_caps.options10;
+
+            TRACE("Variable rate shading sum combiner %#x.\n", data->VariableRateShadingSumCombinerSupported);
+            TRACE("Mesh shader per-primitive shading rate %#x.\n", data->MeshShaderPerPrimitiveShadingRateSupported);
+            return S_OK;
+        }
+
+        case D3D12_FEATURE_D3D12_OPTIONS11:
+        {
+            D3D12_FEATURE_DATA_D3D12_OPTIONS11 *data = feature_data;
+
+            if (feature_data_size != sizeof(*data))
+            {
+                WARN("Invalid size %u.\n", feature_data_size);
+                return E_INVALIDARG;
+            }
+
+            *data = device->d3d12_caps.options11;
+
+            TRACE("Atomic int64 on descriptor heap resources %#x.\n", data->AtomicInt64OnDescriptorHeapResourceSupported);
+            return S_OK;
+        }
+
+        case D3D12_FEATURE_D3D12_OPTIONS12:
+        {
+            D3D12_FEATURE_DATA_D3D12_OPTIONS12 *data = feature_data;
+
+            if (feature_data_size != sizeof(*data))
+            {
+                WARN("Invalid size %u.\n", feature_data_size);
+                return E_INVALIDARG;
+            }
+
+            *data = device->d3d12_caps.options12;
+
+            TRACE("Mesh shader primitives statistic includes culled primitives %d.\n",
+                    data->MSPrimitivesPipelineStatisticIncludesCulledPrimitives);
+            TRACE("Enhanced barriers %#x.\n", data->EnhancedBarriersSupported);
+            TRACE("Relaxed format casting %#x.\n", data->RelaxedFormatCastingSupported);
+            return S_OK;
+        }
+
         case D3D12_FEATURE_QUERY_META_COMMAND:
         {
             D3D12_FEATURE_DATA_QUERY_META_COMMAND *data = feature_data;
@@ -3473,7 +3691,7 @@ static UINT STDMETHODCALLTYPE d3d12_device_GetDescriptorHandleIncrementSize(d3d1
     {
         case D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV:
         case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER:
-            return sizeof(struct d3d12_desc);
+            return VKD3D_RESOURCE_DESC_INCREMENT;
 
         case D3D12_DESCRIPTOR_HEAP_TYPE_RTV:
         case D3D12_DESCRIPTOR_HEAP_TYPE_DSV:
@@ -3509,10 +3727,12 @@ static void STDMETHODCALLTYPE d3d12_device_CreateConstantBufferView(d3d12_device
         const D3D12_CONSTANT_BUFFER_VIEW_DESC *desc, D3D12_CPU_DESCRIPTOR_HANDLE descriptor)
 {
     struct d3d12_device *device = impl_from_ID3D12Device(iface);
+    struct d3d12_desc dst_desc;
 
     TRACE("iface %p, desc %p, descriptor %#lx.\n", iface, desc, descriptor.ptr);
 
-    d3d12_desc_create_cbv(d3d12_desc_from_cpu_handle(descriptor), device, desc);
+    dst_desc = d3d12_desc_from_cpu_handle(descriptor);
+    d3d12_desc_create_cbv(&dst_desc, device, desc);
 }
 
 static void STDMETHODCALLTYPE d3d12_device_CreateShaderResourceView(d3d12_device_iface *iface,
@@ -3520,12 +3740,13 @@ static void STDMETHODCALLTYPE d3d12_device_CreateShaderResourceView(d3d12_device
         D3D12_CPU_DESCRIPTOR_HANDLE descriptor)
 {
     struct d3d12_device *device = impl_from_ID3D12Device(iface);
+    struct d3d12_desc dst_desc;
 
     TRACE("iface %p, resource %p, desc %p, descriptor %#lx.\n",
             iface, resource, desc, descriptor.ptr);
 
-    d3d12_desc_create_srv(d3d12_desc_from_cpu_handle(descriptor),
-            device, impl_from_ID3D12Resource(resource), desc);
+    dst_desc = d3d12_desc_from_cpu_handle(descriptor);
+    d3d12_desc_create_srv(&dst_desc, device, impl_from_ID3D12Resource(resource), desc);
 }
 
 VKD3D_THREAD_LOCAL struct D3D12_UAV_INFO *d3d12_uav_info = NULL;
@@ -3540,18 +3761,18 @@ static void STDMETHODCALLTYPE d3d12_device_CreateUnorderedAccessView(d3d12_devic
     VkResult vr;
     struct d3d12_resource *d3d12_resource_ = impl_from_ID3D12Resource(resource);
     struct d3d12_device *device = impl_from_ID3D12Device(iface);
-    struct d3d12_desc *d3d12_desc_cpu = d3d12_desc_from_cpu_handle(descriptor);
+    struct d3d12_desc d3d12_desc_cpu = d3d12_desc_from_cpu_handle(descriptor);
     TRACE("iface %p, resource %p, counter_resource %p, desc %p, descriptor %#lx.\n",
             iface, resource, counter_resource, desc, descriptor.ptr);
 
-    d3d12_desc_create_uav(d3d12_desc_cpu,
+    d3d12_desc_create_uav(&d3d12_desc_cpu,
             device, d3d12_resource_,
             impl_from_ID3D12Resource(counter_resource), desc);
     
     /* d3d12_uav_info stores the pointer to data from previous call to d3d12_device_vkd3d_ext_CaptureUAVInfo(). Below code will update the data. */
     if (d3d12_uav_info)
     {
-        imageViewHandleInfo.imageView = d3d12_desc_cpu->info.view->vk_image_view;
+        imageViewHandleInfo.imageView = d3d12_desc_cpu.info->view->vk_image_view;
         imageViewHandleInfo.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
 
         vk_procs = &device->vk_procs;
@@ -3596,10 +3817,12 @@ static void STDMETHODCALLTYPE d3d12_device_CreateSampler(d3d12_device_iface *ifa
         const D3D12_SAMPLER_DESC *desc, D3D12_CPU_DESCRIPTOR_HANDLE descriptor)
 {
     struct d3d12_device *device = impl_from_ID3D12Device(iface);
+    struct d3d12_desc dst_desc;
 
     TRACE("iface %p, desc %p, descriptor %#lx.\n", iface, desc, descriptor.ptr);
 
-    d3d12_desc_create_sampler(d3d12_desc_from_cpu_handle(descriptor), device, desc);
+    dst_desc = d3d12_desc_from_cpu_handle(descriptor);
+    d3d12_desc_create_sampler(&dst_desc, device, desc);
 }
 
 static inline D3D12_CPU_DESCRIPTOR_HANDLE d3d12_advance_cpu_descriptor_handle(D3D12_CPU_DESCRIPTOR_HANDLE handle,
@@ -3618,6 +3841,7 @@ static inline void d3d12_device_copy_descriptors(struct d3d12_device *device,
 {
     unsigned int dst_range_idx, dst_idx, src_range_idx, src_idx;
     D3D12_CPU_DESCRIPTOR_HANDLE dst, src, dst_start, src_start;
+    struct d3d12_desc dst_desc, src_desc;
     unsigned int dst_range_size, src_range_size, copy_count;
     unsigned int increment;
 
@@ -3638,22 +3862,26 @@ static inline void d3d12_device_copy_descriptors(struct d3d12_device *device,
         dst = d3d12_advance_cpu_descriptor_handle(dst_start, increment, dst_idx);
         src = d3d12_advance_cpu_descriptor_handle(src_start, increment, src_idx);
 
-        switch (descriptor_heap_type)
+        /* Empty ranges may point anywhere, e.g. past the end of a heap, so don't decode them. */
+        if (copy_count)
         {
-            case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER:
-            case D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV:
-                d3d12_desc_copy(d3d12_desc_from_cpu_handle(dst),
-                        d3d12_desc_from_cpu_handle(src), copy_count,
-                        descriptor_heap_type, device);
-                break;
-            case D3D12_DESCRIPTOR_HEAP_TYPE_RTV:
-            case D3D12_DESCRIPTOR_HEAP_TYPE_DSV:
-                d3d12_rtv_desc_copy(d3d12_rtv_desc_from_cpu_handle(dst),
-                        d3d12_rtv_desc_from_cpu_handle(src), copy_count);
-                break;
-            default:
-                ERR("Unhandled descriptor heap type %u.\n", descriptor_heap_type);
-                return;
+            switch (descriptor_heap_type)
+            {
+                case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER:
+                case D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV:
+                    dst_desc = d3d12_desc_from_cpu_handle(dst);
+                    src_desc = d3d12_desc_from_cpu_handle(src);
+                    d3d12_desc_copy(&dst_desc, &src_desc, copy_count, descriptor_heap_type, device);
+                    break;
+                case D3D12_DESCRIPTOR_HEAP_TYPE_RTV:
+                case D3D12_DESCRIPTOR_HEAP_TYPE_DSV:
+                    d3d12_rtv_desc_copy(d3d12_rtv_desc_from_cpu_handle(dst),
+                            d3d12_rtv_desc_from_cpu_handle(src), copy_count);
+                    break;
+                default:
+                    ERR("Unhandled descriptor heap type %u.\n", descriptor_heap_type);
+                    return;
+            }
         }
 
         dst_idx += copy_count;
@@ -4510,10 +4738,6 @@ static void STDMETHODCALLTYPE d3d12_device_GetRaytracingAccelerationStructurePre
 {
     struct d3d12_device *device = impl_from_ID3D12Device(iface);
 
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
-    struct vkd3d_acceleration_structure_build_info build_info;
-    VkAccelerationStructureBuildSizesInfoKHR size_info;
-
     TRACE("iface %p, desc %p, info %p!\n", iface, desc, info);
 
     if (!d3d12_device_supports_ray_tracing_tier_1_0(device))
@@ -4523,25 +4747,11 @@ static void STDMETHODCALLTYPE d3d12_device_GetRaytracingAccelerationStructurePre
         return;
     }
 
-    if (!vkd3d_acceleration_structure_convert_inputs(device, &build_info, desc))
+    if (!vkd3d_acceleration_structure_get_prebuild_info(device, desc, info))
     {
         ERR("Failed to convert inputs.\n");
         memset(info, 0, sizeof(*info));
-        return;
     }
-
-    memset(&size_info, 0, sizeof(size_info));
-    size_info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-
-    VK_CALL(vkGetAccelerationStructureBuildSizesKHR(device->vk_device,
-            VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &build_info.build_info,
-            build_info.primitive_counts, &size_info));
-
-    vkd3d_acceleration_structure_build_info_cleanup(&build_info);
-
-    info->ResultDataMaxSizeInBytes = size_info.accelerationStructureSize;
-    info->ScratchDataSizeInBytes = size_info.buildScratchSize;
-    info->UpdateScratchDataSizeInBytes = size_info.updateScratchSize;
 }
 
 static D3D12_DRIVER_MATCHING_IDENTIFIER_STATUS STDMETHODCALLTYPE d3d12_device_CheckDriverMatchingIdentifier(d3d12_device_iface *iface,
@@ -4566,7 +4776,41 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_SetBackgroundProcessingMode(d3d12_
     return E_NOTIMPL;
 }
 
-CONST_VTBL struct ID3D12Device6Vtbl d3d12_device_vtbl =
+static HRESULT STDMETHODCALLTYPE d3d12_device_AddToStateObject(d3d12_device_iface *iface,
+        const D3D12_STATE_OBJECT_DESC *addition, ID3D12StateObject *state_object_to_grow_from,
+        REFIID riid, void **new_state_object)
+{
+    struct d3d12_device *device = impl_from_ID3D12Device(iface);
+    struct d3d12_state_object *parent;
+    struct d3d12_state_object *state;
+    HRESULT hr;
+
+    TRACE("iface %p, addition %p, state_object_to_grow_from %p, riid %s, new_state_object %p.\n",
+            iface, addition, state_object_to_grow_from, debugstr_guid(riid), new_state_object);
+
+    if (!state_object_to_grow_from)
+    {
+        WARN("No state object to grow from.\n");
+        return E_INVALIDARG;
+    }
+
+    parent = impl_from_ID3D12StateObject(state_object_to_grow_from);
+    if (FAILED(hr = d3d12_state_object_add(device, addition, parent, &state)))
+        return hr;
+
+    return return_interface(&state->ID3D12StateObject_iface, &IID_ID3D12StateObject, riid, new_state_object);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d12_device_CreateProtectedResourceSession1(d3d12_device_iface *iface,
+        const D3D12_PROTECTED_RESOURCE_SESSION_DESC1 *desc, REFIID riid, void **session)
+{
+    FIXME("iface %p, desc %p, riid %s, session %p stub!\n",
+            iface, desc, debugstr_guid(riid), session);
+
+    return E_NOTIMPL;
+}
+
+CONST_VTBL struct ID3D12Device7Vtbl d3d12_device_vtbl =
 {
     /* IUnknown methods */
     d3d12_device_QueryInterface,
@@ -4643,6 +4887,9 @@ CONST_VTBL struct ID3D12Device6Vtbl d3d12_device_vtbl =
     d3d12_device_CheckDriverMatchingIdentifier,
     /* ID3D12Device6 methods */
     d3d12_device_SetBackgroundProcessingMode,
+    /* ID3D12Device7 methods */
+    d3d12_device_AddToStateObject,
+    d3d12_device_CreateProtectedResourceSession1,
 };
 
 #ifdef VKD3D_ENABLE_PROFILING
@@ -4943,13 +5190,76 @@ static void d3d12_device_caps_init_feature_options6(struct d3d12_device *device)
 
 static void d3d12_device_caps_init_feature_options7(struct d3d12_device *device)
 {
+    const VkPhysicalDeviceMeshShaderPropertiesEXT *mesh_properties = &device->device_info.mesh_shader_properties;
+    const VkPhysicalDeviceMeshShaderFeaturesEXT *mesh_features = &device->device_info.mesh_shader_features;
     D3D12_FEATURE_DATA_D3D12_OPTIONS7 *options7 = &device->d3d12_caps.options7;
 
+    /* Mesh shaders are SM 6.5 DXIL only. D3D12 requires amplification shader support
+     * alongside mesh shaders, as well as the full 256 vertex / 256 primitive output limits. */
+    if (device->d3d12_caps.max_shader_model >= D3D_SHADER_MODEL_6_5 &&
+            mesh_features->meshShader && mesh_features->taskShader &&
+            mesh_properties->maxMeshOutputVertices >= 256 &&
+            mesh_properties->maxMeshOutputPrimitives >= 256 &&
+            mesh_properties->maxMeshWorkGroupInvocations >= 128 &&
+            mesh_properties->maxTaskWorkGroupInvocations >= 128 &&
+            mesh_properties->maxTaskPayloadSize >= 16 * 1024)
+        options7->MeshShaderTier = D3D12_MESH_SHADER_TIER_1;
+    else
+        options7->MeshShaderTier = D3D12_MESH_SHADER_TIER_NOT_SUPPORTED;
+
     /* Not supported */
-    options7->MeshShaderTier = D3D12_MESH_SHADER_TIER_NOT_SUPPORTED;
     options7->SamplerFeedbackTier = D3D12_SAMPLER_FEEDBACK_TIER_NOT_SUPPORTED;
 }
 
+static void d3d12_device_caps_init_feature_options8(struct d3d12_device *device)
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS8 *options8 = &device->d3d12_caps.options8;
+
+    /* Block compressed textures still need block aligned dimensions. */
+    options8->UnalignedBlockTexturesSupported = FALSE;
+}
+
+static void d3d12_device_caps_init_feature_options9(struct d3d12_device *device)
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS9 *options9 = &device->d3d12_caps.options9;
+
+    /* Currently not supported */
+    options9->MeshShaderPipelineStatsSupported = FALSE;
+    options9->MeshShaderSupportsFullRangeRenderTargetArrayIndex = FALSE;
+    options9->AtomicInt64OnTypedResourceSupported = FALSE;
+    options9->AtomicInt64OnGroupSharedSupported = FALSE;
+    options9->DerivativesInMeshAndAmplificationShadersSupported = FALSE;
+    options9->WaveMMATier = D3D12_WAVE_MMA_TIER_NOT_SUPPORTED;
+}
+
+static void d3d12_device_caps_init_feature_options10(struct d3d12_device *device)
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS10 *options10 = &device->d3d12_caps.options10;
+
+    /* Currently not supported */
+    options10->VariableRateShadingSumCombinerSupported = FALSE;
+    options10->MeshShaderPerPrimitiveShadingRateSupported = FALSE;
+}
+
+static void d3d12_device_caps_init_feature_options11(struct d3d12_device *device)
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS11 *options11 = &device->d3d12_caps.options11;
+
+    /* Currently not supported */
+    options11->AtomicInt64OnDescriptorHeapResourceSupported = FALSE;
+}
+
+static void d3d12_device_caps_init_feature_options12(struct d3d12_device *device)
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS12 *options12 = &device->d3d12_caps.options12;
+
+    options12->MSPrimitivesPipelineStatisticIncludesCulledPrimitives = D3D12_TRI_STATE_UNKNOWN;
+    /* ID3D12GraphicsCommandList7::Barrier maps directly to vkCmdPipelineBarrier2. */
+    options12->EnhancedBarriersSupported = device->device_info.synchronization2_features.synchronization2;
+    /* Not supported */
+    options12->RelaxedFormatCastingSupported = FALSE;
+}
+
 static void d3d12_device_caps_init_feature_level(struct d3d12_device *device)
 {
     const VkPhysicalDeviceFeatures *features = &device->device_info.features2.features;
@@ -5174,6 +5484,11 @@ static void d3d12_device_caps_init(struct d3d12_device *device)
     d3d12_device_caps_init_feature_options5(device);
     d3d12_device_caps_init_feature_options6(device);
     d3d12_device_caps_init_feature_options7(device);
+    d3d12_device_caps_init_feature_options8(device);
+    d3d12_device_caps_init_feature_options9(device);
+    d3d12_device_caps_init_feature_options10(device);
+    d3d12_device_caps_init_feature_options11(device);
+    d3d12_device_caps_init_feature_options12(device);
     d3d12_device_caps_init_feature_level(device);
 
     d3d12_device_caps_override(device);
@@ -5262,7 +5577,14 @@ static HRESULT d3d12_device_init(struct d3d12_device *device,
             goto out_cleanup_global_pipeline_cache;
     }
 
+    if (FAILED(hr = vkd3d_queue_worker_pool_init(&device->queue_worker_pool, device)))
+        goto out_cleanup_descriptor_qa_global_info;
+
+    if (FAILED(hr = vkd3d_fence_worker_start(&device->fence_worker, device)))
+        goto out_cleanup_queue_worker_pool;
+
     vkd3d_render_pass_cache_init(&device->render_pass_cache);
+    vkd3d_acceleration_structure_prebuild_cache_init(&device->prebuild_cache);
 
     if ((device->parent = create_info->parent))
         IUnknown_AddRef(device->parent);
@@ -5276,6 +5598,10 @@ static HRESULT d3d12_device_init(struct d3d12_device *device,
 
     return S_OK;
 
+out_cleanup_queue_worker_pool:
+    vkd3d_queue_worker_pool_cleanup(&device->queue_worker_pool, device);
+out_cleanup_descriptor_qa_global_info:
+    vkd3d_descriptor_debug_free_global_info(device->descriptor_qa_global_info, device);
 out_cleanup_global_pipeline_cache:
     d3d12_device_global_pipeline_cache_cleanup(device);
 out_cleanup_debug_ring:
@@ -5298,7 +5624,7 @@ out_free_private_store:
     vkd3d_private_store_destroy(&device->private_store);
 out_free_vk_resources:
     vk_procs = &device->vk_procs;
-    VK_CALL(vkDestroyDevice(device->vk_device, NULL));
+    VK_CALL(vkDestroyDevice(device->vk_device, &vkd3d_vk_allocator));
 out_free_instance:
     vkd3d_instance_decref(device->vkd3d_instance);
 out_free_mutex:
@@ -5321,14 +5647,21 @@ bool d3d12_device_validate_shader_meta(struct d3d12_device *device, const struct
 HRESULT d3d12_device_create(struct vkd3d_instance *instance,
         const struct vkd3d_device_create_info *create_info, struct d3d12_device **device)
 {
+    struct d3d12_device_singleton *singleton;
     struct d3d12_device *object;
     HRESULT hr;
 
     pthread_mutex_lock(&d3d12_device_map_mutex);
-    if ((object = d3d12_find_device_singleton(create_info->adapter_luid)))
+    d3d12_reap_released_device_singletons();
+
+    if ((singleton = d3d12_find_device_singleton(create_info->adapter_luid)))
     {
+        object = singleton->device;
         TRACE("Returned existing singleton device %p.\n", object);
 
+        /* Resurrecting a device in its grace period is safe,
+         * nothing else can observe it without the map lock. */
+        singleton->release_deadline_ns = 0;
         d3d12_device_add_ref(*device = object);
         pthread_mutex_unlock(&d3d12_device_map_mutex);
         return S_OK;
@@ -5367,6 +5700,86 @@ HRESULT d3d12_device_create(struct vkd3d_instance *instance,
     return S_OK;
 }
 
+HRESULT d3d12_device_probe(struct vkd3d_instance *instance,
+        const struct vkd3d_device_create_info *create_info)
+{
+    struct vkd3d_queue_family_info queue_families[VKD3D_QUEUE_FAMILY_COUNT];
+    struct vkd3d_device_queue_info device_queue_info;
+    struct d3d12_device_singleton *singleton;
+    bool *user_extension_supported = NULL;
+    struct d3d12_device *object;
+    uint32_t extension_count;
+    bool supported;
+    unsigned int i;
+    HRESULT hr;
+
+    TRACE("instance %p, create_info %p.\n", instance, create_info);
+
+    pthread_mutex_lock(&d3d12_device_map_mutex);
+    if ((singleton = d3d12_find_device_singleton(create_info->adapter_luid)))
+    {
+        supported = d3d12_device_supports_feature_level(singleton->device, create_info->minimum_feature_level);
+        pthread_mutex_unlock(&d3d12_device_map_mutex);
+        goto done;
+    }
+    pthread_mutex_unlock(&d3d12_device_map_mutex);
+
+    /* Only physical device queries are needed to work out the caps,
+     * so skip creating the Vulkan device and everything built on top of it. */
+    if (!(object = vkd3d_calloc(1, sizeof(*object))))
+        return E_OUTOFMEMORY;
+
+    object->vkd3d_instance = instance;
+    object->vk_info = instance->vk_info;
+
+    if (create_info->optional_device_extension_count)
+    {
+        if (!(user_extension_supported = vkd3d_calloc(create_info->optional_device_extension_count, sizeof(bool))))
+        {
+            vkd3d_free(object);
+            return E_OUTOFMEMORY;
+        }
+    }
+
+    hr = vkd3d_init_physical_device(object, create_info, &device_queue_info,
+            &extension_count, user_extension_supported);
+    vkd3d_free(user_extension_supported);
+
+    if (FAILED(hr))
+    {
+        vkd3d_free(object);
+        return hr;
+    }
+
+    memset(queue_families, 0, sizeof(queue_families));
+    for (i = 0; i < VKD3D_QUEUE_FAMILY_COUNT; i++)
+    {
+        queue_families[i].vk_family_index = device_queue_info.family_index[i];
+        queue_families[i].vk_queue_flags = device_queue_info.vk_properties[i].queueFlags;
+        queue_families[i].timestamp_bits = device_queue_info.vk_properties[i].timestampValidBits;
+        /* Unused families have zeroed properties. */
+        queue_families[i].queue_count = min(device_queue_info.vk_properties[i].queueCount,
+                VKD3D_MAX_QUEUE_COUNT_PER_FAMILY);
+        object->queue_families[i] = &queue_families[i];
+    }
+
+    /* Caps only look at the bindless tier flags, which don't need a Vulkan device. */
+    object->bindless_state.flags = vkd3d_bindless_get_physical_device_flags(object);
+
+    d3d12_device_caps_init(object);
+    supported = d3d12_device_supports_feature_level(object, create_info->minimum_feature_level);
+    vkd3d_free(object);
+
+done:
+    if (!supported)
+    {
+        WARN("Feature level %#x is not supported.\n", create_info->minimum_feature_level);
+        return E_INVALIDARG;
+    }
+
+    return S_OK;
+}
+
 void d3d12_device_mark_as_removed(struct d3d12_device *device, HRESULT reason,
         const char *message, ...)
 {
@@ -5428,6 +5841,59 @@ HRESULT vkd3d_join_thread(struct vkd3d_instance *instance, union vkd3d_thread_ha
     return hr;
 }
 
+struct vkd3d_parallel_join_context
+{
+    vkd3d_join_func func;
+    void *userdata;
+};
+
+static void vkd3d_parallel_join_run(const struct vkd3d_parallel_join_context *context)
+{
+    unsigned int spin_count = 0;
+
+    while (context->func(context->userdata) == VKD3D_JOIN_IDLE)
+        vkd3d_spin_wait(&spin_count);
+}
+
+static void *vkd3d_parallel_join_thread_main(void *userdata)
+{
+    vkd3d_set_thread_name("vkd3d_join");
+    vkd3d_parallel_join_run(userdata);
+    return NULL;
+}
+
+unsigned int vkd3d_parallel_join(struct vkd3d_instance *instance,
+        vkd3d_join_func func, void *userdata, unsigned int thread_count)
+{
+    struct vkd3d_parallel_join_context context;
+    union vkd3d_thread_handle *threads = NULL;
+    unsigned int helper_count = 0, i;
+
+    context.func = func;
+    context.userdata = userdata;
+
+    /* Helper threads are a pure optimization, the calling thread alone is
+     * always able to finish the operation. */
+    if (thread_count > 1 && (threads = vkd3d_malloc((thread_count - 1) * sizeof(*threads))))
+    {
+        for (i = 0; i < thread_count - 1; i++)
+        {
+            if (FAILED(vkd3d_create_thread(instance, vkd3d_parallel_join_thread_main,
+                    &context, &threads[helper_count])))
+                break;
+            helper_count++;
+        }
+    }
+
+    vkd3d_parallel_join_run(&context);
+
+    for (i = 0; i < helper_count; i++)
+        vkd3d_join_thread(instance, &threads[i]);
+
+    vkd3d_free(threads);
+    return helper_count + 1;
+}
+
 VKD3D_EXPORT IUnknown *vkd3d_get_device_parent(ID3D12Device *device)
 {
     struct d3d12_device *d3d12_device = impl_from_ID3D12Device((d3d12_device_iface *)device);
@@ -107,7 +107,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_vkd3d_ext_CreateCubinComputeShader
     moduleCreateInfo.pData = cubin_data;
     moduleCreateInfo.dataSize = cubin_size;
     vk_procs = &device->vk_procs;
-    if ((vr = VK_CALL(vkCreateCuModuleNVX(vk_device, &moduleCreateInfo, NULL, &handle->vkCuModule))) < 0)
+    if ((vr = VK_CALL(vkCreateCuModuleNVX(vk_device, &moduleCreateInfo, &vkd3d_vk_allocator, &handle->vkCuModule))) < 0)
     {
         ERR("Failed to create cubin shader, vr %d.\n", vr);
         vkd3d_free(handle);
@@ -117,10 +117,10 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_vkd3d_ext_CreateCubinComputeShader
     functionCreateInfo.module = handle->vkCuModule;
     functionCreateInfo.pName = shader_name;
 
-    if ((vr = VK_CALL(vkCreateCuFunctionNVX(vk_device, &functionCreateInfo, NULL, &handle->vkCuFunction))) < 0)
+    if ((vr = VK_CALL(vkCreateCuFunctionNVX(vk_device, &functionCreateInfo, &vkd3d_vk_allocator, &handle->vkCuFunction))) < 0)
     {
         ERR("Failed to create cubin function module, vr %d.\n", vr);
-        VK_CALL(vkDestroyCuModuleNVX(vk_device, handle->vkCuModule, NULL));
+        VK_CALL(vkDestroyCuModuleNVX(vk_device, handle->vkCuModule, &vkd3d_vk_allocator));
         vkd3d_free(handle);
         return hresult_from_vk_result(vr);
     }
@@ -143,8 +143,8 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_vkd3d_ext_DestroyCubinComputeShade
     vk_device = device->vk_device;
     vk_procs = &device->vk_procs;
 
-    VK_CALL(vkDestroyCuFunctionNVX(vk_device, handle->vkCuFunction, NULL));
-    VK_CALL(vkDestroyCuModuleNVX(vk_device, handle->vkCuModule, NULL));
+    VK_CALL(vkDestroyCuFunctionNVX(vk_device, handle->vkCuFunction, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyCuModuleNVX(vk_device, handle->vkCuModule, &vkd3d_vk_allocator));
     vkd3d_free(handle);
     return S_OK;
 }
@@ -154,9 +154,9 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_vkd3d_ext_GetCudaTextureObject(ID3
 {
     VkImageViewHandleInfoNVX imageViewHandleInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_HANDLE_INFO_NVX };
     const struct vkd3d_vk_device_procs *vk_procs;
-    struct d3d12_desc *sampler_desc;
+    struct d3d12_desc sampler_desc;
     struct d3d12_device *device;
-    struct d3d12_desc *srv_desc;
+    struct d3d12_desc srv_desc;
     
     TRACE("iface %p, srv_handle %#x, sampler_handle %#x, cuda_texture_handle %p.\n", iface, srv_handle, sampler_handle, cuda_texture_handle);
     if (!cuda_texture_handle)
@@ -166,8 +166,8 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_vkd3d_ext_GetCudaTextureObject(ID3
     srv_desc = d3d12_desc_from_cpu_handle(srv_handle);
     sampler_desc = d3d12_desc_from_cpu_handle(sampler_handle);
 
-    imageViewHandleInfo.imageView = srv_desc->info.view->vk_image_view;
-    imageViewHandleInfo.sampler = sampler_desc->info.view->vk_sampler;
+    imageViewHandleInfo.imageView = srv_desc.info->view->vk_image_view;
+    imageViewHandleInfo.sampler = sampler_desc.info->view->vk_sampler;
     imageViewHandleInfo.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 
     vk_procs = &device->vk_procs;
@@ -181,7 +181,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_vkd3d_ext_GetCudaSurfaceObject(ID3
     VkImageViewHandleInfoNVX imageViewHandleInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_HANDLE_INFO_NVX };
     const struct vkd3d_vk_device_procs *vk_procs;
     struct d3d12_device *device;
-    struct d3d12_desc *uav_desc;
+    struct d3d12_desc uav_desc;
     
     TRACE("iface %p, uav_handle %#x, cuda_surface_handle %p.\n", iface, uav_handle, cuda_surface_handle);
     if (!cuda_surface_handle)
@@ -190,7 +190,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_device_vkd3d_ext_GetCudaSurfaceObject(ID3
     device = d3d12_device_from_ID3D12DeviceExt(iface);
     uav_desc = d3d12_desc_from_cpu_handle(uav_handle);
 
-    imageViewHandleInfo.imageView = uav_desc->info.view->vk_image_view;
+    imageViewHandleInfo.imageView = uav_desc.info->view->vk_image_view;
     imageViewHandleInfo.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
 
     vk_procs = &device->vk_procs;
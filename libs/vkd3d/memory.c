@@ -150,7 +150,7 @@ void vkd3d_free_device_memory(struct d3d12_device *device, const struct vkd3d_de
         return;
     }
 
-    VK_CALL(vkFreeMemory(device->vk_device, allocation->vk_memory, NULL));
+    VK_CALL(vkFreeMemory(device->vk_device, allocation->vk_memory, &vkd3d_vk_allocator));
     budget_sensitive = !!(device->memory_info.budget_sensitive_mask & (1u << allocation->vk_memory_type));
     if (budget_sensitive)
     {
@@ -227,7 +227,7 @@ static HRESULT vkd3d_try_allocate_device_memory(struct d3d12_device *device,
             }
         }
 
-        vr = VK_CALL(vkAllocateMemory(device->vk_device, &allocate_info, NULL, &allocation->vk_memory));
+        vr = VK_CALL(vkAllocateMemory(device->vk_device, &allocate_info, &vkd3d_vk_allocator, &allocation->vk_memory));
 
         if (budget_sensitive)
         {
@@ -459,7 +459,7 @@ static void vkd3d_memory_allocation_free(const struct vkd3d_memory_allocation *a
     }
 
     if (allocation->flags & VKD3D_ALLOCATION_FLAG_GLOBAL_BUFFER)
-        VK_CALL(vkDestroyBuffer(device->vk_device, allocation->resource.vk_buffer, NULL));
+        VK_CALL(vkDestroyBuffer(device->vk_device, allocation->resource.vk_buffer, &vkd3d_vk_allocator));
 
     vkd3d_free_device_memory(device, &allocation->device_allocation);
 }
@@ -546,7 +546,7 @@ static HRESULT vkd3d_memory_allocation_init(struct vkd3d_memory_allocation *allo
         allocation->flags |= VKD3D_ALLOCATION_FLAG_ALLOW_WRITE_WATCH;
         if (!(host_ptr = vkd3d_allocate_write_watch_pointer(&info->heap_properties, memory_requirements.size)))
         {
-            VK_CALL(vkDestroyBuffer(device->vk_device, allocation->resource.vk_buffer, NULL));
+            VK_CALL(vkDestroyBuffer(device->vk_device, allocation->resource.vk_buffer, &vkd3d_vk_allocator));
             return E_INVALIDARG;
         }
     }
@@ -569,7 +569,7 @@ static HRESULT vkd3d_memory_allocation_init(struct vkd3d_memory_allocation *allo
 
     if (FAILED(hr))
     {
-        VK_CALL(vkDestroyBuffer(device->vk_device, allocation->resource.vk_buffer, NULL));
+        VK_CALL(vkDestroyBuffer(device->vk_device, allocation->resource.vk_buffer, &vkd3d_vk_allocator));
         return hr;
     }
 
@@ -860,8 +860,8 @@ static void vkd3d_memory_allocator_cleanup_clear_queue(struct vkd3d_memory_alloc
     struct vkd3d_memory_clear_queue *clear_queue = &allocator->clear_queue;
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
 
-    VK_CALL(vkDestroyCommandPool(device->vk_device, clear_queue->vk_command_pool, NULL));
-    VK_CALL(vkDestroySemaphore(device->vk_device, clear_queue->vk_semaphore, NULL));
+    VK_CALL(vkDestroyCommandPool(device->vk_device, clear_queue->vk_command_pool, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroySemaphore(device->vk_device, clear_queue->vk_semaphore, &vkd3d_vk_allocator));
 
     vkd3d_free(clear_queue->allocations);
     pthread_mutex_destroy(&clear_queue->mutex);
@@ -893,7 +893,7 @@ static HRESULT vkd3d_memory_allocator_init_clear_queue(struct vkd3d_memory_alloc
     command_pool_info.queueFamilyIndex = device->queue_families[VKD3D_QUEUE_FAMILY_INTERNAL_COMPUTE]->vk_family_index;
 
     if ((vr = VK_CALL(vkCreateCommandPool(device->vk_device, &command_pool_info,
-            NULL, &clear_queue->vk_command_pool))) < 0)
+            &vkd3d_vk_allocator, &clear_queue->vk_command_pool))) < 0)
     {
         ERR("Failed to create command pool, vr %d.\n", vr);
         hr = hresult_from_vk_result(vr);
@@ -924,7 +924,7 @@ static HRESULT vkd3d_memory_allocator_init_clear_queue(struct vkd3d_memory_alloc
     semaphore_info.flags = 0;
 
     if ((vr = VK_CALL(vkCreateSemaphore(device->vk_device,
-            &semaphore_info, NULL, &clear_queue->vk_semaphore))) < 0)
+            &semaphore_info, &vkd3d_vk_allocator, &clear_queue->vk_semaphore))) < 0)
     {
         ERR("Failed to create semaphore, vr %d.\n", vr);
         hr = hresult_from_vk_result(vr);
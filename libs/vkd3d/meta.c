@@ -35,7 +35,7 @@ static VkResult vkd3d_meta_create_shader_module(struct d3d12_device *device,
     shader_module_info.codeSize = code_size;
     shader_module_info.pCode = code;
 
-    return VK_CALL(vkCreateShaderModule(device->vk_device, &shader_module_info, NULL, module));
+    return VK_CALL(vkCreateShaderModule(device->vk_device, &shader_module_info, &vkd3d_vk_allocator, module));
 }
 
 static VkResult vkd3d_meta_create_descriptor_set_layout(struct d3d12_device *device,
@@ -50,7 +50,7 @@ static VkResult vkd3d_meta_create_descriptor_set_layout(struct d3d12_device *dev
     set_layout_info.bindingCount = binding_count;
     set_layout_info.pBindings = bindings;
 
-    return VK_CALL(vkCreateDescriptorSetLayout(device->vk_device, &set_layout_info, NULL, set_layout));
+    return VK_CALL(vkCreateDescriptorSetLayout(device->vk_device, &set_layout_info, &vkd3d_vk_allocator, set_layout));
 }
 
 static VkResult vkd3d_meta_create_sampler(struct d3d12_device *device, VkFilter filter, VkSampler *vk_sampler)
@@ -91,7 +91,7 @@ static VkResult vkd3d_meta_create_pipeline_layout(struct d3d12_device *device,
     pipeline_layout_info.pushConstantRangeCount = push_constant_range_count;
     pipeline_layout_info.pPushConstantRanges = push_constant_ranges;
 
-    return VK_CALL(vkCreatePipelineLayout(device->vk_device, &pipeline_layout_info, NULL, pipeline_layout));
+    return VK_CALL(vkCreatePipelineLayout(device->vk_device, &pipeline_layout_info, &vkd3d_vk_allocator, pipeline_layout));
 }
 
 static void vkd3d_meta_make_shader_stage(VkPipelineShaderStageCreateInfo *info, VkShaderStageFlagBits stage,
@@ -131,8 +131,8 @@ static VkResult vkd3d_meta_create_compute_pipeline(struct d3d12_device *device,
     vkd3d_meta_make_shader_stage(&pipeline_info.stage,
             VK_SHADER_STAGE_COMPUTE_BIT, module, "main", specialization_info);
 
-    vr = VK_CALL(vkCreateComputePipelines(device->vk_device, VK_NULL_HANDLE, 1, &pipeline_info, NULL, pipeline));
-    VK_CALL(vkDestroyShaderModule(device->vk_device, module, NULL));
+    vr = VK_CALL(vkCreateComputePipelines(device->vk_device, VK_NULL_HANDLE, 1, &pipeline_info, &vkd3d_vk_allocator, pipeline));
+    VK_CALL(vkDestroyShaderModule(device->vk_device, module, &vkd3d_vk_allocator));
 
     return vr;
 }
@@ -196,7 +196,7 @@ static VkResult vkd3d_meta_create_render_pass(struct d3d12_device *device, VkSam
     pass_info.correlatedViewMaskCount = 0;
     pass_info.pCorrelatedViewMasks = NULL;
 
-    if ((vr = VK_CALL(vkCreateRenderPass2KHR(device->vk_device, &pass_info, NULL, vk_render_pass))) < 0)
+    if ((vr = VK_CALL(vkCreateRenderPass2KHR(device->vk_device, &pass_info, &vkd3d_vk_allocator, vk_render_pass))) < 0)
         ERR("Failed to create render pass, vr %d.\n", vr);
 
     return vr;
@@ -317,7 +317,7 @@ static VkResult vkd3d_meta_create_graphics_pipeline(struct vkd3d_meta_ops *meta_
     }
 
     if ((vr = VK_CALL(vkCreateGraphicsPipelines(meta_ops->device->vk_device,
-            VK_NULL_HANDLE, 1, &pipeline_info, NULL, vk_pipeline))))
+            VK_NULL_HANDLE, 1, &pipeline_info, &vkd3d_vk_allocator, vk_pipeline))))
         ERR("Failed to create graphics pipeline, vr %d.\n", vr);
 
     return vr;
@@ -453,23 +453,23 @@ void vkd3d_clear_uav_ops_cleanup(struct vkd3d_clear_uav_ops *meta_clear_uav_ops,
         &meta_clear_uav_ops->clear_uint,
     };
 
-    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_clear_uav_ops->vk_set_layout_buffer_raw, NULL));
-    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_clear_uav_ops->vk_set_layout_buffer, NULL));
-    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_clear_uav_ops->vk_set_layout_image, NULL));
+    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_clear_uav_ops->vk_set_layout_buffer_raw, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_clear_uav_ops->vk_set_layout_buffer, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_clear_uav_ops->vk_set_layout_image, &vkd3d_vk_allocator));
 
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_clear_uav_ops->vk_pipeline_layout_buffer_raw, NULL));
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_clear_uav_ops->vk_pipeline_layout_buffer, NULL));
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_clear_uav_ops->vk_pipeline_layout_image, NULL));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_clear_uav_ops->vk_pipeline_layout_buffer_raw, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_clear_uav_ops->vk_pipeline_layout_buffer, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_clear_uav_ops->vk_pipeline_layout_image, &vkd3d_vk_allocator));
 
     for (i = 0; i < ARRAY_SIZE(pipeline_sets); i++)
     {
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->buffer, NULL));
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->buffer_raw, NULL));
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_1d, NULL));
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_2d, NULL));
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_3d, NULL));
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_1d_array, NULL));
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_2d_array, NULL));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->buffer, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->buffer_raw, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_1d, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_2d, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_3d, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_1d_array, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline_sets[i]->image_2d_array, &vkd3d_vk_allocator));
     }
 }
 
@@ -623,14 +623,14 @@ void vkd3d_copy_image_ops_cleanup(struct vkd3d_copy_image_ops *meta_copy_image_o
     {
         struct vkd3d_copy_image_pipeline *pipeline = &meta_copy_image_ops->pipelines[i];
 
-        VK_CALL(vkDestroyRenderPass(device->vk_device, pipeline->vk_render_pass, NULL));
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline->vk_pipeline, NULL));
+        VK_CALL(vkDestroyRenderPass(device->vk_device, pipeline->vk_render_pass, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline->vk_pipeline, &vkd3d_vk_allocator));
     }
 
-    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_copy_image_ops->vk_set_layout, NULL));
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_copy_image_ops->vk_pipeline_layout, NULL));
-    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_copy_image_ops->vk_fs_float_module, NULL));
-    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_copy_image_ops->vk_fs_uint_module, NULL));
+    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_copy_image_ops->vk_set_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_copy_image_ops->vk_pipeline_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_copy_image_ops->vk_fs_float_module, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_copy_image_ops->vk_fs_uint_module, &vkd3d_vk_allocator));
 
     pthread_mutex_destroy(&meta_copy_image_ops->mutex);
 
@@ -702,7 +702,7 @@ static VkResult vkd3d_meta_create_swapchain_render_pass(struct d3d12_device *dev
     render_pass_info.correlatedViewMaskCount = 0;
     render_pass_info.pCorrelatedViewMasks = NULL;
 
-    return VK_CALL(vkCreateRenderPass2KHR(device->vk_device, &render_pass_info, NULL, render_pass));
+    return VK_CALL(vkCreateRenderPass2KHR(device->vk_device, &render_pass_info, &vkd3d_vk_allocator, render_pass));
 }
 
 static HRESULT vkd3d_meta_create_swapchain_pipeline(struct vkd3d_meta_ops *meta_ops,
@@ -737,7 +737,7 @@ static HRESULT vkd3d_meta_create_swapchain_pipeline(struct vkd3d_meta_ops *meta_
             NULL, &cb_state,
             NULL, &pipeline->vk_pipeline)) < 0)
     {
-        VK_CALL(vkDestroyRenderPass(meta_ops->device->vk_device, pipeline->vk_render_pass, NULL));
+        VK_CALL(vkDestroyRenderPass(meta_ops->device->vk_device, pipeline->vk_render_pass, &vkd3d_vk_allocator));
         return hresult_from_vk_result(vr);
     }
 
@@ -834,7 +834,7 @@ static HRESULT vkd3d_meta_create_copy_image_pipeline(struct vkd3d_meta_ops *meta
             has_depth_target ? &ds_state : NULL, has_depth_target ? NULL : &cb_state,
             &spec_info, &pipeline->vk_pipeline)) < 0)
     {
-        VK_CALL(vkDestroyRenderPass(meta_ops->device->vk_device, pipeline->vk_render_pass, NULL));
+        VK_CALL(vkDestroyRenderPass(meta_ops->device->vk_device, pipeline->vk_render_pass, &vkd3d_vk_allocator));
         return hresult_from_vk_result(vr);
     }
 
@@ -973,8 +973,8 @@ static void vkd3d_meta_ops_common_cleanup(struct vkd3d_meta_ops_common *meta_ops
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
 
-    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_ops_common->vk_module_fullscreen_vs, NULL));
-    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_ops_common->vk_module_fullscreen_gs, NULL));
+    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_ops_common->vk_module_fullscreen_vs, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_ops_common->vk_module_fullscreen_gs, &vkd3d_vk_allocator));
 }
 
 HRESULT vkd3d_swapchain_ops_init(struct vkd3d_swapchain_ops *meta_swapchain_ops, struct d3d12_device *device)
@@ -1049,18 +1049,18 @@ void vkd3d_swapchain_ops_cleanup(struct vkd3d_swapchain_ops *meta_swapchain_ops,
     {
         struct vkd3d_swapchain_pipeline *pipeline = &meta_swapchain_ops->pipelines[i];
 
-        VK_CALL(vkDestroyRenderPass(device->vk_device, pipeline->vk_render_pass, NULL));
-        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline->vk_pipeline, NULL));
+        VK_CALL(vkDestroyRenderPass(device->vk_device, pipeline->vk_render_pass, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipeline(device->vk_device, pipeline->vk_pipeline, &vkd3d_vk_allocator));
     }
 
     for (i = 0; i < 2; i++)
     {
-        VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_swapchain_ops->vk_set_layouts[i], NULL));
-        VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_swapchain_ops->vk_pipeline_layouts[i], NULL));
+        VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_swapchain_ops->vk_set_layouts[i], &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_swapchain_ops->vk_pipeline_layouts[i], &vkd3d_vk_allocator));
     }
 
-    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_swapchain_ops->vk_vs_module, NULL));
-    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_swapchain_ops->vk_fs_module, NULL));
+    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_swapchain_ops->vk_vs_module, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyShaderModule(device->vk_device, meta_swapchain_ops->vk_fs_module, &vkd3d_vk_allocator));
 
     pthread_mutex_destroy(&meta_swapchain_ops->mutex);
     vkd3d_free(meta_swapchain_ops->pipelines);
@@ -1197,15 +1197,15 @@ void vkd3d_query_ops_cleanup(struct vkd3d_query_ops *meta_query_ops,
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
 
-    VK_CALL(vkDestroyPipeline(device->vk_device, meta_query_ops->vk_gather_occlusion_pipeline, NULL));
-    VK_CALL(vkDestroyPipeline(device->vk_device, meta_query_ops->vk_gather_so_statistics_pipeline, NULL));
+    VK_CALL(vkDestroyPipeline(device->vk_device, meta_query_ops->vk_gather_occlusion_pipeline, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipeline(device->vk_device, meta_query_ops->vk_gather_so_statistics_pipeline, &vkd3d_vk_allocator));
 
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_query_ops->vk_gather_pipeline_layout, NULL));
-    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_query_ops->vk_gather_set_layout, NULL));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_query_ops->vk_gather_pipeline_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_query_ops->vk_gather_set_layout, &vkd3d_vk_allocator));
 
-    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_query_ops->vk_resolve_set_layout, NULL));
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_query_ops->vk_resolve_pipeline_layout, NULL));
-    VK_CALL(vkDestroyPipeline(device->vk_device, meta_query_ops->vk_resolve_binary_pipeline, NULL));
+    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, meta_query_ops->vk_resolve_set_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_query_ops->vk_resolve_pipeline_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipeline(device->vk_device, meta_query_ops->vk_resolve_binary_pipeline, &vkd3d_vk_allocator));
 }
 
 bool vkd3d_meta_get_query_gather_pipeline(struct vkd3d_meta_ops *meta_ops,
@@ -1251,6 +1251,7 @@ HRESULT vkd3d_predicate_ops_init(struct vkd3d_predicate_ops *meta_predicate_ops,
         { 1, VK_TRUE  }, /* VKD3D_PREDICATE_OP_DRAW_INDIRECT_COUNT */
         { 3, VK_FALSE }, /* VKD3D_PREDICATE_OP_DISPATCH */
         { 3, VK_TRUE  }, /* VKD3D_PREDICATE_OP_DISPATCH_INDIRECT */
+        { 3, VK_FALSE }, /* VKD3D_PREDICATE_OP_DRAW_MESH_TASKS */
     };
 
     static const VkSpecializationMapEntry spec_map[] =
@@ -1306,11 +1307,11 @@ void vkd3d_predicate_ops_cleanup(struct vkd3d_predicate_ops *meta_predicate_ops,
     size_t i;
 
     for (i = 0; i < VKD3D_PREDICATE_COMMAND_COUNT; i++)
-        VK_CALL(vkDestroyPipeline(device->vk_device, meta_predicate_ops->vk_command_pipelines[i], NULL));
-    VK_CALL(vkDestroyPipeline(device->vk_device, meta_predicate_ops->vk_resolve_pipeline, NULL));
+        VK_CALL(vkDestroyPipeline(device->vk_device, meta_predicate_ops->vk_command_pipelines[i], &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipeline(device->vk_device, meta_predicate_ops->vk_resolve_pipeline, &vkd3d_vk_allocator));
 
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_predicate_ops->vk_command_pipeline_layout, NULL));
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_predicate_ops->vk_resolve_pipeline_layout, NULL));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_predicate_ops->vk_command_pipeline_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, meta_predicate_ops->vk_resolve_pipeline_layout, &vkd3d_vk_allocator));
 }
 
 void vkd3d_meta_get_predicate_pipeline(struct vkd3d_meta_ops *meta_ops,
@@ -17,6 +17,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_PIPELINE
 #include "vkd3d_private.h"
 #include "vkd3d_string.h"
 
@@ -122,12 +123,13 @@ static void d3d12_state_object_cleanup(struct d3d12_state_object *object)
         d3d12_state_object_dec_ref(object->collections[i]);
     vkd3d_free(object->collections);
 
-    VK_CALL(vkDestroyPipeline(object->device->vk_device, object->pipeline, NULL));
+    VK_CALL(vkDestroyPipeline(object->device->vk_device, object->pipeline, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipeline(object->device->vk_device, object->pipeline_library, &vkd3d_vk_allocator));
 
     VK_CALL(vkDestroyPipelineLayout(object->device->vk_device,
-            object->local_static_sampler.pipeline_layout, NULL));
+            object->local_static_sampler.pipeline_layout, &vkd3d_vk_allocator));
     VK_CALL(vkDestroyDescriptorSetLayout(object->device->vk_device,
-            object->local_static_sampler.set_layout, NULL));
+            object->local_static_sampler.set_layout, &vkd3d_vk_allocator));
     if (object->local_static_sampler.desc_set)
     {
         vkd3d_sampler_state_free_descriptor_set(&object->device->sampler_state, object->device,
@@ -392,6 +394,10 @@ struct d3d12_state_object_pipeline_data
     VkPipeline *vk_libraries;
     size_t vk_libraries_size;
     size_t vk_libraries_count;
+
+    /* Set when growing an existing state object with AddToStateObject. */
+    struct d3d12_state_object *parent;
+    size_t parent_exports_offset;
 };
 
 static void d3d12_state_object_pipeline_data_cleanup(struct d3d12_state_object_pipeline_data *data,
@@ -413,7 +419,7 @@ static void d3d12_state_object_pipeline_data_cleanup(struct d3d12_state_object_p
     vkd3d_free(data->groups);
 
     for (i = 0; i < data->stages_count; i++)
-        VK_CALL(vkDestroyShaderModule(device->vk_device, data->stages[i].module, NULL));
+        VK_CALL(vkDestroyShaderModule(device->vk_device, data->stages[i].module, &vkd3d_vk_allocator));
     vkd3d_free(data->stages);
 
     vkd3d_free(data->associations);
@@ -421,11 +427,44 @@ static void d3d12_state_object_pipeline_data_cleanup(struct d3d12_state_object_p
     vkd3d_free(data->vk_libraries);
 }
 
+static bool d3d12_state_object_pipeline_data_add_collection(struct d3d12_state_object_pipeline_data *data,
+        struct d3d12_state_object *object, unsigned int num_exports, const D3D12_EXPORT_DESC *exports,
+        VkPipeline vk_library)
+{
+    if (!vkd3d_array_reserve((void **)&data->collections, &data->collections_size,
+            data->collections_count + 1, sizeof(*data->collections)))
+        return false;
+
+    if (!vkd3d_array_reserve((void **)&data->vk_libraries, &data->vk_libraries_size,
+            data->vk_libraries_count + 1, sizeof(*data->vk_libraries)))
+        return false;
+
+    data->collections[data->collections_count].object = object;
+    data->collections[data->collections_count].num_exports = num_exports;
+    data->collections[data->collections_count].exports = exports;
+    data->vk_libraries[data->vk_libraries_count] = vk_library;
+
+    data->collections_count += 1;
+    data->vk_libraries_count += 1;
+    return true;
+}
+
 static HRESULT d3d12_state_object_parse_subobjects(struct d3d12_state_object *object,
-        const D3D12_STATE_OBJECT_DESC *desc, struct d3d12_state_object_pipeline_data *data)
+        const D3D12_STATE_OBJECT_DESC *desc, struct d3d12_state_object *parent,
+        struct d3d12_state_object_pipeline_data *data)
 {
     unsigned int i, j;
 
+    if (parent)
+    {
+        /* The parent is linked in like any other collection, with all of its exports visible.
+         * Unless overridden, the addition keeps the configuration of the parent. */
+        object->flags = parent->flags;
+        data->parent = parent;
+        if (!d3d12_state_object_pipeline_data_add_collection(data, parent, 0, NULL, parent->pipeline_library))
+            return E_OUTOFMEMORY;
+    }
+
     for (i = 0; i < desc->NumSubobjects; i++)
     {
         const D3D12_STATE_SUBOBJECT *obj = &desc->pSubobjects[i];
@@ -435,11 +474,20 @@ static HRESULT d3d12_state_object_parse_subobjects(struct d3d12_state_object *ob
             {
                 const D3D12_STATE_OBJECT_CONFIG *object_config = obj->pDesc;
                 object->flags = object_config->Flags;
-                if (object->flags & ~D3D12_STATE_OBJECT_FLAG_ALLOW_EXTERNAL_DEPENDENCIES_ON_LOCAL_DEFINITIONS)
+                if (object->flags & ~(D3D12_STATE_OBJECT_FLAG_ALLOW_EXTERNAL_DEPENDENCIES_ON_LOCAL_DEFINITIONS |
+                        D3D12_STATE_OBJECT_FLAG_ALLOW_STATE_OBJECT_ADDITIONS))
                 {
                     FIXME("Object config flag #%x is not supported.\n", object->flags);
                     return E_INVALIDARG;
                 }
+
+                /* Additions link against a pipeline library of the state object. */
+                if ((object->flags & D3D12_STATE_OBJECT_FLAG_ALLOW_STATE_OBJECT_ADDITIONS) &&
+                        !object->device->vk_info.KHR_pipeline_library)
+                {
+                    FIXME("State object additions require VK_KHR_pipeline_library.\n");
+                    return E_NOTIMPL;
+                }
                 break;
             }
 
@@ -563,19 +611,12 @@ static HRESULT d3d12_state_object_parse_subobjects(struct d3d12_state_object *ob
             case D3D12_STATE_SUBOBJECT_TYPE_EXISTING_COLLECTION:
             {
                 const D3D12_EXISTING_COLLECTION_DESC *collection = obj->pDesc;
-                vkd3d_array_reserve((void **)&data->collections, &data->collections_size,
-                        data->collections_count + 1, sizeof(*data->collections));
-
-                data->collections[data->collections_count].object = impl_from_ID3D12StateObject(collection->pExistingCollection);
-                data->collections[data->collections_count].num_exports = collection->NumExports;
-                data->collections[data->collections_count].exports = collection->pExports;
+                struct d3d12_state_object *collection_object;
 
-                vkd3d_array_reserve((void **)&data->vk_libraries, &data->vk_libraries_size,
-                        data->vk_libraries_count + 1, sizeof(*data->vk_libraries));
-                data->vk_libraries[data->vk_libraries_count] = data->collections[data->collections_count].object->pipeline;
-
-                data->collections_count += 1;
-                data->vk_libraries_count += 1;
+                collection_object = impl_from_ID3D12StateObject(collection->pExistingCollection);
+                if (!d3d12_state_object_pipeline_data_add_collection(data, collection_object,
+                        collection->NumExports, collection->pExports, collection_object->pipeline))
+                    return E_OUTOFMEMORY;
                 break;
             }
 
@@ -585,6 +626,34 @@ static HRESULT d3d12_state_object_parse_subobjects(struct d3d12_state_object *ob
         }
     }
 
+    if (parent)
+    {
+        if (!data->pipeline_config)
+            data->pipeline_config = &parent->pipeline_config;
+        else if (memcmp(data->pipeline_config, &parent->pipeline_config, sizeof(*data->pipeline_config)) != 0)
+        {
+            ERR("RAYTRACING_PIPELINE_CONFIG of addition does not match existing state object.\n");
+            return E_INVALIDARG;
+        }
+
+        if (!data->shader_config)
+            data->shader_config = &parent->shader_config;
+        else if (memcmp(data->shader_config, &parent->shader_config, sizeof(*data->shader_config)) != 0)
+        {
+            ERR("RAYTRACING_SHADER_CONFIG of addition does not match existing state object.\n");
+            return E_INVALIDARG;
+        }
+
+        if (!data->global_root_signature)
+            data->global_root_signature = parent->global_root_signature;
+        else if (data->global_root_signature != parent->global_root_signature)
+        {
+            /* The pipeline layout must be compatible with the linked parent. */
+            FIXME("Global root signature of addition does not match existing state object.\n");
+            return E_INVALIDARG;
+        }
+    }
+
     if (!data->pipeline_config)
     {
         ERR("Must have pipeline config.\n");
@@ -597,6 +666,10 @@ static HRESULT d3d12_state_object_parse_subobjects(struct d3d12_state_object *ob
         return E_INVALIDARG;
     }
 
+    object->pipeline_config = *data->pipeline_config;
+    object->shader_config = *data->shader_config;
+    object->global_root_signature = data->global_root_signature;
+
     return S_OK;
 }
 
@@ -678,7 +751,7 @@ static VkShaderModule create_shader_module(struct d3d12_device *device, const vo
     info.pCode = data;
     info.codeSize = size;
 
-    if (VK_CALL(vkCreateShaderModule(device->vk_device, &info, NULL, &module)) == VK_SUCCESS)
+    if (VK_CALL(vkCreateShaderModule(device->vk_device, &info, &vkd3d_vk_allocator, &module)) == VK_SUCCESS)
         return module;
     else
         return VK_NULL_HANDLE;
@@ -926,10 +999,110 @@ static void d3d12_state_object_append_local_static_samplers(
     *out_vk_bindings_count = vk_bindings_count;
 }
 
+/* Applications tend to compile several state objects in parallel,
+ * so a single compile should not take over every core. */
+#define VKD3D_MAX_DEFERRED_OPERATION_THREADS 8
+
+struct vkd3d_deferred_operation_join
+{
+    struct d3d12_device *device;
+    VkDeferredOperationKHR vk_operation;
+};
+
+static enum vkd3d_join_status vkd3d_deferred_operation_join(void *userdata)
+{
+    const struct vkd3d_deferred_operation_join *join = userdata;
+    const struct vkd3d_vk_device_procs *vk_procs = &join->device->vk_procs;
+    VkResult vr;
+
+    vr = VK_CALL(vkDeferredOperationJoinKHR(join->device->vk_device, join->vk_operation));
+
+    if (vr == VK_THREAD_IDLE_KHR)
+        return VKD3D_JOIN_IDLE;
+    if (vr == VK_THREAD_DONE_KHR)
+        return VKD3D_JOIN_DONE;
+    if (vr < 0)
+        ERR("Failed to join deferred operation, vr %d.\n", vr);
+    return VKD3D_JOIN_COMPLETE;
+}
+
+static VkResult d3d12_state_object_create_vk_pipeline(struct d3d12_state_object *object,
+        const VkRayTracingPipelineCreateInfoKHR *create_info, VkPipeline *vk_pipeline)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &object->device->vk_procs;
+    VkDeferredOperationKHR vk_operation = VK_NULL_HANDLE;
+    struct d3d12_device *device = object->device;
+    struct vkd3d_deferred_operation_join join;
+    unsigned int thread_count, spin_count = 0;
+    VkPipelineCache vk_cache;
+    VkResult vr;
+
+    /* Large pipelines can take seconds to compile, let the driver spread the work over multiple threads. */
+    if (device->vk_info.KHR_deferred_host_operations &&
+            !(vkd3d_config_flags & VKD3D_CONFIG_FLAG_NO_DEFERRED_COMPILE))
+    {
+        if ((vr = VK_CALL(vkCreateDeferredOperationKHR(device->vk_device, &vkd3d_vk_allocator, &vk_operation))))
+        {
+            WARN("Failed to create deferred operation, vr %d.\n", vr);
+            vk_operation = VK_NULL_HANDLE;
+        }
+    }
+
+    /* Concurrent compiles may share the cache, this only holds off merges. */
+    vk_cache = vkd3d_acquire_rt_pipeline_cache(device);
+
+    vr = VK_CALL(vkCreateRayTracingPipelinesKHR(device->vk_device, vk_operation,
+            vk_cache, 1, create_info, &vkd3d_vk_allocator, vk_pipeline));
+
+    if (vr == VK_OPERATION_DEFERRED_KHR)
+    {
+        thread_count = VK_CALL(vkGetDeferredOperationMaxConcurrencyKHR(device->vk_device, vk_operation));
+        thread_count = min(thread_count, min(vkd3d_get_cpu_count(), VKD3D_MAX_DEFERRED_OPERATION_THREADS));
+
+        join.device = device;
+        join.vk_operation = vk_operation;
+        thread_count = vkd3d_parallel_join(device->vkd3d_instance,
+                vkd3d_deferred_operation_join, &join, max(thread_count, 1u));
+        TRACE("Compiled pipeline for state object %p using %u threads.\n", object, thread_count);
+
+        /* Threads which ran out of work do not wait for other threads to finish. */
+        while ((vr = VK_CALL(vkGetDeferredOperationResultKHR(device->vk_device, vk_operation))) == VK_NOT_READY)
+            vkd3d_spin_wait(&spin_count);
+    }
+    else if (vr == VK_OPERATION_NOT_DEFERRED_KHR)
+        vr = VK_SUCCESS;
+
+    vkd3d_release_rt_pipeline_cache(device);
+
+    VK_CALL(vkDestroyDeferredOperationKHR(device->vk_device, vk_operation, &vkd3d_vk_allocator));
+    return vr;
+}
+
+/* Applications keep shader identifiers of the parent in shader binding tables,
+ * so they must not change when the state object grows. Vulkan only guarantees
+ * stable group handles within one pipeline, so verify this after linking. */
+static HRESULT d3d12_state_object_validate_parent_identifiers(const struct d3d12_state_object_pipeline_data *data)
+{
+    const struct d3d12_state_object *parent = data->parent;
+    const struct d3d12_state_object_identifier *export;
+    size_t i;
+
+    for (i = 0; i < parent->exports_count; i++)
+    {
+        export = &data->exports[data->parent_exports_offset + i];
+        if (memcmp(export->identifier, parent->exports[i].identifier, sizeof(export->identifier)) != 0)
+        {
+            WARN("Shader identifier of export #%zu changed after linking, cannot grow state object.\n", i);
+            return E_NOTIMPL;
+        }
+    }
+
+    return S_OK;
+}
+
 static HRESULT d3d12_state_object_compile_pipeline(struct d3d12_state_object *object,
         struct d3d12_state_object_pipeline_data *data)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &object->device->vk_procs;
     struct vkd3d_shader_interface_local_info shader_interface_local_info;
     VkRayTracingPipelineInterfaceCreateInfoKHR interface_create_info;
     VkDescriptorSetLayoutBinding *local_static_sampler_bindings;
@@ -991,7 +1164,7 @@ static HRESULT d3d12_state_object_compile_pipeline(struct d3d12_state_object *ob
 #endif
     }
 
-    shader_interface_local_info.descriptor_size = sizeof(struct d3d12_desc);
+    shader_interface_local_info.descriptor_size = VKD3D_RESOURCE_DESC_INCREMENT;
 
     local_static_sampler_bindings = NULL;
     local_static_sampler_bindings_count = 0;
@@ -1175,6 +1348,9 @@ static HRESULT d3d12_state_object_compile_pipeline(struct d3d12_state_object *ob
         else
             num_groups_to_export = collection->object->exports_count;
 
+        if (collection->object == data->parent)
+            data->parent_exports_offset = data->exports_count;
+
         for (j = 0; j < num_groups_to_export; j++)
         {
             const struct d3d12_state_object_identifier *input_export;
@@ -1331,8 +1507,26 @@ static HRESULT d3d12_state_object_compile_pipeline(struct d3d12_state_object *ob
     dynamic_state.dynamicStateCount = 1;
     dynamic_state.pDynamicStates = dynamic_states;
 
-    vr = VK_CALL(vkCreateRayTracingPipelinesKHR(object->device->vk_device, VK_NULL_HANDLE,
-            VK_NULL_HANDLE, 1, &pipeline_create_info, NULL, &object->pipeline));
+    if (object->type == D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE &&
+            (object->flags & D3D12_STATE_OBJECT_FLAG_ALLOW_STATE_OBJECT_ADDITIONS))
+    {
+        /* A pipeline cannot be used as a library, so compile everything into a library
+         * which additions can link against, and link the executable pipeline from it.
+         * Without any groups of its own, group indices in the linked pipeline are unchanged. */
+        pipeline_create_info.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
+        if ((vr = d3d12_state_object_create_vk_pipeline(object, &pipeline_create_info, &object->pipeline_library)))
+            return hresult_from_vk_result(vr);
+
+        pipeline_create_info.flags = 0;
+        pipeline_create_info.pGroups = NULL;
+        pipeline_create_info.groupCount = 0;
+        pipeline_create_info.pStages = NULL;
+        pipeline_create_info.stageCount = 0;
+        library_info.libraryCount = 1;
+        library_info.pLibraries = &object->pipeline_library;
+    }
+
+    vr = d3d12_state_object_create_vk_pipeline(object, &pipeline_create_info, &object->pipeline);
     if (vr)
         return hresult_from_vk_result(vr);
 
@@ -1341,6 +1535,9 @@ static HRESULT d3d12_state_object_compile_pipeline(struct d3d12_state_object *ob
         if (FAILED(hr = d3d12_state_object_get_group_handles(object, data)))
             return hr;
 
+        if (data->parent && FAILED(hr = d3d12_state_object_validate_parent_identifiers(data)))
+            return hr;
+
         object->pipeline_stack_size = d3d12_state_object_pipeline_data_compute_default_stack_size(data,
                 &object->stack,
                 pipeline_create_info.maxPipelineRayRecursionDepth);
@@ -1372,8 +1569,9 @@ static HRESULT d3d12_state_object_compile_pipeline(struct d3d12_state_object *ob
     /* Always set this, since parent needs to be able to offset pStages[]. */
     object->stages_count = data->stages_count;
 
-    /* If parent object can depend on individual shaders, keep the entry point list around. */
-    if (object->flags & D3D12_STATE_OBJECT_FLAG_ALLOW_EXTERNAL_DEPENDENCIES_ON_LOCAL_DEFINITIONS)
+    /* If parent object or additions can depend on individual shaders, keep the entry point list around. */
+    if (object->flags & (D3D12_STATE_OBJECT_FLAG_ALLOW_EXTERNAL_DEPENDENCIES_ON_LOCAL_DEFINITIONS |
+            D3D12_STATE_OBJECT_FLAG_ALLOW_STATE_OBJECT_ADDITIONS))
     {
         object->entry_points = data->entry_points;
         object->entry_points_count = data->entry_points_count;
@@ -1386,7 +1584,8 @@ static HRESULT d3d12_state_object_compile_pipeline(struct d3d12_state_object *ob
 
 static HRESULT d3d12_state_object_init(struct d3d12_state_object *object,
         struct d3d12_device *device,
-        const D3D12_STATE_OBJECT_DESC *desc)
+        const D3D12_STATE_OBJECT_DESC *desc,
+        struct d3d12_state_object *parent)
 {
     struct d3d12_state_object_pipeline_data data;
     HRESULT hr = S_OK;
@@ -1398,7 +1597,7 @@ static HRESULT d3d12_state_object_init(struct d3d12_state_object *object,
     object->type = desc->Type;
     memset(&data, 0, sizeof(data));
 
-    if (FAILED(hr = d3d12_state_object_parse_subobjects(object, desc, &data)))
+    if (FAILED(hr = d3d12_state_object_parse_subobjects(object, desc, parent, &data)))
         goto fail;
 
     if (FAILED(hr = d3d12_state_object_compile_pipeline(object, &data)))
@@ -1417,8 +1616,8 @@ fail:
     return hr;
 }
 
-HRESULT d3d12_state_object_create(struct d3d12_device *device, const D3D12_STATE_OBJECT_DESC *desc,
-        struct d3d12_state_object **state_object)
+static HRESULT d3d12_state_object_create_internal(struct d3d12_device *device, const D3D12_STATE_OBJECT_DESC *desc,
+        struct d3d12_state_object *parent, struct d3d12_state_object **state_object)
 {
     struct d3d12_state_object *object;
     HRESULT hr;
@@ -1426,7 +1625,7 @@ HRESULT d3d12_state_object_create(struct d3d12_device *device, const D3D12_STATE
     if (!(object = vkd3d_calloc(1, sizeof(*object))))
         return E_OUTOFMEMORY;
 
-    hr = d3d12_state_object_init(object, device, desc);
+    hr = d3d12_state_object_init(object, device, desc, parent);
     if (FAILED(hr))
     {
         vkd3d_free(object);
@@ -1436,3 +1635,35 @@ HRESULT d3d12_state_object_create(struct d3d12_device *device, const D3D12_STATE
     *state_object = object;
     return S_OK;
 }
+
+HRESULT d3d12_state_object_create(struct d3d12_device *device, const D3D12_STATE_OBJECT_DESC *desc,
+        struct d3d12_state_object **state_object)
+{
+    return d3d12_state_object_create_internal(device, desc, NULL, state_object);
+}
+
+HRESULT d3d12_state_object_add(struct d3d12_device *device, const D3D12_STATE_OBJECT_DESC *addition,
+        struct d3d12_state_object *parent, struct d3d12_state_object **state_object)
+{
+    if (addition->Type != D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE ||
+            parent->type != D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE)
+    {
+        ERR("Only raytracing pipelines can be grown.\n");
+        return E_INVALIDARG;
+    }
+
+    if (!(parent->flags & D3D12_STATE_OBJECT_FLAG_ALLOW_STATE_OBJECT_ADDITIONS))
+    {
+        ERR("State object %p was not created with ALLOW_STATE_OBJECT_ADDITIONS.\n", parent);
+        return E_INVALIDARG;
+    }
+
+    if (parent->local_static_sampler.pipeline_layout)
+    {
+        /* The addition would need to use the exact same pipeline layout. */
+        FIXME("Growing state objects with local static samplers is not supported.\n");
+        return E_NOTIMPL;
+    }
+
+    return d3d12_state_object_create_internal(device, addition, parent, state_object);
+}
@@ -18,6 +18,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_RESOURCE
 
 #include <float.h>
 
@@ -188,7 +189,7 @@ HRESULT vkd3d_create_buffer(struct d3d12_device *device,
     if (desc->Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
         FIXME("Unsupported resource flags %#x.\n", desc->Flags);
 
-    if ((vr = VK_CALL(vkCreateBuffer(device->vk_device, &buffer_info, NULL, vk_buffer))) < 0)
+    if ((vr = VK_CALL(vkCreateBuffer(device->vk_device, &buffer_info, &vkd3d_vk_allocator, vk_buffer))) < 0)
     {
         WARN("Failed to create Vulkan buffer, vr %d.\n", vr);
         *vk_buffer = VK_NULL_HANDLE;
@@ -204,24 +205,6 @@ static unsigned int max_miplevel_count(const D3D12_RESOURCE_DESC *desc)
     return vkd3d_log2i(size) + 1;
 }
 
-static const struct vkd3d_format_compatibility_list *vkd3d_get_format_compatibility_list(
-        const struct d3d12_device *device, DXGI_FORMAT dxgi_format)
-{
-    DXGI_FORMAT typeless_format;
-    unsigned int i;
-
-    if (!(typeless_format = vkd3d_get_typeless_format(device, dxgi_format)))
-        typeless_format = dxgi_format;
-
-    for (i = 0; i < device->format_compatibility_list_count; ++i)
-    {
-        if (device->format_compatibility_lists[i].typeless_format == typeless_format)
-            return &device->format_compatibility_lists[i];
-    }
-
-    return NULL;
-}
-
 static bool vkd3d_is_linear_tiling_supported(const struct d3d12_device *device, VkImageCreateInfo *image_info)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
@@ -342,7 +325,7 @@ static HRESULT vkd3d_resource_make_vrs_view(struct d3d12_device *device,
     view_info.subresourceRange.baseArrayLayer = 0;
     view_info.subresourceRange.layerCount = 1;
 
-    if ((vr = VK_CALL(vkCreateImageView(device->vk_device, &view_info, NULL, view))) < 0)
+    if ((vr = VK_CALL(vkCreateImageView(device->vk_device, &view_info, &vkd3d_vk_allocator, view))) < 0)
         ERR("Failed to create implicit VRS view, vr %d.\n", vr);
 
     return hresult_from_vk_result(vr);
@@ -359,6 +342,8 @@ static HRESULT vkd3d_create_image(struct d3d12_device *device,
     const struct vkd3d_format *format;
     VkImageCreateInfo image_info;
     DXGI_FORMAT typeless_format;
+    bool can_track_ownership;
+    bool track_ownership;
     bool use_concurrent;
     unsigned int i;
     VkResult vr;
@@ -379,24 +364,29 @@ static HRESULT vkd3d_create_image(struct d3d12_device *device,
     image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     image_info.pNext = NULL;
     image_info.flags = 0;
-    if (desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS)
+    if ((desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS) ||
+            (!(desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) && format->type == VKD3D_FORMAT_TYPE_TYPELESS))
     {
-        /* Format compatibility rules are more relaxed for UAVs. */
-        if (format->type != VKD3D_FORMAT_TYPE_UINT)
-            image_info.flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
-    }
-    else if (!(desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) && format->type == VKD3D_FORMAT_TYPE_TYPELESS)
-    {
-        image_info.flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
-
+        /* Typed UAVs may be cleared through a UINT view. Always pass the exact
+         * list of view formats, an unrestricted mutable format tends to disable
+         * compression. Without a format list, we have to assume any format. */
         if ((compat_list = vkd3d_get_format_compatibility_list(device, desc->Format)))
         {
-            format_list.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO_KHR;
-            format_list.pNext = NULL;
-            format_list.viewFormatCount = compat_list->format_count;
-            format_list.pViewFormats = compat_list->vk_formats;
+            if (compat_list->format_count > 1)
+            {
+                image_info.flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
 
-            image_info.pNext = &format_list;
+                format_list.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO_KHR;
+                format_list.pNext = NULL;
+                format_list.viewFormatCount = compat_list->format_count;
+                format_list.pViewFormats = compat_list->vk_formats;
+
+                image_info.pNext = &format_list;
+            }
+        }
+        else if (format->type != VKD3D_FORMAT_TYPE_UINT)
+        {
+            image_info.flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
         }
     }
     if (desc->Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE2D
@@ -501,15 +491,28 @@ static HRESULT vkd3d_create_image(struct d3d12_device *device,
         image_info.usage |= VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR;
 
     use_concurrent = !!(device->unique_queue_mask & (device->unique_queue_mask - 1));
+    track_ownership = false;
 
-    if (!(desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS))
+    if (use_concurrent && !(desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS))
     {
-        /* Ignore config flags for actual simultaneous access cases. */
-        if (((desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) &&
+        /* Ownership can only be transferred for uses recorded in a command list, not for
+         * reads which only go through descriptors on another queue, so this is opt-in.
+         * UAV images may be handed over between queues in UNORDERED_ACCESS state instead,
+         * and reserved images are bound on the sparse queue. */
+        can_track_ownership = !(desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS) && !sparse_resource &&
+                (vkd3d_config_flags & VKD3D_CONFIG_FLAG_QUEUE_OWNERSHIP_TRANSFER);
+
+        if (can_track_ownership)
+        {
+            use_concurrent = false;
+            track_ownership = true;
+        }
+        else if (((desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) &&
                 (vkd3d_config_flags & VKD3D_CONFIG_FLAG_FORCE_RTV_EXCLUSIVE_QUEUE)) ||
                 ((desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) &&
                  (vkd3d_config_flags & VKD3D_CONFIG_FLAG_FORCE_DSV_EXCLUSIVE_QUEUE)))
         {
+            /* Ignore config flags for actual simultaneous access cases. */
             use_concurrent = false;
         }
     }
@@ -598,9 +601,15 @@ static HRESULT vkd3d_create_image(struct d3d12_device *device,
 
         if (desc->Flags & D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS)
             resource->flags |= VKD3D_RESOURCE_SIMULTANEOUS_ACCESS;
+
+        if (track_ownership)
+        {
+            resource->flags |= VKD3D_RESOURCE_EXCLUSIVE_OWNERSHIP;
+            vkd3d_queue_ownership_init(&resource->queue_ownership);
+        }
     }
 
-    if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, NULL, vk_image))) < 0)
+    if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, &vkd3d_vk_allocator, vk_image))) < 0)
         WARN("Failed to create Vulkan image, vr %d.\n", vr);
 
     return hresult_from_vk_result(vr);
@@ -632,7 +641,7 @@ HRESULT vkd3d_get_image_allocation_info(struct d3d12_device *device,
         return hr;
 
     VK_CALL(vkGetImageMemoryRequirements(device->vk_device, vk_image, &requirements));
-    VK_CALL(vkDestroyImage(device->vk_device, vk_image, NULL));
+    VK_CALL(vkDestroyImage(device->vk_device, vk_image, &vkd3d_vk_allocator));
 
     allocation_info->SizeInBytes = requirements.size;
     allocation_info->Alignment = requirements.alignment;
@@ -656,6 +665,9 @@ struct vkd3d_view_entry
     struct hash_map_entry entry;
     struct vkd3d_view_key key;
     struct vkd3d_view *view;
+    /* Extent of the data last placed at the view's offset, 0 if nothing was placed yet.
+     * See vkd3d_view_map_place_view(). */
+    VkDeviceSize placed_size;
 };
 
 static bool d3d12_sampler_needs_border_color(D3D12_TEXTURE_ADDRESS_MODE u,
@@ -781,8 +793,6 @@ HRESULT vkd3d_view_map_init(struct vkd3d_view_map *view_map)
     return S_OK;
 }
 
-static void vkd3d_view_destroy(struct vkd3d_view *view, struct d3d12_device *device);
-
 void vkd3d_view_map_destroy(struct vkd3d_view_map *view_map, struct d3d12_device *device)
 {
     uint32_t i;
@@ -791,8 +801,9 @@ void vkd3d_view_map_destroy(struct vkd3d_view_map *view_map, struct d3d12_device
     {
         struct vkd3d_view_entry *e = (struct vkd3d_view_entry *)hash_map_get_entry(&view_map->map, i);
 
+        /* Acquired views may still be referenced by command allocators. */
         if (e->entry.flags & HASH_MAP_ENTRY_OCCUPIED)
-            vkd3d_view_destroy(e->view, device);
+            vkd3d_view_decref(e->view, device);
     }
 
     hash_map_clear(&view_map->map);
@@ -803,8 +814,8 @@ static struct vkd3d_view *vkd3d_view_create(enum vkd3d_view_type type);
 static HRESULT d3d12_create_sampler(struct d3d12_device *device,
         const D3D12_SAMPLER_DESC *desc, VkSampler *vk_sampler);
 
-struct vkd3d_view *vkd3d_view_map_create_view(struct vkd3d_view_map *view_map,
-        struct d3d12_device *device, const struct vkd3d_view_key *key)
+static struct vkd3d_view *vkd3d_view_map_get_view(struct vkd3d_view_map *view_map,
+        struct d3d12_device *device, const struct vkd3d_view_key *key, bool acquire)
 {
     struct vkd3d_view_entry entry, *e;
     struct vkd3d_view *redundant_view;
@@ -818,6 +829,9 @@ struct vkd3d_view *vkd3d_view_map_create_view(struct vkd3d_view_map *view_map,
     if ((e = (struct vkd3d_view_entry *)hash_map_find(&view_map->map, key)))
     {
         view = e->view;
+        /* Must take the reference before the view can be reclaimed. */
+        if (acquire)
+            vkd3d_view_incref(view);
         rw_spinlock_release_read(&view_map->spinlock);
         return view;
     }
@@ -857,6 +871,7 @@ struct vkd3d_view *vkd3d_view_map_create_view(struct vkd3d_view_map *view_map,
 
     entry.key = *key;
     entry.view = view;
+    entry.placed_size = 0;
 
     rw_spinlock_acquire_write(&view_map->spinlock);
 
@@ -869,6 +884,8 @@ struct vkd3d_view *vkd3d_view_map_create_view(struct vkd3d_view_map *view_map,
          * This can happen between releasing reader lock, and acquiring writer lock. */
         redundant_view = view;
         view = e->view;
+        if (acquire)
+            vkd3d_view_incref(view);
         rw_spinlock_release_write(&view_map->spinlock);
         vkd3d_view_decref(redundant_view, device);
     }
@@ -880,9 +897,102 @@ struct vkd3d_view *vkd3d_view_map_create_view(struct vkd3d_view_map *view_map,
             ERR("Intense view map pressure! Got %u views in hash map %p.\n", view_map->map.used_count, &view_map->map);
 
         view = e->view;
+        if (acquire)
+            vkd3d_view_incref(view);
+        rw_spinlock_release_write(&view_map->spinlock);
+    }
+
+    return view;
+}
+
+struct vkd3d_view *vkd3d_view_map_create_view(struct vkd3d_view_map *view_map,
+        struct d3d12_device *device, const struct vkd3d_view_key *key)
+{
+    return vkd3d_view_map_get_view(view_map, device, key, false);
+}
+
+struct vkd3d_view *vkd3d_view_map_acquire_view(struct vkd3d_view_map *view_map,
+        struct d3d12_device *device, const struct vkd3d_view_key *key)
+{
+    return vkd3d_view_map_get_view(view_map, device, key, true);
+}
+
+static bool vkd3d_view_entry_overlaps(const struct vkd3d_view_entry *e,
+        VkDeviceSize offset, VkDeviceSize size)
+{
+    return e->placed_size && e->key.u.buffer.offset < offset + size &&
+            offset < e->key.u.buffer.offset + e->placed_size;
+}
+
+struct vkd3d_view *vkd3d_view_map_place_view(struct vkd3d_view_map *view_map,
+        struct d3d12_device *device, const struct vkd3d_view_key *key, VkDeviceSize size)
+{
+    struct vkd3d_view **stale_views;
+    struct vkd3d_view_entry *e, *other;
+    size_t stale_view_count, i;
+    struct hash_map live_map;
+    struct vkd3d_view *view;
+    VkDeviceSize offset;
+
+    if (!(view = vkd3d_view_map_acquire_view(view_map, device, key)))
+        return NULL;
+
+    /* Data of unknown size still occupies the byte at the view's offset. */
+    offset = key->u.buffer.offset;
+    size = max(size, 1);
+
+    /* In the steady state the same data is placed over and over again, nothing to reclaim. */
+    rw_spinlock_acquire_read(&view_map->spinlock);
+    e = (struct vkd3d_view_entry *)hash_map_find(&view_map->map, key);
+    if (!e || e->view != view || e->placed_size >= size)
+    {
+        rw_spinlock_release_read(&view_map->spinlock);
+        return view;
+    }
+    rw_spinlock_release_read(&view_map->spinlock);
+
+    rw_spinlock_acquire_write(&view_map->spinlock);
+
+    /* Another placement may have reclaimed the view or grown its extent meanwhile. */
+    e = (struct vkd3d_view_entry *)hash_map_find(&view_map->map, key);
+    if (!e || e->view != view || e->placed_size >= size ||
+            !(stale_views = vkd3d_malloc(view_map->map.used_count * sizeof(*stale_views))))
+    {
         rw_spinlock_release_write(&view_map->spinlock);
+        return view;
+    }
+
+    e->placed_size = size;
+
+    /* Placing new data invalidates whatever the new data overlaps. Views of the old data only
+     * live on through the references held by command allocators. */
+    hash_map_init(&live_map, view_map->map.hash_func, view_map->map.compare_func, view_map->map.entry_size);
+    stale_view_count = 0;
+
+    for (i = 0; i < view_map->map.entry_count; i++)
+    {
+        other = (struct vkd3d_view_entry *)hash_map_get_entry(&view_map->map, i);
+
+        if (!(other->entry.flags & HASH_MAP_ENTRY_OCCUPIED))
+            continue;
+
+        if ((other != e && vkd3d_view_entry_overlaps(other, offset, size)) ||
+                !hash_map_insert(&live_map, &other->key, &other->entry))
+            stale_views[stale_view_count++] = other->view;
     }
 
+    hash_map_clear(&view_map->map);
+    view_map->map = live_map;
+
+    rw_spinlock_release_write(&view_map->spinlock);
+
+    if (stale_view_count)
+        TRACE("Reclaiming %zu overlapped views from view map %p.\n", stale_view_count, view_map);
+
+    for (i = 0; i < stale_view_count; i++)
+        vkd3d_view_decref(stale_views[i], device);
+    vkd3d_free(stale_views);
+
     return view;
 }
 
@@ -954,7 +1064,7 @@ void vkd3d_sampler_state_cleanup(struct vkd3d_sampler_state *state,
     uint32_t i;
 
     for (i = 0; i < state->vk_descriptor_pool_count; i++)
-        VK_CALL(vkDestroyDescriptorPool(device->vk_device, state->vk_descriptor_pools[i], NULL));
+        VK_CALL(vkDestroyDescriptorPool(device->vk_device, state->vk_descriptor_pools[i], &vkd3d_vk_allocator));
 
     vkd3d_free(state->vk_descriptor_pools);
 
@@ -963,7 +1073,7 @@ void vkd3d_sampler_state_cleanup(struct vkd3d_sampler_state *state,
         struct vkd3d_sampler_entry *e = (struct vkd3d_sampler_entry *)hash_map_get_entry(&state->map, i);
 
         if (e->entry.flags & HASH_MAP_ENTRY_OCCUPIED)
-            VK_CALL(vkDestroySampler(device->vk_device, e->vk_sampler, NULL));
+            VK_CALL(vkDestroySampler(device->vk_device, e->vk_sampler, &vkd3d_vk_allocator));
     }
 
     hash_map_clear(&state->map);
@@ -1026,7 +1136,7 @@ static VkResult vkd3d_sampler_state_create_descriptor_pool(struct d3d12_device *
     pool_info.poolSizeCount = 1;
     pool_info.pPoolSizes = &pool_size;
 
-    return VK_CALL(vkCreateDescriptorPool(device->vk_device, &pool_info, NULL, vk_pool));
+    return VK_CALL(vkCreateDescriptorPool(device->vk_device, &pool_info, &vkd3d_vk_allocator, vk_pool));
 }
 
 HRESULT vkd3d_sampler_state_allocate_descriptor_set(struct vkd3d_sampler_state *state,
@@ -1075,7 +1185,7 @@ HRESULT vkd3d_sampler_state_allocate_descriptor_set(struct vkd3d_sampler_state *
         if (!vkd3d_array_reserve((void **)&state->vk_descriptor_pools, &state->vk_descriptor_pools_size,
                 state->vk_descriptor_pool_count + 1, sizeof(*state->vk_descriptor_pools)))
         {
-            VK_CALL(vkDestroyDescriptorPool(device->vk_device, alloc_info.descriptorPool, NULL));
+            VK_CALL(vkDestroyDescriptorPool(device->vk_device, alloc_info.descriptorPool, &vkd3d_vk_allocator));
             pthread_mutex_unlock(&state->mutex);
             return E_OUTOFMEMORY;
         }
@@ -2244,8 +2354,6 @@ static HRESULT d3d12_resource_init_sparse_info(struct d3d12_resource *resource,
         struct d3d12_device *device, struct d3d12_sparse_info *sparse)
 {
     VkSparseImageMemoryRequirements vk_memory_requirements;
-    unsigned int i, subresource;
-    VkOffset3D tile_offset;
     HRESULT hr;
 
     memset(sparse, 0, sizeof(*sparse));
@@ -2265,83 +2373,102 @@ static HRESULT d3d12_resource_init_sparse_info(struct d3d12_resource *resource,
     d3d12_resource_get_tiling(device, resource, &sparse->tile_count, &sparse->packed_mips,
             &sparse->tile_shape, sparse->tilings, &vk_memory_requirements);
 
-    if (!(sparse->tiles = vkd3d_malloc(sparse->tile_count * sizeof(*sparse->tiles))))
-    {
-        ERR("Failed to allocate tile mapping array.\n");
-        return E_OUTOFMEMORY;
-    }
+    /* Tile regions are derived from the tiling info when needed, and only
+     * mapped runs of tiles are stored, so that huge reserved resources
+     * do not need host memory proportional to their size. */
+    sparse->block_extent = vk_memory_requirements.formatProperties.imageGranularity;
+    sparse->aspect_mask = vk_memory_requirements.formatProperties.aspectMask;
+    sparse->mip_tail_offset = vk_memory_requirements.imageMipTailOffset;
+    sparse->mip_tail_size = vk_memory_requirements.imageMipTailSize;
+    vkd3d_tile_map_init(&sparse->mappings, VKD3D_TILE_SIZE);
+    spinlock_init(&sparse->mappings_lock);
 
-    tile_offset.x = 0;
-    tile_offset.y = 0;
-    tile_offset.z = 0;
-    subresource = 0;
+    if (FAILED(hr = d3d12_resource_bind_sparse_metadata(resource, device, sparse)))
+        return hr;
 
-    for (i = 0; i < sparse->tile_count; i++)
+    return S_OK;
+}
+
+static uint32_t d3d12_resource_get_sparse_tile_subresource(const struct d3d12_resource *resource,
+        uint32_t tile_index)
+{
+    const struct d3d12_sparse_info *sparse = &resource->sparse;
+    unsigned int standard_mips = sparse->packed_mips.NumStandardMips;
+    uint32_t lo, hi, mid, subresource;
+
+    /* Subresources which are not part of the mip tail are laid out in order. */
+    lo = 0;
+    hi = d3d12_resource_desc_get_layer_count(&resource->desc) * standard_mips;
+
+    while (hi - lo > 1)
     {
-        if (d3d12_resource_is_buffer(resource))
-        {
-            VkDeviceSize offset = VKD3D_TILE_SIZE * i;
-            sparse->tiles[i].buffer.offset = offset;
-            sparse->tiles[i].buffer.length = min(VKD3D_TILE_SIZE, resource->desc.Width - offset);
-        }
-        else if (sparse->packed_mips.NumPackedMips && i >= sparse->packed_mips.StartTileIndexInOverallResource)
-        {
-            VkDeviceSize offset = VKD3D_TILE_SIZE * (i - sparse->packed_mips.StartTileIndexInOverallResource);
-            sparse->tiles[i].buffer.offset = vk_memory_requirements.imageMipTailOffset + offset;
-            sparse->tiles[i].buffer.length = min(VKD3D_TILE_SIZE, vk_memory_requirements.imageMipTailSize - offset);
-        }
+        mid = lo + (hi - lo) / 2;
+        subresource = (mid / standard_mips) * resource->desc.MipLevels + (mid % standard_mips);
+
+        if (sparse->tilings[subresource].StartTileIndexInOverallResource <= tile_index)
+            lo = mid;
         else
-        {
-            struct d3d12_sparse_image_region *region = &sparse->tiles[i].image;
-            VkExtent3D block_extent = vk_memory_requirements.formatProperties.imageGranularity;
-            VkExtent3D mip_extent;
+            hi = mid;
+    }
 
-            assert(subresource < sparse->tiling_count && sparse->tilings[subresource].WidthInTiles &&
-                    sparse->tilings[subresource].HeightInTiles && sparse->tilings[subresource].DepthInTiles);
+    return (lo / standard_mips) * resource->desc.MipLevels + (lo % standard_mips);
+}
 
-            region->subresource.aspectMask = vk_memory_requirements.formatProperties.aspectMask;
-            region->subresource.mipLevel = subresource % resource->desc.MipLevels;
-            region->subresource.arrayLayer = subresource / resource->desc.MipLevels;
-            region->subresource_index = subresource;
+void d3d12_resource_get_sparse_tile(const struct d3d12_resource *resource, uint32_t tile_index,
+        struct d3d12_sparse_tile *tile)
+{
+    const struct d3d12_sparse_info *sparse = &resource->sparse;
+    struct d3d12_sparse_image_region *region = &tile->image;
+    const D3D12_SUBRESOURCE_TILING *tiling;
+    uint32_t subresource, local_index;
+    VkExtent3D mip_extent;
+    VkOffset3D tile_offset;
+    VkDeviceSize offset;
 
-            region->offset.x = tile_offset.x * block_extent.width;
-            region->offset.y = tile_offset.y * block_extent.height;
-            region->offset.z = tile_offset.z * block_extent.depth;
+    assert(tile_index < sparse->tile_count);
 
-            mip_extent.width = d3d12_resource_desc_get_width(&resource->desc, region->subresource.mipLevel);
-            mip_extent.height = d3d12_resource_desc_get_height(&resource->desc, region->subresource.mipLevel);
-            mip_extent.depth = d3d12_resource_desc_get_depth(&resource->desc, region->subresource.mipLevel);
+    if (d3d12_resource_is_buffer(resource))
+    {
+        offset = VKD3D_TILE_SIZE * (VkDeviceSize)tile_index;
+        tile->buffer.offset = offset;
+        tile->buffer.length = min(VKD3D_TILE_SIZE, resource->desc.Width - offset);
+    }
+    else if (sparse->packed_mips.NumPackedMips && tile_index >= sparse->packed_mips.StartTileIndexInOverallResource)
+    {
+        offset = VKD3D_TILE_SIZE * (VkDeviceSize)(tile_index - sparse->packed_mips.StartTileIndexInOverallResource);
+        tile->buffer.offset = sparse->mip_tail_offset + offset;
+        tile->buffer.length = min(VKD3D_TILE_SIZE, sparse->mip_tail_size - offset);
+    }
+    else
+    {
+        subresource = d3d12_resource_get_sparse_tile_subresource(resource, tile_index);
+        tiling = &sparse->tilings[subresource];
 
-            region->extent.width = min(block_extent.width, mip_extent.width - region->offset.x);
-            region->extent.height = min(block_extent.height, mip_extent.height - region->offset.y);
-            region->extent.depth = min(block_extent.depth, mip_extent.depth - region->offset.z);
+        assert(subresource < sparse->tiling_count && tiling->WidthInTiles &&
+                tiling->HeightInTiles && tiling->DepthInTiles);
 
-            if (++tile_offset.x == (int32_t)sparse->tilings[subresource].WidthInTiles)
-            {
-                tile_offset.x = 0;
-                if (++tile_offset.y == (int32_t)sparse->tilings[subresource].HeightInTiles)
-                {
-                    tile_offset.y = 0;
-                    if (++tile_offset.z == (int32_t)sparse->tilings[subresource].DepthInTiles)
-                    {
-                        tile_offset.z = 0;
-
-                        /* Find next subresource that is not part of the packed mip tail */
-                        while ((++subresource % resource->desc.MipLevels) >= sparse->packed_mips.NumStandardMips)
-                            continue;
-                    }
-                }
-            }
-        }
+        local_index = tile_index - tiling->StartTileIndexInOverallResource;
+        tile_offset.x = local_index % tiling->WidthInTiles;
+        tile_offset.y = (local_index / tiling->WidthInTiles) % tiling->HeightInTiles;
+        tile_offset.z = local_index / (tiling->WidthInTiles * tiling->HeightInTiles);
 
-        sparse->tiles[i].vk_memory = VK_NULL_HANDLE;
-        sparse->tiles[i].vk_offset = 0;
-    }
+        region->subresource.aspectMask = sparse->aspect_mask;
+        region->subresource.mipLevel = subresource % resource->desc.MipLevels;
+        region->subresource.arrayLayer = subresource / resource->desc.MipLevels;
+        region->subresource_index = subresource;
 
-    if (FAILED(hr = d3d12_resource_bind_sparse_metadata(resource, device, sparse)))
-        return hr;
+        region->offset.x = tile_offset.x * sparse->block_extent.width;
+        region->offset.y = tile_offset.y * sparse->block_extent.height;
+        region->offset.z = tile_offset.z * sparse->block_extent.depth;
 
-    return S_OK;
+        mip_extent.width = d3d12_resource_desc_get_width(&resource->desc, region->subresource.mipLevel);
+        mip_extent.height = d3d12_resource_desc_get_height(&resource->desc, region->subresource.mipLevel);
+        mip_extent.depth = d3d12_resource_desc_get_depth(&resource->desc, region->subresource.mipLevel);
+
+        region->extent.width = min(sparse->block_extent.width, mip_extent.width - region->offset.x);
+        region->extent.height = min(sparse->block_extent.height, mip_extent.height - region->offset.y);
+        region->extent.depth = min(sparse->block_extent.depth, mip_extent.depth - region->offset.z);
+    }
 }
 
 static void d3d12_resource_destroy(struct d3d12_resource *resource, struct d3d12_device *device)
@@ -2358,7 +2485,7 @@ static void d3d12_resource_destroy(struct d3d12_resource *resource, struct d3d12
     if (resource->flags & VKD3D_RESOURCE_RESERVED)
     {
         vkd3d_free_device_memory(device, &resource->sparse.vk_metadata_memory);
-        vkd3d_free(resource->sparse.tiles);
+        vkd3d_tile_map_cleanup(&resource->sparse.mappings);
         vkd3d_free(resource->sparse.tilings);
 
         if (resource->res.va)
@@ -2371,15 +2498,15 @@ static void d3d12_resource_destroy(struct d3d12_resource *resource, struct d3d12
     }
 
     if (d3d12_resource_is_texture(resource))
-        VK_CALL(vkDestroyImage(device->vk_device, resource->res.vk_image, NULL));
+        VK_CALL(vkDestroyImage(device->vk_device, resource->res.vk_image, &vkd3d_vk_allocator));
     else if (resource->flags & VKD3D_RESOURCE_RESERVED)
-        VK_CALL(vkDestroyBuffer(device->vk_device, resource->res.vk_buffer, NULL));
+        VK_CALL(vkDestroyBuffer(device->vk_device, resource->res.vk_buffer, &vkd3d_vk_allocator));
 
     if ((resource->flags & VKD3D_RESOURCE_ALLOCATION) && resource->mem.device_allocation.vk_memory)
         vkd3d_free_memory(device, &device->memory_allocator, &resource->mem);
 
     if (resource->vrs_view)
-        VK_CALL(vkDestroyImageView(device->vk_device, resource->vrs_view, NULL));
+        VK_CALL(vkDestroyImageView(device->vk_device, resource->vrs_view, &vkd3d_vk_allocator));
 
     vkd3d_private_store_destroy(&resource->private_store);
     d3d12_device_release(resource->device);
@@ -2848,16 +2975,16 @@ static void vkd3d_view_destroy(struct vkd3d_view *view, struct d3d12_device *dev
     switch (view->type)
     {
         case VKD3D_VIEW_TYPE_BUFFER:
-            VK_CALL(vkDestroyBufferView(device->vk_device, view->vk_buffer_view, NULL));
+            VK_CALL(vkDestroyBufferView(device->vk_device, view->vk_buffer_view, &vkd3d_vk_allocator));
             break;
         case VKD3D_VIEW_TYPE_IMAGE:
-            VK_CALL(vkDestroyImageView(device->vk_device, view->vk_image_view, NULL));
+            VK_CALL(vkDestroyImageView(device->vk_device, view->vk_image_view, &vkd3d_vk_allocator));
             break;
         case VKD3D_VIEW_TYPE_SAMPLER:
-            VK_CALL(vkDestroySampler(device->vk_device, view->vk_sampler, NULL));
+            VK_CALL(vkDestroySampler(device->vk_device, view->vk_sampler, &vkd3d_vk_allocator));
             break;
         case VKD3D_VIEW_TYPE_ACCELERATION_STRUCTURE:
-            VK_CALL(vkDestroyAccelerationStructureKHR(device->vk_device, view->vk_acceleration_structure, NULL));
+            VK_CALL(vkDestroyAccelerationStructureKHR(device->vk_device, view->vk_acceleration_structure, &vkd3d_vk_allocator));
             break;
         default:
             WARN("Unhandled view type %d.\n", view->type);
@@ -2872,47 +2999,165 @@ void vkd3d_view_decref(struct vkd3d_view *view, struct d3d12_device *device)
         vkd3d_view_destroy(view, device);
 }
 
+static void d3d12_descriptor_heap_write_null_descriptor_template(struct d3d12_desc *desc,
+        VkDescriptorType vk_mutable_descriptor_type);
+
+static bool d3d12_desc_needs_update(const struct d3d12_desc *dst, const struct d3d12_desc *src)
+{
+    const struct vkd3d_descriptor_data *metadata = src->metadata;
+
+    /* Only update the descriptor if something has changed */
+    if (metadata->cookie != dst->metadata->cookie)
+        return true;
+
+    /* We don't have a cookie for the UAV counter, so just force update if we have that.
+     * If flags differ, we also need to update. E.g. happens if UAV counter flag is turned off.
+     * We have no cookie for the UAV counter itself.
+     * Lastly, if we have plain VkBuffers, offset/range might differ. */
+    if ((metadata->flags & VKD3D_DESCRIPTOR_FLAG_RAW_VA_AUX_BUFFER) != 0 ||
+        (metadata->flags != dst->metadata->flags))
+        return true;
+
+    if (metadata->flags & VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE)
+    {
+        return dst->info->buffer.offset != src->info->buffer.offset ||
+                dst->info->buffer.range != src->info->buffer.range;
+    }
+
+    return false;
+}
+
+static uint32_t d3d12_desc_get_set_info_mask(const struct d3d12_descriptor_heap *heap,
+        const struct vkd3d_descriptor_data *metadata)
+{
+    /* Descriptors which were never written are not initialized on heap creation,
+     * but they hold null descriptors in every set of the heap. */
+    if (!(metadata->flags & VKD3D_DESCRIPTOR_FLAG_NON_NULL))
+        return heap->null_descriptor_template.set_info_mask;
+    return metadata->set_info_mask;
+}
+
+#define VKD3D_HOST_DESCRIPTOR_COPY_BATCH_SIZE 64
+
+struct d3d12_desc_host_copy_batch
+{
+    VkWriteDescriptorSet vk_writes[VKD3D_HOST_DESCRIPTOR_COPY_BATCH_SIZE];
+    uint32_t write_count;
+};
+
+static void d3d12_desc_host_copy_batch_flush(struct d3d12_desc_host_copy_batch *batch,
+        struct d3d12_device *device)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+
+    if (batch->write_count)
+    {
+        VK_CALL(vkUpdateDescriptorSets(device->vk_device, batch->write_count, batch->vk_writes, 0, NULL));
+        batch->write_count = 0;
+    }
+}
+
+static void d3d12_desc_copy_from_host(struct d3d12_desc *dst, struct d3d12_desc *src,
+        struct d3d12_device *device, struct d3d12_desc_host_copy_batch *batch)
+{
+    struct vkd3d_host_descriptor *src_host = &src->heap->host_descriptors[src->heap_offset];
+    VkDescriptorType vk_null_type = src->heap->descriptor_null_types[src->heap_offset];
+    struct vkd3d_descriptor_data metadata = *src->metadata;
+    const struct vkd3d_host_descriptor_write *host_write;
+    struct d3d12_descriptor_heap *dst_heap = dst->heap;
+    struct vkd3d_host_descriptor *dst_host;
+    VkWriteDescriptorSet *vk_write;
+    uint32_t i;
+
+    if (d3d12_descriptor_heap_is_host_only(dst_heap))
+    {
+        dst_host = &dst_heap->host_descriptors[dst->heap_offset];
+        if (!vkd3d_host_descriptor_reserve_writes(dst_host, src_host->write_count))
+        {
+            ERR("Failed to allocate host descriptor writes.\n");
+            dst_host->write_count = 0;
+            return;
+        }
+
+        dst_host->write_count = src_host->write_count;
+        for (i = 0; i < src_host->write_count; i++)
+            *vkd3d_host_descriptor_get_write(dst_host, i) = *vkd3d_host_descriptor_get_write(src_host, i);
+        dst_heap->descriptor_null_types[dst->heap_offset] = vk_null_type;
+    }
+    else if (!(metadata.flags & VKD3D_DESCRIPTOR_FLAG_NON_NULL))
+    {
+        /* Host-only heaps never materialize null descriptors, instantiate the template of the
+         * destination heap instead. Freshly created descriptors have no null type yet,
+         * so fall back to the type we zero-initialize mutable heaps with. */
+        if (!vk_null_type)
+            vk_null_type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        d3d12_descriptor_heap_write_null_descriptor_template(dst, vk_null_type);
+        return;
+    }
+    else if (d3d12_desc_needs_update(dst, src))
+    {
+        for (i = 0; i < src_host->write_count; i++)
+        {
+            if (batch->write_count == ARRAY_SIZE(batch->vk_writes))
+                d3d12_desc_host_copy_batch_flush(batch, device);
+
+            host_write = vkd3d_host_descriptor_get_write(src_host, i);
+            vk_write = &batch->vk_writes[batch->write_count++];
+            vk_write->sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            vk_write->pNext = NULL;
+            vk_write->dstSet = dst_heap->vk_descriptor_sets[host_write->binding.set];
+            vk_write->dstBinding = host_write->binding.binding;
+            vk_write->dstArrayElement = dst->heap_offset;
+            vk_write->descriptorCount = 1;
+            vk_write->descriptorType = host_write->vk_descriptor_type;
+            vk_write->pImageInfo = &host_write->info.image;
+            vk_write->pBufferInfo = &host_write->info.buffer;
+            vk_write->pTexelBufferView = &host_write->info.buffer_view;
+        }
+    }
+
+    *dst->metadata = metadata;
+    *dst->info = *src->info;
+
+    if (metadata.flags & VKD3D_DESCRIPTOR_FLAG_RAW_VA_AUX_BUFFER)
+    {
+        if (dst_heap->raw_va_aux_buffer.host_ptr)
+        {
+            const VkDeviceAddress *src_vas = src->heap->raw_va_aux_buffer.host_ptr;
+            VkDeviceAddress *dst_vas = dst_heap->raw_va_aux_buffer.host_ptr;
+            dst_vas[dst->heap_offset] = src_vas[src->heap_offset];
+        }
+    }
+
+    if (metadata.flags & VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET)
+    {
+        const struct vkd3d_bound_buffer_range *src_buffer_ranges = src->heap->buffer_ranges.host_ptr;
+        struct vkd3d_bound_buffer_range *dst_buffer_ranges = dst_heap->buffer_ranges.host_ptr;
+        dst_buffer_ranges[dst->heap_offset] = src_buffer_ranges[src->heap_offset];
+    }
+}
+
 static void d3d12_desc_copy_single(struct d3d12_desc *dst, struct d3d12_desc *src,
         struct d3d12_device *device)
 {
     VkCopyDescriptorSet vk_copies[VKD3D_MAX_BINDLESS_DESCRIPTOR_SETS];
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
-    struct vkd3d_descriptor_data metadata = src->metadata;
+    struct vkd3d_descriptor_data metadata = *src->metadata;
     struct vkd3d_descriptor_binding binding;
     uint32_t set_mask, set_info_index;
     const VkDescriptorSet *src_sets;
     const VkDescriptorSet *dst_sets;
     VkCopyDescriptorSet *vk_copy;
     uint32_t copy_count = 0;
-    bool needs_update;
 
-    /* Only update the descriptor if something has changed */
-    if (!(needs_update = (metadata.cookie != dst->metadata.cookie)))
-    {
-        /* We don't have a cookie for the UAV counter, so just force update if we have that.
-         * If flags differ, we also need to update. E.g. happens if UAV counter flag is turned off.
-         * We have no cookie for the UAV counter itself.
-         * Lastly, if we have plain VkBuffers, offset/range might differ. */
-        if ((metadata.flags & VKD3D_DESCRIPTOR_FLAG_RAW_VA_AUX_BUFFER) != 0 ||
-            (metadata.flags != dst->metadata.flags))
-        {
-            needs_update = true;
-        }
-        else if (metadata.flags & VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE)
-        {
-            needs_update =
-                    dst->info.buffer.offset != src->info.buffer.offset ||
-                    dst->info.buffer.range != src->info.buffer.range;
-        }
-    }
-
-    if (needs_update)
+    if (d3d12_desc_needs_update(dst, src))
     {
         src_sets = src->heap->vk_descriptor_sets;
         dst_sets = dst->heap->vk_descriptor_sets;
-        dst->metadata = metadata;
-        dst->info = src->info;
-        set_mask = metadata.set_info_mask;
+        *dst->metadata = metadata;
+        *dst->info = *src->info;
+        dst->heap->descriptor_null_types[dst->heap_offset] = src->heap->descriptor_null_types[src->heap_offset];
+        set_mask = d3d12_desc_get_set_info_mask(src->heap, &metadata);
 
         while (set_mask)
         {
@@ -2982,11 +3227,13 @@ void d3d12_desc_copy_range(struct d3d12_desc *dst, struct d3d12_desc *src,
     unsigned int i;
 
     for (i = 0; i < count; i++)
-    {
-        set_info_mask |= src[i].metadata.set_info_mask;
-        dst[i].metadata = src[i].metadata;
-        dst[i].info = src[i].info;
-    }
+        set_info_mask |= d3d12_desc_get_set_info_mask(src->heap, &src->metadata[i]);
+
+    memcpy(dst->metadata, src->metadata, count * sizeof(*dst->metadata));
+    memcpy(dst->info, src->info, count * sizeof(*dst->info));
+    memcpy(&dst->heap->descriptor_null_types[dst->heap_offset],
+            &src->heap->descriptor_null_types[src->heap_offset],
+            count * sizeof(*dst->heap->descriptor_null_types));
 
     while (set_info_mask)
     {
@@ -3044,24 +3291,52 @@ void d3d12_desc_copy_range(struct d3d12_desc *dst, struct d3d12_desc *src,
 void d3d12_desc_copy(struct d3d12_desc *dst, struct d3d12_desc *src,
         unsigned int count, D3D12_DESCRIPTOR_HEAP_TYPE heap_type, struct d3d12_device *device)
 {
+    struct d3d12_desc dst_desc, src_desc;
     unsigned int i;
 
 #ifdef VKD3D_ENABLE_DESCRIPTOR_QA
     for (i = 0; i < count; i++)
     {
         vkd3d_descriptor_debug_copy_descriptor(
-                dst[i].heap->descriptor_heap_info.host_ptr, dst[i].heap->cookie, dst[i].heap_offset,
-                src[i].heap->descriptor_heap_info.host_ptr, src[i].heap->cookie, src[i].heap_offset,
-                src[i].metadata.cookie);
+                dst->heap->descriptor_heap_info.host_ptr, dst->heap->cookie, dst->heap_offset + i,
+                src->heap->descriptor_heap_info.host_ptr, src->heap->cookie, src->heap_offset + i,
+                src->metadata[i].cookie);
     }
 #endif
 
-    if (device->bindless_state.flags & VKD3D_BINDLESS_MUTABLE_TYPE)
+    if (d3d12_descriptor_heap_is_host_only(src->heap))
+    {
+        struct d3d12_desc_host_copy_batch batch;
+
+        batch.write_count = 0;
+        for (i = 0; i < count; i++)
+        {
+            dst_desc = d3d12_desc_from_heap(dst->heap, dst->heap_offset + i);
+            src_desc = d3d12_desc_from_heap(src->heap, src->heap_offset + i);
+            d3d12_desc_copy_from_host(&dst_desc, &src_desc, device, &batch);
+        }
+        d3d12_desc_host_copy_batch_flush(&batch, device);
+    }
+    else if (d3d12_descriptor_heap_is_host_only(dst->heap))
+    {
+        /* Copying out of shader visible heaps is not allowed in D3D12,
+         * and we have nothing to read the descriptor payload back from. */
+        FIXME_ONCE("Copying from shader visible heap to host-only heap is not supported.\n");
+        memcpy(dst->metadata, src->metadata, count * sizeof(*dst->metadata));
+        memcpy(dst->info, src->info, count * sizeof(*dst->info));
+        for (i = 0; i < count; i++)
+            dst->heap->host_descriptors[dst->heap_offset + i].write_count = 0;
+    }
+    else if (device->bindless_state.flags & VKD3D_BINDLESS_MUTABLE_TYPE)
         d3d12_desc_copy_range(dst, src, count, heap_type, device);
     else
     {
         for (i = 0; i < count; i++)
-            d3d12_desc_copy_single(dst + i, src + i, device);
+        {
+            dst_desc = d3d12_desc_from_heap(dst->heap, dst->heap_offset + i);
+            src_desc = d3d12_desc_from_heap(src->heap, src->heap_offset + i);
+            d3d12_desc_copy_single(&dst_desc, &src_desc, device);
+        }
     }
 }
 
@@ -3109,7 +3384,7 @@ bool vkd3d_create_raw_r32ui_vk_buffer_view(struct d3d12_device *device,
     view_desc.format = VK_FORMAT_R32_UINT;
     view_desc.offset = offset;
     view_desc.range = range;
-    if ((vr = VK_CALL(vkCreateBufferView(device->vk_device, &view_desc, NULL, vk_view))) < 0)
+    if ((vr = VK_CALL(vkCreateBufferView(device->vk_device, &view_desc, &vkd3d_vk_allocator, vk_view))) < 0)
         WARN("Failed to create Vulkan buffer view, vr %d.\n", vr);
     return vr == VK_SUCCESS;
 }
@@ -3140,7 +3415,7 @@ static bool vkd3d_create_vk_buffer_view(struct d3d12_device *device,
     view_desc.format = format->vk_format;
     view_desc.offset = offset;
     view_desc.range = range;
-    if ((vr = VK_CALL(vkCreateBufferView(device->vk_device, &view_desc, NULL, vk_view))) < 0)
+    if ((vr = VK_CALL(vkCreateBufferView(device->vk_device, &view_desc, &vkd3d_vk_allocator, vk_view))) < 0)
         WARN("Failed to create Vulkan buffer view, vr %d.\n", vr);
     return vr == VK_SUCCESS;
 }
@@ -3156,7 +3431,7 @@ bool vkd3d_create_buffer_view(struct d3d12_device *device, const struct vkd3d_bu
 
     if (!(object = vkd3d_view_create(VKD3D_VIEW_TYPE_BUFFER)))
     {
-        VK_CALL(vkDestroyBufferView(device->vk_device, vk_view, NULL));
+        VK_CALL(vkDestroyBufferView(device->vk_device, vk_view, &vkd3d_vk_allocator));
         return false;
     }
 
@@ -3188,13 +3463,13 @@ bool vkd3d_create_acceleration_structure_view(struct d3d12_device *device, const
     create_info.offset = desc->offset;
     create_info.size = desc->size;
 
-    vr = VK_CALL(vkCreateAccelerationStructureKHR(device->vk_device, &create_info, NULL, &vk_acceleration_structure));
+    vr = VK_CALL(vkCreateAccelerationStructureKHR(device->vk_device, &create_info, &vkd3d_vk_allocator, &vk_acceleration_structure));
     if (vr != VK_SUCCESS)
         return false;
 
     if (!(object = vkd3d_view_create(VKD3D_VIEW_TYPE_ACCELERATION_STRUCTURE)))
     {
-        VK_CALL(vkDestroyAccelerationStructureKHR(device->vk_device, vk_acceleration_structure, NULL));
+        VK_CALL(vkDestroyAccelerationStructureKHR(device->vk_device, vk_acceleration_structure, &vkd3d_vk_allocator));
         return false;
     }
 
@@ -3499,7 +3774,7 @@ bool vkd3d_create_texture_view(struct d3d12_device *device, const struct vkd3d_t
             view_desc.subresourceRange.baseMipLevel = clamp_base_level;
     }
 
-    if ((vr = VK_CALL(vkCreateImageView(device->vk_device, &view_desc, NULL, &vk_view))) < 0)
+    if ((vr = VK_CALL(vkCreateImageView(device->vk_device, &view_desc, &vkd3d_vk_allocator, &vk_view))) < 0)
     {
         WARN("Failed to create Vulkan image view, vr %d.\n", vr);
         return false;
@@ -3507,7 +3782,7 @@ bool vkd3d_create_texture_view(struct d3d12_device *device, const struct vkd3d_t
 
     if (!(object = vkd3d_view_create(VKD3D_VIEW_TYPE_IMAGE)))
     {
-        VK_CALL(vkDestroyImageView(device->vk_device, vk_view, NULL));
+        VK_CALL(vkDestroyImageView(device->vk_device, vk_view, &vkd3d_vk_allocator));
         return false;
     }
 
@@ -3522,9 +3797,29 @@ bool vkd3d_create_texture_view(struct d3d12_device *device, const struct vkd3d_t
 }
 
 static inline void vkd3d_init_write_descriptor_set(VkWriteDescriptorSet *vk_write, const struct d3d12_desc *descriptor,
-        struct vkd3d_descriptor_binding binding,
+        uint32_t write_index, struct vkd3d_descriptor_binding binding,
         VkDescriptorType vk_descriptor_type, const union vkd3d_descriptor_info *info)
 {
+    struct vkd3d_host_descriptor_write *host_write;
+    struct vkd3d_host_descriptor *host;
+
+    if (d3d12_descriptor_heap_is_host_only(descriptor->heap))
+    {
+        host = &descriptor->heap->host_descriptors[descriptor->heap_offset];
+        if (!vkd3d_host_descriptor_reserve_writes(host, write_index + 1))
+        {
+            /* d3d12_desc_update_descriptor_sets() only keeps the inline write. */
+            ERR("Failed to allocate host descriptor writes.\n");
+            return;
+        }
+
+        host_write = vkd3d_host_descriptor_get_write(host, write_index);
+        host_write->binding = binding;
+        host_write->vk_descriptor_type = vk_descriptor_type;
+        host_write->info = *info;
+        return;
+    }
+
     vk_write->sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     vk_write->pNext = NULL;
     vk_write->dstSet = descriptor->heap->vk_descriptor_sets[binding.set];
@@ -3537,6 +3832,22 @@ static inline void vkd3d_init_write_descriptor_set(VkWriteDescriptorSet *vk_writ
     vk_write->pTexelBufferView = &info->buffer_view;
 }
 
+static void d3d12_desc_update_descriptor_sets(struct d3d12_desc *descriptor, struct d3d12_device *device,
+        uint32_t write_count, const VkWriteDescriptorSet *vk_writes)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+
+    struct vkd3d_host_descriptor *host;
+
+    if (d3d12_descriptor_heap_is_host_only(descriptor->heap))
+    {
+        host = &descriptor->heap->host_descriptors[descriptor->heap_offset];
+        host->write_count = host->extra_writes ? write_count : min(write_count, 1u);
+    }
+    else if (write_count)
+        VK_CALL(vkUpdateDescriptorSets(device->vk_device, write_count, vk_writes, 0, NULL));
+}
+
 static void d3d12_descriptor_heap_write_null_descriptor_template(struct d3d12_desc *desc,
         VkDescriptorType vk_mutable_descriptor_type)
 {
@@ -3560,29 +3871,37 @@ static void d3d12_descriptor_heap_write_null_descriptor_template(struct d3d12_de
         vk_mutable_descriptor_type = 0;
 
     /* Skip writes with the same null type that are already null. */
-    if (!(desc->metadata.flags & VKD3D_DESCRIPTOR_FLAG_NON_NULL)
-            && desc->metadata.current_null_type == vk_mutable_descriptor_type)
+    if (!(desc->metadata->flags & VKD3D_DESCRIPTOR_FLAG_NON_NULL)
+            && heap->descriptor_null_types[desc->heap_offset] == vk_mutable_descriptor_type)
         return;
 
     num_writes = heap->null_descriptor_template.num_writes;
     vk_procs = &heap->device->vk_procs;
     offset = desc->heap_offset;
 
-    for (i = 0; i < num_writes; i++)
+    if (d3d12_descriptor_heap_is_host_only(heap))
     {
-        writes[i] = heap->null_descriptor_template.writes[i];
-        if (writes[i].descriptorType == VK_DESCRIPTOR_TYPE_MUTABLE_VALVE)
-            writes[i].descriptorType = vk_mutable_descriptor_type;
-        writes[i].dstArrayElement = offset;
+        /* The null template is instantiated in the destination heap on copy. */
+        heap->host_descriptors[offset].write_count = 0;
     }
+    else
+    {
+        for (i = 0; i < num_writes; i++)
+        {
+            writes[i] = heap->null_descriptor_template.writes[i];
+            if (writes[i].descriptorType == VK_DESCRIPTOR_TYPE_MUTABLE_VALVE)
+                writes[i].descriptorType = vk_mutable_descriptor_type;
+            writes[i].dstArrayElement = offset;
+        }
 
-    VK_CALL(vkUpdateDescriptorSets(heap->device->vk_device, num_writes, writes, 0, NULL));
+        VK_CALL(vkUpdateDescriptorSets(heap->device->vk_device, num_writes, writes, 0, NULL));
+    }
 
-    desc->metadata.cookie = 0;
-    desc->metadata.flags = 0;
-    desc->metadata.set_info_mask = heap->null_descriptor_template.set_info_mask;
-    desc->metadata.current_null_type = vk_mutable_descriptor_type;
-    memset(&desc->info, 0, sizeof(desc->info));
+    desc->metadata->cookie = 0;
+    desc->metadata->flags = 0;
+    desc->metadata->set_info_mask = heap->null_descriptor_template.set_info_mask;
+    heap->descriptor_null_types[offset] = vk_mutable_descriptor_type;
+    memset(desc->info, 0, sizeof(*desc->info));
 
     va = heap->raw_va_aux_buffer.host_ptr;
     if (va)
@@ -3604,7 +3923,6 @@ static void d3d12_descriptor_heap_write_null_descriptor_template(struct d3d12_de
 void d3d12_desc_create_cbv(struct d3d12_desc *descriptor,
         struct d3d12_device *device, const D3D12_CONSTANT_BUFFER_VIEW_DESC *desc)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     const struct vkd3d_unique_resource *resource = NULL;
     union vkd3d_descriptor_info descriptor_info;
     VkDescriptorType vk_descriptor_type;
@@ -3638,12 +3956,12 @@ void d3d12_desc_create_cbv(struct d3d12_desc *descriptor,
 
     info_index = vkd3d_bindless_state_find_set_info_index(&device->bindless_state, VKD3D_BINDLESS_SET_CBV);
 
-    descriptor->metadata.cookie = resource ? resource->cookie : 0;
-    descriptor->metadata.set_info_mask = 1u << info_index;
-    descriptor->metadata.flags = VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
-    descriptor->info.buffer = descriptor_info.buffer;
+    descriptor->metadata->cookie = resource ? resource->cookie : 0;
+    descriptor->metadata->set_info_mask = 1u << info_index;
+    descriptor->metadata->flags = VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
+    descriptor->info->buffer = descriptor_info.buffer;
 
-    vkd3d_init_write_descriptor_set(&vk_write, descriptor,
+    vkd3d_init_write_descriptor_set(&vk_write, descriptor, 0,
             vkd3d_bindless_state_binding_from_info_index(&device->bindless_state, info_index),
             vk_descriptor_type, &descriptor_info);
 
@@ -3653,9 +3971,9 @@ void d3d12_desc_create_cbv(struct d3d12_desc *descriptor,
             vk_descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ?
                     VKD3D_DESCRIPTOR_QA_TYPE_UNIFORM_BUFFER_BIT :
                     VKD3D_DESCRIPTOR_QA_TYPE_STORAGE_BUFFER_BIT,
-            descriptor->metadata.cookie);
+            descriptor->metadata->cookie);
 
-    VK_CALL(vkUpdateDescriptorSets(device->vk_device, 1, &vk_write, 0, NULL));
+    d3d12_desc_update_descriptor_sets(descriptor, device, 1, &vk_write);
 }
 
 static unsigned int vkd3d_view_flags_from_d3d12_buffer_srv_flags(D3D12_BUFFER_SRV_FLAGS flags)
@@ -3783,7 +4101,6 @@ static void vkd3d_create_buffer_srv(struct d3d12_desc *descriptor,
         struct d3d12_device *device, struct d3d12_resource *resource,
         const D3D12_SHADER_RESOURCE_VIEW_DESC *desc)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     VKD3D_UNUSED vkd3d_descriptor_qa_flags descriptor_qa_flags = 0;
     struct vkd3d_bound_buffer_range bound_range = { 0, 0, 0, 0 };
     union vkd3d_descriptor_info descriptor_info[2];
@@ -3817,11 +4134,11 @@ static void vkd3d_create_buffer_srv(struct d3d12_desc *descriptor,
             VkDeviceAddress *raw_addresses = descriptor->heap->raw_va_aux_buffer.host_ptr;
             uint32_t descriptor_index = d3d12_desc_heap_offset(descriptor);
             raw_addresses[descriptor_index] = desc->RaytracingAccelerationStructure.Location;
-            descriptor->metadata.flags = VKD3D_DESCRIPTOR_FLAG_RAW_VA_AUX_BUFFER |
+            descriptor->metadata->flags = VKD3D_DESCRIPTOR_FLAG_RAW_VA_AUX_BUFFER |
                                          VKD3D_DESCRIPTOR_FLAG_NON_NULL;
-            descriptor->metadata.set_info_mask = 0;
+            descriptor->metadata->set_info_mask = 0;
             /* There is no resource tied to this descriptor, just a naked pointer. */
-            descriptor->metadata.cookie = 0;
+            descriptor->metadata->cookie = 0;
         }
         else
             WARN("Using CreateSRV for RTAS without RT support?\n");
@@ -3829,7 +4146,7 @@ static void vkd3d_create_buffer_srv(struct d3d12_desc *descriptor,
         vkd3d_descriptor_debug_write_descriptor(descriptor->heap->descriptor_heap_info.host_ptr,
                 descriptor->heap->cookie, descriptor->heap_offset,
                 VKD3D_DESCRIPTOR_QA_TYPE_RT_ACCELERATION_STRUCTURE_BIT | VKD3D_DESCRIPTOR_QA_TYPE_RAW_VA_BIT,
-                descriptor->metadata.cookie);
+                descriptor->metadata->cookie);
 
         return;
     }
@@ -3847,8 +4164,8 @@ static void vkd3d_create_buffer_srv(struct d3d12_desc *descriptor,
         return;
     }
 
-    descriptor->metadata.set_info_mask = 0;
-    descriptor->metadata.flags = 0;
+    descriptor->metadata->set_info_mask = 0;
+    descriptor->metadata->flags = 0;
 
     if (d3d12_device_use_ssbo_raw_buffer(device))
     {
@@ -3863,18 +4180,18 @@ static void vkd3d_create_buffer_srv(struct d3d12_desc *descriptor,
         info_index = vkd3d_bindless_state_find_set_info_index(&device->bindless_state,
                 VKD3D_BINDLESS_SET_SRV | VKD3D_BINDLESS_SET_RAW_SSBO);
 
-        descriptor->info.buffer = descriptor_info[vk_write_count].buffer;
-        descriptor->metadata.cookie = resource ? resource->res.cookie : 0;
-        descriptor->metadata.set_info_mask |= 1u << info_index;
+        descriptor->info->buffer = descriptor_info[vk_write_count].buffer;
+        descriptor->metadata->cookie = resource ? resource->res.cookie : 0;
+        descriptor->metadata->set_info_mask |= 1u << info_index;
 
-        descriptor->metadata.flags |= VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE |
+        descriptor->metadata->flags |= VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE |
                                       VKD3D_DESCRIPTOR_FLAG_NON_NULL;
         if (device->bindless_state.flags & VKD3D_SSBO_OFFSET_BUFFER)
-            descriptor->metadata.flags |= VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET;
+            descriptor->metadata->flags |= VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET;
 
         vk_descriptor_type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         descriptor_qa_flags |= VKD3D_DESCRIPTOR_QA_TYPE_STORAGE_BUFFER_BIT;
-        vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor,
+        vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor, vk_write_count,
                 vkd3d_bindless_state_binding_from_info_index(&device->bindless_state, info_index),
                 vk_descriptor_type, &descriptor_info[vk_write_count]);
         vk_write_count++;
@@ -3891,43 +4208,41 @@ static void vkd3d_create_buffer_srv(struct d3d12_desc *descriptor,
     info_index = vkd3d_bindless_state_find_set_info_index(&device->bindless_state,
             VKD3D_BINDLESS_SET_SRV | VKD3D_BINDLESS_SET_BUFFER);
 
-    descriptor->info.view = view;
+    descriptor->info->view = view;
     /* Typed cookie takes precedence over raw cookie.
      * The typed cookie is more unique than raw cookie,
      * since raw cookie is just the ID3D12Resource. */
-    descriptor->metadata.cookie = view ? view->cookie : 0;
-    descriptor->metadata.set_info_mask |= 1u << info_index;
+    descriptor->metadata->cookie = view ? view->cookie : 0;
+    descriptor->metadata->set_info_mask |= 1u << info_index;
 
-    descriptor->metadata.flags |= VKD3D_DESCRIPTOR_FLAG_VIEW | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
+    descriptor->metadata->flags |= VKD3D_DESCRIPTOR_FLAG_VIEW | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
     if (device->bindless_state.flags & VKD3D_TYPED_OFFSET_BUFFER)
-        descriptor->metadata.flags |= VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET;
+        descriptor->metadata->flags |= VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET;
 
     vk_descriptor_type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
     descriptor_qa_flags |= VKD3D_DESCRIPTOR_QA_TYPE_UNIFORM_TEXEL_BUFFER_BIT;
 
-    vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor,
+    vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor, vk_write_count,
             vkd3d_bindless_state_binding_from_info_index(&device->bindless_state, info_index),
             vk_descriptor_type, &descriptor_info[vk_write_count]);
     vk_write_count++;
 
-    if (descriptor->metadata.flags & VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET)
+    if (descriptor->metadata->flags & VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET)
     {
         struct vkd3d_bound_buffer_range *buffer_ranges = descriptor->heap->buffer_ranges.host_ptr;
         buffer_ranges[descriptor->heap_offset] = bound_range;
     }
 
     vkd3d_descriptor_debug_write_descriptor(descriptor->heap->descriptor_heap_info.host_ptr,
-            descriptor->heap->cookie, descriptor->heap_offset, descriptor_qa_flags, descriptor->metadata.cookie);
+            descriptor->heap->cookie, descriptor->heap_offset, descriptor_qa_flags, descriptor->metadata->cookie);
 
-    if (vk_write_count)
-        VK_CALL(vkUpdateDescriptorSets(device->vk_device, vk_write_count, vk_write, 0, NULL));
+    d3d12_desc_update_descriptor_sets(descriptor, device, vk_write_count, vk_write);
 }
 
 static void vkd3d_create_texture_srv(struct d3d12_desc *descriptor,
         struct d3d12_device *device, struct d3d12_resource *resource,
         const D3D12_SHADER_RESOURCE_VIEW_DESC *desc)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     union vkd3d_descriptor_info descriptor_info;
     struct vkd3d_view *view = NULL;
     VkWriteDescriptorSet vk_write;
@@ -4041,20 +4356,20 @@ static void vkd3d_create_texture_srv(struct d3d12_desc *descriptor,
     info_index = vkd3d_bindless_state_find_set_info_index(&device->bindless_state,
             VKD3D_BINDLESS_SET_SRV | VKD3D_BINDLESS_SET_IMAGE);
 
-    descriptor->info.view = view;
-    descriptor->metadata.cookie = view ? view->cookie : 0;
-    descriptor->metadata.set_info_mask = 1u << info_index;
-    descriptor->metadata.flags = VKD3D_DESCRIPTOR_FLAG_VIEW | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
+    descriptor->info->view = view;
+    descriptor->metadata->cookie = view ? view->cookie : 0;
+    descriptor->metadata->set_info_mask = 1u << info_index;
+    descriptor->metadata->flags = VKD3D_DESCRIPTOR_FLAG_VIEW | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
 
-    vkd3d_init_write_descriptor_set(&vk_write, descriptor,
+    vkd3d_init_write_descriptor_set(&vk_write, descriptor, 0,
             vkd3d_bindless_state_binding_from_info_index(&device->bindless_state, info_index),
             VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &descriptor_info);
 
     vkd3d_descriptor_debug_write_descriptor(descriptor->heap->descriptor_heap_info.host_ptr,
             descriptor->heap->cookie, descriptor->heap_offset,
-            VKD3D_DESCRIPTOR_QA_TYPE_SAMPLED_IMAGE_BIT, descriptor->metadata.cookie);
+            VKD3D_DESCRIPTOR_QA_TYPE_SAMPLED_IMAGE_BIT, descriptor->metadata->cookie);
 
-    VK_CALL(vkUpdateDescriptorSets(device->vk_device, 1, &vk_write, 0, NULL));
+    d3d12_desc_update_descriptor_sets(descriptor, device, 1, &vk_write);
 }
 
 void d3d12_desc_create_srv(struct d3d12_desc *descriptor,
@@ -4122,7 +4437,6 @@ static void vkd3d_create_buffer_uav(struct d3d12_desc *descriptor, struct d3d12_
         struct d3d12_resource *resource, struct d3d12_resource *counter_resource,
         const D3D12_UNORDERED_ACCESS_VIEW_DESC *desc)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     VKD3D_UNUSED vkd3d_descriptor_qa_flags descriptor_qa_flags = 0;
     struct vkd3d_bound_buffer_range bound_range = { 0, 0, 0, 0 };
     union vkd3d_descriptor_info descriptor_info[3];
@@ -4156,8 +4470,8 @@ static void vkd3d_create_buffer_uav(struct d3d12_desc *descriptor, struct d3d12_
     /* Handle UAV itself */
     flags = vkd3d_view_flags_from_d3d12_buffer_uav_flags(desc->Buffer.Flags);
 
-    descriptor->metadata.set_info_mask = 0;
-    descriptor->metadata.flags = VKD3D_DESCRIPTOR_FLAG_RAW_VA_AUX_BUFFER |
+    descriptor->metadata->set_info_mask = 0;
+    descriptor->metadata->flags = VKD3D_DESCRIPTOR_FLAG_RAW_VA_AUX_BUFFER |
                                  VKD3D_DESCRIPTOR_FLAG_NON_NULL;
 
     if (d3d12_device_use_ssbo_raw_buffer(device))
@@ -4175,18 +4489,18 @@ static void vkd3d_create_buffer_uav(struct d3d12_desc *descriptor, struct d3d12_
         info_index = vkd3d_bindless_state_find_set_info_index(&device->bindless_state,
                 VKD3D_BINDLESS_SET_UAV | VKD3D_BINDLESS_SET_RAW_SSBO);
 
-        descriptor->info.buffer = *buffer_info;
-        descriptor->metadata.cookie = resource ? resource->res.cookie : 0;
-        descriptor->metadata.set_info_mask |= 1u << info_index;
+        descriptor->info->buffer = *buffer_info;
+        descriptor->metadata->cookie = resource ? resource->res.cookie : 0;
+        descriptor->metadata->set_info_mask |= 1u << info_index;
 
-        descriptor->metadata.flags |= VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE;
+        descriptor->metadata->flags |= VKD3D_DESCRIPTOR_FLAG_OFFSET_RANGE;
         if (device->bindless_state.flags & VKD3D_SSBO_OFFSET_BUFFER)
-            descriptor->metadata.flags |= VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET;
+            descriptor->metadata->flags |= VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET;
 
         vk_descriptor_type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         descriptor_qa_flags |= VKD3D_DESCRIPTOR_QA_TYPE_STORAGE_BUFFER_BIT;
 
-        vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor,
+        vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor, vk_write_count,
                 vkd3d_bindless_state_binding_from_info_index(&device->bindless_state, info_index),
                 vk_descriptor_type, &descriptor_info[vk_write_count]);
         vk_write_count++;
@@ -4203,28 +4517,28 @@ static void vkd3d_create_buffer_uav(struct d3d12_desc *descriptor, struct d3d12_
     info_index = vkd3d_bindless_state_find_set_info_index(&device->bindless_state,
             VKD3D_BINDLESS_SET_UAV | VKD3D_BINDLESS_SET_BUFFER);
 
-    descriptor->info.view = view;
+    descriptor->info->view = view;
     /* Typed cookie takes precedence over raw cookie.
      * The typed cookie is more unique than raw cookie,
      * since raw cookie is just the ID3D12Resource. */
-    descriptor->metadata.cookie = view ? view->cookie : 0;
-    descriptor->metadata.set_info_mask |= 1u << info_index;
+    descriptor->metadata->cookie = view ? view->cookie : 0;
+    descriptor->metadata->set_info_mask |= 1u << info_index;
 
-    descriptor->metadata.flags |= VKD3D_DESCRIPTOR_FLAG_VIEW;
+    descriptor->metadata->flags |= VKD3D_DESCRIPTOR_FLAG_VIEW;
     if (device->bindless_state.flags & VKD3D_TYPED_OFFSET_BUFFER)
-        descriptor->metadata.flags |= VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET;
+        descriptor->metadata->flags |= VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET;
 
     descriptor_info[vk_write_count].buffer_view = view ? view->vk_buffer_view : VK_NULL_HANDLE;
 
     vk_descriptor_type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
     descriptor_qa_flags |= VKD3D_DESCRIPTOR_QA_TYPE_STORAGE_TEXEL_BUFFER_BIT;
 
-    vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor,
+    vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor, vk_write_count,
             vkd3d_bindless_state_binding_from_info_index(&device->bindless_state, info_index),
             vk_descriptor_type, &descriptor_info[vk_write_count]);
     vk_write_count++;
 
-    if (descriptor->metadata.flags & VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET)
+    if (descriptor->metadata->flags & VKD3D_DESCRIPTOR_FLAG_BUFFER_OFFSET)
     {
         struct vkd3d_bound_buffer_range *buffer_ranges = descriptor->heap->buffer_ranges.host_ptr;
         buffer_ranges[descriptor->heap_offset] = bound_range;
@@ -4271,7 +4585,7 @@ static void vkd3d_create_buffer_uav(struct d3d12_desc *descriptor, struct d3d12_
                 &device->bindless_state, VKD3D_BINDLESS_SET_UAV | VKD3D_BINDLESS_SET_AUX_BUFFER);
 
         descriptor_info[vk_write_count].buffer_view = uav_counter_view;
-        vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor,
+        vkd3d_init_write_descriptor_set(&vk_write[vk_write_count], descriptor, vk_write_count,
                 binding,
                 VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, &descriptor_info[vk_write_count]);
         vk_write_count++;
@@ -4279,16 +4593,15 @@ static void vkd3d_create_buffer_uav(struct d3d12_desc *descriptor, struct d3d12_
 
     vkd3d_descriptor_debug_write_descriptor(descriptor->heap->descriptor_heap_info.host_ptr,
             descriptor->heap->cookie, descriptor->heap_offset,
-            descriptor_qa_flags, descriptor->metadata.cookie);
+            descriptor_qa_flags, descriptor->metadata->cookie);
 
-    VK_CALL(vkUpdateDescriptorSets(device->vk_device, vk_write_count, vk_write, 0, NULL));
+    d3d12_desc_update_descriptor_sets(descriptor, device, vk_write_count, vk_write);
 }
 
 static void vkd3d_create_texture_uav(struct d3d12_desc *descriptor,
         struct d3d12_device *device, struct d3d12_resource *resource,
         const D3D12_UNORDERED_ACCESS_VIEW_DESC *desc)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     union vkd3d_descriptor_info descriptor_info;
     struct vkd3d_view *view = NULL;
     VkWriteDescriptorSet vk_write;
@@ -4366,20 +4679,20 @@ static void vkd3d_create_texture_uav(struct d3d12_desc *descriptor,
     info_index = vkd3d_bindless_state_find_set_info_index(&device->bindless_state,
             VKD3D_BINDLESS_SET_UAV | VKD3D_BINDLESS_SET_IMAGE);
 
-    descriptor->info.view = view;
-    descriptor->metadata.cookie = view ? view->cookie : 0;
-    descriptor->metadata.set_info_mask = 1u << info_index;
-    descriptor->metadata.flags = VKD3D_DESCRIPTOR_FLAG_VIEW | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
+    descriptor->info->view = view;
+    descriptor->metadata->cookie = view ? view->cookie : 0;
+    descriptor->metadata->set_info_mask = 1u << info_index;
+    descriptor->metadata->flags = VKD3D_DESCRIPTOR_FLAG_VIEW | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
 
-    vkd3d_init_write_descriptor_set(&vk_write, descriptor,
+    vkd3d_init_write_descriptor_set(&vk_write, descriptor, 0,
             vkd3d_bindless_state_binding_from_info_index(&device->bindless_state, info_index),
             VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &descriptor_info);
 
     vkd3d_descriptor_debug_write_descriptor(descriptor->heap->descriptor_heap_info.host_ptr,
             descriptor->heap->cookie, descriptor->heap_offset,
-            VKD3D_DESCRIPTOR_QA_TYPE_STORAGE_IMAGE_BIT, descriptor->metadata.cookie);
+            VKD3D_DESCRIPTOR_QA_TYPE_STORAGE_IMAGE_BIT, descriptor->metadata->cookie);
 
-    VK_CALL(vkUpdateDescriptorSets(device->vk_device, 1, &vk_write, 0, NULL));
+    d3d12_desc_update_descriptor_sets(descriptor, device, 1, &vk_write);
 }
 
 void d3d12_desc_create_uav(struct d3d12_desc *descriptor, struct d3d12_device *device,
@@ -4586,7 +4899,7 @@ HRESULT d3d12_create_static_sampler(struct d3d12_device *device,
     if (reduction_desc.reductionMode != VK_SAMPLER_REDUCTION_MODE_WEIGHTED_AVERAGE_EXT && device->vk_info.EXT_sampler_filter_minmax)
         vk_prepend_struct(&sampler_desc, &reduction_desc);
 
-    if ((vr = VK_CALL(vkCreateSampler(device->vk_device, &sampler_desc, NULL, vk_sampler))) < 0)
+    if ((vr = VK_CALL(vkCreateSampler(device->vk_device, &sampler_desc, &vkd3d_vk_allocator, vk_sampler))) < 0)
         WARN("Failed to create Vulkan sampler, vr %d.\n", vr);
 
     return hresult_from_vk_result(vr);
@@ -4639,7 +4952,7 @@ static HRESULT d3d12_create_sampler(struct d3d12_device *device,
     if (reduction_desc.reductionMode != VK_SAMPLER_REDUCTION_MODE_WEIGHTED_AVERAGE_EXT && device->vk_info.EXT_sampler_filter_minmax)
         vk_prepend_struct(&sampler_desc, &reduction_desc);
 
-    if ((vr = VK_CALL(vkCreateSampler(device->vk_device, &sampler_desc, NULL, vk_sampler))) < 0)
+    if ((vr = VK_CALL(vkCreateSampler(device->vk_device, &sampler_desc, &vkd3d_vk_allocator, vk_sampler))) < 0)
         WARN("Failed to create Vulkan sampler, vr %d.\n", vr);
 
     return hresult_from_vk_result(vr);
@@ -4648,7 +4961,6 @@ static HRESULT d3d12_create_sampler(struct d3d12_device *device,
 void d3d12_desc_create_sampler(struct d3d12_desc *sampler,
         struct d3d12_device *device, const D3D12_SAMPLER_DESC *desc)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     union vkd3d_descriptor_info descriptor_info;
     VkWriteDescriptorSet vk_write;
     struct vkd3d_view_key key;
@@ -4671,24 +4983,24 @@ void d3d12_desc_create_sampler(struct d3d12_desc *sampler,
 
     info_index = vkd3d_bindless_state_find_set_info_index(&device->bindless_state, VKD3D_BINDLESS_SET_SAMPLER);
 
-    sampler->info.view = view;
-    sampler->metadata.cookie = view->cookie;
-    sampler->metadata.set_info_mask = 1u << info_index;
-    sampler->metadata.flags = VKD3D_DESCRIPTOR_FLAG_VIEW | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
+    sampler->info->view = view;
+    sampler->metadata->cookie = view->cookie;
+    sampler->metadata->set_info_mask = 1u << info_index;
+    sampler->metadata->flags = VKD3D_DESCRIPTOR_FLAG_VIEW | VKD3D_DESCRIPTOR_FLAG_NON_NULL;
 
     descriptor_info.image.sampler = view->vk_sampler;
     descriptor_info.image.imageView = VK_NULL_HANDLE;
     descriptor_info.image.imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-    vkd3d_init_write_descriptor_set(&vk_write, sampler,
+    vkd3d_init_write_descriptor_set(&vk_write, sampler, 0,
             vkd3d_bindless_state_binding_from_info_index(&device->bindless_state, info_index),
             VK_DESCRIPTOR_TYPE_SAMPLER, &descriptor_info);
 
     vkd3d_descriptor_debug_write_descriptor(sampler->heap->descriptor_heap_info.host_ptr,
             sampler->heap->cookie, sampler->heap_offset,
-            VKD3D_DESCRIPTOR_QA_TYPE_SAMPLER_BIT, sampler->metadata.cookie);
+            VKD3D_DESCRIPTOR_QA_TYPE_SAMPLER_BIT, sampler->metadata->cookie);
 
-    VK_CALL(vkUpdateDescriptorSets(device->vk_device, 1, &vk_write, 0, NULL));
+    d3d12_desc_update_descriptor_sets(sampler, device, 1, &vk_write);
 }
 
 /* RTVs */
@@ -4998,7 +5310,7 @@ static D3D12_CPU_DESCRIPTOR_HANDLE * STDMETHODCALLTYPE d3d12_descriptor_heap_Get
 
     TRACE("iface %p, descriptor %p.\n", iface, descriptor);
 
-    descriptor->ptr = (SIZE_T)heap->descriptors;
+    *descriptor = d3d12_descriptor_heap_get_cpu_handle_start(heap);
 
     return descriptor;
 }
@@ -5088,16 +5400,13 @@ static HRESULT d3d12_descriptor_heap_create_descriptor_pool(struct d3d12_descrip
     vk_pool_info.pNext = NULL;
 
     vk_pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
-    if (!(descriptor_heap->desc.Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) &&
-            (descriptor_heap->device->bindless_state.flags & VKD3D_BINDLESS_MUTABLE_TYPE))
-        vk_pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_HOST_ONLY_BIT_VALVE;
 
     vk_pool_info.maxSets = pool_count;
     vk_pool_info.poolSizeCount = pool_count;
     vk_pool_info.pPoolSizes = vk_pool_sizes;
 
     if ((vr = VK_CALL(vkCreateDescriptorPool(device->vk_device,
-            &vk_pool_info, NULL, vk_descriptor_pool))) < 0)
+            &vk_pool_info, &vkd3d_vk_allocator, vk_descriptor_pool))) < 0)
     {
         ERR("Failed to create descriptor pool, vr %d.\n", vr);
         return hresult_from_vk_result(vr);
@@ -5441,9 +5750,140 @@ static void d3d12_descriptor_heap_add_null_descriptor_template(
     descriptor_heap->null_descriptor_template.set_info_mask |= 1u << set_info_index;
 }
 
+struct d3d12_descriptor_heap **vkd3d_descriptor_handle_leaves[VKD3D_DESCRIPTOR_HANDLE_LEAF_COUNT];
+
+/* Ranges are rounded up to a power of two pages, and released ranges are kept on a free list
+ * per order, so reserving and releasing handles are O(1). Handle space is only taken from
+ * the top when no released range of the right order exists. */
+#define VKD3D_DESCRIPTOR_HANDLE_ORDER_COUNT (VKD3D_DESCRIPTOR_HANDLE_SPACE_BITS - VKD3D_DESCRIPTOR_HANDLE_PAGE_BITS + 1)
+
+struct vkd3d_descriptor_handle_free_list
+{
+    uint32_t *first_pages;
+    size_t first_pages_size;
+    size_t first_pages_count;
+};
+
+static struct vkd3d_descriptor_handle_free_list vkd3d_descriptor_handle_free_lists[VKD3D_DESCRIPTOR_HANDLE_ORDER_COUNT];
+/* Page 0 is never handed out so that no handle is ever 0. */
+static uint32_t vkd3d_descriptor_handle_next_page = 1;
+static pthread_mutex_t vkd3d_descriptor_handle_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int d3d12_descriptor_heap_get_handle_order(const struct d3d12_descriptor_heap *heap)
+{
+    uint32_t page_count;
+
+    /* Even empty heaps need a unique start handle. */
+    page_count = max(1u, DIV_ROUND_UP(heap->desc.NumDescriptors,
+            1u << (VKD3D_DESCRIPTOR_HANDLE_PAGE_BITS - VKD3D_RESOURCE_DESC_INCREMENT_LOG2)));
+    return page_count == 1 ? 0 : vkd3d_log2i(page_count - 1) + 1;
+}
+
+static bool vkd3d_descriptor_handle_map_pages(uint32_t first_page, uint32_t page_count,
+        struct d3d12_descriptor_heap *heap)
+{
+    const uint32_t leaf_mask = (1u << VKD3D_DESCRIPTOR_HANDLE_LEAF_BITS) - 1;
+    struct d3d12_descriptor_heap ***leaf;
+    uint32_t page;
+
+    for (page = first_page; page < first_page + page_count; page++)
+    {
+        leaf = &vkd3d_descriptor_handle_leaves[page >> VKD3D_DESCRIPTOR_HANDLE_LEAF_BITS];
+
+        /* Leaves are never freed, so lookups never need to take the lock. */
+        if (!*leaf && !(*leaf = vkd3d_calloc(leaf_mask + 1, sizeof(**leaf))))
+            return false;
+
+        (*leaf)[page & leaf_mask] = heap;
+    }
+
+    return true;
+}
+
+static bool d3d12_descriptor_heap_reserve_handles(struct d3d12_descriptor_heap *heap)
+{
+    struct vkd3d_descriptor_handle_free_list *free_list;
+    uint32_t page_count, first_page;
+    unsigned int order;
+
+    if ((order = d3d12_descriptor_heap_get_handle_order(heap)) >= VKD3D_DESCRIPTOR_HANDLE_ORDER_COUNT)
+        return false;
+
+    page_count = 1u << order;
+    free_list = &vkd3d_descriptor_handle_free_lists[order];
+
+    pthread_mutex_lock(&vkd3d_descriptor_handle_mutex);
+
+    /* Make sure a failed mapping can always be put back on the free list. */
+    if (!vkd3d_array_reserve((void **)&free_list->first_pages, &free_list->first_pages_size,
+            free_list->first_pages_count + 1, sizeof(*free_list->first_pages)))
+    {
+        pthread_mutex_unlock(&vkd3d_descriptor_handle_mutex);
+        return false;
+    }
+
+    if (free_list->first_pages_count)
+    {
+        first_page = free_list->first_pages[--free_list->first_pages_count];
+    }
+    else if (page_count <= VKD3D_DESCRIPTOR_HANDLE_PAGE_COUNT - vkd3d_descriptor_handle_next_page)
+    {
+        first_page = vkd3d_descriptor_handle_next_page;
+        vkd3d_descriptor_handle_next_page += page_count;
+    }
+    else
+    {
+        pthread_mutex_unlock(&vkd3d_descriptor_handle_mutex);
+        return false;
+    }
+
+    if (!vkd3d_descriptor_handle_map_pages(first_page, page_count, heap))
+    {
+        /* Pages which did get mapped are reset when the range is reused. */
+        free_list->first_pages[free_list->first_pages_count++] = first_page;
+        pthread_mutex_unlock(&vkd3d_descriptor_handle_mutex);
+        return false;
+    }
+
+    pthread_mutex_unlock(&vkd3d_descriptor_handle_mutex);
+
+    heap->cpu_handle_base = (SIZE_T)first_page << VKD3D_DESCRIPTOR_HANDLE_PAGE_BITS;
+    return true;
+}
+
+static void d3d12_descriptor_heap_release_handles(struct d3d12_descriptor_heap *heap)
+{
+    struct vkd3d_descriptor_handle_free_list *free_list;
+    uint32_t page_count, first_page;
+    unsigned int order;
+
+    if (!heap->cpu_handle_base)
+        return;
+
+    order = d3d12_descriptor_heap_get_handle_order(heap);
+    page_count = 1u << order;
+    first_page = heap->cpu_handle_base >> VKD3D_DESCRIPTOR_HANDLE_PAGE_BITS;
+    free_list = &vkd3d_descriptor_handle_free_lists[order];
+
+    pthread_mutex_lock(&vkd3d_descriptor_handle_mutex);
+
+    /* Clear the mapping so that stale handles trip the asserts in debug builds.
+     * The leaves already exist, so this cannot fail. */
+    vkd3d_descriptor_handle_map_pages(first_page, page_count, NULL);
+
+    if (vkd3d_array_reserve((void **)&free_list->first_pages, &free_list->first_pages_size,
+            free_list->first_pages_count + 1, sizeof(*free_list->first_pages)))
+        free_list->first_pages[free_list->first_pages_count++] = first_page;
+    else
+        ERR("Failed to recycle handle range, leaking %u pages.\n", page_count);
+
+    pthread_mutex_unlock(&vkd3d_descriptor_handle_mutex);
+}
+
 static HRESULT d3d12_descriptor_heap_init(struct d3d12_descriptor_heap *descriptor_heap,
         struct d3d12_device *device, const D3D12_DESCRIPTOR_HEAP_DESC *desc)
 {
+    bool host_only;
     unsigned int i;
     HRESULT hr;
 
@@ -5456,20 +5896,43 @@ static HRESULT d3d12_descriptor_heap_init(struct d3d12_descriptor_heap *descript
     if (desc->Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE)
         descriptor_heap->gpu_va = d3d12_device_get_descriptor_heap_gpu_va(device);
 
-    if (FAILED(hr = d3d12_descriptor_heap_create_descriptor_pool(descriptor_heap,
-            &descriptor_heap->vk_descriptor_pool)))
-        goto fail;
-
     if (desc->Type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV ||
             desc->Type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER)
     {
+        host_only = d3d12_descriptor_heap_is_host_only(descriptor_heap);
+
+        /* Zeroed memory is a valid null descriptor, so we never have to walk the arrays here. */
+        if (desc->NumDescriptors && (!(descriptor_heap->descriptor_metadata = vkd3d_calloc_tagged(desc->NumDescriptors,
+                sizeof(*descriptor_heap->descriptor_metadata), VKD3D_MEMORY_TAG_DESCRIPTOR)) ||
+                !(descriptor_heap->descriptor_info = vkd3d_calloc_tagged(desc->NumDescriptors,
+                sizeof(*descriptor_heap->descriptor_info), VKD3D_MEMORY_TAG_DESCRIPTOR)) ||
+                !(descriptor_heap->descriptor_null_types = vkd3d_calloc_tagged(desc->NumDescriptors,
+                sizeof(*descriptor_heap->descriptor_null_types), VKD3D_MEMORY_TAG_DESCRIPTOR))))
+        {
+            hr = E_OUTOFMEMORY;
+            goto fail;
+        }
+
+        if (host_only)
+        {
+            if (desc->NumDescriptors && !(descriptor_heap->host_descriptors = vkd3d_calloc_tagged(desc->NumDescriptors,
+                    sizeof(*descriptor_heap->host_descriptors), VKD3D_MEMORY_TAG_DESCRIPTOR)))
+            {
+                hr = E_OUTOFMEMORY;
+                goto fail;
+            }
+        }
+        else if (FAILED(hr = d3d12_descriptor_heap_create_descriptor_pool(descriptor_heap,
+                &descriptor_heap->vk_descriptor_pool)))
+            goto fail;
+
         for (i = 0; i < device->bindless_state.set_count; i++)
         {
             const struct vkd3d_bindless_set_info *set_info = &device->bindless_state.set_info[i];
 
             if (set_info->heap_type == desc->Type)
             {
-                if (FAILED(hr = d3d12_descriptor_heap_create_descriptor_set(descriptor_heap,
+                if (!host_only && FAILED(hr = d3d12_descriptor_heap_create_descriptor_set(descriptor_heap,
                         set_info, &descriptor_heap->vk_descriptor_sets[set_info->set_index])))
                     goto fail;
 
@@ -5485,6 +5948,14 @@ static HRESULT d3d12_descriptor_heap_init(struct d3d12_descriptor_heap *descript
     if (desc->Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE)
         d3d12_descriptor_heap_update_extra_bindings(descriptor_heap, device);
 
+    if (desc->Type != D3D12_DESCRIPTOR_HEAP_TYPE_RTV && desc->Type != D3D12_DESCRIPTOR_HEAP_TYPE_DSV &&
+            !d3d12_descriptor_heap_reserve_handles(descriptor_heap))
+    {
+        WARN("Failed to reserve handle space for %u descriptors.\n", desc->NumDescriptors);
+        hr = E_OUTOFMEMORY;
+        goto fail;
+    }
+
     if (FAILED(hr = vkd3d_private_store_init(&descriptor_heap->private_store)))
         goto fail;
 
@@ -5499,29 +5970,17 @@ fail:
 static void d3d12_descriptor_heap_init_descriptors(struct d3d12_descriptor_heap *descriptor_heap,
         size_t descriptor_size)
 {
-    struct d3d12_desc *desc;
-    unsigned int i;
-
-    memset(descriptor_heap->descriptors, 0, descriptor_size * descriptor_heap->desc.NumDescriptors);
-
     switch (descriptor_heap->desc.Type)
     {
         case D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV:
         case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER:
-            desc = (struct d3d12_desc *)descriptor_heap->descriptors;
-
-            for (i = 0; i < descriptor_heap->desc.NumDescriptors; i++)
-            {
-                desc[i].heap = descriptor_heap;
-                desc[i].heap_offset = i;
-                /* If we begin copying from the descriptors right away, we should copy the null descriptors
-                 * which are already initialized. */
-                desc[i].metadata.set_info_mask = descriptor_heap->null_descriptor_template.set_info_mask;
-            }
+            /* Descriptor state lives in zero-initialized arrays allocated by the heap,
+             * and heap and offset are decoded from the handle itself. */
             break;
 
         case D3D12_DESCRIPTOR_HEAP_TYPE_RTV:
         case D3D12_DESCRIPTOR_HEAP_TYPE_DSV:
+            memset(descriptor_heap->descriptors, 0, descriptor_size * descriptor_heap->desc.NumDescriptors);
             break;
 
         default:
@@ -5532,7 +5991,7 @@ static void d3d12_descriptor_heap_init_descriptors(struct d3d12_descriptor_heap
 HRESULT d3d12_descriptor_heap_create(struct d3d12_device *device,
         const D3D12_DESCRIPTOR_HEAP_DESC *desc, struct d3d12_descriptor_heap **descriptor_heap)
 {
-    size_t max_descriptor_count, descriptor_size;
+    size_t max_descriptor_count, descriptor_size, alloc_size;
     struct d3d12_descriptor_heap *object;
     HRESULT hr;
 
@@ -5556,8 +6015,12 @@ HRESULT d3d12_descriptor_heap_create(struct d3d12_device *device,
         return E_OUTOFMEMORY;
     }
 
-    if (!(object = vkd3d_malloc_aligned(offsetof(struct d3d12_descriptor_heap,
-            descriptors[descriptor_size * desc->NumDescriptors]), D3D12_DESC_ALIGNMENT)))
+    if (desc->Type == D3D12_DESCRIPTOR_HEAP_TYPE_RTV || desc->Type == D3D12_DESCRIPTOR_HEAP_TYPE_DSV)
+        alloc_size = offsetof(struct d3d12_descriptor_heap, descriptors[descriptor_size * desc->NumDescriptors]);
+    else
+        alloc_size = sizeof(*object);
+
+    if (!(object = vkd3d_allocate(alloc_size, D3D12_DESC_ALIGNMENT, false, VKD3D_MEMORY_TAG_DESCRIPTOR)))
         return E_OUTOFMEMORY;
 
     if (FAILED(hr = d3d12_descriptor_heap_init(object, device, desc)))
@@ -5584,6 +6047,9 @@ void d3d12_descriptor_heap_cleanup(struct d3d12_descriptor_heap *descriptor_heap
 {
     const struct vkd3d_vk_device_procs *vk_procs = &descriptor_heap->device->vk_procs;
     struct d3d12_device *device = descriptor_heap->device;
+    uint32_t i;
+
+    d3d12_descriptor_heap_release_handles(descriptor_heap);
 
     if (!descriptor_heap->device_allocation.vk_memory)
         vkd3d_free(descriptor_heap->host_memory);
@@ -5591,10 +6057,20 @@ void d3d12_descriptor_heap_cleanup(struct d3d12_descriptor_heap *descriptor_heap
     if (descriptor_heap->gpu_va != 0)
         d3d12_device_return_descriptor_heap_gpu_va(device, descriptor_heap->gpu_va);
 
-    VK_CALL(vkDestroyBuffer(device->vk_device, descriptor_heap->vk_buffer, NULL));
+    VK_CALL(vkDestroyBuffer(device->vk_device, descriptor_heap->vk_buffer, &vkd3d_vk_allocator));
     vkd3d_free_device_memory(device, &descriptor_heap->device_allocation);
 
-    VK_CALL(vkDestroyDescriptorPool(device->vk_device, descriptor_heap->vk_descriptor_pool, NULL));
+    VK_CALL(vkDestroyDescriptorPool(device->vk_device, descriptor_heap->vk_descriptor_pool, &vkd3d_vk_allocator));
+    vkd3d_free(descriptor_heap->descriptor_metadata);
+    vkd3d_free(descriptor_heap->descriptor_info);
+    vkd3d_free(descriptor_heap->descriptor_null_types);
+
+    if (descriptor_heap->host_descriptors)
+    {
+        for (i = 0; i < descriptor_heap->desc.NumDescriptors; i++)
+            vkd3d_free(descriptor_heap->host_descriptors[i].extra_writes);
+        vkd3d_free(descriptor_heap->host_descriptors);
+    }
 
     vkd3d_descriptor_debug_unregister_heap(descriptor_heap->cookie);
 }
@@ -5660,8 +6136,8 @@ static ULONG STDMETHODCALLTYPE d3d12_query_heap_Release(ID3D12QueryHeap *iface)
 
         vkd3d_private_store_destroy(&heap->private_store);
 
-        VK_CALL(vkDestroyQueryPool(device->vk_device, heap->vk_query_pool, NULL));
-        VK_CALL(vkDestroyBuffer(device->vk_device, heap->vk_buffer, NULL));
+        VK_CALL(vkDestroyQueryPool(device->vk_device, heap->vk_query_pool, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyBuffer(device->vk_device, heap->vk_buffer, &vkd3d_vk_allocator));
         vkd3d_free_device_memory(device, &heap->device_allocation);
 
         vkd3d_free(heap);
@@ -5783,7 +6259,7 @@ HRESULT d3d12_query_heap_create(struct d3d12_device *device, const D3D12_QUERY_H
                 return E_INVALIDARG;
         }
 
-        if ((vr = VK_CALL(vkCreateQueryPool(device->vk_device, &pool_info, NULL, &object->vk_query_pool))) < 0)
+        if ((vr = VK_CALL(vkCreateQueryPool(device->vk_device, &pool_info, &vkd3d_vk_allocator, &object->vk_query_pool))) < 0)
         {
             WARN("Failed to create Vulkan query pool, vr %d.\n", vr);
             vkd3d_free(object);
@@ -5817,7 +6293,7 @@ HRESULT d3d12_query_heap_create(struct d3d12_device *device, const D3D12_QUERY_H
         if (FAILED(hr = vkd3d_allocate_buffer_memory(device, object->vk_buffer,
                 VK_MEMORY_HEAP_DEVICE_LOCAL_BIT, &object->device_allocation)))
         {
-            VK_CALL(vkDestroyBuffer(device->vk_device, object->vk_buffer, NULL));
+            VK_CALL(vkDestroyBuffer(device->vk_device, object->vk_buffer, &vkd3d_vk_allocator));
             vkd3d_free(object);
             return hr;
         }
@@ -6057,14 +6533,14 @@ HRESULT vkd3d_memory_info_init(struct vkd3d_memory_info *info,
                 VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
     }
 
-    if ((vr = VK_CALL(vkCreateBuffer(device->vk_device, &buffer_info, NULL, &buffer))) < 0)
+    if ((vr = VK_CALL(vkCreateBuffer(device->vk_device, &buffer_info, &vkd3d_vk_allocator, &buffer))) < 0)
     {
         ERR("Failed to create dummy buffer");
         return hresult_from_vk_result(vr);
     }
 
     VK_CALL(vkGetBufferMemoryRequirements(device->vk_device, buffer, &memory_requirements));
-    VK_CALL(vkDestroyBuffer(device->vk_device, buffer, NULL));
+    VK_CALL(vkDestroyBuffer(device->vk_device, buffer, &vkd3d_vk_allocator));
     buffer_type_mask = memory_requirements.memoryTypeBits;
 
     memset(&image_info, 0, sizeof(image_info));
@@ -6085,14 +6561,14 @@ HRESULT vkd3d_memory_info_init(struct vkd3d_memory_info *info,
     image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-    if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, NULL, &image))) < 0)
+    if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, &vkd3d_vk_allocator, &image))) < 0)
     {
         ERR("Failed to create dummy sampled image");
         return hresult_from_vk_result(vr);
     }
 
     VK_CALL(vkGetImageMemoryRequirements(device->vk_device, image, &memory_requirements));
-    VK_CALL(vkDestroyImage(device->vk_device, image, NULL));
+    VK_CALL(vkDestroyImage(device->vk_device, image, &vkd3d_vk_allocator));
     sampled_type_mask = memory_requirements.memoryTypeBits;
 
     /* CPU accessible images are always LINEAR.
@@ -6108,10 +6584,10 @@ HRESULT vkd3d_memory_info_init(struct vkd3d_memory_info *info,
     sampled_type_mask_cpu = 0;
     if (vkd3d_is_linear_tiling_supported(device, &image_info))
     {
-        if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, NULL, &image))) == VK_SUCCESS)
+        if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, &vkd3d_vk_allocator, &image))) == VK_SUCCESS)
         {
             VK_CALL(vkGetImageMemoryRequirements(device->vk_device, image, &memory_requirements));
-            VK_CALL(vkDestroyImage(device->vk_device, image, NULL));
+            VK_CALL(vkDestroyImage(device->vk_device, image, &vkd3d_vk_allocator));
             sampled_type_mask_cpu = memory_requirements.memoryTypeBits;
         }
     }
@@ -6125,14 +6601,14 @@ HRESULT vkd3d_memory_info_init(struct vkd3d_memory_info *info,
             VK_IMAGE_USAGE_SAMPLED_BIT |
             VK_IMAGE_USAGE_STORAGE_BIT;
 
-    if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, NULL, &image))) < 0)
+    if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, &vkd3d_vk_allocator, &image))) < 0)
     {
         ERR("Failed to create dummy color image");
         return hresult_from_vk_result(vr);
     }
 
     VK_CALL(vkGetImageMemoryRequirements(device->vk_device, image, &memory_requirements));
-    VK_CALL(vkDestroyImage(device->vk_device, image, NULL));
+    VK_CALL(vkDestroyImage(device->vk_device, image, &vkd3d_vk_allocator));
     rt_ds_type_mask = memory_requirements.memoryTypeBits;
 
     image_info.tiling = VK_IMAGE_TILING_LINEAR;
@@ -6140,10 +6616,10 @@ HRESULT vkd3d_memory_info_init(struct vkd3d_memory_info *info,
     rt_ds_type_mask_cpu = 0;
     if (vkd3d_is_linear_tiling_supported(device, &image_info))
     {
-        if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, NULL, &image))) == VK_SUCCESS)
+        if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, &vkd3d_vk_allocator, &image))) == VK_SUCCESS)
         {
             VK_CALL(vkGetImageMemoryRequirements(device->vk_device, image, &memory_requirements));
-            VK_CALL(vkDestroyImage(device->vk_device, image, NULL));
+            VK_CALL(vkDestroyImage(device->vk_device, image, &vkd3d_vk_allocator));
             rt_ds_type_mask_cpu = memory_requirements.memoryTypeBits;
         }
     }
@@ -6156,14 +6632,14 @@ HRESULT vkd3d_memory_info_init(struct vkd3d_memory_info *info,
             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
             VK_IMAGE_USAGE_SAMPLED_BIT;
 
-    if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, NULL, &image))) < 0)
+    if ((vr = VK_CALL(vkCreateImage(device->vk_device, &image_info, &vkd3d_vk_allocator, &image))) < 0)
     {
         ERR("Failed to create dummy depth-stencil image");
         return hresult_from_vk_result(vr);
     }
 
     VK_CALL(vkGetImageMemoryRequirements(device->vk_device, image, &memory_requirements));
-    VK_CALL(vkDestroyImage(device->vk_device, image, NULL));
+    VK_CALL(vkDestroyImage(device->vk_device, image, &vkd3d_vk_allocator));
     rt_ds_type_mask &= memory_requirements.memoryTypeBits;
 
     /* Unsure if we can have host visible depth-stencil.
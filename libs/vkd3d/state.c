@@ -18,6 +18,7 @@
  */
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
+#define VKD3D_MEMORY_TAG VKD3D_MEMORY_TAG_PIPELINE
 
 #include "vkd3d_private.h"
 #include "vkd3d_descriptor_debug.h"
@@ -64,11 +65,11 @@ static void d3d12_root_signature_cleanup(struct d3d12_root_signature *root_signa
     vkd3d_sampler_state_free_descriptor_set(&device->sampler_state, device,
             root_signature->vk_sampler_set, root_signature->vk_sampler_pool);
 
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, root_signature->graphics.vk_pipeline_layout, NULL));
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, root_signature->compute.vk_pipeline_layout, NULL));
-    VK_CALL(vkDestroyPipelineLayout(device->vk_device, root_signature->raygen.vk_pipeline_layout, NULL));
-    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, root_signature->vk_sampler_descriptor_layout, NULL));
-    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, root_signature->vk_root_descriptor_layout, NULL));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, root_signature->graphics.vk_pipeline_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, root_signature->compute.vk_pipeline_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyPipelineLayout(device->vk_device, root_signature->raygen.vk_pipeline_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, root_signature->vk_sampler_descriptor_layout, &vkd3d_vk_allocator));
+    VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, root_signature->vk_root_descriptor_layout, &vkd3d_vk_allocator));
 
     vkd3d_free(root_signature->parameters);
     vkd3d_free(root_signature->bindings);
@@ -169,6 +170,10 @@ VkShaderStageFlags vkd3d_vk_stage_flags_from_visibility(D3D12_SHADER_VISIBILITY
             return VK_SHADER_STAGE_GEOMETRY_BIT;
         case D3D12_SHADER_VISIBILITY_PIXEL:
             return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case D3D12_SHADER_VISIBILITY_AMPLIFICATION:
+            return VK_SHADER_STAGE_TASK_BIT_EXT;
+        case D3D12_SHADER_VISIBILITY_MESH:
+            return VK_SHADER_STAGE_MESH_BIT_EXT;
         default:
             return 0;
     }
@@ -190,6 +195,10 @@ enum vkd3d_shader_visibility vkd3d_shader_visibility_from_d3d12(D3D12_SHADER_VIS
             return VKD3D_SHADER_VISIBILITY_GEOMETRY;
         case D3D12_SHADER_VISIBILITY_PIXEL:
             return VKD3D_SHADER_VISIBILITY_PIXEL;
+        case D3D12_SHADER_VISIBILITY_AMPLIFICATION:
+            return VKD3D_SHADER_VISIBILITY_AMPLIFICATION;
+        case D3D12_SHADER_VISIBILITY_MESH:
+            return VKD3D_SHADER_VISIBILITY_MESH;
         default:
             FIXME("Unhandled visibility %#x.\n", visibility);
             return VKD3D_SHADER_VISIBILITY_ALL;
@@ -265,7 +274,7 @@ HRESULT vkd3d_create_descriptor_set_layout(struct d3d12_device *device,
     set_desc.bindingCount = binding_count;
     set_desc.pBindings = bindings;
 
-    if ((vr = VK_CALL(vkCreateDescriptorSetLayout(device->vk_device, &set_desc, NULL, set_layout))) < 0)
+    if ((vr = VK_CALL(vkCreateDescriptorSetLayout(device->vk_device, &set_desc, &vkd3d_vk_allocator, set_layout))) < 0)
     {
         WARN("Failed to create Vulkan descriptor set layout, vr %d.\n", vr);
         return hresult_from_vk_result(vr);
@@ -298,7 +307,7 @@ HRESULT vkd3d_create_pipeline_layout(struct d3d12_device *device,
     pipeline_layout_info.pushConstantRangeCount = push_constant_count;
     pipeline_layout_info.pPushConstantRanges = push_constants;
     if ((vr = VK_CALL(vkCreatePipelineLayout(device->vk_device,
-            &pipeline_layout_info, NULL, pipeline_layout))) < 0)
+            &pipeline_layout_info, &vkd3d_vk_allocator, pipeline_layout))) < 0)
     {
         WARN("Failed to create Vulkan pipeline layout, vr %d.\n", vr);
         return hresult_from_vk_result(vr);
@@ -1014,7 +1023,7 @@ static HRESULT d3d12_root_signature_init_static_samplers(struct d3d12_root_signa
     if (!desc->NumStaticSamplers)
         return S_OK;
 
-    if (!(vk_binding_info = malloc(desc->NumStaticSamplers * sizeof(*vk_binding_info))))
+    if (!(vk_binding_info = vkd3d_malloc(desc->NumStaticSamplers * sizeof(*vk_binding_info))))
         return E_OUTOFMEMORY;
 
     for (i = 0; i < desc->NumStaticSamplers; ++i)
@@ -1132,6 +1141,7 @@ static HRESULT d3d12_root_signature_init_global(struct d3d12_root_signature *roo
     const struct vkd3d_bindless_state *bindless_state = &device->bindless_state;
     struct vkd3d_descriptor_set_context context;
     struct d3d12_root_signature_info info;
+    VkShaderStageFlags graphics_stages;
     unsigned int i;
     HRESULT hr;
 
@@ -1240,14 +1250,19 @@ static HRESULT d3d12_root_signature_init_global(struct d3d12_root_signature *roo
      * In set_root_signature we can bind the appropriate layout as well.
      *
      * For graphics we can generally rely on visibility mask, but not so for compute and raygen,
-     * since they use ALL visibility. */
+     * since they use ALL visibility.
+     * Mesh pipelines share the graphics layout, so task and mesh stages are part of its mask. */
 
     root_signature->num_set_layouts = context.vk_set;
 
+    graphics_stages = VK_SHADER_STAGE_ALL_GRAPHICS;
+    if (device->device_info.mesh_shader_features.meshShader && device->device_info.mesh_shader_features.taskShader)
+        graphics_stages |= VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+
     if (FAILED(hr = vkd3d_create_pipeline_layout_for_stage_mask(
             device, root_signature->num_set_layouts, root_signature->set_layouts,
             &root_signature->push_constant_range,
-            VK_SHADER_STAGE_ALL_GRAPHICS, &root_signature->graphics)))
+            graphics_stages, &root_signature->graphics)))
         return hr;
 
     if (FAILED(hr = vkd3d_create_pipeline_layout_for_stage_mask(
@@ -1339,6 +1354,34 @@ fail:
     return hr;
 }
 
+#define VKD3D_FINGERPRINT_SEED 0xcbf29ce484222325ull
+
+static vkd3d_shader_hash_t vkd3d_fingerprint_data(vkd3d_shader_hash_t h, const void *data, size_t size)
+{
+    const uint8_t *bytes = data;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+        h = (h * 0x100000001b3ull) ^ bytes[i];
+
+    return h;
+}
+
+static vkd3d_shader_hash_t vkd3d_fingerprint_u32(vkd3d_shader_hash_t h, uint32_t value)
+{
+    return vkd3d_fingerprint_data(h, &value, sizeof(value));
+}
+
+static vkd3d_shader_hash_t vkd3d_fingerprint_u64(vkd3d_shader_hash_t h, uint64_t value)
+{
+    return vkd3d_fingerprint_data(h, &value, sizeof(value));
+}
+
+static vkd3d_shader_hash_t vkd3d_fingerprint_string(vkd3d_shader_hash_t h, const char *str)
+{
+    return str ? vkd3d_fingerprint_data(h, str, strlen(str) + 1) : vkd3d_fingerprint_u32(h, 0);
+}
+
 HRESULT d3d12_root_signature_create(struct d3d12_device *device,
         const void *bytecode, size_t bytecode_length, struct d3d12_root_signature **root_signature)
 {
@@ -1372,6 +1415,8 @@ HRESULT d3d12_root_signature_create(struct d3d12_device *device,
         return hr;
     }
 
+    object->compatibility_hash = vkd3d_fingerprint_data(VKD3D_FINGERPRINT_SEED, bytecode, bytecode_length);
+
     TRACE("Created root signature %p.\n", object);
 
     *root_signature = object;
@@ -1407,8 +1452,15 @@ struct vkd3d_render_pass_entry
     VkRenderPass vk_render_pass;
 };
 
-/* Ensure that key is packed, and can be memcmp'd. */
-STATIC_ASSERT(sizeof(struct vkd3d_render_pass_key) == 52);
+struct vkd3d_clear_render_pass_entry
+{
+    struct vkd3d_clear_render_pass_key key;
+    VkRenderPass vk_render_pass;
+};
+
+/* Ensure that keys are packed, and can be memcmp'd. */
+STATIC_ASSERT(sizeof(struct vkd3d_render_pass_key) == 60);
+STATIC_ASSERT(sizeof(struct vkd3d_clear_render_pass_key) == 44);
 
 static VkImageLayout vkd3d_render_pass_get_depth_stencil_layout(const struct vkd3d_render_pass_key *key)
 {
@@ -1425,6 +1477,16 @@ static VkImageLayout vkd3d_render_pass_get_depth_stencil_layout(const struct vkd
         return VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 }
 
+static VkAttachmentLoadOp vkd3d_render_pass_get_load_op(uint32_t flags, uint32_t clear_flag, uint32_t discard_flag)
+{
+    if (flags & clear_flag)
+        return VK_ATTACHMENT_LOAD_OP_CLEAR;
+    else if (flags & discard_flag)
+        return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    else
+        return VK_ATTACHMENT_LOAD_OP_LOAD;
+}
+
 static HRESULT vkd3d_render_pass_cache_create_pass_locked(struct vkd3d_render_pass_cache *cache,
         struct d3d12_device *device, const struct vkd3d_render_pass_key *key, VkRenderPass *vk_render_pass)
 {
@@ -1476,7 +1538,12 @@ static HRESULT vkd3d_render_pass_cache_create_pass_locked(struct vkd3d_render_pa
         attachments[attachment_index].flags = 0;
         attachments[attachment_index].format = key->vk_formats[index];
         attachments[attachment_index].samples = key->sample_count;
-        attachments[attachment_index].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        if (key->rtv_clear_mask & (1u << index))
+            attachments[attachment_index].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        else if (key->rtv_discard_mask & (1u << index))
+            attachments[attachment_index].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        else
+            attachments[attachment_index].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
         attachments[attachment_index].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         attachments[attachment_index].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         attachments[attachment_index].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
@@ -1502,9 +1569,11 @@ static HRESULT vkd3d_render_pass_cache_create_pass_locked(struct vkd3d_render_pa
         attachments[attachment_index].flags = 0;
         attachments[attachment_index].format = key->vk_formats[index];
         attachments[attachment_index].samples = key->sample_count;
-        attachments[attachment_index].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        attachments[attachment_index].loadOp = vkd3d_render_pass_get_load_op(key->flags,
+                VKD3D_RENDER_PASS_KEY_DEPTH_CLEAR, VKD3D_RENDER_PASS_KEY_DEPTH_DISCARD);
         attachments[attachment_index].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        attachments[attachment_index].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        attachments[attachment_index].stencilLoadOp = vkd3d_render_pass_get_load_op(key->flags,
+                VKD3D_RENDER_PASS_KEY_STENCIL_CLEAR, VKD3D_RENDER_PASS_KEY_STENCIL_DISCARD);
         attachments[attachment_index].stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
         attachments[attachment_index].initialLayout = depth_layout;
         attachments[attachment_index].finalLayout = depth_layout;
@@ -1616,7 +1685,7 @@ static HRESULT vkd3d_render_pass_cache_create_pass_locked(struct vkd3d_render_pa
     pass_info.correlatedViewMaskCount = 0;
     pass_info.pCorrelatedViewMasks = NULL;
 
-    if ((vr = VK_CALL(vkCreateRenderPass2KHR(device->vk_device, &pass_info, NULL, vk_render_pass))) >= 0)
+    if ((vr = VK_CALL(vkCreateRenderPass2KHR(device->vk_device, &pass_info, &vkd3d_vk_allocator, vk_render_pass))) >= 0)
     {
         entry->vk_render_pass = *vk_render_pass;
         ++cache->render_pass_count;
@@ -1676,11 +1745,274 @@ HRESULT vkd3d_render_pass_cache_find(struct vkd3d_render_pass_cache *cache,
     return hr;
 }
 
+HRESULT vkd3d_render_pass_cache_find_clear_variant(struct vkd3d_render_pass_cache *cache,
+        struct d3d12_device *device, VkRenderPass vk_base_render_pass, uint32_t *rtv_clear_mask,
+        uint32_t *rtv_discard_mask, uint32_t *ds_load_flags, VkRenderPass *vk_render_pass)
+{
+    struct vkd3d_render_pass_key key;
+    unsigned int rt_count;
+    bool found = false;
+    size_t i;
+
+    rw_spinlock_acquire_read(&cache->lock);
+    for (i = 0; i < cache->render_pass_count; ++i)
+    {
+        struct vkd3d_render_pass_entry *current = &cache->render_passes[i];
+
+        if (current->vk_render_pass == vk_base_render_pass)
+        {
+            key = current->key;
+            found = true;
+            break;
+        }
+    }
+    rw_spinlock_release_read(&cache->lock);
+
+    if (!found)
+    {
+        *vk_render_pass = VK_NULL_HANDLE;
+        return E_INVALIDARG;
+    }
+
+    /* Only attachments which are actually part of the render pass can be cleared,
+     * report back which clears the caller still needs to perform by other means.
+     * Clears take precedence over discards of the same attachment. */
+    rt_count = (key.flags & VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_ENABLE) ?
+            key.attachment_count - 1 : key.attachment_count;
+    *rtv_clear_mask &= key.rtv_active_mask & ((1u << rt_count) - 1);
+    *rtv_discard_mask &= key.rtv_active_mask & ((1u << rt_count) - 1) & ~*rtv_clear_mask;
+
+    if (key.flags & VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_ENABLE)
+    {
+        *ds_load_flags &= VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_CLEAR | VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_DISCARD;
+        if (*ds_load_flags & VKD3D_RENDER_PASS_KEY_DEPTH_CLEAR)
+            *ds_load_flags &= ~VKD3D_RENDER_PASS_KEY_DEPTH_DISCARD;
+        if (*ds_load_flags & VKD3D_RENDER_PASS_KEY_STENCIL_CLEAR)
+            *ds_load_flags &= ~VKD3D_RENDER_PASS_KEY_STENCIL_DISCARD;
+    }
+    else
+    {
+        *ds_load_flags = 0;
+    }
+
+    if (!*rtv_clear_mask && !*rtv_discard_mask && !*ds_load_flags)
+    {
+        *vk_render_pass = vk_base_render_pass;
+        return S_OK;
+    }
+
+    key.rtv_clear_mask = *rtv_clear_mask;
+    key.rtv_discard_mask = *rtv_discard_mask;
+    key.flags |= *ds_load_flags;
+    return vkd3d_render_pass_cache_find(cache, device, &key, vk_render_pass);
+}
+
+static HRESULT vkd3d_render_pass_cache_create_clear_pass_locked(struct vkd3d_render_pass_cache *cache,
+        struct d3d12_device *device, const struct vkd3d_clear_render_pass_key *key, VkRenderPass *vk_render_pass)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    VkAttachmentDescriptionStencilLayout stencil_attachment_desc;
+    VkAttachmentReferenceStencilLayout stencil_attachment_ref;
+    struct vkd3d_clear_render_pass_entry *entry;
+    VkAttachmentDescription2KHR attachment_desc;
+    VkAttachmentReference2KHR attachment_ref;
+    VkSubpassDependency2KHR dependencies[2];
+    VkSubpassDescription2KHR subpass_desc;
+    VkRenderPassCreateInfo2KHR pass_info;
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+    bool clear_op;
+    VkResult vr;
+
+    if (!vkd3d_array_reserve((void **)&cache->clear_passes, &cache->clear_passes_size,
+            cache->clear_pass_count + 1, sizeof(*cache->clear_passes)))
+    {
+        *vk_render_pass = VK_NULL_HANDLE;
+        return E_OUTOFMEMORY;
+    }
+
+    entry = &cache->clear_passes[cache->clear_pass_count];
+    entry->key = *key;
+
+    clear_op = !!(key->flags & VKD3D_CLEAR_RENDER_PASS_KEY_CLEAR_OP);
+
+    attachment_desc.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2_KHR;
+    attachment_desc.pNext = NULL;
+    attachment_desc.flags = 0;
+    attachment_desc.format = key->vk_format;
+    attachment_desc.samples = key->sample_count;
+    attachment_desc.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachment_desc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment_desc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachment_desc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment_desc.initialLayout = key->initial_layout;
+    attachment_desc.finalLayout = key->final_layout;
+
+    if (clear_op)
+    {
+        if (key->clear_aspects & (VK_IMAGE_ASPECT_COLOR_BIT | VK_IMAGE_ASPECT_DEPTH_BIT))
+            attachment_desc.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+
+        if (key->clear_aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+            attachment_desc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    }
+
+    attachment_ref.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2_KHR;
+    attachment_ref.pNext = NULL;
+    attachment_ref.attachment = 0;
+    attachment_ref.layout = key->attachment_layout;
+    attachment_ref.aspectMask = 0; /* input attachment aspect mask */
+
+    if (key->flags & VKD3D_CLEAR_RENDER_PASS_KEY_SEPARATE_DS_LAYOUTS)
+    {
+        stencil_attachment_desc.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_STENCIL_LAYOUT;
+        stencil_attachment_desc.pNext = NULL;
+        stencil_attachment_desc.stencilInitialLayout = key->stencil_initial_layout;
+        stencil_attachment_desc.stencilFinalLayout = key->stencil_final_layout;
+        attachment_desc.pNext = &stencil_attachment_desc;
+
+        stencil_attachment_ref.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_STENCIL_LAYOUT;
+        stencil_attachment_ref.pNext = NULL;
+        stencil_attachment_ref.stencilLayout = key->stencil_attachment_layout;
+        attachment_ref.pNext = &stencil_attachment_ref;
+    }
+
+    subpass_desc.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2_KHR;
+    subpass_desc.pNext = NULL;
+    subpass_desc.flags = 0;
+    subpass_desc.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass_desc.viewMask = 0;
+    subpass_desc.inputAttachmentCount = 0;
+    subpass_desc.pInputAttachments = NULL;
+    subpass_desc.colorAttachmentCount = 0;
+    subpass_desc.pColorAttachments = NULL;
+    subpass_desc.pResolveAttachments = NULL;
+    subpass_desc.pDepthStencilAttachment = NULL;
+    subpass_desc.preserveAttachmentCount = 0;
+    subpass_desc.pPreserveAttachments = NULL;
+
+    if (key->clear_aspects & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+    {
+        stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        if (!clear_op || key->clear_aspects != key->format_aspects)
+            access |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+
+        subpass_desc.pDepthStencilAttachment = &attachment_ref;
+    }
+    else
+    {
+        stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        if (!clear_op)
+            access |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+
+        subpass_desc.colorAttachmentCount = 1;
+        subpass_desc.pColorAttachments = &attachment_ref;
+    }
+
+    dependencies[0].sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2_KHR;
+    dependencies[0].pNext = NULL;
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = stages;
+    dependencies[0].dstStageMask = stages;
+    dependencies[0].srcAccessMask = clear_op ? access : 0;
+    dependencies[0].dstAccessMask = access;
+    dependencies[0].dependencyFlags = 0;
+    dependencies[0].viewOffset = 0;
+
+    dependencies[1].sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2_KHR;
+    dependencies[1].pNext = NULL;
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = stages;
+    dependencies[1].dstStageMask = stages;
+    dependencies[1].srcAccessMask = access;
+    dependencies[1].dstAccessMask = 0;
+    dependencies[1].dependencyFlags = 0;
+    dependencies[1].viewOffset = 0;
+
+    pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2_KHR;
+    pass_info.pNext = NULL;
+    pass_info.flags = 0;
+    pass_info.attachmentCount = 1;
+    pass_info.pAttachments = &attachment_desc;
+    pass_info.subpassCount = 1;
+    pass_info.pSubpasses = &subpass_desc;
+    pass_info.dependencyCount = ARRAY_SIZE(dependencies);
+    pass_info.pDependencies = dependencies;
+    pass_info.correlatedViewMaskCount = 0;
+    pass_info.pCorrelatedViewMasks = NULL;
+
+    if ((vr = VK_CALL(vkCreateRenderPass2KHR(device->vk_device, &pass_info, &vkd3d_vk_allocator, vk_render_pass))) >= 0)
+    {
+        entry->vk_render_pass = *vk_render_pass;
+        ++cache->clear_pass_count;
+    }
+    else
+    {
+        WARN("Failed to create Vulkan render pass, vr %d.\n", vr);
+        *vk_render_pass = VK_NULL_HANDLE;
+    }
+
+    return hresult_from_vk_result(vr);
+}
+
+HRESULT vkd3d_render_pass_cache_find_clear_pass(struct vkd3d_render_pass_cache *cache,
+        struct d3d12_device *device, const struct vkd3d_clear_render_pass_key *key, VkRenderPass *vk_render_pass)
+{
+    size_t searched_count;
+    bool found = false;
+    HRESULT hr = S_OK;
+    size_t i;
+
+    rw_spinlock_acquire_read(&cache->lock);
+    for (i = 0; i < cache->clear_pass_count; ++i)
+    {
+        struct vkd3d_clear_render_pass_entry *current = &cache->clear_passes[i];
+
+        if (!memcmp(&current->key, key, sizeof(*key)))
+        {
+            *vk_render_pass = current->vk_render_pass;
+            found = true;
+            break;
+        }
+    }
+    searched_count = cache->clear_pass_count;
+    rw_spinlock_release_read(&cache->lock);
+
+    if (!found)
+    {
+        rw_spinlock_acquire_write(&cache->lock);
+        for (i = searched_count; i < cache->clear_pass_count; ++i)
+        {
+            struct vkd3d_clear_render_pass_entry *current = &cache->clear_passes[i];
+
+            if (!memcmp(&current->key, key, sizeof(*key)))
+            {
+                *vk_render_pass = current->vk_render_pass;
+                rw_spinlock_release_write(&cache->lock);
+                return S_OK;
+            }
+        }
+        hr = vkd3d_render_pass_cache_create_clear_pass_locked(cache, device, key, vk_render_pass);
+        rw_spinlock_release_write(&cache->lock);
+    }
+
+    return hr;
+}
+
 void vkd3d_render_pass_cache_init(struct vkd3d_render_pass_cache *cache)
 {
     cache->render_passes = NULL;
     cache->render_pass_count = 0;
     cache->render_passes_size = 0;
+    cache->clear_passes = NULL;
+    cache->clear_pass_count = 0;
+    cache->clear_passes_size = 0;
     cache->lock = 0;
 }
 
@@ -1693,11 +2025,19 @@ void vkd3d_render_pass_cache_cleanup(struct vkd3d_render_pass_cache *cache,
     for (i = 0; i < cache->render_pass_count; ++i)
     {
         struct vkd3d_render_pass_entry *current = &cache->render_passes[i];
-        VK_CALL(vkDestroyRenderPass(device->vk_device, current->vk_render_pass, NULL));
+        VK_CALL(vkDestroyRenderPass(device->vk_device, current->vk_render_pass, &vkd3d_vk_allocator));
+    }
+
+    for (i = 0; i < cache->clear_pass_count; ++i)
+    {
+        struct vkd3d_clear_render_pass_entry *current = &cache->clear_passes[i];
+        VK_CALL(vkDestroyRenderPass(device->vk_device, current->vk_render_pass, &vkd3d_vk_allocator));
     }
 
     vkd3d_free(cache->render_passes);
     cache->render_passes = NULL;
+    vkd3d_free(cache->clear_passes);
+    cache->clear_passes = NULL;
 }
 
 static void d3d12_promote_depth_stencil_desc(D3D12_DEPTH_STENCIL_DESC1 *out, const D3D12_DEPTH_STENCIL_DESC *in)
@@ -1812,8 +2152,8 @@ HRESULT vkd3d_pipeline_state_desc_from_d3d12_stream_desc(struct d3d12_pipeline_s
 {
     D3D12_PIPELINE_STATE_SUBOBJECT_TYPE subobject_type;
     const char *stream_ptr, *stream_end;
+    bool is_graphics, is_compute, has_vs, has_ms;
     uint64_t defined_subobjects = 0;
-    bool is_graphics, is_compute;
     uint64_t subobject_bit;
 
     /* Initialize defaults for undefined subobjects */
@@ -1869,6 +2209,8 @@ HRESULT vkd3d_pipeline_state_desc_from_d3d12_stream_desc(struct d3d12_pipeline_s
             VKD3D_HANDLE_SUBOBJECT(FLAGS, D3D12_PIPELINE_STATE_FLAGS, desc->flags);
             VKD3D_HANDLE_SUBOBJECT(DEPTH_STENCIL1, D3D12_DEPTH_STENCIL_DESC1, desc->depth_stencil_state);
             VKD3D_HANDLE_SUBOBJECT(VIEW_INSTANCING, D3D12_VIEW_INSTANCING_DESC, desc->view_instancing_desc);
+            VKD3D_HANDLE_SUBOBJECT(AS, D3D12_SHADER_BYTECODE, desc->as);
+            VKD3D_HANDLE_SUBOBJECT(MS, D3D12_SHADER_BYTECODE, desc->ms);
 
             default:
                 ERR("Unhandled pipeline subobject type %u.\n", subobject_type);
@@ -1877,7 +2219,9 @@ HRESULT vkd3d_pipeline_state_desc_from_d3d12_stream_desc(struct d3d12_pipeline_s
     }
 
     /* Deduce pipeline type from specified shaders */
-    is_graphics = desc->vs.pShaderBytecode && desc->vs.BytecodeLength;
+    has_vs = desc->vs.pShaderBytecode && desc->vs.BytecodeLength;
+    has_ms = desc->ms.pShaderBytecode && desc->ms.BytecodeLength;
+    is_graphics = has_vs || has_ms;
     is_compute = desc->cs.pShaderBytecode && desc->cs.BytecodeLength;
 
     if (is_graphics == is_compute)
@@ -1886,6 +2230,18 @@ HRESULT vkd3d_pipeline_state_desc_from_d3d12_stream_desc(struct d3d12_pipeline_s
         return E_INVALIDARG;
     }
 
+    if (has_ms && (has_vs || desc->hs.BytecodeLength || desc->ds.BytecodeLength || desc->gs.BytecodeLength))
+    {
+        ERR("Mesh shader pipelines cannot use legacy geometry stages.\n");
+        return E_INVALIDARG;
+    }
+
+    if (desc->as.BytecodeLength && !has_ms)
+    {
+        ERR("Amplification shader requires a mesh shader.\n");
+        return E_INVALIDARG;
+    }
+
     *vk_bind_point = is_graphics
         ? VK_PIPELINE_BIND_POINT_GRAPHICS
         : VK_PIPELINE_BIND_POINT_COMPUTE;
@@ -1947,17 +2303,17 @@ static void d3d12_pipeline_state_destroy_graphics(struct d3d12_pipeline_state *s
 
     for (i = 0; i < graphics->stage_count; ++i)
     {
-        VK_CALL(vkDestroyShaderModule(device->vk_device, graphics->stages[i].module, NULL));
+        VK_CALL(vkDestroyShaderModule(device->vk_device, graphics->stages[i].module, &vkd3d_vk_allocator));
     }
 
     LIST_FOR_EACH_ENTRY_SAFE(current, e, &graphics->compiled_fallback_pipelines, struct vkd3d_compiled_pipeline, entry)
     {
-        VK_CALL(vkDestroyPipeline(device->vk_device, current->vk_pipeline, NULL));
+        VK_CALL(vkDestroyPipeline(device->vk_device, current->vk_pipeline, &vkd3d_vk_allocator));
         vkd3d_free(current);
     }
 
     for (i = 0; i < VKD3D_GRAPHICS_PIPELINE_STATIC_VARIANT_COUNT; i++)
-        VK_CALL(vkDestroyPipeline(device->vk_device, graphics->pipeline[i], NULL));
+        VK_CALL(vkDestroyPipeline(device->vk_device, graphics->pipeline[i], &vkd3d_vk_allocator));
 }
 
 static void d3d12_pipeline_state_set_name(struct d3d12_pipeline_state *state, const char *name)
@@ -1969,6 +2325,14 @@ static void d3d12_pipeline_state_set_name(struct d3d12_pipeline_state *state, co
     }
 }
 
+static void d3d12_pipeline_state_free_stage_code(struct d3d12_pipeline_state *state)
+{
+    unsigned int i;
+
+    for (i = 0; i < state->stage_code_count; i++)
+        vkd3d_shader_free_shader_code(&state->stage_code[i].spirv);
+}
+
 static ULONG STDMETHODCALLTYPE d3d12_pipeline_state_Release(ID3D12PipelineState *iface)
 {
     struct d3d12_pipeline_state *state = impl_from_ID3D12PipelineState(iface);
@@ -1986,9 +2350,13 @@ static ULONG STDMETHODCALLTYPE d3d12_pipeline_state_Release(ID3D12PipelineState
         if (d3d12_pipeline_state_is_graphics(state))
             d3d12_pipeline_state_destroy_graphics(state, device);
         else if (d3d12_pipeline_state_is_compute(state))
-            VK_CALL(vkDestroyPipeline(device->vk_device, state->compute.vk_pipeline, NULL));
+        {
+            VK_CALL(vkDestroyPipeline(device->vk_device, state->compute.vk_pipeline, &vkd3d_vk_allocator));
+            VK_CALL(vkDestroyShaderModule(device->vk_device, state->compute.create_info.stage.module, &vkd3d_vk_allocator));
+        }
 
-        VK_CALL(vkDestroyPipelineCache(device->vk_device, state->vk_pso_cache, NULL));
+        vkd3d_free(state->vk_cache_data);
+        d3d12_pipeline_state_free_stage_code(state);
 
         if (state->private_root_signature)
             ID3D12RootSignature_Release(state->private_root_signature);
@@ -2058,7 +2426,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_pipeline_state_GetCachedBlob(ID3D12Pipeli
     if ((vr = vkd3d_serialize_pipeline_state(state, &cache_size, NULL)))
         return hresult_from_vk_result(vr);
 
-    if (!(cache_data = malloc(cache_size)))
+    if (!(cache_data = vkd3d_malloc(cache_size)))
         return E_OUTOFMEMORY;
 
     if ((vr = vkd3d_serialize_pipeline_state(state, &cache_size, cache_data)))
@@ -2095,19 +2463,125 @@ CONST_VTBL struct ID3D12PipelineStateVtbl d3d12_pipeline_state_vtbl =
     d3d12_pipeline_state_GetCachedBlob,
 };
 
+/* Covers all inputs to DXBC translation, so that SPIR-V from a cached blob
+ * is only reused if translating again would produce the same code. */
+static vkd3d_shader_hash_t vkd3d_pipeline_stage_fingerprint(vkd3d_shader_hash_t root_signature_hash,
+        VkShaderStageFlagBits stage, const D3D12_SHADER_BYTECODE *code,
+        const struct vkd3d_shader_interface_info *shader_interface,
+        const struct vkd3d_shader_compile_arguments *compile_args)
+{
+    const struct vkd3d_shader_transform_feedback_info *xfb_info = shader_interface->xfb_info;
+    const struct vkd3d_shader_quirk_info *quirks = compile_args->quirks;
+    const struct vkd3d_shader_transform_feedback_element *element;
+    const struct vkd3d_shader_parameter *parameter;
+    vkd3d_shader_hash_t h = VKD3D_FINGERPRINT_SEED;
+    unsigned int i;
+
+    h = vkd3d_fingerprint_data(h, code->pShaderBytecode, code->BytecodeLength);
+    h = vkd3d_fingerprint_u64(h, root_signature_hash);
+    h = vkd3d_fingerprint_u64(h, vkd3d_config_flags);
+    h = vkd3d_fingerprint_u32(h, stage);
+    h = vkd3d_fingerprint_u32(h, shader_interface->flags);
+    h = vkd3d_fingerprint_u32(h, shader_interface->min_ssbo_alignment);
+
+    h = vkd3d_fingerprint_u32(h, compile_args->target);
+    for (i = 0; i < compile_args->target_extension_count; i++)
+        h = vkd3d_fingerprint_u32(h, compile_args->target_extensions[i]);
+
+    for (i = 0; i < compile_args->parameter_count; i++)
+    {
+        parameter = &compile_args->parameters[i];
+        h = vkd3d_fingerprint_u32(h, parameter->name);
+        h = vkd3d_fingerprint_u32(h, parameter->type);
+        h = vkd3d_fingerprint_u32(h, parameter->data_type);
+        if (parameter->type == VKD3D_SHADER_PARAMETER_TYPE_IMMEDIATE_CONSTANT)
+            h = vkd3d_fingerprint_u32(h, parameter->immediate_constant.u32);
+        else
+            h = vkd3d_fingerprint_u32(h, parameter->specialization_constant.id);
+    }
+
+    h = vkd3d_fingerprint_u32(h, compile_args->dual_source_blending);
+    for (i = 0; i < compile_args->output_swizzle_count; i++)
+        h = vkd3d_fingerprint_u32(h, compile_args->output_swizzles[i]);
+
+    if (quirks)
+    {
+        h = vkd3d_fingerprint_u32(h, quirks->default_quirks);
+        for (i = 0; i < quirks->num_hashes; i++)
+        {
+            h = vkd3d_fingerprint_u64(h, quirks->hashes[i].shader_hash);
+            h = vkd3d_fingerprint_u32(h, quirks->hashes[i].quirks);
+        }
+    }
+
+    if (xfb_info)
+    {
+        for (i = 0; i < xfb_info->element_count; i++)
+        {
+            element = &xfb_info->elements[i];
+            h = vkd3d_fingerprint_u32(h, element->stream_index);
+            h = vkd3d_fingerprint_string(h, element->semantic_name);
+            h = vkd3d_fingerprint_u32(h, element->semantic_index);
+            h = vkd3d_fingerprint_u32(h, element->component_index);
+            h = vkd3d_fingerprint_u32(h, element->component_count);
+            h = vkd3d_fingerprint_u32(h, element->output_slot);
+        }
+
+        for (i = 0; i < xfb_info->buffer_stride_count; i++)
+            h = vkd3d_fingerprint_u32(h, xfb_info->buffer_strides[i]);
+    }
+
+    return h;
+}
+
+static HRESULT vkd3d_get_stage_spirv(struct d3d12_device *device, VkShaderStageFlagBits stage,
+        const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface,
+        const struct vkd3d_shader_compile_arguments *compile_args, const D3D12_CACHED_PIPELINE_STATE *cached_pso,
+        vkd3d_shader_hash_t fingerprint, struct vkd3d_shader_code *spirv)
+{
+    struct vkd3d_shader_code dxbc = {code->pShaderBytecode, code->BytecodeLength};
+    struct vkd3d_shader_code cached_spirv;
+    void *spirv_code;
+    int ret;
+
+    if (vkd3d_get_cached_spirv_from_d3d12_desc(device, cached_pso, stage, fingerprint, &cached_spirv))
+    {
+        TRACE("Using cached SPIR-V for stage %#x, hash %016"PRIx64".\n", stage, cached_spirv.meta.hash);
+
+        if (!(spirv_code = vkd3d_malloc(cached_spirv.size)))
+            return E_OUTOFMEMORY;
+
+        memcpy(spirv_code, cached_spirv.code, cached_spirv.size);
+        *spirv = cached_spirv;
+        spirv->code = spirv_code;
+        return S_OK;
+    }
+
+    TRACE("Calling vkd3d_shader_compile_dxbc.\n");
+    if ((ret = vkd3d_shader_compile_dxbc(&dxbc, spirv, 0, shader_interface, compile_args)) < 0)
+    {
+        WARN("Failed to compile shader, vkd3d result %d.\n", ret);
+        return hresult_from_vkd3d_result(ret);
+    }
+    TRACE("Called vkd3d_shader_compile_dxbc.\n");
+
+    return S_OK;
+}
+
 static HRESULT create_shader_stage(struct d3d12_device *device,
         VkPipelineShaderStageCreateInfo *stage_desc, VkShaderStageFlagBits stage,
         VkPipelineShaderStageRequiredSubgroupSizeCreateInfoEXT *required_subgroup_size_info,
         const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface,
-        const struct vkd3d_shader_compile_arguments *compile_args, struct vkd3d_shader_meta *meta)
+        const struct vkd3d_shader_compile_arguments *compile_args, const D3D12_CACHED_PIPELINE_STATE *cached_pso,
+        vkd3d_shader_hash_t root_signature_hash, struct vkd3d_pipeline_stage_code *stage_code,
+        struct vkd3d_shader_meta *meta)
 {
-    struct vkd3d_shader_code dxbc = {code->pShaderBytecode, code->BytecodeLength};
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     VkShaderModuleCreateInfo shader_desc;
     struct vkd3d_shader_code spirv = {0};
     char hash_str[16 + 1];
     VkResult vr;
-    int ret;
+    HRESULT hr;
 
     stage_desc->sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     stage_desc->pNext = NULL;
@@ -2120,19 +2594,24 @@ static HRESULT create_shader_stage(struct d3d12_device *device,
     shader_desc.pNext = NULL;
     shader_desc.flags = 0;
 
-    TRACE("Calling vkd3d_shader_compile_dxbc.\n");
-    if ((ret = vkd3d_shader_compile_dxbc(&dxbc, &spirv, 0, shader_interface, compile_args)) < 0)
-    {
-        WARN("Failed to compile shader, vkd3d result %d.\n", ret);
-        return hresult_from_vkd3d_result(ret);
-    }
-    TRACE("Called vkd3d_shader_compile_dxbc.\n");
+    memset(stage_code, 0, sizeof(*stage_code));
+    stage_code->stage = stage;
+    stage_code->fingerprint = vkd3d_pipeline_stage_fingerprint(root_signature_hash,
+            stage, code, shader_interface, compile_args);
+
+    if (FAILED(hr = vkd3d_get_stage_spirv(device, stage, code, shader_interface,
+            compile_args, cached_pso, stage_code->fingerprint, &spirv)))
+        return hr;
+
     shader_desc.codeSize = spirv.size;
     shader_desc.pCode = spirv.code;
     *meta = spirv.meta;
 
     if (!d3d12_device_validate_shader_meta(device, &spirv.meta))
+    {
+        vkd3d_shader_free_shader_code(&spirv);
         return E_INVALIDARG;
+    }
 
     if (spirv.meta.uses_subgroup_size && device->device_info.subgroup_size_control_features.subgroupSizeControl)
     {
@@ -2165,14 +2644,20 @@ static HRESULT create_shader_stage(struct d3d12_device *device,
         }
     }
 
-    vr = VK_CALL(vkCreateShaderModule(device->vk_device, &shader_desc, NULL, &stage_desc->module));
-    vkd3d_shader_free_shader_code(&spirv);
+    vr = VK_CALL(vkCreateShaderModule(device->vk_device, &shader_desc, &vkd3d_vk_allocator, &stage_desc->module));
     if (vr < 0)
     {
         WARN("Failed to create Vulkan shader module, vr %d.\n", vr);
+        vkd3d_shader_free_shader_code(&spirv);
         return hresult_from_vk_result(vr);
     }
 
+    /* Replaced shaders are keyed on the original DXBC, don't let them leak into cached blobs. */
+    if (spirv.meta.replaced || !d3d12_device_uses_pipeline_blobs(device))
+        vkd3d_shader_free_shader_code(&spirv);
+    else
+        stage_code->spirv = spirv;
+
     /* Helpful for tooling like RenderDoc. */
     sprintf(hash_str, "%016"PRIx64, spirv.meta.hash);
     vkd3d_set_vk_object_name(device, (uint64_t)stage_desc->module, VK_OBJECT_TYPE_SHADER_MODULE, hash_str);
@@ -2180,16 +2665,15 @@ static HRESULT create_shader_stage(struct d3d12_device *device,
     return S_OK;
 }
 
-static HRESULT vkd3d_create_compute_pipeline(struct d3d12_device *device,
+static HRESULT vkd3d_create_compute_pipeline(struct d3d12_pipeline_state *state, struct d3d12_device *device,
         const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface,
-        VkPipelineLayout vk_pipeline_layout, VkPipelineCache vk_cache, VkPipeline *vk_pipeline,
-        struct vkd3d_shader_meta *meta)
+        const struct d3d12_root_signature *root_signature, const D3D12_CACHED_PIPELINE_STATE *cached_pso,
+        VkPipelineCache vk_cache)
 {
-    VkPipelineShaderStageRequiredSubgroupSizeCreateInfoEXT required_subgroup_size_info;
+    struct d3d12_compute_pipeline_state *compute = &state->compute;
+    VkComputePipelineCreateInfo *pipeline_info = &compute->create_info;
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
-    struct vkd3d_shader_debug_ring_spec_info spec_info;
     struct vkd3d_shader_compile_arguments compile_args;
-    VkComputePipelineCreateInfo pipeline_info;
     VkResult vr;
     HRESULT hr;
 
@@ -2199,41 +2683,161 @@ static HRESULT vkd3d_create_compute_pipeline(struct d3d12_device *device,
     compile_args.target = VKD3D_SHADER_TARGET_SPIRV_VULKAN_1_0;
     compile_args.quirks = vkd3d_shader_quirk_info;
 
-    pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-    pipeline_info.pNext = NULL;
-    pipeline_info.flags = 0;
-    if (FAILED(hr = create_shader_stage(device, &pipeline_info.stage,
-            VK_SHADER_STAGE_COMPUTE_BIT, &required_subgroup_size_info,
-            code, shader_interface, &compile_args, meta)))
+    pipeline_info->sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_info->pNext = NULL;
+    pipeline_info->flags = 0;
+    if (FAILED(hr = create_shader_stage(device, &pipeline_info->stage,
+            VK_SHADER_STAGE_COMPUTE_BIT, &compute->required_subgroup_size_info,
+            code, shader_interface, &compile_args, cached_pso, root_signature->compatibility_hash,
+            &state->stage_code[0], &compute->meta)))
         return hr;
-    pipeline_info.layout = vk_pipeline_layout;
-    pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
-    pipeline_info.basePipelineIndex = -1;
+    state->stage_code_count = 1;
+    pipeline_info->layout = root_signature->compute.vk_pipeline_layout;
+    pipeline_info->basePipelineHandle = VK_NULL_HANDLE;
+    pipeline_info->basePipelineIndex = -1;
 
-    if (meta->replaced && device->debug_ring.active)
+    if (compute->meta.replaced && device->debug_ring.active)
     {
-        vkd3d_shader_debug_ring_init_spec_constant(device, &spec_info, meta->hash);
-        pipeline_info.stage.pSpecializationInfo = &spec_info.spec_info;
+        vkd3d_shader_debug_ring_init_spec_constant(device, &compute->spec_info, compute->meta.hash);
+        pipeline_info->stage.pSpecializationInfo = &compute->spec_info.spec_info;
     }
 
     TRACE("Calling vkCreateComputePipelines.\n");
-    vr = VK_CALL(vkCreateComputePipelines(device->vk_device,
-            vk_cache, 1, &pipeline_info, NULL, vk_pipeline));
+    vr = vkd3d_pipeline_cache_pool_create_compute_pipeline(&device->pipeline_cache_pool, device,
+            vk_cache, pipeline_info, &compute->vk_pipeline);
     TRACE("Called vkCreateComputePipelines.\n");
-    VK_CALL(vkDestroyShaderModule(device->vk_device, pipeline_info.stage.module, NULL));
     if (vr < 0)
     {
-        WARN("Failed to create Vulkan compute pipeline, hr %#x.", hr);
+        WARN("Failed to create Vulkan compute pipeline, vr %d.\n", vr);
+        VK_CALL(vkDestroyShaderModule(device->vk_device, pipeline_info->stage.module, &vkd3d_vk_allocator));
         return hresult_from_vk_result(vr);
     }
 
+    /* The shader module is kept alive with the PSO, see d3d12_pipeline_state_get_cache_data(). */
     return S_OK;
 }
 
+struct d3d12_pipeline_state_compile_cache
+{
+    VkPipelineCache vk_cache;
+    bool is_private;
+    bool capture_data;
+};
+
+/* PSOs created from a cached blob compile against a private cache seeded with that blob.
+ * If the application serializes PSOs, they compile into an empty private cache, so that
+ * their own cache data can be captured without compiling them again later. Everything
+ * else compiles into the PSO's shard of the device's cache pool. */
+static HRESULT d3d12_pipeline_state_begin_compile(struct d3d12_pipeline_state *state,
+        struct d3d12_device *device, const D3D12_CACHED_PIPELINE_STATE *cached_pso,
+        struct d3d12_pipeline_state_compile_cache *cache)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    const void *data;
+    VkResult vr;
+    size_t size;
+    HRESULT hr;
+
+    cache->capture_data = false;
+
+    if (FAILED(hr = vkd3d_create_pipeline_cache_from_d3d12_desc(device, cached_pso, &cache->vk_cache)))
+    {
+        ERR("Failed to create pipeline cache, hr %#x.\n", hr);
+        return hr;
+    }
+
+    if (!cache->vk_cache && d3d12_device_uses_pipeline_blobs(device))
+    {
+        if ((vr = vkd3d_create_pipeline_cache(device, 0, NULL, &cache->vk_cache)))
+        {
+            ERR("Failed to create pipeline cache, vr %d.\n", vr);
+            return hresult_from_vk_result(vr);
+        }
+
+        cache->is_private = true;
+        cache->capture_data = true;
+        return S_OK;
+    }
+
+    if (!(cache->is_private = !!cache->vk_cache))
+    {
+        cache->vk_cache = vkd3d_pipeline_cache_pool_acquire(&device->pipeline_cache_pool, state->cache_shard_index);
+        return S_OK;
+    }
+
+    /* The blob is exactly what this PSO contributed when it was serialized. */
+    data = vkd3d_get_pipeline_cache_data_from_d3d12_desc(cached_pso, &size);
+    if (size)
+    {
+        if (!(state->vk_cache_data = vkd3d_malloc(size)))
+        {
+            VK_CALL(vkDestroyPipelineCache(device->vk_device, cache->vk_cache, &vkd3d_vk_allocator));
+            return E_OUTOFMEMORY;
+        }
+
+        memcpy(state->vk_cache_data, data, size);
+    }
+
+    state->vk_cache_data_size = size;
+    state->has_vk_cache_data = true;
+    return S_OK;
+}
+
+/* If capturing fails, the data is extracted again the first time the PSO is serialized. */
+static void d3d12_pipeline_state_capture_cache_data(struct d3d12_pipeline_state *state,
+        struct d3d12_device *device, VkPipelineCache vk_cache)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    size_t size = 0;
+    void *data;
+    VkResult vr;
+
+    if ((vr = VK_CALL(vkGetPipelineCacheData(device->vk_device, vk_cache, &size, NULL))))
+    {
+        WARN("Failed to query pipeline cache data size, vr %d.\n", vr);
+        return;
+    }
+
+    if (!size)
+        data = NULL;
+    else if (!(data = vkd3d_malloc(size)))
+        return;
+    else if ((vr = VK_CALL(vkGetPipelineCacheData(device->vk_device, vk_cache, &size, data))))
+    {
+        /* Nothing else uses the cache, so it cannot grow in between. */
+        WARN("Failed to get pipeline cache data, vr %d.\n", vr);
+        vkd3d_free(data);
+        return;
+    }
+
+    state->vk_cache_data = data;
+    state->vk_cache_data_size = size;
+    state->has_vk_cache_data = true;
+}
+
+static void d3d12_pipeline_state_end_compile(struct d3d12_pipeline_state *state,
+        struct d3d12_device *device, struct d3d12_pipeline_state_compile_cache *cache)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+
+    if (cache->is_private)
+    {
+        if (cache->capture_data)
+            d3d12_pipeline_state_capture_cache_data(state, device, cache->vk_cache);
+
+        vkd3d_pipeline_cache_pool_import(&device->pipeline_cache_pool, device,
+                state->cache_shard_index, cache->vk_cache);
+        VK_CALL(vkDestroyPipelineCache(device->vk_device, cache->vk_cache, &vkd3d_vk_allocator));
+    }
+    else
+        vkd3d_pipeline_cache_pool_release(&device->pipeline_cache_pool, device, state->cache_shard_index);
+}
+
 static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *state,
         struct d3d12_device *device, const struct d3d12_pipeline_state_desc *desc)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    struct d3d12_pipeline_state_compile_cache compile_cache;
     struct vkd3d_shader_interface_info shader_interface;
     const struct d3d12_root_signature *root_signature;
     HRESULT hr;
@@ -2263,20 +2867,13 @@ static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *st
     shader_interface.descriptor_qa_heap_binding = &root_signature->descriptor_qa_heap_binding;
 #endif
 
-    if (!device->global_pipeline_cache)
-    {
-        if ((hr = vkd3d_create_pipeline_cache_from_d3d12_desc(device, &desc->cached_pso, &state->vk_pso_cache)) < 0)
-        {
-            ERR("Failed to create pipeline cache, hr %d.\n", hr);
-            return hr;
-        }
-    }
+    if (FAILED(hr = d3d12_pipeline_state_begin_compile(state, device, &desc->cached_pso, &compile_cache)))
+        return hr;
+
+    hr = vkd3d_create_compute_pipeline(state, device, &desc->cs, &shader_interface,
+            root_signature, &desc->cached_pso, compile_cache.vk_cache);
 
-    hr = vkd3d_create_compute_pipeline(device, &desc->cs, &shader_interface,
-            root_signature->compute.vk_pipeline_layout,
-            state->vk_pso_cache ? state->vk_pso_cache : device->global_pipeline_cache,
-            &state->compute.vk_pipeline,
-            &state->compute.meta);
+    d3d12_pipeline_state_end_compile(state, device, &compile_cache);
 
     if (FAILED(hr))
     {
@@ -2286,7 +2883,8 @@ static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *st
 
     if (FAILED(hr = vkd3d_private_store_init(&state->private_store)))
     {
-        VK_CALL(vkDestroyPipeline(device->vk_device, state->compute.vk_pipeline, NULL));
+        VK_CALL(vkDestroyPipeline(device->vk_device, state->compute.vk_pipeline, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyShaderModule(device->vk_device, state->compute.create_info.stage.module, &vkd3d_vk_allocator));
         return hr;
     }
 
@@ -2733,6 +3331,8 @@ static HRESULT d3d12_graphics_pipeline_state_create_render_pass_for_plane_mask(
     memcpy(key.vk_formats, graphics->rtv_formats, sizeof(graphics->rtv_formats));
     key.attachment_count = graphics->rt_count;
     key.rtv_active_mask = rtv_active_mask;
+    key.rtv_clear_mask = 0;
+    key.rtv_discard_mask = 0;
     key.flags = 0;
 
     if (graphics->dsv_format)
@@ -2913,7 +3513,8 @@ static uint32_t d3d12_graphics_pipeline_state_init_dynamic_state(struct d3d12_pi
             dynamic_state_flags |= VKD3D_DYNAMIC_STATE_VERTEX_BUFFER;
     }
 
-    if (!key || key->dynamic_topology)
+    /* Mesh pipelines must not declare any input assembly state as dynamic. */
+    if ((!key || key->dynamic_topology) && !graphics->is_mesh_pipeline)
         dynamic_state_flags |= VKD3D_DYNAMIC_STATE_TOPOLOGY;
 
     if (graphics->ds_desc.stencilTestEnable)
@@ -2967,6 +3568,37 @@ static bool d3d12_is_valid_pipeline_variant(struct d3d12_device *device, uint32_
     return true;
 }
 
+#ifdef VKD3D_ENABLE_PROFILING
+static uint64_t vkd3d_static_variant_deferred_count;
+static uint64_t vkd3d_static_variant_late_count;
+static spinlock_t vkd3d_static_variant_region_lock;
+static uint32_t vkd3d_static_variant_region_latch;
+#endif
+
+static void d3d12_pipeline_state_count_static_variants(uint32_t deferred_count, uint32_t late_count)
+{
+#ifdef VKD3D_ENABLE_PROFILING
+    uint64_t deferred, late;
+    unsigned int index;
+
+    deferred = vkd3d_atomic_uint64_add(&vkd3d_static_variant_deferred_count, deferred_count, vkd3d_memory_order_relaxed);
+    late = vkd3d_atomic_uint64_add(&vkd3d_static_variant_late_count, late_count, vkd3d_memory_order_relaxed);
+
+    if (!vkd3d_uses_profiling())
+        return;
+
+    if (!(index = vkd3d_atomic_uint32_load_explicit(&vkd3d_static_variant_region_latch, vkd3d_memory_order_acquire)))
+    {
+        if (!(index = vkd3d_profiling_register_region("Static PSO variant compiles avoided",
+                &vkd3d_static_variant_region_lock, &vkd3d_static_variant_region_latch)))
+            return;
+    }
+
+    /* Deferred variants which were never needed are compiles we avoided entirely. */
+    vkd3d_profiling_set_counter(index, deferred - late, deferred);
+#endif
+}
+
 static HRESULT d3d12_pipeline_state_validate_blend_state(struct d3d12_pipeline_state *state,
         const struct d3d12_device *device,
         const struct d3d12_pipeline_state_desc *desc, const struct vkd3d_shader_signature *sig)
@@ -3023,6 +3655,7 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
     uint32_t aligned_offsets[D3D12_VS_INPUT_REGISTER_COUNT];
     struct vkd3d_shader_parameter ps_shader_parameters[1];
     struct vkd3d_shader_transform_feedback_info xfb_info;
+    struct d3d12_pipeline_state_compile_cache compile_cache;
     struct vkd3d_shader_interface_info shader_interface;
     const struct d3d12_root_signature *root_signature;
     struct vkd3d_shader_signature output_signature;
@@ -3049,6 +3682,8 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
         {VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,    offsetof(struct d3d12_pipeline_state_desc, hs)},
         {VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT, offsetof(struct d3d12_pipeline_state_desc, ds)},
         {VK_SHADER_STAGE_GEOMETRY_BIT,                offsetof(struct d3d12_pipeline_state_desc, gs)},
+        {VK_SHADER_STAGE_TASK_BIT_EXT,                offsetof(struct d3d12_pipeline_state_desc, as)},
+        {VK_SHADER_STAGE_MESH_BIT_EXT,                offsetof(struct d3d12_pipeline_state_desc, ms)},
         {VK_SHADER_STAGE_FRAGMENT_BIT,                offsetof(struct d3d12_pipeline_state_desc, ps)},
     };
 
@@ -3056,7 +3691,14 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
     state->refcount = 1;
 
     graphics->stage_count = 0;
-    graphics->primitive_topology_type = desc->primitive_topology_type;
+    graphics->is_mesh_pipeline = desc->ms.pShaderBytecode && desc->ms.BytecodeLength;
+
+    /* The output topology of mesh pipelines is declared by the mesh shader, and there is
+     * no input assembly, so treat them as triangle pipelines for the purpose of dynamic state. */
+    if (graphics->is_mesh_pipeline)
+        graphics->primitive_topology_type = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    else
+        graphics->primitive_topology_type = desc->primitive_topology_type;
 
     memset(&input_signature, 0, sizeof(input_signature));
     memset(&output_signature, 0, sizeof(output_signature));
@@ -3254,6 +3896,13 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
     graphics->xfb_enabled = false;
     if (so_desc->NumEntries)
     {
+        if (graphics->is_mesh_pipeline)
+        {
+            WARN("Stream output cannot be used with mesh shaders.\n");
+            hr = E_INVALIDARG;
+            goto fail;
+        }
+
         if (!(root_signature->d3d12_flags & D3D12_ROOT_SIGNATURE_FLAG_ALLOW_STREAM_OUTPUT))
         {
             WARN("Stream output is used without D3D12_ROOT_SIGNATURE_FLAG_ALLOW_STREAM_OUTPUT.\n");
@@ -3331,6 +3980,17 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
             case VK_SHADER_STAGE_GEOMETRY_BIT:
                 break;
 
+            case VK_SHADER_STAGE_TASK_BIT_EXT:
+            case VK_SHADER_STAGE_MESH_BIT_EXT:
+                if (!device->device_info.mesh_shader_features.meshShader ||
+                        !device->device_info.mesh_shader_features.taskShader)
+                {
+                    WARN("Mesh shaders are not supported by the device.\n");
+                    hr = E_INVALIDARG;
+                    goto fail;
+                }
+                break;
+
             case VK_SHADER_STAGE_FRAGMENT_BIT:
                 if ((ret = vkd3d_shader_parse_output_signature(&dxbc, &output_signature)) < 0)
                 {
@@ -3352,8 +4012,10 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
         if (FAILED(hr = create_shader_stage(device, &graphics->stages[graphics->stage_count],
                 shader_stages[i].stage, NULL, b, &shader_interface,
                 shader_stages[i].stage == VK_SHADER_STAGE_FRAGMENT_BIT ? &ps_compile_args : &compile_args,
-                &graphics->stage_meta[graphics->stage_count])))
+                &desc->cached_pso, root_signature->compatibility_hash,
+                &state->stage_code[graphics->stage_count], &graphics->stage_meta[graphics->stage_count])))
             goto fail;
+        state->stage_code_count = graphics->stage_count + 1;
 
         if (shader_stages[i].stage == VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT)
             graphics->patch_vertex_count = graphics->stage_meta[graphics->stage_count].patch_vertex_count;
@@ -3369,7 +4031,8 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
         ++graphics->stage_count;
     }
 
-    graphics->attribute_count = desc->input_layout.NumElements;
+    /* Mesh pipelines fetch their own vertex data, any input layout is ignored. */
+    graphics->attribute_count = graphics->is_mesh_pipeline ? 0 : desc->input_layout.NumElements;
     if (graphics->attribute_count > ARRAY_SIZE(graphics->attributes))
     {
         FIXME("InputLayout.NumElements %zu > %zu, ignoring extra elements.\n",
@@ -3568,8 +4231,8 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
     }
 
     supports_extended_dynamic_state = device->device_info.extended_dynamic_state_features.extendedDynamicState &&
-            (desc->primitive_topology_type != D3D12_PRIMITIVE_TOPOLOGY_TYPE_PATCH || graphics->patch_vertex_count != 0) &&
-            desc->primitive_topology_type != D3D12_PRIMITIVE_TOPOLOGY_TYPE_UNDEFINED;
+            (graphics->primitive_topology_type != D3D12_PRIMITIVE_TOPOLOGY_TYPE_PATCH || graphics->patch_vertex_count != 0) &&
+            graphics->primitive_topology_type != D3D12_PRIMITIVE_TOPOLOGY_TYPE_UNDEFINED;
 
     graphics->pipeline_layout = root_signature->graphics.vk_pipeline_layout;
     for (i = 0; i < VKD3D_GRAPHICS_PIPELINE_STATIC_VARIANT_COUNT; i++)
@@ -3578,26 +4241,28 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
 
     if (supports_extended_dynamic_state)
     {
-        if (!device->global_pipeline_cache)
+        /* If we have EXT_extended_dynamic_state, we can compile a pipeline right here.
+         * There are still some edge cases where we need to fall back to special pipelines, but that should be very rare. */
+        if (FAILED(hr = d3d12_pipeline_state_begin_compile(state, device, &desc->cached_pso, &compile_cache)))
+            goto fail;
+
+        /* Only the primary variant is compiled up front. Other static variants are only
+         * needed once a command list binds e.g. a shading rate image, which most PSOs never see,
+         * so they are compiled on first use instead. */
+        graphics->pipeline[0] = d3d12_pipeline_state_create_pipeline_variant(state, NULL, graphics->dsv_format,
+                compile_cache.vk_cache, &graphics->render_pass[0], &graphics->dynamic_state_flags, 0);
+        d3d12_pipeline_state_end_compile(state, device, &compile_cache);
+
+        if (!graphics->pipeline[0])
         {
-            /* If we have EXT_extended_dynamic_state, we can compile a pipeline right here.
-             * There are still some edge cases where we need to fall back to special pipelines, but that should be very rare. */
-            if ((hr = vkd3d_create_pipeline_cache_from_d3d12_desc(device, &desc->cached_pso, &state->vk_pso_cache)) < 0)
-            {
-                ERR("Failed to create pipeline cache, hr %d.\n", hr);
-                goto fail;
-            }
+            hr = E_FAIL;
+            goto fail;
         }
 
-        for (i = 0; i < VKD3D_GRAPHICS_PIPELINE_STATIC_VARIANT_COUNT; i++)
+        for (i = 1; i < VKD3D_GRAPHICS_PIPELINE_STATIC_VARIANT_COUNT; i++)
         {
-            if (!d3d12_is_valid_pipeline_variant(device, i))
-                continue;
-
-            if (!(graphics->pipeline[i] = d3d12_pipeline_state_create_pipeline_variant(state, NULL, graphics->dsv_format,
-                    state->vk_pso_cache ? state->vk_pso_cache : device->global_pipeline_cache,
-                    &graphics->render_pass[i], &graphics->dynamic_state_flags, i)))
-                goto fail;
+            if (d3d12_is_valid_pipeline_variant(device, i))
+                d3d12_pipeline_state_count_static_variants(1, 0);
         }
     }
     else
@@ -3627,7 +4292,7 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
 fail:
     for (i = 0; i < graphics->stage_count; ++i)
     {
-        VK_CALL(vkDestroyShaderModule(device->vk_device, state->graphics.stages[i].module, NULL));
+        VK_CALL(vkDestroyShaderModule(device->vk_device, state->graphics.stages[i].module, &vkd3d_vk_allocator));
     }
     vkd3d_shader_free_shader_signature(&input_signature);
     vkd3d_shader_free_shader_signature(&output_signature);
@@ -3667,7 +4332,6 @@ static HRESULT d3d12_pipeline_create_private_root_signature(struct d3d12_device
 HRESULT d3d12_pipeline_state_create(struct d3d12_device *device, VkPipelineBindPoint bind_point,
         const struct d3d12_pipeline_state_desc *desc, struct d3d12_pipeline_state **state)
 {
-    const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     struct d3d12_pipeline_state *object;
     HRESULT hr;
 
@@ -3676,6 +4340,11 @@ HRESULT d3d12_pipeline_state_create(struct d3d12_device *device, VkPipelineBindP
 
     memset(object, 0, sizeof(*object));
 
+    if (desc->cached_pso.CachedBlobSizeInBytes)
+        d3d12_device_mark_pipeline_blob_usage(device);
+
+    object->cache_shard_index = vkd3d_pipeline_cache_pool_get_shard(&device->pipeline_cache_pool);
+
     if (!desc->root_signature)
     {
         if (FAILED(hr = d3d12_pipeline_create_private_root_signature(device,
@@ -3706,7 +4375,8 @@ HRESULT d3d12_pipeline_state_create(struct d3d12_device *device, VkPipelineBindP
     {
         if (object->private_root_signature)
             ID3D12RootSignature_Release(object->private_root_signature);
-        VK_CALL(vkDestroyPipelineCache(device->vk_device, object->vk_pso_cache, NULL));
+        vkd3d_free(object->vk_cache_data);
+        d3d12_pipeline_state_free_stage_code(object);
 
         vkd3d_free(object);
         return hr;
@@ -3884,7 +4554,6 @@ VkPipeline d3d12_pipeline_state_create_pipeline_variant(struct d3d12_pipeline_st
         uint32_t *dynamic_state_flags, uint32_t variant_flags)
 {
     VkVertexInputBindingDescription bindings[D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
-    const struct vkd3d_vk_device_procs *vk_procs = &state->device->vk_procs;
     VkDynamicState dynamic_state_buffer[VKD3D_MAX_DYNAMIC_STATE_COUNT];
     struct d3d12_graphics_pipeline_state *graphics = &state->graphics;
     VkPipelineVertexInputDivisorStateCreateInfoEXT input_divisor_info;
@@ -3960,9 +4629,9 @@ VkPipeline d3d12_pipeline_state_create_pipeline_variant(struct d3d12_pipeline_st
     pipeline_desc.flags = 0;
     pipeline_desc.stageCount = graphics->stage_count;
     pipeline_desc.pStages = graphics->stages;
-    pipeline_desc.pVertexInputState = &input_desc;
-    pipeline_desc.pInputAssemblyState = &ia_desc;
-    pipeline_desc.pTessellationState = &tessellation_info;
+    pipeline_desc.pVertexInputState = graphics->is_mesh_pipeline ? NULL : &input_desc;
+    pipeline_desc.pInputAssemblyState = graphics->is_mesh_pipeline ? NULL : &ia_desc;
+    pipeline_desc.pTessellationState = graphics->is_mesh_pipeline ? NULL : &tessellation_info;
     pipeline_desc.pViewportState = &vp_desc;
     pipeline_desc.pRasterizationState = &graphics->rs_desc;
     pipeline_desc.pMultisampleState = &graphics->ms_desc;
@@ -3998,8 +4667,8 @@ VkPipeline d3d12_pipeline_state_create_pipeline_variant(struct d3d12_pipeline_st
     pipeline_desc.renderPass = render_pass_compat->dsv_layouts[0];
 
     TRACE("Calling vkCreateGraphicsPipelines.\n");
-    if ((vr = VK_CALL(vkCreateGraphicsPipelines(device->vk_device,
-            vk_cache, 1, &pipeline_desc, NULL, &vk_pipeline))) < 0)
+    if ((vr = vkd3d_pipeline_cache_pool_create_graphics_pipeline(&device->pipeline_cache_pool, device,
+            vk_cache, &pipeline_desc, &vk_pipeline)) < 0)
     {
         WARN("Failed to create Vulkan graphics pipeline, vr %d.\n", vr);
         return VK_NULL_HANDLE;
@@ -4009,6 +4678,115 @@ VkPipeline d3d12_pipeline_state_create_pipeline_variant(struct d3d12_pipeline_st
     return vk_pipeline;
 }
 
+static HRESULT d3d12_pipeline_state_compile_into_cache(struct d3d12_pipeline_state *state, VkPipelineCache vk_cache)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &state->device->vk_procs;
+    struct d3d12_graphics_pipeline_state *graphics = &state->graphics;
+    struct vkd3d_render_pass_compatibility render_pass_compat;
+    struct d3d12_device *device = state->device;
+    uint32_t dynamic_state_flags;
+    VkPipeline vk_pipeline;
+    VkResult vr;
+
+    if (d3d12_pipeline_state_is_compute(state))
+    {
+        if ((vr = VK_CALL(vkCreateComputePipelines(device->vk_device, vk_cache, 1,
+                &state->compute.create_info, &vkd3d_vk_allocator, &vk_pipeline))) < 0)
+            return hresult_from_vk_result(vr);
+
+        VK_CALL(vkDestroyPipeline(device->vk_device, vk_pipeline, &vkd3d_vk_allocator));
+        return S_OK;
+    }
+
+    /* Fallback pipelines and on-demand static variants are compiled without a private cache,
+     * so only the primary static variant contributes. */
+    if (!graphics->pipeline[0])
+        return S_OK;
+
+    if (!(vk_pipeline = d3d12_pipeline_state_create_pipeline_variant(state, NULL, graphics->dsv_format,
+            vk_cache, &render_pass_compat, &dynamic_state_flags, 0)))
+        return E_FAIL;
+
+    VK_CALL(vkDestroyPipeline(device->vk_device, vk_pipeline, &vkd3d_vk_allocator));
+    return S_OK;
+}
+
+/* Returns the driver cache data which belongs to this PSO alone. PSOs which were created before
+ * the device used pipeline blobs were compiled into a shared cache, so the data is extracted
+ * by compiling the PSO once more into an empty cache. The result is kept, since applications
+ * tend to serialize PSOs more than once. */
+HRESULT d3d12_pipeline_state_get_cache_data(struct d3d12_pipeline_state *state,
+        const void **data, size_t *size)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &state->device->vk_procs;
+    struct d3d12_device *device = state->device;
+    VkPipelineCache vk_cache;
+    size_t vk_data_size = 0;
+    void *vk_data = NULL;
+    VkResult vr;
+    HRESULT hr;
+
+    rw_spinlock_acquire_read(&state->lock);
+    if (state->has_vk_cache_data)
+        goto out;
+    rw_spinlock_release_read(&state->lock);
+
+    if ((vr = vkd3d_create_pipeline_cache(device, 0, NULL, &vk_cache)))
+        return hresult_from_vk_result(vr);
+
+    if (FAILED(hr = d3d12_pipeline_state_compile_into_cache(state, vk_cache)))
+    {
+        ERR("Failed to recompile pipeline state %p, hr %#x.\n", state, hr);
+        goto cleanup;
+    }
+
+    if ((vr = VK_CALL(vkGetPipelineCacheData(device->vk_device, vk_cache, &vk_data_size, NULL))))
+    {
+        hr = hresult_from_vk_result(vr);
+        goto cleanup;
+    }
+
+    if (vk_data_size && !(vk_data = vkd3d_malloc(vk_data_size)))
+    {
+        hr = E_OUTOFMEMORY;
+        goto cleanup;
+    }
+
+    if (vk_data_size && (vr = VK_CALL(vkGetPipelineCacheData(device->vk_device, vk_cache, &vk_data_size, vk_data))))
+    {
+        vkd3d_free(vk_data);
+        hr = hresult_from_vk_result(vr);
+        goto cleanup;
+    }
+
+    VK_CALL(vkDestroyPipelineCache(device->vk_device, vk_cache, &vkd3d_vk_allocator));
+
+    rw_spinlock_acquire_write(&state->lock);
+    if (state->has_vk_cache_data)
+    {
+        /* Another thread got there first. */
+        vkd3d_free(vk_data);
+    }
+    else
+    {
+        state->vk_cache_data = vk_data;
+        state->vk_cache_data_size = vk_data_size;
+        state->has_vk_cache_data = true;
+    }
+    rw_spinlock_release_write(&state->lock);
+
+    rw_spinlock_acquire_read(&state->lock);
+out:
+    *data = state->vk_cache_data;
+    *size = state->vk_cache_data_size;
+    rw_spinlock_release_read(&state->lock);
+    return S_OK;
+
+cleanup:
+    VK_CALL(vkDestroyPipelineCache(device->vk_device, vk_cache, &vkd3d_vk_allocator));
+    return hr;
+}
+
 static bool d3d12_pipeline_state_can_use_dynamic_stride(struct d3d12_pipeline_state *state,
         const struct vkd3d_dynamic_state *dyn_state)
 {
@@ -4044,6 +4822,58 @@ static bool d3d12_pipeline_state_can_use_dynamic_stride(struct d3d12_pipeline_st
     return true;
 }
 
+static VkPipeline d3d12_pipeline_state_get_static_variant(struct d3d12_pipeline_state *state,
+        uint32_t variant_flags)
+{
+    const struct vkd3d_vk_device_procs *vk_procs = &state->device->vk_procs;
+    struct d3d12_graphics_pipeline_state *graphics = &state->graphics;
+    struct vkd3d_render_pass_compatibility render_pass_compat;
+    struct d3d12_device *device = state->device;
+    uint32_t dynamic_state_flags;
+    VkPipelineCache vk_cache;
+    VkPipeline vk_pipeline;
+
+    rw_spinlock_acquire_read(&state->lock);
+    vk_pipeline = graphics->pipeline[variant_flags];
+    rw_spinlock_release_read(&state->lock);
+
+    if (vk_pipeline)
+        return vk_pipeline;
+
+    if (!d3d12_is_valid_pipeline_variant(device, variant_flags))
+        return VK_NULL_HANDLE;
+
+    TRACE("Compiling static variant %#x of pipeline state %p on first use.\n", variant_flags, state);
+
+    vk_cache = vkd3d_pipeline_cache_pool_acquire(&device->pipeline_cache_pool, state->cache_shard_index);
+    vk_pipeline = d3d12_pipeline_state_create_pipeline_variant(state, NULL, graphics->dsv_format,
+            vk_cache, &render_pass_compat, &dynamic_state_flags, variant_flags);
+    vkd3d_pipeline_cache_pool_release(&device->pipeline_cache_pool, device, state->cache_shard_index);
+
+    if (!vk_pipeline)
+    {
+        ERR("Failed to compile static pipeline variant %#x.\n", variant_flags);
+        return VK_NULL_HANDLE;
+    }
+
+    rw_spinlock_acquire_write(&state->lock);
+    if (graphics->pipeline[variant_flags])
+    {
+        /* Other thread compiled the variant before us. */
+        VK_CALL(vkDestroyPipeline(device->vk_device, vk_pipeline, &vkd3d_vk_allocator));
+        vk_pipeline = graphics->pipeline[variant_flags];
+    }
+    else
+    {
+        graphics->render_pass[variant_flags] = render_pass_compat;
+        graphics->pipeline[variant_flags] = vk_pipeline;
+        d3d12_pipeline_state_count_static_variants(0, 1);
+    }
+    rw_spinlock_release_write(&state->lock);
+
+    return vk_pipeline;
+}
+
 VkPipeline d3d12_pipeline_state_get_pipeline(struct d3d12_pipeline_state *state,
         const struct vkd3d_dynamic_state *dyn_state,
         uint32_t rtv_nonnull_mask, const struct vkd3d_format *dsv_format,
@@ -4051,8 +4881,9 @@ VkPipeline d3d12_pipeline_state_get_pipeline(struct d3d12_pipeline_state *state,
         uint32_t *dynamic_state_flags, uint32_t variant_flags)
 {
     struct d3d12_graphics_pipeline_state *graphics = &state->graphics;
+    VkPipeline vk_pipeline;
 
-    if (!graphics->pipeline[variant_flags])
+    if (!graphics->pipeline[0])
         return VK_NULL_HANDLE;
 
     /* Unknown DSV format workaround. */
@@ -4083,7 +4914,7 @@ VkPipeline d3d12_pipeline_state_get_pipeline(struct d3d12_pipeline_state *state,
     }
 
     /* It should be illegal to use different patch size for topology compared to pipeline, but be safe here. */
-    if (dyn_state->vk_primitive_topology == VK_PRIMITIVE_TOPOLOGY_PATCH_LIST &&
+    if (!graphics->is_mesh_pipeline && dyn_state->vk_primitive_topology == VK_PRIMITIVE_TOPOLOGY_PATCH_LIST &&
         (dyn_state->primitive_topology - D3D_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + 1) != graphics->patch_vertex_count)
     {
         if (graphics->patch_vertex_count)
@@ -4095,9 +4926,17 @@ VkPipeline d3d12_pipeline_state_get_pipeline(struct d3d12_pipeline_state *state,
         return VK_NULL_HANDLE;
     }
 
+    if (variant_flags)
+    {
+        if (!(vk_pipeline = d3d12_pipeline_state_get_static_variant(state, variant_flags)))
+            return VK_NULL_HANDLE;
+    }
+    else
+        vk_pipeline = graphics->pipeline[0];
+
     *render_pass_compat = &state->graphics.render_pass[variant_flags];
     *dynamic_state_flags = state->graphics.dynamic_state_flags;
-    return state->graphics.pipeline[variant_flags];
+    return vk_pipeline;
 }
 
 VkPipeline d3d12_pipeline_state_get_or_create_pipeline(struct d3d12_pipeline_state *state,
@@ -4123,9 +4962,10 @@ VkPipeline d3d12_pipeline_state_get_or_create_pipeline(struct d3d12_pipeline_sta
     /* Try to keep as much dynamic state as possible so we don't have to rebind state unnecessarily. */
     extended_dynamic_state = device->device_info.extended_dynamic_state_features.extendedDynamicState;
 
-    if (extended_dynamic_state &&
+    /* Mesh pipelines have no input assembly, so the bound topology never needs to be baked in. */
+    if (graphics->is_mesh_pipeline || (extended_dynamic_state &&
         graphics->primitive_topology_type != D3D12_PRIMITIVE_TOPOLOGY_TYPE_PATCH &&
-        graphics->primitive_topology_type != D3D12_PRIMITIVE_TOPOLOGY_TYPE_UNDEFINED)
+        graphics->primitive_topology_type != D3D12_PRIMITIVE_TOPOLOGY_TYPE_UNDEFINED))
         pipeline_key.dynamic_topology = true;
     else
         pipeline_key.topology = dyn_state->primitive_topology;
@@ -4184,7 +5024,7 @@ VkPipeline d3d12_pipeline_state_get_or_create_pipeline(struct d3d12_pipeline_sta
     }
 
     /* Other thread compiled the pipeline before us. */
-    VK_CALL(vkDestroyPipeline(device->vk_device, vk_pipeline, NULL));
+    VK_CALL(vkDestroyPipeline(device->vk_device, vk_pipeline, &vkd3d_vk_allocator));
     vk_pipeline = d3d12_pipeline_state_find_compiled_pipeline(state, &pipeline_key, render_pass_compat, dynamic_state_flags);
     if (!vk_pipeline)
         ERR("Could not get the pipeline compiled by other thread from the cache.\n");
@@ -4340,7 +5180,7 @@ static HRESULT vkd3d_bindless_state_add_binding(struct vkd3d_bindless_state *bin
     }
 
     if ((vr = VK_CALL(vkCreateDescriptorSetLayout(device->vk_device,
-            &vk_set_layout_info, NULL, &set_info->vk_set_layout))) < 0)
+            &vk_set_layout_info, &vkd3d_vk_allocator, &set_info->vk_set_layout))) < 0)
         ERR("Failed to create descriptor set layout, vr %d.\n", vr);
 
     vk_binding->descriptorCount = d3d12_max_host_descriptor_count_from_heap_type(device, set_info->heap_type);
@@ -4354,7 +5194,7 @@ static HRESULT vkd3d_bindless_state_add_binding(struct vkd3d_bindless_state *bin
     }
 
     if ((vr = VK_CALL(vkCreateDescriptorSetLayout(device->vk_device,
-            &vk_set_layout_info, NULL, &set_info->vk_host_set_layout))) < 0)
+            &vk_set_layout_info, &vkd3d_vk_allocator, &set_info->vk_host_set_layout))) < 0)
         ERR("Failed to create descriptor set layout, vr %d.\n", vr);
 
     return hresult_from_vk_result(vr);
@@ -4417,7 +5257,7 @@ static bool vkd3d_bindless_supports_mutable_type(struct d3d12_device *device, ui
     return supported.supported == VK_TRUE;
 }
 
-static uint32_t vkd3d_bindless_state_get_bindless_flags(struct d3d12_device *device)
+uint32_t vkd3d_bindless_get_physical_device_flags(struct d3d12_device *device)
 {
     const struct vkd3d_physical_device_info *device_info = &device->device_info;
     const struct vkd3d_vulkan_info *vk_info = &device->vk_info;
@@ -4494,6 +5334,16 @@ static uint32_t vkd3d_bindless_state_get_bindless_flags(struct d3d12_device *dev
         flags |= VKD3D_HOIST_STATIC_TABLE_CBV;
     }
 
+    return flags;
+}
+
+static uint32_t vkd3d_bindless_state_get_bindless_flags(struct d3d12_device *device)
+{
+    uint32_t flags = vkd3d_bindless_get_physical_device_flags(device);
+
+    if (!flags)
+        return 0;
+
     if (vkd3d_bindless_supports_mutable_type(device, flags))
     {
         INFO("Device supports VK_VALVE_mutable_descriptor_type.\n");
@@ -4606,8 +5456,8 @@ void vkd3d_bindless_state_cleanup(struct vkd3d_bindless_state *bindless_state,
 
     for (i = 0; i < bindless_state->set_count; i++)
     {
-        VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, bindless_state->set_info[i].vk_set_layout, NULL));
-        VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, bindless_state->set_info[i].vk_host_set_layout, NULL));
+        VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, bindless_state->set_info[i].vk_set_layout, &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, bindless_state->set_info[i].vk_host_set_layout, &vkd3d_vk_allocator));
     }
 }
 
@@ -227,7 +227,7 @@ static inline const struct vkd3d_vk_device_procs* d3d12_swapchain_procs(struct d
     return &swapchain->command_queue->device->vk_procs;
 }
 
-static inline struct ID3D12Device6* d3d12_swapchain_device_iface(struct d3d12_swapchain* swapchain)
+static inline struct ID3D12Device7* d3d12_swapchain_device_iface(struct d3d12_swapchain* swapchain)
 {
     return &swapchain->command_queue->device->ID3D12Device_iface;
 }
@@ -835,11 +835,11 @@ static void d3d12_swapchain_destroy_user_descriptors(struct d3d12_swapchain *swa
     UINT i;
     for (i = 0; i < swapchain->desc.BufferCount; i++)
     {
-        VK_CALL(vkDestroyImageView(device->vk_device, swapchain->descriptors.vk_image_views[i], NULL));
+        VK_CALL(vkDestroyImageView(device->vk_device, swapchain->descriptors.vk_image_views[i], &vkd3d_vk_allocator));
         swapchain->descriptors.vk_image_views[i] = VK_NULL_HANDLE;
     }
 
-    VK_CALL(vkDestroyDescriptorPool(device->vk_device, swapchain->descriptors.pool, NULL));
+    VK_CALL(vkDestroyDescriptorPool(device->vk_device, swapchain->descriptors.pool, &vkd3d_vk_allocator));
     swapchain->descriptors.pool = VK_NULL_HANDLE;
 }
 
@@ -874,7 +874,7 @@ static HRESULT d3d12_swapchain_create_user_descriptors(struct d3d12_swapchain *s
     for (i = 0; i < swapchain->desc.BufferCount; i++)
     {
         image_view_info.image = swapchain->vk_images[i];
-        if ((vr = VK_CALL(vkCreateImageView(device->vk_device, &image_view_info, NULL, &swapchain->descriptors.vk_image_views[i]))))
+        if ((vr = VK_CALL(vkCreateImageView(device->vk_device, &image_view_info, &vkd3d_vk_allocator, &swapchain->descriptors.vk_image_views[i]))))
             return hresult_from_vk_result(vr);
     }
 
@@ -887,7 +887,7 @@ static HRESULT d3d12_swapchain_create_user_descriptors(struct d3d12_swapchain *s
     pool_create_info.poolSizeCount = 1;
     pool_create_info.pPoolSizes = &pool_sizes;
     pool_create_info.maxSets = swapchain->desc.BufferCount;
-    if ((vr = VK_CALL(vkCreateDescriptorPool(device->vk_device, &pool_create_info, NULL, &swapchain->descriptors.pool))))
+    if ((vr = VK_CALL(vkCreateDescriptorPool(device->vk_device, &pool_create_info, &vkd3d_vk_allocator, &swapchain->descriptors.pool))))
         return hresult_from_vk_result(vr);
 
     allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -1075,8 +1075,8 @@ static void d3d12_swapchain_destroy_framebuffers(struct d3d12_swapchain *swapcha
 
     for (i = 0; i < swapchain->buffer_count; i++)
     {
-        VK_CALL(vkDestroyImageView(vk_device, swapchain->vk_swapchain_image_views[i], NULL));
-        VK_CALL(vkDestroyFramebuffer(vk_device, swapchain->vk_framebuffers[i], NULL));
+        VK_CALL(vkDestroyImageView(vk_device, swapchain->vk_swapchain_image_views[i], &vkd3d_vk_allocator));
+        VK_CALL(vkDestroyFramebuffer(vk_device, swapchain->vk_framebuffers[i], &vkd3d_vk_allocator));
         swapchain->vk_swapchain_image_views[i] = VK_NULL_HANDLE;
         swapchain->vk_framebuffers[i] = VK_NULL_HANDLE;
     }
@@ -1118,10 +1118,10 @@ static HRESULT d3d12_swapchain_create_framebuffers(struct d3d12_swapchain *swapc
     for (i = 0; i < swapchain->buffer_count; i++)
     {
         image_view_info.image = swapchain->vk_swapchain_images[i];
-        if ((vr = VK_CALL(vkCreateImageView(vk_device, &image_view_info, NULL, &swapchain->vk_swapchain_image_views[i]))))
+        if ((vr = VK_CALL(vkCreateImageView(vk_device, &image_view_info, &vkd3d_vk_allocator, &swapchain->vk_swapchain_image_views[i]))))
             return hresult_from_vk_result(vr);
         fb_info.pAttachments = &swapchain->vk_swapchain_image_views[i];
-        if ((vr = VK_CALL(vkCreateFramebuffer(vk_device, &fb_info, NULL, &swapchain->vk_framebuffers[i]))))
+        if ((vr = VK_CALL(vkCreateFramebuffer(vk_device, &fb_info, &vkd3d_vk_allocator, &swapchain->vk_framebuffers[i]))))
             return hresult_from_vk_result(vr);
     }
 
@@ -1147,7 +1147,7 @@ static HRESULT d3d12_swapchain_prepare_command_buffers(struct d3d12_swapchain *s
 
     assert(swapchain->vk_cmd_pool == VK_NULL_HANDLE);
     if ((vr = VK_CALL(vkCreateCommandPool(vk_device, &pool_info,
-            NULL, &swapchain->vk_cmd_pool))) < 0)
+            &vkd3d_vk_allocator, &swapchain->vk_cmd_pool))) < 0)
     {
         WARN("Failed to create command pool, vr %d.\n", vr);
         swapchain->vk_cmd_pool = VK_NULL_HANDLE;
@@ -1183,7 +1183,7 @@ static HRESULT d3d12_swapchain_prepare_command_buffers(struct d3d12_swapchain *s
 
         assert(swapchain->vk_acquire_semaphores[i] == VK_NULL_HANDLE);
         if ((vr = VK_CALL(vkCreateSemaphore(vk_device, &semaphore_info,
-                NULL, &swapchain->vk_acquire_semaphores[i]))) < 0)
+                &vkd3d_vk_allocator, &swapchain->vk_acquire_semaphores[i]))) < 0)
         {
             WARN("Failed to create semaphore, vr %d.\n", vr);
             swapchain->vk_acquire_semaphores[i] = VK_NULL_HANDLE;
@@ -1192,7 +1192,7 @@ static HRESULT d3d12_swapchain_prepare_command_buffers(struct d3d12_swapchain *s
 
         assert(swapchain->vk_present_semaphores[i] == VK_NULL_HANDLE);
         if ((vr = VK_CALL(vkCreateSemaphore(vk_device, &semaphore_info,
-                NULL, &swapchain->vk_present_semaphores[i]))) < 0)
+                &vkd3d_vk_allocator, &swapchain->vk_present_semaphores[i]))) < 0)
         {
             WARN("Failed to create semaphore, vr %d.\n", vr);
             swapchain->vk_present_semaphores[i] = VK_NULL_HANDLE;
@@ -1201,7 +1201,7 @@ static HRESULT d3d12_swapchain_prepare_command_buffers(struct d3d12_swapchain *s
 
         assert(swapchain->vk_blit_fences[i] == VK_NULL_HANDLE);
         if ((vr = VK_CALL(vkCreateFence(vk_device, &fence_info,
-                NULL, &swapchain->vk_blit_fences[i]))) < 0)
+                &vkd3d_vk_allocator, &swapchain->vk_blit_fences[i]))) < 0)
         {
             WARN("Failed to create fence, vr %d.\n", vr);
             swapchain->vk_blit_fences[i] = VK_NULL_HANDLE;
@@ -1283,7 +1283,7 @@ static VkResult d3d12_swapchain_unsignal_acquire_semaphore(struct d3d12_swapchai
         fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
         fence_create_info.pNext = NULL;
         fence_create_info.flags = 0;
-        if ((vr = VK_CALL(vkCreateFence(vk_device, &fence_create_info, NULL, &vk_fence))))
+        if ((vr = VK_CALL(vkCreateFence(vk_device, &fence_create_info, &vkd3d_vk_allocator, &vk_fence))))
         {
             ERR("Failed to create fence, vr %d\n", vr);
             return vr;
@@ -1310,7 +1310,7 @@ static VkResult d3d12_swapchain_unsignal_acquire_semaphore(struct d3d12_swapchai
             ERR("Failed to wait for fences, vr %d\n", vr);
 
 end:
-    VK_CALL(vkDestroyFence(vk_device, vk_fence, NULL));
+    VK_CALL(vkDestroyFence(vk_device, vk_fence, &vkd3d_vk_allocator));
     return vr;
 }
 
@@ -1358,17 +1358,17 @@ static void d3d12_swapchain_destroy_buffers(struct d3d12_swapchain *swapchain, B
     {
         for (i = 0; i < swapchain->buffer_count; ++i)
         {
-            VK_CALL(vkDestroySemaphore(swapchain->command_queue->device->vk_device, swapchain->vk_acquire_semaphores[i], NULL));
+            VK_CALL(vkDestroySemaphore(swapchain->command_queue->device->vk_device, swapchain->vk_acquire_semaphores[i], &vkd3d_vk_allocator));
             swapchain->vk_acquire_semaphores[i] = VK_NULL_HANDLE;
             swapchain->vk_acquire_semaphores_signaled[i] = false;
 
-            VK_CALL(vkDestroySemaphore(swapchain->command_queue->device->vk_device, swapchain->vk_present_semaphores[i], NULL));
+            VK_CALL(vkDestroySemaphore(swapchain->command_queue->device->vk_device, swapchain->vk_present_semaphores[i], &vkd3d_vk_allocator));
             swapchain->vk_present_semaphores[i] = VK_NULL_HANDLE;
 
-            VK_CALL(vkDestroyFence(swapchain->command_queue->device->vk_device, swapchain->vk_blit_fences[i], NULL));
+            VK_CALL(vkDestroyFence(swapchain->command_queue->device->vk_device, swapchain->vk_blit_fences[i], &vkd3d_vk_allocator));
             swapchain->vk_blit_fences[i] = VK_NULL_HANDLE;
         }
-        VK_CALL(vkDestroyCommandPool(swapchain->command_queue->device->vk_device, swapchain->vk_cmd_pool, NULL));
+        VK_CALL(vkDestroyCommandPool(swapchain->command_queue->device->vk_device, swapchain->vk_cmd_pool, &vkd3d_vk_allocator));
         swapchain->vk_cmd_pool = VK_NULL_HANDLE;
     }
 }
@@ -1487,7 +1487,7 @@ static HRESULT d3d12_swapchain_create_vulkan_swapchain(struct d3d12_swapchain *s
      * the swapchain up front. */
     if (swapchain->vk_swapchain)
     {
-        VK_CALL(vkDestroySwapchainKHR(swapchain->command_queue->device->vk_device, swapchain->vk_swapchain, NULL));
+        VK_CALL(vkDestroySwapchainKHR(swapchain->command_queue->device->vk_device, swapchain->vk_swapchain, &vkd3d_vk_allocator));
         swapchain->vk_swapchain = VK_NULL_HANDLE;
     }
 
@@ -1512,7 +1512,7 @@ static HRESULT d3d12_swapchain_create_vulkan_swapchain(struct d3d12_swapchain *s
         vk_swapchain_desc.presentMode = swapchain->present_mode;
         vk_swapchain_desc.clipped = VK_TRUE;
         vk_swapchain_desc.oldSwapchain = swapchain->vk_swapchain;
-        if ((vr = VK_CALL(vkCreateSwapchainKHR(vk_device, &vk_swapchain_desc, NULL, &vk_swapchain))) < 0)
+        if ((vr = VK_CALL(vkCreateSwapchainKHR(vk_device, &vk_swapchain_desc, &vkd3d_vk_allocator, &vk_swapchain))) < 0)
         {
             WARN("Failed to create Vulkan swapchain, vr %d.\n", vr);
             return hresult_from_vk_result(vr);
@@ -1619,9 +1619,9 @@ static void d3d12_swapchain_destroy(struct d3d12_swapchain *swapchain)
     vkd3d_private_store_destroy(&swapchain->private_store);
 
     if (swapchain->command_queue->device->vk_device)
-        VK_CALL(vkDestroySwapchainKHR(swapchain->command_queue->device->vk_device, swapchain->vk_swapchain, NULL));
+        VK_CALL(vkDestroySwapchainKHR(swapchain->command_queue->device->vk_device, swapchain->vk_swapchain, &vkd3d_vk_allocator));
 
-    VK_CALL(vkDestroySurfaceKHR(d3d12_swapchain_device(swapchain)->vkd3d_instance->vk_instance, swapchain->vk_surface, NULL));
+    VK_CALL(vkDestroySurfaceKHR(d3d12_swapchain_device(swapchain)->vkd3d_instance->vk_instance, swapchain->vk_surface, &vkd3d_vk_allocator));
 
     if (swapchain->target)
     {
@@ -1706,7 +1706,7 @@ static HRESULT STDMETHODCALLTYPE d3d12_swapchain_GetDevice(dxgi_swapchain_iface
 
     TRACE("iface %p, iid %s, device %p.\n", iface, debugstr_guid(iid), device);
 
-    return ID3D12Device6_QueryInterface(d3d12_swapchain_device_iface(swapchain), iid, device);
+    return ID3D12Device7_QueryInterface(d3d12_swapchain_device_iface(swapchain), iid, device);
 }
 
 /* IDXGISwapChain methods */
@@ -1920,6 +1920,8 @@ static HRESULT d3d12_swapchain_present(struct d3d12_swapchain *swapchain,
     if (flags & DXGI_PRESENT_TEST)
         return S_OK;
 
+    vkd3d_vk_call_profiling_sample("Present");
+
     if (FAILED(hr = d3d12_swapchain_set_sync_interval(swapchain, sync_interval)))
         return hr;
 
@@ -2789,7 +2791,7 @@ static HRESULT d3d12_swapchain_init(struct d3d12_swapchain *swapchain, IDXGIFact
     surface_desc.flags = 0;
     surface_desc.hinstance = GetModuleHandleA("d3d12.dll");
     surface_desc.hwnd = window;
-    if ((vr = VK_CALL(vkCreateWin32SurfaceKHR(vk_instance, &surface_desc, NULL, &vk_surface))) < 0)
+    if ((vr = VK_CALL(vkCreateWin32SurfaceKHR(vk_instance, &surface_desc, &vkd3d_vk_allocator, &vk_surface))) < 0)
     {
         WARN("Failed to create Vulkan surface, vr %d.\n", vr);
         d3d12_swapchain_destroy(swapchain);
@@ -2827,7 +2829,7 @@ static HRESULT d3d12_swapchain_init(struct d3d12_swapchain *swapchain, IDXGIFact
     if (swapchain_desc->Flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT)
         swapchain->frame_latency = 1;
 
-    if (FAILED(hr = ID3D12Device6_CreateFence(d3d12_swapchain_device_iface(swapchain), DXGI_MAX_SWAP_CHAIN_BUFFERS,
+    if (FAILED(hr = ID3D12Device7_CreateFence(d3d12_swapchain_device_iface(swapchain), DXGI_MAX_SWAP_CHAIN_BUFFERS,
             0, &IID_ID3D12Fence, (void **)&swapchain->frame_latency_fence)))
     {
         WARN("Failed to create frame latency fence, hr %#x.\n", hr);
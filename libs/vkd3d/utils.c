@@ -273,90 +273,164 @@ static bool dxgi_format_is_depth_stencil(DXGI_FORMAT dxgi_format)
     return false;
 }
 
-/* FIXME: This table should be generated at compile-time. */
+/* Additional view formats, either for a single format or for every format of a
+ * typeless family. R11G11B10_FLOAT has no UINT format in its family but is cleared
+ * through a UINT view, see vkd3d_fixup_clear_uav_uint_color(). The R32 and small
+ * typeless aliases are used as attachment formats for shader-based copies from
+ * depth-stencil images. Other 32bpp typeless resources may be accessed through
+ * R32_UINT, R32_SINT and R32_FLOAT UAVs, but that only applies to the typeless
+ * format itself. */
+static const struct vkd3d_format_view_alias
+{
+    DXGI_FORMAT format;
+    DXGI_FORMAT view_format;
+    bool family;
+}
+vkd3d_format_view_aliases[] =
+{
+    {DXGI_FORMAT_R11G11B10_FLOAT,       DXGI_FORMAT_R32_UINT,  true},
+    {DXGI_FORMAT_R32_TYPELESS,          DXGI_FORMAT_R32_FLOAT, true},
+    {DXGI_FORMAT_R16_TYPELESS,          DXGI_FORMAT_R16_UNORM, true},
+    {DXGI_FORMAT_R8_TYPELESS,           DXGI_FORMAT_R8_UINT,   true},
+    {DXGI_FORMAT_R10G10B10A2_TYPELESS,  DXGI_FORMAT_R32_UINT},
+    {DXGI_FORMAT_R10G10B10A2_TYPELESS,  DXGI_FORMAT_R32_SINT},
+    {DXGI_FORMAT_R10G10B10A2_TYPELESS,  DXGI_FORMAT_R32_FLOAT},
+    {DXGI_FORMAT_R8G8B8A8_TYPELESS,     DXGI_FORMAT_R32_UINT},
+    {DXGI_FORMAT_R8G8B8A8_TYPELESS,     DXGI_FORMAT_R32_SINT},
+    {DXGI_FORMAT_R8G8B8A8_TYPELESS,     DXGI_FORMAT_R32_FLOAT},
+    {DXGI_FORMAT_R16G16_TYPELESS,       DXGI_FORMAT_R32_UINT},
+    {DXGI_FORMAT_R16G16_TYPELESS,       DXGI_FORMAT_R32_SINT},
+    {DXGI_FORMAT_R16G16_TYPELESS,       DXGI_FORMAT_R32_FLOAT},
+    {DXGI_FORMAT_B8G8R8A8_TYPELESS,     DXGI_FORMAT_R32_UINT},
+    {DXGI_FORMAT_B8G8R8A8_TYPELESS,     DXGI_FORMAT_R32_SINT},
+    {DXGI_FORMAT_B8G8R8A8_TYPELESS,     DXGI_FORMAT_R32_FLOAT},
+    {DXGI_FORMAT_B8G8R8X8_TYPELESS,     DXGI_FORMAT_R32_UINT},
+    {DXGI_FORMAT_B8G8R8X8_TYPELESS,     DXGI_FORMAT_R32_SINT},
+    {DXGI_FORMAT_B8G8R8X8_TYPELESS,     DXGI_FORMAT_R32_FLOAT},
+};
+
+static bool vkd3d_format_is_uint(DXGI_FORMAT dxgi_format)
+{
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(vkd3d_formats); ++i)
+    {
+        if (vkd3d_formats[i].dxgi_format == dxgi_format)
+            return vkd3d_formats[i].type == VKD3D_FORMAT_TYPE_UINT;
+    }
+
+    return false;
+}
+
+static void vkd3d_format_compatibility_list_add(struct vkd3d_format_compatibility_list *list,
+        DXGI_FORMAT dxgi_format)
+{
+    VkFormat vk_format;
+    unsigned int i;
+
+    /* In Vulkan, each depth-stencil format is only compatible with itself. */
+    if (dxgi_format_is_depth_stencil(dxgi_format))
+        return;
+
+    if (!(vk_format = vkd3d_get_vk_format(dxgi_format)))
+        return;
+
+    for (i = 0; i < list->format_count; ++i)
+    {
+        if (list->vk_formats[i] == vk_format)
+            return;
+    }
+
+    assert(list->format_count < VKD3D_MAX_COMPATIBLE_FORMAT_COUNT);
+    list->vk_formats[list->format_count++] = vk_format;
+}
+
+/* Builds the list of view formats for each resource format. Typeless resources
+ * can be viewed with any format of their family. Fully typed resources can only
+ * be viewed with their own format in D3D12, but typed UAV clears go through the
+ * UINT format of the family, and a few internal copies need other aliases. */
 static HRESULT vkd3d_init_format_compatibility_lists(struct d3d12_device *device)
 {
-    struct vkd3d_format_compatibility_list *lists, *current_list;
     const struct vkd3d_format_compatibility_info *current;
-    DXGI_FORMAT dxgi_format;
-    VkFormat vk_format;
-    unsigned int count;
+    struct vkd3d_format_compatibility_list *lists;
+    DXGI_FORMAT uint_format;
     unsigned int i, j;
 
-    device->format_compatibility_list_count = 0;
     device->format_compatibility_lists = NULL;
 
     if (!device->vk_info.KHR_image_format_list)
         return S_OK;
 
-    count = 1;
-    dxgi_format = vkd3d_format_compatibility_info[0].typeless_format;
-    for (i = 0; i < ARRAY_SIZE(vkd3d_format_compatibility_info); ++i)
-    {
-        DXGI_FORMAT typeless_format = vkd3d_format_compatibility_info[i].typeless_format;
+    if (!(lists = vkd3d_calloc(VKD3D_MAX_DXGI_FORMAT + 1, sizeof(*lists))))
+        return E_OUTOFMEMORY;
 
-        if (dxgi_format != typeless_format)
-        {
-            ++count;
-            dxgi_format = typeless_format;
-        }
+    for (i = 0; i < ARRAY_SIZE(vkd3d_formats); ++i)
+    {
+        assert(vkd3d_formats[i].dxgi_format <= VKD3D_MAX_DXGI_FORMAT);
+        vkd3d_format_compatibility_list_add(&lists[vkd3d_formats[i].dxgi_format], vkd3d_formats[i].dxgi_format);
     }
 
-    if (!(lists = vkd3d_calloc(count, sizeof(*lists))))
-        return E_OUTOFMEMORY;
-
-    count = 0;
-    current_list = lists;
-    current_list->typeless_format = vkd3d_format_compatibility_info[0].typeless_format;
     for (i = 0; i < ARRAY_SIZE(vkd3d_format_compatibility_info); ++i)
     {
         current = &vkd3d_format_compatibility_info[i];
+        vkd3d_format_compatibility_list_add(&lists[current->typeless_format], current->format);
 
-        if (current_list->typeless_format != current->typeless_format)
+        if (dxgi_format_is_depth_stencil(current->format))
+            continue;
+
+        uint_format = DXGI_FORMAT_UNKNOWN;
+        for (j = 0; j < ARRAY_SIZE(vkd3d_format_compatibility_info); ++j)
         {
-            /* Avoid empty format lists. */
-            if (current_list->format_count)
+            if (vkd3d_format_compatibility_info[j].typeless_format == current->typeless_format &&
+                    vkd3d_format_is_uint(vkd3d_format_compatibility_info[j].format))
             {
-                ++current_list;
-                ++count;
+                uint_format = vkd3d_format_compatibility_info[j].format;
+                break;
             }
-
-            current_list->typeless_format = current->typeless_format;
         }
 
-        /* In Vulkan, each depth-stencil format is only compatible with itself. */
-        if (dxgi_format_is_depth_stencil(current->format))
-            continue;
+        if (uint_format)
+            vkd3d_format_compatibility_list_add(&lists[current->format], uint_format);
+    }
 
-        if (!(vk_format = vkd3d_get_vk_format(current->format)))
-            continue;
+    for (i = 0; i < ARRAY_SIZE(vkd3d_format_view_aliases); ++i)
+    {
+        const struct vkd3d_format_view_alias *alias = &vkd3d_format_view_aliases[i];
 
-        for (j = 0; j < current_list->format_count; ++j)
-        {
-            if (current_list->vk_formats[j] == vk_format)
-                break;
-        }
+        vkd3d_format_compatibility_list_add(&lists[alias->format], alias->view_format);
+
+        if (!alias->family)
+            continue;
 
-        if (j >= current_list->format_count)
+        for (j = 0; j < ARRAY_SIZE(vkd3d_format_compatibility_info); ++j)
         {
-            assert(current_list->format_count < VKD3D_MAX_COMPATIBLE_FORMAT_COUNT);
-            current_list->vk_formats[current_list->format_count++] = vk_format;
+            current = &vkd3d_format_compatibility_info[j];
+            if (current->typeless_format == alias->format && !dxgi_format_is_depth_stencil(current->format))
+                vkd3d_format_compatibility_list_add(&lists[current->format], alias->view_format);
         }
     }
-    if (current_list->format_count)
-        ++count;
 
-    device->format_compatibility_list_count = count;
     device->format_compatibility_lists = lists;
     return S_OK;
 }
 
+const struct vkd3d_format_compatibility_list *vkd3d_get_format_compatibility_list(
+        const struct d3d12_device *device, DXGI_FORMAT dxgi_format)
+{
+    const struct vkd3d_format_compatibility_list *list;
+
+    if (!device->format_compatibility_lists || dxgi_format > VKD3D_MAX_DXGI_FORMAT)
+        return NULL;
+
+    list = &device->format_compatibility_lists[dxgi_format];
+    return list->format_count ? list : NULL;
+}
+
 static void vkd3d_cleanup_format_compatibility_lists(struct d3d12_device *device)
 {
     vkd3d_free((void *)device->format_compatibility_lists);
 
     device->format_compatibility_lists = NULL;
-    device->format_compatibility_list_count = 0;
 }
 
 static HRESULT vkd3d_init_depth_stencil_formats(struct d3d12_device *device)
@@ -1085,6 +1159,179 @@ HRESULT vkd3d_load_vk_device_procs(struct vkd3d_vk_device_procs *procs,
     return S_OK;
 }
 
+#if defined(VKD3D_ENABLE_PROFILING) && defined(__GNUC__)
+#define DECLARE_VK_ENTRY_NAME(name) #name,
+static const char * const vkd3d_vk_entry_names[] =
+{
+    NULL, /* 0 is reserved for unresolved call sites. */
+    "Unknown",
+    "vkCreateInstance",
+    "vkEnumerateInstanceVersion",
+    "vkEnumerateInstanceExtensionProperties",
+    "vkEnumerateInstanceLayerProperties",
+    "vkGetInstanceProcAddr",
+#define VK_INSTANCE_PFN     DECLARE_VK_ENTRY_NAME
+#define VK_INSTANCE_EXT_PFN DECLARE_VK_ENTRY_NAME
+#define VK_DEVICE_PFN       DECLARE_VK_ENTRY_NAME
+#define VK_DEVICE_EXT_PFN   DECLARE_VK_ENTRY_NAME
+#include "vulkan_procs.h"
+};
+#undef DECLARE_VK_ENTRY_NAME
+
+struct vkd3d_vk_call_counter
+{
+    uint64_t call_count;
+    uint64_t ticks;
+    uint64_t published_call_count;
+    uint32_t latch;
+    spinlock_t lock;
+};
+
+struct vkd3d_vk_call_interval
+{
+    const char *name;
+    uint64_t sample_count;
+    uint64_t published_sample_count;
+    uint32_t latch;
+    spinlock_t lock;
+};
+
+static struct vkd3d_vk_call_counter vkd3d_vk_call_counters[ARRAY_SIZE(vkd3d_vk_entry_names)];
+static struct vkd3d_vk_call_interval vkd3d_vk_call_intervals[4];
+static spinlock_t vkd3d_vk_call_sample_lock;
+static UINT64 vkd3d_vk_call_first_sample_ticks;
+
+uint32_t vkd3d_vk_call_lookup_entry(uint32_t *latch, const char *call)
+{
+    size_t length, i;
+    uint32_t entry;
+
+    /* The call is the stringified VK_CALL() argument, e.g. "vkCmdDraw(cmd, 3, 1, 0, 0)". */
+    for (length = 0; call[length] && call[length] != '(' && call[length] != ' '; length++)
+        ;
+
+    entry = 1;
+    for (i = 2; i < ARRAY_SIZE(vkd3d_vk_entry_names); i++)
+    {
+        if (!strncmp(vkd3d_vk_entry_names[i], call, length) && !vkd3d_vk_entry_names[i][length])
+        {
+            entry = i;
+            break;
+        }
+    }
+
+    vkd3d_atomic_uint32_store_explicit(latch, entry, vkd3d_memory_order_release);
+    return entry;
+}
+
+void vkd3d_vk_call_scope_end(struct vkd3d_vk_call_scope *scope)
+{
+    struct vkd3d_vk_call_counter *counter;
+    uint64_t end_ticks;
+
+    if (!scope->entry)
+        return;
+
+    end_ticks = vkd3d_profiling_get_tick_count();
+    counter = &vkd3d_vk_call_counters[scope->entry];
+    vkd3d_atomic_uint64_increment(&counter->call_count, vkd3d_memory_order_relaxed);
+    vkd3d_atomic_uint64_add(&counter->ticks, end_ticks - scope->begin_ticks, vkd3d_memory_order_relaxed);
+}
+
+static void vkd3d_vk_call_profiling_publish(const char *prefix, const char *name,
+        spinlock_t *lock, uint32_t *latch, uint64_t value, uint64_t count)
+{
+    unsigned int index;
+    char region[64];
+
+    if (!(index = vkd3d_atomic_uint32_load_explicit(latch, vkd3d_memory_order_acquire)))
+    {
+        snprintf(region, sizeof(region), "%s: %s", prefix, name);
+        if (!(index = vkd3d_profiling_register_region(region, lock, latch)))
+            return;
+    }
+
+    vkd3d_profiling_set_counter(index, value, count);
+}
+
+static struct vkd3d_vk_call_interval *vkd3d_vk_call_lookup_interval(const char *interval)
+{
+    const char *name;
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(vkd3d_vk_call_intervals); i++)
+    {
+        /* Claim the first free slot, another thread may race us for it. */
+        if (!(name = vkd3d_atomic_ptr_load_explicit(&vkd3d_vk_call_intervals[i].name, vkd3d_memory_order_acquire)))
+        {
+            if (!(name = vkd3d_atomic_ptr_compare_exchange(&vkd3d_vk_call_intervals[i].name, NULL, interval,
+                    vkd3d_memory_order_acq_rel, vkd3d_memory_order_acquire)))
+                return &vkd3d_vk_call_intervals[i];
+        }
+
+        if (!strcmp(name, interval))
+            return &vkd3d_vk_call_intervals[i];
+    }
+
+    return NULL;
+}
+
+void vkd3d_vk_call_profiling_sample(const char *interval)
+{
+    struct vkd3d_vk_call_interval *sample_interval;
+    struct vkd3d_vk_call_counter *counter;
+    uint64_t call_count, sample_count;
+    uint64_t ticks, first_ticks;
+    size_t i;
+
+    if (!vkd3d_uses_profiling())
+        return;
+
+    /* Every sample is counted, even when another thread is publishing. */
+    ticks = vkd3d_profiling_get_tick_count();
+    vkd3d_atomic_uint64_compare_exchange(&vkd3d_vk_call_first_sample_ticks, 0, ticks,
+            vkd3d_memory_order_relaxed, vkd3d_memory_order_relaxed);
+    if ((sample_interval = vkd3d_vk_call_lookup_interval(interval)))
+        vkd3d_atomic_uint64_increment(&sample_interval->sample_count, vkd3d_memory_order_relaxed);
+
+    /* Counters are cumulative, so if another thread is already publishing
+     * we can skip publishing, the next sample picks up our counts. */
+    if (!spinlock_try_acquire(&vkd3d_vk_call_sample_lock))
+        return;
+
+    first_ticks = vkd3d_atomic_uint64_load_explicit(&vkd3d_vk_call_first_sample_ticks, vkd3d_memory_order_relaxed);
+
+    /* Intervals count samples, the value is the wall time since the first sample
+     * so that it can be displayed as time per interval as well. */
+    for (i = 0; i < ARRAY_SIZE(vkd3d_vk_call_intervals); i++)
+    {
+        sample_interval = &vkd3d_vk_call_intervals[i];
+        sample_count = vkd3d_atomic_uint64_load_explicit(&sample_interval->sample_count, vkd3d_memory_order_relaxed);
+        if (sample_count == sample_interval->published_sample_count)
+            continue;
+
+        vkd3d_vk_call_profiling_publish("vk interval", sample_interval->name,
+                &sample_interval->lock, &sample_interval->latch, max(ticks - first_ticks, 1), sample_count);
+        sample_interval->published_sample_count = sample_count;
+    }
+
+    for (i = 1; i < ARRAY_SIZE(vkd3d_vk_call_counters); i++)
+    {
+        counter = &vkd3d_vk_call_counters[i];
+        call_count = vkd3d_atomic_uint64_load_explicit(&counter->call_count, vkd3d_memory_order_relaxed);
+        if (call_count == counter->published_call_count)
+            continue;
+
+        vkd3d_vk_call_profiling_publish("vk", vkd3d_vk_entry_names[i], &counter->lock, &counter->latch,
+                max(vkd3d_atomic_uint64_load_explicit(&counter->ticks, vkd3d_memory_order_relaxed), 1),
+                call_count);
+        counter->published_call_count = call_count;
+    }
+
+    spinlock_release(&vkd3d_vk_call_sample_lock);
+}
+#endif
+
 static struct vkd3d_private_data *vkd3d_private_store_get_private_data(
         const struct vkd3d_private_store *store, const GUID *tag)
 {
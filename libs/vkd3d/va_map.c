@@ -247,19 +247,19 @@ const struct vkd3d_unique_resource *vkd3d_va_map_deref(struct vkd3d_va_map *va_m
     return vkd3d_va_map_deref_mutable(va_map, va);
 }
 
-VkAccelerationStructureKHR vkd3d_va_map_place_acceleration_structure(struct vkd3d_va_map *va_map,
+struct vkd3d_view *vkd3d_va_map_place_acceleration_structure(struct vkd3d_va_map *va_map,
         struct d3d12_device *device,
-        VkDeviceAddress va)
+        VkDeviceAddress va, VkDeviceSize size)
 {
     struct vkd3d_unique_resource *resource;
     struct vkd3d_view_map *old_view_map;
     struct vkd3d_view_map *view_map;
-    const struct vkd3d_view *view;
+    struct vkd3d_view *view;
     struct vkd3d_view_key key;
 
     resource = vkd3d_va_map_deref_mutable(va_map, va);
     if (!resource || !resource->va)
-        return VK_NULL_HANDLE;
+        return NULL;
 
     view_map = vkd3d_atomic_ptr_load_explicit(&resource->view_map, vkd3d_memory_order_acquire);
     if (!view_map)
@@ -268,12 +268,12 @@ VkAccelerationStructureKHR vkd3d_va_map_place_acceleration_structure(struct vkd3
          * CAS in a pointer. */
         view_map = vkd3d_malloc(sizeof(*view_map));
         if (!view_map)
-            return VK_NULL_HANDLE;
+            return NULL;
 
         if (FAILED(vkd3d_view_map_init(view_map)))
         {
             vkd3d_free(view_map);
-            return VK_NULL_HANDLE;
+            return NULL;
         }
 
         /* Need to release in case other RTASes are placed at the same time, so they observe
@@ -294,10 +294,9 @@ VkAccelerationStructureKHR vkd3d_va_map_place_acceleration_structure(struct vkd3
     key.u.buffer.size = resource->size - key.u.buffer.offset;
     key.u.buffer.format = NULL;
 
-    view = vkd3d_view_map_create_view(view_map, device, &key);
-    if (!view)
-        return VK_NULL_HANDLE;
-    return view->vk_acceleration_structure;
+    /* Engines which rebuild acceleration structures into a ring buffer place them at ever
+     * shifting offsets, drop the views of acceleration structures which got overwritten. */
+    return vkd3d_view_map_place_view(view_map, device, &key, size);
 }
 
 #define VKD3D_FAKE_VA_ALIGNMENT (65536)
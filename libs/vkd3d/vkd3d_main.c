@@ -21,6 +21,92 @@
 #define INITGUID
 #include "vkd3d_private.h"
 
+static void * VKAPI_PTR vkd3d_vk_allocation(void *userdata, size_t size,
+        size_t alignment, VkSystemAllocationScope scope)
+{
+    return vkd3d_allocate(size, alignment, false, VKD3D_MEMORY_TAG_VULKAN);
+}
+
+static void * VKAPI_PTR vkd3d_vk_reallocation(void *userdata, void *original, size_t size,
+        size_t alignment, VkSystemAllocationScope scope)
+{
+    if (!size)
+    {
+        vkd3d_deallocate(original);
+        return NULL;
+    }
+
+    return vkd3d_reallocate(original, size, alignment, VKD3D_MEMORY_TAG_VULKAN);
+}
+
+static void VKAPI_PTR vkd3d_vk_free(void *userdata, void *ptr)
+{
+    vkd3d_deallocate(ptr);
+}
+
+const VkAllocationCallbacks vkd3d_vk_allocator =
+{
+    NULL,
+    vkd3d_vk_allocation,
+    vkd3d_vk_reallocation,
+    vkd3d_vk_free,
+    NULL,
+    NULL,
+};
+
+static VkAllocationCallbacks vkd3d_app_allocator;
+
+static void *vkd3d_app_allocate(void *userdata, size_t size, bool zero)
+{
+    void *ptr;
+
+    ptr = vkd3d_app_allocator.pfnAllocation(vkd3d_app_allocator.pUserData, size,
+            2 * sizeof(void *), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+    if (ptr && zero)
+        memset(ptr, 0, size);
+    return ptr;
+}
+
+static void *vkd3d_app_reallocate(void *userdata, void *ptr, size_t size)
+{
+    return vkd3d_app_allocator.pfnReallocation(vkd3d_app_allocator.pUserData, ptr, size,
+            2 * sizeof(void *), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+}
+
+static void vkd3d_app_free(void *userdata, void *ptr)
+{
+    vkd3d_app_allocator.pfnFree(vkd3d_app_allocator.pUserData, ptr);
+}
+
+VKD3D_EXPORT HRESULT vkd3d_set_host_allocator(const VkAllocationCallbacks *allocator)
+{
+    static const struct vkd3d_host_allocator app_allocator =
+    {
+        vkd3d_app_allocate,
+        vkd3d_app_reallocate,
+        vkd3d_app_free,
+        NULL,
+    };
+    VkAllocationCallbacks previous_allocator;
+
+    TRACE("allocator %p.\n", allocator);
+
+    if (allocator && (!allocator->pfnAllocation || !allocator->pfnReallocation || !allocator->pfnFree))
+        return E_INVALIDARG;
+
+    previous_allocator = vkd3d_app_allocator;
+    if (allocator)
+        vkd3d_app_allocator = *allocator;
+
+    if (!vkd3d_set_host_allocator_backend(allocator ? &app_allocator : NULL))
+    {
+        vkd3d_app_allocator = previous_allocator;
+        return E_FAIL;
+    }
+
+    return S_OK;
+}
+
 VKD3D_EXPORT HRESULT vkd3d_create_device(const struct vkd3d_device_create_info *create_info,
         REFIID iid, void **device)
 {
@@ -60,17 +146,18 @@ VKD3D_EXPORT HRESULT vkd3d_create_device(const struct vkd3d_device_create_info *
         return E_FAIL;
     }
 
+    if (!device)
+    {
+        hr = d3d12_device_probe(instance, create_info);
+        vkd3d_instance_decref(instance);
+        return SUCCEEDED(hr) ? S_FALSE : hr;
+    }
+
     hr = d3d12_device_create(instance, create_info, &object);
     vkd3d_instance_decref(instance);
     if (FAILED(hr))
         return hr;
 
-    if (!device)
-    {
-        ID3D12Device_Release(&object->ID3D12Device_iface);
-        return S_FALSE;
-    }
-
     return return_interface(&object->ID3D12Device_iface, &IID_ID3D12Device, iid, device);
 }
 
@@ -35,6 +35,9 @@
 #include "vkd3d_shader.h"
 #include "vkd3d_threads.h"
 #include "vkd3d_platform.h"
+#include "vkd3d_queue_ownership.h"
+#include "vkd3d_tile_map.h"
+#include "vkd3d_barrier.h"
 #include "vkd3d_swapchain_factory.h"
 #include "vkd3d_command_list_vkd3d_ext.h"
 #include "vkd3d_device_vkd3d_ext.h"
@@ -44,11 +47,51 @@
 #include <limits.h>
 #include <stdbool.h>
 
+#if defined(VKD3D_ENABLE_PROFILING) && defined(__GNUC__)
+/* In profiling builds, every Vulkan call is counted and timed per entry point.
+ * The entry point is resolved by name once per call site and cached in a latch. */
+struct vkd3d_vk_call_scope
+{
+    uint32_t entry;
+    uint64_t begin_ticks;
+};
+
+uint32_t vkd3d_vk_call_lookup_entry(uint32_t *latch, const char *call);
+void vkd3d_vk_call_scope_end(struct vkd3d_vk_call_scope *scope);
+void vkd3d_vk_call_profiling_sample(const char *interval);
+
+static inline struct vkd3d_vk_call_scope vkd3d_vk_call_scope_begin(uint32_t *latch, const char *call)
+{
+    struct vkd3d_vk_call_scope scope;
+
+    scope.entry = 0;
+    scope.begin_ticks = 0;
+
+    if (!vkd3d_uses_profiling())
+        return scope;
+
+    if (!(scope.entry = vkd3d_atomic_uint32_load_explicit(latch, vkd3d_memory_order_acquire)))
+        scope.entry = vkd3d_vk_call_lookup_entry(latch, call);
+    scope.begin_ticks = vkd3d_profiling_get_tick_count();
+    return scope;
+}
+
+#define VK_CALL(f) __extension__ ({ \
+        static uint32_t _vkd3d_vk_call_latch; \
+        struct vkd3d_vk_call_scope _vkd3d_vk_call_scope __attribute__((cleanup(vkd3d_vk_call_scope_end))) = \
+                vkd3d_vk_call_scope_begin(&_vkd3d_vk_call_latch, #f); \
+        (vk_procs->f); })
+#else
 #define VK_CALL(f) (vk_procs->f)
 
+static inline void vkd3d_vk_call_profiling_sample(const char *interval)
+{
+}
+#endif
+
 #define MAKE_MAGIC(a,b,c,d) (((uint32_t)a) | (((uint32_t)b) << 8) | (((uint32_t)c) << 16) | (((uint32_t)d) << 24))
 
-#define VKD3D_MAX_COMPATIBLE_FORMAT_COUNT 6u
+#define VKD3D_MAX_COMPATIBLE_FORMAT_COUNT 9u
 #define VKD3D_MAX_SHADER_EXTENSIONS       3u
 #define VKD3D_MAX_SHADER_STAGES           5u
 #define VKD3D_MAX_VK_SYNC_OBJECTS         4u
@@ -123,6 +166,7 @@ struct vkd3d_vulkan_info
     bool KHR_sampler_mirror_clamp_to_edge;
     bool KHR_separate_depth_stencil_layouts;
     bool KHR_shader_integer_dot_product;
+    bool KHR_synchronization2;
     /* EXT device extensions */
     bool EXT_calibrated_timestamps;
     bool EXT_conditional_rendering;
@@ -143,6 +187,8 @@ struct vkd3d_vulkan_info
     bool EXT_extended_dynamic_state;
     bool EXT_external_memory_host;
     bool EXT_4444_formats;
+    bool EXT_mesh_shader;
+    bool EXT_pipeline_creation_cache_control;
     /* AMD device extensions */
     bool AMD_buffer_marker;
     bool AMD_shader_core_properties;
@@ -191,6 +237,9 @@ struct vkd3d_instance
 extern uint64_t vkd3d_config_flags;
 extern const struct vkd3d_shader_quirk_info *vkd3d_shader_quirk_info;
 
+/* Routes driver host allocations through the vkd3d host allocator. */
+extern const VkAllocationCallbacks vkd3d_vk_allocator;
+
 union vkd3d_thread_handle
 {
     pthread_t pthread;
@@ -201,12 +250,31 @@ HRESULT vkd3d_create_thread(struct vkd3d_instance *instance,
         PFN_vkd3d_thread thread_main, void *data, union vkd3d_thread_handle *thread);
 HRESULT vkd3d_join_thread(struct vkd3d_instance *instance, union vkd3d_thread_handle *thread);
 
+/* Result of a single join call, mirrors vkDeferredOperationJoinKHR. */
+enum vkd3d_join_status
+{
+    /* The operation has completed. */
+    VKD3D_JOIN_COMPLETE,
+    /* There is no more work for the calling thread, but the operation may still be running. */
+    VKD3D_JOIN_DONE,
+    /* There is no work right now, but there may be more later. */
+    VKD3D_JOIN_IDLE,
+};
+
+typedef enum vkd3d_join_status (*vkd3d_join_func)(void *userdata);
+
+/* Calls func on the current thread and on up to thread_count - 1 helper threads
+ * until each thread has run out of work. Returns the number of threads used. */
+unsigned int vkd3d_parallel_join(struct vkd3d_instance *instance,
+        vkd3d_join_func func, void *userdata, unsigned int thread_count);
+
 struct vkd3d_waiting_fence
 {
     struct d3d12_fence *fence;
     uint64_t value;
 };
 
+/* A single device-wide thread waits for all GPU fence signals at once. */
 struct vkd3d_fence_worker
 {
     union vkd3d_thread_handle thread;
@@ -218,6 +286,12 @@ struct vkd3d_fence_worker
     struct vkd3d_waiting_fence *enqueued_fences;
     size_t enqueued_fences_size;
 
+    /* Signalled from the host to interrupt a wait when new fences are enqueued. */
+    VkSemaphore wake_semaphore;
+    uint64_t wake_value;
+    bool is_waiting;
+    bool wake_pending;
+
     struct d3d12_device *device;
 };
 
@@ -226,6 +300,31 @@ HRESULT vkd3d_fence_worker_start(struct vkd3d_fence_worker *worker,
 HRESULT vkd3d_fence_worker_stop(struct vkd3d_fence_worker *worker,
         struct d3d12_device *device);
 
+struct d3d12_command_queue;
+
+/* Device-wide threads which process the submissions of all command queues.
+ * A queue is on the ready list at most once, so its submissions are
+ * still processed in order by a single thread at a time. */
+struct vkd3d_queue_worker_pool
+{
+    union vkd3d_thread_handle *threads;
+    unsigned int thread_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool should_exit;
+
+    struct d3d12_command_queue **ready_queues;
+    size_t ready_queue_count;
+    size_t ready_queues_size;
+
+    struct d3d12_device *device;
+};
+
+HRESULT vkd3d_queue_worker_pool_init(struct vkd3d_queue_worker_pool *pool,
+        struct d3d12_device *device);
+void vkd3d_queue_worker_pool_cleanup(struct vkd3d_queue_worker_pool *pool,
+        struct d3d12_device *device);
+
 #define VKD3D_VA_BLOCK_SIZE_BITS (20)
 #define VKD3D_VA_BLOCK_SIZE (1ull << VKD3D_VA_BLOCK_SIZE_BITS)
 #define VKD3D_VA_LO_MASK (VKD3D_VA_BLOCK_SIZE - 1)
@@ -290,9 +389,9 @@ struct vkd3d_va_map
 void vkd3d_va_map_insert(struct vkd3d_va_map *va_map, struct vkd3d_unique_resource *resource);
 void vkd3d_va_map_remove(struct vkd3d_va_map *va_map, const struct vkd3d_unique_resource *resource);
 const struct vkd3d_unique_resource *vkd3d_va_map_deref(struct vkd3d_va_map *va_map, VkDeviceAddress va);
-VkAccelerationStructureKHR vkd3d_va_map_place_acceleration_structure(struct vkd3d_va_map *va_map,
+struct vkd3d_view *vkd3d_va_map_place_acceleration_structure(struct vkd3d_va_map *va_map,
         struct d3d12_device *device,
-        VkDeviceAddress va);
+        VkDeviceAddress va, VkDeviceSize size);
 VkDeviceAddress vkd3d_va_map_alloc_fake_va(struct vkd3d_va_map *va_map, VkDeviceSize size);
 void vkd3d_va_map_free_fake_va(struct vkd3d_va_map *va_map, VkDeviceAddress va, VkDeviceSize size);
 void vkd3d_va_map_init(struct vkd3d_va_map *va_map);
@@ -318,27 +417,64 @@ enum vkd3d_render_pass_key_flag
     VKD3D_RENDER_PASS_KEY_DEPTH_WRITE    = (1u << 2),
     VKD3D_RENDER_PASS_KEY_STENCIL_WRITE  = (1u << 3),
     VKD3D_RENDER_PASS_KEY_VRS_ATTACHMENT = (1u << 4),
+    VKD3D_RENDER_PASS_KEY_DEPTH_CLEAR    = (1u << 5),
+    VKD3D_RENDER_PASS_KEY_STENCIL_CLEAR  = (1u << 6),
+    VKD3D_RENDER_PASS_KEY_DEPTH_DISCARD   = (1u << 7),
+    VKD3D_RENDER_PASS_KEY_STENCIL_DISCARD = (1u << 8),
 
     VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_ENABLE = (VKD3D_RENDER_PASS_KEY_DEPTH_ENABLE | VKD3D_RENDER_PASS_KEY_STENCIL_ENABLE),
     VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_WRITE  = (VKD3D_RENDER_PASS_KEY_DEPTH_WRITE  | VKD3D_RENDER_PASS_KEY_STENCIL_WRITE),
+    VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_CLEAR  = (VKD3D_RENDER_PASS_KEY_DEPTH_CLEAR  | VKD3D_RENDER_PASS_KEY_STENCIL_CLEAR),
+    VKD3D_RENDER_PASS_KEY_DEPTH_STENCIL_DISCARD = (VKD3D_RENDER_PASS_KEY_DEPTH_DISCARD | VKD3D_RENDER_PASS_KEY_STENCIL_DISCARD),
 };
 
 struct vkd3d_render_pass_key
 {
     uint32_t attachment_count;
     uint32_t rtv_active_mask;
+    /* Render targets which use LOAD_OP_CLEAR. Does not affect render pass compatibility. */
+    uint32_t rtv_clear_mask;
+    /* Render targets which use LOAD_OP_DONT_CARE. Does not affect render pass compatibility. */
+    uint32_t rtv_discard_mask;
     uint32_t flags; /* vkd3d_render_pass_key_flag */
     uint32_t sample_count;
     VkFormat vk_formats[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT + 1];
 };
 
+enum vkd3d_clear_render_pass_key_flag
+{
+    VKD3D_CLEAR_RENDER_PASS_KEY_CLEAR_OP             = (1u << 0),
+    VKD3D_CLEAR_RENDER_PASS_KEY_SEPARATE_DS_LAYOUTS  = (1u << 1),
+};
+
+/* Single-attachment render pass used to clear views which are not
+ * part of the current render pass. Must be zero-initialized. */
+struct vkd3d_clear_render_pass_key
+{
+    VkFormat vk_format;
+    VkSampleCountFlagBits sample_count;
+    VkImageAspectFlags clear_aspects;
+    VkImageAspectFlags format_aspects;
+    uint32_t flags; /* vkd3d_clear_render_pass_key_flag */
+    VkImageLayout initial_layout;
+    VkImageLayout final_layout;
+    VkImageLayout attachment_layout;
+    VkImageLayout stencil_initial_layout;
+    VkImageLayout stencil_final_layout;
+    VkImageLayout stencil_attachment_layout;
+};
+
 struct vkd3d_render_pass_entry;
+struct vkd3d_clear_render_pass_entry;
 
 struct vkd3d_render_pass_cache
 {
     struct vkd3d_render_pass_entry *render_passes;
     size_t render_pass_count;
     size_t render_passes_size;
+    struct vkd3d_clear_render_pass_entry *clear_passes;
+    size_t clear_pass_count;
+    size_t clear_passes_size;
     spinlock_t lock;
 };
 
@@ -347,6 +483,12 @@ void vkd3d_render_pass_cache_cleanup(struct vkd3d_render_pass_cache *cache,
 HRESULT vkd3d_render_pass_cache_find(struct vkd3d_render_pass_cache *cache,
         struct d3d12_device *device, const struct vkd3d_render_pass_key *key,
         VkRenderPass *vk_render_pass);
+HRESULT vkd3d_render_pass_cache_find_clear_variant(struct vkd3d_render_pass_cache *cache,
+        struct d3d12_device *device, VkRenderPass vk_base_render_pass, uint32_t *rtv_clear_mask,
+        uint32_t *rtv_discard_mask, uint32_t *ds_load_flags, VkRenderPass *vk_render_pass);
+HRESULT vkd3d_render_pass_cache_find_clear_pass(struct vkd3d_render_pass_cache *cache,
+        struct d3d12_device *device, const struct vkd3d_clear_render_pass_key *key,
+        VkRenderPass *vk_render_pass);
 void vkd3d_render_pass_cache_init(struct vkd3d_render_pass_cache *cache);
 
 struct vkd3d_private_store
@@ -556,9 +698,17 @@ struct d3d12_fence
     size_t pending_updates_size;
 
     pthread_mutex_t mutex;
-    pthread_cond_t cond;
     pthread_cond_t null_event_cond;
 
+    /* Queues whose next submission waits for a value that has no pending signal yet. */
+    struct vkd3d_parked_queue
+    {
+        struct d3d12_command_queue *queue;
+        uint64_t value;
+    } *parked_queues;
+    size_t parked_queues_size;
+    size_t parked_queue_count;
+
     struct vkd3d_waiting_event
     {
         uint64_t value;
@@ -790,6 +940,7 @@ enum vkd3d_resource_flag
     VKD3D_RESOURCE_EXTERNAL               = (1u << 5),
     VKD3D_RESOURCE_ACCELERATION_STRUCTURE = (1u << 6),
     VKD3D_RESOURCE_SIMULTANEOUS_ACCESS    = (1u << 7),
+    VKD3D_RESOURCE_EXCLUSIVE_OWNERSHIP    = (1u << 8),
 };
 
 struct d3d12_sparse_image_region
@@ -806,6 +957,7 @@ struct d3d12_sparse_buffer_region
     VkDeviceSize length;
 };
 
+/* Computed on demand by d3d12_resource_get_sparse_tile(). */
 struct d3d12_sparse_tile
 {
     union
@@ -813,18 +965,23 @@ struct d3d12_sparse_tile
         struct d3d12_sparse_image_region image;
         struct d3d12_sparse_buffer_region buffer;
     };
-    VkDeviceMemory vk_memory;
-    VkDeviceSize vk_offset;
 };
 
 struct d3d12_sparse_info
 {
     uint32_t tile_count;
     uint32_t tiling_count;
-    struct d3d12_sparse_tile *tiles;
+    /* Memory handles are VkDeviceMemory. Sparse binds on one queue may update the
+     * mappings while a CopyTileMappings on another queue reads them. */
+    struct vkd3d_tile_map mappings;
+    spinlock_t mappings_lock;
     D3D12_TILE_SHAPE tile_shape;
     D3D12_PACKED_MIP_INFO packed_mips;
     D3D12_SUBRESOURCE_TILING *tilings;
+    VkExtent3D block_extent;
+    VkImageAspectFlags aspect_mask;
+    VkDeviceSize mip_tail_offset;
+    VkDeviceSize mip_tail_size;
     struct vkd3d_device_memory_allocation vk_metadata_memory;
 };
 
@@ -864,6 +1021,13 @@ struct d3d12_resource
     D3D12_RESOURCE_STATES initial_state;
     uint32_t initial_layout_transition;
 
+    /* DSV plane optimal mask the image is left in between command lists.
+     * Only written by queue submission threads, see d3d12_dsv_boundary_layout. */
+    uint32_t persistent_dsv_plane_optimal_mask;
+
+    /* Only used with VKD3D_RESOURCE_EXCLUSIVE_OWNERSHIP. */
+    struct vkd3d_queue_ownership queue_ownership;
+
     struct d3d12_sparse_info sparse;
     struct vkd3d_view_map view_map;
 
@@ -919,6 +1083,8 @@ HRESULT d3d12_resource_create_placed(struct d3d12_device *device, const D3D12_RE
 HRESULT d3d12_resource_create_reserved(struct d3d12_device *device,
         const D3D12_RESOURCE_DESC *desc, D3D12_RESOURCE_STATES initial_state,
         const D3D12_CLEAR_VALUE *optimized_clear_value, struct d3d12_resource **resource);
+void d3d12_resource_get_sparse_tile(const struct d3d12_resource *resource, uint32_t tile_index,
+        struct d3d12_sparse_tile *tile);
 
 static inline struct d3d12_resource *impl_from_ID3D12Resource1(ID3D12Resource1 *iface)
 {
@@ -1045,38 +1211,47 @@ struct vkd3d_descriptor_data
     uint64_t cookie;
     uint32_t set_info_mask;
     uint32_t flags;
-    VkDescriptorType current_null_type;
 };
 
+union d3d12_desc_info
+{
+    VkDescriptorBufferInfo buffer;
+    struct vkd3d_view *view;
+};
+
+/* CBV_SRV_UAV and sampler handles do not point to memory. Each heap reserves a contiguous
+ * range in a process-wide handle space, which is split into pages. A page table maps
+ * every page back to the heap which owns it, and the descriptor index is the distance
+ * from the start of the heap's range, see d3d12_desc_from_cpu_handle().
+ * Descriptor state itself lives in tightly packed arrays owned by the heap.
+ * The increment stays at 64 since we need a POT size when reporting GPU addresses.
+ * In DXR, we will need to handle app-placed VAs in a local root signature,
+ * and the fastest approach we can use is uint(VA) >> 6 to derive an index. */
+#define VKD3D_RESOURCE_DESC_INCREMENT_LOG2 6
+#define VKD3D_RESOURCE_DESC_INCREMENT (1u << VKD3D_RESOURCE_DESC_INCREMENT_LOG2)
+
+/* 256 descriptors per page. The page table has two levels, a static directory and leaves
+ * of 4096 pages which are allocated on first use. 64-bit builds get 1 TiB of handle space,
+ * which is 16G descriptors, so the descriptor memory runs out long before the handles do.
+ * 32-bit builds are limited to 2 GiB by the handle width. */
+#define VKD3D_DESCRIPTOR_HANDLE_PAGE_BITS 14
+#define VKD3D_DESCRIPTOR_HANDLE_LEAF_BITS 12
+#if defined(_WIN64) || defined(__LP64__)
+#define VKD3D_DESCRIPTOR_HANDLE_SPACE_BITS 40
+#else
+#define VKD3D_DESCRIPTOR_HANDLE_SPACE_BITS 31
+#endif
+#define VKD3D_DESCRIPTOR_HANDLE_PAGE_COUNT (1u << (VKD3D_DESCRIPTOR_HANDLE_SPACE_BITS - VKD3D_DESCRIPTOR_HANDLE_PAGE_BITS))
+#define VKD3D_DESCRIPTOR_HANDLE_LEAF_COUNT (VKD3D_DESCRIPTOR_HANDLE_PAGE_COUNT >> VKD3D_DESCRIPTOR_HANDLE_LEAF_BITS)
+
 #define D3D12_DESC_ALIGNMENT 64
 struct d3d12_desc
 {
-    /* Align d3d12_desc to 64 bytes for two reasons.
-     * - We need a POT size when reporting GPU addresses.
-     *   In DXR, we will need to handle app-placed VAs in a local root signature,
-     *   and the fastest approach we can use is uint(VA) >> 6 to derive an index.
-     * - Can avoid false sharing on cache lines if multiple threads
-     *   modify adjacent descriptors somehow. */
-    DECLSPEC_ALIGN(D3D12_DESC_ALIGNMENT) struct vkd3d_descriptor_data metadata;
     struct d3d12_descriptor_heap *heap;
     uint32_t heap_offset;
-    union
-    {
-        VkDescriptorBufferInfo buffer;
-        struct vkd3d_view *view;
-    } info;
+    struct vkd3d_descriptor_data *metadata;
+    union d3d12_desc_info *info;
 };
-STATIC_ASSERT(sizeof(struct d3d12_desc) == 64);
-
-static inline struct d3d12_desc *d3d12_desc_from_cpu_handle(D3D12_CPU_DESCRIPTOR_HANDLE cpu_handle)
-{
-    return (struct d3d12_desc *)cpu_handle.ptr;
-}
-
-static inline struct d3d12_desc *d3d12_desc_from_gpu_handle(D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle)
-{
-    return (struct d3d12_desc *)(intptr_t)gpu_handle.ptr;
-}
 
 void d3d12_desc_copy(struct d3d12_desc *dst, struct d3d12_desc *src,
         unsigned int count, D3D12_DESCRIPTOR_HEAP_TYPE heap_type, struct d3d12_device *device);
@@ -1143,6 +1318,46 @@ union vkd3d_descriptor_info
     VkDeviceAddress va;
 };
 
+/* Non-shader-visible CBV_SRV_UAV and sampler heaps are never bound, so they do not
+ * need VkDescriptorSets at all. Instead we remember the writes a view would have
+ * performed, and replay them when the descriptor is copied into a shader-visible heap.
+ * Only buffer views without mutable descriptor support need more than one write,
+ * so the first write is stored inline and the rest are allocated on demand.
+ * The extra writes are kept until the heap is destroyed so that rewriting a
+ * descriptor with the same kind of view does not allocate again. */
+#define VKD3D_HOST_DESCRIPTOR_MAX_WRITES 3
+
+struct vkd3d_host_descriptor_write
+{
+    struct vkd3d_descriptor_binding binding;
+    VkDescriptorType vk_descriptor_type;
+    union vkd3d_descriptor_info info;
+};
+
+struct vkd3d_host_descriptor
+{
+    struct vkd3d_host_descriptor_write write;
+    struct vkd3d_host_descriptor_write *extra_writes;
+    uint32_t write_count;
+};
+
+static inline struct vkd3d_host_descriptor_write *vkd3d_host_descriptor_get_write(
+        struct vkd3d_host_descriptor *host, uint32_t index)
+{
+    return index ? &host->extra_writes[index - 1] : &host->write;
+}
+
+static inline bool vkd3d_host_descriptor_reserve_writes(struct vkd3d_host_descriptor *host, uint32_t count)
+{
+    if (count > 1 && !host->extra_writes)
+    {
+        host->extra_writes = vkd3d_malloc((VKD3D_HOST_DESCRIPTOR_MAX_WRITES - 1) * sizeof(*host->extra_writes));
+        return !!host->extra_writes;
+    }
+
+    return true;
+}
+
 /* ID3D12DescriptorHeap */
 struct d3d12_null_descriptor_template
 {
@@ -1177,6 +1392,17 @@ struct d3d12_descriptor_heap
     uint64_t cookie;
 #endif
 
+    /* Hot descriptor state for CBV_SRV_UAV and sampler heaps, indexed by heap offset. */
+    struct vkd3d_descriptor_data *descriptor_metadata;
+    union d3d12_desc_info *descriptor_info;
+    /* Cold state, only consulted when writing or copying null descriptors. */
+    VkDescriptorType *descriptor_null_types;
+    /* Start of the range this heap owns in the descriptor handle space. */
+    SIZE_T cpu_handle_base;
+
+    /* Only allocated for host-only heaps, which have no Vulkan descriptor sets. */
+    struct vkd3d_host_descriptor *host_descriptors;
+
     struct d3d12_null_descriptor_template null_descriptor_template;
 
     struct d3d12_device *device;
@@ -1199,6 +1425,11 @@ static inline struct d3d12_descriptor_heap *impl_from_ID3D12DescriptorHeap(ID3D1
     return CONTAINING_RECORD(iface, struct d3d12_descriptor_heap, ID3D12DescriptorHeap_iface);
 }
 
+static inline bool d3d12_descriptor_heap_is_host_only(const struct d3d12_descriptor_heap *heap)
+{
+    return !(heap->desc.Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
+}
+
 static inline uint32_t d3d12_desc_heap_offset(const struct d3d12_desc *dst)
 {
     return dst->heap_offset;
@@ -1206,7 +1437,50 @@ static inline uint32_t d3d12_desc_heap_offset(const struct d3d12_desc *dst)
 
 static inline uint32_t d3d12_desc_heap_offset_from_gpu_handle(D3D12_GPU_DESCRIPTOR_HANDLE handle)
 {
-    return (uint32_t)handle.ptr / sizeof(struct d3d12_desc);
+    return (uint32_t)handle.ptr >> VKD3D_RESOURCE_DESC_INCREMENT_LOG2;
+}
+
+static inline struct d3d12_desc d3d12_desc_from_heap(struct d3d12_descriptor_heap *heap, uint32_t offset)
+{
+    struct d3d12_desc desc;
+
+    desc.heap = heap;
+    desc.heap_offset = offset;
+    desc.metadata = &heap->descriptor_metadata[offset];
+    desc.info = &heap->descriptor_info[offset];
+    return desc;
+}
+
+extern struct d3d12_descriptor_heap **vkd3d_descriptor_handle_leaves[VKD3D_DESCRIPTOR_HANDLE_LEAF_COUNT];
+
+static inline struct d3d12_desc d3d12_desc_from_cpu_handle(D3D12_CPU_DESCRIPTOR_HANDLE cpu_handle)
+{
+    struct d3d12_descriptor_heap **leaf, *heap;
+    SIZE_T page;
+
+    page = cpu_handle.ptr >> VKD3D_DESCRIPTOR_HANDLE_PAGE_BITS;
+    assert(page && page < VKD3D_DESCRIPTOR_HANDLE_PAGE_COUNT);
+    leaf = vkd3d_descriptor_handle_leaves[page >> VKD3D_DESCRIPTOR_HANDLE_LEAF_BITS];
+    assert(leaf);
+    heap = leaf[page & ((1u << VKD3D_DESCRIPTOR_HANDLE_LEAF_BITS) - 1)];
+    assert(heap && cpu_handle.ptr >= heap->cpu_handle_base);
+    assert(!((cpu_handle.ptr - heap->cpu_handle_base) & (VKD3D_RESOURCE_DESC_INCREMENT - 1)));
+    assert((cpu_handle.ptr - heap->cpu_handle_base) >> VKD3D_RESOURCE_DESC_INCREMENT_LOG2 < heap->desc.NumDescriptors);
+
+    return d3d12_desc_from_heap(heap,
+            (uint32_t)((cpu_handle.ptr - heap->cpu_handle_base) >> VKD3D_RESOURCE_DESC_INCREMENT_LOG2));
+}
+
+static inline D3D12_CPU_DESCRIPTOR_HANDLE d3d12_descriptor_heap_get_cpu_handle_start(
+        const struct d3d12_descriptor_heap *heap)
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE handle;
+
+    if (heap->desc.Type == D3D12_DESCRIPTOR_HEAP_TYPE_RTV || heap->desc.Type == D3D12_DESCRIPTOR_HEAP_TYPE_DSV)
+        handle.ptr = (SIZE_T)heap->descriptors;
+    else
+        handle.ptr = heap->cpu_handle_base;
+    return handle;
 }
 
 /* ID3D12QueryHeap */
@@ -1346,6 +1620,9 @@ struct d3d12_root_signature
 
     struct vkd3d_descriptor_hoist_info hoist_info;
 
+    /* Hash of the serialized root signature, used to validate cached SPIR-V. */
+    vkd3d_shader_hash_t compatibility_hash;
+
     struct d3d12_device *device;
 
     struct vkd3d_private_store private_store;
@@ -1482,6 +1759,7 @@ struct d3d12_graphics_pipeline_state
     struct list compiled_fallback_pipelines;
 
     bool xfb_enabled;
+    bool is_mesh_pipeline;
 };
 
 static inline unsigned int dsv_attachment_mask(const struct d3d12_graphics_pipeline_state *graphics)
@@ -1493,6 +1771,22 @@ struct d3d12_compute_pipeline_state
 {
     VkPipeline vk_pipeline;
     struct vkd3d_shader_meta meta;
+
+    /* Kept around so the pipeline can be recompiled into a private cache for GetCachedBlob(). */
+    VkComputePipelineCreateInfo create_info;
+    VkPipelineShaderStageRequiredSubgroupSizeCreateInfoEXT required_subgroup_size_info;
+    struct vkd3d_shader_debug_ring_spec_info spec_info;
+};
+
+/* Translated shader code of one stage. It is stored in cached blobs, which lets
+ * PSOs created from those blobs skip translation. The SPIR-V is only kept if the
+ * device uses pipeline blobs at the time the PSO is created. */
+struct vkd3d_pipeline_stage_code
+{
+    VkShaderStageFlagBits stage;
+    /* Hash of everything which affects translation, see vkd3d_pipeline_stage_fingerprint(). */
+    vkd3d_shader_hash_t fingerprint;
+    struct vkd3d_shader_code spirv;
 };
 
 /* ID3D12PipelineState */
@@ -1507,9 +1801,20 @@ struct d3d12_pipeline_state
         struct d3d12_compute_pipeline_state compute;
     };
     VkPipelineBindPoint vk_bind_point;
-    VkPipelineCache vk_pso_cache;
     spinlock_t lock;
 
+    /* Driver cache data belonging to this PSO alone. It is taken from CachedPSO or
+     * captured at creation time once the device uses pipeline blobs. Otherwise,
+     * it is extracted the first time the PSO is serialized. */
+    void *vk_cache_data;
+    size_t vk_cache_data_size;
+    bool has_vk_cache_data;
+    /* Shard of the device's cache pool which this PSO compiles into. */
+    unsigned int cache_shard_index;
+
+    struct vkd3d_pipeline_stage_code stage_code[VKD3D_MAX_SHADER_STAGES];
+    unsigned int stage_code_count;
+
     ID3D12RootSignature *private_root_signature;
     struct d3d12_device *device;
 
@@ -1547,6 +1852,8 @@ struct d3d12_pipeline_state_desc
     D3D12_SHADER_BYTECODE hs;
     D3D12_SHADER_BYTECODE gs;
     D3D12_SHADER_BYTECODE cs;
+    D3D12_SHADER_BYTECODE as;
+    D3D12_SHADER_BYTECODE ms;
     D3D12_STREAM_OUTPUT_DESC stream_output;
     D3D12_BLEND_DESC blend_state;
     UINT sample_mask;
@@ -1624,17 +1931,73 @@ struct d3d12_pipeline_library
     pthread_mutex_t mutex;
     struct hash_map map;
 
+    /* Snapshot of the device's ray tracing pipeline cache for serialization. */
+    void *rt_cache_data;
+    size_t rt_cache_size;
+    bool has_rt_cache_snapshot;
+
     struct vkd3d_private_store private_store;
 };
 
 HRESULT d3d12_pipeline_library_create(struct d3d12_device *device, const void *blob,
         size_t blob_length, struct d3d12_pipeline_library **pipeline_library);
 
+HRESULT d3d12_pipeline_state_get_cache_data(struct d3d12_pipeline_state *state,
+        const void **data, size_t *size);
+
 VkResult vkd3d_create_pipeline_cache(struct d3d12_device *device,
         size_t size, const void *data, VkPipelineCache *cache);
 HRESULT vkd3d_create_pipeline_cache_from_d3d12_desc(struct d3d12_device *device,
         const D3D12_CACHED_PIPELINE_STATE *state, VkPipelineCache *cache);
-VkResult vkd3d_serialize_pipeline_state(const struct d3d12_pipeline_state *state, size_t *size, void *data);
+const void *vkd3d_get_pipeline_cache_data_from_d3d12_desc(const D3D12_CACHED_PIPELINE_STATE *state, size_t *size);
+bool vkd3d_get_cached_spirv_from_d3d12_desc(struct d3d12_device *device,
+        const D3D12_CACHED_PIPELINE_STATE *state, VkShaderStageFlagBits stage,
+        vkd3d_shader_hash_t fingerprint, struct vkd3d_shader_code *spirv);
+VkResult vkd3d_serialize_pipeline_state(struct d3d12_pipeline_state *state, size_t *size, void *data);
+VkPipelineCache vkd3d_acquire_rt_pipeline_cache(struct d3d12_device *device);
+void vkd3d_release_rt_pipeline_cache(struct d3d12_device *device);
+void vkd3d_cleanup_rt_pipeline_cache_merges(struct d3d12_device *device);
+
+#define VKD3D_PIPELINE_CACHE_SHARD_COUNT 4
+
+/* Device-level pipeline caches shared by all graphics and compute PSOs. Each PSO is
+ * assigned a shard, which spreads concurrent compiles over several caches. Every so
+ * many imports, a shard is folded into the read-only base cache and starts over empty,
+ * so compiled state lives in exactly one cache and merges only ever move a shard's
+ * recent additions. Compiles probe the base first, which requires
+ * VK_EXT_pipeline_creation_cache_control, without it shards are never folded. */
+struct vkd3d_pipeline_cache_shard
+{
+    VkPipelineCache vk_cache;
+    /* Only locked exclusively while importing into or folding this shard. */
+    spinlock_t lock;
+    /* Compiles and imports since the shard was last folded into the base. */
+    uint32_t compile_count;
+};
+
+struct vkd3d_pipeline_cache_pool
+{
+    struct vkd3d_pipeline_cache_shard shards[VKD3D_PIPELINE_CACHE_SHARD_COUNT];
+    uint32_t next_shard;
+    /* Only locked exclusively while a shard is folded in. */
+    VkPipelineCache vk_base_cache;
+    spinlock_t base_lock;
+};
+
+HRESULT vkd3d_pipeline_cache_pool_init(struct vkd3d_pipeline_cache_pool *pool, struct d3d12_device *device);
+void vkd3d_pipeline_cache_pool_cleanup(struct vkd3d_pipeline_cache_pool *pool, struct d3d12_device *device);
+unsigned int vkd3d_pipeline_cache_pool_get_shard(struct vkd3d_pipeline_cache_pool *pool);
+VkPipelineCache vkd3d_pipeline_cache_pool_acquire(struct vkd3d_pipeline_cache_pool *pool, unsigned int shard_index);
+void vkd3d_pipeline_cache_pool_release(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, unsigned int shard_index);
+void vkd3d_pipeline_cache_pool_import(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, unsigned int shard_index, VkPipelineCache vk_cache);
+VkResult vkd3d_pipeline_cache_pool_create_graphics_pipeline(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, VkPipelineCache vk_cache, VkGraphicsPipelineCreateInfo *create_info,
+        VkPipeline *vk_pipeline);
+VkResult vkd3d_pipeline_cache_pool_create_compute_pipeline(struct vkd3d_pipeline_cache_pool *pool,
+        struct d3d12_device *device, VkPipelineCache vk_cache, VkComputePipelineCreateInfo *create_info,
+        VkPipeline *vk_pipeline);
 
 struct vkd3d_buffer
 {
@@ -1663,12 +2026,33 @@ enum vkd3d_descriptor_pool_types
 #define VKD3D_SCRATCH_BUFFER_SIZE (1ull << 20)
 #define VKD3D_SCRATCH_BUFFER_COUNT (32u)
 
+enum vkd3d_scratch_pool_kind
+{
+    VKD3D_SCRATCH_POOL_KIND_DEVICE_STORAGE = 0,
+    /* Host-visible, for data which is already known while recording. */
+    VKD3D_SCRATCH_POOL_KIND_UPLOAD,
+    VKD3D_SCRATCH_POOL_KIND_COUNT
+};
+
 struct vkd3d_scratch_buffer
 {
     struct vkd3d_memory_allocation allocation;
     VkDeviceSize offset;
 };
 
+struct d3d12_command_allocator_scratch_pool
+{
+    struct vkd3d_scratch_buffer *scratch_buffers;
+    size_t scratch_buffers_size;
+    size_t scratch_buffer_count;
+};
+
+struct d3d12_device_scratch_pool
+{
+    struct vkd3d_scratch_buffer scratch_buffers[VKD3D_SCRATCH_BUFFER_COUNT];
+    size_t scratch_buffer_count;
+};
+
 #define VKD3D_QUERY_TYPE_INDEX_OCCLUSION (0u)
 #define VKD3D_QUERY_TYPE_INDEX_PIPELINE_STATISTICS (1u)
 #define VKD3D_QUERY_TYPE_INDEX_TRANSFORM_FEEDBACK (2u)
@@ -1698,10 +2082,6 @@ struct d3d12_command_allocator
 
     struct d3d12_descriptor_pool_cache descriptor_pool_caches[VKD3D_DESCRIPTOR_POOL_TYPE_COUNT];
 
-    VkRenderPass *passes;
-    size_t passes_size;
-    size_t pass_count;
-
     VkFramebuffer *framebuffers;
     size_t framebuffers_size;
     size_t framebuffer_count;
@@ -1718,9 +2098,7 @@ struct d3d12_command_allocator
     size_t command_buffers_size;
     size_t command_buffer_count;
 
-    struct vkd3d_scratch_buffer *scratch_buffers;
-    size_t scratch_buffers_size;
-    size_t scratch_buffer_count;
+    struct d3d12_command_allocator_scratch_pool scratch_pools[VKD3D_SCRATCH_POOL_KIND_COUNT];
 
     struct vkd3d_query_pool *query_pools;
     size_t query_pools_size;
@@ -1812,7 +2190,7 @@ struct vkd3d_dynamic_state
 };
 
 /* ID3D12CommandList */
-typedef ID3D12GraphicsCommandList5 d3d12_command_list_iface;
+typedef ID3D12GraphicsCommandList7 d3d12_command_list_iface;
 
 enum vkd3d_initial_transition_type
 {
@@ -1876,6 +2254,55 @@ struct d3d12_resource_tracking
     uint32_t plane_optimal_mask;
 };
 
+/* Layout of a DSV resource at the boundaries of a command list. Rather than decaying
+ * optimal DSV layouts in Close(), the queue tracks the layout each resource is left in
+ * and only executes the promote or decay command buffers when the next command list
+ * which uses the resource expects a different layout. */
+struct d3d12_dsv_boundary_layout
+{
+    struct d3d12_resource *resource;
+    uint32_t entry_plane_optimal_mask;
+    uint32_t exit_plane_optimal_mask;
+    /* Common layout to entry layout, only if entry_plane_optimal_mask is not 0. */
+    VkCommandBuffer vk_promote_commands;
+    /* Exit layout to common layout, only if exit_plane_optimal_mask is not 0. */
+    VkCommandBuffer vk_decay_commands;
+};
+
+/* Full-view clear recorded outside a render pass. Folded into the
+ * load op of the next render pass which binds the view, if possible.
+ * Discards only come from BeginRenderPass() and are merely a hint. */
+struct vkd3d_clear_attachment
+{
+    struct d3d12_resource *resource;
+    struct vkd3d_view *view;
+    VkImageAspectFlags aspect_mask;
+    VkImageAspectFlags discard_aspect_mask;
+    VkClearValue value;
+};
+
+struct vkd3d_clear_state
+{
+    uint32_t attachment_mask;
+    uint32_t discard_mask;
+    struct vkd3d_clear_attachment attachments[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT + 1];
+};
+
+/* Render pass opened with BeginRenderPass(). Ending accesses are applied in EndRenderPass(). */
+struct d3d12_render_pass_state
+{
+    bool active;
+    D3D12_RENDER_PASS_FLAGS flags;
+    uint32_t rt_count;
+    D3D12_RENDER_PASS_ENDING_ACCESS rt_ending_access[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT];
+    D3D12_RENDER_PASS_ENDING_ACCESS depth_ending_access;
+    D3D12_RENDER_PASS_ENDING_ACCESS stencil_ending_access;
+
+    /* Storage for the subresource parameters of resolve ending accesses. */
+    D3D12_RENDER_PASS_ENDING_ACCESS_RESOLVE_SUBRESOURCE_PARAMETERS *resolve_parameters;
+    size_t resolve_parameters_size;
+};
+
 struct d3d12_command_list
 {
     d3d12_command_list_iface ID3D12GraphicsCommandList_iface;
@@ -1909,6 +2336,9 @@ struct d3d12_command_list
 
     bool predicate_enabled;
     VkDeviceAddress predicate_va;
+    /* Same location as predicate_va, used as draw count for predicated draws. */
+    VkBuffer predicate_vk_buffer;
+    VkDeviceSize predicate_offset;
 
     VkFramebuffer current_framebuffer;
 
@@ -1922,6 +2352,8 @@ struct d3d12_command_list
 
     VkRenderPass pso_render_pass;
     VkRenderPass current_render_pass;
+    struct vkd3d_clear_state clear_state;
+    struct d3d12_render_pass_state render_pass_state;
     struct vkd3d_dynamic_state dynamic_state;
     struct vkd3d_pipeline_bindings pipeline_bindings[VKD3D_PIPELINE_BIND_POINT_COUNT];
     VkPipelineBindPoint active_bind_point;
@@ -1955,7 +2387,7 @@ struct d3d12_command_list
 
     LONG *outstanding_submissions_count;
 
-    const struct d3d12_desc *cbv_srv_uav_descriptors;
+    const struct d3d12_descriptor_heap *cbv_srv_uav_heap;
 
     struct d3d12_resource *vrs_image;
 
@@ -1963,6 +2395,10 @@ struct d3d12_command_list
     size_t dsv_resource_tracking_count;
     size_t dsv_resource_tracking_size;
 
+    struct d3d12_dsv_boundary_layout *dsv_boundary_layouts;
+    size_t dsv_boundary_layout_count;
+    size_t dsv_boundary_layouts_size;
+
     struct vkd3d_private_store private_store;
 };
 
@@ -1970,6 +2406,10 @@ HRESULT d3d12_command_list_create(struct d3d12_device *device,
         UINT node_mask, D3D12_COMMAND_LIST_TYPE type, struct d3d12_command_list **list);
 bool d3d12_command_list_reset_query(struct d3d12_command_list *list,
         VkQueryPool vk_pool, uint32_t index);
+/* size is the extent of the data about to be written at va, or 0 if the acceleration
+ * structure is only read or its size is not known up front. */
+VkAccelerationStructureKHR d3d12_command_list_place_acceleration_structure(struct d3d12_command_list *list,
+        D3D12_GPU_VIRTUAL_ADDRESS va, VkDeviceSize size);
 
 #define VKD3D_BUNDLE_CHUNK_SIZE (256 << 10)
 #define VKD3D_BUNDLE_COMMAND_ALIGNMENT (sizeof(UINT64))
@@ -2044,6 +2484,13 @@ struct vkd3d_queue
     VkPipelineStageFlags *wait_stages;
     size_t wait_stages_size;
     uint32_t wait_count;
+
+    /* Command queues whose worker found the queue locked. Pool workers never block
+     * on the mutex, the command queues are rescheduled on release instead. */
+    spinlock_t parked_lock;
+    struct d3d12_command_queue **parked_queues;
+    size_t parked_queues_size;
+    size_t parked_queue_count;
 };
 
 VkQueue vkd3d_queue_acquire(struct vkd3d_queue *queue);
@@ -2073,6 +2520,7 @@ struct vkd3d_sparse_memory_bind
 {
     uint32_t dst_tile;
     uint32_t src_tile;
+    uint32_t tile_count;
     VkDeviceMemory vk_memory;
     VkDeviceSize vk_offset;
 };
@@ -2097,6 +2545,14 @@ struct d3d12_command_queue_submission_signal
     UINT64 value;
 };
 
+struct d3d12_command_queue_dsv_boundary
+{
+    struct d3d12_dsv_boundary_layout layout;
+    /* Range of the command list's command buffers in the submission. */
+    UINT cmd_begin;
+    UINT cmd_end;
+};
+
 struct d3d12_command_queue_submission_execute
 {
     VkCommandBuffer *cmd;
@@ -2107,6 +2563,9 @@ struct d3d12_command_queue_submission_execute
     struct vkd3d_initial_transition *transitions;
     size_t transition_count;
 
+    struct d3d12_command_queue_dsv_boundary *dsv_boundaries;
+    size_t dsv_boundary_count;
+
     bool debug_capture;
 };
 
@@ -2146,6 +2605,8 @@ struct d3d12_swapchain_factory
 
 HRESULT d3d12_swapchain_factory_init(struct d3d12_command_queue *queue, struct d3d12_swapchain_factory *factory);
 
+struct d3d12_command_queue_transition_pool;
+
 /* ID3D12CommandQueue */
 struct d3d12_command_queue
 {
@@ -2160,7 +2621,6 @@ struct d3d12_command_queue
 
     pthread_mutex_t queue_lock;
     pthread_cond_t queue_cond;
-    pthread_t submission_thread;
 
     struct d3d12_command_queue_submission *submissions;
     size_t submissions_count;
@@ -2168,7 +2628,39 @@ struct d3d12_command_queue
     uint64_t drain_count;
     uint64_t queue_drain_count;
 
-    struct vkd3d_fence_worker fence_worker;
+    /* Set while the queue is on the worker pool's ready list, being processed
+     * or parked on a fence. Protected by queue_lock. */
+    bool is_scheduled;
+    bool is_stopped;
+
+    struct d3d12_command_queue_transition_pool *transition_pool;
+    uint64_t transition_timeline_value;
+
+    /* Fence waits which have been resolved but not submitted yet. They are
+     * attached to the next ExecuteCommandLists submission, or flushed with an
+     * empty submission if anything else comes first. Only accessed by the worker
+     * currently processing the queue. */
+    struct d3d12_command_queue_pending_waits
+    {
+        struct d3d12_fence **fences;
+        size_t fences_size;
+        VkSemaphore *semaphores;
+        size_t semaphores_size;
+        uint64_t *values;
+        size_t values_size;
+        VkPipelineStageFlags *stages;
+        size_t stages_size;
+        uint32_t count;
+        uint32_t submission_count;
+    } pending_waits;
+
+    uint64_t folded_submit_count;
+
+    /* Vulkan queues the worker holds while processing the current submission. */
+    struct vkd3d_queue **held_vk_queues;
+    size_t held_vk_queues_size;
+    size_t held_vk_queue_count;
+
     struct vkd3d_private_store private_store;
 
 #ifdef VKD3D_BUILD_STANDALONE_D3D12
@@ -2319,6 +2811,7 @@ struct vkd3d_bindless_state
 
 HRESULT vkd3d_bindless_state_init(struct vkd3d_bindless_state *bindless_state,
         struct d3d12_device *device);
+uint32_t vkd3d_bindless_get_physical_device_flags(struct d3d12_device *device);
 void vkd3d_bindless_state_cleanup(struct vkd3d_bindless_state *bindless_state,
         struct d3d12_device *device);
 bool vkd3d_bindless_state_find_binding(const struct vkd3d_bindless_state *bindless_state,
@@ -2336,9 +2829,9 @@ static inline VkDescriptorType vkd3d_bindless_state_get_cbv_descriptor_type(cons
             : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 }
 
+/* View formats allowed for a mutable image of a given DXGI format. */
 struct vkd3d_format_compatibility_list
 {
-    DXGI_FORMAT typeless_format;
     unsigned int format_count;
     VkFormat vk_formats[VKD3D_MAX_COMPATIBLE_FORMAT_COUNT];
 };
@@ -2554,6 +3047,7 @@ union vkd3d_predicate_command_direct_args
     VkDispatchIndirectCommand dispatch;
     VkDrawIndirectCommand draw;
     VkDrawIndexedIndirectCommand draw_indexed;
+    VkDrawMeshTasksIndirectCommandEXT draw_mesh_tasks;
     uint32_t draw_count;
 };
 
@@ -2573,6 +3067,7 @@ enum vkd3d_predicate_command_type
     VKD3D_PREDICATE_COMMAND_DRAW_INDIRECT_COUNT,
     VKD3D_PREDICATE_COMMAND_DISPATCH,
     VKD3D_PREDICATE_COMMAND_DISPATCH_INDIRECT,
+    VKD3D_PREDICATE_COMMAND_DRAW_MESH_TASKS,
     VKD3D_PREDICATE_COMMAND_COUNT
 };
 
@@ -2683,6 +3178,7 @@ struct vkd3d_physical_device_info
     VkPhysicalDeviceFragmentShadingRatePropertiesKHR fragment_shading_rate_properties;
     VkPhysicalDeviceConservativeRasterizationPropertiesEXT conservative_rasterization_properties;
     VkPhysicalDeviceShaderIntegerDotProductPropertiesKHR shader_integer_dot_product_properties;
+    VkPhysicalDeviceMeshShaderPropertiesEXT mesh_shader_properties;
 
     VkPhysicalDeviceProperties2KHR properties2;
 
@@ -2698,6 +3194,7 @@ struct vkd3d_physical_device_info
     VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT vertex_divisor_features;
     VkPhysicalDeviceCustomBorderColorFeaturesEXT custom_border_color_features;
     VkPhysicalDevice4444FormatsFeaturesEXT ext_4444_formats_features;
+    VkPhysicalDevicePipelineCreationCacheControlFeaturesEXT pipeline_creation_cache_control_features;
     VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore_features;
     VkPhysicalDeviceFloat16Int8FeaturesKHR float16_int8_features;
     VkPhysicalDevice16BitStorageFeatures storage_16bit_features;
@@ -2712,6 +3209,8 @@ struct vkd3d_physical_device_info
     VkPhysicalDeviceSubgroupSizeControlFeaturesEXT subgroup_size_control_features;
     VkPhysicalDeviceSeparateDepthStencilLayoutsFeaturesKHR separate_depth_stencil_layout_features;
     VkPhysicalDeviceShaderIntegerDotProductFeaturesKHR shader_integer_dot_product_features;
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2_features;
+    VkPhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features;
 
     VkPhysicalDeviceFeatures2 features2;
 
@@ -2731,6 +3230,11 @@ struct d3d12_caps
     D3D12_FEATURE_DATA_D3D12_OPTIONS5 options5;
     D3D12_FEATURE_DATA_D3D12_OPTIONS6 options6;
     D3D12_FEATURE_DATA_D3D12_OPTIONS7 options7;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS8 options8;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS9 options9;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS10 options10;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS11 options11;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS12 options12;
 
     D3D_FEATURE_LEVEL max_feature_level;
     D3D_SHADER_MODEL max_shader_model;
@@ -2757,8 +3261,17 @@ struct vkd3d_queue_family_info
     VkQueueFlags vk_queue_flags;
 };
 
+/* Memoized GetRaytracingAccelerationStructurePrebuildInfo() results. */
+struct vkd3d_acceleration_structure_prebuild_cache
+{
+    spinlock_t spinlock;
+    struct hash_map map;
+    uint64_t hit_count;
+    uint64_t miss_count;
+};
+
 /* ID3D12Device */
-typedef ID3D12Device6 d3d12_device_iface;
+typedef ID3D12Device7 d3d12_device_iface;
 
 struct vkd3d_descriptor_qa_global_info;
 struct vkd3d_descriptor_qa_heap_buffer_data;
@@ -2801,8 +3314,7 @@ struct d3d12_device
 
     struct vkd3d_memory_allocator memory_allocator;
 
-    struct vkd3d_scratch_buffer scratch_buffers[VKD3D_SCRATCH_BUFFER_COUNT];
-    size_t scratch_buffer_count;
+    struct d3d12_device_scratch_pool scratch_pools[VKD3D_SCRATCH_POOL_KIND_COUNT];
 
     struct vkd3d_query_pool query_pools[VKD3D_VIRTUAL_QUERY_POOL_COUNT];
     size_t query_pool_count;
@@ -2816,22 +3328,39 @@ struct d3d12_device
 
     const struct vkd3d_format *formats;
     const struct vkd3d_format *depth_stencil_formats;
-    unsigned int format_compatibility_list_count;
+    /* Indexed by DXGI format, NULL without VK_KHR_image_format_list. */
     const struct vkd3d_format_compatibility_list *format_compatibility_lists;
     struct vkd3d_bindless_state bindless_state;
     struct vkd3d_memory_info memory_info;
     struct vkd3d_meta_ops meta_ops;
     struct vkd3d_view_map sampler_map;
     struct vkd3d_sampler_state sampler_state;
+    struct vkd3d_acceleration_structure_prebuild_cache prebuild_cache;
     struct vkd3d_shader_debug_ring debug_ring;
 #ifdef VKD3D_ENABLE_DESCRIPTOR_QA
     struct vkd3d_descriptor_qa_global_info *descriptor_qa_global_info;
 #endif
-    VkPipelineCache global_pipeline_cache;
+    struct vkd3d_pipeline_cache_pool pipeline_cache_pool;
+    /* Set once the application serializes PSOs, see d3d12_device_uses_pipeline_blobs(). */
+    uint32_t pipeline_blob_usage;
+    /* Shared by all ray tracing pipelines and persisted through pipeline libraries. */
+    VkPipelineCache rt_pipeline_cache;
+    spinlock_t rt_pipeline_cache_lock;
+    /* Loaded pipeline library data waiting to be merged into rt_pipeline_cache. */
+    VkPipelineCache *rt_pipeline_cache_pending;
+    size_t rt_pipeline_cache_pending_size;
+    uint32_t rt_pipeline_cache_pending_count;
+    spinlock_t rt_pipeline_cache_pending_lock;
+    /* The pipeline library which currently stores rt_pipeline_cache when serialized. */
+    struct d3d12_pipeline_library *rt_pipeline_cache_library;
+    struct vkd3d_fence_worker fence_worker;
+    struct vkd3d_queue_worker_pool queue_worker_pool;
 };
 
 HRESULT d3d12_device_create(struct vkd3d_instance *instance,
         const struct vkd3d_device_create_info *create_info, struct d3d12_device **device);
+HRESULT d3d12_device_probe(struct vkd3d_instance *instance,
+        const struct vkd3d_device_create_info *create_info);
 struct vkd3d_queue_family_info *d3d12_device_get_vkd3d_queue_family(struct d3d12_device *device,
         D3D12_COMMAND_LIST_TYPE type);
 struct vkd3d_queue *d3d12_device_allocate_vkd3d_queue(struct d3d12_device *device,
@@ -2844,9 +3373,9 @@ void d3d12_device_mark_as_removed(struct d3d12_device *device, HRESULT reason,
 
 static inline struct d3d12_device *impl_from_ID3D12Device(d3d12_device_iface *iface)
 {
-    extern CONST_VTBL struct ID3D12Device6Vtbl d3d12_device_vtbl;
+    extern CONST_VTBL struct ID3D12Device7Vtbl d3d12_device_vtbl;
 #ifdef VKD3D_ENABLE_PROFILING
-    extern CONST_VTBL struct ID3D12Device6Vtbl d3d12_device_vtbl_profiled;
+    extern CONST_VTBL struct ID3D12Device7Vtbl d3d12_device_vtbl_profiled;
 #endif
     if (!iface)
         return NULL;
@@ -2863,8 +3392,10 @@ static inline struct d3d12_device *impl_from_ID3D12Device(d3d12_device_iface *if
 
 bool d3d12_device_validate_shader_meta(struct d3d12_device *device, const struct vkd3d_shader_meta *meta);
 
-HRESULT d3d12_device_get_scratch_buffer(struct d3d12_device *device, VkDeviceSize min_size, struct vkd3d_scratch_buffer *scratch);
-void d3d12_device_return_scratch_buffer(struct d3d12_device *device, const struct vkd3d_scratch_buffer *scratch);
+HRESULT d3d12_device_get_scratch_buffer(struct d3d12_device *device, enum vkd3d_scratch_pool_kind kind,
+        VkDeviceSize min_size, struct vkd3d_scratch_buffer *scratch);
+void d3d12_device_return_scratch_buffer(struct d3d12_device *device, enum vkd3d_scratch_pool_kind kind,
+        const struct vkd3d_scratch_buffer *scratch);
 
 HRESULT d3d12_device_get_query_pool(struct d3d12_device *device, uint32_t type_index, struct vkd3d_query_pool *pool);
 void d3d12_device_return_query_pool(struct d3d12_device *device, const struct vkd3d_query_pool *pool);
@@ -2898,23 +3429,23 @@ static inline const struct vkd3d_memory_info_domain *d3d12_device_get_memory_inf
 
 static inline HRESULT d3d12_device_query_interface(struct d3d12_device *device, REFIID iid, void **object)
 {
-    return ID3D12Device6_QueryInterface(&device->ID3D12Device_iface, iid, object);
+    return ID3D12Device7_QueryInterface(&device->ID3D12Device_iface, iid, object);
 }
 
 static inline ULONG d3d12_device_add_ref(struct d3d12_device *device)
 {
-    return ID3D12Device6_AddRef(&device->ID3D12Device_iface);
+    return ID3D12Device7_AddRef(&device->ID3D12Device_iface);
 }
 
 static inline ULONG d3d12_device_release(struct d3d12_device *device)
 {
-    return ID3D12Device6_Release(&device->ID3D12Device_iface);
+    return ID3D12Device7_Release(&device->ID3D12Device_iface);
 }
 
 static inline unsigned int d3d12_device_get_descriptor_handle_increment_size(struct d3d12_device *device,
         D3D12_DESCRIPTOR_HEAP_TYPE descriptor_type)
 {
-    return ID3D12Device6_GetDescriptorHandleIncrementSize(&device->ID3D12Device_iface, descriptor_type);
+    return ID3D12Device7_GetDescriptorHandleIncrementSize(&device->ID3D12Device_iface, descriptor_type);
 }
 
 static inline bool d3d12_device_use_ssbo_raw_buffer(struct d3d12_device *device)
@@ -2935,6 +3466,18 @@ static inline bool d3d12_device_use_ssbo_root_descriptors(struct d3d12_device *d
             d3d12_device_get_ssbo_alignment(device) <= 4;
 }
 
+/* Most applications never serialize PSOs, so PSOs only keep the data needed for
+ * cached blobs once the application has created or requested one. */
+static inline void d3d12_device_mark_pipeline_blob_usage(struct d3d12_device *device)
+{
+    vkd3d_atomic_uint32_store_explicit(&device->pipeline_blob_usage, 1, vkd3d_memory_order_relaxed);
+}
+
+static inline bool d3d12_device_uses_pipeline_blobs(struct d3d12_device *device)
+{
+    return !!vkd3d_atomic_uint32_load_explicit(&device->pipeline_blob_usage, vkd3d_memory_order_relaxed);
+}
+
 bool d3d12_device_supports_variable_shading_rate_tier_1(struct d3d12_device *device);
 bool d3d12_device_supports_ray_tracing_tier_1_0(const struct d3d12_device *device);
 
@@ -3009,6 +3552,15 @@ struct d3d12_state_object
      * export externally, and stages_count matches pStages[] size for purposes of index fixups. */
 
     VkPipeline pipeline;
+    /* With ALLOW_STATE_OBJECT_ADDITIONS, pipeline is linked from this library,
+     * so that additions can link against the same compiled groups. */
+    VkPipeline pipeline_library;
+
+    /* Inherited by additions which do not override them. Like native drivers,
+     * no reference is held on the root signature. */
+    D3D12_RAYTRACING_PIPELINE_CONFIG pipeline_config;
+    D3D12_RAYTRACING_SHADER_CONFIG shader_config;
+    ID3D12RootSignature *global_root_signature;
 
     struct
     {
@@ -3030,6 +3582,8 @@ struct d3d12_state_object
 
 HRESULT d3d12_state_object_create(struct d3d12_device *device, const D3D12_STATE_OBJECT_DESC *desc,
         struct d3d12_state_object **object);
+HRESULT d3d12_state_object_add(struct d3d12_device *device, const D3D12_STATE_OBJECT_DESC *addition,
+        struct d3d12_state_object *parent, struct d3d12_state_object **object);
 
 static inline struct d3d12_state_object *impl_from_ID3D12StateObject(ID3D12StateObject *iface)
 {
@@ -3093,6 +3647,8 @@ const struct vkd3d_format *vkd3d_get_format(const struct d3d12_device *device,
 DXGI_FORMAT vkd3d_get_typeless_format(const struct d3d12_device *device, DXGI_FORMAT dxgi_format);
 const struct vkd3d_format *vkd3d_find_uint_format(const struct d3d12_device *device,
         DXGI_FORMAT dxgi_format);
+const struct vkd3d_format_compatibility_list *vkd3d_get_format_compatibility_list(
+        const struct d3d12_device *device, DXGI_FORMAT dxgi_format);
 VkFormat vkd3d_internal_get_vk_format(const struct d3d12_device *device, DXGI_FORMAT dxgi_format);
 struct vkd3d_format_footprint vkd3d_format_footprint_for_plane(const struct vkd3d_format *format, unsigned int plane_idx);
 
@@ -3267,6 +3823,14 @@ struct vkd3d_view_key
 };
 struct vkd3d_view *vkd3d_view_map_create_view(struct vkd3d_view_map *view_map,
         struct d3d12_device *device, const struct vkd3d_view_key *key);
+/* Returns a new reference, and marks the view as recently used. */
+struct vkd3d_view *vkd3d_view_map_acquire_view(struct vkd3d_view_map *view_map,
+        struct d3d12_device *device, const struct vkd3d_view_key *key);
+/* Acquires a buffer view, and records that size bytes of data are placed at its offset.
+ * The map drops its reference to views whose placed data overlaps. Only valid for views
+ * which users always acquire. */
+struct vkd3d_view *vkd3d_view_map_place_view(struct vkd3d_view_map *view_map,
+        struct d3d12_device *device, const struct vkd3d_view_key *key, VkDeviceSize size);
 
 /* Acceleration structure helpers. */
 struct vkd3d_acceleration_structure_build_info
@@ -3290,6 +3854,12 @@ void vkd3d_acceleration_structure_build_info_cleanup(
 bool vkd3d_acceleration_structure_convert_inputs(const struct d3d12_device *device,
         struct vkd3d_acceleration_structure_build_info *info,
         const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS *desc);
+
+void vkd3d_acceleration_structure_prebuild_cache_init(struct vkd3d_acceleration_structure_prebuild_cache *cache);
+void vkd3d_acceleration_structure_prebuild_cache_cleanup(struct vkd3d_acceleration_structure_prebuild_cache *cache);
+bool vkd3d_acceleration_structure_get_prebuild_info(struct d3d12_device *device,
+        const D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS *desc,
+        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO *info);
 void vkd3d_acceleration_structure_emit_postbuild_info(
         struct d3d12_command_list *list,
         const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC *desc,
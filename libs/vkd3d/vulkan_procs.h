@@ -197,6 +197,13 @@ VK_DEVICE_EXT_PFN(vkCmdDrawIndexedIndirectCountKHR)
 /* VK_KHR_push_descriptor */
 VK_DEVICE_EXT_PFN(vkCmdPushDescriptorSetKHR)
 
+/* VK_KHR_deferred_host_operations */
+VK_DEVICE_EXT_PFN(vkCreateDeferredOperationKHR)
+VK_DEVICE_EXT_PFN(vkDestroyDeferredOperationKHR)
+VK_DEVICE_EXT_PFN(vkGetDeferredOperationMaxConcurrencyKHR)
+VK_DEVICE_EXT_PFN(vkGetDeferredOperationResultKHR)
+VK_DEVICE_EXT_PFN(vkDeferredOperationJoinKHR)
+
 /* VK_KHR_ray_tracing_pipeline */
 VK_DEVICE_EXT_PFN(vkCreateRayTracingPipelinesKHR)
 VK_DEVICE_EXT_PFN(vkGetRayTracingShaderGroupHandlesKHR)
@@ -224,6 +231,9 @@ VK_DEVICE_EXT_PFN(vkCmdEndRenderPass2KHR)
 VK_DEVICE_EXT_PFN(vkCmdNextSubpass2KHR)
 VK_DEVICE_EXT_PFN(vkCreateRenderPass2KHR)
 
+/* VK_KHR_synchronization2 */
+VK_DEVICE_EXT_PFN(vkCmdPipelineBarrier2KHR)
+
 /* VK_EXT_calibrated_timestamps */
 VK_DEVICE_EXT_PFN(vkGetCalibratedTimestampsEXT)
 VK_INSTANCE_EXT_PFN(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)
@@ -254,6 +264,11 @@ VK_DEVICE_EXT_PFN(vkCmdSetViewportWithCountEXT)
 /* VK_EXT_external_memory_host */
 VK_DEVICE_EXT_PFN(vkGetMemoryHostPointerPropertiesEXT)
 
+/* VK_EXT_mesh_shader */
+VK_DEVICE_EXT_PFN(vkCmdDrawMeshTasksEXT)
+VK_DEVICE_EXT_PFN(vkCmdDrawMeshTasksIndirectEXT)
+VK_DEVICE_EXT_PFN(vkCmdDrawMeshTasksIndirectCountEXT)
+
 /* VK_KHR_surface */
 VK_INSTANCE_EXT_PFN(vkGetPhysicalDeviceSurfacePresentModesKHR)
 VK_INSTANCE_EXT_PFN(vkGetPhysicalDeviceSurfaceSupportKHR)
@@ -69,12 +69,34 @@ def per_iteration_normalize(block):
     return ProfileCase(name = block.name, iterations = block.iterations, ticks = block.ticks / block.iterations)
 
 
+def print_vk_calls(blocks, interval, sort):
+    interval_block = find_record_by_name(blocks, 'vk interval: ' + interval)
+    if interval_block is None:
+        raise AssertionError('Interval ' + interval + ' was not sampled.')
+
+    vk_blocks = [block for block in blocks if block.name.startswith('vk: ')]
+    if sort == 'ticks':
+        vk_blocks.sort(reverse = True, key = lambda a: a.ticks)
+    else:
+        vk_blocks.sort(reverse = True, key = lambda a: a.iterations)
+
+    intervals = interval_block.iterations
+    print('Vulkan calls per {} ({} samples, {:.3f} us per interval):'.format(
+        interval, intervals, interval_block.ticks / intervals / 1000.0))
+    print('    {:<48} {:>14} {:>14}'.format('Entry point', 'Calls', 'Time (us)'))
+    for block in vk_blocks:
+        print('    {:<48} {:>14.2f} {:>14.3f}'.format(block.name[4:],
+            block.iterations / intervals, block.ticks / intervals / 1000.0))
+
+
 def main():
     parser = argparse.ArgumentParser(description = 'Script for parsing profiling data.')
     parser.add_argument('--divider', type = str, help = 'Represent data in terms of count per divider. Divider is another counter name.')
     parser.add_argument('--per-iteration', action = 'store_true', help = 'Represent ticks in terms of ticks / iteration. Cannot be used with --divider.')
     parser.add_argument('--name', nargs = '+', type = str, help = 'Only display data for certain counters.')
     parser.add_argument('--sort', type = str, default = 'none', help = 'Sorts input data according to "iterations" or "ticks".')
+    parser.add_argument('--vk-calls', action = 'store_true', help = 'Display Vulkan call counts and CPU time per sampling interval.')
+    parser.add_argument('--vk-interval', type = str, default = 'Present', help = 'Sampling interval for --vk-calls, "Present" or "ExecuteCommandLists".')
     parser.add_argument('profile', help = 'The profile binary blob.')
 
     args = parser.parse_args()
@@ -87,6 +109,10 @@ def main():
             if is_valid_block(block):
                 blocks.append(parse_block(block))
 
+    if args.vk_calls:
+        print_vk_calls(blocks, args.vk_interval, args.sort)
+        return
+
     if args.divider is not None:
         if args.per_iteration:
             raise AssertionError('Cannot use --per-iteration alongside --divider.')
@@ -413,6 +413,67 @@ void test_clear_render_target_view(void)
     destroy_test_context(&context);
 }
 
+void test_clear_bound_render_target_view(void)
+{
+    static const float white[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    static const float blue[] = {0.0f, 0.0f, 1.0f, 1.0f};
+    static const float red[] = {1.0f, 0.0f, 0.0f, 1.0f};
+    ID3D12GraphicsCommandList *command_list;
+    struct resource_readback rb;
+    struct test_context context;
+    ID3D12CommandQueue *queue;
+    unsigned int width, height;
+    RECT scissor_rect;
+    D3D12_BOX box;
+
+    if (!init_test_context(&context, NULL))
+        return;
+    command_list = context.list;
+    queue = context.queue;
+
+    width = context.render_target_desc.Width;
+    height = context.render_target_desc.Height;
+    set_rect(&scissor_rect, 0, 0, width / 2, height);
+
+    /* Clears of a bound view outside of a render pass may become the load op of the next render pass. */
+    ID3D12GraphicsCommandList_OMSetRenderTargets(command_list, 1, &context.rtv, false, NULL);
+    ID3D12GraphicsCommandList_ClearRenderTargetView(command_list, context.rtv, white, 0, NULL);
+    ID3D12GraphicsCommandList_ClearRenderTargetView(command_list, context.rtv, red, 0, NULL);
+    ID3D12GraphicsCommandList_SetGraphicsRootSignature(command_list, context.root_signature);
+    ID3D12GraphicsCommandList_SetPipelineState(command_list, context.pipeline_state);
+    ID3D12GraphicsCommandList_IASetPrimitiveTopology(command_list, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    ID3D12GraphicsCommandList_RSSetViewports(command_list, 1, &context.viewport);
+    ID3D12GraphicsCommandList_RSSetScissorRects(command_list, 1, &scissor_rect);
+    ID3D12GraphicsCommandList_DrawInstanced(command_list, 3, 1, 0, 0);
+
+    /* The render pass is active now, the clear is recorded inline. */
+    ID3D12GraphicsCommandList_ClearRenderTargetView(command_list, context.rtv, blue, 0, NULL);
+    set_rect(&scissor_rect, 0, 0, width, height / 2);
+    ID3D12GraphicsCommandList_RSSetScissorRects(command_list, 1, &scissor_rect);
+    ID3D12GraphicsCommandList_DrawInstanced(command_list, 3, 1, 0, 0);
+
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    get_texture_readback_with_command_list(context.render_target, 0, &rb, queue, command_list);
+    set_box(&box, 0, 0, 0, width, height / 2, 1);
+    check_readback_data_uint(&rb, &box, 0xff00ff00, 0);
+    set_box(&box, 0, height / 2, 0, width, height, 1);
+    check_readback_data_uint(&rb, &box, 0xffff0000, 0);
+    release_resource_readback(&rb);
+
+    /* Clears which are never followed by a draw must still be performed. */
+    reset_command_list(command_list, context.allocator);
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    ID3D12GraphicsCommandList_OMSetRenderTargets(command_list, 1, &context.rtv, false, NULL);
+    ID3D12GraphicsCommandList_ClearRenderTargetView(command_list, context.rtv, red, 0, NULL);
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    check_sub_resource_uint(context.render_target, 0, queue, command_list, 0xff0000ff, 0);
+
+    destroy_test_context(&context);
+}
+
 void test_clear_unordered_access_view_buffer(void)
 {
     D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc;
@@ -920,3 +981,258 @@ void test_clear_unordered_access_view_image(void)
 #undef IMAGE_SIZE
 }
 
+void test_clear_unordered_access_view_image_formats(void)
+{
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc;
+    ID3D12DescriptorHeap *cpu_heap, *gpu_heap;
+    ID3D12GraphicsCommandList *command_list;
+    D3D12_HEAP_PROPERTIES heap_properties;
+    D3D12_RESOURCE_DESC resource_desc;
+    struct test_context_desc desc;
+    struct test_context context;
+    struct resource_readback rb;
+    ID3D12CommandQueue *queue;
+    uint32_t got;
+    ID3D12Resource *texture;
+    ID3D12Device *device;
+    unsigned int i, j;
+    HRESULT hr;
+
+    static const UINT clear_value[4] = {1, 2, 3, 4};
+
+    /* Every typed UAV format is cleared through a UINT view, both for fully typed
+     * resources and for resources created with the typeless format of the family. */
+    static const struct
+    {
+        DXGI_FORMAT format;
+        DXGI_FORMAT typeless_format;
+        unsigned int byte_count;
+        uint32_t expected;
+    }
+    tests[] =
+    {
+        {DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_TYPELESS, 16, 0x00000001},
+        {DXGI_FORMAT_R32G32B32A32_UINT,  DXGI_FORMAT_R32G32B32A32_TYPELESS, 16, 0x00000001},
+        {DXGI_FORMAT_R32G32B32A32_SINT,  DXGI_FORMAT_R32G32B32A32_TYPELESS, 16, 0x00000001},
+        {DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R16G16B16A16_TYPELESS,  8, 0x00020001},
+        {DXGI_FORMAT_R16G16B16A16_UNORM, DXGI_FORMAT_R16G16B16A16_TYPELESS,  8, 0x00020001},
+        {DXGI_FORMAT_R16G16B16A16_UINT,  DXGI_FORMAT_R16G16B16A16_TYPELESS,  8, 0x00020001},
+        {DXGI_FORMAT_R16G16B16A16_SNORM, DXGI_FORMAT_R16G16B16A16_TYPELESS,  8, 0x00020001},
+        {DXGI_FORMAT_R16G16B16A16_SINT,  DXGI_FORMAT_R16G16B16A16_TYPELESS,  8, 0x00020001},
+        {DXGI_FORMAT_R32G32_FLOAT,       DXGI_FORMAT_R32G32_TYPELESS,        8, 0x00000001},
+        {DXGI_FORMAT_R32G32_UINT,        DXGI_FORMAT_R32G32_TYPELESS,        8, 0x00000001},
+        {DXGI_FORMAT_R32G32_SINT,        DXGI_FORMAT_R32G32_TYPELESS,        8, 0x00000001},
+        {DXGI_FORMAT_R10G10B10A2_UNORM,  DXGI_FORMAT_R10G10B10A2_TYPELESS,   4, 0x00300801},
+        {DXGI_FORMAT_R10G10B10A2_UINT,   DXGI_FORMAT_R10G10B10A2_TYPELESS,   4, 0x00300801},
+        {DXGI_FORMAT_R11G11B10_FLOAT,    DXGI_FORMAT_UNKNOWN,                4, 0x00c01001},
+        {DXGI_FORMAT_R8G8B8A8_UNORM,     DXGI_FORMAT_R8G8B8A8_TYPELESS,      4, 0x04030201},
+        {DXGI_FORMAT_R8G8B8A8_UINT,      DXGI_FORMAT_R8G8B8A8_TYPELESS,      4, 0x04030201},
+        {DXGI_FORMAT_R8G8B8A8_SNORM,     DXGI_FORMAT_R8G8B8A8_TYPELESS,      4, 0x04030201},
+        {DXGI_FORMAT_R8G8B8A8_SINT,      DXGI_FORMAT_R8G8B8A8_TYPELESS,      4, 0x04030201},
+        {DXGI_FORMAT_R16G16_FLOAT,       DXGI_FORMAT_R16G16_TYPELESS,        4, 0x00020001},
+        {DXGI_FORMAT_R16G16_UNORM,       DXGI_FORMAT_R16G16_TYPELESS,        4, 0x00020001},
+        {DXGI_FORMAT_R16G16_UINT,        DXGI_FORMAT_R16G16_TYPELESS,        4, 0x00020001},
+        {DXGI_FORMAT_R16G16_SNORM,       DXGI_FORMAT_R16G16_TYPELESS,        4, 0x00020001},
+        {DXGI_FORMAT_R16G16_SINT,        DXGI_FORMAT_R16G16_TYPELESS,        4, 0x00020001},
+        {DXGI_FORMAT_R32_FLOAT,          DXGI_FORMAT_R32_TYPELESS,           4, 0x00000001},
+        {DXGI_FORMAT_R32_UINT,           DXGI_FORMAT_R32_TYPELESS,           4, 0x00000001},
+        {DXGI_FORMAT_R32_SINT,           DXGI_FORMAT_R32_TYPELESS,           4, 0x00000001},
+        {DXGI_FORMAT_R8G8_UNORM,         DXGI_FORMAT_R8G8_TYPELESS,          2, 0x00000201},
+        {DXGI_FORMAT_R8G8_UINT,          DXGI_FORMAT_R8G8_TYPELESS,          2, 0x00000201},
+        {DXGI_FORMAT_R8G8_SNORM,         DXGI_FORMAT_R8G8_TYPELESS,          2, 0x00000201},
+        {DXGI_FORMAT_R8G8_SINT,          DXGI_FORMAT_R8G8_TYPELESS,          2, 0x00000201},
+        {DXGI_FORMAT_R16_FLOAT,          DXGI_FORMAT_R16_TYPELESS,           2, 0x00000001},
+        {DXGI_FORMAT_R16_UNORM,          DXGI_FORMAT_R16_TYPELESS,           2, 0x00000001},
+        {DXGI_FORMAT_R16_UINT,           DXGI_FORMAT_R16_TYPELESS,           2, 0x00000001},
+        {DXGI_FORMAT_R16_SNORM,          DXGI_FORMAT_R16_TYPELESS,           2, 0x00000001},
+        {DXGI_FORMAT_R16_SINT,           DXGI_FORMAT_R16_TYPELESS,           2, 0x00000001},
+        {DXGI_FORMAT_R8_UNORM,           DXGI_FORMAT_R8_TYPELESS,            1, 0x00000001},
+        {DXGI_FORMAT_R8_UINT,            DXGI_FORMAT_R8_TYPELESS,            1, 0x00000001},
+        {DXGI_FORMAT_R8_SNORM,           DXGI_FORMAT_R8_TYPELESS,            1, 0x00000001},
+        {DXGI_FORMAT_R8_SINT,            DXGI_FORMAT_R8_TYPELESS,            1, 0x00000001},
+    };
+
+    memset(&desc, 0, sizeof(desc));
+    desc.no_render_target = true;
+    if (!init_test_context(&context, &desc))
+        return;
+    device = context.device;
+    command_list = context.list;
+    queue = context.queue;
+
+    cpu_heap = create_cpu_descriptor_heap(device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1);
+    gpu_heap = create_gpu_descriptor_heap(device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1);
+
+    memset(&heap_properties, 0, sizeof(heap_properties));
+    heap_properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+    for (i = 0; i < ARRAY_SIZE(tests); ++i)
+    {
+        for (j = 0; j < 2; ++j)
+        {
+            vkd3d_test_set_context("Test %u, %s", i, j ? "typeless" : "typed");
+
+            if (j && tests[i].typeless_format == DXGI_FORMAT_UNKNOWN)
+                continue;
+
+            resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            resource_desc.Alignment = 0;
+            resource_desc.Width = 4;
+            resource_desc.Height = 4;
+            resource_desc.DepthOrArraySize = 1;
+            resource_desc.MipLevels = 1;
+            resource_desc.Format = j ? tests[i].typeless_format : tests[i].format;
+            resource_desc.SampleDesc.Count = 1;
+            resource_desc.SampleDesc.Quality = 0;
+            resource_desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            resource_desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+            if (FAILED(hr = ID3D12Device_CreateCommittedResource(device, &heap_properties,
+                    D3D12_HEAP_FLAG_NONE, &resource_desc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                    NULL, &IID_ID3D12Resource, (void **)&texture)))
+            {
+                skip("Failed to create texture, hr %#x.\n", hr);
+                continue;
+            }
+
+            memset(&uav_desc, 0, sizeof(uav_desc));
+            uav_desc.Format = tests[i].format;
+            uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+
+            ID3D12Device_CreateUnorderedAccessView(device, texture, NULL,
+                    &uav_desc, get_cpu_descriptor_handle(&context, cpu_heap, 0));
+            ID3D12Device_CreateUnorderedAccessView(device, texture, NULL,
+                    &uav_desc, get_cpu_descriptor_handle(&context, gpu_heap, 0));
+
+            ID3D12GraphicsCommandList_ClearUnorderedAccessViewUint(command_list,
+                    get_gpu_descriptor_handle(&context, gpu_heap, 0),
+                    get_cpu_descriptor_handle(&context, cpu_heap, 0),
+                    texture, clear_value, 0, NULL);
+
+            transition_resource_state(command_list, texture,
+                    D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE);
+            get_texture_readback_with_command_list(texture, 0, &rb, queue, command_list);
+
+            got = 0;
+            memcpy(&got, get_readback_data(&rb, 0, 0, 0, tests[i].byte_count),
+                    min(tests[i].byte_count, sizeof(got)));
+            ok(got == tests[i].expected, "Expected %#x, got %#x.\n", tests[i].expected, got);
+
+            release_resource_readback(&rb);
+            reset_command_list(command_list, context.allocator);
+            ID3D12Resource_Release(texture);
+        }
+    }
+    vkd3d_test_set_context(NULL);
+
+    ID3D12DescriptorHeap_Release(cpu_heap);
+    ID3D12DescriptorHeap_Release(gpu_heap);
+    destroy_test_context(&context);
+}
+
+void test_clear_unordered_access_view_image_r32_views(void)
+{
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc;
+    ID3D12DescriptorHeap *cpu_heap, *gpu_heap;
+    ID3D12GraphicsCommandList *command_list;
+    D3D12_HEAP_PROPERTIES heap_properties;
+    D3D12_RESOURCE_DESC resource_desc;
+    struct test_context_desc desc;
+    struct test_context context;
+    struct resource_readback rb;
+    ID3D12CommandQueue *queue;
+    ID3D12Resource *texture;
+    ID3D12Device *device;
+    unsigned int i, j;
+    uint32_t got;
+    HRESULT hr;
+
+    static const UINT clear_value[4] = {0x11223344, 2, 3, 4};
+
+    /* Any 32bpp typeless resource may be accessed through R32 UAVs. */
+    static const DXGI_FORMAT typeless_formats[] =
+    {
+        DXGI_FORMAT_R10G10B10A2_TYPELESS,
+        DXGI_FORMAT_R8G8B8A8_TYPELESS,
+        DXGI_FORMAT_R16G16_TYPELESS,
+        DXGI_FORMAT_B8G8R8A8_TYPELESS,
+    };
+    static const DXGI_FORMAT view_formats[] =
+    {
+        DXGI_FORMAT_R32_UINT,
+        DXGI_FORMAT_R32_SINT,
+    };
+
+    memset(&desc, 0, sizeof(desc));
+    desc.no_render_target = true;
+    if (!init_test_context(&context, &desc))
+        return;
+    device = context.device;
+    command_list = context.list;
+    queue = context.queue;
+
+    cpu_heap = create_cpu_descriptor_heap(device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1);
+    gpu_heap = create_gpu_descriptor_heap(device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1);
+
+    memset(&heap_properties, 0, sizeof(heap_properties));
+    heap_properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+    for (i = 0; i < ARRAY_SIZE(typeless_formats); ++i)
+    {
+        for (j = 0; j < ARRAY_SIZE(view_formats); ++j)
+        {
+            vkd3d_test_set_context("Format %#x, view format %#x", typeless_formats[i], view_formats[j]);
+
+            resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            resource_desc.Alignment = 0;
+            resource_desc.Width = 4;
+            resource_desc.Height = 4;
+            resource_desc.DepthOrArraySize = 1;
+            resource_desc.MipLevels = 1;
+            resource_desc.Format = typeless_formats[i];
+            resource_desc.SampleDesc.Count = 1;
+            resource_desc.SampleDesc.Quality = 0;
+            resource_desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            resource_desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+            if (FAILED(hr = ID3D12Device_CreateCommittedResource(device, &heap_properties,
+                    D3D12_HEAP_FLAG_NONE, &resource_desc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                    NULL, &IID_ID3D12Resource, (void **)&texture)))
+            {
+                skip("Failed to create texture, hr %#x.\n", hr);
+                continue;
+            }
+
+            memset(&uav_desc, 0, sizeof(uav_desc));
+            uav_desc.Format = view_formats[j];
+            uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+
+            ID3D12Device_CreateUnorderedAccessView(device, texture, NULL,
+                    &uav_desc, get_cpu_descriptor_handle(&context, cpu_heap, 0));
+            ID3D12Device_CreateUnorderedAccessView(device, texture, NULL,
+                    &uav_desc, get_cpu_descriptor_handle(&context, gpu_heap, 0));
+
+            ID3D12GraphicsCommandList_ClearUnorderedAccessViewUint(command_list,
+                    get_gpu_descriptor_handle(&context, gpu_heap, 0),
+                    get_cpu_descriptor_handle(&context, cpu_heap, 0),
+                    texture, clear_value, 0, NULL);
+
+            transition_resource_state(command_list, texture,
+                    D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE);
+            get_texture_readback_with_command_list(texture, 0, &rb, queue, command_list);
+
+            got = get_readback_uint(&rb, 3, 3, 0);
+            ok(got == clear_value[0], "Expected %#x, got %#x.\n", clear_value[0], got);
+
+            release_resource_readback(&rb);
+            reset_command_list(command_list, context.allocator);
+            ID3D12Resource_Release(texture);
+        }
+    }
+    vkd3d_test_set_context(NULL);
+
+    ID3D12DescriptorHeap_Release(cpu_heap);
+    ID3D12DescriptorHeap_Release(gpu_heap);
+    destroy_test_context(&context);
+}
+
@@ -21,6 +21,7 @@
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
 #include "d3d12_crosstest.h"
+#include "vkd3d_barrier.h"
 
 void test_set_render_targets(void)
 {
@@ -2576,6 +2577,43 @@ void test_conditional_rendering(void)
 
     check_sub_resource_uint(context.render_target, 0, queue, command_list, 0xff00ff00, 0);
 
+    reset_command_list(command_list, context.allocator);
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    /* Many predicated draws within a single predication span. */
+    ID3D12GraphicsCommandList_ClearRenderTargetView(command_list, context.rtv, white, 0, NULL);
+    prepare_instanced_draw(&context);
+    ID3D12GraphicsCommandList_SetPredication(command_list, conditions, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+    for (i = 0; i < 64; ++i)
+        ID3D12GraphicsCommandList_DrawInstanced(command_list, 3, 1, 0, 0);
+    ID3D12GraphicsCommandList_SetPredication(command_list, NULL, 0, 0);
+
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+    check_sub_resource_uint(context.render_target, 0, queue, command_list, 0xffffffff, 0);
+
+    reset_command_list(command_list, context.allocator);
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    ID3D12GraphicsCommandList_ClearRenderTargetView(command_list, context.rtv, white, 0, NULL);
+    prepare_instanced_draw(&context);
+    ID3D12GraphicsCommandList_SetPredication(command_list, conditions, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+    for (i = 0; i < 64; ++i)
+        ID3D12GraphicsCommandList_DrawInstanced(command_list, 3, 1, 0, 0);
+    ID3D12GraphicsCommandList_SetPredication(command_list, conditions,
+            sizeof(uint64_t), D3D12_PREDICATION_OP_EQUAL_ZERO);
+    for (i = 0; i < 64; ++i)
+        ID3D12GraphicsCommandList_DrawInstanced(command_list, 3, 1, 0, 0);
+    ID3D12GraphicsCommandList_SetPredication(command_list, NULL, 0, 0);
+
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+    check_sub_resource_uint(context.render_target, 0, queue, command_list, 0xff00ff00, 0);
+
     reset_command_list(command_list, context.allocator);
     transition_resource_state(command_list, context.render_target,
             D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
@@ -4044,3 +4082,113 @@ void test_conservative_rasterization_dxil(void)
     test_conservative_rasterization(true);
 }
 
+void test_enhanced_barrier_translation(void)
+{
+    static const struct
+    {
+        D3D12_BARRIER_SYNC sync;
+        VkPipelineStageFlags2KHR stages;
+    }
+    sync_tests[] =
+    {
+        {D3D12_BARRIER_SYNC_NONE, 0},
+        {D3D12_BARRIER_SYNC_ALL, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR},
+        {D3D12_BARRIER_SYNC_ALL | D3D12_BARRIER_SYNC_COPY, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR},
+        {D3D12_BARRIER_SYNC_DRAW, VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT_KHR},
+        {D3D12_BARRIER_SYNC_INDEX_INPUT, VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR},
+        {D3D12_BARRIER_SYNC_PIXEL_SHADING, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR},
+        {D3D12_BARRIER_SYNC_DEPTH_STENCIL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR |
+                VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR},
+        {D3D12_BARRIER_SYNC_RENDER_TARGET, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR},
+        {D3D12_BARRIER_SYNC_COMPUTE_SHADING, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR},
+        {D3D12_BARRIER_SYNC_RAYTRACING, VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR},
+        {D3D12_BARRIER_SYNC_COPY | D3D12_BARRIER_SYNC_RESOLVE, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR},
+        {D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR |
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR},
+        {D3D12_BARRIER_SYNC_ALL_SHADING, VKD3D_PIPELINE_STAGE_2_ALL_SHADERS},
+        {D3D12_BARRIER_SYNC_NON_PIXEL_SHADING, VKD3D_PIPELINE_STAGE_2_ALL_SHADERS &
+                ~VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR},
+        {D3D12_BARRIER_SYNC_BUILD_RAYTRACING_ACCELERATION_STRUCTURE,
+                VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR},
+        {D3D12_BARRIER_SYNC_VIDEO_DECODE, 0},
+    };
+    static const struct
+    {
+        D3D12_BARRIER_ACCESS access;
+        VkPipelineStageFlags2KHR stages;
+        VkAccessFlags2KHR vk_access;
+    }
+    access_tests[] =
+    {
+        {D3D12_BARRIER_ACCESS_COMMON, 0, VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_NO_ACCESS, 0, 0},
+        {D3D12_BARRIER_ACCESS_NO_ACCESS | D3D12_BARRIER_ACCESS_COPY_DEST, 0, 0},
+        {D3D12_BARRIER_ACCESS_VERTEX_BUFFER, 0, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_INDEX_BUFFER, 0, VK_ACCESS_2_INDEX_READ_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_RENDER_TARGET, 0, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR |
+                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_UNORDERED_ACCESS, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_UNORDERED_ACCESS, VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+                VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ, 0, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_SHADER_RESOURCE, 0, VK_ACCESS_2_SHADER_READ_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_COPY_SOURCE | D3D12_BARRIER_ACCESS_COPY_DEST, 0,
+                VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_RESOLVE_DEST, 0, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_READ, 0,
+                VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR},
+        {D3D12_BARRIER_ACCESS_SHADING_RATE_SOURCE, 0, VK_ACCESS_2_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR},
+    };
+    static const struct
+    {
+        D3D12_BARRIER_LAYOUT layout;
+        VkImageLayout vk_layout;
+    }
+    layout_tests[] =
+    {
+        {D3D12_BARRIER_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_UNDEFINED},
+        {D3D12_BARRIER_LAYOUT_COMMON, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL},
+        {D3D12_BARRIER_LAYOUT_GENERIC_READ, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL},
+        {D3D12_BARRIER_LAYOUT_SHADER_RESOURCE, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL},
+        {D3D12_BARRIER_LAYOUT_COPY_DEST, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL},
+        {D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_COMMON, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL},
+        {D3D12_BARRIER_LAYOUT_RENDER_TARGET, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+        {D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS, VK_IMAGE_LAYOUT_GENERAL},
+        {D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_UNORDERED_ACCESS, VK_IMAGE_LAYOUT_GENERAL},
+        {D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_UNORDERED_ACCESS, VK_IMAGE_LAYOUT_GENERAL},
+        {D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL},
+        {D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL},
+        {D3D12_BARRIER_LAYOUT_SHADING_RATE_SOURCE, VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR},
+    };
+    VkPipelineStageFlags2KHR stages;
+    VkAccessFlags2KHR vk_access;
+    VkImageLayout vk_layout;
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(sync_tests); i++)
+    {
+        stages = vk_stage_flags_from_d3d12_barrier_sync(sync_tests[i].sync);
+        ok(stages == sync_tests[i].stages, "Test %u: Got stages %#"PRIx64", expected %#"PRIx64".\n",
+                i, (uint64_t)stages, (uint64_t)sync_tests[i].stages);
+        /* Must be expressible with legacy barriers. */
+        ok(!(stages >> 32), "Test %u: Got 64-bit stages %#"PRIx64".\n", i, (uint64_t)stages);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(access_tests); i++)
+    {
+        vk_access = vk_access_flags_from_d3d12_barrier_access(access_tests[i].access, access_tests[i].stages);
+        ok(vk_access == access_tests[i].vk_access, "Test %u: Got access %#"PRIx64", expected %#"PRIx64".\n",
+                i, (uint64_t)vk_access, (uint64_t)access_tests[i].vk_access);
+        ok(!(vk_access >> 32), "Test %u: Got 64-bit access %#"PRIx64".\n", i, (uint64_t)vk_access);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(layout_tests); i++)
+    {
+        vk_layout = vk_image_layout_from_d3d12_barrier_layout(layout_tests[i].layout,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+        ok(vk_layout == layout_tests[i].vk_layout, "Test %u: Got layout %#x, expected %#x.\n",
+                i, vk_layout, layout_tests[i].vk_layout);
+    }
+}
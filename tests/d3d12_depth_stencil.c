@@ -1284,6 +1284,245 @@ void test_early_depth_stencil_tests(void)
     destroy_test_context(&context);
 }
 
+static void record_depth_only_draw(ID3D12GraphicsCommandList *command_list, struct test_context *context,
+        const D3D12_CPU_DESCRIPTOR_HANDLE *dsv, float x, float depth)
+{
+    D3D12_VIEWPORT viewport;
+
+    set_viewport(&viewport, x, 0.0f, 32.0f, 32.0f, 0.0f, 1.0f);
+    ID3D12GraphicsCommandList_OMSetRenderTargets(command_list, 0, NULL, false, dsv);
+    ID3D12GraphicsCommandList_SetGraphicsRootSignature(command_list, context->root_signature);
+    ID3D12GraphicsCommandList_SetPipelineState(command_list, context->pipeline_state);
+    ID3D12GraphicsCommandList_IASetPrimitiveTopology(command_list, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    ID3D12GraphicsCommandList_RSSetViewports(command_list, 1, &viewport);
+    ID3D12GraphicsCommandList_RSSetScissorRects(command_list, 1, &context->scissor_rect);
+    ID3D12GraphicsCommandList_SetGraphicsRoot32BitConstants(command_list, 0, 1, &depth, 0);
+    ID3D12GraphicsCommandList_DrawInstanced(command_list, 3, 1, 0, 0);
+}
+
+static void init_depth_only_pipeline_state(struct test_context *context)
+{
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC pso_desc;
+    HRESULT hr;
+
+    static const DWORD ps_code[] =
+    {
+#if 0
+        float depth;
+
+        float main() : SV_Depth
+        {
+            return depth;
+        }
+#endif
+        0x43425844, 0x91af6cd0, 0x7e884502, 0xcede4f54, 0x6f2c9326, 0x00000001, 0x000000b0, 0x00000003,
+        0x0000002c, 0x0000003c, 0x00000070, 0x4e475349, 0x00000008, 0x00000000, 0x00000008, 0x4e47534f,
+        0x0000002c, 0x00000001, 0x00000008, 0x00000020, 0x00000000, 0x00000000, 0x00000003, 0xffffffff,
+        0x00000e01, 0x445f5653, 0x68747065, 0xababab00, 0x52444853, 0x00000038, 0x00000040, 0x0000000e,
+        0x04000059, 0x00208e46, 0x00000000, 0x00000001, 0x02000065, 0x0000c001, 0x05000036, 0x0000c001,
+        0x0020800a, 0x00000000, 0x00000000, 0x0100003e,
+    };
+    static const D3D12_SHADER_BYTECODE ps = {ps_code, sizeof(ps_code)};
+
+    context->root_signature = create_32bit_constants_root_signature(context->device,
+            0, 1, D3D12_SHADER_VISIBILITY_PIXEL);
+    init_pipeline_state_desc(&pso_desc, context->root_signature, 0, NULL, &ps, NULL);
+    pso_desc.NumRenderTargets = 0;
+    pso_desc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+    pso_desc.DepthStencilState.DepthEnable = true;
+    pso_desc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+    pso_desc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+    hr = ID3D12Device_CreateGraphicsPipelineState(context->device, &pso_desc,
+            &IID_ID3D12PipelineState, (void **)&context->pipeline_state);
+    ok(SUCCEEDED(hr), "Failed to create graphics pipeline state, hr %#x.\n", hr);
+}
+
+void test_depth_layout_across_command_lists(void)
+{
+    ID3D12GraphicsCommandList *command_lists[2];
+    ID3D12CommandAllocator *allocators[2];
+    struct depth_stencil_resource ds;
+    struct test_context_desc desc;
+    struct resource_readback rb;
+    struct test_context context;
+    ID3D12CommandQueue *queue;
+    float depth;
+    HRESULT hr;
+
+    /* Depth buffers left in DEPTH_WRITE state at the end of a command list may stay
+     * in an optimal layout until the next command list, make sure contents and
+     * layouts stay coherent no matter how command lists are batched. */
+    memset(&desc, 0, sizeof(desc));
+    desc.no_render_target = true;
+    if (!init_test_context(&context, &desc))
+        return;
+    queue = context.queue;
+
+    init_depth_stencil(&ds, context.device, 64, 32, 1, 1, DXGI_FORMAT_D32_FLOAT, 0, NULL);
+    set_rect(&context.scissor_rect, 0, 0, 64, 32);
+    init_depth_only_pipeline_state(&context);
+
+    command_lists[0] = context.list;
+    allocators[0] = context.allocator;
+    hr = ID3D12Device_CreateCommandAllocator(context.device, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            &IID_ID3D12CommandAllocator, (void **)&allocators[1]);
+    ok(SUCCEEDED(hr), "Failed to create command allocator, hr %#x.\n", hr);
+    hr = ID3D12Device_CreateCommandList(context.device, 0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            allocators[1], NULL, &IID_ID3D12GraphicsCommandList, (void **)&command_lists[1]);
+    ok(SUCCEEDED(hr), "Failed to create command list, hr %#x.\n", hr);
+
+    /* Both command lists are recorded before either is submitted. */
+    ID3D12GraphicsCommandList_ClearDepthStencilView(command_lists[0], ds.dsv_handle,
+            D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, NULL);
+    record_depth_only_draw(command_lists[0], &context, &ds.dsv_handle, 0.0f, 0.5f);
+    record_depth_only_draw(command_lists[0], &context, &ds.dsv_handle, 32.0f, 0.5f);
+    hr = ID3D12GraphicsCommandList_Close(command_lists[0]);
+    ok(SUCCEEDED(hr), "Failed to close command list, hr %#x.\n", hr);
+
+    record_depth_only_draw(command_lists[1], &context, &ds.dsv_handle, 0.0f, 0.75f);
+    record_depth_only_draw(command_lists[1], &context, &ds.dsv_handle, 32.0f, 0.25f);
+    hr = ID3D12GraphicsCommandList_Close(command_lists[1]);
+    ok(SUCCEEDED(hr), "Failed to close command list, hr %#x.\n", hr);
+
+    ID3D12CommandQueue_ExecuteCommandLists(queue, 2, (ID3D12CommandList * const *)command_lists);
+    wait_queue_idle(context.device, queue);
+
+    /* Recorded after the resource was left in DEPTH_WRITE by an earlier submission. */
+    reset_command_list(command_lists[1], allocators[1]);
+    record_depth_only_draw(command_lists[1], &context, &ds.dsv_handle, 0.0f, 0.125f);
+    hr = ID3D12GraphicsCommandList_Close(command_lists[1]);
+    ok(SUCCEEDED(hr), "Failed to close command list, hr %#x.\n", hr);
+    exec_command_list(queue, command_lists[1]);
+    wait_queue_idle(context.device, queue);
+
+    reset_command_list(command_lists[0], allocators[0]);
+    transition_resource_state(command_lists[0], ds.texture,
+            D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    get_texture_readback_with_command_list(ds.texture, 0, &rb, queue, command_lists[0]);
+    depth = get_readback_float(&rb, 16, 16);
+    ok(compare_float(depth, 0.125f, 1), "Got unexpected depth %.8e, expected %.8e.\n", depth, 0.125f);
+    depth = get_readback_float(&rb, 48, 16);
+    ok(compare_float(depth, 0.25f, 1), "Got unexpected depth %.8e, expected %.8e.\n", depth, 0.25f);
+    release_resource_readback(&rb);
+
+    ID3D12GraphicsCommandList_Release(command_lists[1]);
+    ID3D12CommandAllocator_Release(allocators[1]);
+    destroy_depth_stencil(&ds);
+    destroy_test_context(&context);
+}
+
+void test_depth_layout_across_queues(void)
+{
+    ID3D12CommandAllocator *allocators[2], *copy_allocator;
+    ID3D12GraphicsCommandList *command_lists[2], *copy_list;
+    ID3D12CommandQueue *queues[2], *copy_queue;
+    struct depth_stencil_resource ds;
+    struct test_context_desc desc;
+    struct resource_readback rb;
+    struct test_context context;
+    ID3D12Fence *fence;
+    unsigned int i;
+    float depth;
+    HRESULT hr;
+
+    /* The layout a depth buffer is left in between command lists is tracked per resource,
+     * not per queue. Hand it over to another direct queue while it is still in an optimal
+     * layout, then to a copy queue, which needs the common layout and possibly a queue
+     * family ownership transfer. */
+    memset(&desc, 0, sizeof(desc));
+    desc.no_render_target = true;
+    if (!init_test_context(&context, &desc))
+        return;
+
+    init_depth_stencil(&ds, context.device, 64, 32, 1, 1, DXGI_FORMAT_D32_FLOAT, 0, NULL);
+    set_rect(&context.scissor_rect, 0, 0, 64, 32);
+    init_depth_only_pipeline_state(&context);
+
+    hr = ID3D12Device_CreateFence(context.device, 0, D3D12_FENCE_FLAG_NONE, &IID_ID3D12Fence, (void **)&fence);
+    ok(SUCCEEDED(hr), "Failed to create fence, hr %#x.\n", hr);
+
+    queues[0] = context.queue;
+    queues[1] = create_command_queue(context.device, D3D12_COMMAND_LIST_TYPE_DIRECT, D3D12_COMMAND_QUEUE_PRIORITY_NORMAL);
+    copy_queue = create_command_queue(context.device, D3D12_COMMAND_LIST_TYPE_COPY, D3D12_COMMAND_QUEUE_PRIORITY_NORMAL);
+
+    command_lists[0] = context.list;
+    allocators[0] = context.allocator;
+    hr = ID3D12Device_CreateCommandAllocator(context.device, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            &IID_ID3D12CommandAllocator, (void **)&allocators[1]);
+    ok(SUCCEEDED(hr), "Failed to create command allocator, hr %#x.\n", hr);
+    hr = ID3D12Device_CreateCommandList(context.device, 0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            allocators[1], NULL, &IID_ID3D12GraphicsCommandList, (void **)&command_lists[1]);
+    ok(SUCCEEDED(hr), "Failed to create command list, hr %#x.\n", hr);
+    hr = ID3D12Device_CreateCommandAllocator(context.device, D3D12_COMMAND_LIST_TYPE_COPY,
+            &IID_ID3D12CommandAllocator, (void **)&copy_allocator);
+    ok(SUCCEEDED(hr), "Failed to create command allocator, hr %#x.\n", hr);
+    hr = ID3D12Device_CreateCommandList(context.device, 0, D3D12_COMMAND_LIST_TYPE_COPY,
+            copy_allocator, NULL, &IID_ID3D12GraphicsCommandList, (void **)&copy_list);
+    ok(SUCCEEDED(hr), "Failed to create command list, hr %#x.\n", hr);
+
+    /* Left in DEPTH_WRITE. */
+    ID3D12GraphicsCommandList_ClearDepthStencilView(command_lists[0], ds.dsv_handle,
+            D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, NULL);
+    record_depth_only_draw(command_lists[0], &context, &ds.dsv_handle, 0.0f, 0.5f);
+    record_depth_only_draw(command_lists[0], &context, &ds.dsv_handle, 32.0f, 0.5f);
+    hr = ID3D12GraphicsCommandList_Close(command_lists[0]);
+    ok(SUCCEEDED(hr), "Failed to close command list, hr %#x.\n", hr);
+    exec_command_list(queues[0], command_lists[0]);
+    queue_signal(queues[0], fence, 1);
+
+    /* Picks up the layout left by the other queue, then decays to COMMON. */
+    queue_wait(queues[1], fence, 1);
+    record_depth_only_draw(command_lists[1], &context, &ds.dsv_handle, 0.0f, 0.25f);
+    transition_resource_state(command_lists[1], ds.texture,
+            D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_COMMON);
+    hr = ID3D12GraphicsCommandList_Close(command_lists[1]);
+    ok(SUCCEEDED(hr), "Failed to close command list, hr %#x.\n", hr);
+    exec_command_list(queues[1], command_lists[1]);
+    queue_signal(queues[1], fence, 2);
+
+    queue_wait(copy_queue, fence, 2);
+    get_texture_readback_with_command_list(ds.texture, 0, &rb, copy_queue, copy_list);
+    depth = get_readback_float(&rb, 16, 16);
+    ok(compare_float(depth, 0.25f, 1), "Got unexpected depth %.8e, expected %.8e.\n", depth, 0.25f);
+    depth = get_readback_float(&rb, 48, 16);
+    ok(compare_float(depth, 0.5f, 1), "Got unexpected depth %.8e, expected %.8e.\n", depth, 0.5f);
+    release_resource_readback(&rb);
+
+    /* Back on the first queue, the resource was decayed by the second queue. */
+    reset_command_list(command_lists[0], allocators[0]);
+    transition_resource_state(command_lists[0], ds.texture,
+            D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+    record_depth_only_draw(command_lists[0], &context, &ds.dsv_handle, 32.0f, 0.125f);
+    transition_resource_state(command_lists[0], ds.texture,
+            D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    hr = ID3D12GraphicsCommandList_Close(command_lists[0]);
+    ok(SUCCEEDED(hr), "Failed to close command list, hr %#x.\n", hr);
+    exec_command_list(queues[0], command_lists[0]);
+    wait_queue_idle(context.device, queues[0]);
+
+    reset_command_list(command_lists[0], allocators[0]);
+    get_texture_readback_with_command_list(ds.texture, 0, &rb, queues[0], command_lists[0]);
+    depth = get_readback_float(&rb, 16, 16);
+    ok(compare_float(depth, 0.25f, 1), "Got unexpected depth %.8e, expected %.8e.\n", depth, 0.25f);
+    depth = get_readback_float(&rb, 48, 16);
+    ok(compare_float(depth, 0.125f, 1), "Got unexpected depth %.8e, expected %.8e.\n", depth, 0.125f);
+    release_resource_readback(&rb);
+
+    for (i = 1; i < ARRAY_SIZE(queues); i++)
+    {
+        wait_queue_idle(context.device, queues[i]);
+        ID3D12GraphicsCommandList_Release(command_lists[i]);
+        ID3D12CommandAllocator_Release(allocators[i]);
+        ID3D12CommandQueue_Release(queues[i]);
+    }
+    ID3D12GraphicsCommandList_Release(copy_list);
+    ID3D12CommandAllocator_Release(copy_allocator);
+    ID3D12CommandQueue_Release(copy_queue);
+    ID3D12Fence_Release(fence);
+    destroy_depth_stencil(&ds);
+    destroy_test_context(&context);
+}
+
 static void test_stencil_export(bool use_dxil)
 {
     D3D12_SHADER_RESOURCE_VIEW_DESC stencil_srv_desc;
@@ -21,6 +21,7 @@
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
 #include "d3d12_crosstest.h"
+#include "vkd3d_memory.h"
 
 void test_create_device(void)
 {
@@ -70,6 +71,64 @@ void test_create_device(void)
     ok(hr == E_INVALIDARG, "Got unexpected hr %#x.\n", hr);
 }
 
+static const D3D_FEATURE_LEVEL d3d12_probe_feature_levels[] =
+{
+    D3D_FEATURE_LEVEL_12_2,
+    D3D_FEATURE_LEVEL_12_1,
+    D3D_FEATURE_LEVEL_12_0,
+    D3D_FEATURE_LEVEL_11_1,
+    D3D_FEATURE_LEVEL_11_0,
+};
+
+void test_create_device_probe(void)
+{
+    D3D12_FEATURE_DATA_FEATURE_LEVELS feature_levels;
+    HRESULT probe_hr[ARRAY_SIZE(d3d12_probe_feature_levels)];
+    ID3D12Device *device;
+    unsigned int i;
+    HRESULT hr;
+
+    /* Probe before creating a device, so the probe cannot piggyback on a live one. */
+    for (i = 0; i < ARRAY_SIZE(d3d12_probe_feature_levels); i++)
+        probe_hr[i] = D3D12CreateDevice(NULL, d3d12_probe_feature_levels[i], &IID_ID3D12Device, NULL);
+
+    hr = D3D12CreateDevice(NULL, D3D_FEATURE_LEVEL_11_0, &IID_ID3D12Device, (void **)&device);
+    if (FAILED(hr))
+    {
+        skip("Failed to create device, hr %#x.\n", hr);
+        return;
+    }
+
+    feature_levels.NumFeatureLevels = ARRAY_SIZE(d3d12_probe_feature_levels);
+    feature_levels.pFeatureLevelsRequested = d3d12_probe_feature_levels;
+    feature_levels.MaxSupportedFeatureLevel = 0;
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_FEATURE_LEVELS,
+            &feature_levels, sizeof(feature_levels));
+    ok(hr == S_OK, "Failed to check feature support, hr %#x.\n", hr);
+    ID3D12Device_Release(device);
+
+    for (i = 0; i < ARRAY_SIZE(d3d12_probe_feature_levels); i++)
+    {
+        vkd3d_test_set_context("Feature level %#x", d3d12_probe_feature_levels[i]);
+
+        if (d3d12_probe_feature_levels[i] <= feature_levels.MaxSupportedFeatureLevel)
+        {
+            ok(probe_hr[i] == S_FALSE, "Got unexpected hr %#x.\n", probe_hr[i]);
+
+            /* A real device at the same level must agree with the probe. */
+            hr = D3D12CreateDevice(NULL, d3d12_probe_feature_levels[i], &IID_ID3D12Device, (void **)&device);
+            ok(hr == S_OK, "Failed to create device, hr %#x.\n", hr);
+            if (SUCCEEDED(hr))
+                ID3D12Device_Release(device);
+        }
+        else
+        {
+            ok(probe_hr[i] == E_INVALIDARG, "Got unexpected hr %#x.\n", probe_hr[i]);
+        }
+    }
+    vkd3d_test_set_context(NULL);
+}
+
 void test_node_count(void)
 {
     ID3D12Device *device;
@@ -93,6 +152,11 @@ void test_node_count(void)
 void test_check_feature_support(void)
 {
     D3D12_FEATURE_DATA_GPU_VIRTUAL_ADDRESS_SUPPORT gpu_virtual_address;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS12 options12;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS10 options10;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS11 options11;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS8 options8;
+    D3D12_FEATURE_DATA_D3D12_OPTIONS9 options9;
     D3D12_FEATURE_DATA_FEATURE_LEVELS feature_levels;
     D3D12_FEATURE_DATA_ROOT_SIGNATURE root_signature;
     D3D_FEATURE_LEVEL max_supported_feature_level;
@@ -299,6 +363,33 @@ void test_check_feature_support(void)
             || root_signature.HighestVersion == D3D_ROOT_SIGNATURE_VERSION_1_1,
             "Got unexpected root signature feature version %#x.\n", root_signature.HighestVersion);
 
+    /* Options 8 to 12 */
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS8, &options8, sizeof(options8));
+    ok(hr == S_OK, "Failed to check options 8, hr %#x.\n", hr);
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS8, &options8, sizeof(options8) + 1);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#x.\n", hr);
+
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS9, &options9, sizeof(options9));
+    ok(hr == S_OK, "Failed to check options 9, hr %#x.\n", hr);
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS9, &options9, sizeof(options9) - 1);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#x.\n", hr);
+
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS10, &options10, sizeof(options10));
+    ok(hr == S_OK, "Failed to check options 10, hr %#x.\n", hr);
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS10, &options10, sizeof(options10) - 1);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#x.\n", hr);
+
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS11, &options11, sizeof(options11));
+    ok(hr == S_OK, "Failed to check options 11, hr %#x.\n", hr);
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS11, &options11, sizeof(options11) + 1);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#x.\n", hr);
+
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS12, &options12, sizeof(options12));
+    ok(hr == S_OK, "Failed to check options 12, hr %#x.\n", hr);
+    trace("Enhanced barriers supported: %#x.\n", options12.EnhancedBarriersSupported);
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS12, &options12, sizeof(options12) - 1);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#x.\n", hr);
+
     refcount = ID3D12Device_Release(device);
     ok(!refcount, "ID3D12Device has %u references left.\n", (unsigned int)refcount);
 }
@@ -1473,3 +1564,127 @@ void test_device_removed_reason(void)
     ok(!refcount, "ID3D12Device has %u references left.\n", (unsigned int)refcount);
 }
 
+
+#define HOST_ALLOCATOR_THREADS 8
+#define HOST_ALLOCATOR_SLOTS 256
+#define HOST_ALLOCATOR_ITERATIONS 100000
+
+struct host_allocator_thread_data
+{
+    unsigned int index;
+    unsigned int errors;
+};
+
+static void host_allocator_thread(void *userdata)
+{
+    struct host_allocator_thread_data *data = userdata;
+    uint8_t *slots[HOST_ALLOCATOR_SLOTS];
+    size_t sizes[HOST_ALLOCATOR_SLOTS];
+    uint32_t seed = data->index + 1;
+    unsigned int i, slot;
+    size_t j;
+
+    memset(slots, 0, sizeof(slots));
+    memset(sizes, 0, sizeof(sizes));
+
+    /* Small blocks are recycled through the per-thread cache, make sure a recycled
+     * block never aliases one which is still alive. */
+    for (i = 0; i < HOST_ALLOCATOR_ITERATIONS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        slot = (seed >> 8) % HOST_ALLOCATOR_SLOTS;
+
+        if (slots[slot])
+        {
+            for (j = 0; j < sizes[slot]; j++)
+            {
+                if (slots[slot][j] != (uint8_t)slot)
+                {
+                    data->errors++;
+                    break;
+                }
+            }
+            vkd3d_free(slots[slot]);
+        }
+
+        sizes[slot] = 1 + ((seed >> 20) & 0x3ff);
+        if ((slots[slot] = vkd3d_malloc(sizes[slot])))
+            memset(slots[slot], slot, sizes[slot]);
+        else
+            data->errors++;
+    }
+
+    for (i = 0; i < HOST_ALLOCATOR_SLOTS; i++)
+        vkd3d_free(slots[i]);
+}
+
+void test_host_allocator(void)
+{
+    struct host_allocator_thread_data data[HOST_ALLOCATOR_THREADS];
+    HANDLE threads[HOST_ALLOCATOR_THREADS];
+    static const size_t alignments[] = {1, 16, 64, 256, 4096};
+    uint8_t *ptr, *new_ptr;
+    unsigned int i;
+    size_t j;
+
+    for (i = 0; i < 64; i++)
+    {
+        ptr = vkd3d_malloc(i + 1);
+        ok(ptr && !((uintptr_t)ptr & 15), "Got unaligned pointer %p for size %u.\n", ptr, i + 1);
+        vkd3d_free(ptr);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(alignments); i++)
+    {
+        ptr = vkd3d_malloc_aligned(100, alignments[i]);
+        ok(ptr && !((uintptr_t)ptr & (alignments[i] - 1)), "Got pointer %p for alignment %u.\n",
+                ptr, (unsigned int)alignments[i]);
+        vkd3d_free_aligned(ptr);
+    }
+
+    ptr = vkd3d_calloc(1000, 3);
+    ok(ptr, "Failed to allocate memory.\n");
+    for (j = 0; ptr && j < 3000; j++)
+    {
+        if (ptr[j])
+            break;
+    }
+    ok(ptr && j == 3000, "Got non-zero byte at offset %u.\n", (unsigned int)j);
+
+    for (j = 0; ptr && j < 3000; j++)
+        ptr[j] = j & 0xff;
+
+    /* Growing and shrinking must preserve contents. */
+    new_ptr = vkd3d_realloc(ptr, 100000);
+    ok(new_ptr, "Failed to reallocate memory.\n");
+    if (new_ptr)
+        ptr = new_ptr;
+    new_ptr = vkd3d_realloc(ptr, 16);
+    ok(new_ptr, "Failed to reallocate memory.\n");
+    if (new_ptr)
+        ptr = new_ptr;
+    for (j = 0; ptr && j < 16; j++)
+    {
+        if (ptr[j] != (j & 0xff))
+            break;
+    }
+    ok(ptr && j == 16, "Got unexpected byte at offset %u.\n", (unsigned int)j);
+    vkd3d_free(ptr);
+
+    vkd3d_free(NULL);
+
+    for (i = 0; i < ARRAY_SIZE(threads); i++)
+    {
+        data[i].index = i;
+        data[i].errors = 0;
+        threads[i] = create_thread(host_allocator_thread, &data[i]);
+        ok(threads[i] != NULL, "Failed to create thread %u.\n", i);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(threads); i++)
+    {
+        if (threads[i])
+            ok(join_thread(threads[i]), "Failed to join thread %u.\n", i);
+        ok(!data[i].errors, "Thread %u got %u corrupted or failed allocations.\n", i, data[i].errors);
+    }
+}
@@ -2389,3 +2389,274 @@ void test_mismatching_pso_stages(void)
     destroy_test_context(&context);
 }
 
+
+void test_mesh_shader_pipeline_state(void)
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS7 options7;
+    D3D12_ROOT_SIGNATURE_DESC root_signature_desc;
+    D3D12_COMMAND_SIGNATURE_DESC signature_desc;
+    ID3D12CommandSignature *command_signature;
+    D3D12_INDIRECT_ARGUMENT_DESC argument_desc;
+    ID3D12RootSignature *root_signature;
+    ID3D12PipelineState *pipeline_state;
+    ID3D12Device2 *device2;
+    ID3D12Device *device;
+    unsigned int i;
+    ULONG refcount;
+    HRESULT hr;
+
+    /* Stream validation happens before any shader is looked at. */
+    static const DWORD dummy_code[] = { 0xdeadbeef };
+
+    static const union d3d12_root_signature_subobject
+    {
+        struct
+        {
+            D3D12_PIPELINE_STATE_SUBOBJECT_TYPE type;
+            ID3D12RootSignature *root_signature;
+        };
+        void *dummy_align;
+    }
+    root_signature_subobject =
+    {{
+        D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE,
+        NULL, /* fill in dynamically */
+    }};
+
+    static const union d3d12_shader_bytecode_subobject
+    {
+        struct
+        {
+            D3D12_PIPELINE_STATE_SUBOBJECT_TYPE type;
+            D3D12_SHADER_BYTECODE shader_bytecode;
+        };
+        void *dummy_align;
+    }
+    vs_subobject = {{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_VS, { dummy_code, sizeof(dummy_code) } }},
+    gs_subobject = {{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_GS, { dummy_code, sizeof(dummy_code) } }},
+    ps_subobject = {{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, { dummy_code, sizeof(dummy_code) } }},
+    as_subobject = {{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS, { dummy_code, sizeof(dummy_code) } }},
+    ms_subobject = {{ D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS, { dummy_code, sizeof(dummy_code) } }};
+
+    struct
+    {
+        union d3d12_root_signature_subobject root_signature;
+        union d3d12_shader_bytecode_subobject vs;
+        union d3d12_shader_bytecode_subobject ms;
+        union d3d12_shader_bytecode_subobject ps;
+    }
+    pipeline_desc_vs_ms =
+    {
+        root_signature_subobject, vs_subobject, ms_subobject, ps_subobject,
+    };
+
+    struct
+    {
+        union d3d12_root_signature_subobject root_signature;
+        union d3d12_shader_bytecode_subobject ms;
+        union d3d12_shader_bytecode_subobject gs;
+        union d3d12_shader_bytecode_subobject ps;
+    }
+    pipeline_desc_ms_gs =
+    {
+        root_signature_subobject, ms_subobject, gs_subobject, ps_subobject,
+    };
+
+    struct
+    {
+        union d3d12_root_signature_subobject root_signature;
+        union d3d12_shader_bytecode_subobject as;
+        union d3d12_shader_bytecode_subobject ps;
+    }
+    pipeline_desc_as =
+    {
+        root_signature_subobject, as_subobject, ps_subobject,
+    };
+
+    struct
+    {
+        union d3d12_root_signature_subobject root_signature;
+        union d3d12_shader_bytecode_subobject as;
+        union d3d12_shader_bytecode_subobject ms;
+        union d3d12_shader_bytecode_subobject as2;
+    }
+    pipeline_desc_duplicate_as =
+    {
+        root_signature_subobject, as_subobject, ms_subobject, as_subobject,
+    };
+
+    const D3D12_PIPELINE_STATE_STREAM_DESC tests[] =
+    {
+        { sizeof(pipeline_desc_vs_ms), &pipeline_desc_vs_ms },
+        { sizeof(pipeline_desc_ms_gs), &pipeline_desc_ms_gs },
+        { sizeof(pipeline_desc_as), &pipeline_desc_as },
+        { sizeof(pipeline_desc_duplicate_as), &pipeline_desc_duplicate_as },
+    };
+
+    if (!(device = create_device()))
+    {
+        skip("Failed to create device.\n");
+        return;
+    }
+
+    if (ID3D12Device_QueryInterface(device, &IID_ID3D12Device2, (void **)&device2))
+    {
+        skip("ID3D12Device2 not supported.\n");
+        ID3D12Device_Release(device);
+        return;
+    }
+
+    memset(&root_signature_desc, 0, sizeof(root_signature_desc));
+    hr = create_root_signature(device, &root_signature_desc, &root_signature);
+    ok(hr == S_OK, "Failed to create root signature, hr %#x.\n", hr);
+
+    for (i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        union d3d12_root_signature_subobject *rs_subobject = tests[i].pPipelineStateSubobjectStream;
+        vkd3d_test_set_context("Test %u", i);
+
+        rs_subobject->root_signature = root_signature;
+
+        hr = ID3D12Device2_CreatePipelineState(device2, &tests[i], &IID_ID3D12PipelineState, (void **)&pipeline_state);
+        ok(hr == E_INVALIDARG, "Got unexpected hr %#x.\n", hr);
+
+        if (SUCCEEDED(hr))
+            ID3D12PipelineState_Release(pipeline_state);
+    }
+    vkd3d_test_set_context(NULL);
+
+    memset(&options7, 0, sizeof(options7));
+    hr = ID3D12Device_CheckFeatureSupport(device, D3D12_FEATURE_D3D12_OPTIONS7, &options7, sizeof(options7));
+    ok(hr == S_OK, "Failed to query feature support, hr %#x.\n", hr);
+
+    if (options7.MeshShaderTier < D3D12_MESH_SHADER_TIER_1)
+    {
+        skip("Mesh shaders not supported by device.\n");
+        goto done;
+    }
+
+    argument_desc.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH;
+    signature_desc.ByteStride = sizeof(D3D12_DISPATCH_MESH_ARGUMENTS);
+    signature_desc.NumArgumentDescs = 1;
+    signature_desc.pArgumentDescs = &argument_desc;
+    signature_desc.NodeMask = 0;
+    hr = ID3D12Device_CreateCommandSignature(device, &signature_desc,
+            NULL, &IID_ID3D12CommandSignature, (void **)&command_signature);
+    ok(hr == S_OK, "Failed to create command signature, hr %#x.\n", hr);
+
+    if (SUCCEEDED(hr))
+    {
+        refcount = ID3D12CommandSignature_Release(command_signature);
+        ok(!refcount, "ID3D12CommandSignature has %u references left.\n", (unsigned int)refcount);
+    }
+
+done:
+    refcount = ID3D12RootSignature_Release(root_signature);
+    ok(!refcount, "ID3D12RootSignature has %u references left.\n", (unsigned int)refcount);
+    refcount = ID3D12Device2_Release(device2);
+    ok(refcount == 1, "ID3D12Device2 has %u references left.\n", (unsigned int)refcount);
+    refcount = ID3D12Device_Release(device);
+    ok(!refcount, "ID3D12Device has %u references left.\n", (unsigned int)refcount);
+}
+
+void test_mesh_shader_command_recording(void)
+{
+    static const float white[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    D3D12_FEATURE_DATA_D3D12_OPTIONS7 options7;
+    D3D12_COMMAND_SIGNATURE_DESC signature_desc;
+    ID3D12CommandSignature *command_signature;
+    D3D12_INDIRECT_ARGUMENT_DESC argument_desc;
+    ID3D12Resource *argument_buffer, *conditions;
+    ID3D12GraphicsCommandList6 *command_list6;
+    ID3D12GraphicsCommandList *command_list;
+    struct test_context context;
+    ID3D12CommandQueue *queue;
+    HRESULT hr;
+
+    static const struct mesh_argument_data
+    {
+        D3D12_DISPATCH_MESH_ARGUMENTS args[2];
+        uint32_t count;
+    }
+    mesh_args =
+    {
+        {{1, 1, 1}, {2, 1, 1}},
+        2,
+    };
+    static const uint64_t predicate_args[] = {0, 1};
+
+    if (!init_test_context(&context, NULL))
+        return;
+    command_list = context.list;
+    queue = context.queue;
+
+    memset(&options7, 0, sizeof(options7));
+    hr = ID3D12Device_CheckFeatureSupport(context.device, D3D12_FEATURE_D3D12_OPTIONS7, &options7, sizeof(options7));
+    ok(hr == S_OK, "Failed to query feature support, hr %#x.\n", hr);
+
+    if (options7.MeshShaderTier < D3D12_MESH_SHADER_TIER_1)
+    {
+        skip("Mesh shaders not supported by device.\n");
+        destroy_test_context(&context);
+        return;
+    }
+
+    hr = ID3D12GraphicsCommandList_QueryInterface(command_list, &IID_ID3D12GraphicsCommandList6, (void **)&command_list6);
+    ok(hr == S_OK, "Failed to query ID3D12GraphicsCommandList6, hr %#x.\n", hr);
+
+    argument_desc.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH;
+    signature_desc.ByteStride = sizeof(D3D12_DISPATCH_MESH_ARGUMENTS);
+    signature_desc.NumArgumentDescs = 1;
+    signature_desc.pArgumentDescs = &argument_desc;
+    signature_desc.NodeMask = 0;
+    hr = ID3D12Device_CreateCommandSignature(context.device, &signature_desc,
+            NULL, &IID_ID3D12CommandSignature, (void **)&command_signature);
+    ok(hr == S_OK, "Failed to create command signature, hr %#x.\n", hr);
+
+    argument_buffer = create_upload_buffer(context.device, sizeof(mesh_args), &mesh_args);
+    conditions = create_upload_buffer(context.device, sizeof(predicate_args), predicate_args);
+
+    /* Without a mesh shader pipeline bound, mesh dispatches must be dropped rather than
+     * recorded against whatever pipeline is bound. This must hold for the direct,
+     * indirect and predicated paths alike. */
+    ID3D12GraphicsCommandList_ClearRenderTargetView(command_list, context.rtv, white, 0, NULL);
+    ID3D12GraphicsCommandList_OMSetRenderTargets(command_list, 1, &context.rtv, false, NULL);
+    ID3D12GraphicsCommandList_RSSetViewports(command_list, 1, &context.viewport);
+    ID3D12GraphicsCommandList_RSSetScissorRects(command_list, 1, &context.scissor_rect);
+    ID3D12GraphicsCommandList_IASetPrimitiveTopology(command_list, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    ID3D12GraphicsCommandList6_DispatchMesh(command_list6, 1, 1, 1);
+    ID3D12GraphicsCommandList_ExecuteIndirect(command_list, command_signature, ARRAY_SIZE(mesh_args.args),
+            argument_buffer, 0, NULL, 0);
+
+    ID3D12GraphicsCommandList_SetGraphicsRootSignature(command_list, context.root_signature);
+    ID3D12GraphicsCommandList_SetPipelineState(command_list, context.pipeline_state);
+    ID3D12GraphicsCommandList6_DispatchMesh(command_list6, 1, 1, 1);
+    ID3D12GraphicsCommandList_ExecuteIndirect(command_list, command_signature, ARRAY_SIZE(mesh_args.args),
+            argument_buffer, 0, NULL, 0);
+    ID3D12GraphicsCommandList_ExecuteIndirect(command_list, command_signature, ARRAY_SIZE(mesh_args.args),
+            argument_buffer, 0, argument_buffer, offsetof(struct mesh_argument_data, count));
+
+    ID3D12GraphicsCommandList_SetPredication(command_list, conditions, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+    ID3D12GraphicsCommandList6_DispatchMesh(command_list6, 1, 1, 1);
+    ID3D12GraphicsCommandList_ExecuteIndirect(command_list, command_signature, ARRAY_SIZE(mesh_args.args),
+            argument_buffer, 0, NULL, 0);
+    ID3D12GraphicsCommandList_SetPredication(command_list, conditions, sizeof(uint64_t), D3D12_PREDICATION_OP_EQUAL_ZERO);
+    ID3D12GraphicsCommandList6_DispatchMesh(command_list6, 1, 1, 1);
+    ID3D12GraphicsCommandList_ExecuteIndirect(command_list, command_signature, ARRAY_SIZE(mesh_args.args),
+            argument_buffer, 0, argument_buffer, offsetof(struct mesh_argument_data, count));
+    ID3D12GraphicsCommandList_SetPredication(command_list, NULL, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    check_sub_resource_uint(context.render_target, 0, queue, command_list, 0xffffffff, 0);
+
+    hr = ID3D12Device_GetDeviceRemovedReason(context.device);
+    ok(hr == S_OK, "Got unexpected device removed reason %#x.\n", hr);
+
+    ID3D12CommandSignature_Release(command_signature);
+    ID3D12Resource_Release(argument_buffer);
+    ID3D12Resource_Release(conditions);
+    ID3D12GraphicsCommandList6_Release(command_list6);
+    destroy_test_context(&context);
+}
@@ -28,9 +28,9 @@ void test_get_cached_blob(void)
     D3D12_ROOT_SIGNATURE_DESC root_signature_desc;
     ID3D12RootSignature *root_signature;
     struct test_context context;
-    ID3D12PipelineState *state;
+    ID3D12PipelineState *state, *state2;
+    ID3DBlob *blob, *blob2;
     ID3D12Device *device;
-    ID3DBlob *blob;
     HRESULT hr;
 
 #if 0
@@ -67,6 +67,32 @@ void test_get_cached_blob(void)
     ok(hr == S_OK, "Failed to get cached blob, hr %#x.\n", hr);
     ok(ID3D10Blob_GetBufferSize(blob) > 0, "Cached blob is empty.\n");
 
+    ID3D10Blob_Release(blob);
+    ID3D12PipelineState_Release(state);
+
+    /* PSOs may only keep translated shaders around once blobs are in use, so compare
+     * blobs of PSOs which were both created after the first blob was requested. */
+    hr = ID3D12Device_CreateComputePipelineState(device,
+            &compute_desc, &IID_ID3D12PipelineState, (void**)&state);
+    ok(hr == S_OK, "Failed to create compute pipeline, hr %#x.\n", hr);
+
+    hr = ID3D12PipelineState_GetCachedBlob(state, &blob);
+    ok(hr == S_OK, "Failed to get cached blob, hr %#x.\n", hr);
+    ok(ID3D10Blob_GetBufferSize(blob) > 0, "Cached blob is empty.\n");
+
+    /* Blobs must not grow with unrelated pipelines compiled by the device. */
+    hr = ID3D12Device_CreateComputePipelineState(device,
+            &compute_desc, &IID_ID3D12PipelineState, (void**)&state2);
+    ok(hr == S_OK, "Failed to create compute pipeline, hr %#x.\n", hr);
+
+    hr = ID3D12PipelineState_GetCachedBlob(state2, &blob2);
+    ok(hr == S_OK, "Failed to get cached blob, hr %#x.\n", hr);
+    ok(ID3D10Blob_GetBufferSize(blob2) == ID3D10Blob_GetBufferSize(blob),
+            "Got unexpected blob size %u, expected %u.\n",
+            (unsigned int)ID3D10Blob_GetBufferSize(blob2), (unsigned int)ID3D10Blob_GetBufferSize(blob));
+
+    ID3D10Blob_Release(blob2);
+    ID3D12PipelineState_Release(state2);
     ID3D12PipelineState_Release(state);
 
     compute_desc.CachedPSO.pCachedBlob = ID3D10Blob_GetBufferPointer(blob);
@@ -76,6 +102,13 @@ void test_get_cached_blob(void)
             &compute_desc, &IID_ID3D12PipelineState, (void**)&state);
     ok(hr == S_OK, "Failed to create compute pipeline, hr %#x.\n", hr);
 
+    hr = ID3D12PipelineState_GetCachedBlob(state, &blob2);
+    ok(hr == S_OK, "Failed to get cached blob, hr %#x.\n", hr);
+    ok(ID3D10Blob_GetBufferSize(blob2) == ID3D10Blob_GetBufferSize(blob),
+            "Got unexpected blob size %u, expected %u.\n",
+            (unsigned int)ID3D10Blob_GetBufferSize(blob2), (unsigned int)ID3D10Blob_GetBufferSize(blob));
+
+    ID3D10Blob_Release(blob2);
     ID3D12PipelineState_Release(state);
     ID3D12RootSignature_Release(root_signature);
 
@@ -83,6 +116,139 @@ void test_get_cached_blob(void)
     destroy_test_context(&context);
 }
 
+void test_cached_blob_skips_translation(void)
+{
+    D3D12_COMPUTE_PIPELINE_STATE_DESC compute_desc;
+    D3D12_ROOT_SIGNATURE_DESC root_signature_desc;
+    D3D12_ROOT_PARAMETER root_parameter;
+    ID3D12GraphicsCommandList *command_list;
+    ID3D12RootSignature *root_signature;
+    unsigned int i, patch_count = 0;
+    struct resource_readback rb;
+    struct test_context context;
+    ID3D12PipelineState *state;
+    ID3D12CommandQueue *queue;
+    ID3D12Resource *buffer;
+    size_t blob_size, j;
+    uint32_t *blob_data;
+    ID3D12Device *device;
+    ID3DBlob *blob;
+    uint32_t value;
+    HRESULT hr;
+
+#if 0
+    RWByteAddressBuffer u0 : register(u0);
+
+    [numthreads(1, 1, 1)]
+    void main()
+    {
+        u0.Store(0, 0x12345678);
+    }
+#endif
+    static const DWORD cs_dxbc[] =
+    {
+        0x43425844, 0x06c2043a, 0x75638175, 0xd221f5bf, 0xa7fea0d5, 0x00000001, 0x0000009c, 0x00000003,
+        0x0000002c, 0x0000003c, 0x0000004c, 0x4e475349, 0x00000008, 0x00000000, 0x00000008, 0x4e47534f,
+        0x00000008, 0x00000000, 0x00000008, 0x58454853, 0x00000048, 0x00050050, 0x00000012, 0x0100086a,
+        0x0300009d, 0x0011e000, 0x00000000, 0x0400009b, 0x00000001, 0x00000001, 0x00000001, 0x070000a6,
+        0x0011e012, 0x00000000, 0x00004001, 0x00000000, 0x00004001, 0x12345678, 0x0100003e,
+    };
+
+    if (!init_compute_test_context(&context))
+        return;
+
+    device = context.device;
+    command_list = context.list;
+    queue = context.queue;
+
+    root_parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    root_parameter.Descriptor.ShaderRegister = 0;
+    root_parameter.Descriptor.RegisterSpace = 0;
+    root_parameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    memset(&root_signature_desc, 0, sizeof(root_signature_desc));
+    root_signature_desc.NumParameters = 1;
+    root_signature_desc.pParameters = &root_parameter;
+    hr = create_root_signature(device, &root_signature_desc, &root_signature);
+    ok(hr == S_OK, "Failed to create root signature, hr %#x.\n", hr);
+
+    memset(&compute_desc, 0, sizeof(compute_desc));
+    compute_desc.pRootSignature = root_signature;
+    compute_desc.CS.pShaderBytecode = cs_dxbc;
+    compute_desc.CS.BytecodeLength = sizeof(cs_dxbc);
+
+    /* Requesting a blob once makes PSOs created afterwards keep their translated shaders. */
+    for (i = 0; i < 2; i++)
+    {
+        hr = ID3D12Device_CreateComputePipelineState(device,
+                &compute_desc, &IID_ID3D12PipelineState, (void**)&state);
+        ok(hr == S_OK, "Failed to create compute pipeline, hr %#x.\n", hr);
+
+        hr = ID3D12PipelineState_GetCachedBlob(state, &blob);
+        ok(hr == S_OK, "Failed to get cached blob, hr %#x.\n", hr);
+        ID3D12PipelineState_Release(state);
+
+        if (!i)
+            ID3D10Blob_Release(blob);
+    }
+
+    /* The blob format is opaque. If it carries SPIR-V, the immediate from the shader shows up
+     * after the SPIR-V magic, and a PSO created from a patched blob must run the patched code. */
+    blob_size = ID3D10Blob_GetBufferSize(blob);
+    blob_data = malloc(blob_size);
+    memcpy(blob_data, ID3D10Blob_GetBufferPointer(blob), blob_size);
+    ID3D10Blob_Release(blob);
+
+    for (j = 0; j < blob_size / sizeof(*blob_data); j++)
+    {
+        if (blob_data[j] != 0x07230203)
+            continue;
+
+        for (; j < blob_size / sizeof(*blob_data); j++)
+        {
+            if (blob_data[j] == 0x12345678)
+            {
+                blob_data[j] = 0x0badf00d;
+                patch_count++;
+            }
+        }
+    }
+
+    if (!patch_count)
+    {
+        skip("Cached blob does not contain SPIR-V.\n");
+        goto done;
+    }
+
+    compute_desc.CachedPSO.pCachedBlob = blob_data;
+    compute_desc.CachedPSO.CachedBlobSizeInBytes = blob_size;
+    hr = ID3D12Device_CreateComputePipelineState(device,
+            &compute_desc, &IID_ID3D12PipelineState, (void**)&state);
+    ok(hr == S_OK, "Failed to create compute pipeline, hr %#x.\n", hr);
+
+    buffer = create_default_buffer(device, sizeof(value),
+            D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+    ID3D12GraphicsCommandList_SetComputeRootSignature(command_list, root_signature);
+    ID3D12GraphicsCommandList_SetPipelineState(command_list, state);
+    ID3D12GraphicsCommandList_SetComputeRootUnorderedAccessView(command_list, 0,
+            ID3D12Resource_GetGPUVirtualAddress(buffer));
+    ID3D12GraphicsCommandList_Dispatch(command_list, 1, 1, 1);
+    transition_resource_state(command_list, buffer,
+            D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+    get_buffer_readback_with_command_list(buffer, DXGI_FORMAT_R32_UINT, &rb, queue, command_list);
+    value = get_readback_uint(&rb, 0, 0, 0);
+    ok(value == 0x0badf00d, "Got unexpected value %#x, shader was translated again.\n", value);
+    release_resource_readback(&rb);
+
+    ID3D12Resource_Release(buffer);
+    ID3D12PipelineState_Release(state);
+done:
+    free(blob_data);
+    ID3D12RootSignature_Release(root_signature);
+    destroy_test_context(&context);
+}
+
 void test_pipeline_library(void)
 {
     D3D12_GRAPHICS_PIPELINE_STATE_DESC graphics_desc;
@@ -1035,20 +1035,16 @@ static unsigned int rt_pso_factory_add_existing_collection(struct rt_pso_factory
     return rt_pso_factory_add_subobject(factory, &desc);
 }
 
-static ID3D12StateObject *rt_pso_factory_compile(struct raytracing_test_context *context,
-        struct rt_pso_factory *factory,
-        D3D12_STATE_OBJECT_TYPE type)
+static void rt_pso_factory_build_desc(struct rt_pso_factory *factory,
+        D3D12_STATE_OBJECT_TYPE type, D3D12_STATE_OBJECT_DESC *desc)
 {
     D3D12_SUBOBJECT_TO_EXPORTS_ASSOCIATION *assoc;
-    D3D12_STATE_OBJECT_DESC desc;
-    ID3D12StateObject *rt_pso;
-    HRESULT hr;
     size_t i;
 
-    memset(&desc, 0, sizeof(desc));
-    desc.Type = type;
-    desc.NumSubobjects = factory->subobjects_count;
-    desc.pSubobjects = factory->subobjects;
+    memset(desc, 0, sizeof(*desc));
+    desc->Type = type;
+    desc->NumSubobjects = factory->subobjects_count;
+    desc->pSubobjects = factory->subobjects;
 
     for (i = 0; i < factory->subobjects_count; i++)
     {
@@ -1059,20 +1055,52 @@ static ID3D12StateObject *rt_pso_factory_compile(struct raytracing_test_context
             assoc->pSubobjectToAssociate = factory->subobjects + (uintptr_t)assoc->pSubobjectToAssociate;
         }
     }
+}
 
-    rt_pso = NULL;
-    hr = ID3D12Device5_CreateStateObject(context->device5, &desc, &IID_ID3D12StateObject, (void **)&rt_pso);
-    ok(SUCCEEDED(hr), "Failed to create RT PSO, hr %#x.\n", hr);
+static void rt_pso_factory_free(struct rt_pso_factory *factory)
+{
+    size_t i;
 
     free(factory->subobjects);
     for (i = 0; i < factory->allocs_count; i++)
         free(factory->allocs[i]);
     free(factory->allocs);
     memset(factory, 0, sizeof(*factory));
+}
+
+static ID3D12StateObject *rt_pso_factory_compile(struct raytracing_test_context *context,
+        struct rt_pso_factory *factory,
+        D3D12_STATE_OBJECT_TYPE type)
+{
+    D3D12_STATE_OBJECT_DESC desc;
+    ID3D12StateObject *rt_pso;
+    HRESULT hr;
+
+    rt_pso_factory_build_desc(factory, type, &desc);
+
+    rt_pso = NULL;
+    hr = ID3D12Device5_CreateStateObject(context->device5, &desc, &IID_ID3D12StateObject, (void **)&rt_pso);
+    ok(SUCCEEDED(hr), "Failed to create RT PSO, hr %#x.\n", hr);
 
+    rt_pso_factory_free(factory);
     return rt_pso;
 }
 
+static HRESULT rt_pso_factory_add_to_state_object(ID3D12Device7 *device7,
+        struct rt_pso_factory *factory, ID3D12StateObject *parent, ID3D12StateObject **rt_pso)
+{
+    D3D12_STATE_OBJECT_DESC desc;
+    HRESULT hr;
+
+    rt_pso_factory_build_desc(factory, D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE, &desc);
+
+    *rt_pso = NULL;
+    hr = ID3D12Device7_AddToStateObject(device7, &desc, parent, &IID_ID3D12StateObject, (void **)rt_pso);
+
+    rt_pso_factory_free(factory);
+    return hr;
+}
+
 static ID3D12StateObject *create_rt_collection(struct raytracing_test_context *context,
         unsigned int num_exports, D3D12_EXPORT_DESC *exports,
         const D3D12_HIT_GROUP_DESC *hit_group,
@@ -1909,3 +1937,406 @@ void test_raytracing_local_rs_static_sampler(void)
 
     destroy_raytracing_test_context(&context);
 }
+
+void test_raytracing_add_to_state_object(void)
+{
+    const void *parent_gen, *parent_miss, *gen, *miss, *hit;
+    ID3D12StateObjectProperties *parent_props, *props;
+    D3D12_ROOT_PARAMETER root_parameters[2];
+    D3D12_DESCRIPTOR_RANGE descriptor_ranges[2];
+    D3D12_ROOT_SIGNATURE_DESC root_signature_desc;
+    D3D12_STATE_OBJECT_DESC desc;
+    struct raytracing_test_context context;
+    ID3D12StateObject *rt_pso, *grown_pso;
+    ID3D12RootSignature *global_rs;
+    ID3D12RootSignature *local_rs;
+    struct rt_pso_factory factory;
+    ID3D12Device7 *device7;
+    ID3D12Device *device;
+    HRESULT hr;
+
+    if (!init_raytracing_test_context(&context))
+        return;
+
+    device = context.context.device;
+
+    if (FAILED(ID3D12Device_QueryInterface(device, &IID_ID3D12Device7, (void **)&device7)))
+    {
+        skip("ID3D12Device7 is not supported. Skipping test.\n");
+        destroy_raytracing_test_context(&context);
+        return;
+    }
+
+    memset(&root_signature_desc, 0, sizeof(root_signature_desc));
+    memset(root_parameters, 0, sizeof(root_parameters));
+    memset(descriptor_ranges, 0, sizeof(descriptor_ranges));
+    root_signature_desc.NumParameters = 1;
+    root_signature_desc.pParameters = root_parameters;
+    root_parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    root_parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    root_parameters[0].DescriptorTable.NumDescriptorRanges = 2;
+    root_parameters[0].DescriptorTable.pDescriptorRanges = descriptor_ranges;
+    descriptor_ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    descriptor_ranges[0].NumDescriptors = 2;
+    descriptor_ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    descriptor_ranges[1].OffsetInDescriptorsFromTableStart = 2;
+    descriptor_ranges[1].NumDescriptors = 1;
+    hr = create_root_signature(device, &root_signature_desc, &global_rs);
+    ok(SUCCEEDED(hr), "Failed to create root signature, hr #%x.\n", hr);
+
+    memset(&root_signature_desc, 0, sizeof(root_signature_desc));
+    memset(root_parameters, 0, sizeof(root_parameters));
+    root_signature_desc.NumParameters = 2;
+    root_signature_desc.pParameters = root_parameters;
+    root_signature_desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_LOCAL_ROOT_SIGNATURE;
+    root_parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    root_parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    root_parameters[0].Constants.Num32BitValues = 1;
+    root_parameters[0].Constants.RegisterSpace = 1;
+    root_parameters[0].Constants.ShaderRegister = 0;
+    root_parameters[1] = root_parameters[0];
+    root_parameters[1].Constants.ShaderRegister = 1;
+    hr = create_root_signature(device, &root_signature_desc, &local_rs);
+    ok(SUCCEEDED(hr), "Failed to create root signature, hr #%x.\n", hr);
+
+    /* Growing a state object which does not allow additions must fail. */
+    {
+        D3D12_EXPORT_DESC dxil_exports[1] = {
+            { u"RayGen", NULL, 0 },
+        };
+
+        rt_pso_factory_init(&factory);
+        rt_pso_factory_add_state_object_config(&factory, D3D12_STATE_OBJECT_FLAG_NONE);
+        rt_pso_factory_add_global_root_signature(&factory, global_rs);
+        rt_pso_factory_add_pipeline_config(&factory, 1);
+        rt_pso_factory_add_shader_config(&factory, 8, 8);
+        rt_pso_factory_add_dxil_library(&factory, get_default_rt_lib(), ARRAY_SIZE(dxil_exports), dxil_exports);
+        rt_pso = rt_pso_factory_compile(&context, &factory, D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE);
+
+        if (rt_pso)
+        {
+            rt_pso_factory_init(&factory);
+            rt_pso_factory_add_dxil_library(&factory, get_default_rt_lib(), 0, NULL);
+            hr = rt_pso_factory_add_to_state_object(device7, &factory, rt_pso, &grown_pso);
+            ok(hr == E_INVALIDARG, "Unexpected hr %#x.\n", hr);
+            ok(!grown_pso, "Unexpected state object %p.\n", grown_pso);
+            ID3D12StateObject_Release(rt_pso);
+        }
+    }
+
+    /* Base pipeline with raygen and miss, which allows additions. */
+    {
+        D3D12_EXPORT_DESC dxil_exports[2] = {
+            { u"RayMiss", NULL, 0 },
+            { u"RayGen", NULL, 0 },
+        };
+        unsigned int local_rs_index;
+
+        rt_pso_factory_init(&factory);
+        rt_pso_factory_add_state_object_config(&factory, D3D12_STATE_OBJECT_FLAG_ALLOW_STATE_OBJECT_ADDITIONS);
+        rt_pso_factory_add_global_root_signature(&factory, global_rs);
+        rt_pso_factory_add_pipeline_config(&factory, 1);
+        rt_pso_factory_add_shader_config(&factory, 8, 8);
+        rt_pso_factory_add_dxil_library(&factory, get_default_rt_lib(), ARRAY_SIZE(dxil_exports), dxil_exports);
+        local_rs_index = rt_pso_factory_add_local_root_signature(&factory, local_rs);
+        rt_pso_factory_add_subobject_to_exports_association(&factory, local_rs_index, 0, NULL);
+        rt_pso_factory_build_desc(&factory, D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE, &desc);
+
+        rt_pso = NULL;
+        hr = ID3D12Device5_CreateStateObject(context.device5, &desc, &IID_ID3D12StateObject, (void **)&rt_pso);
+        rt_pso_factory_free(&factory);
+    }
+
+    /* Only missing pipeline library support in the driver may prevent additions. */
+    if (hr == E_NOTIMPL)
+    {
+        skip("State object additions are not supported.\n");
+        goto out;
+    }
+
+    ok(SUCCEEDED(hr), "Failed to create RT PSO, hr %#x.\n", hr);
+    if (!rt_pso)
+        goto out;
+
+    ID3D12StateObject_QueryInterface(rt_pso, &IID_ID3D12StateObjectProperties, (void **)&parent_props);
+    parent_gen = ID3D12StateObjectProperties_GetShaderIdentifier(parent_props, u"RayGen");
+    parent_miss = ID3D12StateObjectProperties_GetShaderIdentifier(parent_props, u"RayMiss");
+    ok(parent_gen && parent_miss, "Failed to query shader identifiers.\n");
+
+    /* Add a hit group. Configuration and global root signature are inherited. */
+    {
+        D3D12_EXPORT_DESC dxil_exports[1] = {
+            { u"RayClosest", NULL, 0 },
+        };
+        D3D12_HIT_GROUP_DESC hit_group;
+        unsigned int local_rs_index;
+
+        memset(&hit_group, 0, sizeof(hit_group));
+        hit_group.Type = D3D12_HIT_GROUP_TYPE_TRIANGLES;
+        hit_group.ClosestHitShaderImport = u"RayClosest";
+        hit_group.HitGroupExport = u"RayHit";
+
+        rt_pso_factory_init(&factory);
+        rt_pso_factory_add_dxil_library(&factory, get_default_rt_lib(), ARRAY_SIZE(dxil_exports), dxil_exports);
+        local_rs_index = rt_pso_factory_add_local_root_signature(&factory, local_rs);
+        rt_pso_factory_add_subobject_to_exports_association(&factory, local_rs_index, 0, NULL);
+        rt_pso_factory_add_hit_group(&factory, &hit_group);
+        hr = rt_pso_factory_add_to_state_object(device7, &factory, rt_pso, &grown_pso);
+    }
+
+    ok(SUCCEEDED(hr), "Failed to add to state object, hr %#x.\n", hr);
+
+    if (grown_pso)
+    {
+        ID3D12StateObject_QueryInterface(grown_pso, &IID_ID3D12StateObjectProperties, (void **)&props);
+        gen = ID3D12StateObjectProperties_GetShaderIdentifier(props, u"RayGen");
+        miss = ID3D12StateObjectProperties_GetShaderIdentifier(props, u"RayMiss");
+        hit = ID3D12StateObjectProperties_GetShaderIdentifier(props, u"RayHit");
+        ok(gen && miss && hit, "Failed to query shader identifiers.\n");
+
+        /* Identifiers already baked into shader tables must remain valid. */
+        if (gen && parent_gen)
+            ok(!memcmp(gen, parent_gen, D3D12_SHADER_IDENTIFIER_SIZE_IN_BYTES), "RayGen identifier changed.\n");
+        if (miss && parent_miss)
+            ok(!memcmp(miss, parent_miss, D3D12_SHADER_IDENTIFIER_SIZE_IN_BYTES), "RayMiss identifier changed.\n");
+        ID3D12StateObjectProperties_Release(props);
+    }
+
+    /* The original state object is unaffected and can still be used on its own. */
+    ok(!ID3D12StateObjectProperties_GetShaderIdentifier(parent_props, u"RayHit"), "Unexpected identifier in parent.\n");
+    ok(ID3D12StateObjectProperties_GetShaderIdentifier(parent_props, u"RayGen") == parent_gen,
+            "Parent identifier changed.\n");
+    ID3D12StateObjectProperties_Release(parent_props);
+    ID3D12StateObject_Release(rt_pso);
+
+    /* The grown state object keeps its parent alive. */
+    if (grown_pso)
+    {
+        ID3D12StateObject_QueryInterface(grown_pso, &IID_ID3D12StateObjectProperties, (void **)&props);
+        ok(!!ID3D12StateObjectProperties_GetShaderIdentifier(props, u"RayGen"), "Failed to query shader identifier.\n");
+        ID3D12StateObjectProperties_Release(props);
+        ID3D12StateObject_Release(grown_pso);
+    }
+
+out:
+    ID3D12RootSignature_Release(global_rs);
+    ID3D12RootSignature_Release(local_rs);
+    ID3D12Device7_Release(device7);
+    destroy_raytracing_test_context(&context);
+}
+
+void test_raytracing_acceleration_structure_ring(void)
+{
+    static const float vertices[] =
+    {
+        0.0f, 0.0f, 0.0f,
+        1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f,
+    };
+
+    /* Rebuild a BLAS at ever shifting offsets of a ring buffer, like engines with
+     * dynamic geometry do. Every offset needs its own VkAccelerationStructureKHR. */
+    const unsigned int offset_count = 1024;
+    const unsigned int builds_per_list = 256;
+    const unsigned int list_count = 8;
+
+    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC postbuild_desc;
+    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO prebuild_info;
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC build_desc;
+    ID3D12Resource *vbo, *ring, *scratch, *postbuild;
+    struct raytracing_test_context context;
+    D3D12_RAYTRACING_GEOMETRY_DESC geom_desc;
+    ID3D12GraphicsCommandList *command_list;
+    struct resource_readback rb;
+    unsigned int i, j, index;
+    uint64_t value;
+
+    if (!init_raytracing_test_context(&context))
+        return;
+
+    command_list = context.context.list;
+
+    vbo = create_upload_buffer(context.context.device, sizeof(vertices), vertices);
+
+    memset(&geom_desc, 0, sizeof(geom_desc));
+    geom_desc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
+    geom_desc.Flags = D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
+    geom_desc.Triangles.VertexBuffer.StartAddress = ID3D12Resource_GetGPUVirtualAddress(vbo);
+    geom_desc.Triangles.VertexBuffer.StrideInBytes = 3 * sizeof(float);
+    geom_desc.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+    geom_desc.Triangles.VertexCount = 3;
+
+    memset(&build_desc, 0, sizeof(build_desc));
+    build_desc.Inputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL;
+    build_desc.Inputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_COMPACTION;
+    build_desc.Inputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
+    build_desc.Inputs.NumDescs = 1;
+    build_desc.Inputs.pGeometryDescs = &geom_desc;
+
+    memset(&prebuild_info, 0, sizeof(prebuild_info));
+    ID3D12Device5_GetRaytracingAccelerationStructurePrebuildInfo(context.device5, &build_desc.Inputs, &prebuild_info);
+    ok(prebuild_info.ResultDataMaxSizeInBytes, "Unexpected result size.\n");
+
+    ring = create_default_buffer(context.context.device,
+            offset_count * D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT + prebuild_info.ResultDataMaxSizeInBytes,
+            D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE);
+    scratch = create_default_buffer(context.context.device, max(prebuild_info.ScratchDataSizeInBytes, 256),
+            D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    postbuild = create_default_buffer(context.context.device, builds_per_list * sizeof(uint64_t),
+            D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+    build_desc.ScratchAccelerationStructureData = ID3D12Resource_GetGPUVirtualAddress(scratch);
+    postbuild_desc.InfoType = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE;
+
+    for (i = 0; i < list_count; i++)
+    {
+        for (j = 0; j < builds_per_list; j++)
+        {
+            index = (i * builds_per_list + j) % offset_count;
+            build_desc.DestAccelerationStructureData = ID3D12Resource_GetGPUVirtualAddress(ring) +
+                    index * D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT;
+            postbuild_desc.DestBuffer = ID3D12Resource_GetGPUVirtualAddress(postbuild) + j * sizeof(uint64_t);
+
+            ID3D12GraphicsCommandList4_BuildRaytracingAccelerationStructure(context.list4, &build_desc, 1, &postbuild_desc);
+            uav_barrier(command_list, ring);
+            uav_barrier(command_list, scratch);
+        }
+
+        transition_resource_state(command_list, postbuild,
+                D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE);
+        get_buffer_readback_with_command_list(postbuild, DXGI_FORMAT_UNKNOWN, &rb,
+                context.context.queue, command_list);
+
+        for (j = 0; j < builds_per_list; j++)
+        {
+            value = get_readback_uint64(&rb, j, 0);
+            ok(value && value <= prebuild_info.ResultDataMaxSizeInBytes,
+                    "Unexpected compacted size %"PRIu64" for build %u.\n", value, i * builds_per_list + j);
+        }
+
+        release_resource_readback(&rb);
+        reset_command_list(command_list, context.context.allocator);
+        transition_resource_state(command_list, postbuild,
+                D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    }
+
+    ID3D12Resource_Release(postbuild);
+    ID3D12Resource_Release(scratch);
+    ID3D12Resource_Release(ring);
+    ID3D12Resource_Release(vbo);
+    destroy_raytracing_test_context(&context);
+}
+
+void test_raytracing_pipeline_library_serialize(void)
+{
+    D3D12_EXPORT_DESC dxil_exports[2] = {
+        { u"RayMiss", NULL, 0 },
+        { u"RayGen", NULL, 0 },
+    };
+    ID3D12PipelineLibrary *pipeline_libraries[2], *loaded_library;
+    D3D12_ROOT_PARAMETER root_parameters[2];
+    D3D12_DESCRIPTOR_RANGE descriptor_ranges[2];
+    D3D12_ROOT_SIGNATURE_DESC root_signature_desc;
+    struct raytracing_test_context context;
+    ID3D12RootSignature *global_rs;
+    ID3D12RootSignature *local_rs;
+    struct rt_pso_factory factory;
+    unsigned int local_rs_index;
+    SIZE_T serialized_sizes[2];
+    ID3D12StateObject *rt_pso;
+    ID3D12Device1 *device1;
+    ID3D12Device *device;
+    void *serialized_data;
+    unsigned int i;
+    HRESULT hr;
+
+    if (!init_raytracing_test_context(&context))
+        return;
+
+    device = context.context.device;
+
+    if (FAILED(ID3D12Device_QueryInterface(device, &IID_ID3D12Device1, (void **)&device1)))
+    {
+        skip("ID3D12Device1 is not supported. Skipping test.\n");
+        destroy_raytracing_test_context(&context);
+        return;
+    }
+
+    memset(&root_signature_desc, 0, sizeof(root_signature_desc));
+    memset(root_parameters, 0, sizeof(root_parameters));
+    memset(descriptor_ranges, 0, sizeof(descriptor_ranges));
+    root_signature_desc.NumParameters = 1;
+    root_signature_desc.pParameters = root_parameters;
+    root_parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    root_parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    root_parameters[0].DescriptorTable.NumDescriptorRanges = 2;
+    root_parameters[0].DescriptorTable.pDescriptorRanges = descriptor_ranges;
+    descriptor_ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    descriptor_ranges[0].NumDescriptors = 2;
+    descriptor_ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    descriptor_ranges[1].OffsetInDescriptorsFromTableStart = 2;
+    descriptor_ranges[1].NumDescriptors = 1;
+    hr = create_root_signature(device, &root_signature_desc, &global_rs);
+    ok(SUCCEEDED(hr), "Failed to create root signature, hr #%x.\n", hr);
+
+    memset(&root_signature_desc, 0, sizeof(root_signature_desc));
+    memset(root_parameters, 0, sizeof(root_parameters));
+    root_signature_desc.NumParameters = 2;
+    root_signature_desc.pParameters = root_parameters;
+    root_signature_desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_LOCAL_ROOT_SIGNATURE;
+    root_parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    root_parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    root_parameters[0].Constants.Num32BitValues = 1;
+    root_parameters[0].Constants.RegisterSpace = 1;
+    root_parameters[0].Constants.ShaderRegister = 0;
+    root_parameters[1] = root_parameters[0];
+    root_parameters[1].Constants.ShaderRegister = 1;
+    hr = create_root_signature(device, &root_signature_desc, &local_rs);
+    ok(SUCCEEDED(hr), "Failed to create root signature, hr #%x.\n", hr);
+
+    for (i = 0; i < ARRAY_SIZE(pipeline_libraries); i++)
+    {
+        hr = ID3D12Device1_CreatePipelineLibrary(device1, NULL, 0,
+                &IID_ID3D12PipelineLibrary, (void **)&pipeline_libraries[i]);
+        ok(hr == S_OK, "Failed to create pipeline library, hr %#x.\n", hr);
+        serialized_sizes[i] = ID3D12PipelineLibrary_GetSerializedSize(pipeline_libraries[i]);
+        ok(serialized_sizes[i] > 0, "Serialized size for pipeline library is 0.\n");
+    }
+
+    /* Compiling a ray tracing pipeline between querying the size and serializing
+     * must not invalidate the size the application allocated for. */
+    rt_pso_factory_init(&factory);
+    rt_pso_factory_add_global_root_signature(&factory, global_rs);
+    rt_pso_factory_add_pipeline_config(&factory, 1);
+    rt_pso_factory_add_shader_config(&factory, 8, 8);
+    rt_pso_factory_add_dxil_library(&factory, get_default_rt_lib(), ARRAY_SIZE(dxil_exports), dxil_exports);
+    local_rs_index = rt_pso_factory_add_local_root_signature(&factory, local_rs);
+    rt_pso_factory_add_subobject_to_exports_association(&factory, local_rs_index, 0, NULL);
+    rt_pso = rt_pso_factory_compile(&context, &factory, D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE);
+
+    for (i = 0; i < ARRAY_SIZE(pipeline_libraries); i++)
+    {
+        serialized_data = malloc(serialized_sizes[i]);
+        hr = ID3D12PipelineLibrary_Serialize(pipeline_libraries[i], serialized_data, serialized_sizes[i]);
+        ok(hr == S_OK, "Failed to serialize pipeline library %u, hr %#x.\n", i, hr);
+
+        if (SUCCEEDED(hr))
+        {
+            hr = ID3D12Device1_CreatePipelineLibrary(device1, serialized_data, serialized_sizes[i],
+                    &IID_ID3D12PipelineLibrary, (void **)&loaded_library);
+            ok(hr == S_OK, "Failed to create pipeline library %u, hr %#x.\n", i, hr);
+            if (SUCCEEDED(hr))
+                ID3D12PipelineLibrary_Release(loaded_library);
+        }
+
+        free(serialized_data);
+        ID3D12PipelineLibrary_Release(pipeline_libraries[i]);
+    }
+
+    if (rt_pso)
+        ID3D12StateObject_Release(rt_pso);
+    ID3D12RootSignature_Release(global_rs);
+    ID3D12RootSignature_Release(local_rs);
+    ID3D12Device1_Release(device1);
+    destroy_raytracing_test_context(&context);
+}
@@ -837,3 +837,74 @@ void test_multisample_rendering(void)
     destroy_test_context(&context);
 }
 
+
+void test_render_pass_begin_end(void)
+{
+    static const struct vec4 green = { 0.0f, 1.0f, 0.0f, 1.0f };
+    static const struct vec4 red = { 1.0f, 0.0f, 0.0f, 1.0f };
+    D3D12_RENDER_PASS_RENDER_TARGET_DESC rt_desc;
+    ID3D12GraphicsCommandList4 *command_list4;
+    ID3D12GraphicsCommandList *command_list;
+    struct test_context_desc desc;
+    struct test_context context;
+    ID3D12CommandQueue *queue;
+    HRESULT hr;
+
+    memset(&desc, 0, sizeof(desc));
+    desc.rt_format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    desc.rt_width = 32;
+    desc.rt_height = 32;
+    if (!init_test_context(&context, &desc))
+        return;
+    command_list = context.list;
+    queue = context.queue;
+
+    if (FAILED(hr = ID3D12GraphicsCommandList_QueryInterface(command_list,
+            &IID_ID3D12GraphicsCommandList4, (void **)&command_list4)))
+    {
+        skip("ID3D12GraphicsCommandList4 not supported.\n");
+        destroy_test_context(&context);
+        return;
+    }
+
+    /* Clear through the beginning access and preserve the result. */
+    memset(&rt_desc, 0, sizeof(rt_desc));
+    rt_desc.cpuDescriptor = context.rtv;
+    rt_desc.BeginningAccess.Type = D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_CLEAR;
+    rt_desc.BeginningAccess.Clear.ClearValue.Format = desc.rt_format;
+    memcpy(rt_desc.BeginningAccess.Clear.ClearValue.Color, &red.x, sizeof(red));
+    rt_desc.EndingAccess.Type = D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_PRESERVE;
+
+    ID3D12GraphicsCommandList4_BeginRenderPass(command_list4, 1, &rt_desc, NULL, D3D12_RENDER_PASS_FLAG_NONE);
+    ID3D12GraphicsCommandList4_EndRenderPass(command_list4);
+
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    check_sub_resource_vec4(context.render_target, 0, queue, command_list, &red, 0);
+    reset_command_list(command_list, context.allocator);
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    /* Discarded contents followed by a full-screen draw, split across a suspended and a resumed pass. */
+    rt_desc.BeginningAccess.Type = D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_DISCARD;
+    ID3D12GraphicsCommandList4_BeginRenderPass(command_list4, 1, &rt_desc, NULL, D3D12_RENDER_PASS_FLAG_SUSPENDING_PASS);
+    ID3D12GraphicsCommandList_SetGraphicsRootSignature(command_list, context.root_signature);
+    ID3D12GraphicsCommandList_SetPipelineState(command_list, context.pipeline_state);
+    ID3D12GraphicsCommandList_IASetPrimitiveTopology(command_list, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    ID3D12GraphicsCommandList_RSSetViewports(command_list, 1, &context.viewport);
+    ID3D12GraphicsCommandList_RSSetScissorRects(command_list, 1, &context.scissor_rect);
+    ID3D12GraphicsCommandList_DrawInstanced(command_list, 3, 1, 0, 0);
+    ID3D12GraphicsCommandList4_EndRenderPass(command_list4);
+
+    /* A resuming pass must not re-apply the beginning access. */
+    rt_desc.BeginningAccess.Type = D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_CLEAR;
+    ID3D12GraphicsCommandList4_BeginRenderPass(command_list4, 1, &rt_desc, NULL, D3D12_RENDER_PASS_FLAG_RESUMING_PASS);
+    ID3D12GraphicsCommandList4_EndRenderPass(command_list4);
+
+    transition_resource_state(command_list, context.render_target,
+            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    check_sub_resource_vec4(context.render_target, 0, queue, command_list, &green, 0);
+
+    ID3D12GraphicsCommandList4_Release(command_list4);
+    destroy_test_context(&context);
+}
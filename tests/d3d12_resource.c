@@ -21,6 +21,7 @@
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
 #include "d3d12_crosstest.h"
+#include "vkd3d_queue_ownership.h"
 
 void test_create_committed_resource(void)
 {
@@ -3314,3 +3315,40 @@ void test_map_texture_validation(void)
     vkd3d_test_set_context(NULL);
     destroy_test_context(&context);
 }
+
+void test_queue_ownership_model(void)
+{
+    struct vkd3d_queue_ownership_transfer transfer;
+    struct vkd3d_queue_ownership ownership;
+    int queues[3];
+
+    vkd3d_queue_ownership_init(&ownership);
+
+    /* The first use does not need a transfer. */
+    ok(!vkd3d_queue_ownership_acquire(&ownership, &queues[0], 0, &transfer), "Unexpected transfer.\n");
+
+    /* Neither does a use by another queue in the same family, but it becomes the releasing queue. */
+    ok(!vkd3d_queue_ownership_acquire(&ownership, &queues[1], 0, &transfer), "Unexpected transfer.\n");
+
+    memset(&transfer, 0, sizeof(transfer));
+    ok(vkd3d_queue_ownership_acquire(&ownership, &queues[2], 1, &transfer), "Expected transfer.\n");
+    ok(transfer.release_queue == &queues[1], "Got release queue %p, expected %p.\n",
+            transfer.release_queue, &queues[1]);
+    ok(transfer.src_family == 0, "Got source family %u.\n", transfer.src_family);
+    ok(transfer.dst_family == 1, "Got destination family %u.\n", transfer.dst_family);
+
+    ok(!vkd3d_queue_ownership_acquire(&ownership, &queues[2], 1, &transfer), "Unexpected transfer.\n");
+
+    /* Discarding contents takes ownership without a transfer. */
+    vkd3d_queue_ownership_reset(&ownership, &queues[0], 0);
+    memset(&transfer, 0, sizeof(transfer));
+    ok(vkd3d_queue_ownership_acquire(&ownership, &queues[2], 1, &transfer), "Expected transfer.\n");
+    ok(transfer.release_queue == &queues[0], "Got release queue %p, expected %p.\n",
+            transfer.release_queue, &queues[0]);
+    ok(transfer.src_family == 0, "Got source family %u.\n", transfer.src_family);
+    ok(transfer.dst_family == 1, "Got destination family %u.\n", transfer.dst_family);
+
+    /* Only a use from another family would need the owning queue to release. */
+    ok(!vkd3d_queue_ownership_peek_release_queue(&ownership, 1), "Unexpected release queue.\n");
+    ok(vkd3d_queue_ownership_peek_release_queue(&ownership, 0) == &queues[2], "Unexpected release queue.\n");
+}
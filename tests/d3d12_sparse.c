@@ -21,6 +21,7 @@
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
 #include "d3d12_crosstest.h"
+#include "vkd3d_tile_map.h"
 
 static uint32_t compute_tile_count(uint32_t resource_size, uint32_t mip, uint32_t tile_size)
 {
@@ -3371,3 +3372,53 @@ void test_texture_feedback_instructions_dxil(void)
     test_texture_feedback_instructions(true);
 }
 
+void test_tile_map(void)
+{
+    const uint32_t tile_count = 1024u * 1024u;
+    const uint64_t tile_size = 65536;
+    const uint32_t stride = 1024;
+    struct vkd3d_tile_map map;
+    uint64_t memory, offset;
+    uint32_t i, count;
+
+    vkd3d_tile_map_init(&map, tile_size);
+
+    /* Map everything to one heap, then scatter single tiles from a second heap. */
+    ok(vkd3d_tile_map_set(&map, 0, tile_count, 1, 0), "Failed to map tiles.\n");
+    ok(map.run_count == 1, "Got %u runs.\n", (unsigned int)map.run_count);
+
+    for (i = 0; i < tile_count; i += stride)
+        ok(vkd3d_tile_map_set(&map, i, 1, 2, (uint64_t)i * tile_size), "Failed to map tile %u.\n", i);
+    ok(map.run_count == 2 * (tile_count / stride), "Got %u runs.\n", (unsigned int)map.run_count);
+
+    count = vkd3d_tile_map_query(&map, stride, tile_count, &memory, &offset);
+    ok(count == 1 && memory == 2 && offset == stride * tile_size,
+            "Got count %u, memory %"PRIu64", offset %#"PRIx64".\n", count, memory, offset);
+    count = vkd3d_tile_map_query(&map, stride + 1, tile_count, &memory, &offset);
+    ok(count == stride - 1 && memory == 1 && offset == (stride + 1) * tile_size,
+            "Got count %u, memory %"PRIu64", offset %#"PRIx64".\n", count, memory, offset);
+
+    /* Queries are clamped to the requested tile count. */
+    count = vkd3d_tile_map_query(&map, stride + 1, 5, &memory, &offset);
+    ok(count == 5 && memory == 1, "Got count %u, memory %"PRIu64".\n", count, memory);
+
+    /* Mapping the whole range again collapses everything into one run. */
+    ok(vkd3d_tile_map_set(&map, 0, tile_count, 1, 0), "Failed to map tiles.\n");
+    ok(map.run_count == 1, "Got %u runs.\n", (unsigned int)map.run_count);
+
+    /* Contiguous memory in adjacent runs is merged. */
+    ok(vkd3d_tile_map_set(&map, tile_count, 16, 1, tile_count * tile_size), "Failed to map tiles.\n");
+    ok(map.run_count == 1, "Got %u runs.\n", (unsigned int)map.run_count);
+    ok(vkd3d_tile_map_unmap(&map, tile_count, 16), "Failed to unmap tiles.\n");
+
+    /* Unmapping the upper half leaves a gap which is reported as a single range. */
+    ok(vkd3d_tile_map_unmap(&map, tile_count / 2, tile_count / 2), "Failed to unmap tiles.\n");
+    count = vkd3d_tile_map_query(&map, tile_count / 2, tile_count / 2, &memory, &offset);
+    ok(count == tile_count / 2 && !memory && !offset,
+            "Got count %u, memory %"PRIu64", offset %#"PRIx64".\n", count, memory, offset);
+
+    ok(vkd3d_tile_map_unmap(&map, 0, tile_count), "Failed to unmap tiles.\n");
+    ok(!map.run_count, "Got %u runs.\n", (unsigned int)map.run_count);
+
+    vkd3d_tile_map_cleanup(&map);
+}
@@ -21,6 +21,7 @@
 
 #define VKD3D_DBG_CHANNEL VKD3D_DBG_CHANNEL_API
 #include "d3d12_crosstest.h"
+#include "vkd3d_spinlock.h"
 
 void test_queue_wait(void)
 {
@@ -1187,3 +1188,282 @@ void test_create_fence(void)
     ok(!refcount, "ID3D12Device has %u references left.\n", (unsigned int)refcount);
 }
 
+
+/* Many more threads than cores hammer one lock, so lock holders are regularly
+ * preempted and waiters have to park. No increment may get lost. */
+#define SPINLOCK_CONTENTION_THREADS 64
+#define SPINLOCK_CONTENTION_ITERATIONS 2000
+
+struct spinlock_contention_context
+{
+    spinlock_t lock;
+    uint64_t counter;
+};
+
+static void spinlock_contention_thread(void *userdata)
+{
+    struct spinlock_contention_context *context = userdata;
+    unsigned int i;
+
+    for (i = 0; i < SPINLOCK_CONTENTION_ITERATIONS; i++)
+    {
+        spinlock_acquire(&context->lock);
+        context->counter++;
+        spinlock_release(&context->lock);
+    }
+}
+
+void test_spinlock_contention(void)
+{
+    HANDLE threads[SPINLOCK_CONTENTION_THREADS];
+    struct spinlock_contention_context context;
+    unsigned int i;
+
+    spinlock_init(&context.lock);
+    context.counter = 0;
+
+    for (i = 0; i < ARRAY_SIZE(threads); i++)
+    {
+        threads[i] = create_thread(spinlock_contention_thread, &context);
+        ok(threads[i] != NULL, "Failed to create thread %u.\n", i);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(threads); i++)
+    {
+        if (threads[i])
+            ok(join_thread(threads[i]), "Failed to join thread %u.\n", i);
+    }
+
+    ok(context.counter == (uint64_t)SPINLOCK_CONTENTION_THREADS * SPINLOCK_CONTENTION_ITERATIONS,
+            "Got unexpected counter %"PRIu64".\n", context.counter);
+    ok(context.lock == VKD3D_SPINLOCK_FREE, "Got unexpected lock state %#x.\n", context.lock);
+}
+
+void test_many_queues_signal(void)
+{
+    static const D3D12_COMMAND_LIST_TYPE types[] =
+    {
+        D3D12_COMMAND_LIST_TYPE_DIRECT,
+        D3D12_COMMAND_LIST_TYPE_COMPUTE,
+        D3D12_COMMAND_LIST_TYPE_COPY,
+    };
+    ID3D12CommandQueue *queues[32];
+    D3D12_COMMAND_QUEUE_DESC desc;
+    ID3D12Device *device;
+    ID3D12Fence *fence;
+    unsigned int i, j;
+    ULONG refcount;
+    UINT64 value;
+    HRESULT hr;
+
+    if (!(device = create_device()))
+    {
+        skip("Failed to create device.\n");
+        return;
+    }
+
+    hr = ID3D12Device_CreateFence(device, 0, D3D12_FENCE_FLAG_NONE, &IID_ID3D12Fence, (void **)&fence);
+    ok(SUCCEEDED(hr), "Failed to create fence, hr %#x.\n", hr);
+
+    /* Queues share submission and fence workers, every queue must still make progress
+     * while most of the other queues are idle. */
+    memset(&desc, 0, sizeof(desc));
+    for (i = 0; i < ARRAY_SIZE(queues); i++)
+    {
+        desc.Type = types[i % ARRAY_SIZE(types)];
+        hr = ID3D12Device_CreateCommandQueue(device, &desc, &IID_ID3D12CommandQueue, (void **)&queues[i]);
+        ok(SUCCEEDED(hr), "Failed to create command queue %u, hr %#x.\n", i, hr);
+    }
+
+    value = 0;
+    for (j = 0; j < 4; j++)
+    {
+        for (i = 0; i < ARRAY_SIZE(queues); i++)
+        {
+            hr = ID3D12CommandQueue_Signal(queues[i], fence, ++value);
+            ok(SUCCEEDED(hr), "Failed to signal fence, hr %#x.\n", hr);
+            hr = wait_for_fence(fence, value);
+            ok(SUCCEEDED(hr), "Failed to wait for fence, hr %#x.\n", hr);
+        }
+    }
+
+    /* Signals queued on every queue at once all have to retire. */
+    for (i = 0; i < ARRAY_SIZE(queues); i++)
+    {
+        hr = ID3D12CommandQueue_Signal(queues[i], fence, ++value);
+        ok(SUCCEEDED(hr), "Failed to signal fence, hr %#x.\n", hr);
+    }
+
+    hr = wait_for_fence(fence, value);
+    ok(SUCCEEDED(hr), "Failed to wait for fence, hr %#x.\n", hr);
+    ok(ID3D12Fence_GetCompletedValue(fence) == value, "Got completed value %"PRIu64", expected %"PRIu64".\n",
+            ID3D12Fence_GetCompletedValue(fence), value);
+
+    for (i = 0; i < ARRAY_SIZE(queues); i++)
+        ID3D12CommandQueue_Release(queues[i]);
+    ID3D12Fence_Release(fence);
+    refcount = ID3D12Device_Release(device);
+    ok(!refcount, "ID3D12Device has %u references left.\n", (unsigned int)refcount);
+}
+
+static uint32_t get_submission_folding_slot(ID3D12Resource *buffer, unsigned int index)
+{
+    D3D12_RANGE range;
+    uint32_t value;
+    void *ptr;
+    HRESULT hr;
+
+    range.Begin = index * sizeof(value);
+    range.End = range.Begin + sizeof(value);
+    hr = ID3D12Resource_Map(buffer, 0, &range, &ptr);
+    ok(SUCCEEDED(hr), "Failed to map buffer, hr %#x.\n", hr);
+    memcpy(&value, (const uint8_t *)ptr + range.Begin, sizeof(value));
+    range.End = range.Begin;
+    ID3D12Resource_Unmap(buffer, 0, &range);
+    return value;
+}
+
+void test_queue_submission_folding(void)
+{
+    ID3D12GraphicsCommandList *lists[12];
+    ID3D12CommandAllocator *allocators[12];
+    ID3D12CommandQueue *queues[8];
+    ID3D12Resource *src, *dst;
+    uint32_t data[12], zero[12];
+    ID3D12Fence *fence, *fence2;
+    D3D12_COMMAND_QUEUE_DESC desc;
+    ID3D12Device *device;
+    unsigned int i;
+    ULONG refcount;
+    UINT64 value;
+    HRESULT hr;
+
+    if (!(device = create_device()))
+    {
+        skip("Failed to create device.\n");
+        return;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(data); i++)
+        data[i] = i + 1;
+    memset(zero, 0, sizeof(zero));
+    src = create_upload_buffer(device, sizeof(data), data);
+    dst = create_readback_buffer(device, sizeof(zero));
+    update_buffer_data(dst, 0, sizeof(zero), zero);
+
+    /* Every list copies a single slot, so we can tell which submissions have executed. */
+    for (i = 0; i < ARRAY_SIZE(lists); i++)
+    {
+        hr = ID3D12Device_CreateCommandAllocator(device, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                &IID_ID3D12CommandAllocator, (void **)&allocators[i]);
+        ok(SUCCEEDED(hr), "Failed to create command allocator, hr %#x.\n", hr);
+        hr = ID3D12Device_CreateCommandList(device, 0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                allocators[i], NULL, &IID_ID3D12GraphicsCommandList, (void **)&lists[i]);
+        ok(SUCCEEDED(hr), "Failed to create command list, hr %#x.\n", hr);
+        ID3D12GraphicsCommandList_CopyBufferRegion(lists[i], dst, i * sizeof(uint32_t),
+                src, i * sizeof(uint32_t), sizeof(uint32_t));
+        hr = ID3D12GraphicsCommandList_Close(lists[i]);
+        ok(SUCCEEDED(hr), "Failed to close command list, hr %#x.\n", hr);
+    }
+
+    /* More queues than most implementations expose per family, so several
+     * D3D12 queues end up sharing one Vulkan queue. */
+    memset(&desc, 0, sizeof(desc));
+    desc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+    for (i = 0; i < ARRAY_SIZE(queues); i++)
+    {
+        hr = ID3D12Device_CreateCommandQueue(device, &desc, &IID_ID3D12CommandQueue, (void **)&queues[i]);
+        ok(SUCCEEDED(hr), "Failed to create command queue %u, hr %#x.\n", i, hr);
+    }
+
+    hr = ID3D12Device_CreateFence(device, 0, D3D12_FENCE_FLAG_NONE, &IID_ID3D12Fence, (void **)&fence);
+    ok(SUCCEEDED(hr), "Failed to create fence, hr %#x.\n", hr);
+    hr = ID3D12Device_CreateFence(device, 0, D3D12_FENCE_FLAG_NONE, &IID_ID3D12Fence, (void **)&fence2);
+    ok(SUCCEEDED(hr), "Failed to create fence, hr %#x.\n", hr);
+
+    /* Wait -> Execute -> Signal sequences may be folded into single submissions,
+     * but the waits must still hold back exactly their own command lists. */
+    queue_wait(queues[0], fence, 1);
+    exec_command_list(queues[0], lists[0]);
+    queue_signal(queues[0], fence2, 1);
+    queue_wait(queues[0], fence, 2);
+    exec_command_list(queues[0], lists[1]);
+    queue_signal(queues[0], fence2, 2);
+
+    value = ID3D12Fence_GetCompletedValue(fence2);
+    ok(value == 0, "Got unexpected value %"PRIu64".\n", value);
+    ok(!get_submission_folding_slot(dst, 0), "Command list executed before its wait was satisfied.\n");
+
+    hr = ID3D12Fence_Signal(fence, 1);
+    ok(SUCCEEDED(hr), "Failed to signal fence, hr %#x.\n", hr);
+    hr = wait_for_fence(fence2, 1);
+    ok(SUCCEEDED(hr), "Failed to wait for fence, hr %#x.\n", hr);
+    value = ID3D12Fence_GetCompletedValue(fence2);
+    ok(value == 1, "Got unexpected value %"PRIu64".\n", value);
+    ok(get_submission_folding_slot(dst, 0) == 1, "Got unexpected slot 0 value.\n");
+    ok(!get_submission_folding_slot(dst, 1), "Command list executed before its wait was satisfied.\n");
+
+    hr = ID3D12Fence_Signal(fence, 2);
+    ok(SUCCEEDED(hr), "Failed to signal fence, hr %#x.\n", hr);
+    hr = wait_for_fence(fence2, 2);
+    ok(SUCCEEDED(hr), "Failed to wait for fence, hr %#x.\n", hr);
+    ok(get_submission_folding_slot(dst, 1) == 2, "Got unexpected slot 1 value.\n");
+
+    /* A GPU signal which is submitted before the wait it satisfies, on another queue and on the same queue. */
+    queue_signal(queues[1], fence, 3);
+    queue_wait(queues[0], fence, 3);
+    exec_command_list(queues[0], lists[2]);
+    queue_signal(queues[0], fence2, 3);
+    hr = wait_for_fence(fence2, 3);
+    ok(SUCCEEDED(hr), "Failed to wait for fence, hr %#x.\n", hr);
+    ok(get_submission_folding_slot(dst, 2) == 3, "Got unexpected slot 2 value.\n");
+
+    queue_signal(queues[0], fence, 4);
+    queue_wait(queues[0], fence, 4);
+    exec_command_list(queues[0], lists[3]);
+    queue_signal(queues[0], fence2, 4);
+    hr = wait_for_fence(fence2, 4);
+    ok(SUCCEEDED(hr), "Failed to wait for fence, hr %#x.\n", hr);
+    ok(get_submission_folding_slot(dst, 3) == 4, "Got unexpected slot 3 value.\n");
+
+    /* Build a dependency chain across all queues in reverse order, so that queues which
+     * share a Vulkan queue have waits pending that can only be satisfied by submissions
+     * issued later. The last signal unblocks everything. */
+    for (i = ARRAY_SIZE(queues) - 1; i >= 1; i--)
+    {
+        queue_wait(queues[i], fence, 4 + i);
+        exec_command_list(queues[i], lists[4 + i]);
+        queue_signal(queues[i], fence, 5 + i);
+    }
+
+    value = ID3D12Fence_GetCompletedValue(fence);
+    ok(value == 4, "Got unexpected value %"PRIu64".\n", value);
+
+    exec_command_list(queues[0], lists[4]);
+    queue_signal(queues[0], fence, 5);
+    hr = wait_for_fence(fence, 4 + ARRAY_SIZE(queues));
+    ok(SUCCEEDED(hr), "Failed to wait for fence, hr %#x.\n", hr);
+
+    for (i = 0; i < ARRAY_SIZE(queues); i++)
+    {
+        ok(get_submission_folding_slot(dst, 4 + i) == 5 + i, "Got unexpected slot %u value %u.\n",
+                4 + i, get_submission_folding_slot(dst, 4 + i));
+    }
+
+    for (i = 0; i < ARRAY_SIZE(queues); i++)
+        wait_queue_idle(device, queues[i]);
+
+    ID3D12Fence_Release(fence);
+    ID3D12Fence_Release(fence2);
+    for (i = 0; i < ARRAY_SIZE(queues); i++)
+        ID3D12CommandQueue_Release(queues[i]);
+    for (i = 0; i < ARRAY_SIZE(lists); i++)
+    {
+        ID3D12GraphicsCommandList_Release(lists[i]);
+        ID3D12CommandAllocator_Release(allocators[i]);
+    }
+    ID3D12Resource_Release(src);
+    ID3D12Resource_Release(dst);
+    refcount = ID3D12Device_Release(device);
+    ok(!refcount, "ID3D12Device has %u references left.\n", (unsigned int)refcount);
+}
@@ -20,6 +20,7 @@
 /* Can be included multiple times. */
 
 decl_test(test_create_device);
+decl_test(test_create_device_probe);
 decl_test(test_node_count);
 decl_test(test_check_feature_support);
 decl_test(test_format_support);
@@ -48,11 +49,17 @@ decl_test(test_reset_command_allocator);
 decl_test(test_cpu_signal_fence);
 decl_test(test_gpu_signal_fence);
 decl_test(test_multithread_fence_wait);
+decl_test(test_spinlock_contention);
+decl_test(test_many_queues_signal);
+decl_test(test_queue_submission_folding);
 decl_test(test_fence_values);
 decl_test(test_clear_depth_stencil_view);
 decl_test(test_clear_render_target_view);
+decl_test(test_clear_bound_render_target_view);
 decl_test(test_clear_unordered_access_view_buffer);
 decl_test(test_clear_unordered_access_view_image);
+decl_test(test_clear_unordered_access_view_image_formats);
+decl_test(test_clear_unordered_access_view_image_r32_views);
 decl_test(test_set_render_targets);
 decl_test(test_draw_instanced);
 decl_test(test_draw_indexed_instanced);
@@ -70,6 +77,7 @@ decl_test(test_draw_depth_only);
 decl_test(test_draw_uav_only);
 decl_test(test_texture_resource_barriers);
 decl_test(test_device_removed_reason);
+decl_test(test_host_allocator);
 decl_test(test_map_resource);
 decl_test(test_map_placed_resources);
 decl_test(test_bundle_state_inheritance);
@@ -114,6 +122,8 @@ decl_test(test_depth_clip);
 decl_test(test_depth_stencil_sampling);
 decl_test(test_depth_load);
 decl_test(test_depth_read_only_view);
+decl_test(test_depth_layout_across_command_lists);
+decl_test(test_depth_layout_across_queues);
 decl_test(test_stencil_load);
 decl_test(test_typed_buffer_uav);
 decl_test(test_typed_uav_store);
@@ -229,6 +239,7 @@ decl_test(test_get_resource_tiling);
 decl_test(test_update_tile_mappings);
 decl_test(test_sampler_border_color);
 decl_test(test_copy_tiles);
+decl_test(test_tile_map);
 decl_test(test_buffer_feedback_instructions_sm51);
 decl_test(test_buffer_feedback_instructions_dxil);
 decl_test(test_texture_feedback_instructions_sm51);
@@ -238,6 +249,7 @@ decl_test(test_discard_resource);
 decl_test(test_clock_calibration);
 decl_test(test_open_heap_from_address);
 decl_test(test_get_cached_blob);
+decl_test(test_cached_blob_skips_translation);
 decl_test(test_pipeline_library);
 decl_test(test_buffers_oob_behavior_dxbc);
 decl_test(test_buffers_oob_behavior_dxil);
@@ -261,9 +273,12 @@ decl_test(test_cbv_hoisting_dxil);
 decl_test(test_write_watch);
 decl_test(test_conservative_rasterization_dxbc);
 decl_test(test_conservative_rasterization_dxil);
+decl_test(test_enhanced_barrier_translation);
 decl_test(test_root_signature_priority);
 decl_test(test_missing_bindings_root_signature);
 decl_test(test_mismatching_pso_stages);
+decl_test(test_mesh_shader_pipeline_state);
+decl_test(test_mesh_shader_command_recording);
 decl_test(test_null_descriptor_mismatch_type);
 decl_test(test_vbv_stride_edge_cases);
 decl_test(test_view_min_lod);
@@ -276,9 +291,14 @@ decl_test(test_get_copyable_footprints_planar);
 decl_test(test_depth_stencil_test_no_dsv);
 decl_test(test_copy_buffer_to_depth_stencil);
 decl_test(test_map_texture_validation);
+decl_test(test_queue_ownership_model);
 decl_test(test_read_write_subresource_2d);
 decl_test(test_read_subresource_rt);
 decl_test(test_integer_blending_pipeline_state);
 decl_test(test_discard_resource_uav);
 decl_test(test_unbound_rtv_rendering);
+decl_test(test_render_pass_begin_end);
 decl_test(test_raytracing_local_rs_static_sampler);
+decl_test(test_raytracing_add_to_state_object);
+decl_test(test_raytracing_acceleration_structure_ring);
+decl_test(test_raytracing_pipeline_library_serialize);
@@ -261,6 +261,9 @@ static void test_create_device(void)
     refcount = ID3D12Device_Release(device);
     ok(!refcount, "Device has %u references left.\n", refcount);
 
+    hr = vkd3d_create_device(&create_info, &IID_ID3D12Device, NULL);
+    ok(hr == S_FALSE, "Got unexpected hr %#x.\n", hr);
+
     hr = vkd3d_create_instance(&instance_default_create_info, &instance);
     ok(hr == S_OK, "Failed to create instance, hr %#x.\n", hr);
 
@@ -276,6 +279,12 @@ static void test_create_device(void)
     refcount = ID3D12Device_Release(device);
     ok(!refcount, "Device has %u references left.\n", refcount);
 
+    hr = vkd3d_create_device(&create_info, &IID_ID3D12Device, NULL);
+    ok(hr == S_FALSE, "Got unexpected hr %#x.\n", hr);
+    refcount = vkd3d_instance_incref(instance);
+    ok(refcount == 2, "Got unexpected refcount %u.\n", refcount);
+    vkd3d_instance_decref(instance);
+
     create_info.instance = instance;
     create_info.instance_create_info = &instance_default_create_info;
     hr = vkd3d_create_device(&create_info, &IID_ID3D12Device, (void **)&device);